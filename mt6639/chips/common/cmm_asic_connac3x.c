@@ -358,6 +358,7 @@ void asicConnac3xWfdmaReInit(
 			prHifInfo->TxRing[u4Idx].TxSwUsedIdx = 0;
 			prHifInfo->TxRing[u4Idx].u4UsedCnt = 0;
 			prHifInfo->TxRing[u4Idx].TxCpuIdx = 0;
+			prHifInfo->TxRing[u4Idx].u4KickPendingCnt = 0;
 		}
 
 		if (halWpdmaGetRxDmaDoneCnt(prAdapter->prGlueInfo,
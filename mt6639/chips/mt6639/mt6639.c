@@ -289,7 +289,9 @@ struct BUS_INFO mt6639_bus_info = {
 	.wfdmaAllocRxRing = mt6639WfdmaAllocRxRing,
 	/* .enablefwdlmode = mt6639EnableFwDlMode, */
 #endif /*_HIF_PCIE || _HIF_AXI */
+#if defined(_HIF_PCIE) || defined(_HIF_AXI) || defined(_HIF_USB)
 	.DmaShdlInit = mt6639DmashdlInit,
+#endif
 #if defined(_HIF_USB)
 	.prDmashdlCfg = &rMt6639DmashdlCfg,
 	.u4UdmaWlCfg_0_Addr = CONNAC3X_UDMA_WLCFG_0,
@@ -207,6 +207,128 @@ void wlanDumpTcResAndTxedCmd(uint8_t *pucBuf,
 }
 #endif
 
+#if CFG_SUPPORT_DBG_TRACE_RING
+u_int8_t fgDbgTraceBinary;
+
+/* one DBG_TRACE_RING per CPU id, allocated on first binary mode switch */
+static struct DBG_TRACE_RING *gprDbgTraceRing;
+static uint32_t gu4DbgTraceRingNum;
+
+static const char gacDbgTraceArgOverflow[] = "<arguments too long>\n";
+
+uint32_t wlanDbgTraceSetMode(u_int8_t fgBinary)
+{
+	struct DBG_TRACE_RING *prRing;
+	uint32_t u4Size;
+
+	if (fgBinary && !gprDbgTraceRing) {
+		u4Size = nr_cpu_ids * sizeof(struct DBG_TRACE_RING);
+		prRing = kalMemAlloc(u4Size, VIR_MEM_TYPE);
+		if (!prRing) {
+			LOG_FUNC("Alloc DBGTRACE ring %u bytes failed\n",
+				 u4Size);
+			return WLAN_STATUS_RESOURCES;
+		}
+		kalMemZero(prRing, u4Size);
+		gu4DbgTraceRingNum = nr_cpu_ids;
+		/* the ring is ready before any writer can see it */
+		smp_wmb();
+		WRITE_ONCE(gprDbgTraceRing, prRing);
+	}
+
+	WRITE_ONCE(fgDbgTraceBinary, fgBinary);
+	LOG_FUNC("DBGTRACE mode: %s\n", fgBinary ? "binary" : "text");
+
+	return WLAN_STATUS_SUCCESS;
+}
+
+void wlanDbgTraceUninit(void)
+{
+	struct DBG_TRACE_RING *prRing = gprDbgTraceRing;
+
+	WRITE_ONCE(fgDbgTraceBinary, FALSE);
+	if (!prRing)
+		return;
+
+	WRITE_ONCE(gprDbgTraceRing, NULL);
+	/* writers only use the ring with IRQs off, wait for them to leave */
+	synchronize_rcu();
+
+	kalMemFree(prRing, VIR_MEM_TYPE,
+		   gu4DbgTraceRingNum * sizeof(struct DBG_TRACE_RING));
+	gu4DbgTraceRingNum = 0;
+}
+
+void wlanDbgTraceRecord(const char *pucFunc, const char *pucFmt, ...)
+{
+	struct DBG_TRACE_RING *prRing;
+	struct DBG_TRACE_REC *prRec;
+	unsigned long ulFlags;
+	uint32_t u4Idx;
+	int i4Words;
+	va_list ap;
+
+	/* each CPU only writes its own ring, so masking IRQs is enough.
+	 * It is also the read side wlanDbgTraceUninit() waits for.
+	 */
+	local_irq_save(ulFlags);
+	prRing = READ_ONCE(gprDbgTraceRing);
+	if (!prRing) {
+		local_irq_restore(ulFlags);
+		return;
+	}
+	prRing += smp_processor_id();
+	u4Idx = prRing->u4WriteIdx++;
+	prRec = &prRing->arRec[u4Idx & (DBG_TRACE_RING_SIZE - 1)];
+	WRITE_ONCE(prRec->u4Seq, 0);
+	smp_wmb();
+
+	prRec->u8Time = sched_clock();
+	prRec->pucFunc = pucFunc;
+	prRec->u4Tid = KAL_GET_CURRENT_THREAD_ID();
+	va_start(ap, pucFmt);
+	i4Words = vbin_printf(prRec->au4Arg, DBG_TRACE_ARG_WORDS, pucFmt, ap);
+	va_end(ap);
+	/* a truncated argument buffer cannot be passed to bstr_printf() */
+	prRec->pucFmt = i4Words <= DBG_TRACE_ARG_WORDS ?
+		pucFmt : gacDbgTraceArgOverflow;
+
+	smp_wmb();
+	WRITE_ONCE(prRec->u4Seq, u4Idx + 1);
+	local_irq_restore(ulFlags);
+}
+
+uint32_t wlanDbgTraceGetWriteIdx(uint32_t u4Cpu)
+{
+	struct DBG_TRACE_RING *prRing = READ_ONCE(gprDbgTraceRing);
+
+	if (!prRing || u4Cpu >= gu4DbgTraceRingNum)
+		return 0;
+
+	return READ_ONCE(prRing[u4Cpu].u4WriteIdx);
+}
+
+u_int8_t wlanDbgTraceRead(uint32_t u4Cpu, uint32_t u4Idx,
+			  struct DBG_TRACE_REC *prRec)
+{
+	struct DBG_TRACE_RING *prRing = READ_ONCE(gprDbgTraceRing);
+	struct DBG_TRACE_REC *prSrc;
+
+	if (!prRing || u4Cpu >= gu4DbgTraceRingNum)
+		return FALSE;
+
+	prSrc = &prRing[u4Cpu].arRec[u4Idx & (DBG_TRACE_RING_SIZE - 1)];
+	if (READ_ONCE(prSrc->u4Seq) != u4Idx + 1)
+		return FALSE;
+	smp_rmb();
+	kalMemCopy(prRec, prSrc, sizeof(struct DBG_TRACE_REC));
+	smp_rmb();
+
+	/* drop the record if the writer wrapped onto it while copying */
+	return READ_ONCE(prSrc->u4Seq) == u4Idx + 1;
+}
+#endif
+
 uint32_t wlanSetDriverDbgLevel(IN uint32_t u4DbgIdx, IN uint32_t u4DbgMask)
 {
 	uint32_t u4Idx;
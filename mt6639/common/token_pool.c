@@ -0,0 +1,339 @@
+/******************************************************************************
+ *
+ * This file is provided under a dual license.  When you use or
+ * distribute this software, you may choose to be licensed under
+ * version 2 of the GNU General Public License ("GPLv2 License")
+ * or BSD License.
+ *
+ * GPLv2 License
+ *
+ * Copyright(C) 2016 MediaTek Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See http://www.gnu.org/licenses/gpl-2.0.html for more details.
+ *
+ * BSD LICENSE
+ *
+ * Copyright(C) 2016 MediaTek Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+/*
+ ** Id: common/token_pool.c
+ */
+
+/*! \file   "token_pool.c"
+ *    \brief  Free token stack with per-CPU caches.
+ *
+ *    The TX MSDU tokens of the PCIe/AXI HIF are kept in a TOKEN_POOL, so
+ *    TX from several CPUs does not serialize on one lock.
+ */
+
+
+/*******************************************************************************
+ *                         C O M P I L E R   F L A G S
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                    E X T E R N A L   R E F E R E N C E S
+ *******************************************************************************
+ */
+#include "precomp.h"
+
+/*******************************************************************************
+ *                              C O N S T A N T S
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                             D A T A   T Y P E S
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                            P U B L I C   D A T A
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                           P R I V A T E   D A T A
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                                 M A C R O S
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                   F U N C T I O N   D E C L A R A T I O N S
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                              F U N C T I O N S
+ *******************************************************************************
+ */
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Allocate the stack and the per-CPU caches of a token pool.
+ *
+ *        The pool starts empty, tokens are added by tokenPoolAdd(). Calling
+ *        it again on an initialized pool only empties it.
+ *
+ * \param[in] prPool     The pool
+ * \param[in] u4Size     Number of tokens the pool can hold
+ * \param[in] fgCache    FALSE to use the global stack only
+ *
+ * \retval FALSE         The stack could not be allocated
+ */
+/*----------------------------------------------------------------------------*/
+u_int8_t tokenPoolInit(struct TOKEN_POOL *prPool, uint32_t u4Size,
+		       u_int8_t fgCache)
+{
+	uint32_t u4Idx;
+
+	if (prPool->apvStack) {
+		tokenPoolReset(prPool);
+		return TRUE;
+	}
+
+	prPool->apvStack = kalMemAlloc(u4Size * sizeof(void *), VIR_MEM_TYPE);
+	if (!prPool->apvStack)
+		return FALSE;
+	prPool->u4Size = u4Size;
+	prPool->u4StackCnt = 0;
+	spin_lock_init(&prPool->rLock);
+
+	prPool->arCache = NULL;
+	prPool->u4CacheNum = 0;
+	if (!fgCache)
+		return TRUE;
+
+	prPool->arCache = kalMemAlloc(nr_cpu_ids * sizeof(struct TOKEN_CACHE),
+				      VIR_MEM_TYPE);
+	if (!prPool->arCache) {
+		DBGLOG(HAL, WARN, "Token cache alloc failed, use the stack\n");
+		return TRUE;
+	}
+	prPool->u4CacheNum = nr_cpu_ids;
+	for (u4Idx = 0; u4Idx < prPool->u4CacheNum; u4Idx++) {
+		spin_lock_init(&prPool->arCache[u4Idx].rLock);
+		prPool->arCache[u4Idx].u4Cnt = 0;
+	}
+
+	return TRUE;
+}
+
+void tokenPoolUninit(struct TOKEN_POOL *prPool)
+{
+	if (prPool->arCache)
+		kalMemFree(prPool->arCache, VIR_MEM_TYPE,
+			   prPool->u4CacheNum * sizeof(struct TOKEN_CACHE));
+	if (prPool->apvStack)
+		kalMemFree(prPool->apvStack, VIR_MEM_TYPE,
+			   prPool->u4Size * sizeof(void *));
+	prPool->arCache = NULL;
+	prPool->u4CacheNum = 0;
+	prPool->apvStack = NULL;
+	prPool->u4Size = 0;
+	prPool->u4StackCnt = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Drop all free tokens, in the stack and in the caches.
+ *
+ * \param[in] prPool     The pool
+ */
+/*----------------------------------------------------------------------------*/
+void tokenPoolReset(struct TOKEN_POOL *prPool)
+{
+	unsigned long ulFlags = 0;
+	uint32_t u4Idx;
+
+	spin_lock_irqsave(&prPool->rLock, ulFlags);
+	prPool->u4StackCnt = 0;
+	spin_unlock_irqrestore(&prPool->rLock, ulFlags);
+
+	for (u4Idx = 0; u4Idx < prPool->u4CacheNum; u4Idx++) {
+		spin_lock_irqsave(&prPool->arCache[u4Idx].rLock, ulFlags);
+		prPool->arCache[u4Idx].u4Cnt = 0;
+		spin_unlock_irqrestore(&prPool->arCache[u4Idx].rLock,
+				       ulFlags);
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Add a token to the global stack, used to fill the pool.
+ *
+ * \param[in] prPool     The pool
+ * \param[in] pvToken    The token
+ */
+/*----------------------------------------------------------------------------*/
+void tokenPoolAdd(struct TOKEN_POOL *prPool, void *pvToken)
+{
+	unsigned long ulFlags = 0;
+
+	spin_lock_irqsave(&prPool->rLock, ulFlags);
+	if (prPool->u4StackCnt < prPool->u4Size)
+		prPool->apvStack[prPool->u4StackCnt++] = pvToken;
+	spin_unlock_irqrestore(&prPool->rLock, ulFlags);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Take a free token.
+ *
+ *        An empty cache of the running CPU is refilled with a batch of
+ *        tokens from the global stack. If the stack is empty too, a token
+ *        is stolen from the cache of another CPU.
+ *
+ * \param[in] prPool     The pool
+ *
+ * \retval NULL          No free token
+ */
+/*----------------------------------------------------------------------------*/
+void *tokenPoolGet(struct TOKEN_POOL *prPool)
+{
+	struct TOKEN_CACHE *prCache;
+	void *pvToken = NULL;
+	unsigned long ulFlags = 0;
+	uint32_t u4Num, u4Idx;
+
+	if (!prPool->arCache) {
+		spin_lock_irqsave(&prPool->rLock, ulFlags);
+		if (prPool->u4StackCnt)
+			pvToken = prPool->apvStack[--prPool->u4StackCnt];
+		spin_unlock_irqrestore(&prPool->rLock, ulFlags);
+		return pvToken;
+	}
+
+	local_irq_save(ulFlags);
+
+	prCache = &prPool->arCache[smp_processor_id()];
+	spin_lock(&prCache->rLock);
+	if (!prCache->u4Cnt) {
+		spin_lock(&prPool->rLock);
+		u4Num = min_t(uint32_t, prPool->u4StackCnt,
+			      TOKEN_CACHE_BATCH);
+		while (u4Num--)
+			prCache->apvToken[prCache->u4Cnt++] =
+				prPool->apvStack[--prPool->u4StackCnt];
+		spin_unlock(&prPool->rLock);
+	}
+	if (prCache->u4Cnt)
+		pvToken = prCache->apvToken[--prCache->u4Cnt];
+	spin_unlock(&prCache->rLock);
+
+	for (u4Idx = 0; !pvToken && u4Idx < prPool->u4CacheNum; u4Idx++) {
+		prCache = &prPool->arCache[u4Idx];
+		spin_lock(&prCache->rLock);
+		if (prCache->u4Cnt)
+			pvToken = prCache->apvToken[--prCache->u4Cnt];
+		spin_unlock(&prCache->rLock);
+	}
+
+	local_irq_restore(ulFlags);
+
+	return pvToken;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Return a token.
+ *
+ *        A full cache of the running CPU drains a batch of tokens to the
+ *        global stack first.
+ *
+ * \param[in] prPool     The pool
+ * \param[in] pvToken    The token
+ */
+/*----------------------------------------------------------------------------*/
+void tokenPoolPut(struct TOKEN_POOL *prPool, void *pvToken)
+{
+	struct TOKEN_CACHE *prCache;
+	unsigned long ulFlags = 0;
+	uint32_t u4Num;
+
+	if (!prPool->arCache) {
+		tokenPoolAdd(prPool, pvToken);
+		return;
+	}
+
+	local_irq_save(ulFlags);
+
+	prCache = &prPool->arCache[smp_processor_id()];
+	spin_lock(&prCache->rLock);
+	if (prCache->u4Cnt == TOKEN_CACHE_SIZE) {
+		spin_lock(&prPool->rLock);
+		for (u4Num = 0; u4Num < TOKEN_CACHE_BATCH; u4Num++)
+			prPool->apvStack[prPool->u4StackCnt++] =
+				prCache->apvToken[--prCache->u4Cnt];
+		spin_unlock(&prPool->rLock);
+	}
+	prCache->apvToken[prCache->u4Cnt++] = pvToken;
+	spin_unlock(&prCache->rLock);
+
+	local_irq_restore(ulFlags);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Count the free tokens, in the stack and in the caches.
+ *
+ *        The count is only a snapshot while other CPUs take or return
+ *        tokens.
+ *
+ * \param[in] prPool     The pool
+ *
+ * \return number of free tokens
+ */
+/*----------------------------------------------------------------------------*/
+uint32_t tokenPoolFreeCnt(struct TOKEN_POOL *prPool)
+{
+	unsigned long ulFlags = 0;
+	uint32_t u4Cnt, u4Idx;
+
+	spin_lock_irqsave(&prPool->rLock, ulFlags);
+	u4Cnt = prPool->u4StackCnt;
+	spin_unlock_irqrestore(&prPool->rLock, ulFlags);
+
+	for (u4Idx = 0; u4Idx < prPool->u4CacheNum; u4Idx++)
+		u4Cnt += READ_ONCE(prPool->arCache[u4Idx].u4Cnt);
+
+	return u4Cnt;
+}
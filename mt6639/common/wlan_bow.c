@@ -2686,7 +2686,6 @@ bowValidateAuth(IN struct ADAPTER *prAdapter,
 		 * exhausted case and do removal of unused struct STA_RECORD.
 		 */
 		ASSERT(prStaRec);
-		COPY_MAC_ADDR(prStaRec->aucMacAddr, prAuthFrame->aucSrcAddr);
 		prSwRfb->ucStaRecIdx = prStaRec->ucIndex;
 		prBowBssInfo->prStaRecOfAP = prStaRec;
 
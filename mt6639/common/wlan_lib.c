@@ -474,10 +474,6 @@ struct axDataRateMappingTable_t {
 } } } } }
 };
 
-#if CFG_SUPPORT_CSI_NF
-static uint32_t g_csi_val[CSI_MAX_DATA_COUNT];
-#endif
-
 /*******************************************************************************
  *                                 M A C R O S
  *******************************************************************************
@@ -731,6 +727,7 @@ void wlanOnPreAllocAdapterMem(IN struct ADAPTER *prAdapter,
 		prAdapter->ucP2PDevBssIdx = BSS_DEFAULT_NUM;
 		prAdapter->ucWtblEntryNum = WTBL_SIZE;
 		prAdapter->ucTxDefaultWlanIndex = prAdapter->ucWtblEntryNum - 1;
+		prAdapter->ucStaRecNum = CFG_STA_REC_NUM;
 
 		prAdapter->u4HifDbgFlag = 0;
 		prAdapter->u4HifChkFlag = 0;
@@ -774,7 +771,7 @@ void wlanOnPreAllocAdapterMem(IN struct ADAPTER *prAdapter,
 		prAdapter->fgIsChipNoAck = FALSE;
 	}
 
-	QUEUE_INITIALIZE(&(prAdapter->rPendingCmdQueue));
+	nicInitPendingCmdInfo(prAdapter);
 #if CFG_SUPPORT_MULTITHREAD
 	QUEUE_INITIALIZE(&prAdapter->rTxCmdQueue);
 	QUEUE_INITIALIZE(&prAdapter->rTxCmdDoneQueue);
@@ -1173,12 +1170,14 @@ uint32_t wlanAdapterStart(IN struct ADAPTER *prAdapter,
 		/* 4 <6> Enable HIF cut-through to N9 mode, not visiting CR4 */
 		HAL_ENABLE_FWDL(prAdapter, TRUE);
 
+#if CFG_CHIP_RESET_SUPPORT && (defined(_HIF_PCIE) || defined(_HIF_USB))
 		/* Reset WF subsystem before chip eco info reading */
 		DBGLOG(INIT, INFO, "About to call WF subsystem reset functions\n");
 		mt6639HalCbInfraRguWfRst(prAdapter, TRUE);  /* Assert reset */
 		mt6639HalPollWfsysSwInitDone(prAdapter);
 		mt6639HalCbInfraRguWfRst(prAdapter, FALSE); /* De-assert reset */
 		DBGLOG(INIT, INFO, "WF subsystem reset functions completed\n");
+#endif
 
 		/* 4 <7> Get ECO Version */
 		if (wlanSetChipEcoInfo(prAdapter) != WLAN_STATUS_SUCCESS) {
@@ -1820,9 +1819,8 @@ uint32_t wlanProcessCommandQueue(IN struct ADAPTER
 				 */
 				KAL_ACQUIRE_SPIN_LOCK(prAdapter,
 						      SPIN_LOCK_CMD_PENDING);
-				QUEUE_INSERT_TAIL(
-						&(prAdapter->rPendingCmdQueue),
-						prQueueEntry);
+				nicEnqueuePendingCmdInfo(prAdapter,
+					(struct CMD_INFO *) prQueueEntry);
 				KAL_RELEASE_SPIN_LOCK(prAdapter,
 						      SPIN_LOCK_CMD_PENDING);
 			} else {
@@ -2165,8 +2163,7 @@ uint32_t wlanTxCmdMthread(IN struct ADAPTER *prAdapter)
 				prMemTrack->u2CmdIdAndWhere |= 0x0200;
 			}
 #endif
-			QUEUE_INSERT_TAIL(&(prAdapter->rPendingCmdQueue),
-					  (struct QUE_ENTRY *) prCmdInfo);
+			nicEnqueuePendingCmdInfo(prAdapter, prCmdInfo);
 			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
 		} else {
 #if CFG_DBG_MGT_BUF
@@ -2481,10 +2478,11 @@ void wlanClearDataQueue(IN struct ADAPTER *prAdapter)
 		}
 
 		/* <1> Move whole list of CMD_INFO to temp queue */
-		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
-		for (i = 0; i < TX_PORT_NUM; i++)
+		for (i = 0; i < TX_PORT_NUM; i++) {
+			TX_PORT_QUE_LOCK(prAdapter, i);
 			QUEUE_MOVE_ALL(prDataPort[i], &prAdapter->rTxPQueue[i]);
-		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
+			TX_PORT_QUE_UNLOCK(prAdapter, i);
+		}
 
 		/* <2> Return sk buffer */
 		for (i = 0; i < TX_PORT_NUM; i++) {
@@ -2568,7 +2566,7 @@ void wlanClearPendingCommandQueue(IN struct ADAPTER *prAdapter)
 	ASSERT(prAdapter);
 
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
-	QUEUE_MOVE_ALL(prTempCmdQue, &prAdapter->rPendingCmdQueue);
+	nicDequeueAllPendingCmdInfo(prAdapter, prTempCmdQue);
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
 
 	QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
@@ -2685,7 +2683,6 @@ void wlanReleaseCommand(IN struct ADAPTER *prAdapter,
 void wlanReleasePendingOid(IN struct ADAPTER *prAdapter,
 			   IN unsigned long ulParamPtr)
 {
-	struct QUE *prCmdQue;
 	struct QUE rTempCmdQue;
 	struct QUE *prTempCmdQue = &rTempCmdQue;
 	struct QUE_ENTRY *prQueueEntry = (struct QUE_ENTRY *) NULL;
@@ -2745,11 +2742,10 @@ void wlanReleasePendingOid(IN struct ADAPTER *prAdapter,
 		wlanClearTxOidCommand(prAdapter);
 #endif
 
-		/* 2: Clear Pending OID in prAdapter->rPendingCmdQueue */
+		/* 2: Clear Pending OID in prAdapter->aprPendingCmdInfo */
 		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
 
-		prCmdQue = &prAdapter->rPendingCmdQueue;
-		QUEUE_MOVE_ALL(prTempCmdQue, prCmdQue);
+		nicDequeueAllPendingCmdInfo(prAdapter, prTempCmdQue);
 
 		QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
 				  struct QUE_ENTRY *);
@@ -2779,7 +2775,7 @@ void wlanReleasePendingOid(IN struct ADAPTER *prAdapter,
 
 				cmdBufFreeCmdInfo(prAdapter, prCmdInfo);
 			} else {
-				QUEUE_INSERT_TAIL(prCmdQue, prQueueEntry);
+				nicEnqueuePendingCmdInfo(prAdapter, prCmdInfo);
 			}
 
 			QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
@@ -2889,38 +2885,26 @@ void wlanReturnPacketDelaySetupTimeout(IN struct ADAPTER
 				       *prAdapter, IN unsigned long ulParamPtr)
 {
 	struct RX_CTRL *prRxCtrl;
-	struct SW_RFB *prSwRfb = NULL;
 
 	KAL_SPIN_LOCK_DECLARATION();
 	uint32_t status = WLAN_STATUS_SUCCESS;
-	struct QUE *prQueList;
+	struct QUE rRfbList;
 
 	ASSERT(prAdapter);
 
 	prRxCtrl = &prAdapter->rRxCtrl;
 	ASSERT(prRxCtrl);
 
-	prQueList = &prRxCtrl->rIndicatedRfbList;
-	DBGLOG(RX, TRACE, "%s: IndicatedRfbList num = %u\n",
-	       __func__, prQueList->u4NumElem);
-
-	while (QUEUE_IS_NOT_EMPTY(&prRxCtrl->rIndicatedRfbList)) {
-		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
-		QUEUE_REMOVE_HEAD(&prRxCtrl->rIndicatedRfbList, prSwRfb,
-				  struct SW_RFB *);
-		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+	QUEUE_MOVE_ALL(&rRfbList, &prRxCtrl->rIndicatedRfbList);
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
 
-		if (prSwRfb) {
-			status = nicRxSetupRFB(prAdapter, prSwRfb);
-			nicRxReturnRFB(prAdapter, prSwRfb);
-		} else {
-			log_dbg(RX, WARN, "prSwRfb == NULL\n");
-			break;
-		}
+	DBGLOG(RX, TRACE, "%s: IndicatedRfbList num = %u\n",
+	       __func__, rRfbList.u4NumElem);
 
-		if (status != WLAN_STATUS_SUCCESS)
-			break;
-	}
+	/* RFBs failed to setup go back to rIndicatedRfbList */
+	status = nicRxSetupRFBList(prAdapter, &rRfbList);
+	nicRxReturnRFBList(prAdapter, &rRfbList);
 
 	if (status != WLAN_STATUS_SUCCESS) {
 		DBGLOG(RX, WARN, "Restart ReturnIndicatedRfb Timer (%u)\n",
@@ -2945,40 +2929,69 @@ void wlanReturnPacketDelaySetupTimeout(IN struct ADAPTER
 /*----------------------------------------------------------------------------*/
 void wlanReturnPacket(IN struct ADAPTER *prAdapter,
 		      IN void *pvPacket)
+{
+	DEBUGFUNC("wlanReturnPacket");
+
+	wlanReturnPacketBatch(prAdapter, &pvPacket, 1);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Return a batch of packet buffers and reallocate one to a RFB for each
+ *        of them. The RFBs are taken from and given back to the RX lists with
+ *        one lock acquisition each.
+ *
+ * \param prAdapter      Pointer of Adapter Data Structure
+ * \param apvPackets     Array of returned packets, NULL entries are allowed
+ * \param u4Num          Number of entries in apvPackets
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void wlanReturnPacketBatch(IN struct ADAPTER *prAdapter,
+			   IN void *apvPackets[], IN uint32_t u4Num)
 {
 	struct RX_CTRL *prRxCtrl;
 	struct SW_RFB *prSwRfb = NULL;
+	struct QUE rRfbList;
+	uint32_t i, u4Freed = 0;
 
 	KAL_SPIN_LOCK_DECLARATION();
 
-	DEBUGFUNC("wlanReturnPacket");
-
 	ASSERT(prAdapter);
 
 	prRxCtrl = &prAdapter->rRxCtrl;
 	ASSERT(prRxCtrl);
 
-	if (pvPacket) {
-		kalPacketFree(prAdapter->prGlueInfo, pvPacket);
-		RX_ADD_CNT(prRxCtrl, RX_DATA_RETURNED_COUNT, 1);
-#if CFG_NATIVE_802_11
-		if (GLUE_TEST_FLAG(prAdapter->prGlueInfo, GLUE_FLAG_HALT)) {
-			/*Todo:: nothing */
-			/*Todo:: nothing */
-		}
-#endif
+	if (u4Num == 0)
+		return;
+
+	for (i = 0; i < u4Num; i++) {
+		if (!apvPackets[i])
+			continue;
+		kalPacketFree(prAdapter->prGlueInfo, apvPackets[i]);
+		u4Freed++;
 	}
+	if (u4Freed)
+		RX_ADD_CNT(prRxCtrl, RX_DATA_RETURNED_COUNT, u4Freed);
 
+	QUEUE_INITIALIZE(&rRfbList);
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
-	QUEUE_REMOVE_HEAD(&prRxCtrl->rIndicatedRfbList, prSwRfb,
-			  struct SW_RFB *);
+	for (i = 0; i < u4Num; i++) {
+		QUEUE_REMOVE_HEAD(&prRxCtrl->rIndicatedRfbList, prSwRfb,
+				  struct SW_RFB *);
+		if (!prSwRfb)
+			break;
+		QUEUE_INSERT_TAIL(&rRfbList, &prSwRfb->rQueEntry);
+	}
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
 	if (!prSwRfb) {
 		DBGLOG(RX, WARN, "No free SwRfb!\n");
-		return;
+		if (QUEUE_IS_EMPTY(&rRfbList))
+			return;
 	}
 
-	if (nicRxSetupRFB(prAdapter, prSwRfb)) {
+	if (nicRxSetupRFBList(prAdapter, &rRfbList)) {
 		DBGLOG(RX, WARN,
 		       "Cannot allocate packet buffer for SwRfb!\n");
 		if (!timerPendingTimer(
@@ -2991,7 +3004,7 @@ void wlanReturnPacket(IN struct ADAPTER *prAdapter,
 			    SEC_TO_MSEC(RX_RETURN_INDICATED_RFB_TIMEOUT_SEC));
 		}
 	}
-	nicRxReturnRFB(prAdapter, prSwRfb);
+	nicRxReturnRFBList(prAdapter, &rRfbList);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -5998,7 +6011,6 @@ void wlanDumpBssStatistics(IN struct ADAPTER *prAdapter,
 	struct STA_RECORD *prStaRec;
 	enum ENUM_WMM_ACI eAci;
 	struct WIFI_WMM_AC_STAT arLLStats[WMM_AC_INDEX_NUM];
-	uint8_t ucIdx;
 
 	if (ucBssIdx > prAdapter->ucHwBssIdNum) {
 		DBGLOG(SW4, INFO, "Invalid BssInfo index[%u], skip dump!\n",
@@ -6051,12 +6063,8 @@ void wlanDumpBssStatistics(IN struct ADAPTER *prAdapter,
 			prBssInfo->arLinkStatistics[eAci].u4TxRetryMsdu;
 	}
 
-	for (ucIdx = 0; ucIdx < CFG_STA_REC_NUM; ucIdx++) {
-		prStaRec = cnmGetStaRecByIndex(prAdapter, ucIdx);
-		if (!prStaRec)
-			continue;
-		if (prStaRec->ucBssIndex != ucBssIdx)
-			continue;
+	LINK_FOR_EACH_ENTRY(prStaRec, &prAdapter->arStaRecOfBss[ucBssIdx],
+		rLinkEntryOfBss, struct STA_RECORD) {
 		/* now the valid sta_rec is valid */
 		for (eAci = 0; eAci < WMM_AC_INDEX_NUM; eAci++) {
 			arLLStats[eAci].u4TxMsdu +=
@@ -7229,6 +7237,18 @@ void wlanInitFeatureOption(IN struct ADAPTER *prAdapter)
 	prWifiVar->cThreadNice = (int8_t) wlanCfgGetInt32(
 					prAdapter, "ThreadNice",
 					WLAN_THREAD_TASK_NICE);
+	prWifiVar->ucTxDataThread = (uint8_t) wlanCfgGetUint32(
+					prAdapter, "TxDataThread", 1);
+	prWifiVar->ucRxDataThread = (uint8_t) wlanCfgGetUint32(
+					prAdapter, "RxDataThread", 1);
+	prWifiVar->u4MainThreadCpuMask = wlanCfgGetUint32(
+					prAdapter, "MainThreadCpuMask", 0);
+	prWifiVar->u4TxDataThreadCpuMask = wlanCfgGetUint32(
+					prAdapter, "TxDataThreadCpuMask", 0);
+	prWifiVar->u4HifThreadCpuMask = wlanCfgGetUint32(
+					prAdapter, "HifThreadCpuMask", 0);
+	prWifiVar->u4RxThreadCpuMask = wlanCfgGetUint32(
+					prAdapter, "RxThreadCpuMask", 0);
 
 	prAdapter->rQM.u4MaxForwardBufferCount = (uint32_t) wlanCfgGetUint32(
 					prAdapter, "ApForwardBufferCnt",
@@ -7381,6 +7401,13 @@ void wlanInitFeatureOption(IN struct ADAPTER *prAdapter)
 	prWifiVar->u4NetifStartTh = (uint32_t) wlanCfgGetUint32(
 					prAdapter, "NetifStartTh",
 					CFG_TX_START_NETIF_PER_QUEUE_THRESHOLD);
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	prWifiVar->u4TxKickBurstMax = (uint32_t) wlanCfgGetUint32(
+					prAdapter, "TxKickBurstMax",
+					HIF_TX_KICK_BURST_MAX_NUM);
+	if (prWifiVar->u4TxKickBurstMax == 0)
+		prWifiVar->u4TxKickBurstMax = 1;
+#endif
 	prWifiVar->ucTxBaSize = (uint8_t) wlanCfgGetUint32(
 					prAdapter, "TxBaSize", 64);
 	prWifiVar->ucRxHtBaSize = (uint8_t) wlanCfgGetUint32(
@@ -7449,6 +7476,12 @@ void wlanInitFeatureOption(IN struct ADAPTER *prAdapter)
 
 	prWifiVar->ucTxMsduQueue = (uint32_t) wlanCfgGetUint32(
 		prAdapter, "NicTxMsduQueue", 0);
+	prWifiVar->ucTxPortQueLock = (uint8_t) wlanCfgGetUint32(
+		prAdapter, "TxPortQueLock", 1);
+#if (CFG_SUPPORT_TX_TSO_SW == 1)
+	prWifiVar->ucSwTsoRefFrag = (uint8_t) wlanCfgGetUint32(
+		prAdapter, "SwTsoRefFrag", 1);
+#endif
 
 #if QM_ADAPTIVE_TC_RESOURCE_CTRL
 	prQM->au4MinReservedTcResource[TC0_INDEX] = (uint32_t) wlanCfgGetUint32(
@@ -8411,42 +8444,94 @@ void wlanCfgSetCountryCode(IN struct ADAPTER *prAdapter)
 }
 
 
-struct WLAN_CFG_ENTRY *wlanCfgGetEntry(IN struct ADAPTER *prAdapter,
-				       const int8_t *pucKey,
-				       u_int8_t fgGetCfgRec)
+/* Select the config store, both stores share the same layout */
+static struct WLAN_CFG_ENTRY *wlanCfgGetStore(IN struct ADAPTER *prAdapter,
+					      u_int8_t fgGetCfgRec,
+					      uint32_t *pu4MaxNum,
+					      uint16_t **ppu2HashIdx,
+					      uint32_t **ppu4FreeIdx)
 {
-
-	struct WLAN_CFG_ENTRY *prWlanCfgEntry;
-	struct WLAN_CFG *prWlanCfg = NULL;
-	struct WLAN_CFG_REC *prWlanCfgRec = NULL;
-	uint32_t i, u32MaxNum;
+	struct WLAN_CFG *prWlanCfg;
+	struct WLAN_CFG_REC *prWlanCfgRec;
 
 	if (fgGetCfgRec) {
 		prWlanCfgRec = prAdapter->prWlanCfgRec;
-		u32MaxNum = WLAN_CFG_REC_ENTRY_NUM_MAX;
 		ASSERT(prWlanCfgRec);
-	} else {
-		prWlanCfg = prAdapter->prWlanCfg;
-		u32MaxNum = WLAN_CFG_ENTRY_NUM_MAX;
-		ASSERT(prWlanCfg);
+		*pu4MaxNum = WLAN_CFG_REC_ENTRY_NUM_MAX;
+		*ppu2HashIdx = prWlanCfgRec->au2HashIdx;
+		*ppu4FreeIdx = &prWlanCfgRec->u4FreeIdx;
+		return prWlanCfgRec->arWlanCfgBuf;
 	}
 
+	prWlanCfg = prAdapter->prWlanCfg;
+	ASSERT(prWlanCfg);
+	*pu4MaxNum = WLAN_CFG_ENTRY_NUM_MAX;
+	*ppu2HashIdx = prWlanCfg->au2HashIdx;
+	*ppu4FreeIdx = &prWlanCfg->u4FreeIdx;
+	return prWlanCfg->arWlanCfgBuf;
+}
 
-	ASSERT(pucKey);
+/* FNV-1a over the part of the key that kalStrnCmp compares */
+static uint32_t wlanCfgHashKey(const int8_t *pucKey)
+{
+	uint32_t u4Hash = 2166136261;
+	uint32_t i;
 
-	prWlanCfgEntry = NULL;
+	for (i = 0; i < WLAN_CFG_KEY_LEN_MAX - 1 && pucKey[i] != '\0'; i++) {
+		u4Hash ^= (uint8_t) pucKey[i];
+		u4Hash *= 16777619;
+	}
 
-	for (i = 0; i < u32MaxNum; i++) {
-		if (fgGetCfgRec)
-			prWlanCfgEntry = &prWlanCfgRec->arWlanCfgBuf[i];
-		else
-			prWlanCfgEntry = &prWlanCfg->arWlanCfgBuf[i];
+	return u4Hash & (WLAN_CFG_HASH_SIZE - 1);
+}
 
-		if (prWlanCfgEntry->aucKey[0] != '\0') {
-			if (kalStrnCmp(pucKey, prWlanCfgEntry->aucKey,
-				       WLAN_CFG_KEY_LEN_MAX - 1) == 0)
-				return prWlanCfgEntry;
-		}
+static void wlanCfgHashInsert(struct WLAN_CFG_ENTRY *prBuf,
+			      uint16_t *pu2HashIdx, uint32_t u4EntryIdx)
+{
+	uint32_t u4Slot = wlanCfgHashKey(prBuf[u4EntryIdx].aucKey);
+
+	/* the index is twice the store, an empty slot always exists */
+	while (pu2HashIdx[u4Slot])
+		u4Slot = (u4Slot + 1) & (WLAN_CFG_HASH_SIZE - 1);
+	pu2HashIdx[u4Slot] = (uint16_t) (u4EntryIdx + 1);
+}
+
+/* Linear probing can't simply clear a slot, rebuild after a removal */
+static void wlanCfgHashRebuild(struct WLAN_CFG_ENTRY *prBuf,
+			       uint32_t u4MaxNum, uint16_t *pu2HashIdx)
+{
+	uint32_t i;
+
+	kalMemZero(pu2HashIdx, WLAN_CFG_HASH_SIZE * sizeof(uint16_t));
+	for (i = 0; i < u4MaxNum; i++) {
+		if (prBuf[i].aucKey[0] != '\0')
+			wlanCfgHashInsert(prBuf, pu2HashIdx, i);
+	}
+}
+
+struct WLAN_CFG_ENTRY *wlanCfgGetEntry(IN struct ADAPTER *prAdapter,
+				       const int8_t *pucKey,
+				       u_int8_t fgGetCfgRec)
+{
+
+	struct WLAN_CFG_ENTRY *prWlanCfgEntry;
+	struct WLAN_CFG_ENTRY *prBuf;
+	uint16_t *pu2HashIdx;
+	uint32_t *pu4FreeIdx;
+	uint32_t u4MaxNum, u4Slot, i;
+
+	prBuf = wlanCfgGetStore(prAdapter, fgGetCfgRec, &u4MaxNum,
+				&pu2HashIdx, &pu4FreeIdx);
+
+	ASSERT(pucKey);
+
+	u4Slot = wlanCfgHashKey(pucKey);
+	for (i = 0; i < WLAN_CFG_HASH_SIZE && pu2HashIdx[u4Slot]; i++) {
+		prWlanCfgEntry = &prBuf[pu2HashIdx[u4Slot] - 1];
+		if (kalStrnCmp(pucKey, prWlanCfgEntry->aucKey,
+			       WLAN_CFG_KEY_LEN_MAX - 1) == 0)
+			return prWlanCfgEntry;
+		u4Slot = (u4Slot + 1) & (WLAN_CFG_HASH_SIZE - 1);
 	}
 
 	return NULL;
@@ -8602,8 +8687,10 @@ uint32_t wlanCfgSet(IN struct ADAPTER *prAdapter,
 {
 
 	struct WLAN_CFG_ENTRY *prWlanCfgEntry;
-	struct WLAN_CFG *prWlanCfg = NULL;
-	struct WLAN_CFG_REC *prWlanCfgRec = NULL;
+	struct WLAN_CFG_ENTRY *prBuf;
+	uint16_t *pu2HashIdx;
+	uint32_t *pu4FreeIdx;
+	uint32_t u4MaxNum;
 	uint32_t u4EntryIndex;
 	uint32_t i;
 	uint8_t ucExist;
@@ -8616,35 +8703,20 @@ uint32_t wlanCfgSet(IN struct ADAPTER *prAdapter,
 
 	/* Find the exist */
 	ucExist = 0;
-	if (fgGetCfgRec) {
-		prWlanCfgEntry = wlanCfgGetEntry(prAdapter, pucKey, TRUE);
-		prWlanCfgRec = prAdapter->prWlanCfgRec;
-		ASSERT(prWlanCfgRec);
-	} else {
-		prWlanCfgEntry = wlanCfgGetEntry(prAdapter, pucKey, FALSE);
-		prWlanCfg = prAdapter->prWlanCfg;
-		ASSERT(prWlanCfg);
-	}
+	prWlanCfgEntry = wlanCfgGetEntry(prAdapter, pucKey, fgGetCfgRec);
+	prBuf = wlanCfgGetStore(prAdapter, fgGetCfgRec, &u4MaxNum,
+				&pu2HashIdx, &pu4FreeIdx);
 
 	if (!prWlanCfgEntry) {
 		/* Find the empty */
-		for (i = 0; i < WLAN_CFG_ENTRY_NUM_MAX; i++) {
-			if (fgGetCfgRec)
-				prWlanCfgEntry = &prWlanCfgRec->arWlanCfgBuf[i];
-			else
-				prWlanCfgEntry = &prWlanCfg->arWlanCfgBuf[i];
-			if (prWlanCfgEntry->aucKey[0] == '\0')
+		for (i = *pu4FreeIdx; i < u4MaxNum; i++) {
+			if (prBuf[i].aucKey[0] == '\0')
 				break;
 		}
 
 		u4EntryIndex = i;
-		if (u4EntryIndex < WLAN_CFG_ENTRY_NUM_MAX) {
-			if (fgGetCfgRec)
-				prWlanCfgEntry =
-				    &prWlanCfgRec->arWlanCfgBuf[u4EntryIndex];
-			else
-				prWlanCfgEntry =
-				    &prWlanCfg->arWlanCfgBuf[u4EntryIndex];
+		if (u4EntryIndex < u4MaxNum) {
+			prWlanCfgEntry = &prBuf[u4EntryIndex];
 			kalMemZero(prWlanCfgEntry,
 				   sizeof(struct WLAN_CFG_ENTRY));
 		} else {
@@ -8657,6 +8729,8 @@ uint32_t wlanCfgSet(IN struct ADAPTER *prAdapter,
 		ucExist = 1;
 
 	if (prWlanCfgEntry) {
+		u4EntryIndex = prWlanCfgEntry - prBuf;
+
 		if (ucExist == 0) {
 			kalStrnCpy(prWlanCfgEntry->aucKey, pucKey,
 				   WLAN_CFG_KEY_LEN_MAX - 1);
@@ -8675,12 +8749,22 @@ uint32_t wlanCfgSet(IN struct ADAPTER *prAdapter,
 						prWlanCfgEntry->aucKey,
 						prWlanCfgEntry->aucValue,
 						prWlanCfgEntry->pPrivate, 0);
+			} else {
+				wlanCfgHashInsert(prBuf, pu2HashIdx,
+						  u4EntryIndex);
+				*pu4FreeIdx = u4EntryIndex + 1;
 			}
 		} else {
 			/* Call the pfSetCb if value is empty ? */
 			/* remove the entry if value is empty */
 			kalMemZero(prWlanCfgEntry,
 				   sizeof(struct WLAN_CFG_ENTRY));
+			if (ucExist) {
+				wlanCfgHashRebuild(prBuf, u4MaxNum,
+						   pu2HashIdx);
+				if (u4EntryIndex < *pu4FreeIdx)
+					*pu4FreeIdx = u4EntryIndex;
+			}
 		}
 
 	}
@@ -9539,6 +9623,7 @@ uint32_t wlanCfgInit(IN struct ADAPTER *prAdapter,
 #else
 		wlanCfgParse(prAdapter, pucConfigBuf, u4ConfigBufLen);
 #endif
+
 	return WLAN_STATUS_SUCCESS;
 }
 
@@ -9849,11 +9934,108 @@ u_int8_t wlanTxLifetimeIsTargetMsdu(IN struct ADAPTER
 	return fgResult;
 }
 
+static uint32_t wlanTxLatGetBucket(IN uint64_t u8Time)
+{
+	uint32_t u4Msb = 0;
+	uint32_t u4Shift;
+
+	if (u8Time < TX_LAT_HIST_SUB_NUM)
+		return (uint32_t) u8Time;
+	if (u8Time >> TX_LAT_HIST_MAX_BITS)
+		return TX_LAT_HIST_BUCKET_NUM - 1;
+
+	/* binary search of the most significant bit */
+	for (u4Shift = 32; u4Shift; u4Shift >>= 1) {
+		if (u8Time >> (u4Msb + u4Shift))
+			u4Msb += u4Shift;
+	}
+
+	u4Shift = u4Msb - TX_LAT_HIST_SUB_BITS;
+	return ((u4Shift + 1) << TX_LAT_HIST_SUB_BITS) +
+		((uint32_t) (u8Time >> u4Shift) & (TX_LAT_HIST_SUB_NUM - 1));
+}
+
+/* highest latency counted by bucket u4Idx */
+static uint64_t wlanTxLatGetBucketMax(IN uint32_t u4Idx)
+{
+	uint32_t u4Group = u4Idx >> TX_LAT_HIST_SUB_BITS;
+	uint64_t u8Sub = u4Idx & (TX_LAT_HIST_SUB_NUM - 1);
+
+	if (u4Group == 0)
+		return u8Sub;
+
+	return ((TX_LAT_HIST_SUB_NUM + u8Sub + 1) << (u4Group - 1)) - 1;
+}
+
+static void wlanTxLatRecord(IN struct ADAPTER *prAdapter,
+			    IN enum ENUM_TX_LAT_STAGE eStage,
+			    IN uint64_t u8Start, IN uint64_t u8End)
+{
+	struct TX_LAT_HIST *prHist =
+		&prAdapter->rTxCtrl.rLatStats.arHist[eStage];
+	uint64_t u8Time;
+
+	if (u8Start == 0 || u8End < u8Start)
+		return;
+
+	u8Time = u8End - u8Start;
+	prHist->u4Count++;
+	prHist->u8TotalTime += u8Time;
+	if (u8Time > prHist->u8MaxTime)
+		prHist->u8MaxTime = u8Time;
+	prHist->au4Bucket[wlanTxLatGetBucket(u8Time)]++;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Get a percentile of one TX stage latency histogram
+ *
+ * \param[in] prHist      Latency histogram of the stage
+ * \param[in] u4PerMille  Percentile in 1/1000, e.g. 999 for p99.9
+ *
+ * \return Upper bound of the bucket holding the percentile in ns,
+ *         0 if nothing was recorded
+ */
+/*----------------------------------------------------------------------------*/
+uint64_t wlanTxLatGetPercentile(IN struct TX_LAT_HIST *prHist,
+				IN uint32_t u4PerMille)
+{
+	uint64_t u8Rank;
+	uint64_t u8Sum = 0;
+	uint32_t u4Idx;
+
+	if (prHist->u4Count == 0)
+		return 0;
+
+	u8Rank = div_u64((uint64_t) prHist->u4Count * u4PerMille + 999, 1000);
+
+	for (u4Idx = 0; u4Idx < TX_LAT_HIST_BUCKET_NUM; u4Idx++) {
+		u8Sum += prHist->au4Bucket[u4Idx];
+		if (u8Sum >= u8Rank)
+			break;
+	}
+
+	/* buckets may lag behind u4Count during a concurrent update */
+	if (u4Idx == TX_LAT_HIST_BUCKET_NUM ||
+	    wlanTxLatGetBucketMax(u4Idx) > prHist->u8MaxTime)
+		return prHist->u8MaxTime;
+
+	return wlanTxLatGetBucketMax(u4Idx);
+}
+
+void wlanTxLatReset(IN struct ADAPTER *prAdapter)
+{
+	kalMemZero(&prAdapter->rTxCtrl.rLatStats,
+		   sizeof(prAdapter->rTxCtrl.rLatStats));
+}
+
 void wlanTxLifetimeTagPacket(IN struct ADAPTER *prAdapter,
 			     IN struct MSDU_INFO *prMsduInfo,
 			     IN enum ENUM_TX_PROFILING_TAG eTag)
 {
 	struct PKT_PROFILE *prPktProfile = &prMsduInfo->rPktProfile;
+	struct TX_LAT_STATS *prLatStats = &prAdapter->rTxCtrl.rLatStats;
+	uint64_t u8Now;
 
 	if (!wlanTxLifetimeIsProfilingEnabled(prAdapter))
 		return;
@@ -9877,25 +10059,76 @@ void wlanTxLifetimeTagPacket(IN struct ADAPTER *prAdapter,
 			/* Packet enqueue time */
 			prPktProfile->rEnqueueTimestamp = (OS_SYSTIME)
 							  kalGetTimeTick();
+
+			prPktProfile->u8ArrivalTime =
+				GLUE_GET_PKT_XTIME(prMsduInfo->prPacket);
+			prPktProfile->u8EnqueueTime = sched_clock();
+			prPktProfile->u8HifTxDoneTime = 0;
+			wlanTxLatRecord(prAdapter, TX_LAT_STAGE_OS_TO_ENQUE,
+					prPktProfile->u8ArrivalTime,
+					prPktProfile->u8EnqueueTime);
 		}
 		break;
 
 	case TX_PROF_TAG_DRV_DEQUE:
-		if (prPktProfile->fgIsValid)
-			prPktProfile->rDequeueTimestamp = (OS_SYSTIME)
-							  kalGetTimeTick();
+		/* qmDequeueTxPacketsMthread passes the dequeued list */
+		u8Now = sched_clock();
+		while (prMsduInfo) {
+			prPktProfile = &prMsduInfo->rPktProfile;
+			if (prPktProfile->fgIsValid) {
+				prPktProfile->rDequeueTimestamp = (OS_SYSTIME)
+					kalGetTimeTick();
+
+				prPktProfile->u8DequeueTime = u8Now;
+				wlanTxLatRecord(prAdapter,
+					TX_LAT_STAGE_ENQUE_TO_DEQUE,
+					prPktProfile->u8EnqueueTime, u8Now);
+			}
+			prMsduInfo = (struct MSDU_INFO *)
+				QUEUE_GET_NEXT_ENTRY(&prMsduInfo->rQueEntry);
+		}
 		break;
 
 	case TX_PROF_TAG_DRV_TX_DONE:
-		if (prPktProfile->fgIsValid) {
+		/* nicTxMsduQueue may tag an OS frame twice, count it once */
+		if (prPktProfile->fgIsValid &&
+		    prPktProfile->u8HifTxDoneTime == 0) {
 			prPktProfile->rHifTxDoneTimestamp = (OS_SYSTIME)
 							    kalGetTimeTick();
+
+			prPktProfile->u8HifTxDoneTime = sched_clock();
+			wlanTxLatRecord(prAdapter, TX_LAT_STAGE_DEQUE_TO_HIF,
+					prPktProfile->u8DequeueTime,
+					prPktProfile->u8HifTxDoneTime);
 #if CFG_ENABLE_PER_STA_STATISTICS
 			wlanTxLifetimeUpdateStaStats(prAdapter, prMsduInfo);
 #endif
 		}
 		break;
 
+	case TX_PROF_TAG_DRV_FREE_MSDU:
+		/* callers may pass a list linked by rQueEntry */
+		u8Now = sched_clock();
+		while (prMsduInfo) {
+			prPktProfile = &prMsduInfo->rPktProfile;
+			if (prPktProfile->fgIsValid) {
+				prPktProfile->fgIsValid = FALSE;
+				wlanTxLatRecord(prAdapter,
+					TX_LAT_STAGE_HIF_TO_FREE,
+					prPktProfile->u8HifTxDoneTime, u8Now);
+				wlanTxLatRecord(prAdapter, TX_LAT_STAGE_TOTAL,
+					prPktProfile->u8ArrivalTime ?
+					prPktProfile->u8ArrivalTime :
+					prPktProfile->u8EnqueueTime, u8Now);
+				if (prLatStats->u8FirstFreeTime == 0)
+					prLatStats->u8FirstFreeTime = u8Now;
+				prLatStats->u8LastFreeTime = u8Now;
+			}
+			prMsduInfo = (struct MSDU_INFO *)
+				QUEUE_GET_NEXT_ENTRY(&prMsduInfo->rQueEntry);
+		}
+		break;
+
 	case TX_PROF_TAG_MAC_TX_DONE:
 		break;
 
@@ -10204,22 +10437,22 @@ wlanGetWlanIdxByAddress(IN struct ADAPTER *prAdapter,
 	uint8_t ucStaRecIdx;
 	struct STA_RECORD *prTempStaRec;
 
+	if (pucAddr) {
+		prTempStaRec = cnmGetStaRecByAddressAnyBss(prAdapter,
+			AIS_DEFAULT_INDEX, pucAddr);
+		if (!prTempStaRec)
+			return FALSE;
+		*pucIndex = prTempStaRec->ucWlanIndex;
+		return TRUE;
+	}
+
 	for (ucStaRecIdx = 0; ucStaRecIdx < CFG_STA_REC_NUM;
 	     ucStaRecIdx++) {
 		prTempStaRec = &(prAdapter->arStaRec[ucStaRecIdx]);
-		if (pucAddr) {
-			if (prTempStaRec->fgIsInUse &&
-			    EQUAL_MAC_ADDR(prTempStaRec->aucMacAddr,
-			    pucAddr)) {
-				*pucIndex = prTempStaRec->ucWlanIndex;
-				return TRUE;
-			}
-		} else {
-			if (prTempStaRec->fgIsInUse
-			    && prTempStaRec->ucStaState == STA_STATE_3) {
-				*pucIndex = prTempStaRec->ucWlanIndex;
-				return TRUE;
-			}
+		if (prTempStaRec->fgIsInUse
+		    && prTempStaRec->ucStaState == STA_STATE_3) {
+			*pucIndex = prTempStaRec->ucWlanIndex;
+			return TRUE;
 		}
 	}
 	return FALSE;
@@ -10349,16 +10582,14 @@ uint32_t
 wlanGetStaIdxByWlanIdx(IN struct ADAPTER *prAdapter,
 		       IN uint8_t ucIndex, OUT uint8_t *pucStaIdx)
 {
-	struct WLAN_TABLE *prWtbl;
+	struct STA_RECORD *prStaRec;
 
 	ASSERT(prAdapter);
-	prWtbl = prAdapter->rWifiVar.arWtbl;
 
-	if (ucIndex < WTBL_SIZE) {
-		if (prWtbl[ucIndex].ucUsed && prWtbl[ucIndex].ucPairwise) {
-			*pucStaIdx = prWtbl[ucIndex].ucStaIndex;
-			return WLAN_STATUS_SUCCESS;
-		}
+	prStaRec = cnmGetStaRecByWlanIdx(prAdapter, ucIndex);
+	if (prStaRec) {
+		*pucStaIdx = prStaRec->ucIndex;
+		return WLAN_STATUS_SUCCESS;
 	}
 	return WLAN_STATUS_FAILURE;
 }
@@ -11540,7 +11771,6 @@ int32_t wlanGetFileContent(struct ADAPTER *prAdapter,
 
 void wlanReleasePendingCmdById(struct ADAPTER *prAdapter, uint8_t ucCid)
 {
-	struct QUE *prCmdQue;
 	struct QUE rTempCmdQue;
 	struct QUE *prTempCmdQue = &rTempCmdQue;
 	struct QUE_ENTRY *prQueueEntry = (struct QUE_ENTRY *) NULL;
@@ -11551,29 +11781,28 @@ void wlanReleasePendingCmdById(struct ADAPTER *prAdapter, uint8_t ucCid)
 	ASSERT(prAdapter);
 	DBGLOG(OID, INFO, "Remove pending Cmd: CID %d\n", ucCid);
 
-	/* 1: Clear Pending OID in prAdapter->rPendingCmdQueue */
+	/* 1: Clear Pending OID in prAdapter->aprPendingCmdInfo */
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
 
-	prCmdQue = &prAdapter->rPendingCmdQueue;
-	QUEUE_MOVE_ALL(prTempCmdQue, prCmdQue);
+	nicDequeueAllPendingCmdInfo(prAdapter, prTempCmdQue);
 
 	QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry, struct QUE_ENTRY *);
 	while (prQueueEntry) {
 		prCmdInfo = (struct CMD_INFO *) prQueueEntry;
 		if (prCmdInfo->ucCID != ucCid) {
-			QUEUE_INSERT_TAIL(prCmdQue, prQueueEntry);
-			continue;
-		}
+			nicEnqueuePendingCmdInfo(prAdapter, prCmdInfo);
+		} else {
+			if (prCmdInfo->pfCmdTimeoutHandler) {
+				prCmdInfo->pfCmdTimeoutHandler(prAdapter,
+							       prCmdInfo);
+			} else if (prCmdInfo->fgIsOid) {
+				kalOidComplete(prAdapter->prGlueInfo,
+					       prCmdInfo->fgSetQuery, 0,
+					       WLAN_STATUS_FAILURE);
+			}
 
-		if (prCmdInfo->pfCmdTimeoutHandler) {
-			prCmdInfo->pfCmdTimeoutHandler(prAdapter, prCmdInfo);
-		} else if (prCmdInfo->fgIsOid) {
-			kalOidComplete(prAdapter->prGlueInfo,
-				       prCmdInfo->fgSetQuery, 0,
-				       WLAN_STATUS_FAILURE);
+			cmdBufFreeCmdInfo(prAdapter, prCmdInfo);
 		}
-
-		cmdBufFreeCmdInfo(prAdapter, prCmdInfo);
 		QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
 				  struct QUE_ENTRY *);
 	}
@@ -12042,50 +12271,88 @@ void wlanResumePmHandle(struct GLUE_INFO *prGlueInfo)
 #if CFG_SUPPORT_CSI
 
 #if CFG_SUPPORT_CSI_NF
-bool
-wlanCSINoiseFilter(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData)
+/*
+ * Magnitude of each tone by alpha max plus beta min,
+ * alpha = 1, beta = 3/8. The loop body has no branch and no
+ * cross-tone dependency so the compiler can unroll/vectorize it.
+ */
+static void wlanCSIMagnitude(const int16_t *ai2IData,
+			     const int16_t *ai2QData,
+			     uint32_t *au4Val, uint16_t u2Cnt)
 {
-	uint16_t i, i_data, q_data;
-	uint32_t tmp;
+	uint16_t i;
+	uint32_t i_data, q_data, hi, lo;
 
+	for (i = 0; i < u2Cnt; i++) {
+		i_data = (uint32_t)abs(ai2IData[i]);
+		q_data = (uint32_t)abs(ai2QData[i]);
+		hi = i_data > q_data ? i_data : q_data;
+		lo = i_data > q_data ? q_data : i_data;
+		au4Val[i] = hi + (lo >> 2) + (lo >> 1);
+	}
+}
 
-	/* get csi val */
-	kalMemSet(g_csi_val, 0, sizeof(g_csi_val));
-	for (i = 0; i < prCSIData->u2DataCount; i++) {
+bool
+wlanCSINoiseFilter(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData,
+		   OUT uint32_t csi_val[])
+{
+	uint16_t u2Cnt = prCSIData->u2DataCount;
 #if CFG_SUPPORT_CSI_BFADJ
-		/* Please refer to BFAGC algo. */
-		if ((prCSIData->ucRxMode == RX_VT_HE_MODE) &&
-			(prCSIData->ucBw == RX_VT_FR_MODE_80) &&
-			(prCSIData->ucDataBw == RX_VT_FR_MODE_80)) {
-			if ((i < CSI_DCTONE_NUM) ||
-				(i >= (prCSIData->u2DataCount -
-					CSI_DCTONE_NUM))) {
-				prCSIData->ac2IData[i] = 0;
-				prCSIData->ac2QData[i] = 0;
-			}
-		}
+	uint16_t u2Dc;
 #endif
-		i_data = abs(prCSIData->ac2IData[i]);
-		q_data = abs(prCSIData->ac2QData[i]);
 
-		/* alpha max plus beta min algo.  */
-		/* alpha = 1, beta = 3/8  */
-		tmp = min(i_data, q_data);
-		g_csi_val[i] = max(i_data, q_data) + (tmp>>2) + (tmp>>1);
-	}
+	if (u2Cnt > CSI_MAX_DATA_COUNT)
+		u2Cnt = CSI_MAX_DATA_COUNT;
+
+#if CFG_SUPPORT_CSI_BFADJ
+	/* Please refer to BFAGC algo. */
+	if ((prCSIData->ucRxMode == RX_VT_HE_MODE) &&
+		(prCSIData->ucBw == RX_VT_FR_MODE_80) &&
+		(prCSIData->ucDataBw == RX_VT_FR_MODE_80)) {
+		u2Dc = u2Cnt < CSI_DCTONE_NUM ? u2Cnt : CSI_DCTONE_NUM;
+		kalMemZero(prCSIData->ac2IData, sizeof(int16_t) * u2Dc);
+		kalMemZero(prCSIData->ac2QData, sizeof(int16_t) * u2Dc);
+		kalMemZero(&prCSIData->ac2IData[u2Cnt - u2Dc],
+			sizeof(int16_t) * u2Dc);
+		kalMemZero(&prCSIData->ac2QData[u2Cnt - u2Dc],
+			sizeof(int16_t) * u2Dc);
+	}
+#endif
+
+	/* get csi val, tones beyond the report read as 0 */
+	wlanCSIMagnitude(prCSIData->ac2IData, prCSIData->ac2QData,
+			 csi_val, u2Cnt);
+	kalMemZero(&csi_val[u2Cnt],
+		sizeof(uint32_t) * (CSI_MAX_DATA_COUNT - u2Cnt));
 #if CFG_SUPPORT_CSI_BWDF
-	if (wlanBWDFilter(prAdapter, prCSIData, g_csi_val) == FALSE)
+	if (wlanBWDFilter(prAdapter, prCSIData, csi_val) == FALSE)
 		return FALSE;
 #endif
 	return TRUE;
 }
 
 #if CFG_SUPPORT_CSI_BWDF
+static uint32_t wlanCSISumTones(IN uint32_t csi_val[],
+				IN uint16_t u2Base, IN uint16_t u2Num)
+{
+	const uint32_t *pu4Val = &csi_val[u2Base];
+	uint32_t u4Sum0 = 0, u4Sum1 = 0;
+	uint16_t i;
+
+	/* two independent accumulators, u2Num is always even */
+	for (i = 0; i < u2Num; i += 2) {
+		u4Sum0 += pu4Val[i];
+		u4Sum1 += pu4Val[i + 1];
+	}
+
+	return u4Sum0 + u4Sum1;
+}
+
 bool wlanBWDFilter(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData,
 						IN uint32_t csi_val[])
 {
 	uint8_t  ucDBW = 0;
-	uint16_t dbw20_tone_num, dbw40_tone_num, i;
+	uint16_t dbw20_tone_num, dbw40_tone_num;
 	uint16_t prim20_tone_base = 0, sec20_tone_base = 0, sec40_tone_base = 0;
 	uint32_t prim20_csi_sum = 0, sec20_csi_sum = 0, sec40_csi_sum = 0;
 	uint32_t prim20_csi_avg = 0, sec20_csi_avg = 0, sec40_csi_avg = 0;
@@ -12127,19 +12394,12 @@ bool wlanBWDFilter(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData,
 			return FALSE;
 		}
 
-		for (i = prim20_tone_base;
-				i < (dbw20_tone_num + prim20_tone_base); i++) {
-			prim20_csi_sum += csi_val[i];
-
-		}
-		for (i = sec20_tone_base;
-			i < (dbw20_tone_num + sec20_tone_base); i++) {
-			sec20_csi_sum += csi_val[i];
-		}
-		for (i = sec40_tone_base;
-			i < (dbw40_tone_num + sec40_tone_base); i++) {
-			sec40_csi_sum += csi_val[i];
-		}
+		prim20_csi_sum = wlanCSISumTones(csi_val,
+				prim20_tone_base, dbw20_tone_num);
+		sec20_csi_sum = wlanCSISumTones(csi_val,
+				sec20_tone_base, dbw20_tone_num);
+		sec40_csi_sum = wlanCSISumTones(csi_val,
+				sec40_tone_base, dbw40_tone_num);
 
 		prim20_csi_avg = prim20_csi_sum/dbw20_tone_num;
 		sec20_csi_avg = sec20_csi_sum/dbw20_tone_num;
@@ -12171,78 +12431,82 @@ wlanCSILikeHighPass(IN struct ADAPTER *prAdapter,
 	if (cnt != CSI_MAX_DATA_COUNT)
 		return TRUE;
 
-	for (i = 0; i < cnt; i++) {
-		if (csi_val[i] < CSI_NOISE_TH)
-			noise_cnt++;
-		if (noise_cnt > CSI_NOISE_CNT_TH)
-			return FALSE;
-	}
-	return TRUE;
+	for (i = 0; i < cnt; i++)
+		noise_cnt += (csi_val[i] < CSI_NOISE_TH);
+
+	return noise_cnt <= CSI_NOISE_CNT_TH;
 }
 
 #endif
 
-bool
-wlanPushCSIData(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData)
+/*
+ * The CSI ring has one producer, the CSI event handler, which fills the
+ * slot at Tail in place and publishes it with a release store. Readers
+ * peek the slot at Head and release it after copying out. A report
+ * arriving on a full ring is dropped and counted instead of overwriting
+ * a slot a reader may be copying.
+ */
+struct CSI_DATA_T *wlanCSIRingReserve(IN struct ADAPTER *prAdapter)
 {
 	struct CSI_INFO_T *prCSIInfo = &(prAdapter->rCSIInfo);
-
-	KAL_ACQUIRE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
-
-	/* Put the CSI data into CSI event queue */
-	if (prCSIInfo->u4CSIBufferUsed != 0) {
-		prCSIInfo->u4CSIBufferTail++;
-		prCSIInfo->u4CSIBufferTail %= CSI_RING_SIZE;
+	uint32_t u4Tail = prCSIInfo->u4CSIBufferTail;
+	struct CSI_DATA_T *prCSIData;
+
+	if ((u4Tail + 1) % CSI_RING_SIZE ==
+	    GLUE_LOAD_ACQUIRE(&prCSIInfo->u4CSIBufferHead)) {
+		prCSIInfo->u4CSISeq++;
+		WRITE_ONCE(prCSIInfo->u4CSIDropCnt,
+			   prCSIInfo->u4CSIDropCnt + 1);
+		return NULL;
 	}
 
-	kalMemCopy(&(prCSIInfo->arCSIBuffer[prCSIInfo->u4CSIBufferTail]),
-		prCSIData, sizeof(struct CSI_DATA_T));
+	prCSIData = &(prCSIInfo->arCSIBuffer[u4Tail]);
+	kalMemZero(prCSIData, sizeof(struct CSI_DATA_T));
 
-	if (prCSIInfo->u4CSIBufferUsed < CSI_RING_SIZE) {
-		prCSIInfo->u4CSIBufferUsed++;
-	} else {
-		/*
-		 * While new CSI event comes and the ring buffer is
-		 * already full, the new coming CSI event will
-		 * overwrite the oldest one in the ring buffer.
-		 * Thus, the Head pointer which points to * the
-		 * oldest CSI event in the buffer should be moved too.
-		 */
-		prCSIInfo->u4CSIBufferHead++;
-		prCSIInfo->u4CSIBufferHead %= CSI_RING_SIZE;
-	}
+	return prCSIData;
+}
 
-	KAL_RELEASE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+void wlanCSIRingCommit(IN struct ADAPTER *prAdapter)
+{
+	struct CSI_INFO_T *prCSIInfo = &(prAdapter->rCSIInfo);
+	uint32_t u4Tail = prCSIInfo->u4CSIBufferTail;
 
-	return TRUE;
+	prCSIInfo->arCSIBuffer[u4Tail].u4Seq = prCSIInfo->u4CSISeq++;
+	GLUE_STORE_RELEASE(&prCSIInfo->u4CSIBufferTail,
+			   (u4Tail + 1) % CSI_RING_SIZE);
 }
 
-bool
-wlanPopCSIData(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData)
+/* Caller holds MUTEX_CSI_BUFFER */
+struct CSI_DATA_T *wlanCSIRingPeek(IN struct ADAPTER *prAdapter)
 {
 	struct CSI_INFO_T *prCSIInfo = &(prAdapter->rCSIInfo);
+	uint32_t u4Head = prCSIInfo->u4CSIBufferHead;
 
-	KAL_ACQUIRE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+	if (u4Head == GLUE_LOAD_ACQUIRE(&prCSIInfo->u4CSIBufferTail))
+		return NULL;
 
-	/* No CSI data in the ring buffer */
-	if (prCSIInfo->u4CSIBufferUsed == 0) {
-		KAL_RELEASE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
-		return FALSE;
-	}
+	return &(prCSIInfo->arCSIBuffer[u4Head]);
+}
 
-	kalMemCopy(prCSIData,
-		&(prCSIInfo->arCSIBuffer[prCSIInfo->u4CSIBufferHead]),
-		sizeof(struct CSI_DATA_T));
+/* Caller holds MUTEX_CSI_BUFFER */
+void wlanCSIRingConsume(IN struct ADAPTER *prAdapter)
+{
+	struct CSI_INFO_T *prCSIInfo = &(prAdapter->rCSIInfo);
 
-	prCSIInfo->u4CSIBufferUsed--;
-	if (prCSIInfo->u4CSIBufferUsed != 0) {
-		prCSIInfo->u4CSIBufferHead++;
-		prCSIInfo->u4CSIBufferHead %= CSI_RING_SIZE;
-	}
-	KAL_RELEASE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+	GLUE_STORE_RELEASE(&prCSIInfo->u4CSIBufferHead,
+			   (prCSIInfo->u4CSIBufferHead + 1) % CSI_RING_SIZE);
+}
 
-	return TRUE;
+void wlanCSIRingFlush(IN struct ADAPTER *prAdapter)
+{
+	struct CSI_INFO_T *prCSIInfo = &(prAdapter->rCSIInfo);
+
+	KAL_ACQUIRE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+	GLUE_STORE_RELEASE(&prCSIInfo->u4CSIBufferHead,
+			   GLUE_LOAD_ACQUIRE(&prCSIInfo->u4CSIBufferTail));
+	KAL_RELEASE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
 }
+
 /*
 *CSI TONE MASK
 *this function mask(clear) the null tone && pilot tones
@@ -13347,8 +13611,7 @@ void wlanReleaseAllTxCmdQueue(struct ADAPTER *prAdapter)
 		return;
 
 	/* dump queue info before release for debug */
-	cmdBufDumpCmdQueue(&prAdapter->rPendingCmdQueue,
-				   "waiting response CMD queue");
+	nicDumpPendingCmdInfo(prAdapter);
 #if CFG_SUPPORT_MULTITHREAD
 	cmdBufDumpCmdQueue(&prAdapter->rTxCmdQueue,
 				   "Tx CMD queue");
@@ -13635,14 +13898,13 @@ void wlanTpeFlush(struct GLUE_INFO *prGlueInfo)
 	struct QUE rTempQue;
 	struct QUE *prTempQue = &rTempQue;
 	struct QUE *prTpeAckQueue;
-	struct QUE *prTxQueue;
+	struct QUE_ENTRY *prQueueEntry;
 
 	GLUE_SPIN_LOCK_DECLARATION();
 
 	ASSERT(prGlueInfo);
 
 	prTpeAckQueue = &prGlueInfo->rTpeAckQueue;
-	prTxQueue = &prGlueInfo->rTxQueue;
 
 	if (QUEUE_IS_EMPTY(prTpeAckQueue))
 		return;
@@ -13660,9 +13922,10 @@ void wlanTpeFlush(struct GLUE_INFO *prGlueInfo)
 	prGlueInfo->u8TpeTimestamp = wlanTpeTimeUs();
 
 	/* Append to Tx-Q */
-	GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
-	QUEUE_CONCATENATE_QUEUES(prTxQueue, prTempQue);
-	GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+	while (QUEUE_IS_NOT_EMPTY(prTempQue)) {
+		QUEUE_REMOVE_HEAD(prTempQue, prQueueEntry, struct QUE_ENTRY *);
+		QUEUE_MPSC_PUSH(&prGlueInfo->prTxInbox, prQueueEntry);
+	}
 }
 
 #if KERNEL_VERSION(4, 14, 0) <= LINUX_VERSION_CODE
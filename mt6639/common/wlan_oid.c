@@ -11866,6 +11866,8 @@ wlanoidUpdateSLTMode(IN struct ADAPTER *prAdapter,
 
 			prBssDesc->ucChannelNum = prSltInfo->ucChannel2G4;
 
+			scanUpdateBssDescIndex(prAdapter, prBssDesc);
+
 			prBssDesc->ucPhyTypeSet = PHY_TYPE_SET_802_11ABGN;
 
 			GET_CURRENT_SYSTIME(&prBssDesc->rUpdateTime);
@@ -12070,6 +12072,7 @@ wlanoidUpdateSLTMode(IN struct ADAPTER *prAdapter,
 			break;
 		}
 
+		scanUpdateBssDescIndex(prAdapter, prBssDesc);
 	}
 
 	break;
@@ -395,6 +395,9 @@ uint32_t wlanImageSectionConfig(IN struct ADAPTER *prAdapter,
 uint32_t wlanImageSectionDownload(IN struct ADAPTER *prAdapter,
 	IN uint32_t u4ImgSecSize, IN uint8_t *pucImgSecBuf);
 
+uint32_t wlanImageSectionDownloadBurst(IN struct ADAPTER *prAdapter,
+	IN uint32_t u4Len, IN uint8_t *pucStartPtr);
+
 uint32_t wlanImageQueryStatus(IN struct ADAPTER *prAdapter);
 
 uint32_t wlanConfigWifiFuncStatus(IN struct ADAPTER *prAdapter,
@@ -358,14 +358,20 @@
 #endif
 
 #if CFG_SUPPORT_CSI
+#ifndef CFG_SUPPORT_CSI_NF
 #define CFG_SUPPORT_CSI_NF 0
+#endif
 #define CFG_CSI_DEBUG 0
 #endif
 
 #if CFG_SUPPORT_CSI_NF
+#ifndef CFG_SUPPORT_CSI_BFADJ
 #define CFG_SUPPORT_CSI_BFADJ 0
+#endif
+#ifndef CFG_SUPPORT_CSI_BWDF
 #define CFG_SUPPORT_CSI_BWDF 0
 #endif
+#endif
 
 /*------------------------------------------------------------------------------
  * Support Extend Range feature
@@ -670,6 +676,45 @@
 #define CFG_RX_MAX_MPDU_SIZE	CFG_RX_MAX_PKT_SIZE
 #endif
 
+/*! PCIe RX buffers are taken from a pool of pages which stay DMA mapped.
+ *  A buffer is reused once the OS has released it, so RX only syncs the
+ *  buffer instead of unmapping, mapping and allocating it per packet.
+ */
+#ifndef CFG_SUPPORT_PCIE_RX_POOL
+#if defined(_HIF_PCIE)
+#define CFG_SUPPORT_PCIE_RX_POOL	1
+#else
+#define CFG_SUPPORT_PCIE_RX_POOL	0
+#endif
+#endif
+
+/*! TX MSDU tokens are handed out from small per-CPU caches which are
+ *  refilled from and drained to the global token stack in batches, so
+ *  TX from several CPUs does not serialize on the global token lock.
+ */
+#ifndef CFG_SUPPORT_MSDU_TOKEN_CPU_CACHE
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+#define CFG_SUPPORT_MSDU_TOKEN_CPU_CACHE	1
+#else
+#define CFG_SUPPORT_MSDU_TOKEN_CPU_CACHE	0
+#endif
+#endif
+
+/*------------------------------------------------------------------------------
+ * Bind the RX descriptor accessors at compile time instead of through the
+ * RX_DESC_OPS_T function pointers. Only valid when a single RXD version is
+ * built in (CONNAC3X only); the build system sets it for such chips.
+ *------------------------------------------------------------------------------
+ */
+#ifndef CFG_RXD_STATIC_BIND
+#define CFG_RXD_STATIC_BIND	0
+#endif
+
+#if CFG_RXD_STATIC_BIND && \
+	((CFG_SUPPORT_CONNAC3X == 0) || (CFG_SUPPORT_CONNAC2X == 1))
+#error "CFG_RXD_STATIC_BIND requires a CONNAC3X only build"
+#endif
+
 /*! Minimum RX packet size, if lower than this value, drop incoming packet */
 #define CFG_RX_MIN_PKT_SIZE	10 /*!< 802.11 Control Frame is 10 bytes */
 
@@ -842,6 +887,13 @@
 #define CFG_ASSERT_DUMP                         1
 
 #define CFG_SUPPORT_TRACE_TC4			0
+
+/* DBGTRACE binary ring, needs the kernel vbin_printf()/bstr_printf() */
+#if defined(CONFIG_BINARY_PRINTF)
+#define CFG_SUPPORT_DBG_TRACE_RING		1
+#else
+#define CFG_SUPPORT_DBG_TRACE_RING		0
+#endif
 /*------------------------------------------------------------------------------
  * Flags of Firmware Download Option.
  *------------------------------------------------------------------------------
@@ -1191,6 +1243,11 @@
 #define CFG_SUPPORT_MULTITHREAD		1
 #endif
 
+/* Debug only: time every TX port queue lock hold, shown by tx_latency proc */
+#ifndef CFG_TX_PORT_QUE_LOCK_STAT
+#define CFG_TX_PORT_QUE_LOCK_STAT	0
+#endif
+
 /* Transfer Oid from main_thread to workqueue */
 #ifndef CFG_REDIRECT_OID_SUPPORT
 #if (CFG_SUPPORT_MULTITHREAD == 1) && (CFG_SUPPORT_SUPPLICANT_SME == 1)
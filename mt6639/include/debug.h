@@ -87,6 +87,10 @@ extern int get_logtoomuch_enable(void) __attribute__((weak));
 
 extern struct MIB_INFO_STAT g_arMibInfo[ENUM_BAND_NUM];
 
+#if CFG_SUPPORT_DBG_TRACE_RING
+extern u_int8_t fgDbgTraceBinary;
+#endif
+
 /*******************************************************************************
  *                              C O N S T A N T S
  *******************************************************************************
@@ -124,6 +128,13 @@ extern struct MIB_INFO_STAT g_arMibInfo[ENUM_BAND_NUM];
 #endif
 #define DBG_ALL_MODULE_IDX      0xFFFFFFFF
 
+#if CFG_SUPPORT_DBG_TRACE_RING
+/* DBGTRACE records kept per CPU, must be a power of 2 */
+#define DBG_TRACE_RING_SIZE     1024
+/* 32-bit words of packed arguments per DBGTRACE record */
+#define DBG_TRACE_ARG_WORDS     24
+#endif
+
 #define DEG_HIF_ALL             BIT(0)
 #define DEG_HIF_HOST_CSR        BIT(1)
 #define DEG_HIF_PDMA            BIT(2)
@@ -217,6 +228,23 @@ enum ENUM_DBG_MODULE {
 #endif
 	DBG_MODULE_NUM		/* Notice the XLOG check */
 };
+#if CFG_SUPPORT_DBG_TRACE_RING
+/* One DBGTRACE call, arguments packed by vbin_printf() */
+struct DBG_TRACE_REC {
+	uint64_t u8Time;	/* ns */
+	const char *pucFmt;
+	const char *pucFunc;
+	uint32_t u4Seq;		/* write index + 1, 0 while being written */
+	uint32_t u4Tid;
+	uint32_t au4Arg[DBG_TRACE_ARG_WORDS];
+};
+
+struct DBG_TRACE_RING {
+	uint32_t u4WriteIdx;
+	struct DBG_TRACE_REC arRec[DBG_TRACE_RING_SIZE];
+};
+#endif
+
 enum ENUM_DBG_ASSERT_CTRL_LEVEL {
 	DBG_ASSERT_CTRL_LEVEL_ERROR,
 	DBG_ASSERT_CTRL_LEVEL_WARN,
@@ -652,6 +680,8 @@ struct WLAN_DEBUG_INFO {
 #define DBGLOG_LIMITED(_Module, _Class, _Fmt)
 #define DBGLOG_MEM8(_Module, _Class, _StartAddr, _Length)
 #define DBGLOG_MEM32(_Module, _Class, _StartAddr, _Length)
+#define DBGTRACE(_Module, _Class, _Fmt)
+#define DBGTRACE_LIMITED(_Module, _Class, _Fmt)
 #else
 #define DBGLOG(_Mod, _Clz, _Fmt, ...) \
 	do { \
@@ -671,6 +701,37 @@ struct WLAN_DEBUG_INFO {
 			 KAL_GET_CURRENT_THREAD_ID(), \
 			 __func__, ##__VA_ARGS__); \
 	} while (0)
+#if CFG_SUPPORT_DBG_TRACE_RING
+/* Hot path log, packed into the per-CPU ring in binary mode and only
+ * formatted when /proc dbg_trace is read. In text mode it prints through
+ * _LogFunc, so DBGTRACE and DBGTRACE_LIMITED keep the rate limiting of
+ * the DBGLOG/DBGLOG_LIMITED call they replace.
+ */
+#define DBGTRACE_FUNC(_LogFunc, _Mod, _Clz, _Fmt, ...) \
+	do { \
+		if ((aucDebugModule[DBG_##_Mod##_IDX] & \
+			 DBG_CLASS_##_Clz) == 0) \
+			break; \
+		if (READ_ONCE(fgDbgTraceBinary)) { \
+			wlanDbgTraceRecord(__func__, \
+				"(" #_Mod " " #_Clz ") " _Fmt, \
+				##__VA_ARGS__); \
+			break; \
+		} \
+		_LogFunc("[%u]%s:(" #_Mod " " #_Clz ") " _Fmt, \
+			 KAL_GET_CURRENT_THREAD_ID(), \
+			 __func__, ##__VA_ARGS__); \
+	} while (0)
+#define DBGTRACE(_Mod, _Clz, _Fmt, ...) \
+	DBGTRACE_FUNC(LOG_FUNC, _Mod, _Clz, _Fmt, ##__VA_ARGS__)
+#define DBGTRACE_LIMITED(_Mod, _Clz, _Fmt, ...) \
+	DBGTRACE_FUNC(LOG_FUNC_LIMITED, _Mod, _Clz, _Fmt, ##__VA_ARGS__)
+#else
+#define DBGTRACE(_Mod, _Clz, _Fmt, ...) \
+	DBGLOG(_Mod, _Clz, _Fmt, ##__VA_ARGS__)
+#define DBGTRACE_LIMITED(_Mod, _Clz, _Fmt, ...) \
+	DBGLOG_LIMITED(_Mod, _Clz, _Fmt, ##__VA_ARGS__)
+#endif
 #define DBGFWLOG(_Mod, _Clz, _Fmt, ...) \
 	do { \
 		if ((aucDebugModule[DBG_##_Mod##_IDX] & \
@@ -838,6 +899,15 @@ u_int8_t wlanDbgSetGlobalLogLevel(uint32_t u4Module, uint32_t u4Level);
 void wlanFillTimestamp(struct ADAPTER *prAdapter, void *pvPacket,
 		       uint8_t ucPhase);
 
+#if CFG_SUPPORT_DBG_TRACE_RING
+uint32_t wlanDbgTraceSetMode(u_int8_t fgBinary);
+void wlanDbgTraceUninit(void);
+void wlanDbgTraceRecord(const char *pucFunc, const char *pucFmt, ...);
+uint32_t wlanDbgTraceGetWriteIdx(uint32_t u4Cpu);
+u_int8_t wlanDbgTraceRead(uint32_t u4Cpu, uint32_t u4Idx,
+			  struct DBG_TRACE_REC *prRec);
+#endif
+
 void halShowPseInfo(IN struct ADAPTER *prAdapter);
 void halShowPleInfo(IN struct ADAPTER *prAdapter,
 	u_int8_t fgDumpTxd);
@@ -110,6 +110,17 @@
 #define STA_REC_INDEX_BMCAST		0xFF
 #define STA_REC_INDEX_NOT_FOUND		0xFE
 
+/* Open addressing index of arStaRec keyed by (BSS index, MAC address).
+ * Kept at least twice as large as CFG_STA_REC_NUM so probes stay short.
+ */
+#define STA_REC_HASH_BITS		6
+#define STA_REC_HASH_SIZE		(1 << STA_REC_HASH_BITS)
+#define STA_REC_HASH_MASK		(STA_REC_HASH_SIZE - 1)
+
+#if (CFG_STA_REC_NUM * 2 > STA_REC_HASH_SIZE)
+#error "STA_REC_HASH_BITS is too small for CFG_STA_REC_NUM"
+#endif
+
 /* Number of SW queues in each STA_REC: AC0~AC4 */
 #define STA_WAIT_QUEUE_NUM		5
 
@@ -280,6 +291,8 @@ struct _QOS_MAP_SET {
 /* Define STA record structure */
 struct STA_RECORD {
 	struct LINK_ENTRY rLinkEntry;
+	/* Entry of ADAPTER.arStaRecOfBss[ucBssIndex] while in use */
+	struct LINK_ENTRY rLinkEntryOfBss;
 	uint8_t ucIndex;	/* Not modify it except initializing */
 	uint8_t ucWlanIndex;	/* WLAN table index */
 
@@ -1152,6 +1165,12 @@ void cnmStaFreeAllStaByNetwork(struct ADAPTER *prAdapter, uint8_t ucBssIndex,
 struct STA_RECORD *cnmGetStaRecByIndex(IN struct ADAPTER *prAdapter,
 	IN uint8_t ucIndex);
 
+struct STA_RECORD *cnmGetStaRecByWlanIdx(struct ADAPTER *prAdapter,
+	uint8_t ucWlanIdx);
+
+struct STA_RECORD *cnmGetStaRecByAddressAnyBss(struct ADAPTER *prAdapter,
+	uint8_t ucBssIndexHint, uint8_t *pucPeerMacAddr);
+
 struct STA_RECORD *cnmGetStaRecByAddress(struct ADAPTER *prAdapter,
 	uint8_t ucBssIndex, uint8_t aucPeerMACAddress[]);
 
@@ -102,6 +102,28 @@
 #error WAKE_LOCK_MAX_TIME is too large
 #endif
 
+/* Hierarchical timer wheel, the unit is OS_SYSTIME tick.
+ * Level 0 has 1-tick slots, a slot of an upper level covers one full
+ * round of the level below it.
+ */
+#define TIMER_WHEEL_L0_BITS		8
+#define TIMER_WHEEL_LN_BITS		6
+#define TIMER_WHEEL_LN_NUM		2
+#define TIMER_WHEEL_L0_SIZE		BIT(TIMER_WHEEL_L0_BITS)
+#define TIMER_WHEEL_LN_SIZE		BIT(TIMER_WHEEL_LN_BITS)
+#define TIMER_WHEEL_L0_MASK		(TIMER_WHEEL_L0_SIZE - 1)
+#define TIMER_WHEEL_LN_MASK		(TIMER_WHEEL_LN_SIZE - 1)
+#define TIMER_WHEEL_SLOT_NUM		(TIMER_WHEEL_L0_SIZE + \
+					TIMER_WHEEL_LN_NUM * \
+					TIMER_WHEEL_LN_SIZE)
+#define TIMER_WHEEL_BITMAP_NUM		(TIMER_WHEEL_SLOT_NUM / 32)
+/* Ticks covered by the whole wheel */
+#define TIMER_WHEEL_RANGE		BIT(TIMER_WHEEL_L0_BITS + \
+					TIMER_WHEEL_LN_NUM * \
+					TIMER_WHEEL_LN_BITS)
+/* Slot index of a timer waiting in ROOT_TIMER.rExpiredLink */
+#define TIMER_WHEEL_SLOT_EXPIRED	TIMER_WHEEL_SLOT_NUM
+
 enum ENUM_TIMER_WAKELOCK_TYPE_T {
 	TIMER_WAKELOCK_AUTO,
 	TIMER_WAKELOCK_NONE,
@@ -119,7 +141,7 @@ struct TIMER {
 	struct LINK_ENTRY rLinkEntry;
 	OS_SYSTIME rExpiredSysTime;
 	uint16_t u2Minutes;
-	uint16_t u2Reserved;
+	uint16_t u2WheelSlot;
 	unsigned long ulDataPtr;
 	PFN_MGMT_TIMEOUT_FUNC pfMgmtTimeOutFunc;
 	enum ENUM_TIMER_WAKELOCK_TYPE_T eType;
@@ -236,6 +258,9 @@ void cnmTimerStartTimer(IN struct ADAPTER *prAdapter, IN struct TIMER *prTimer,
 
 void cnmTimerDoTimeOutCheck(IN struct ADAPTER *prAdapter);
 
+uint32_t cnmTimerDumpStatus(IN struct ADAPTER *prAdapter, IN uint8_t *pucBuf,
+			    IN uint32_t u4Max);
+
 /*******************************************************************************
  *                              F U N C T I O N S
  *******************************************************************************
@@ -284,9 +284,19 @@ enum ENUM_MBOX_ID {
 	MBOX_ID_TOTAL_NUM
 };
 
-/* Define Mailbox structure */
+/* Define Mailbox structure. Senders push messages with a compare and
+ * swap on prHead, so the list is linked by rLinkEntry.prNext in LIFO
+ * order. The main thread takes the whole list with one exchange.
+ */
 struct MBOX {
-	struct LINK rLinkHead;
+	struct LINK_ENTRY *prHead;
+};
+
+/*! Handler statistics of one message ID */
+struct MBOX_MSG_STAT {
+	uint32_t u4HitCnt;
+	uint32_t u4MaxTime;	/* ns */
+	uint64_t u8TotalTime;	/* ns */
 };
 
 struct MSG_SAA_FSM_START {
@@ -80,6 +80,24 @@
 #define SCN_MAX_BUFFER_SIZE \
 	(CFG_MAX_NUM_BSS_LIST * ALIGN_4(sizeof(struct BSS_DESC)))
 
+/* Number of BSSID hash buckets of SCAN list, power of 2 */
+#define SCN_BSS_DESC_HASH_NUM			64
+
+#define SCN_BSS_DESC_HASH(_aucBSSID) \
+	(((_aucBSSID)[3] ^ (_aucBSSID)[4] ^ (_aucBSSID)[5]) & \
+	(SCN_BSS_DESC_HASH_NUM - 1))
+
+/* Number of channel buckets per band, prime since 5G/6G channel
+ * numbers step by 4
+ */
+#define SCN_BSS_DESC_CHNL_HASH_NUM		13
+
+#define SCN_BSS_DESC_CHNL_HASH(_ucChannelNum) \
+	((_ucChannelNum) % SCN_BSS_DESC_CHNL_HASH_NUM)
+
+#define SCN_BSS_DESC_BAND_IDX(_eBand) \
+	(((_eBand) < BAND_NUM) ? (_eBand) : BAND_NULL)
+
 /* Remove SCAN result except the connected one. */
 #define SCN_RM_POLICY_EXCLUDE_CONNECTED		BIT(0)
 
@@ -280,6 +298,15 @@ struct BSS_DESC {
 	/* Support AP Selection*/
 	struct LINK_ENTRY rLinkEntryEss[KAL_AIS_NUM];
 
+	/* Entries of the BSSID hash and (band, channel) buckets, with the
+	 * bucket indexes they were filed under.
+	 */
+	struct LINK_ENTRY rLinkEntryHash;
+	struct LINK_ENTRY rLinkEntryChnl;
+	uint8_t ucHashIdx;
+	uint8_t ucChnlBandIdx;
+	uint8_t ucChnlHashIdx;
+
 	uint8_t aucBSSID[MAC_ADDR_LEN];
 
 	/* For IBSS, the SrcAddr is different from BSSID */
@@ -564,6 +591,10 @@ struct SCAN_INFO {
 
 	struct LINK rBSSDescList;
 
+	/* Index of rBSSDescList by BSSID and by (band, channel) */
+	struct LINK arBssDescHash[SCN_BSS_DESC_HASH_NUM];
+	struct LINK aarBssDescChnl[BAND_NUM][SCN_BSS_DESC_CHNL_HASH_NUM];
+
 	struct LINK rFreeBSSDescList;
 
 	struct LINK rPendingMsgList;
@@ -971,6 +1002,8 @@ void scanInsertBssDescToList(IN struct LINK *prBSSDescList,
 			     IN u_int8_t init);
 void scanResetBssDesc(IN struct ADAPTER *prAdapter,
 		      IN struct BSS_DESC *prBssDesc);
+void scanUpdateBssDescIndex(IN struct ADAPTER *prAdapter,
+			    IN struct BSS_DESC *prBssDesc);
 
 /* Check if VHT IE filled in Epigram IE */
 void scanCheckEpigramVhtIE(IN uint8_t *pucBuf, IN struct BSS_DESC *prBssDesc);
@@ -81,12 +81,19 @@
 
 #define MIN_TX_DURATION_TIME_MS 100
 
+/* One pending command slot per 8-bit command sequence number */
+#define PENDING_CMD_SLOT_NUM 256
+
 #if CFG_SUPPORT_CSI
 #define CSI_RING_SIZE 1000
 #define CSI_MAX_DATA_COUNT 256
 #define CSI_MAX_RSVD1_COUNT 10
 
 #define CSI_H_max_Index 4		/* for 2x2 support*/
+
+/* Binary record export of /proc csi_ring, see struct CSI_EXPORT_HDR */
+#define CSI_EXPORT_MAGIC 0xC5
+#define CSI_EXPORT_VER 1
 #define CSI_MAX_RSVD2_COUNT 10
 #define Max_Stream_Bytes 3000
 
@@ -1084,6 +1091,15 @@ struct WIFI_VAR {
 	uint8_t ucThreadScheduling;
 	uint8_t ucThreadPriority;
 	int8_t cThreadNice;
+	/* Run OS TX dequeue in tx_thread instead of main_thread */
+	uint8_t ucTxDataThread;
+	/* Process RX data RFBs in rx_thread instead of main_thread */
+	uint8_t ucRxDataThread;
+	/* Allowed CPUs per driver thread, bit n is CPU n, 0 is any */
+	uint32_t u4MainThreadCpuMask;
+	uint32_t u4TxDataThreadCpuMask;
+	uint32_t u4HifThreadCpuMask;
+	uint32_t u4RxThreadCpuMask;
 
 	uint8_t ucTcRestrict;
 	uint32_t u4MaxTxDeQLimit;
@@ -1091,6 +1107,9 @@ struct WIFI_VAR {
 
 	uint32_t u4NetifStopTh;
 	uint32_t u4NetifStartTh;
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	uint32_t u4TxKickBurstMax;
+#endif
 	struct PARAM_GET_CHN_INFO rChnLoadInfo;
 
 #if CFG_SUPPORT_MTK_SYNERGY
@@ -1231,6 +1250,12 @@ struct WIFI_VAR {
 
 	/* Tx Msdu Queue method */
 	uint8_t ucTxMsduQueue;
+	/* 1: one lock per TX port queue, 0: one lock for all */
+	uint8_t ucTxPortQueLock;
+#if (CFG_SUPPORT_TX_TSO_SW == 1)
+	/* 1: SW TSO segments reference the payload pages, 0: copy them */
+	uint8_t ucSwTsoRefFrag;
+#endif
 
 	uint32_t u4MTU; /* net device maximum transmission unit */
 #if CFG_SUPPORT_RX_GRO
@@ -1319,10 +1344,21 @@ struct WIFI_VAR {
 
 /* cnm_timer module */
 struct ROOT_TIMER {
-	struct LINK rLinkHead;
+	struct LINK arWheel[TIMER_WHEEL_SLOT_NUM];
+	struct LINK rExpiredLink;
+	uint32_t au4WheelBitmap[TIMER_WHEEL_BITMAP_NUM];
+	uint32_t u4WheelTimerNum;
+	OS_SYSTIME rWheelTime;	/* Next tick to be processed */
 	OS_SYSTIME rNextExpiredSysTime;
 	KAL_WAKE_LOCK_T *prWakeLock;
 	u_int8_t fgWakeLocked;
+
+	/* Statistics of cnmTimerDoTimeOutCheck */
+	uint32_t u4LastFiredNum;
+	uint32_t u4MaxFiredNum;
+	uint32_t u4TotalFiredNum;
+	uint32_t u4MaxCallbackUs;
+	PFN_MGMT_TIMEOUT_FUNC pfnMaxCallback;
 };
 
 /* FW/DRV/NVRAM version information */
@@ -1519,6 +1555,34 @@ struct CSI_DATA_T {
 	uint8_t ucRsvd4;
 	uint32_t Antenna_pattern;
 	uint32_t u4TRxIdx;
+	uint32_t u4Seq;		/* push sequence, gaps are drops */
+};
+
+/*
+ * CSI_EXPORT_HDR leads each record read from /proc csi_ring and is
+ * followed by u4RecLen bytes of struct CSI_DATA_T as built in this
+ * driver. CSI_EXPORT_VER is bumped whenever CSI_DATA_T changes.
+ */
+struct CSI_EXPORT_HDR {
+	uint8_t ucMagic;
+	uint8_t ucVer;
+	uint16_t u2HdrLen;
+	uint32_t u4RecLen;
+	uint32_t u4Seq;
+	uint32_t u4DropCnt;	/* reports dropped on a full ring so far */
+};
+
+/*
+ * CSI_SCRATCH_T is the work area of a CSI report while it is
+ * post-processed. Events are handled one at a time on main_thread,
+ * so a single instance in CSI_INFO_T serves every report.
+ */
+struct CSI_SCRATCH_T {
+	int16_t ai2TempIData[CSI_MAX_DATA_COUNT];
+	int16_t ai2TempQData[CSI_MAX_DATA_COUNT];
+#if CFG_SUPPORT_CSI_NF
+	uint32_t au4CsiVal[CSI_MAX_DATA_COUNT];
+#endif
 };
 
 /*
@@ -1535,13 +1599,16 @@ struct CSI_INFO_T {
 	uint8_t ucMode;
 	uint8_t ucValue1[CSI_CONFIG_ITEM_NUM];
 	uint8_t ucValue2[CSI_CONFIG_ITEM_NUM];
-	/* Variable for manipulating the CSI ring buffer */
+	/* Variable for manipulating the CSI ring buffer.
+	 * Single producer (event handler) owns Tail, readers own Head
+	 * and are serialized by MUTEX_CSI_BUFFER. One slot stays empty.
+	 */
 	struct CSI_DATA_T arCSIBuffer[CSI_RING_SIZE];
 	uint32_t u4CSIBufferHead;
 	uint32_t u4CSIBufferTail;
-	uint32_t u4CSIBufferUsed;
-	int16_t ai2TempIData[CSI_MAX_DATA_COUNT];
-	int16_t ai2TempQData[CSI_MAX_DATA_COUNT];
+	uint32_t u4CSISeq;
+	uint32_t u4CSIDropCnt;
+	struct CSI_SCRATCH_T rScratch;
 	/*for usr to get the specific H(jw), 0 for all */
 	uint16_t Matrix_Get_Bit;
 	uint8_t byte_stream[Max_Stream_Bytes];/*send bytes to proc interfacel */
@@ -1573,6 +1640,7 @@ struct ADAPTER {
 	uint8_t ucWtblEntryNum;
 	uint8_t ucTxDefaultWlanIndex;
 	uint8_t ucP2PDevBssIdx;
+	uint8_t ucStaRecNum;	/* Usable entries of arStaRec */
 
 #if CFG_TCP_IP_CHKSUM_OFFLOAD
 	/* Does FW support Checksum Offload feature */
@@ -1610,6 +1678,12 @@ struct ADAPTER {
 #endif
 
 	struct STA_RECORD arStaRec[CFG_STA_REC_NUM];
+	/* arStaRec index by (BSS index, MAC), STA_REC_INDEX_NOT_FOUND: free */
+	uint8_t aucStaRecHash[STA_REC_HASH_SIZE];
+	/* In use STA_RECORD by its pairwise WLAN index */
+	struct STA_RECORD *aprStaRecByWlanIdx[WTBL_SIZE];
+	/* In use STA_RECORD linked by rLinkEntryOfBss, per BSS index */
+	struct LINK arStaRecOfBss[MAX_BSSID_NUM + 1];
 
 	/* Element for TX PATH */
 	struct TX_CTRL rTxCtrl;
@@ -1671,6 +1745,12 @@ struct ADAPTER {
 	uint32_t u4StaPendBitmap;
 	/* TX Direct related : END */
 
+	/* Commands waiting for response, indexed by ucCmdSeqNum. A command
+	 * whose slot is still taken by an older one goes to rPendingCmdQueue.
+	 * Both are protected by SPIN_LOCK_CMD_PENDING.
+	 */
+	struct CMD_INFO *aprPendingCmdInfo[PENDING_CMD_SLOT_NUM];
+	uint32_t u4PendingCmdNum;
 	struct QUE rPendingCmdQueue;
 
 #if CFG_SUPPORT_MULTITHREAD
@@ -1689,6 +1769,9 @@ struct ADAPTER {
 	struct QUE rTxP1Queue;
 #else
 	struct QUE rTxPQueue[TX_PORT_NUM];
+#if CFG_TX_PORT_QUE_LOCK_STAT
+	struct TX_PORT_QUE_STAT arTxPQueueStat[TX_PORT_NUM];
+#endif
 #endif
 	struct QUE rRxQueue;
 	struct QUE rTxDataDoneQueue;
@@ -1777,6 +1860,7 @@ struct ADAPTER {
 
 	/* Mailboxs for inter-module communication */
 	struct MBOX arMbox[MBOX_ID_TOTAL_NUM];
+	struct MBOX_MSG_STAT arMboxMsgStat[MID_TOTAL_NUM];
 
 	/* Timers for OID Pending Handling */
 	struct TIMER rOidTimeoutTimer;
@@ -1168,10 +1168,16 @@ do { \
 	kal_virt_get_wifi_func_stat(_prAdapter, &_u4Result)
 
 #define HAL_WIFI_FUNC_OFF_CHECK(_prAdapter, _checkItem, _pfgResult) \
-	kal_virt_chk_wifi_func_off(_prAdapter, _checkItem, _pfgResult)
+do { \
+	struct mt66xx_chip_info *prChipInfo = (_prAdapter)->chip_info; \
+	kal_virt_chk_wifi_func_off(_prAdapter, _checkItem, _pfgResult); \
+} while (0)
 
 #define HAL_WIFI_FUNC_READY_CHECK(_prAdapter, _checkItem, _pfgResult) \
-	kal_virt_chk_wifi_func_ready(_prAdapter, _checkItem, _pfgResult)
+do { \
+	struct mt66xx_chip_info *prChipInfo = (_prAdapter)->chip_info; \
+	kal_virt_chk_wifi_func_ready(_prAdapter, _checkItem, _pfgResult); \
+} while (0)
 
 #define HAL_SET_MAILBOX_READ_CLEAR(_prAdapter, _fgEnableReadClear) \
 	kal_virt_set_mailbox_readclear(_prAdapter, _fgEnableReadClear)
@@ -1312,6 +1318,8 @@ bool halWpdmaAllocRxRing(struct GLUE_INFO *prGlueInfo, uint32_t u4Num,
 uint8_t halRingDataSelectByWmmIndex(
 	IN struct ADAPTER *prAdapter,
 	IN uint8_t ucWmmIndex);
+uint32_t halWpdmaBeginTxBurst(struct GLUE_INFO *prGlueInfo);
+void halWpdmaEndTxBurst(struct GLUE_INFO *prGlueInfo, uint32_t u4Slot);
 #endif /* defined(_HIF_PCIE) || defined(_HIF_AXI) */
 
 #endif /* _HAL_H */
@@ -246,6 +246,16 @@ void nicProcessAbnormalInterrupt(IN struct ADAPTER
 void nicSetSwIntr(IN struct ADAPTER *prAdapter,
 		  IN uint32_t u4SwIntrBitmap);
 
+void nicInitPendingCmdInfo(IN struct ADAPTER *prAdapter);
+
+void nicEnqueuePendingCmdInfo(IN struct ADAPTER *prAdapter,
+			      IN struct CMD_INFO *prCmdInfo);
+
+void nicDequeueAllPendingCmdInfo(IN struct ADAPTER *prAdapter,
+				 OUT struct QUE *prQue);
+
+void nicDumpPendingCmdInfo(IN struct ADAPTER *prAdapter);
+
 struct CMD_INFO *nicGetPendingCmdInfo(IN struct ADAPTER
 				      *prAdapter, IN uint8_t ucSeqNum);
 
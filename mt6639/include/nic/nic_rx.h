@@ -95,6 +95,9 @@
 
 #define RX_RETURN_INDICATED_RFB_TIMEOUT_SEC     3
 
+/* Max RFBs parked in an open return batch before returning them directly */
+#define RX_RETURN_BATCH_MAX_NUM                 64
+
 #define RX_PROCESS_TIMEOUT           1000
 
 #if defined(_HIF_SDIO) && defined(WINDOWS_DDK)
@@ -998,12 +1001,41 @@ struct RX_CSO_REPORT_T {
 };
 #endif /* CFG_TCP_IP_CHKSUM_OFFLOAD */
 
+/*! Number of firmware event IDs, both legacy and unified EID are 8 bits */
+#define RX_EVENT_ID_NUM				256
+
+/*! Event dispatch statistics of one event ID */
+struct RX_EVENT_STAT {
+	uint32_t u4HitCnt;
+	uint32_t u4MaxTime;	/* ns */
+	uint64_t u8TotalTime;	/* ns */
+};
+
+/*! Execution contexts that may hold an open RFB return batch */
+enum ENUM_RX_RETURN_BATCH {
+	RX_RETURN_BATCH_TASK = 0,	/* RX thread, owner is the thread id */
+	RX_RETURN_BATCH_SOFTIRQ,	/* NAPI poll, owner is CPU id + 1 */
+	RX_RETURN_BATCH_NUM
+};
+
+/*! RFBs returned while a batch is open, handed back by
+ *  nicRxEndReturnBatch() in a single critical section
+ */
+struct RX_RETURN_BATCH {
+	struct QUE rRfbList;		/* returned as is */
+	struct QUE rRefillList;		/* need a new packet first */
+	uint32_t u4Owner;
+	uint32_t u4Depth;
+};
+
 /*! RX configuration type structure */
 struct RX_CTRL {
 	uint32_t u4RxCachedSize;
 	uint8_t *pucRxCached;
 	struct QUE rFreeSwRfbList;
 	struct QUE rReceivedRfbList;
+	/* Data RFBs left for rx_thread, see fgRxDataThread */
+	struct QUE rReceivedDataRfbList;
 	struct QUE rIndicatedRfbList;
 
 #if CFG_SDIO_RX_AGG
@@ -1034,6 +1066,15 @@ struct RX_CTRL {
 
 	/* Store SysTime of Last Rx */
 	uint32_t u4LastRxTime[MAX_BSSID_NUM];
+
+	/* Event dispatch statistics, indexed by EID */
+	struct RX_EVENT_STAT arEventStat[RX_EVENT_ID_NUM];
+	struct RX_EVENT_STAT arUniEventStat[RX_EVENT_ID_NUM];
+
+	struct RX_RETURN_BATCH arReturnBatch[RX_RETURN_BATCH_NUM];
+
+	/* Data RFBs are processed by rx_thread, not main_thread */
+	u_int8_t fgRxDataThread;
 };
 
 struct RX_MAILBOX {
@@ -1145,12 +1186,36 @@ struct ACTION_FRAME_SIZE_MAP {
 	{kalMemZero(&prRxCtrl->au8Statistics[0], \
 	sizeof(prRxCtrl->au8Statistics)); }
 
+/* Data RFBs may run outside main_thread, in the HIF RX direct path or in
+ * rx_thread, so the data path takes the RX direct locks
+ */
+#define RX_DATA_IS_CONCURRENT(_prAdapter) \
+	(HAL_IS_RX_DIRECT(_prAdapter) || \
+	 (_prAdapter)->rRxCtrl.fgRxDataThread)
+
 #define RX_STATUS_TEST_MORE_FLAG(flag)	\
 	((u_int8_t)((flag & RX_STATUS_FLAG_MORE_PACKET) ? TRUE : FALSE))
 
+/* With CFG_RXD_STATIC_BIND the RX descriptor hooks are resolved at compile
+ * time to the nic_rxd_static_* mappings of the only RXD version built in,
+ * so the per-packet descriptor accessors inline to plain bit extraction.
+ * Otherwise they are called through the chip's RX_DESC_OPS_T table.
+ */
+#if CFG_RXD_STATIC_BIND
+#define RX_DESC_OPS_EXIST(__RxDescOps, __fn_name) \
+	((void)(__RxDescOps), TRUE)
+#define RX_DESC_OPS_FN(__RxDescOps, __fn_name)	nic_rxd_static_##__fn_name
+#else
+#define RX_DESC_OPS_EXIST(__RxDescOps, __fn_name) \
+	((__RxDescOps)->nic_rxd_##__fn_name != NULL)
+#define RX_DESC_OPS_FN(__RxDescOps, __fn_name) \
+	((__RxDescOps)->nic_rxd_##__fn_name)
+#endif /* CFG_RXD_STATIC_BIND */
+
 #define RX_STATUS_GET(__RxDescOps, __out_buf, __fn_name, __rx_status) { \
-	if (__RxDescOps->nic_rxd_##__fn_name) \
-		__out_buf = __RxDescOps->nic_rxd_##__fn_name(__rx_status); \
+	if (RX_DESC_OPS_EXIST(__RxDescOps, __fn_name)) \
+		__out_buf = RX_DESC_OPS_FN(__RxDescOps, __fn_name)( \
+			__rx_status); \
 	else {\
 		__out_buf = 0; \
 		DBGLOG(RX, ERROR, "%s:: no hook api??\n", \
@@ -1482,6 +1547,14 @@ void nicRxProcessPacketType(
 
 void nicRxProcessRFBs(IN struct ADAPTER *prAdapter);
 
+u_int8_t nicRxIsDataRFB(IN struct ADAPTER *prAdapter,
+	IN struct SW_RFB *prSwRfb);
+
+void nicRxEnqueueReceivedRFB(IN struct ADAPTER *prAdapter,
+	IN struct SW_RFB *prSwRfb);
+
+void nicRxProcessDataRFBs(IN struct ADAPTER *prAdapter);
+
 void nicRxProcessMsduReport(IN struct ADAPTER *prAdapter,
 	IN OUT struct SW_RFB *prSwRfb);
 
@@ -1492,6 +1565,16 @@ uint32_t nicRxSetupRFB(IN struct ADAPTER *prAdapter, IN struct SW_RFB *prRfb);
 
 void nicRxReturnRFB(IN struct ADAPTER *prAdapter, IN struct SW_RFB *prRfb);
 
+uint32_t nicRxSetupRFBList(IN struct ADAPTER *prAdapter,
+	IN struct QUE *prRfbList);
+
+void nicRxReturnRFBList(IN struct ADAPTER *prAdapter,
+	IN struct QUE *prRfbList);
+
+void nicRxBeginReturnBatch(IN struct ADAPTER *prAdapter);
+
+void nicRxEndReturnBatch(IN struct ADAPTER *prAdapter);
+
 void nicProcessRxInterrupt(IN struct ADAPTER *prAdapter);
 
 void nicRxProcessPktWithoutReorder(IN struct ADAPTER *prAdapter,
@@ -1528,6 +1611,9 @@ void nicRxProcessDataPacket(IN struct ADAPTER *prAdapter,
 void nicRxProcessEventPacket(IN struct ADAPTER *prAdapter,
 	IN OUT struct SW_RFB *prSwRfb);
 
+void nicRxUpdateEventStat(IN struct RX_EVENT_STAT *prStat,
+	IN uint64_t u8StartTime);
+
 void nicRxProcessMgmtPacket(IN struct ADAPTER *prAdapter,
 	IN OUT struct SW_RFB *prSwRfb);
 
@@ -117,5 +117,48 @@ uint8_t nic_rxd_v3_fill_radiotap(
 	struct SW_RFB *prSwRfb);
 #endif
 
+#if CFG_RXD_STATIC_BIND
+/* Compile time bindings used by RX_DESC_OPS_FN(), see nic_rx.h */
+#define nic_rxd_static_get_rx_byte_count(_prRxStatus) \
+	((uint16_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_RX_BYTE_CNT( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_pkt_type(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_PKT_TYPE( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_wlan_idx(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_MLD_ID( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_sec_mode(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_SEC_MODE( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_ch_num(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_CHNL_NUM( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_rf_band(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_RF_BAND( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_tcl(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_TCL( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_ofld(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_GET_OFLD( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_HdrTrans(_prRxStatus) \
+	((uint8_t)HAL_MAC_CONNAC3X_RX_STATUS_IS_HEADER_TRAN( \
+		(struct HW_MAC_CONNAC3X_RX_DESC *)(_prRxStatus)))
+#define nic_rxd_static_get_sw_class_error_bit \
+	nic_rxd_v3_get_sw_class_error_bit
+#define nic_rxd_static_fill_rfb		nic_rxd_v3_fill_rfb
+#define nic_rxd_static_sanity_check	nic_rxd_v3_sanity_check
+#define nic_rxd_static_handle_host_rpt	nic_rxd_v3_handle_host_rpt
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+#define nic_rxd_static_check_wakeup_reason \
+	nic_rxd_v3_check_wakeup_reason
+#endif /* CFG_SUPPORT_WAKEUP_REASON_DEBUG */
+#if (CFG_SUPPORT_SNIFFER_RADIOTAP == 1)
+#define nic_rxd_static_fill_radiotap	nic_rxd_v3_fill_radiotap
+#endif
+#endif /* CFG_RXD_STATIC_BIND */
+
 #endif /* CFG_SUPPORT_CONNAC3X == 1 */
 #endif /* _NIC_RXD_v3_H */
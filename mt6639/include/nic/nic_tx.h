@@ -90,6 +90,9 @@
 
 #define NIC_TX_CMD_INFO_RESERVED_COUNT      4
 
+/* Forwarded packets returned to RX per wlanReturnPacketBatch() call */
+#define NIC_TX_FWD_RETURN_BATCH_NUM         16
+
 /* Maximum buffer count for individual HIF TCQ */
 #define NIC_TX_PAGE_COUNT_TC0 \
 	(NIC_TX_BUFF_COUNT_TC0 * nicTxGetMaxDataPageCntPerFrame(prAdapter))
@@ -533,6 +536,9 @@ enum ENUM_MCU_Q_INDEX {
 
 #define TX_2G_WMM_PORT_NUM (TC_NUM)
 
+/* MSDUs moved from one TX port queue per round by nicTxMsduQueueByRR */
+#define TX_PORT_QUE_RR_QUOTA 8
+
 #define BMC_TC_INDEX TC1_INDEX
 
 /* per-Network Tc Resource index */
@@ -680,6 +686,54 @@ struct TX_TCQ_ADJUST {
 	int32_t ai4Variation[TC_NUM];
 };
 
+#if CFG_SUPPORT_MULTITHREAD && CFG_TX_PORT_QUE_LOCK_STAT
+/*! Hold time statistics of one TX port queue lock */
+struct TX_PORT_QUE_STAT {
+	uint64_t u8LockTime;		/* ns, taken by the current holder */
+	uint32_t u4HoldCnt;
+	uint32_t u4MaxHoldTime;		/* ns */
+	uint64_t u8TotalHoldTime;	/* ns */
+};
+#endif
+
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+/*! TX data path stages timed by the packet lifetime profiler */
+enum ENUM_TX_LAT_STAGE {
+	TX_LAT_STAGE_OS_TO_ENQUE = 0,	/* hard_start_xmit to QM enqueue */
+	TX_LAT_STAGE_ENQUE_TO_DEQUE,	/* waiting in QM */
+	TX_LAT_STAGE_DEQUE_TO_HIF,	/* QM dequeue to HIF write */
+	TX_LAT_STAGE_HIF_TO_FREE,	/* HIF write to MSDU_INFO free */
+	TX_LAT_STAGE_TOTAL,		/* first tag to MSDU_INFO free */
+	TX_LAT_STAGE_NUM
+};
+
+/* Log-linear histogram: 2^TX_LAT_HIST_SUB_BITS linear sub-buckets per
+ * power of two, values below 2^TX_LAT_HIST_SUB_BITS ns are exact and
+ * values of 2^TX_LAT_HIST_MAX_BITS ns or more land in the last bucket.
+ */
+#define TX_LAT_HIST_SUB_BITS		3
+#define TX_LAT_HIST_SUB_NUM		BIT(TX_LAT_HIST_SUB_BITS)
+#define TX_LAT_HIST_MAX_BITS		40
+#define TX_LAT_HIST_BUCKET_NUM \
+	((TX_LAT_HIST_MAX_BITS - TX_LAT_HIST_SUB_BITS + 1) * \
+	 TX_LAT_HIST_SUB_NUM)
+
+/*! Latency histogram of one TX stage */
+struct TX_LAT_HIST {
+	uint32_t u4Count;
+	uint64_t u8MaxTime;	/* ns */
+	uint64_t u8TotalTime;	/* ns */
+	uint32_t au4Bucket[TX_LAT_HIST_BUCKET_NUM];
+};
+
+/*! Per-stage TX latency, updated without lock so counts are best effort */
+struct TX_LAT_STATS {
+	uint64_t u8FirstFreeTime;	/* ns, first MSDU_INFO freed */
+	uint64_t u8LastFreeTime;	/* ns, last MSDU_INFO freed */
+	struct TX_LAT_HIST arHist[TX_LAT_STAGE_NUM];
+};
+#endif
+
 struct TX_CTRL {
 	uint32_t u4TxCachedSize;
 	uint8_t *pucTxCached;
@@ -727,6 +781,10 @@ struct TX_CTRL {
 
 	/* Store SysTime of Last TxDone successfully */
 	uint32_t u4LastTxTime[MAX_BSSID_NUM];
+
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+	struct TX_LAT_STATS rLatStats;
+#endif
 };
 
 enum ENUM_TX_PACKET_TYPE {
@@ -762,6 +820,10 @@ struct PKT_PROFILE {
 	OS_SYSTIME rEnqueueTimestamp;
 	OS_SYSTIME rDequeueTimestamp;
 	OS_SYSTIME rHifTxDoneTimestamp;
+	uint64_t u8ArrivalTime;		/* ns, 0 if not tagged by xmit */
+	uint64_t u8EnqueueTime;		/* ns */
+	uint64_t u8DequeueTime;		/* ns */
+	uint64_t u8HifTxDoneTime;	/* ns */
 };
 #endif
 
@@ -1130,6 +1192,39 @@ extern PFN_TX_DATA_DONE_CB g_pfTxDataDoneCb;
 #define TX_RESET_ALL_CNTS(prTxCtrl)                 \
 	{kalMemZero(&prTxCtrl->au4Statistics[0], \
 	sizeof(prTxCtrl->au4Statistics)); }
+
+#if CFG_SUPPORT_MULTITHREAD
+/* Each rTxPQueue[] has its own lock unless TxPortQueLock is 0, then all
+ * ports share SPIN_LOCK_TX_PORT_QUE. Never hold two of them at once.
+ */
+#define TX_PORT_QUE_LOCK_ID(_prAdapter, _ucPort) \
+	(SPIN_LOCK_TX_PORT_QUE + \
+	 ((_prAdapter)->rWifiVar.ucTxPortQueLock ? (_ucPort) : 0))
+
+#if CFG_TX_PORT_QUE_LOCK_STAT
+#define TX_PORT_QUE_LOCK(_prAdapter, _ucPort) \
+{ \
+	KAL_ACQUIRE_SPIN_LOCK(_prAdapter, \
+		TX_PORT_QUE_LOCK_ID(_prAdapter, _ucPort)); \
+	(_prAdapter)->arTxPQueueStat[_ucPort].u8LockTime = sched_clock(); \
+}
+
+#define TX_PORT_QUE_UNLOCK(_prAdapter, _ucPort) \
+{ \
+	nicTxUpdatePortQueStat(&(_prAdapter)->arTxPQueueStat[_ucPort]); \
+	KAL_RELEASE_SPIN_LOCK(_prAdapter, \
+		TX_PORT_QUE_LOCK_ID(_prAdapter, _ucPort)); \
+}
+#else
+#define TX_PORT_QUE_LOCK(_prAdapter, _ucPort) \
+	KAL_ACQUIRE_SPIN_LOCK(_prAdapter, \
+		TX_PORT_QUE_LOCK_ID(_prAdapter, _ucPort))
+
+#define TX_PORT_QUE_UNLOCK(_prAdapter, _ucPort) \
+	KAL_RELEASE_SPIN_LOCK(_prAdapter, \
+		TX_PORT_QUE_LOCK_ID(_prAdapter, _ucPort))
+#endif
+#endif
 #if CFG_ENABLE_PKT_LIFETIME_PROFILE
 
 #if CFG_PRINT_PKT_LIFETIME_PROFILE
@@ -1848,6 +1943,10 @@ void nicTxMsduQueueByPrio(struct ADAPTER *prAdapter);
 void nicTxMsduQueueByRR(struct ADAPTER *prAdapter);
 
 uint32_t nicTxGetMsduPendingCnt(IN struct ADAPTER *prAdapter);
+
+#if CFG_TX_PORT_QUE_LOCK_STAT
+void nicTxUpdatePortQueStat(IN struct TX_PORT_QUE_STAT *prStat);
+#endif
 #endif
 
 uint32_t nicTxMsduQueue(IN struct ADAPTER *prAdapter,
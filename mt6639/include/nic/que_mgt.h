@@ -106,6 +106,12 @@ extern const uint8_t *apucACI2Str[4];
  * before the frame with SSN is received
  */
 #define QM_RX_INIT_FALL_BEHIND_PASS     1
+/* 1: Index the RX reorder queue by (SN % WinSize) with a slot array and
+ * an occupancy bitmap, so insert and duplicate check skip the queue walk
+ */
+#ifndef QM_RX_REORDER_SLOT_INDEX
+#define QM_RX_REORDER_SLOT_INDEX        1
+#endif
 /* 1: Count times of TC resource empty happened */
 #define QM_TC_RESOURCE_EMPTY_COUNTER    1
 
@@ -419,6 +425,14 @@ struct RX_BA_ENTRY {
 #if CFG_WOW_SUPPORT
 	u_int8_t fgFirstSnToWinStart;
 #endif
+#if QM_RX_REORDER_SLOT_INDEX
+	/* Slot (SN % u2SlotNum) holds the first queued SW_RFB of that SN.
+	 * NULL slot array means the linear rReOrderQue walk is used.
+	 */
+	struct SW_RFB **aprReorderSlot;
+	uint32_t *pu4ReorderSlotBitmap;
+	uint16_t u2SlotNum;
+#endif
 
 };
 
@@ -837,6 +851,15 @@ enum ENUM_BA_ENTRY_STATUS {
 #define QM_RX_GET_NEXT_SW_RFB(_prSwRfb) \
 	((struct SW_RFB *)(((_prSwRfb)->rQueEntry).prNext))
 
+#if QM_RX_REORDER_SLOT_INDEX
+#define QM_RX_REORDER_SLOT_BITMAP_SIZE(_u2SlotNum) \
+	((((_u2SlotNum) + 31) >> 5) * sizeof(uint32_t))
+
+#define QM_RX_REORDER_SLOT_IS_SET(_prReorderQueParm, _u4Idx) \
+	((_prReorderQueParm)->pu4ReorderSlotBitmap[(_u4Idx) >> 5] & \
+	BIT((_u4Idx) & 31))
+#endif
+
 #if 0
 #define QM_GET_STA_REC_PTR_FROM_INDEX(_prAdapter, _ucIndex) \
 	((((_ucIndex) != STA_REC_INDEX_BMCAST) && \
@@ -1086,6 +1109,31 @@ void qmPopOutDueToFallAhead(IN struct ADAPTER *prAdapter,
 			    IN struct RX_BA_ENTRY *prReorderQueParm,
 			    OUT struct QUE *prReturnedQue);
 
+#if QM_RX_REORDER_SLOT_INDEX
+void qmRxReorderSlotAlloc(IN struct ADAPTER *prAdapter,
+			  IN struct RX_BA_ENTRY *prReorderQueParm);
+
+void qmRxReorderSlotFree(IN struct ADAPTER *prAdapter,
+			 IN struct RX_BA_ENTRY *prReorderQueParm);
+
+void qmRxReorderSlotReset(IN struct RX_BA_ENTRY *prReorderQueParm);
+
+void qmRxReorderSlotSet(IN struct RX_BA_ENTRY *prReorderQueParm,
+			IN struct SW_RFB *prSwRfb);
+
+void qmRxReorderSlotClear(IN struct RX_BA_ENTRY *prReorderQueParm,
+			  IN struct SW_RFB *prSwRfb);
+
+struct SW_RFB *qmRxReorderSlotGet(IN struct RX_BA_ENTRY *prReorderQueParm,
+				  IN uint16_t u2SN);
+
+struct SW_RFB *qmRxReorderSlotFindNext(
+	IN struct RX_BA_ENTRY *prReorderQueParm, IN uint16_t u2SN);
+
+struct SW_RFB *qmRxReorderSlotLookup(IN struct RX_BA_ENTRY *prReorderQueParm,
+				     IN struct SW_RFB *prSwRfb);
+#endif
+
 void qmHandleReorderBubbleTimeout(IN struct ADAPTER
 				  *prAdapter, IN unsigned long ulParamPtr);
 
@@ -198,6 +198,9 @@
 #define CHNL_LIST_SZ_5G         14
 
 /*! CNM(STA_RECORD_T) related definition */
+/* Upper bound only, the usable number is ADAPTER.ucStaRecNum which is
+ * trimmed to the WTBL size reported by the chip capability.
+ */
 #define CFG_STA_REC_NUM         27
 
 /* PHY TYPE bit definitions */
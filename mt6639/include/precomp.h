@@ -83,7 +83,9 @@
 #include "gl_cfg80211.h"
 
 /* for sched_clock() */
+#ifndef CFG_VIRTUAL_OS
 #include <linux/sched/clock.h>
+#endif
 
 #if CFG_ENABLE_WIFI_DIRECT
 #include "gl_p2p_os.h"
@@ -226,6 +226,40 @@ struct QUE {
 		} \
 	}
 
+/* Multi-producer stack: producers push entries onto *pprTop with a compare
+ * and swap and need no lock, so *pprTop links the entries newest first.
+ * The consumer takes every entry with one exchange.
+ */
+#define QUEUE_MPSC_PUSH(pprTop, prQueueEntry) \
+	{ \
+		struct QUE_ENTRY *__prTop; \
+		do { \
+			__prTop = *(pprTop); \
+			(prQueueEntry)->prNext = __prTop; \
+		} while (GLUE_CMPXCHG(pprTop, __prTop, \
+			 (struct QUE_ENTRY *)(prQueueEntry)) != __prTop); \
+	}
+
+/* Take the whole stack of QUEUE_MPSC_PUSH() and append it to prDestQueue
+ * in push order
+ */
+#define QUEUE_MPSC_MOVE_ALL(prDestQueue, pprTop) \
+	{ \
+		struct QUE_ENTRY *__prEntry, *__prNext; \
+		struct QUE __rQue; \
+		QUEUE_INITIALIZE(&__rQue); \
+		__prEntry = GLUE_XCHG(pprTop, NULL); \
+		__rQue.prTail = __prEntry; \
+		while (__prEntry) { \
+			__prNext = __prEntry->prNext; \
+			__prEntry->prNext = __rQue.prHead; \
+			__rQue.prHead = __prEntry; \
+			__rQue.u4NumElem++; \
+			__prEntry = __prNext; \
+		} \
+		QUEUE_CONCATENATE_QUEUES(prDestQueue, &__rQue); \
+	}
+
 /*******************************************************************************
  *                            E X T E R N A L  D A T A
  *******************************************************************************
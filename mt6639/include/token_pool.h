@@ -0,0 +1,144 @@
+/******************************************************************************
+ *
+ * This file is provided under a dual license.  When you use or
+ * distribute this software, you may choose to be licensed under
+ * version 2 of the GNU General Public License ("GPLv2 License")
+ * or BSD License.
+ *
+ * GPLv2 License
+ *
+ * Copyright(C) 2016 MediaTek Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See http://www.gnu.org/licenses/gpl-2.0.html for more details.
+ *
+ * BSD LICENSE
+ *
+ * Copyright(C) 2016 MediaTek Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *****************************************************************************/
+/*
+ ** Id: include/token_pool.h
+ */
+
+/*! \file   token_pool.h
+ *    \brief  Free token stack with per-CPU caches.
+ *
+ *    A TOKEN_POOL hands out opaque token pointers. Tokens are taken from
+ *    and returned to a small cache of the running CPU. An empty cache is
+ *    refilled from the global stack, a full one drains to it, a batch at
+ *    a time, so the global lock is only taken once per batch.
+ */
+
+#ifndef _TOKEN_POOL_H
+#define _TOKEN_POOL_H
+
+/*******************************************************************************
+ *                         C O M P I L E R   F L A G S
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                    E X T E R N A L   R E F E R E N C E S
+ *******************************************************************************
+ */
+#include "gl_typedef.h"
+
+/*******************************************************************************
+ *                              C O N S T A N T S
+ *******************************************************************************
+ */
+#define TOKEN_CACHE_SIZE			32
+#define TOKEN_CACHE_BATCH			16
+
+/*******************************************************************************
+ *                             D A T A   T Y P E S
+ *******************************************************************************
+ */
+struct TOKEN_CACHE {
+	spinlock_t rLock;	/* only contended when another CPU steals */
+	uint32_t u4Cnt;
+	void *apvToken[TOKEN_CACHE_SIZE];
+};
+
+struct TOKEN_POOL {
+	spinlock_t rLock;	/* protects the global stack */
+	uint32_t u4StackCnt;	/* free tokens left in apvStack */
+	uint32_t u4Size;	/* capacity of apvStack */
+	void **apvStack;
+	struct TOKEN_CACHE *arCache;	/* one per CPU, NULL: stack only */
+	uint32_t u4CacheNum;
+};
+
+/*******************************************************************************
+ *                            P U B L I C   D A T A
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                           P R I V A T E   D A T A
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                                 M A C R O S
+ *******************************************************************************
+ */
+
+/*******************************************************************************
+ *                  F U N C T I O N   D E C L A R A T I O N S
+ *******************************************************************************
+ */
+u_int8_t tokenPoolInit(struct TOKEN_POOL *prPool, uint32_t u4Size,
+		       u_int8_t fgCache);
+
+void tokenPoolUninit(struct TOKEN_POOL *prPool);
+
+void tokenPoolReset(struct TOKEN_POOL *prPool);
+
+void tokenPoolAdd(struct TOKEN_POOL *prPool, void *pvToken);
+
+void *tokenPoolGet(struct TOKEN_POOL *prPool);
+
+void tokenPoolPut(struct TOKEN_POOL *prPool, void *pvToken);
+
+uint32_t tokenPoolFreeCnt(struct TOKEN_POOL *prPool);
+
+/*******************************************************************************
+ *                              F U N C T I O N S
+ *******************************************************************************
+ */
+
+#endif /* _TOKEN_POOL_H */
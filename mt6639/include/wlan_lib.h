@@ -223,6 +223,8 @@
 
 #define WLAN_CFG_REC_ENTRY_NUM_MAX 256
 #define WLAN_CFG_REC_FLAG_BIT BIT(0)
+/* slots of the key index, power of 2 and twice the entry number */
+#define WLAN_CFG_HASH_SIZE	512
 
 
 #define WLAN_CFG_SET_CHIP_LEN_MAX 10
@@ -929,6 +931,7 @@ struct _TWT_GET_TSF_CONTEXT_T {
 
 #if CFG_SUPPORT_CSI
 struct CSI_DATA_T;
+struct TX_LAT_HIST;
 #endif
 
 enum ENUM_NVRAM_MTK_FEATURE {
@@ -1333,6 +1336,9 @@ struct WLAN_CFG {
 	uint32_t u4WlanCfgKeyLenMax;
 	uint32_t u4WlanCfgValueLenMax;
 	struct WLAN_CFG_ENTRY arWlanCfgBuf[WLAN_CFG_ENTRY_NUM_MAX];
+	/* open addressing index of arWlanCfgBuf, entry index + 1 per slot */
+	uint16_t au2HashIdx[WLAN_CFG_HASH_SIZE];
+	uint32_t u4FreeIdx;	/* no empty entry below this index */
 };
 
 struct WLAN_CFG_REC {
@@ -1340,6 +1346,9 @@ struct WLAN_CFG_REC {
 	uint32_t u4WlanCfgKeyLenMax;
 	uint32_t u4WlanCfgValueLenMax;
 	struct WLAN_CFG_ENTRY arWlanCfgBuf[WLAN_CFG_REC_ENTRY_NUM_MAX];
+	/* open addressing index of arWlanCfgBuf, entry index + 1 per slot */
+	uint16_t au2HashIdx[WLAN_CFG_HASH_SIZE];
+	uint32_t u4FreeIdx;	/* no empty entry below this index */
 };
 
 enum ENUM_MAX_BANDWIDTH_SETTING {
@@ -1573,6 +1582,9 @@ void wlanReturnPacketDelaySetupTimeout(IN struct ADAPTER *prAdapter,
 
 void wlanReturnPacket(IN struct ADAPTER *prAdapter, IN void *pvPacket);
 
+void wlanReturnPacketBatch(IN struct ADAPTER *prAdapter,
+			   IN void *apvPackets[], IN uint32_t u4Num);
+
 uint32_t
 wlanQueryInformation(IN struct ADAPTER *prAdapter,
 		     IN PFN_OID_HANDLER_FUNC pfOidQryHandler,
@@ -1649,7 +1661,8 @@ void wlanSecurityFrameTxTimeout(IN struct ADAPTER *prAdapter,
 #if CFG_SUPPORT_CSI
 #if CFG_SUPPORT_CSI_NF
 bool
-wlanCSINoiseFilter(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData);
+wlanCSINoiseFilter(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData,
+		   OUT uint32_t csi_val[]);
 
 bool
 wlanBWDFilter(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData,
@@ -1658,9 +1671,11 @@ bool
 wlanCSILikeHighPass(IN struct ADAPTER *prAdapter,
 		IN uint32_t csi_val[], IN uint16_t cnt);
 #endif
-bool
-wlanPushCSIData(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData);
-bool wlanPopCSIData(IN struct ADAPTER *prAdapter, struct CSI_DATA_T *prCSIData);
+struct CSI_DATA_T *wlanCSIRingReserve(IN struct ADAPTER *prAdapter);
+void wlanCSIRingCommit(IN struct ADAPTER *prAdapter);
+struct CSI_DATA_T *wlanCSIRingPeek(IN struct ADAPTER *prAdapter);
+void wlanCSIRingConsume(IN struct ADAPTER *prAdapter);
+void wlanCSIRingFlush(IN struct ADAPTER *prAdapter);
 void
 wlanApplyCSIToneMask(
 	uint8_t ucRxMode,
@@ -1950,6 +1965,11 @@ void wlanTxLifetimeTagPacket(IN struct ADAPTER *prAdapter,
 			     IN struct MSDU_INFO *prMsduInfoListHead,
 			     IN enum ENUM_TX_PROFILING_TAG eTag);
 
+uint64_t wlanTxLatGetPercentile(IN struct TX_LAT_HIST *prHist,
+				IN uint32_t u4PerMille);
+
+void wlanTxLatReset(IN struct ADAPTER *prAdapter);
+
 #if CFG_ASSERT_DUMP
 void wlanCorDumpTimerInit(IN struct ADAPTER *prAdapter, u_int8_t fgIsResetN9);
 
@@ -1707,17 +1707,22 @@ struct STA_RECORD *bssGetClientByMac(IN struct ADAPTER *prAdapter,
 				     IN uint8_t *pucMac)
 {
 	struct LINK *prClientList;
-	struct STA_RECORD *prCurrStaRec;
+	struct STA_RECORD *prStaRec, *prCurrStaRec;
 
 	ASSERT(prBssInfo);
 
 	prClientList = &prBssInfo->rStaRecOfClientList;
 
-	LINK_FOR_EACH_ENTRY(prCurrStaRec, prClientList, rLinkEntry,
-			    struct STA_RECORD) {
+	/* Find the candidate by hash, then only compare list pointers */
+	prStaRec = cnmGetStaRecByAddress(prAdapter, prBssInfo->ucBssIndex,
+					 pucMac);
+	if (prStaRec) {
+		LINK_FOR_EACH_ENTRY(prCurrStaRec, prClientList, rLinkEntry,
+				    struct STA_RECORD) {
 
-		if (EQUAL_MAC_ADDR(prCurrStaRec->aucMacAddr, pucMac))
-			return prCurrStaRec;
+			if (prCurrStaRec == prStaRec)
+				return prCurrStaRec;
+		}
 	}
 
 	DBGLOG(BSS, INFO,
@@ -140,6 +140,9 @@ const uint8_t aucValidDataRate[] = {
 static void cnmStaRoutinesForAbort(struct ADAPTER *prAdapter,
 	struct STA_RECORD *prStaRec);
 
+static void cnmStaRecIndexRemove(struct ADAPTER *prAdapter,
+	struct STA_RECORD *prStaRec);
+
 static void cnmStaRecHandleEventPkt(struct ADAPTER *prAdapter,
 	struct CMD_INFO *prCmdInfo, uint8_t *pucEventBuf);
 
@@ -601,11 +604,147 @@ void cnmStaRecInit(struct ADAPTER *prAdapter)
 		prStaRec->qosMapSet = NULL;
 #endif
 	}
+
+	kalMemSet(prAdapter->aucStaRecHash, STA_REC_INDEX_NOT_FOUND,
+		sizeof(prAdapter->aucStaRecHash));
+	kalMemZero(prAdapter->aprStaRecByWlanIdx,
+		sizeof(prAdapter->aprStaRecByWlanIdx));
+	for (i = 0; i <= MAX_BSSID_NUM; i++)
+		LINK_INITIALIZE(&prAdapter->arStaRecOfBss[i]);
 }
 
 /*----------------------------------------------------------------------------*/
 /*!
- * \brief
+ * \brief Home slot of a (BSS index, MAC address) pair in aucStaRecHash.
+ *
+ * \param[in] ucBssIndex
+ * \param[in] pucMacAddr
+ *
+ * \return slot index
+ */
+/*----------------------------------------------------------------------------*/
+static uint32_t cnmStaRecHashSlot(uint8_t ucBssIndex, uint8_t *pucMacAddr)
+{
+	uint32_t u4Key;
+
+	/* The OUI part carries little entropy, fold the NIC specific part */
+	u4Key = ((uint32_t) pucMacAddr[3] << 16) |
+		((uint32_t) pucMacAddr[4] << 8) |
+		(uint32_t) pucMacAddr[5];
+	u4Key ^= (uint32_t) ucBssIndex << 24;
+
+	return (u4Key * 0x9E3779B1) >> (32 - STA_REC_HASH_BITS);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Add an allocated STA_RECORD to the MAC address and WLAN index
+ *        lookup tables.
+ *
+ * \param[in] prAdapter
+ * \param[in] prStaRec
+ *
+ * \return none
+ */
+/*----------------------------------------------------------------------------*/
+static void cnmStaRecIndexAdd(struct ADAPTER *prAdapter,
+	struct STA_RECORD *prStaRec)
+{
+	uint8_t *pucHash = prAdapter->aucStaRecHash;
+	struct WLAN_TABLE *prWtbl;
+	uint32_t u4Slot, i;
+
+	if (prStaRec->ucBssIndex <= MAX_BSSID_NUM)
+		LINK_INSERT_TAIL(
+			&prAdapter->arStaRecOfBss[prStaRec->ucBssIndex],
+			&prStaRec->rLinkEntryOfBss);
+
+	u4Slot = cnmStaRecHashSlot(prStaRec->ucBssIndex, prStaRec->aucMacAddr);
+	for (i = 0; i < STA_REC_HASH_SIZE; i++) {
+		if (pucHash[u4Slot] == STA_REC_INDEX_NOT_FOUND ||
+		    pucHash[u4Slot] == prStaRec->ucIndex) {
+			pucHash[u4Slot] = prStaRec->ucIndex;
+			break;
+		}
+		u4Slot = (u4Slot + 1) & STA_REC_HASH_MASK;
+	}
+
+	/* Only map the WLAN index once secPrivacySeekForEntry() gave one */
+	prWtbl = prAdapter->rWifiVar.arWtbl;
+	if (prStaRec->ucWlanIndex < WTBL_SIZE &&
+	    prWtbl[prStaRec->ucWlanIndex].ucUsed &&
+	    prWtbl[prStaRec->ucWlanIndex].ucPairwise &&
+	    prWtbl[prStaRec->ucWlanIndex].ucStaIndex == prStaRec->ucIndex)
+		prAdapter->aprStaRecByWlanIdx[prStaRec->ucWlanIndex] =
+			prStaRec;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Drop a STA_RECORD from the lookup tables. Entries behind the freed
+ *        hash slot are shifted back so that probing never needs tombstones.
+ *
+ * \param[in] prAdapter
+ * \param[in] prStaRec
+ *
+ * \return none
+ */
+/*----------------------------------------------------------------------------*/
+static void cnmStaRecIndexRemove(struct ADAPTER *prAdapter,
+	struct STA_RECORD *prStaRec)
+{
+	uint8_t *pucHash = prAdapter->aucStaRecHash;
+	struct STA_RECORD *prEntry;
+	uint32_t u4Hole, u4Slot, u4Home, i;
+
+	if (prStaRec->ucWlanIndex < WTBL_SIZE &&
+	    prAdapter->aprStaRecByWlanIdx[prStaRec->ucWlanIndex] == prStaRec)
+		prAdapter->aprStaRecByWlanIdx[prStaRec->ucWlanIndex] = NULL;
+
+	if (prStaRec->ucBssIndex <= MAX_BSSID_NUM &&
+	    prStaRec->rLinkEntryOfBss.prNext)
+		LINK_REMOVE_KNOWN_ENTRY(
+			&prAdapter->arStaRecOfBss[prStaRec->ucBssIndex],
+			&prStaRec->rLinkEntryOfBss);
+
+	u4Hole = cnmStaRecHashSlot(prStaRec->ucBssIndex,
+		prStaRec->aucMacAddr);
+	for (i = 0; i < STA_REC_HASH_SIZE; i++) {
+		if (pucHash[u4Hole] == prStaRec->ucIndex)
+			break;
+		if (pucHash[u4Hole] == STA_REC_INDEX_NOT_FOUND)
+			return;
+		u4Hole = (u4Hole + 1) & STA_REC_HASH_MASK;
+	}
+	if (i == STA_REC_HASH_SIZE)
+		return;
+
+	pucHash[u4Hole] = STA_REC_INDEX_NOT_FOUND;
+	u4Slot = u4Hole;
+	for (i = 1; i < STA_REC_HASH_SIZE; i++) {
+		u4Slot = (u4Slot + 1) & STA_REC_HASH_MASK;
+		if (pucHash[u4Slot] == STA_REC_INDEX_NOT_FOUND)
+			break;
+
+		prEntry = &prAdapter->arStaRec[pucHash[u4Slot]];
+		u4Home = cnmStaRecHashSlot(prEntry->ucBssIndex,
+			prEntry->aucMacAddr);
+
+		/* Keep the entry if its home lies cyclically in (hole, slot] */
+		if (((u4Slot - u4Home) & STA_REC_HASH_MASK) <
+		    ((u4Slot - u4Hole) & STA_REC_HASH_MASK))
+			continue;
+
+		pucHash[u4Hole] = pucHash[u4Slot];
+		pucHash[u4Slot] = STA_REC_INDEX_NOT_FOUND;
+		u4Hole = u4Slot;
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Allocate a STA_RECORD. Its BSS index and MAC address are hashed
+ *        here, so they must not be changed while the record is in use.
  *
  * \param[in]
  *
@@ -620,7 +759,7 @@ struct STA_RECORD *cnmStaRecAlloc(struct ADAPTER *prAdapter,
 
 	ASSERT(prAdapter);
 
-	for (i = 0; i < CFG_STA_REC_NUM; i++) {
+	for (i = 0; i < prAdapter->ucStaRecNum; i++) {
 		prStaRec = &prAdapter->arStaRec[i];
 
 		if (!prStaRec->fgIsInUse) {
@@ -684,7 +823,7 @@ struct STA_RECORD *cnmStaRecAlloc(struct ADAPTER *prAdapter,
 	}
 
 	/* Sync to chip to allocate WTBL resource */
-	if (i < CFG_STA_REC_NUM) {
+	if (i < prAdapter->ucStaRecNum) {
 		COPY_MAC_ADDR(prStaRec->aucMacAddr, pucMacAddr);
 		if (secPrivacySeekForEntry(prAdapter, prStaRec))
 			cnmStaSendUpdateCmd(prAdapter, prStaRec, FALSE);
@@ -699,6 +838,9 @@ struct STA_RECORD *cnmStaRecAlloc(struct ADAPTER *prAdapter,
 		prStaRec = NULL;
 	}
 
+	if (prStaRec)
+		cnmStaRecIndexAdd(prAdapter, prStaRec);
+
 	/* remove pending msdu when sta_rec alloc */
 	if (prStaRec)
 		nicFreePendingTxMsduInfo(prAdapter,
@@ -778,6 +920,9 @@ static void cnmStaRoutinesForAbort(struct ADAPTER *prAdapter,
 
 	qmDeactivateStaRec(prAdapter, prStaRec);
 
+	if (prStaRec->fgIsInUse)
+		cnmStaRecIndexRemove(prAdapter, prStaRec);
+
 	/* Update the driver part table setting */
 	secPrivacyFreeSta(prAdapter, prStaRec);
 
@@ -799,20 +944,20 @@ void cnmStaFreeAllStaByNetwork(struct ADAPTER *prAdapter, uint8_t ucBssIndex,
 #if CFG_ENABLE_WIFI_DIRECT
 	struct BSS_INFO *prBssInfo;
 #endif
-	struct STA_RECORD *prStaRec;
-	uint16_t i;
+	struct STA_RECORD *prStaRec, *prStaRecNext;
+	struct LINK *prStaRecList;
 	enum ENUM_STA_REC_CMD_ACTION eAction;
 
 	if (ucBssIndex > prAdapter->ucHwBssIdNum)
 		return;
 
-	for (i = 0; i < CFG_STA_REC_NUM; i++) {
-		prStaRec = (struct STA_RECORD *) &prAdapter->arStaRec[i];
-
-		if (prStaRec->fgIsInUse && prStaRec->ucBssIndex == ucBssIndex
-			&& i != ucStaRecIndexExcluded)
+	prStaRecList = &prAdapter->arStaRecOfBss[ucBssIndex];
+	LINK_FOR_EACH_ENTRY_SAFE(prStaRec, prStaRecNext, prStaRecList,
+		rLinkEntryOfBss, struct STA_RECORD) {
+		if (prStaRec->fgIsInUse
+			&& prStaRec->ucIndex != ucStaRecIndexExcluded)
 			cnmStaRoutinesForAbort(prAdapter, prStaRec);
-	}	/* end of for loop */
+	}
 
 	if (ucStaRecIndexExcluded < CFG_STA_REC_NUM)
 		eAction = STA_REC_CMD_ACTION_BSS_EXCLUDE_STA;
@@ -876,25 +1021,91 @@ struct STA_RECORD *cnmGetStaRecByAddress(struct ADAPTER *prAdapter,
 	uint8_t ucBssIndex, uint8_t *pucPeerMacAddr)
 {
 	struct STA_RECORD *prStaRec;
-	uint16_t i;
+	uint8_t ucStaRecIdx;
+	uint32_t u4Slot, i;
 
 	ASSERT(prAdapter);
 
 	if (!pucPeerMacAddr)
 		return NULL;
 
-	for (i = 0; i < CFG_STA_REC_NUM; i++) {
-		prStaRec = &prAdapter->arStaRec[i];
+	u4Slot = cnmStaRecHashSlot(ucBssIndex, pucPeerMacAddr);
+	for (i = 0; i < STA_REC_HASH_SIZE; i++) {
+		ucStaRecIdx = prAdapter->aucStaRecHash[u4Slot];
+		if (ucStaRecIdx >= CFG_STA_REC_NUM)
+			break;
 
+		prStaRec = &prAdapter->arStaRec[ucStaRecIdx];
 		if (prStaRec->fgIsInUse
 			&& prStaRec->ucBssIndex == ucBssIndex
 			&& EQUAL_MAC_ADDR(
 				prStaRec->aucMacAddr, pucPeerMacAddr)) {
-			break;
+			return prStaRec;
 		}
+		u4Slot = (u4Slot + 1) & STA_REC_HASH_MASK;
+	}
+
+	return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Get STA_RECORD_T by Peer MAC Address in any BSS.
+ *
+ * @param[in] ucBssIndexHint      BSS to look up first.
+ * @param[in] pucPeerMacAddr      Given Peer MAC Address.
+ *
+ * @retval   Pointer to STA_RECORD_T, if found. NULL, if not found
+ */
+/*----------------------------------------------------------------------------*/
+struct STA_RECORD *cnmGetStaRecByAddressAnyBss(struct ADAPTER *prAdapter,
+	uint8_t ucBssIndexHint, uint8_t *pucPeerMacAddr)
+{
+	struct STA_RECORD *prStaRec;
+	uint8_t ucBssIndex;
+
+	prStaRec = cnmGetStaRecByAddress(prAdapter, ucBssIndexHint,
+		pucPeerMacAddr);
+	if (prStaRec || !pucPeerMacAddr)
+		return prStaRec;
+
+	for (ucBssIndex = 0; ucBssIndex <= MAX_BSSID_NUM; ucBssIndex++) {
+		if (ucBssIndex == ucBssIndexHint)
+			continue;
+		prStaRec = cnmGetStaRecByAddress(prAdapter, ucBssIndex,
+			pucPeerMacAddr);
+		if (prStaRec)
+			return prStaRec;
 	}
 
-	return (i < CFG_STA_REC_NUM) ? prStaRec : NULL;
+	return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Get STA_RECORD_T by its pairwise WLAN index.
+ *
+ * @param[in] ucWlanIdx           WLAN index.
+ *
+ * @retval   Pointer to STA_RECORD_T, if found. NULL, if not found
+ */
+/*----------------------------------------------------------------------------*/
+struct STA_RECORD *cnmGetStaRecByWlanIdx(struct ADAPTER *prAdapter,
+	uint8_t ucWlanIdx)
+{
+	struct STA_RECORD *prStaRec;
+
+	ASSERT(prAdapter);
+
+	if (ucWlanIdx >= WTBL_SIZE)
+		return NULL;
+
+	prStaRec = prAdapter->aprStaRecByWlanIdx[ucWlanIdx];
+	if (prStaRec && (!prStaRec->fgIsInUse ||
+	    prStaRec->ucWlanIndex != ucWlanIdx))
+		prStaRec = NULL;
+
+	return prStaRec;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1555,12 +1766,10 @@ cnmPeerAdd(struct ADAPTER *prAdapter, void *pvSetBuffer,
 		if (prStaRec == NULL)
 			return TDLS_STATUS_RESOURCES;
 
-		if (prBssInfo->ucBssIndex)
-			prStaRec->ucBssIndex = prBssInfo->ucBssIndex;
-
 		/* init the prStaRec */
-		/* prStaRec will be zero first in cnmStaRecAlloc() */
-		COPY_MAC_ADDR(prStaRec->aucMacAddr, prCmd->aucPeerMac);
+		/* prStaRec will be zero first in cnmStaRecAlloc(), which
+		 * also set its BSS index and MAC address
+		 */
 
 		prStaRec->u2BSSBasicRateSet = prBssInfo->u2BSSBasicRateSet;
 
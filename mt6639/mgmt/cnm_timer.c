@@ -144,6 +144,302 @@ static u_int8_t cnmTimerSetTimer(IN struct ADAPTER *prAdapter,
 	return fgNeedWakeLock;
 }
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Get the list holding the timers of a wheel slot.
+ *
+ * \param[in] u2Slot Wheel slot, or TIMER_WHEEL_SLOT_EXPIRED.
+ *
+ * \return The slot list.
+ */
+/*----------------------------------------------------------------------------*/
+static struct LINK *cnmTimerWheelGetLink(IN struct ROOT_TIMER *prRootTimer,
+					 IN uint16_t u2Slot)
+{
+	if (u2Slot == TIMER_WHEEL_SLOT_EXPIRED)
+		return &prRootTimer->rExpiredLink;
+
+	return &prRootTimer->arWheel[u2Slot];
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Find the first occupied slot of a wheel level.
+ *
+ * \param[in] u4Offset Slot index of the first slot of the level.
+ * \param[in] u4Size Number of slots of the level.
+ * \param[in] u4Start Level index to start from, the search wraps around.
+ * \param[in] u4Num Number of slots to check.
+ *
+ * \return The wheel slot, TIMER_WHEEL_SLOT_NUM if none is occupied.
+ */
+/*----------------------------------------------------------------------------*/
+static uint32_t cnmTimerWheelFindSlot(IN struct ROOT_TIMER *prRootTimer,
+				      IN uint32_t u4Offset, IN uint32_t u4Size,
+				      IN uint32_t u4Start, IN uint32_t u4Num)
+{
+	uint32_t u4Idx = u4Start, u4Slot, u4Bits, u4Word;
+
+	/* Level offsets are multiples of 32, so a level word never
+	 * straddles two levels.
+	 */
+	while (u4Num) {
+		u4Slot = u4Offset + u4Idx;
+		u4Bits = 32 - (u4Slot & 31);
+		if (u4Bits > u4Num)
+			u4Bits = u4Num;
+		if (u4Idx + u4Bits > u4Size)
+			u4Bits = u4Size - u4Idx;
+
+		u4Word = prRootTimer->au4WheelBitmap[u4Slot >> 5] >>
+			(u4Slot & 31);
+		if (u4Bits < 32)
+			u4Word &= BIT(u4Bits) - 1;
+		if (u4Word)
+			return u4Slot + ffs(u4Word) - 1;
+
+		u4Num -= u4Bits;
+		u4Idx = (u4Idx + u4Bits) & (u4Size - 1);
+	}
+
+	return TIMER_WHEEL_SLOT_NUM;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Hang a timer on the wheel slot of its expiration time.
+ *
+ * \param[in] prTimer Pointer to a timer structure, not pending.
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void cnmTimerWheelAdd(IN struct ROOT_TIMER *prRootTimer,
+			     IN struct TIMER *prTimer)
+{
+	uint32_t u4Expires = (uint32_t) prTimer->rExpiredSysTime;
+	uint32_t u4Delta = u4Expires - (uint32_t) prRootTimer->rWheelTime;
+	uint32_t u4Slot;
+
+	if (u4Delta > 0x7fffffff) {
+		/* Already expired, fire on the next processed tick */
+		u4Slot = prRootTimer->rWheelTime & TIMER_WHEEL_L0_MASK;
+	} else if (u4Delta < TIMER_WHEEL_L0_SIZE) {
+		u4Slot = u4Expires & TIMER_WHEEL_L0_MASK;
+	} else if (u4Delta < BIT(TIMER_WHEEL_L0_BITS + TIMER_WHEEL_LN_BITS)) {
+		u4Slot = TIMER_WHEEL_L0_SIZE +
+			((u4Expires >> TIMER_WHEEL_L0_BITS) &
+			TIMER_WHEEL_LN_MASK);
+	} else {
+		/* Beyond the wheel, park it in the last slot and let the
+		 * cascade put it back with its real expiration time.
+		 */
+		if (u4Delta >= TIMER_WHEEL_RANGE)
+			u4Expires = (uint32_t) prRootTimer->rWheelTime +
+				TIMER_WHEEL_RANGE - 1;
+		u4Slot = TIMER_WHEEL_L0_SIZE + TIMER_WHEEL_LN_SIZE +
+			((u4Expires >> (TIMER_WHEEL_L0_BITS +
+			TIMER_WHEEL_LN_BITS)) & TIMER_WHEEL_LN_MASK);
+	}
+
+	prTimer->u2WheelSlot = (uint16_t) u4Slot;
+	LINK_INSERT_TAIL(&prRootTimer->arWheel[u4Slot], &prTimer->rLinkEntry);
+	prRootTimer->au4WheelBitmap[u4Slot >> 5] |= BIT(u4Slot & 31);
+	prRootTimer->u4WheelTimerNum++;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Unhang a pending timer from the wheel or the expired list.
+ *
+ * \param[in] prTimer Pointer to a timer structure, pending.
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void cnmTimerWheelDel(IN struct ROOT_TIMER *prRootTimer,
+			     IN struct TIMER *prTimer)
+{
+	uint16_t u2Slot = prTimer->u2WheelSlot;
+	struct LINK *prLink = cnmTimerWheelGetLink(prRootTimer, u2Slot);
+
+	LINK_REMOVE_KNOWN_ENTRY(prLink, &prTimer->rLinkEntry);
+
+	if (u2Slot == TIMER_WHEEL_SLOT_EXPIRED)
+		return;
+
+	prRootTimer->u4WheelTimerNum--;
+	if (LINK_IS_EMPTY(prLink))
+		prRootTimer->au4WheelBitmap[u2Slot >> 5] &= ~BIT(u2Slot & 31);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Move all timers of a wheel slot to the expired list.
+ *
+ * \param[in] u4Slot Wheel slot.
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void cnmTimerWheelExpireSlot(IN struct ROOT_TIMER *prRootTimer,
+				    IN uint32_t u4Slot)
+{
+	struct LINK *prLink = &prRootTimer->arWheel[u4Slot];
+	struct LINK_ENTRY *prLinkEntry;
+	struct TIMER *prTimer;
+
+	if (LINK_IS_EMPTY(prLink))
+		return;
+
+	LINK_FOR_EACH(prLinkEntry, prLink) {
+		prTimer = LINK_ENTRY(prLinkEntry, struct TIMER, rLinkEntry);
+		prTimer->u2WheelSlot = TIMER_WHEEL_SLOT_EXPIRED;
+	}
+
+	prRootTimer->u4WheelTimerNum -= prLink->u4NumElem;
+	prRootTimer->au4WheelBitmap[u4Slot >> 5] &= ~BIT(u4Slot & 31);
+	LINK_MERGE_TO_TAIL(&prRootTimer->rExpiredLink, prLink);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Re-hang the timers of the current slot of an upper level onto the
+ *        levels below it.
+ *
+ * \param[in] u4Level Wheel level, 1 ~ TIMER_WHEEL_LN_NUM.
+ *
+ * \return The level index of the cascaded slot.
+ */
+/*----------------------------------------------------------------------------*/
+static uint32_t cnmTimerWheelCascade(IN struct ROOT_TIMER *prRootTimer,
+				     IN uint32_t u4Level)
+{
+	struct LINK rCascadeLink;
+	struct LINK *prLink;
+	struct TIMER *prTimer;
+	uint32_t u4Idx, u4Slot;
+
+	u4Idx = ((uint32_t) prRootTimer->rWheelTime >>
+		(TIMER_WHEEL_L0_BITS + (u4Level - 1) * TIMER_WHEEL_LN_BITS)) &
+		TIMER_WHEEL_LN_MASK;
+	u4Slot = TIMER_WHEEL_L0_SIZE + (u4Level - 1) * TIMER_WHEEL_LN_SIZE +
+		u4Idx;
+	prLink = &prRootTimer->arWheel[u4Slot];
+
+	if (LINK_IS_EMPTY(prLink))
+		return u4Idx;
+
+	LINK_INITIALIZE(&rCascadeLink);
+	prRootTimer->u4WheelTimerNum -= prLink->u4NumElem;
+	prRootTimer->au4WheelBitmap[u4Slot >> 5] &= ~BIT(u4Slot & 31);
+	LINK_MERGE_TO_TAIL(&rCascadeLink, prLink);
+
+	while (TRUE) {
+		LINK_REMOVE_HEAD(&rCascadeLink, prTimer, struct TIMER *);
+		if (!prTimer)
+			break;
+		cnmTimerWheelAdd(prRootTimer, prTimer);
+	}
+
+	return u4Idx;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Fold the timers of a slot into the next expiration time.
+ *
+ * \param[in] u4Slot Wheel slot.
+ * \param[in,out] prNextExpiredSysTime Earliest expiration time so far.
+ * \param[in,out] peType Wake lock type of the next timeout.
+ * \param[in,out] pfgFound TRUE if prNextExpiredSysTime is valid.
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void cnmTimerWheelScanSlot(IN struct ROOT_TIMER *prRootTimer,
+				  IN uint32_t u4Slot,
+				  IN OUT OS_SYSTIME *prNextExpiredSysTime,
+				  IN OUT enum ENUM_TIMER_WAKELOCK_TYPE_T *peType,
+				  IN OUT u_int8_t *pfgFound)
+{
+	struct LINK_ENTRY *prLinkEntry;
+	struct TIMER *prTimer;
+
+	if (u4Slot >= TIMER_WHEEL_SLOT_NUM)
+		return;
+
+	LINK_FOR_EACH(prLinkEntry, &prRootTimer->arWheel[u4Slot]) {
+		prTimer = LINK_ENTRY(prLinkEntry, struct TIMER, rLinkEntry);
+
+		if (*pfgFound && !TIME_BEFORE(prTimer->rExpiredSysTime,
+			*prNextExpiredSysTime))
+			continue;
+
+		*prNextExpiredSysTime = prTimer->rExpiredSysTime;
+		*pfgFound = TRUE;
+
+		if (prTimer->eType == TIMER_WAKELOCK_REQUEST)
+			*peType = TIMER_WAKELOCK_REQUEST;
+		else if ((*peType != TIMER_WAKELOCK_REQUEST)
+			&& (prTimer->eType == TIMER_WAKELOCK_AUTO))
+			*peType = TIMER_WAKELOCK_AUTO;
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Get the earliest expiration time of the timers on the wheel.
+ *
+ *        Only the first occupied slot of each level needs to be scanned,
+ *        because later slots of a level always expire later.
+ *
+ * \param[out] prNextExpiredSysTime Earliest expiration time.
+ * \param[out] peType Wake lock type of the next timeout.
+ *
+ * \retval TRUE A timer is pending on the wheel.
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t cnmTimerWheelNextExpiry(IN struct ROOT_TIMER *prRootTimer,
+				OUT OS_SYSTIME *prNextExpiredSysTime,
+				OUT enum ENUM_TIMER_WAKELOCK_TYPE_T *peType)
+{
+	uint32_t u4Level, u4Shift, u4Offset, u4Idx, u4Slot;
+	u_int8_t fgFound = FALSE;
+
+	*peType = TIMER_WAKELOCK_NONE;
+
+	if (prRootTimer->u4WheelTimerNum == 0)
+		return FALSE;
+
+	u4Slot = cnmTimerWheelFindSlot(prRootTimer, 0, TIMER_WHEEL_L0_SIZE,
+		prRootTimer->rWheelTime & TIMER_WHEEL_L0_MASK,
+		TIMER_WHEEL_L0_SIZE);
+	cnmTimerWheelScanSlot(prRootTimer, u4Slot, prNextExpiredSysTime,
+		peType, &fgFound);
+
+	for (u4Level = 1; u4Level <= TIMER_WHEEL_LN_NUM; u4Level++) {
+		u4Shift = TIMER_WHEEL_L0_BITS +
+			(u4Level - 1) * TIMER_WHEEL_LN_BITS;
+		u4Offset = TIMER_WHEEL_L0_SIZE +
+			(u4Level - 1) * TIMER_WHEEL_LN_SIZE;
+		/* The current slot holds the latest round of this level once
+		 * it has been cascaded, i.e. unless the next tick cascades it.
+		 */
+		u4Idx = (uint32_t) prRootTimer->rWheelTime >> u4Shift;
+		if ((uint32_t) prRootTimer->rWheelTime & (BIT(u4Shift) - 1))
+			u4Idx++;
+		u4Idx &= TIMER_WHEEL_LN_MASK;
+
+		u4Slot = cnmTimerWheelFindSlot(prRootTimer, u4Offset,
+			TIMER_WHEEL_LN_SIZE, u4Idx, TIMER_WHEEL_LN_SIZE);
+		cnmTimerWheelScanSlot(prRootTimer, u4Slot,
+			prNextExpiredSysTime, peType, &fgFound);
+	}
+
+	return fgFound;
+}
+
 /*----------------------------------------------------------------------------*/
 /*!
  * \brief This routines is called to initialize a root timer.
@@ -156,6 +452,7 @@ static u_int8_t cnmTimerSetTimer(IN struct ADAPTER *prAdapter,
 void cnmTimerInitialize(IN struct ADAPTER *prAdapter)
 {
 	struct ROOT_TIMER *prRootTimer;
+	uint32_t u4Slot;
 
 	KAL_SPIN_LOCK_DECLARATION();
 
@@ -166,7 +463,19 @@ void cnmTimerInitialize(IN struct ADAPTER *prAdapter)
 	/* Note: glue layer have configured timer */
 
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
-	LINK_INITIALIZE(&prRootTimer->rLinkHead);
+	for (u4Slot = 0; u4Slot < TIMER_WHEEL_SLOT_NUM; u4Slot++)
+		LINK_INITIALIZE(&prRootTimer->arWheel[u4Slot]);
+	LINK_INITIALIZE(&prRootTimer->rExpiredLink);
+	kalMemZero(prRootTimer->au4WheelBitmap,
+		sizeof(prRootTimer->au4WheelBitmap));
+	prRootTimer->u4WheelTimerNum = 0;
+	prRootTimer->rWheelTime = kalGetTimeTick();
+
+	prRootTimer->u4LastFiredNum = 0;
+	prRootTimer->u4MaxFiredNum = 0;
+	prRootTimer->u4TotalFiredNum = 0;
+	prRootTimer->u4MaxCallbackUs = 0;
+	prRootTimer->pfnMaxCallback = NULL;
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
 
 	KAL_WAKE_LOCK_INIT(prAdapter, prRootTimer->prWakeLock, "WLAN Timer");
@@ -198,10 +507,10 @@ static void cnmTimerStopTimer_impl(IN struct ADAPTER *prAdapter,
 		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
 
 	if (timerPendingTimer(prTimer)) {
-		LINK_REMOVE_KNOWN_ENTRY(&prRootTimer->rLinkHead,
-			&prTimer->rLinkEntry);
+		cnmTimerWheelDel(prRootTimer, prTimer);
 
-		if (LINK_IS_EMPTY(&prRootTimer->rLinkHead)) {
+		if (prRootTimer->u4WheelTimerNum == 0 &&
+			LINK_IS_EMPTY(&prRootTimer->rExpiredLink)) {
 		       /* kalCancelTimer(prAdapter->prGlueInfo); */
 
 		       /* Violate rule of del_timer_sync which cause DeadLock
@@ -263,6 +572,7 @@ void cnmTimerDestroy(IN struct ADAPTER *prAdapter)
 	struct LINK *prTimerList;
 	struct LINK_ENTRY *prLinkEntry, *prNextLinkEntry;
 	struct TIMER *prTimer;
+	uint32_t u4Slot;
 
 	KAL_SPIN_LOCK_DECLARATION();
 
@@ -273,7 +583,6 @@ void cnmTimerDestroy(IN struct ADAPTER *prAdapter)
 	}
 
 	prRootTimer = &prAdapter->rRootTimer;
-	prTimerList = &prRootTimer->rLinkHead;
 
 	if (prRootTimer->fgWakeLocked) {
 		KAL_WAKE_UNLOCK(prAdapter, prRootTimer->prWakeLock);
@@ -281,16 +590,23 @@ void cnmTimerDestroy(IN struct ADAPTER *prAdapter)
 	}
 	KAL_WAKE_LOCK_DESTROY(prAdapter, prRootTimer->prWakeLock);
 
+	if (LINK_IS_INVALID(&prRootTimer->rExpiredLink))
+		return;
+
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
 
-	if (LINK_IS_INVALID(prTimerList))
-		return;
+	for (u4Slot = 0; u4Slot <= TIMER_WHEEL_SLOT_EXPIRED; u4Slot++) {
+		prTimerList = cnmTimerWheelGetLink(prRootTimer,
+			(uint16_t) u4Slot);
 
-	LINK_FOR_EACH_SAFE(prLinkEntry, prNextLinkEntry, prTimerList) {
-		prTimer = LINK_ENTRY(prLinkEntry, struct TIMER, rLinkEntry);
-		ASSERT(prTimer);
+		LINK_FOR_EACH_SAFE(prLinkEntry, prNextLinkEntry,
+			prTimerList) {
+			prTimer = LINK_ENTRY(prLinkEntry, struct TIMER,
+				rLinkEntry);
+			ASSERT(prTimer);
 
-		cnmTimerStopTimer_impl(prAdapter, prTimer, FALSE);
+			cnmTimerStopTimer_impl(prAdapter, prTimer, FALSE);
+		}
 	}
 
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
@@ -334,19 +650,21 @@ cnmTimerInitTimerOption(IN struct ADAPTER *prAdapter,
 	if (pfFunc == NULL)
 		log_dbg(CNM, WARN, "Init timer with NULL callback function!\n");
 
-	if (!prAdapter->rRootTimer.rLinkHead.prNext) {
-		DBGLOG(INIT, ERROR, "rRootTimer.rLinkHead.prNext=0x%p\n",
-		       prAdapter->rRootTimer.rLinkHead.prNext);
+	if (!prAdapter->rRootTimer.rExpiredLink.prNext) {
+		DBGLOG(INIT, ERROR, "rRootTimer.rExpiredLink.prNext=0x%p\n",
+		       prAdapter->rRootTimer.rExpiredLink.prNext);
 
 		return;
 	}
 
-	{
+	if (timerPendingTimer(prTimer) &&
+		prTimer->u2WheelSlot <= TIMER_WHEEL_SLOT_EXPIRED) {
 		struct LINK *prTimerList;
 		struct LINK_ENTRY *prLinkEntry;
 		struct TIMER *prPendingTimer;
 
-		prTimerList = &(prAdapter->rRootTimer.rLinkHead);
+		prTimerList = cnmTimerWheelGetLink(&prAdapter->rRootTimer,
+			prTimer->u2WheelSlot);
 
 		LINK_FOR_EACH(prLinkEntry, prTimerList) {
 			prPendingTimer = LINK_ENTRY(prLinkEntry,
@@ -401,8 +719,8 @@ void cnmTimerStartTimer(IN struct ADAPTER *prAdapter, IN struct TIMER *prTimer,
 	IN uint32_t u4TimeoutMs)
 {
 	struct ROOT_TIMER *prRootTimer;
-	struct LINK *prTimerList;
-	OS_SYSTIME rExpiredSysTime, rTimeoutSystime;
+	OS_SYSTIME rCurSysTime, rExpiredSysTime, rTimeoutSystime;
+	u_int8_t fgNoPendingTimer;
 
 	KAL_SPIN_LOCK_DECLARATION();
 
@@ -412,7 +730,6 @@ void cnmTimerStartTimer(IN struct ADAPTER *prAdapter, IN struct TIMER *prTimer,
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
 
 	prRootTimer = &prAdapter->rRootTimer;
-	prTimerList = &prRootTimer->rLinkHead;
 
 	/* If timeout interval is larger than 1 minute, the mod value is set
 	 * to the timeout value first, then per minutue.
@@ -435,10 +752,23 @@ void cnmTimerStartTimer(IN struct ADAPTER *prAdapter, IN struct TIMER *prTimer,
 	rTimeoutSystime = MSEC_TO_SYSTIME(u4TimeoutMs);
 	if (rTimeoutSystime == 0)
 		rTimeoutSystime = 1;
-	rExpiredSysTime = kalGetTimeTick() + rTimeoutSystime;
+	rCurSysTime = kalGetTimeTick();
+	rExpiredSysTime = rCurSysTime + rTimeoutSystime;
+
+	/* Restarting a pending timer moves it to its new slot */
+	if (timerPendingTimer(prTimer))
+		cnmTimerWheelDel(prRootTimer, prTimer);
+
+	fgNoPendingTimer = (prRootTimer->u4WheelTimerNum == 0 &&
+		LINK_IS_EMPTY(&prRootTimer->rExpiredLink));
+
+	/* An idle wheel is not ticked, bring it up to date first */
+	if (prRootTimer->u4WheelTimerNum == 0 &&
+		TIME_BEFORE(prRootTimer->rWheelTime, rCurSysTime))
+		prRootTimer->rWheelTime = rCurSysTime;
 
 	/* If no timer pending or the fast time interval is used. */
-	if (LINK_IS_EMPTY(prTimerList)
+	if (fgNoPendingTimer
 		|| TIME_BEFORE(rExpiredSysTime,
 			prRootTimer->rNextExpiredSysTime)) {
 
@@ -446,11 +776,9 @@ void cnmTimerStartTimer(IN struct ADAPTER *prAdapter, IN struct TIMER *prTimer,
 		cnmTimerSetTimer(prAdapter, rTimeoutSystime, prTimer->eType);
 	}
 
-	/* Add this timer to checking list */
+	/* Add this timer to the wheel */
 	prTimer->rExpiredSysTime = rExpiredSysTime;
-
-	if (!timerPendingTimer(prTimer))
-		LINK_INSERT_TAIL(prTimerList, &prTimer->rLinkEntry);
+	cnmTimerWheelAdd(prRootTimer, prTimer);
 
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
 }
@@ -459,6 +787,11 @@ void cnmTimerStartTimer(IN struct ADAPTER *prAdapter, IN struct TIMER *prTimer,
 /*!
  * \brief This routines is called to check the timer list.
  *
+ *        The wheel is ticked from the last processed tick up to now. Only
+ *        the slots which are due are visited, and runs of empty level 0
+ *        slots are skipped, so the cost depends on the number of expired
+ *        timers instead of the number of pending timers.
+ *
  * \param[in]
  *
  * \return (none)
@@ -467,14 +800,14 @@ void cnmTimerStartTimer(IN struct ADAPTER *prAdapter, IN struct TIMER *prTimer,
 void cnmTimerDoTimeOutCheck(IN struct ADAPTER *prAdapter)
 {
 	struct ROOT_TIMER *prRootTimer;
-	struct LINK *prTimerList;
-	struct LINK_ENTRY *prLinkEntry;
 	struct TIMER *prTimer;
-	OS_SYSTIME rCurSysTime;
+	OS_SYSTIME rCurSysTime, rNextExpiredSysTime;
 	PFN_MGMT_TIMEOUT_FUNC pfMgmtTimeOutFunc;
 	unsigned long ulTimeoutDataPtr;
 	u_int8_t fgNeedWakeLock;
 	enum ENUM_TIMER_WAKELOCK_TYPE_T eType = TIMER_WAKELOCK_NONE;
+	uint32_t u4Idx, u4Slot, u4Step, u4Left, u4FiredNum, u4CallbackUs;
+	uint64_t u8StartTime;
 
 	KAL_SPIN_LOCK_DECLARATION();
 
@@ -484,7 +817,6 @@ void cnmTimerDoTimeOutCheck(IN struct ADAPTER *prAdapter)
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
 
 	prRootTimer = &prAdapter->rRootTimer;
-	prTimerList = &prRootTimer->rLinkHead;
 
 	rCurSysTime = kalGetTimeTick();
 
@@ -492,76 +824,97 @@ void cnmTimerDoTimeOutCheck(IN struct ADAPTER *prAdapter)
 	prRootTimer->rNextExpiredSysTime
 		= rCurSysTime + MGMT_MAX_TIMEOUT_INTERVAL;
 
-	LINK_FOR_EACH(prLinkEntry, prTimerList) {
-		if (prLinkEntry == NULL)
+	/* Lagged behind more than the whole wheel, everything is due */
+	if (!TIME_BEFORE(rCurSysTime, prRootTimer->rWheelTime) &&
+		(uint32_t) (rCurSysTime - prRootTimer->rWheelTime) >=
+		TIMER_WHEEL_RANGE) {
+		for (u4Slot = 0; u4Slot < TIMER_WHEEL_SLOT_NUM; u4Slot++)
+			cnmTimerWheelExpireSlot(prRootTimer, u4Slot);
+		prRootTimer->rWheelTime = rCurSysTime + 1;
+	}
+
+	/* Collect the timers of every tick up to now */
+	while (!TIME_BEFORE(rCurSysTime, prRootTimer->rWheelTime)) {
+		u4Idx = prRootTimer->rWheelTime & TIMER_WHEEL_L0_MASK;
+		if (u4Idx == 0 && cnmTimerWheelCascade(prRootTimer, 1) == 0)
+			cnmTimerWheelCascade(prRootTimer, 2);
+
+		cnmTimerWheelExpireSlot(prRootTimer, u4Idx);
+
+		if (prRootTimer->u4WheelTimerNum == 0) {
+			prRootTimer->rWheelTime = rCurSysTime + 1;
 			break;
+		}
 
-		prTimer = LINK_ENTRY(prLinkEntry, struct TIMER, rLinkEntry);
-		ASSERT(prTimer);
-		if (prLinkEntry->prNext == NULL)
-			log_dbg(CNM, WARN, "timer was re-inited, func %p\n",
-				prTimer->pfMgmtTimeOutFunc);
+		/* Skip empty level 0 slots, at most up to the next cascade */
+		u4Slot = cnmTimerWheelFindSlot(prRootTimer, 0,
+			TIMER_WHEEL_L0_SIZE, (u4Idx + 1) & TIMER_WHEEL_L0_MASK,
+			TIMER_WHEEL_L0_MASK - u4Idx);
+		u4Step = (u4Slot < TIMER_WHEEL_L0_SIZE) ?
+			(u4Slot - u4Idx) : (TIMER_WHEEL_L0_SIZE - u4Idx);
+		u4Left = (uint32_t) (rCurSysTime - prRootTimer->rWheelTime) + 1;
+		prRootTimer->rWheelTime += (u4Step < u4Left) ? u4Step : u4Left;
+	}
 
-		/* Check if this entry is timeout. */
-		if (!TIME_BEFORE(rCurSysTime, prTimer->rExpiredSysTime)) {
-			cnmTimerStopTimer_impl(prAdapter, prTimer, FALSE);
+	u4FiredNum = 0;
+	while (TRUE) {
+		LINK_REMOVE_HEAD(&prRootTimer->rExpiredLink, prTimer,
+			struct TIMER *);
+		if (prTimer == NULL)
+			break;
 
-			pfMgmtTimeOutFunc = prTimer->pfMgmtTimeOutFunc;
-			ulTimeoutDataPtr = prTimer->ulDataPtr;
-
-			if (prTimer->u2Minutes > 0) {
-				prTimer->u2Minutes--;
-				prTimer->rExpiredSysTime
-					= rCurSysTime
-						+ MSEC_TO_SYSTIME(MSEC_PER_MIN);
-				LINK_INSERT_TAIL(prTimerList,
-					&prTimer->rLinkEntry);
-			} else if (pfMgmtTimeOutFunc) {
-				KAL_RELEASE_SPIN_LOCK(prAdapter,
-					SPIN_LOCK_TIMER);
-			#ifdef UT_TEST_MODE
-				if (testTimerTimeout(prAdapter,
-						     pfMgmtTimeOutFunc,
-						     ulTimeoutDataPtr))
-			#endif
-				(pfMgmtTimeOutFunc) (prAdapter,
-					ulTimeoutDataPtr);
-				KAL_ACQUIRE_SPIN_LOCK(prAdapter,
-					SPIN_LOCK_TIMER);
-			}
+		/* Parked beyond the wheel range, not due yet */
+		if (TIME_BEFORE(rCurSysTime, prTimer->rExpiredSysTime)) {
+			cnmTimerWheelAdd(prRootTimer, prTimer);
+			continue;
+		}
 
-			/* Search entire list again because of nest del and add
-			 * timers and current MGMT_TIMER could be volatile after
-			 * stopped
-			 */
-			prLinkEntry = (struct LINK_ENTRY *) prTimerList;
+		pfMgmtTimeOutFunc = prTimer->pfMgmtTimeOutFunc;
+		ulTimeoutDataPtr = prTimer->ulDataPtr;
 
-			prRootTimer->rNextExpiredSysTime
-				= rCurSysTime + MGMT_MAX_TIMEOUT_INTERVAL;
-		} else if (TIME_BEFORE(prTimer->rExpiredSysTime,
-			prRootTimer->rNextExpiredSysTime)) {
-			prRootTimer->rNextExpiredSysTime
-				= prTimer->rExpiredSysTime;
-
-			if (prTimer->eType == TIMER_WAKELOCK_REQUEST)
-				eType = TIMER_WAKELOCK_REQUEST;
-			else if ((eType != TIMER_WAKELOCK_REQUEST)
-				&& (prTimer->eType == TIMER_WAKELOCK_AUTO))
-				eType = TIMER_WAKELOCK_AUTO;
+		if (prTimer->u2Minutes > 0) {
+			prTimer->u2Minutes--;
+			prTimer->rExpiredSysTime
+				= rCurSysTime + MSEC_TO_SYSTIME(MSEC_PER_MIN);
+			cnmTimerWheelAdd(prRootTimer, prTimer);
+		} else if (pfMgmtTimeOutFunc) {
+			u4FiredNum++;
+			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
+			u8StartTime = sched_clock();
+		#ifdef UT_TEST_MODE
+			if (testTimerTimeout(prAdapter,
+					     pfMgmtTimeOutFunc,
+					     ulTimeoutDataPtr))
+		#endif
+			(pfMgmtTimeOutFunc) (prAdapter, ulTimeoutDataPtr);
+			u4CallbackUs = ((uint32_t) (sched_clock() -
+				u8StartTime)) / NSEC_PER_USEC;
+			KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
+
+			if (u4CallbackUs > prRootTimer->u4MaxCallbackUs) {
+				prRootTimer->u4MaxCallbackUs = u4CallbackUs;
+				prRootTimer->pfnMaxCallback = pfMgmtTimeOutFunc;
+			}
 		}
-	}	/* end of for loop */
+	}
+
+	prRootTimer->u4LastFiredNum = u4FiredNum;
+	prRootTimer->u4TotalFiredNum += u4FiredNum;
+	if (u4FiredNum > prRootTimer->u4MaxFiredNum)
+		prRootTimer->u4MaxFiredNum = u4FiredNum;
 
 	/* Setup the prNext timeout event. It is possible the timer was already
 	 * set in the above timeout callback function.
 	 */
 	fgNeedWakeLock = FALSE;
-	if (!LINK_IS_EMPTY(prTimerList)) {
-		ASSERT(TIME_AFTER(
-			prRootTimer->rNextExpiredSysTime, rCurSysTime));
+	if (cnmTimerWheelNextExpiry(prRootTimer, &rNextExpiredSysTime,
+		&eType)) {
+		prRootTimer->rNextExpiredSysTime = rNextExpiredSysTime;
 
 		fgNeedWakeLock = cnmTimerSetTimer(prAdapter,
-			(OS_SYSTIME)((int32_t) prRootTimer->rNextExpiredSysTime
-				- (int32_t) rCurSysTime),
+			TIME_AFTER(rNextExpiredSysTime, rCurSysTime) ?
+			(OS_SYSTIME)((int32_t) rNextExpiredSysTime
+				- (int32_t) rCurSysTime) : 1,
 			eType);
 	}
 
@@ -573,3 +926,42 @@ void cnmTimerDoTimeOutCheck(IN struct ADAPTER *prAdapter)
 	/* release spin lock */
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TIMER);
 }
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief This routines is called to dump the timer wheel status.
+ *
+ * \param[out] pucBuf Output buffer.
+ * \param[in] u4Max Size of the output buffer.
+ *
+ * \return Length of the output.
+ */
+/*----------------------------------------------------------------------------*/
+uint32_t cnmTimerDumpStatus(IN struct ADAPTER *prAdapter, IN uint8_t *pucBuf,
+			    IN uint32_t u4Max)
+{
+	struct ROOT_TIMER *prRootTimer = &prAdapter->rRootTimer;
+	uint32_t u4Len = 0;
+
+	LOGBUF(pucBuf, u4Max, u4Len, "\n");
+	LOGBUF(pucBuf, u4Max, u4Len,
+		"============= DUMP Timer Status =============\n");
+	LOGBUF(pucBuf, u4Max, u4Len,
+		"Pending: wheel[%u] expired[%u] WheelTime[%u] Next[%u]\n",
+		prRootTimer->u4WheelTimerNum,
+		prRootTimer->rExpiredLink.u4NumElem,
+		(uint32_t) prRootTimer->rWheelTime,
+		(uint32_t) prRootTimer->rNextExpiredSysTime);
+	LOGBUF(pucBuf, u4Max, u4Len,
+		"Fired per check: last[%u] max[%u] total[%u]\n",
+		prRootTimer->u4LastFiredNum,
+		prRootTimer->u4MaxFiredNum,
+		prRootTimer->u4TotalFiredNum);
+	LOGBUF(pucBuf, u4Max, u4Len,
+		"Max callback duration: %uus func[%ps]\n",
+		prRootTimer->u4MaxCallbackUs,
+		prRootTimer->pfnMaxCallback);
+	LOGBUF(pucBuf, u4Max, u4Len, "============= DUMP END =============\n");
+
+	return u4Len;
+}
@@ -403,6 +403,40 @@ static struct MSG_HNDL_ENTRY arMsgMapTable[] = {
  *******************************************************************************
  */
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Dispatch one message to its handler and account the handler time
+ *        in arMboxMsgStat
+ *
+ * \param[in] prAdapter  Pointer to the Adapter structure.
+ * \param[in] prMsg      Message, owned and freed by the handler
+ *
+ * \return none
+ */
+/*----------------------------------------------------------------------------*/
+static void mboxHndlMsg(IN struct ADAPTER *prAdapter,
+			IN struct MSG_HDR *prMsg)
+{
+	/* the handler frees prMsg, keep what the statistics need */
+	enum ENUM_MSG_ID eMsgId = prMsg->eMsgId;
+	uint64_t u8StartTime = sched_clock();
+	uint64_t u8Time;
+	struct MBOX_MSG_STAT *prStat;
+
+	MBOX_HNDL_MSG(prAdapter, prMsg);
+
+	if (eMsgId >= MID_TOTAL_NUM)
+		return;
+
+	u8Time = sched_clock() - u8StartTime;
+	prStat = &prAdapter->arMboxMsgStat[eMsgId];
+	prStat->u4HitCnt++;
+	prStat->u8TotalTime += u8Time;
+	if (u8Time > prStat->u4MaxTime)
+		prStat->u4MaxTime = u8Time > 0xFFFFFFFF ?
+			0xFFFFFFFF : (uint32_t)u8Time;
+}
+
 /*----------------------------------------------------------------------------*/
 /*!
  * \brief
@@ -465,16 +499,12 @@ void mboxSetup(IN struct ADAPTER *prAdapter,
 {
 	struct MBOX *prMbox;
 
-	KAL_SPIN_LOCK_DECLARATION();
-
 	ASSERT(eMboxId < MBOX_ID_TOTAL_NUM);
 	ASSERT(prAdapter);
 
 	prMbox = &(prAdapter->arMbox[eMboxId]);
 
-	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
-	LINK_INITIALIZE(&prMbox->rLinkHead);
-	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
+	prMbox->prHead = NULL;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -492,8 +522,7 @@ mboxSendMsg(IN struct ADAPTER *prAdapter,
 	    IN enum EUNM_MSG_SEND_METHOD eMethod)
 {
 	struct MBOX *prMbox;
-
-	KAL_SPIN_LOCK_DECLARATION();
+	struct LINK_ENTRY *prHead;
 
 	ASSERT(eMboxId < MBOX_ID_TOTAL_NUM);
 	ASSERT(prMsg);
@@ -512,17 +541,22 @@ mboxSendMsg(IN struct ADAPTER *prAdapter,
 
 	switch (eMethod) {
 	case MSG_SEND_METHOD_BUF:
-		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
-		LINK_INSERT_TAIL(&prMbox->rLinkHead, &prMsg->rLinkEntry);
-		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
-
-		/* to wake up main service thread */
-		GLUE_SET_EVENT(prAdapter->prGlueInfo);
+		do {
+			prHead = prMbox->prHead;
+			prMsg->rLinkEntry.prNext = prHead;
+		} while (GLUE_CMPXCHG(&prMbox->prHead, prHead,
+				      &prMsg->rLinkEntry) != prHead);
+
+		/* to wake up main service thread, messages pushed on top of
+		 * a non-empty mailbox are taken by the same drain
+		 */
+		if (!prHead)
+			GLUE_SET_EVENT(prAdapter->prGlueInfo);
 
 		break;
 
 	case MSG_SEND_METHOD_UNBUF:
-		MBOX_HNDL_MSG(prAdapter, prMsg);
+		mboxHndlMsg(prAdapter, prMsg);
 		break;
 
 	default:
@@ -545,29 +579,32 @@ void mboxRcvAllMsg(IN struct ADAPTER *prAdapter,
 {
 	struct MBOX *prMbox;
 	struct MSG_HDR *prMsg;
-
-	KAL_SPIN_LOCK_DECLARATION();
+	struct LINK_ENTRY *prEntry, *prNext, *prList;
 
 	ASSERT(eMboxId < MBOX_ID_TOTAL_NUM);
 	ASSERT(prAdapter);
 
 	prMbox = &(prAdapter->arMbox[eMboxId]);
 
-	while (!LINK_IS_EMPTY(&prMbox->rLinkHead)) {
-		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
-		LINK_REMOVE_HEAD(&prMbox->rLinkHead, prMsg,
-				 struct MSG_HDR *);
-		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
-
-		ASSERT(prMsg);
-		if (!prMsg) {
-			DBGLOG(CNM, ERROR, "prMsg is NULL\n");
-			continue;
+	/* handlers may send more messages, drain until it stays empty */
+	while ((prEntry = GLUE_XCHG(&prMbox->prHead, NULL)) != NULL) {
+		/* reverse the LIFO list to handle messages in sent order */
+		prList = NULL;
+		while (prEntry) {
+			prNext = prEntry->prNext;
+			prEntry->prNext = prList;
+			prList = prEntry;
+			prEntry = prNext;
 		}
+
+		while (prList) {
+			prMsg = (struct MSG_HDR *) prList;
+			prList = prList->prNext;
 #ifdef UT_TEST_MODE
-		if (testMBoxRcv(prAdapter, prMsg))
+			if (testMBoxRcv(prAdapter, prMsg))
 #endif
-		MBOX_HNDL_MSG(prAdapter, prMsg);
+			mboxHndlMsg(prAdapter, prMsg);
+		}
 	}
 
 }
@@ -589,6 +626,8 @@ void mboxInitialize(IN struct ADAPTER *prAdapter)
 
 	/* Initialize Mailbox */
 	mboxInitMsgMap();
+	kalMemZero(prAdapter->arMboxMsgStat,
+		   sizeof(prAdapter->arMboxMsgStat));
 
 	/* Setup/initialize each mailbox */
 	for (i = 0; i < MBOX_ID_TOTAL_NUM; i++)
@@ -608,24 +647,19 @@ void mboxInitialize(IN struct ADAPTER *prAdapter)
 void mboxDestroy(IN struct ADAPTER *prAdapter)
 {
 	struct MBOX *prMbox;
-	struct MSG_HDR *prMsg;
+	struct LINK_ENTRY *prEntry, *prNext;
 	uint8_t i;
 
-	KAL_SPIN_LOCK_DECLARATION();
-
 	ASSERT(prAdapter);
 
 	for (i = 0; i < MBOX_ID_TOTAL_NUM; i++) {
 		prMbox = &(prAdapter->arMbox[i]);
 
-		while (!LINK_IS_EMPTY(&prMbox->rLinkHead)) {
-			KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
-			LINK_REMOVE_HEAD(&prMbox->rLinkHead, prMsg,
-					 struct MSG_HDR *);
-			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_MAILBOX);
-
-			ASSERT(prMsg);
-			cnmMemFree(prAdapter, prMsg);
+		prEntry = GLUE_XCHG(&prMbox->prHead, NULL);
+		while (prEntry) {
+			prNext = prEntry->prNext;
+			cnmMemFree(prAdapter, prEntry);
+			prEntry = prNext;
 		}
 	}
 }
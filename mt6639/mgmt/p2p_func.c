@@ -3292,7 +3292,7 @@ p2pFuncValidateAuth(IN struct ADAPTER *prAdapter,
 		/* ASSERT(prStaRec); */
 		if (!prStaRec) {
 			DBGLOG(P2P, WARN,
-				"StaRec Full. (%d)\n", CFG_STA_REC_NUM);
+				"StaRec Full. (%d)\n", prAdapter->ucStaRecNum);
 			return TRUE;
 		}
 
@@ -278,11 +278,11 @@ u_int8_t secCheckClassError(IN struct ADAPTER *prAdapter,
 	ASSERT(prAdapter);
 	ASSERT(prSwRfb);
 	prRxDescOps = prAdapter->chip_info->prRxDescOps;
-	ASSERT(prRxDescOps->nic_rxd_get_sw_class_error_bit);
+	ASSERT(RX_DESC_OPS_EXIST(prRxDescOps, get_sw_class_error_bit));
 
 	prRxStatus = prSwRfb->prRxStatus;
 
-	if (prRxDescOps->nic_rxd_get_sw_class_error_bit(prRxStatus)
+	if (RX_DESC_OPS_FN(prRxDescOps, get_sw_class_error_bit)(prRxStatus)
 	    || (IS_STA_IN_AIS(prStaRec)
 		&& aisGetAisBssInfo(prAdapter,
 		prStaRec->ucBssIndex)->eConnectionState ==
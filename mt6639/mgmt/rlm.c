@@ -4629,6 +4629,7 @@ static uint8_t rlmRecIeInfoForClient(struct ADAPTER *prAdapter,
 			       MAC2STR(prBssInfo->aucBSSID),
 			       prBssDesc->ucChannelNum, ucChannelAnnouncePri);
 			prBssDesc->ucChannelNum = ucChannelAnnouncePri;
+			scanUpdateBssDescIndex(prAdapter, prBssDesc);
 			prBssDesc->eChannelWidth = prBssInfo->ucVhtChannelWidth;
 			prBssDesc->ucCenterFreqS1 =
 				prBssInfo->ucVhtChannelFrequencyS1;
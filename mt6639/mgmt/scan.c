@@ -88,6 +88,10 @@ const char aucScanLogPrefix[][SCAN_LOG_PREFIX_MAX_LEN] = {
  *                   F U N C T I O N   D E C L A R A T I O N S
  *******************************************************************************
  */
+static void scanInitBssDescIndex(IN struct SCAN_INFO *prScanInfo);
+
+static void scanDelBssDescIndex(IN struct SCAN_INFO *prScanInfo,
+				IN struct BSS_DESC *prBssDesc);
 
 /*******************************************************************************
  *                              F U N C T I O N S
@@ -128,6 +132,7 @@ void scnInit(IN struct ADAPTER *prAdapter)
 
 	LINK_INITIALIZE(&prScanInfo->rFreeBSSDescList);
 	LINK_INITIALIZE(&prScanInfo->rBSSDescList);
+	scanInitBssDescIndex(prScanInfo);
 
 	for (i = 0; i < CFG_MAX_NUM_BSS_LIST; i++) {
 
@@ -225,6 +230,7 @@ void scnUninit(IN struct ADAPTER *prAdapter)
 	/* 4 <2> Reset link list of BSS_DESC_T */
 	LINK_INITIALIZE(&prScanInfo->rFreeBSSDescList);
 	LINK_INITIALIZE(&prScanInfo->rBSSDescList);
+	scanInitBssDescIndex(prScanInfo);
 
 #if (CFG_SUPPORT_WIFI_RNR == 1)
 	while (!LINK_IS_EMPTY(&prAdapter->rNeighborAPInfoList)) {
@@ -284,11 +290,12 @@ scanSearchBssDescByBssidAndChanNum(IN struct ADAPTER *prAdapter,
 	ASSERT(aucBSSID);
 
 	prScanInfo = &(prAdapter->rWifiVar.rScanInfo);
-	prBSSDescList = &prScanInfo->rBSSDescList;
+	prBSSDescList =
+		&prScanInfo->arBssDescHash[SCN_BSS_DESC_HASH(aucBSSID)];
 
-	/* Search BSS Desc from current SCAN result list. */
+	/* Search BSS Desc from the BSSID bucket of current SCAN result. */
 	LINK_FOR_EACH_ENTRY(prBssDesc, prBSSDescList,
-		rLinkEntry, struct BSS_DESC) {
+		rLinkEntryHash, struct BSS_DESC) {
 		if (!(EQUAL_MAC_ADDR(prBssDesc->aucBSSID, aucBSSID)))
 			continue;
 		if (fgCheckChanNum == FALSE || ucChannelNum == 0)
@@ -297,7 +304,7 @@ scanSearchBssDescByBssidAndChanNum(IN struct ADAPTER *prAdapter,
 			return prBssDesc;
 	}
 
-	return prBssDesc;
+	return NULL;
 }
 #endif
 
@@ -642,11 +649,12 @@ scanSearchBssDescByBssidAndSsid(IN struct ADAPTER *prAdapter,
 
 	prScanInfo = &(prAdapter->rWifiVar.rScanInfo);
 
-	prBSSDescList = &prScanInfo->rBSSDescList;
+	prBSSDescList =
+		&prScanInfo->arBssDescHash[SCN_BSS_DESC_HASH(aucBSSID)];
 
-	/* Search BSS Desc from current SCAN result list. */
+	/* Search BSS Desc from the BSSID bucket of current SCAN result. */
 	LINK_FOR_EACH_ENTRY(prBssDesc, prBSSDescList,
-		rLinkEntry, struct BSS_DESC) {
+		rLinkEntryHash, struct BSS_DESC) {
 
 		if (!(EQUAL_MAC_ADDR(prBssDesc->aucBSSID, aucBSSID)))
 			continue;
@@ -1134,6 +1142,7 @@ void scanRemoveBssDescByBssid(IN struct ADAPTER *prAdapter,
 	struct SCAN_INFO *prScanInfo;
 	struct LINK *prBSSDescList;
 	struct LINK *prFreeBSSDescList;
+	struct LINK *prHashList;
 	struct BSS_DESC *prBssDesc = (struct BSS_DESC *) NULL;
 	struct BSS_DESC *prBSSDescNext;
 	uint8_t ucTargetChNum = 0;
@@ -1145,10 +1154,11 @@ void scanRemoveBssDescByBssid(IN struct ADAPTER *prAdapter,
 	prScanInfo = &(prAdapter->rWifiVar.rScanInfo);
 	prBSSDescList = &prScanInfo->rBSSDescList;
 	prFreeBSSDescList = &prScanInfo->rFreeBSSDescList;
+	prHashList = &prScanInfo->arBssDescHash[SCN_BSS_DESC_HASH(aucBSSID)];
 
-	/* Check if such BSS Descriptor exists in a valid list */
-	LINK_FOR_EACH_ENTRY_SAFE(prBssDesc, prBSSDescNext, prBSSDescList,
-		rLinkEntry, struct BSS_DESC) {
+	/* Check if such BSS Descriptor exists in its BSSID bucket */
+	LINK_FOR_EACH_ENTRY_SAFE(prBssDesc, prBSSDescNext, prHashList,
+		rLinkEntryHash, struct BSS_DESC) {
 
 		if (EQUAL_MAC_ADDR(prBssDesc->aucBSSID, aucBSSID)) {
 			/* Because BSS descriptor will be cleared in next step,
@@ -1175,7 +1185,7 @@ void scanRemoveBssDescByBssid(IN struct ADAPTER *prAdapter,
 				eTargetBand);
 
 			/* BSSID is not unique, so need to traverse
-			 * whols link-list
+			 * whole bucket
 			 */
 		}
 	}
@@ -1202,9 +1212,11 @@ void scanRemoveBssDescByBandAndNetwork(IN struct ADAPTER *prAdapter,
 	struct SCAN_INFO *prScanInfo;
 	struct LINK *prBSSDescList;
 	struct LINK *prFreeBSSDescList;
+	struct LINK *prChnlList;
 	struct BSS_DESC *prBssDesc = (struct BSS_DESC *) NULL;
 	struct BSS_DESC *prBSSDescNext;
 	u_int8_t fgToRemove;
+	uint8_t i;
 
 	ASSERT(prAdapter);
 	ASSERT(eBand <= BAND_NUM);
@@ -1219,12 +1231,18 @@ void scanRemoveBssDescByBandAndNetwork(IN struct ADAPTER *prAdapter,
 		return;
 	}
 
-	/* Check if such BSS Descriptor exists in a valid list */
-	LINK_FOR_EACH_ENTRY_SAFE(prBssDesc, prBSSDescNext, prBSSDescList,
-		rLinkEntry, struct BSS_DESC) {
-		fgToRemove = FALSE;
+	/* Only the channel buckets of this band can hold such BSS Desc */
+	for (i = 0; i < SCN_BSS_DESC_CHNL_HASH_NUM; i++) {
+		prChnlList = &prScanInfo->aarBssDescChnl[
+			SCN_BSS_DESC_BAND_IDX(eBand)][i];
+
+		LINK_FOR_EACH_ENTRY_SAFE(prBssDesc, prBSSDescNext, prChnlList,
+			rLinkEntryChnl, struct BSS_DESC) {
+			fgToRemove = FALSE;
+
+			if (prBssDesc->eBand != eBand)
+				continue;
 
-		if (prBssDesc->eBand == eBand) {
 			switch (GET_BSS_INFO_BY_INDEX(
 				prAdapter, ucBssIndex)->eNetworkType) {
 			case NETWORK_TYPE_AIS:
@@ -1249,17 +1267,17 @@ void scanRemoveBssDescByBandAndNetwork(IN struct ADAPTER *prAdapter,
 				ASSERT(0);
 				break;
 			}
-		}
 
-		if (fgToRemove == TRUE) {
-			scanRemoveBssDescFromList(prBSSDescList,
-				prBssDesc,
-				prAdapter);
+			if (fgToRemove == TRUE) {
+				scanRemoveBssDescFromList(prBSSDescList,
+					prBssDesc,
+					prAdapter);
 
-			/* Return this BSS Desc to the free BSS Desc list. */
-			scanInsertBssDescToList(prFreeBSSDescList,
-				prBssDesc,
-				FALSE);
+				/* Return this BSS Desc to the free list. */
+				scanInsertBssDescToList(prFreeBSSDescList,
+					prBssDesc,
+					FALSE);
+			}
 		}
 	}
 }	/* end of scanRemoveBssDescByBand() */
@@ -1284,18 +1302,19 @@ void scanRemoveConnFlagOfBssDescByBssid(IN struct ADAPTER *prAdapter,
 	ASSERT(aucBSSID);
 
 	prScanInfo = &(prAdapter->rWifiVar.rScanInfo);
-	prBSSDescList = &prScanInfo->rBSSDescList;
+	prBSSDescList =
+		&prScanInfo->arBssDescHash[SCN_BSS_DESC_HASH(aucBSSID)];
 
-	/* Search BSS Desc from current SCAN result list. */
+	/* Search BSS Desc from the BSSID bucket of current SCAN result. */
 	LINK_FOR_EACH_ENTRY(prBssDesc, prBSSDescList,
-		rLinkEntry, struct BSS_DESC) {
+		rLinkEntryHash, struct BSS_DESC) {
 
 		if (EQUAL_MAC_ADDR(prBssDesc->aucBSSID, aucBSSID)) {
 			prBssDesc->fgIsConnected = FALSE;
 			prBssDesc->fgIsConnecting = FALSE;
 
 			/* BSSID is not unique, so need to
-			 * traverse whols link-list
+			 * traverse whole bucket
 			 */
 		}
 	}
@@ -1893,6 +1912,7 @@ struct BSS_DESC *scanAllocateBssDesc(IN struct ADAPTER *prAdapter)
 		scanInsertBssDescToList(prBSSDescList,
 			prBssDesc,
 			TRUE);
+		scanUpdateBssDescIndex(prAdapter, prBssDesc);
 	}
 
 	return prBssDesc;
@@ -2295,6 +2315,7 @@ struct BSS_DESC *scanAddToBssDesc(IN struct ADAPTER *prAdapter,
 	COPY_MAC_ADDR(prBssDesc->aucSrcAddr, prWlanBeaconFrame->aucSrcAddr);
 
 	COPY_MAC_ADDR(prBssDesc->aucBSSID, prWlanBeaconFrame->aucBSSID);
+	scanUpdateBssDescIndex(prAdapter, prBssDesc);
 
 	prBssDesc->u8TimeStamp.QuadPart = u8Timestamp;
 
@@ -2887,6 +2908,8 @@ struct BSS_DESC *scanAddToBssDesc(IN struct ADAPTER *prAdapter,
 				prBssDesc->ucChannelNum, ucHwChannelNum);
 		}
 #endif
+		/* Refile under the (band, channel) just learned */
+		scanUpdateBssDescIndex(prAdapter, prBssDesc);
 	}
 
 	/* 4 <5> Check IE information corret or not */
@@ -4528,11 +4551,12 @@ struct BSS_DESC *scanSearchBssDescByBssidAndLatestUpdateTime(
 
 	prScanInfo = &(prAdapter->rWifiVar.rScanInfo);
 
-	prBSSDescList = &prScanInfo->rBSSDescList;
+	prBSSDescList =
+		&prScanInfo->arBssDescHash[SCN_BSS_DESC_HASH(aucBSSID)];
 
-	/* Search BSS Desc from current SCAN result list. */
+	/* Search BSS Desc from the BSSID bucket of current SCAN result. */
 	LINK_FOR_EACH_ENTRY(
-		prBssDesc, prBSSDescList, rLinkEntry, struct BSS_DESC) {
+		prBssDesc, prBSSDescList, rLinkEntryHash, struct BSS_DESC) {
 
 		if (EQUAL_MAC_ADDR(prBssDesc->aucBSSID, aucBSSID)) {
 			if (!rLatestUpdateTime
@@ -4850,6 +4874,10 @@ void scanRemoveBssDescFromList(IN struct LINK *prBSSDescList,
 		}
 		/* end Support AP Selection */
 
+		/* Remove this BSS Desc from the BSSID/channel buckets */
+		scanDelBssDescIndex(&prAdapter->rWifiVar.rScanInfo,
+			prBssDesc);
+
 		/* Remove this BSS Desc from the BSS Desc list */
 		if (prBSSDescList != NULL)
 			LINK_REMOVE_KNOWN_ENTRY(prBSSDescList, prBssDesc);
@@ -4910,8 +4938,104 @@ void scanResetBssDesc(IN struct ADAPTER *prAdapter,
 	scanInsertBssDescToList(prBSSDescList,
 		prBssDesc,
 		TRUE);
+	scanUpdateBssDescIndex(prAdapter, prBssDesc);
 }	/* end of scanResetBssDesc() */
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Reset the BSSID hash and (band, channel) buckets.
+ *
+ * @param[in] prScanInfo Pointer to the SCAN_INFO structure.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void scanInitBssDescIndex(IN struct SCAN_INFO *prScanInfo)
+{
+	uint32_t i, j;
+
+	for (i = 0; i < SCN_BSS_DESC_HASH_NUM; i++)
+		LINK_INITIALIZE(&prScanInfo->arBssDescHash[i]);
+
+	for (i = 0; i < BAND_NUM; i++)
+		for (j = 0; j < SCN_BSS_DESC_CHNL_HASH_NUM; j++)
+			LINK_INITIALIZE(&prScanInfo->aarBssDescChnl[i][j]);
+}	/* end of scanInitBssDescIndex() */
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Take the BSS Descriptor out of its BSSID and channel buckets.
+ *
+ * @param[in] prScanInfo Pointer to the SCAN_INFO structure.
+ * @param[in] prBssDesc  Pointer to the BSS_DESC structure.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void scanDelBssDescIndex(IN struct SCAN_INFO *prScanInfo,
+				IN struct BSS_DESC *prBssDesc)
+{
+	if (LINK_ENTRY_IS_VALID(&prBssDesc->rLinkEntryHash)) {
+		LINK_REMOVE_KNOWN_ENTRY(
+			&prScanInfo->arBssDescHash[prBssDesc->ucHashIdx],
+			&prBssDesc->rLinkEntryHash);
+	}
+
+	if (LINK_ENTRY_IS_VALID(&prBssDesc->rLinkEntryChnl)) {
+		LINK_REMOVE_KNOWN_ENTRY(
+			&prScanInfo->aarBssDescChnl[prBssDesc->ucChnlBandIdx]
+				[prBssDesc->ucChnlHashIdx],
+			&prBssDesc->rLinkEntryChnl);
+	}
+}	/* end of scanDelBssDescIndex() */
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief File a BSS Descriptor of rBSSDescList under the BSSID and
+ *        (band, channel) buckets matching its current aucBSSID, eBand
+ *        and ucChannelNum. Must be called whenever one of them changes.
+ *
+ * @param[in] prAdapter  Pointer to the Adapter structure.
+ * @param[in] prBssDesc  Pointer to the BSS_DESC structure.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void scanUpdateBssDescIndex(IN struct ADAPTER *prAdapter,
+			    IN struct BSS_DESC *prBssDesc)
+{
+	struct SCAN_INFO *prScanInfo;
+	uint8_t ucHashIdx, ucBandIdx, ucChnlIdx;
+
+	if (!prAdapter || !prBssDesc)
+		return;
+
+	prScanInfo = &(prAdapter->rWifiVar.rScanInfo);
+
+	ucHashIdx = SCN_BSS_DESC_HASH(prBssDesc->aucBSSID);
+	ucBandIdx = SCN_BSS_DESC_BAND_IDX(prBssDesc->eBand);
+	ucChnlIdx = SCN_BSS_DESC_CHNL_HASH(prBssDesc->ucChannelNum);
+
+	/* Already filed under the right buckets */
+	if (LINK_ENTRY_IS_VALID(&prBssDesc->rLinkEntryHash) &&
+	    LINK_ENTRY_IS_VALID(&prBssDesc->rLinkEntryChnl) &&
+	    prBssDesc->ucHashIdx == ucHashIdx &&
+	    prBssDesc->ucChnlBandIdx == ucBandIdx &&
+	    prBssDesc->ucChnlHashIdx == ucChnlIdx)
+		return;
+
+	scanDelBssDescIndex(prScanInfo, prBssDesc);
+
+	prBssDesc->ucHashIdx = ucHashIdx;
+	prBssDesc->ucChnlBandIdx = ucBandIdx;
+	prBssDesc->ucChnlHashIdx = ucChnlIdx;
+
+	LINK_INSERT_TAIL(&prScanInfo->arBssDescHash[ucHashIdx],
+		&prBssDesc->rLinkEntryHash);
+	LINK_INSERT_TAIL(&prScanInfo->aarBssDescChnl[ucBandIdx][ucChnlIdx],
+		&prBssDesc->rLinkEntryChnl);
+}	/* end of scanUpdateBssDescIndex() */
+
 /*----------------------------------------------------------------------------*/
 /*!
  * @brief Check if VHT IE exists in Vendor Epigram IE.
@@ -422,13 +422,11 @@ struct CMD_INFO *cmdBufAllocateCmdInfo(IN struct ADAPTER
 	} else if (!fgCmdDumpIsDone) {
 		struct GLUE_INFO *prGlueInfo = prAdapter->prGlueInfo;
 		struct QUE *prCmdQue = &prGlueInfo->rCmdQueue;
-		struct QUE *prPendingCmdQue = &prAdapter->rPendingCmdQueue;
 		struct TX_TCQ_STATUS *prTc = &prAdapter->rTxCtrl.rTc;
 
 		fgCmdDumpIsDone = TRUE;
 		cmdBufDumpCmdQueue(prCmdQue, "waiting Tx CMD queue");
-		cmdBufDumpCmdQueue(prPendingCmdQue,
-				   "waiting response CMD queue");
+		nicDumpPendingCmdInfo(prAdapter);
 		DBGLOG(NIC, INFO, "Tc4 number:%d\n",
 		       prTc->au4FreeBufferCount[TC4_INDEX]);
 	}
@@ -773,7 +773,126 @@ void nicSetSwIntr(IN struct ADAPTER *prAdapter,
 
 /*----------------------------------------------------------------------------*/
 /*!
- * @brief This procedure is used to dequeue from prAdapter->rPendingCmdQueue
+ * @brief This procedure is used to reset the pending command table
+ *
+ * @param    prAdapter   Pointer of ADAPTER_T
+ *
+ * @retval - (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicInitPendingCmdInfo(IN struct ADAPTER *prAdapter)
+{
+	kalMemZero(prAdapter->aprPendingCmdInfo,
+		   sizeof(prAdapter->aprPendingCmdInfo));
+	prAdapter->u4PendingCmdNum = 0;
+	QUEUE_INITIALIZE(&prAdapter->rPendingCmdQueue);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief This procedure is used to add a command waiting for response to
+ *        the pending command table. Caller shall hold SPIN_LOCK_CMD_PENDING.
+ *
+ * @param    prAdapter   Pointer of ADAPTER_T
+ *           prCmdInfo   Pointer of CMD_INFO_T
+ *
+ * @retval - (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicEnqueuePendingCmdInfo(IN struct ADAPTER *prAdapter,
+			      IN struct CMD_INFO *prCmdInfo)
+{
+	struct CMD_INFO **pprSlot =
+		&prAdapter->aprPendingCmdInfo[prCmdInfo->ucCmdSeqNum];
+
+	/* An older command still owns the sequence number, so the response
+	 * is matched to it first, as the queue order used to do.
+	 */
+	if (*pprSlot == NULL)
+		*pprSlot = prCmdInfo;
+	else
+		QUEUE_INSERT_TAIL(&prAdapter->rPendingCmdQueue,
+				  &prCmdInfo->rQueEntry);
+
+	prAdapter->u4PendingCmdNum++;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief This procedure is used to move all pending commands to a queue,
+ *        oldest sequence number first. Caller shall hold
+ *        SPIN_LOCK_CMD_PENDING.
+ *
+ * @param    prAdapter   Pointer of ADAPTER_T
+ *           prQue       Queue to receive the pending commands
+ *
+ * @retval - (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicDequeueAllPendingCmdInfo(IN struct ADAPTER *prAdapter,
+				 OUT struct QUE *prQue)
+{
+	struct CMD_INFO *prCmdInfo;
+	uint32_t u4Idx;
+	uint8_t ucSeqNum;
+
+	QUEUE_INITIALIZE(prQue);
+
+	if (prAdapter->u4PendingCmdNum == 0)
+		return;
+
+	ucSeqNum = prAdapter->ucCmdSeqNum;
+	for (u4Idx = 0; u4Idx < PENDING_CMD_SLOT_NUM; u4Idx++) {
+		ucSeqNum++;
+		prCmdInfo = prAdapter->aprPendingCmdInfo[ucSeqNum];
+		if (!prCmdInfo)
+			continue;
+
+		prAdapter->aprPendingCmdInfo[ucSeqNum] = NULL;
+		QUEUE_INSERT_TAIL(prQue, &prCmdInfo->rQueEntry);
+	}
+	QUEUE_CONCATENATE_QUEUES(prQue, &prAdapter->rPendingCmdQueue);
+
+	prAdapter->u4PendingCmdNum = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief This procedure is used to dump the pending command table
+ *
+ * @param    prAdapter   Pointer of ADAPTER_T
+ *
+ * @retval - (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicDumpPendingCmdInfo(IN struct ADAPTER *prAdapter)
+{
+	struct CMD_INFO *prCmdInfo;
+	uint32_t u4Idx;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
+
+	DBGLOG(NIC, INFO,
+	       "Dump CMD info for waiting response CMD table, Elem number:%u\n",
+	       prAdapter->u4PendingCmdNum);
+	for (u4Idx = 0; u4Idx < PENDING_CMD_SLOT_NUM; u4Idx++) {
+		prCmdInfo = prAdapter->aprPendingCmdInfo[u4Idx];
+		if (prCmdInfo)
+			DBGLOG(NIC, INFO, "CID:%d SEQ:%d\n",
+			       prCmdInfo->ucCID, prCmdInfo->ucCmdSeqNum);
+	}
+	if (prAdapter->rPendingCmdQueue.u4NumElem)
+		cmdBufDumpCmdQueue(&prAdapter->rPendingCmdQueue,
+				   "waiting response CMD with reused SEQ");
+
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief This procedure is used to dequeue from the pending command table
  *        with specified sequential number
  *
  * @param    prAdapter   Pointer of ADAPTER_T
@@ -790,6 +909,7 @@ struct CMD_INFO *nicGetPendingCmdInfo(IN struct ADAPTER
 	struct QUE *prTempCmdQue = &rTempCmdQue;
 	struct QUE_ENTRY *prQueueEntry = (struct QUE_ENTRY *) NULL;
 	struct CMD_INFO *prCmdInfo = (struct CMD_INFO *) NULL;
+	struct CMD_INFO *prNextCmdInfo = (struct CMD_INFO *) NULL;
 
 	KAL_SPIN_LOCK_DECLARATION();
 
@@ -797,25 +917,39 @@ struct CMD_INFO *nicGetPendingCmdInfo(IN struct ADAPTER
 
 	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
 
-	prCmdQue = &prAdapter->rPendingCmdQueue;
-	QUEUE_MOVE_ALL(prTempCmdQue, prCmdQue);
+	prCmdInfo = prAdapter->aprPendingCmdInfo[ucSeqNum];
+	if (prCmdInfo) {
+		prAdapter->u4PendingCmdNum--;
 
-	QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
-			  struct QUE_ENTRY *);
-	while (prQueueEntry) {
-		prCmdInfo = (struct CMD_INFO *) prQueueEntry;
+		/* Hand the slot to the next command with the same sequence
+		 * number. This only happens when a command never got its
+		 * response before the sequence number wrapped around.
+		 */
+		prCmdQue = &prAdapter->rPendingCmdQueue;
+		if (prCmdQue->u4NumElem) {
+			QUEUE_MOVE_ALL(prTempCmdQue, prCmdQue);
 
-		if (prCmdInfo->ucCmdSeqNum == ucSeqNum)
-			break;
+			QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
+					  struct QUE_ENTRY *);
+			while (prQueueEntry) {
+				prNextCmdInfo =
+					(struct CMD_INFO *) prQueueEntry;
 
-		QUEUE_INSERT_TAIL(prCmdQue, prQueueEntry);
+				if (prNextCmdInfo->ucCmdSeqNum == ucSeqNum)
+					break;
 
-		prCmdInfo = NULL;
+				QUEUE_INSERT_TAIL(prCmdQue, prQueueEntry);
 
-		QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
-				  struct QUE_ENTRY *);
+				prNextCmdInfo = NULL;
+
+				QUEUE_REMOVE_HEAD(prTempCmdQue, prQueueEntry,
+						  struct QUE_ENTRY *);
+			}
+			QUEUE_CONCATENATE_QUEUES(prCmdQue, prTempCmdQue);
+		}
+
+		prAdapter->aprPendingCmdInfo[ucSeqNum] = prNextCmdInfo;
 	}
-	QUEUE_CONCATENATE_QUEUES(prCmdQue, prTempCmdQue);
 
 	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_CMD_PENDING);
 
@@ -3272,9 +3272,14 @@ uint32_t nicCfgChipCapMacCap(IN struct ADAPTER *prAdapter,
 		prAdapter->ucWtblEntryNum = prMacCap->ucWtblEntryNum;
 		prAdapter->ucTxDefaultWlanIndex = prAdapter->ucWtblEntryNum
 						  - 1;
+		/* Each STA_RECORD needs a pairwise entry below the default */
+		prAdapter->ucStaRecNum = prAdapter->ucTxDefaultWlanIndex;
+		if (prAdapter->ucStaRecNum == 0 ||
+		    prAdapter->ucStaRecNum > CFG_STA_REC_NUM)
+			prAdapter->ucStaRecNum = CFG_STA_REC_NUM;
 	}
-	DBGLOG(INIT, INFO, "ucWtblEntryNum: %d.\n",
-	       prMacCap->ucWtblEntryNum);
+	DBGLOG(INIT, INFO, "ucWtblEntryNum: %d, ucStaRecNum: %d.\n",
+	       prMacCap->ucWtblEntryNum, prAdapter->ucStaRecNum);
 
 	prAdapter->ucWmmSetNum = prMacCap->ucWmmSet > 0 ?
 		prMacCap->ucWmmSet : 1;
@@ -5957,6 +5962,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 	uint32_t *p32tmp = NULL;
 	struct CSI_DATA_T *prCSIData = NULL;
 	struct CSI_INFO_T *prCSIInfo = &(prAdapter->rCSIInfo);
+	struct CSI_SCRATCH_T *prScratch = &(prCSIInfo->rScratch);
 	/* u2Offset is 8 bytes currently, tag 4 bytes + length 4 bytes */
 	uint16_t u2Offset = OFFSET_OF(struct CSI_TLV_ELEMENT, aucbody);
 	uint32_t u4Tmp = 0;
@@ -5979,10 +5985,11 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 			i4EventLen);
 		return;
 	}
-	prCSIData = kalMemAlloc(sizeof(struct CSI_DATA_T), VIR_MEM_TYPE);
-
+	/* The report is parsed in place into the next ring slot */
+	prCSIData = wlanCSIRingReserve(prAdapter);
 	if (!prCSIData) {
-		DBGLOG(NIC, WARN, "[CSI] Alloc prCSIData failed!");
+		DBGLOG_LIMITED(NIC, WARN, "[CSI] ring full, drop %u\n",
+			prCSIInfo->u4CSIDropCnt);
 		return;
 	}
 
@@ -6007,7 +6014,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid FwVer len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 			u4Tmp = le32_to_cpup(
 					(uint32_t *) prCSITlvData->aucbody);
@@ -6018,7 +6025,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid CBW len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 			prCSIData->ucBw = le32_to_cpup(
 					(uint32_t *) prCSITlvData->aucbody);
@@ -6028,7 +6035,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid RSSI len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->cRssi =
@@ -6040,7 +6047,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid SNR len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->ucSNR =
@@ -6052,7 +6059,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid BAND len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->ucDbdcIdx =
@@ -6064,7 +6071,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid CSI num len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->u2DataCount =
@@ -6076,7 +6083,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid CSI count %u\n",
 					prCSIData->u2DataCount);
-				goto out;
+				return;
 			}
 
 			if (prCSITlvData->body_len !=
@@ -6084,7 +6091,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid CSI num len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			kalMemZero(prCSIData->ac2IData,
@@ -6100,7 +6107,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid CSI count %u\n",
 					prCSIData->u2DataCount);
-				goto out;
+				return;
 			}
 
 			if (prCSITlvData->body_len !=
@@ -6108,7 +6115,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid CSI num len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			kalMemZero(prCSIData->ac2QData,
@@ -6124,7 +6131,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid DBW len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->ucDataBw =
@@ -6135,7 +6142,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid CH IDX len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->ucPrimaryChIdx =
@@ -6152,7 +6159,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid TA len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 			kalMemCopy(prCSIData->aucTA, prCSITlvData->aucbody,
 				sizeof(prCSIData->aucTA));
@@ -6162,7 +6169,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid Error len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 			prCSIData->u4ExtraInfo =
 				le32_to_cpup((int32_t *) prCSITlvData->aucbody);
@@ -6172,7 +6179,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid Rx Mode len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 			u4Tmp = le32_to_cpup((int32_t *) prCSITlvData->aucbody);
 
@@ -6190,7 +6197,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid RSVD1 len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			kalMemCopy(prCSIData->ai4Rsvd1,
@@ -6206,7 +6213,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid RSVD2 len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 			prCSIData->ucRsvd2Cnt =
 				prCSITlvData->body_len / sizeof(int32_t);
@@ -6220,7 +6227,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid RSVD3 len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->i4Rsvd3 =
@@ -6231,7 +6238,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid RSVD4 len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->ucRsvd4 =
@@ -6243,7 +6250,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid Antenna_pattern len %u",
 					prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 
 			prCSIData->Antenna_pattern =
@@ -6257,7 +6264,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] drop Antenna_pattern=%d\n",
 					prCSIData->Antenna_pattern);
-				goto out;
+				return;
 			}
 			break;
 		case CSI_EVENT_TX_RX_IDX:
@@ -6265,7 +6272,7 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 				DBGLOG(NIC, WARN,
 					"[CSI] Invalid TRxIdx len %u",
 							prCSITlvData->body_len);
-				goto out;
+				return;
 			}
 			prCSIData->u4TRxIdx = le32_to_cpup(
 					(uint32_t *) prCSITlvData->aucbody);
@@ -6297,17 +6304,17 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 	if (prCSIInfo->ucValue1[CSI_CONFIG_OUTPUT_FORMAT] ==
 		CSI_OUTPUT_TONE_MASKED_SHIFTED &&
 		!prCSIData->bIsCck) {
-		kalMemCopy(prCSIInfo->ai2TempIData,
+		kalMemCopy(prScratch->ai2TempIData,
 			prCSIData->ac2IData,
 			sizeof(int16_t) * prCSIData->u2DataCount);
-		kalMemCopy(prCSIInfo->ai2TempQData,
+		kalMemCopy(prScratch->ai2TempQData,
 			prCSIData->ac2QData,
 			sizeof(int16_t) * prCSIData->u2DataCount);
 		wlanShiftCSI(prCSIData->ucRxMode,
 			prCSIData->ucBw, prCSIData->ucDataBw,
 			prCSIData->ucPrimaryChIdx,
-			prCSIInfo->ai2TempIData,
-			prCSIInfo->ai2TempQData,
+			prScratch->ai2TempIData,
+			prScratch->ai2TempQData,
 			prCSIData->ac2IData,
 			prCSIData->ac2QData);
 
@@ -6322,18 +6329,16 @@ nicEventCSIData(IN struct ADAPTER *prAdapter, IN struct WIFI_EVENT *prEvent)
 	}
 
 #if CFG_SUPPORT_CSI_NF
-	ucRes = wlanCSINoiseFilter(prAdapter, prCSIData);
+	ucRes = wlanCSINoiseFilter(prAdapter, prCSIData,
+		prScratch->au4CsiVal);
 	if (ucRes == FALSE) {
 		DBGLOG(INIT, STATE, "[CSI] drop noise\n");
-		goto out;
+		return;
 	}
 #endif
 
-	wlanPushCSIData(prAdapter, prCSIData);
+	wlanCSIRingCommit(prAdapter);
 	wake_up_interruptible(&(prAdapter->rCSIInfo.waitq));
-
-out:
-	kalMemFree(prCSIData, VIR_MEM_TYPE, sizeof(struct CSI_DATA_T));
 }
 #endif
 
@@ -218,6 +218,9 @@ static struct RX_EVENT_HANDLER arEventTable[] = {
 #endif
 };
 
+/* Event handlers indexed by EID, built from arEventTable */
+static PROCESS_RX_EVENT_FUNCTION apfnEventTable[RX_EVENT_ID_NUM];
+
 static const struct ACTION_FRAME_SIZE_MAP arActionFrameReservedLen[] = {
 	{(uint16_t)(CATEGORY_QOS_ACTION | ACTION_QOS_MAP_CONFIGURE << 8),
 	 sizeof(struct _ACTION_QOS_MAP_CONFIGURE_FRAME)},
@@ -275,11 +278,58 @@ static const struct ACTION_FRAME_SIZE_MAP arActionFrameReservedLen[] = {
  *                   F U N C T I O N   D E C L A R A T I O N S
  *******************************************************************************
  */
+static u_int8_t nicRxDeferReturnRFB(IN struct ADAPTER *prAdapter,
+	IN struct SW_RFB *prSwRfb, IN u_int8_t fgRefill);
 
 /*******************************************************************************
  *                              F U N C T I O N S
  *******************************************************************************
  */
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Build the EID indexed event handler table from arEventTable, so
+ *        event dispatch does not need to scan arEventTable.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void nicRxInitEventTable(void)
+{
+	uint32_t u4Idx;
+
+	kalMemZero(apfnEventTable, sizeof(apfnEventTable));
+
+	for (u4Idx = 0; u4Idx < ARRAY_SIZE(arEventTable); u4Idx++) {
+		/* keep the first handler like the linear scan did */
+		if (apfnEventTable[arEventTable[u4Idx].eEID])
+			continue;
+		apfnEventTable[arEventTable[u4Idx].eEID] =
+			arEventTable[u4Idx].pfnHandler;
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Account one dispatched event to its event statistics.
+ *
+ * @param prStat         Statistics entry of the event ID.
+ * @param u8StartTime    sched_clock() before the event was dispatched.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicRxUpdateEventStat(IN struct RX_EVENT_STAT *prStat,
+	IN uint64_t u8StartTime)
+{
+	uint64_t u8Time = sched_clock() - u8StartTime;
+
+	prStat->u4HitCnt++;
+	prStat->u8TotalTime += u8Time;
+	if (u8Time > prStat->u4MaxTime)
+		prStat->u4MaxTime = u8Time > 0xFFFFFFFF ?
+			0xFFFFFFFF : (uint32_t)u8Time;
+}
+
 /*----------------------------------------------------------------------------*/
 /*!
  * @brief Initialize the RFBs
@@ -305,10 +355,22 @@ void nicRxInitialize(IN struct ADAPTER *prAdapter)
 	kalMemZero((void *) prRxCtrl->pucRxCached,
 		   prRxCtrl->u4RxCachedSize);
 
+	kalMemZero(prRxCtrl->arEventStat, sizeof(prRxCtrl->arEventStat));
+	kalMemZero(prRxCtrl->arUniEventStat,
+		   sizeof(prRxCtrl->arUniEventStat));
+	nicRxInitEventTable();
+
 	/* 4 <1> Initialize the RFB lists */
 	QUEUE_INITIALIZE(&prRxCtrl->rFreeSwRfbList);
 	QUEUE_INITIALIZE(&prRxCtrl->rReceivedRfbList);
+	QUEUE_INITIALIZE(&prRxCtrl->rReceivedDataRfbList);
 	QUEUE_INITIALIZE(&prRxCtrl->rIndicatedRfbList);
+	for (i = 0; i < RX_RETURN_BATCH_NUM; i++) {
+		QUEUE_INITIALIZE(&prRxCtrl->arReturnBatch[i].rRfbList);
+		QUEUE_INITIALIZE(&prRxCtrl->arReturnBatch[i].rRefillList);
+		prRxCtrl->arReturnBatch[i].u4Owner = 0;
+		prRxCtrl->arReturnBatch[i].u4Depth = 0;
+	}
 
 	pucMemHandle = prRxCtrl->pucRxCached;
 	for (i = CFG_RX_MAX_PKT_NUM; i != 0; i--) {
@@ -373,6 +435,11 @@ void nicRxUninitialize(IN struct ADAPTER *prAdapter)
 
 	nicRxFlush(prAdapter);
 
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+	QUEUE_CONCATENATE_QUEUES(&prRxCtrl->rReceivedRfbList,
+				 &prRxCtrl->rReceivedDataRfbList);
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+
 	do {
 		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 		QUEUE_REMOVE_HEAD(&prRxCtrl->rReceivedRfbList, prSwRfb,
@@ -421,8 +488,8 @@ void nicRxFillRFB(IN struct ADAPTER *prAdapter,
 {
 	struct RX_DESC_OPS_T *prRxDescOps = prAdapter->chip_info->prRxDescOps;
 
-	if (prRxDescOps->nic_rxd_fill_rfb)
-		prRxDescOps->nic_rxd_fill_rfb(prAdapter, prSwRfb);
+	if (RX_DESC_OPS_EXIST(prRxDescOps, fill_rfb))
+		RX_DESC_OPS_FN(prRxDescOps, fill_rfb)(prAdapter, prSwRfb);
 	else
 		DBGLOG(RX, ERROR,
 			"%s:: no nic_rxd_fill_rfb??\n",
@@ -453,11 +520,11 @@ void nicRxFillChksumStatus(IN struct ADAPTER *prAdapter,
 
 	u4TcpUdpIpCksStatus = prSwRfb->u4TcpUdpIpCksStatus;
 	rReport = (struct RX_CSO_REPORT_T *) &u4TcpUdpIpCksStatus;
-	DBGLOG_LIMITED(RX, LOUD,
+	DBGTRACE_LIMITED(RX, LOUD,
 	       "RX_IPV4_STATUS=%d, RX_TCP_STATUS=%d, RX_UDP_STATUS=%d\n",
 	       rReport->u4IpV4CksStatus, rReport->u4TcpCksStatus,
 	       rReport->u4UdpCksStatus);
-	DBGLOG_LIMITED(RX, LOUD,
+	DBGTRACE_LIMITED(RX, LOUD,
 		"RX_IPV4_TYPE=%d, RX_IPV6_TYPE=%d, RX_TCP_TYPE=%d, RX_UDP_TYPE=%d\n",
 	  rReport->u4IpV4CksType, rReport->u4IpV6CksType,
 	  rReport->u4TcpCksType, rReport->u4UdpCksType);
@@ -967,8 +1034,8 @@ u_int8_t nicRxIsDuplicateFrame(IN OUT struct SW_RFB
 			 *          aggregation.
 			 */
 
-			DBGLOG(RX, LOUD, "RX: SC=0x%X (BA Entry present)\n",
-			       u2SequenceControl);
+			DBGTRACE(RX, LOUD, "RX: SC=0x%X (BA Entry present)\n",
+				 u2SequenceControl);
 
 			/* Update the SN cache in order to ensure the
 			 * correctness of duplicate removal in case the
@@ -1033,8 +1100,9 @@ u_int8_t nicRxIsDuplicateFrame(IN OUT struct SW_RFB
 				prSwRfb->prStaRec->
 					afgIsIgnoreAmsduDuplicate[
 					u4SeqCtrlCacheIdx] = TRUE;
-			DBGLOG(RX, LOUD, "RXM: SC= 0x%x (Cache[%u] updated)\n",
-			       u2SequenceControl, u4SeqCtrlCacheIdx);
+			DBGTRACE(RX, LOUD,
+				 "RXM: SC= 0x%x (Cache[%u] updated)\n",
+				 u2SequenceControl, u4SeqCtrlCacheIdx);
 		} else {
 			/* A duplicate. */
 			if (prSwRfb->prStaRec->
@@ -1046,7 +1114,7 @@ u_int8_t nicRxIsDuplicateFrame(IN OUT struct SW_RFB
 					u4SeqCtrlCacheIdx] = FALSE;
 			} else {
 				fgIsDuplicate = TRUE;
-				DBGLOG(RX, LOUD,
+				DBGTRACE(RX, LOUD,
 					"RXM: SC= 0x%x (Cache[%u] duplicate)\n",
 				  u2SequenceControl, u4SeqCtrlCacheIdx);
 			}
@@ -1061,8 +1129,8 @@ u_int8_t nicRxIsDuplicateFrame(IN OUT struct SW_RFB
 		prSwRfb->prStaRec->afgIsIgnoreAmsduDuplicate[u4SeqCtrlCacheIdx]
 			= FALSE;
 
-		DBGLOG(RX, LOUD, "RXM: SC= 0x%x (Cache[%u] updated)\n",
-		       u2SequenceControl, u4SeqCtrlCacheIdx);
+		DBGTRACE(RX, LOUD, "RXM: SC= 0x%x (Cache[%u] updated)\n",
+			 u2SequenceControl, u4SeqCtrlCacheIdx);
 	}
 
 	return fgIsDuplicate;
@@ -1212,6 +1280,11 @@ void nicRxProcessPktWithoutReorder(IN struct ADAPTER
 	}
 #endif
 
+	/* Leave the packet refill to the end of an open return batch */
+	if (!prSwRfb->pvPacket &&
+	    nicRxDeferReturnRFB(prAdapter, prSwRfb, TRUE))
+		return;
+
 	/* Return RFB */
 	if (nicRxSetupRFB(prAdapter, prSwRfb)) {
 		DBGLOG(RX, WARN,
@@ -1561,8 +1634,8 @@ void nicRxProcessDataPacket(IN struct ADAPTER *prAdapter,
 
 	DBGLOG(RSN, TRACE, "StatusFlag:0x%x\n", prRxStatus->u2StatusFlag);
 
-	if (prRxDescOps->nic_rxd_sanity_check)
-		fgDrop = prRxDescOps->nic_rxd_sanity_check(
+	if (RX_DESC_OPS_EXIST(prRxDescOps, sanity_check))
+		fgDrop = RX_DESC_OPS_FN(prRxDescOps, sanity_check)(
 			prAdapter, prSwRfb);
 	else {
 		DBGLOG(RX, ERROR,
@@ -1710,11 +1783,13 @@ void nicRxProcessEventPacket(IN struct ADAPTER *prAdapter,
 	struct mt66xx_chip_info *prChipInfo;
 	struct CMD_INFO *prCmdInfo;
 	struct WIFI_EVENT *prEvent;
-	uint32_t u4Idx, u4Size;
+	PROCESS_RX_EVENT_FUNCTION pfnHandler;
+	uint64_t u8StartTime;
 
 	ASSERT(prAdapter);
 	ASSERT(prSwRfb);
 	prChipInfo = prAdapter->chip_info;
+	u8StartTime = sched_clock();
 
 	prEvent = (struct WIFI_EVENT *)
 			(prSwRfb->pucRecvBuff + prChipInfo->rxd_size);
@@ -1727,19 +1802,13 @@ void nicRxProcessEventPacket(IN struct ADAPTER *prAdapter,
 	}
 
 	/* Event handler table */
-	u4Size = sizeof(arEventTable) / sizeof(struct
-					       RX_EVENT_HANDLER);
-
-	for (u4Idx = 0; u4Idx < u4Size; u4Idx++) {
-		if (prEvent->ucEID == arEventTable[u4Idx].eEID) {
-			arEventTable[u4Idx].pfnHandler(prAdapter, prEvent);
-
-			break;
-		}
-	}
-
-	/* Event cannot be found in event handler table, use default action */
-	if (u4Idx >= u4Size) {
+	pfnHandler = apfnEventTable[prEvent->ucEID];
+	if (pfnHandler) {
+		pfnHandler(prAdapter, prEvent);
+	} else {
+		/* Event cannot be found in event handler table,
+		 * use default action
+		 */
 		prCmdInfo = nicGetPendingCmdInfo(prAdapter,
 						 prEvent->ucSeqNum);
 
@@ -1765,6 +1834,9 @@ void nicRxProcessEventPacket(IN struct ADAPTER *prAdapter,
 		}
 	}
 
+	nicRxUpdateEventStat(&prAdapter->rRxCtrl.arEventStat[prEvent->ucEID],
+		u8StartTime);
+
 	/* Reset Chip NoAck flag */
 	if (prAdapter->fgIsChipNoAck) {
 		DBGLOG(RX, WARN,
@@ -3358,8 +3430,9 @@ static void nicRxCheckWakeupReason(struct ADAPTER *prAdapter,
 	struct RX_DESC_OPS_T *prRxDescOps;
 
 	prRxDescOps = prAdapter->chip_info->prRxDescOps;
-	if (prRxDescOps->nic_rxd_check_wakeup_reason)
-		prRxDescOps->nic_rxd_check_wakeup_reason(prAdapter, prSwRfb);
+	if (RX_DESC_OPS_EXIST(prRxDescOps, check_wakeup_reason))
+		RX_DESC_OPS_FN(prRxDescOps, check_wakeup_reason)(
+			prAdapter, prSwRfb);
 	else
 		DBGLOG(RX, ERROR,
 			"%s:: no nic_rxd_check_wakeup_reason??\n",
@@ -3447,7 +3520,7 @@ void nicRxProcessPacketType(
 	prChipInfo = prAdapter->chip_info;
 	switch (prSwRfb->ucPacketType) {
 	case RX_PKT_TYPE_RX_DATA:
-		if (HAL_IS_RX_DIRECT(prAdapter)) {
+		if (RX_DATA_IS_CONCURRENT(prAdapter)) {
 			spin_lock_bh(&prGlueInfo->rSpinLock[
 				SPIN_LOCK_RX_DIRECT]);
 			nicRxProcessDataPacket(
@@ -3498,7 +3571,7 @@ void nicRxProcessPacketType(
 				get_HdrTrans,
 				prSwRfb->prRxStatus);
 			if ((prSwRfb->ucOFLD) || (prSwRfb->fgHdrTran)) {
-				if (HAL_IS_RX_DIRECT(prAdapter)) {
+				if (RX_DATA_IS_CONCURRENT(prAdapter)) {
 					spin_lock_bh(&prGlueInfo->rSpinLock[
 						SPIN_LOCK_RX_DIRECT]);
 					nicRxProcessDataPacket(
@@ -3581,14 +3654,66 @@ void nicRxProcessPacketType(
 
 /*----------------------------------------------------------------------------*/
 /*!
- * @brief nicProcessRFBs is used to process RFBs in the rReceivedRFBList queue.
+ * @brief Check if a RFB goes through nicRxProcessDataPacket(), following
+ *        the same decision as nicRxProcessPacketType().
  *
  * @param prAdapter Pointer to the Adapter structure.
+ * @param prSwRfb   Pointer to the RFB.
+ *
+ * @retval TRUE  Data RFB, including OFLD and header translated frames
+ * @retval FALSE Event, management or report RFB
+ */
+/*----------------------------------------------------------------------------*/
+u_int8_t nicRxIsDataRFB(IN struct ADAPTER *prAdapter,
+	IN struct SW_RFB *prSwRfb)
+{
+	struct mt66xx_chip_info *prChipInfo = prAdapter->chip_info;
+	uint8_t ucOFLD, ucHdrTran;
+
+	if (prSwRfb->ucPacketType == RX_PKT_TYPE_RX_DATA)
+		return TRUE;
+
+	if (prSwRfb->ucPacketType != RX_PKT_TYPE_SW_DEFINED ||
+	    (NIC_RX_GET_U2_SW_PKT_TYPE(prSwRfb->prRxStatus) &
+	     prChipInfo->u2RxSwPktBitMap) != prChipInfo->u2RxSwPktFrame)
+		return FALSE;
+
+	RX_STATUS_GET(prChipInfo->prRxDescOps, ucOFLD, get_ofld,
+		prSwRfb->prRxStatus);
+	RX_STATUS_GET(prChipInfo->prRxDescOps, ucHdrTran, get_HdrTrans,
+		prSwRfb->prRxStatus);
+
+	return ucOFLD || ucHdrTran;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Queue a received RFB for processing. Data RFBs go to rx_thread
+ *        when it owns the data path, everything else stays on main_thread.
+ *        The caller holds SPIN_LOCK_RX_QUE.
+ *
+ * @param prAdapter Pointer to the Adapter structure.
+ * @param prSwRfb   Pointer to the RFB.
  *
  * @return (none)
  */
 /*----------------------------------------------------------------------------*/
-void nicRxProcessRFBs(IN struct ADAPTER *prAdapter)
+void nicRxEnqueueReceivedRFB(IN struct ADAPTER *prAdapter,
+	IN struct SW_RFB *prSwRfb)
+{
+	struct RX_CTRL *prRxCtrl = &prAdapter->rRxCtrl;
+
+	if (prRxCtrl->fgRxDataThread && nicRxIsDataRFB(prAdapter, prSwRfb)) {
+		QUEUE_INSERT_TAIL(&prRxCtrl->rReceivedDataRfbList,
+			&prSwRfb->rQueEntry);
+	} else {
+		QUEUE_INSERT_TAIL(&prRxCtrl->rReceivedRfbList,
+			&prSwRfb->rQueEntry);
+	}
+}
+
+static void nicRxProcessRfbList(IN struct ADAPTER *prAdapter,
+	IN struct QUE *prRfbList, IN u_int8_t fgDataList)
 {
 	struct RX_CTRL *prRxCtrl;
 	struct SW_RFB *prSwRfb = (struct SW_RFB *) NULL;
@@ -3598,22 +3723,23 @@ void nicRxProcessRFBs(IN struct ADAPTER *prAdapter)
 
 	KAL_SPIN_LOCK_DECLARATION();
 
-	DEBUGFUNC("nicRxProcessRFBs");
-
 	ASSERT(prAdapter);
 
 	prRxCtrl = &prAdapter->rRxCtrl;
 	ASSERT(prRxCtrl);
 
-	prRxCtrl->ucNumIndPacket = 0;
-	prRxCtrl->ucNumRetainedPacket = 0;
+	/* The indication counters belong to whoever processes data RFBs */
+	if (fgDataList) {
+		prRxCtrl->ucNumIndPacket = 0;
+		prRxCtrl->ucNumRetainedPacket = 0;
+	}
 	u4RxLoopCount = prAdapter->rWifiVar.u4TxRxLoopCount;
 	u4Tick = kalGetTimeTick();
 
 	QUEUE_INITIALIZE(prTempRfbList);
 
 	while (u4RxLoopCount--) {
-		while (QUEUE_IS_NOT_EMPTY(&prRxCtrl->rReceivedRfbList)) {
+		while (QUEUE_IS_NOT_EMPTY(prRfbList)) {
 
 			/* check process RFB timeout */
 			if ((kalGetTimeTick() - u4Tick) > RX_PROCESS_TIMEOUT) {
@@ -3622,10 +3748,10 @@ void nicRxProcessRFBs(IN struct ADAPTER *prAdapter)
 			}
 
 			KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
-			QUEUE_MOVE_ALL(prTempRfbList,
-				&prRxCtrl->rReceivedRfbList);
+			QUEUE_MOVE_ALL(prTempRfbList, prRfbList);
 			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 
+			nicRxBeginReturnBatch(prAdapter);
 			while (QUEUE_IS_NOT_EMPTY(prTempRfbList)) {
 				QUEUE_REMOVE_HEAD(prTempRfbList,
 					prSwRfb, struct SW_RFB *);
@@ -3643,8 +3769,9 @@ void nicRxProcessRFBs(IN struct ADAPTER *prAdapter)
 				 */
 				nicRxProcessPacketType(prAdapter, prSwRfb);
 			}
+			nicRxEndReturnBatch(prAdapter);
 
-			if (prRxCtrl->ucNumIndPacket > 0) {
+			if (fgDataList && prRxCtrl->ucNumIndPacket > 0) {
 				RX_ADD_CNT(prRxCtrl, RX_DATA_INDICATION_COUNT,
 					   prRxCtrl->ucNumIndPacket);
 				RX_ADD_CNT(prRxCtrl, RX_DATA_RETAINED_COUNT,
@@ -3667,8 +3794,47 @@ void nicRxProcessRFBs(IN struct ADAPTER *prAdapter)
 			}
 		}
 	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief nicProcessRFBs is used to process RFBs in the rReceivedRFBList queue.
+ *
+ * @param prAdapter Pointer to the Adapter structure.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicRxProcessRFBs(IN struct ADAPTER *prAdapter)
+{
+	DEBUGFUNC("nicRxProcessRFBs");
+
+	ASSERT(prAdapter);
+
+	nicRxProcessRfbList(prAdapter, &prAdapter->rRxCtrl.rReceivedRfbList,
+		!prAdapter->rRxCtrl.fgRxDataThread);
 }				/* end of nicRxProcessRFBs() */
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief nicRxProcessDataRFBs is used by rx_thread to process RFBs in the
+ *        rReceivedDataRfbList queue.
+ *
+ * @param prAdapter Pointer to the Adapter structure.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicRxProcessDataRFBs(IN struct ADAPTER *prAdapter)
+{
+	DEBUGFUNC("nicRxProcessDataRFBs");
+
+	ASSERT(prAdapter);
+
+	nicRxProcessRfbList(prAdapter,
+		&prAdapter->rRxCtrl.rReceivedDataRfbList, TRUE);
+}				/* end of nicRxProcessDataRFBs() */
+
 /*----------------------------------------------------------------------------*/
 /*!
  * @brief Setup a RFB and allocate the os packet to the RFB
@@ -3691,8 +3857,14 @@ uint32_t nicRxSetupRFB(IN struct ADAPTER *prAdapter,
 
 	if (!prSwRfb->pvPacket) {
 		kalMemZero(prSwRfb, sizeof(struct SW_RFB));
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+		pvPacket = kalDevAllocRxPacket(prAdapter->prGlueInfo,
+					       CFG_RX_MAX_MPDU_SIZE,
+					       &pucRecvBuff);
+#else
 		pvPacket = kalPacketAlloc(prAdapter->prGlueInfo,
 					  CFG_RX_MAX_MPDU_SIZE, &pucRecvBuff);
+#endif
 		if (pvPacket == NULL)
 			return WLAN_STATUS_RESOURCES;
 
@@ -3737,6 +3909,9 @@ void nicRxReturnRFB(IN struct ADAPTER *prAdapter,
 
 	ASSERT(prQueEntry);
 
+	if (nicRxDeferReturnRFB(prAdapter, prSwRfb, FALSE))
+		return;
+
 	/* The processing on this RFB is done,
 	 * so put it back on the tail of our list
 	 */
@@ -3762,6 +3937,261 @@ void nicRxReturnRFB(IN struct ADAPTER *prAdapter,
 		kalSetIntEvent(prAdapter->prGlueInfo);
 }				/* end of nicRxReturnRFB() */
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Setup a list of RFBs, stop at the first RFB which can not get an os
+ *        packet. The list keeps all RFBs, set up or not.
+ *
+ * @param prAdapter      Pointer to the Adapter structure.
+ * @param prRfbList      List of RFBs
+ *
+ * @retval WLAN_STATUS_SUCCESS
+ * @retval WLAN_STATUS_RESOURCES
+ */
+/*----------------------------------------------------------------------------*/
+uint32_t nicRxSetupRFBList(IN struct ADAPTER *prAdapter,
+			   IN struct QUE *prRfbList)
+{
+	struct SW_RFB *prSwRfb;
+	struct QUE rTempList;
+	uint32_t u4Status = WLAN_STATUS_SUCCESS;
+
+	ASSERT(prAdapter);
+	ASSERT(prRfbList);
+
+	/* nicRxSetupRFB() may clear rQueEntry, so relink every RFB */
+	QUEUE_MOVE_ALL(&rTempList, prRfbList);
+	while (QUEUE_IS_NOT_EMPTY(&rTempList)) {
+		QUEUE_REMOVE_HEAD(&rTempList, prSwRfb, struct SW_RFB *);
+		if (!prSwRfb)
+			break;
+		if (u4Status == WLAN_STATUS_SUCCESS)
+			u4Status = nicRxSetupRFB(prAdapter, prSwRfb);
+		QUEUE_INSERT_TAIL(prRfbList, &prSwRfb->rQueEntry);
+	}
+
+	return u4Status;
+}				/* end of nicRxSetupRFBList() */
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Put a list of RFBs back onto the "RFB with Buffer" or "RFB without
+ *        buffer" list with a single lock acquisition, and raise at most one
+ *        interrupt event for the whole list.
+ *
+ * @param prAdapter      Pointer to the Adapter structure.
+ * @param prRfbList      List of RFBs, empty on return
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicRxReturnRFBList(IN struct ADAPTER *prAdapter,
+			IN struct QUE *prRfbList)
+{
+	struct RX_CTRL *prRxCtrl;
+	struct SW_RFB *prSwRfb;
+	struct QUE rFreeList, rIndicatedList;
+	u_int8_t fgSetIntEvent = FALSE;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	ASSERT(prAdapter);
+	ASSERT(prRfbList);
+	prRxCtrl = &prAdapter->rRxCtrl;
+
+	QUEUE_INITIALIZE(&rFreeList);
+	QUEUE_INITIALIZE(&rIndicatedList);
+	while (QUEUE_IS_NOT_EMPTY(prRfbList)) {
+		QUEUE_REMOVE_HEAD(prRfbList, prSwRfb, struct SW_RFB *);
+		if (!prSwRfb)
+			break;
+		if (prSwRfb->pvPacket) {
+			QUEUE_INSERT_TAIL(&rFreeList, &prSwRfb->rQueEntry);
+		} else {
+			QUEUE_INSERT_TAIL(&rIndicatedList,
+					  &prSwRfb->rQueEntry);
+		}
+	}
+
+	if (QUEUE_IS_EMPTY(&rFreeList) && QUEUE_IS_EMPTY(&rIndicatedList))
+		return;
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+	if (QUEUE_IS_NOT_EMPTY(&rFreeList) && prAdapter->u4NoMoreRfb != 0)
+		fgSetIntEvent = TRUE;
+	QUEUE_CONCATENATE_QUEUES(&prRxCtrl->rFreeSwRfbList, &rFreeList);
+	QUEUE_CONCATENATE_QUEUES(&prRxCtrl->rIndicatedRfbList,
+				 &rIndicatedList);
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+
+	if (fgSetIntEvent)
+		DBGLOG(RX, INFO, "Free rfb list and set IntEvent\n");
+
+	/* Trigger Rx if there are free SwRfb */
+	if (fgSetIntEvent || (halIsPendingRx(prAdapter)
+	    && (prRxCtrl->rFreeSwRfbList.u4NumElem > 0)))
+		kalSetIntEvent(prAdapter->prGlueInfo);
+}				/* end of nicRxReturnRFBList() */
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Get the return batch of the current execution context.
+ *
+ * @param prAdapter      Pointer to the Adapter structure.
+ * @param pu4Owner       Owner id of the current context
+ *
+ * @return the batch, NULL if the context can not hold one
+ */
+/*----------------------------------------------------------------------------*/
+static struct RX_RETURN_BATCH *nicRxGetReturnBatch(
+	IN struct ADAPTER *prAdapter, OUT uint32_t *pu4Owner)
+{
+	struct RX_CTRL *prRxCtrl = &prAdapter->rRxCtrl;
+
+	if (KAL_IS_SOFTIRQ_CONTEXT()) {
+		*pu4Owner = KAL_GET_CURRENT_CPU_ID() + 1;
+		return &prRxCtrl->arReturnBatch[RX_RETURN_BATCH_SOFTIRQ];
+	}
+
+	if (KAL_IS_INTERRUPT_CONTEXT())
+		return NULL;
+
+	*pu4Owner = (uint32_t) KAL_GET_CURRENT_THREAD_ID();
+	return &prRxCtrl->arReturnBatch[RX_RETURN_BATCH_TASK];
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Park a RFB in the return batch opened by the current context.
+ *
+ * @param prAdapter      Pointer to the Adapter structure.
+ * @param prSwRfb        Pointer to the RFB
+ * @param fgRefill       The RFB needs a new os packet before being returned
+ *
+ * @retval TRUE          The RFB is parked, nicRxEndReturnBatch() returns it
+ * @retval FALSE         No batch is open, the caller returns the RFB
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t nicRxDeferReturnRFB(IN struct ADAPTER *prAdapter,
+				    IN struct SW_RFB *prSwRfb,
+				    IN u_int8_t fgRefill)
+{
+	struct RX_RETURN_BATCH *prBatch;
+	uint32_t u4Owner = 0;
+
+	prBatch = nicRxGetReturnBatch(prAdapter, &u4Owner);
+	if (!prBatch || prBatch->u4Depth == 0 || prBatch->u4Owner != u4Owner)
+		return FALSE;
+
+	if (prBatch->rRfbList.u4NumElem + prBatch->rRefillList.u4NumElem >=
+	    RX_RETURN_BATCH_MAX_NUM)
+		return FALSE;
+
+	if (fgRefill) {
+		QUEUE_INSERT_TAIL(&prBatch->rRefillList, &prSwRfb->rQueEntry);
+	} else {
+		QUEUE_INSERT_TAIL(&prBatch->rRfbList, &prSwRfb->rQueEntry);
+	}
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Open a RFB return batch for the current context. Until the matching
+ *        nicRxEndReturnBatch(), RFBs returned by this context are parked and
+ *        then handed back in one critical section. Other contexts are not
+ *        affected. Only the RX thread and the NAPI poll open a batch.
+ *
+ * @param prAdapter      Pointer to the Adapter structure.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicRxBeginReturnBatch(IN struct ADAPTER *prAdapter)
+{
+	struct RX_RETURN_BATCH *prBatch;
+	uint32_t u4Owner = 0;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	prBatch = nicRxGetReturnBatch(prAdapter, &u4Owner);
+	if (!prBatch || u4Owner == 0)
+		return;
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+	if (prBatch->u4Depth == 0) {
+		prBatch->u4Owner = u4Owner;
+		QUEUE_INITIALIZE(&prBatch->rRfbList);
+		QUEUE_INITIALIZE(&prBatch->rRefillList);
+	}
+	if (prBatch->u4Owner == u4Owner)
+		prBatch->u4Depth++;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Close the RFB return batch of the current context. Parked RFBs get
+ *        their os packets in bulk and are returned with nicRxReturnRFBList().
+ *
+ * @param prAdapter      Pointer to the Adapter structure.
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicRxEndReturnBatch(IN struct ADAPTER *prAdapter)
+{
+	struct RX_RETURN_BATCH *prBatch;
+	struct QUE rRfbList, rRefillList;
+	uint32_t u4Owner = 0;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	prBatch = nicRxGetReturnBatch(prAdapter, &u4Owner);
+	if (!prBatch || prBatch->u4Depth == 0 || prBatch->u4Owner != u4Owner)
+		return;
+
+	if (prBatch->u4Depth > 1) {
+		prBatch->u4Depth--;
+		return;
+	}
+
+	QUEUE_MOVE_ALL(&rRfbList, &prBatch->rRfbList);
+	QUEUE_MOVE_ALL(&rRefillList, &prBatch->rRefillList);
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+	prBatch->u4Owner = 0;
+	prBatch->u4Depth = 0;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+
+	if (nicRxSetupRFBList(prAdapter, &rRefillList) !=
+	    WLAN_STATUS_SUCCESS) {
+		DBGLOG(RX, WARN,
+		       "Cannot allocate packet buffer for SwRfb!\n");
+		if (!timerPendingTimer(
+			    &prAdapter->rPacketDelaySetupTimer)) {
+			DBGLOG(RX, WARN,
+				"Start ReturnIndicatedRfb Timer (%u)\n",
+			  RX_RETURN_INDICATED_RFB_TIMEOUT_SEC);
+			cnmTimerStartTimer(prAdapter,
+				&prAdapter->rPacketDelaySetupTimer,
+				SEC_TO_MSEC(
+					RX_RETURN_INDICATED_RFB_TIMEOUT_SEC));
+		}
+	}
+
+	QUEUE_CONCATENATE_QUEUES(&rRfbList, &rRefillList);
+	if (QUEUE_IS_EMPTY(&rRfbList))
+		return;
+
+	nicRxReturnRFBList(prAdapter, &rRfbList);
+#if (CFG_SUPPORT_RETURN_TASK == 1)
+	/* The tasklet may have run before the RFBs reach rIndicatedRfbList */
+	tasklet_schedule(&prAdapter->prGlueInfo->rRxRfbRetTask);
+#endif
+}
+
 /*----------------------------------------------------------------------------*/
 /*!
  * @brief Process rx interrupt. When the rx
@@ -256,6 +256,18 @@ void nicTxInitialize(IN struct ADAPTER *prAdapter)
 
 	prTxCtrl->u4WrIdx = 0;
 
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+	wlanTxLatReset(prAdapter);
+#endif
+#if CFG_SUPPORT_MULTITHREAD && !CFG_FIX_2_TX_PORT
+	DATA_STRUCT_INSPECTING_ASSERT(
+		TX_PORT_NUM <= SPIN_LOCK_TX_PORT_QUE_NUM);
+#if CFG_TX_PORT_QUE_LOCK_STAT
+	kalMemZero(prAdapter->arTxPQueueStat,
+		   sizeof(prAdapter->arTxPQueueStat));
+#endif
+#endif
+
 	/* allocate MSDU_INFO_T and link it into rFreeMsduInfoList */
 	QUEUE_INITIALIZE(&prTxCtrl->rFreeMsduInfoList);
 
@@ -626,8 +638,7 @@ uint32_t nicTxAcquireResource(IN struct ADAPTER *prAdapter,
 #if (CFG_SUPPORT_TRACE_TC4 == 1)
 			wlanDumpTcResAndTxedCmd(NULL, 0);
 #endif
-			cmdBufDumpCmdQueue(&prAdapter->rPendingCmdQueue,
-					   "waiting response CMD queue");
+			nicDumpPendingCmdInfo(prAdapter);
 		}
 	}
 
@@ -1441,11 +1452,14 @@ uint32_t nicTxMsduInfoListMthread(IN struct ADAPTER
 	}
 
 	if (fgSetTx2Hif) {
-		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
-		for (i = 0; i < TX_PORT_NUM; i++)
+		for (i = 0; i < TX_PORT_NUM; i++) {
+			if (QUEUE_IS_EMPTY(prDataPort[i]))
+				continue;
+			TX_PORT_QUE_LOCK(prAdapter, i);
 			QUEUE_CONCATENATE_QUEUES((&(prAdapter->rTxPQueue[i])),
 						 (prDataPort[i]));
-		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
+			TX_PORT_QUE_UNLOCK(prAdapter, i);
+		}
 		kalSetTxEvent2Hif(prAdapter->prGlueInfo);
 	}
 
@@ -1565,22 +1579,19 @@ void nicTxMsduQueueByPrio(struct ADAPTER *prAdapter)
 
 	for (i = TC_NUM; i >= 0; i--) {
 		while (QUEUE_IS_NOT_EMPTY(&(prAdapter->rTxPQueue[i]))) {
-			KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
+			TX_PORT_QUE_LOCK(prAdapter, i);
 			QUEUE_MOVE_ALL(prDataPort[i],
 				&(prAdapter->rTxPQueue[i]));
-			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
+			TX_PORT_QUE_UNLOCK(prAdapter, i);
 
 			nicTxMsduQueue(prAdapter, 0, prDataPort[i]);
 
 			if (QUEUE_IS_NOT_EMPTY(prDataPort[i])) {
-				KAL_ACQUIRE_SPIN_LOCK(
-					prAdapter,
-					SPIN_LOCK_TX_PORT_QUE);
+				TX_PORT_QUE_LOCK(prAdapter, i);
 				QUEUE_CONCATENATE_QUEUES_HEAD(
 					&(prAdapter->rTxPQueue[i]),
 					prDataPort[i]);
-				KAL_RELEASE_SPIN_LOCK(prAdapter,
-						      SPIN_LOCK_TX_PORT_QUE);
+				TX_PORT_QUE_UNLOCK(prAdapter, i);
 
 				break;
 			}
@@ -1592,6 +1603,10 @@ void nicTxMsduQueueByPrio(struct ADAPTER *prAdapter)
 /*!
  * @brief In this function, we'll write MSDU into HIF by Round-Robin
  *
+ * Each round moves up to TX_PORT_QUE_RR_QUOTA MSDUs from every TC queue,
+ * holding only the lock of that queue. The MSDUs queued when this
+ * function starts bound the number of rounds, so producers that keep
+ * adding traffic cannot starve the HIF write below.
  *
  * @param prAdapter              Pointer to the Adapter structure.
  *
@@ -1602,6 +1617,8 @@ void nicTxMsduQueueByRR(struct ADAPTER *prAdapter)
 	struct QUE qDataPort0, qDataPort1, arTempQue[TX_PORT_NUM];
 	struct QUE *prDataPort0, *prDataPort1, *prDataPort, *prTxQue;
 	struct MSDU_INFO *prMsduInfo;
+	uint32_t au4Budget[TX_PORT_NUM];
+	uint32_t u4Quota;
 	bool fgIsAllQueneEmpty = false;
 	int32_t i;
 
@@ -1612,22 +1629,32 @@ void nicTxMsduQueueByRR(struct ADAPTER *prAdapter)
 	QUEUE_INITIALIZE(prDataPort0);
 	QUEUE_INITIALIZE(prDataPort1);
 
-	for (i = 0; i < TX_PORT_NUM; i++)
+	for (i = 0; i < TX_PORT_NUM; i++) {
 		QUEUE_INITIALIZE(&arTempQue[i]);
+		au4Budget[i] = prAdapter->rTxPQueue[i].u4NumElem;
+	}
 
-	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 	/* Dequeue each TCQ to dataQ by round-robin  */
 	/* Check each TCQ is empty or not */
 	while (!fgIsAllQueneEmpty) {
 		fgIsAllQueneEmpty = true;
 		for (i = TC_NUM; i >= 0; i--) {
 			prTxQue = &(prAdapter->rTxPQueue[i]);
-			if (QUEUE_IS_NOT_EMPTY(prTxQue)) {
+			if (au4Budget[i] == 0)
+				continue;
+
+			TX_PORT_QUE_LOCK(prAdapter, i);
+			for (u4Quota = TX_PORT_QUE_RR_QUOTA;
+			     u4Quota && au4Budget[i]; u4Quota--) {
 				QUEUE_REMOVE_HEAD(
 					prTxQue, prMsduInfo,
 					struct MSDU_INFO *);
-				if (prMsduInfo == NULL)
+				if (prMsduInfo == NULL) {
+					/* drained by someone else */
+					au4Budget[i] = 0;
 					break;
+				}
+				au4Budget[i]--;
 				if (halTxRingDataSelect(prAdapter, prMsduInfo))
 					prDataPort = prDataPort1;
 				else
@@ -1636,40 +1663,63 @@ void nicTxMsduQueueByRR(struct ADAPTER *prAdapter)
 				QUEUE_INSERT_TAIL(
 					prDataPort,
 					(struct QUE_ENTRY *) prMsduInfo);
-				fgIsAllQueneEmpty = false;
 			}
+			TX_PORT_QUE_UNLOCK(prAdapter, i);
+
+			if (au4Budget[i])
+				fgIsAllQueneEmpty = false;
 		}
 	}
-	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 
 	nicTxMsduQueue(prAdapter, 0, prDataPort0);
 	nicTxMsduQueue(prAdapter, 0, prDataPort1);
 
-	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 	/* Enque from dataQ to TCQ if TX don't finish */
-	/* Need to reverse dataQ by TC first */
+	/* Need to split dataQ by TC first, keeping the order */
 	while (QUEUE_IS_NOT_EMPTY(prDataPort0)) {
 		QUEUE_REMOVE_HEAD(prDataPort0, prMsduInfo, struct MSDU_INFO *);
-		QUEUE_INSERT_HEAD(&arTempQue[prMsduInfo->ucTC],
+		QUEUE_INSERT_TAIL(&arTempQue[prMsduInfo->ucTC],
 				  (struct QUE_ENTRY *) prMsduInfo);
 	}
 	while (QUEUE_IS_NOT_EMPTY(prDataPort1)) {
 		QUEUE_REMOVE_HEAD(prDataPort1, prMsduInfo, struct MSDU_INFO *);
-		QUEUE_INSERT_HEAD(&arTempQue[prMsduInfo->ucTC],
+		QUEUE_INSERT_TAIL(&arTempQue[prMsduInfo->ucTC],
 				  (struct QUE_ENTRY *) prMsduInfo);
 	}
 
 	for (i = 0; i < TX_PORT_NUM; i++) {
-		while (QUEUE_IS_NOT_EMPTY(&arTempQue[i])) {
-			QUEUE_REMOVE_HEAD(&arTempQue[i], prMsduInfo,
-					  struct MSDU_INFO *);
-			QUEUE_INSERT_HEAD(&prAdapter->rTxPQueue[i],
-					  (struct QUE_ENTRY *) prMsduInfo);
-		}
+		if (QUEUE_IS_EMPTY(&arTempQue[i]))
+			continue;
+		TX_PORT_QUE_LOCK(prAdapter, i);
+		QUEUE_CONCATENATE_QUEUES_HEAD(&prAdapter->rTxPQueue[i],
+					      &arTempQue[i]);
+		TX_PORT_QUE_UNLOCK(prAdapter, i);
 	}
-	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 }
 
+#if CFG_TX_PORT_QUE_LOCK_STAT
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Account the hold time of a TX port queue lock, called with the
+ *        lock held
+ *
+ * @param prStat         Statistics of the TX port queue
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void nicTxUpdatePortQueStat(IN struct TX_PORT_QUE_STAT *prStat)
+{
+	uint64_t u8Time = sched_clock() - prStat->u8LockTime;
+
+	prStat->u4HoldCnt++;
+	prStat->u8TotalHoldTime += u8Time;
+	if (u8Time > prStat->u4MaxHoldTime)
+		prStat->u4MaxHoldTime = u8Time > 0xFFFFFFFF ?
+			0xFFFFFFFF : (uint32_t)u8Time;
+}
+#endif
+
 uint32_t nicTxGetMsduPendingCnt(IN struct ADAPTER
 				*prAdapter)
 {
@@ -2321,6 +2371,9 @@ uint32_t nicTxMsduQueue(IN struct ADAPTER *prAdapter,
 {
 	struct MSDU_INFO *prMsduInfo;
 	struct TX_CTRL *prTxCtrl;
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	uint32_t u4BurstSlot;
+#endif
 
 	ASSERT(prAdapter);
 	ASSERT(prQue);
@@ -2332,6 +2385,9 @@ uint32_t nicTxMsduQueue(IN struct ADAPTER *prAdapter,
 	prTxCtrl->u4TotalTxPacketNum += prQue->u4NumElem;
 #endif
 
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	u4BurstSlot = halWpdmaBeginTxBurst(prAdapter->prGlueInfo);
+#endif
 	while (QUEUE_IS_NOT_EMPTY(prQue)) {
 		QUEUE_REMOVE_HEAD(prQue, prMsduInfo, struct MSDU_INFO *);
 
@@ -2393,6 +2449,9 @@ uint32_t nicTxMsduQueue(IN struct ADAPTER *prAdapter,
 	}
 
 	HAL_KICK_TX_DATA(prAdapter);
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	halWpdmaEndTxBurst(prAdapter->prGlueInfo, u4BurstSlot);
+#endif
 
 	return WLAN_STATUS_SUCCESS;
 }
@@ -2754,6 +2813,8 @@ void nicTxReturnMsduInfo(IN struct ADAPTER *prAdapter,
 	struct TX_CTRL *prTxCtrl;
 	struct MSDU_INFO *prMsduInfo = prMsduInfoListHead,
 				  *prNextMsduInfo;
+	void *apvFwdPacket[NIC_TX_FWD_RETURN_BATCH_NUM];
+	uint32_t u4FwdNum = 0;
 
 	KAL_SPIN_LOCK_DECLARATION();
 
@@ -2768,7 +2829,13 @@ void nicTxReturnMsduInfo(IN struct ADAPTER *prAdapter,
 
 		switch (prMsduInfo->eSrc) {
 		case TX_PACKET_FORWARDING:
-			wlanReturnPacket(prAdapter, prMsduInfo->prPacket);
+			/* Return forwarded RX packets in batches */
+			apvFwdPacket[u4FwdNum++] = prMsduInfo->prPacket;
+			if (u4FwdNum == NIC_TX_FWD_RETURN_BATCH_NUM) {
+				wlanReturnPacketBatch(prAdapter,
+					apvFwdPacket, u4FwdNum);
+				u4FwdNum = 0;
+			}
 			break;
 		case TX_PACKET_OS:
 		case TX_PACKET_OS_OID:
@@ -2789,6 +2856,8 @@ void nicTxReturnMsduInfo(IN struct ADAPTER *prAdapter,
 		prMsduInfo = prNextMsduInfo;
 	};
 
+	if (u4FwdNum)
+		wlanReturnPacketBatch(prAdapter, apvFwdPacket, u4FwdNum);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -5312,9 +5381,25 @@ uint32_t nicTxDirectStartXmit(struct sk_buff *prSkb,
 	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
 	struct MSDU_INFO *prMsduInfo;
 	uint32_t ret = WLAN_STATUS_SUCCESS;
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	uint32_t u4BurstSlot;
+#endif
 
 	spin_lock_bh(&prGlueInfo->rSpinLock[SPIN_LOCK_TX_DIRECT]);
 
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	/* Hold the skb while the stack has more to send, so that the whole
+	 * batch is written with one doorbell per ring. rTxDirectSkbTimer
+	 * flushes it if the rest never comes.
+	 */
+	if (prSkb && GLUE_TEST_PKT_FLAG(prSkb, ENUM_PKT_XMIT_MORE) &&
+	    skb_queue_len(&prAdapter->rTxDirectSkbQueue) + 1 <
+	    prAdapter->rWifiVar.u4TxKickBurstMax) {
+		skb_queue_tail(&prAdapter->rTxDirectSkbQueue, prSkb);
+		goto end;
+	}
+#endif
+
 	if (prSkb) {
 		prMsduInfo = cnmPktAlloc(prAdapter, 0);
 
@@ -5346,6 +5431,10 @@ uint32_t nicTxDirectStartXmit(struct sk_buff *prSkb,
 		}
 	}
 
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	wlanAcquirePowerControl(prAdapter);
+	u4BurstSlot = halWpdmaBeginTxBurst(prGlueInfo);
+#endif
 	while (1) {
 		nicTxDirectStartXmitMain(prSkb, prMsduInfo, prAdapter, 0xff,
 					 0xff, 0xff);
@@ -5361,6 +5450,10 @@ uint32_t nicTxDirectStartXmit(struct sk_buff *prSkb,
 			break;
 		}
 	}
+#if defined(_HIF_PCIE) || defined(_HIF_AXI)
+	halWpdmaEndTxBurst(prGlueInfo, u4BurstSlot);
+	wlanReleasePowerControl(prAdapter);
+#endif
 
 end:
 	if (skb_queue_len(&prAdapter->rTxDirectSkbQueue))
@@ -5747,8 +5840,8 @@ void nicTxHandleRoamingDone(struct ADAPTER *prAdapter,
 ** prepare code for that case to avoid scheduler corner case.
 */
 #if CFG_SUPPORT_MULTITHREAD
-	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 #if CFG_FIX_2_TX_PORT
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 	prMsduInfo = (struct MSDU_INFO *)QUEUE_GET_HEAD(&prAdapter->rTxP0Queue);
 	while (prMsduInfo) {
 		if (prMsduInfo->ucWlanIndex == ucOldWlanIndex)
@@ -5763,8 +5856,10 @@ void nicTxHandleRoamingDone(struct ADAPTER *prAdapter,
 		prMsduInfo = (struct MSDU_INFO *)QUEUE_GET_NEXT_ENTRY(
 			&prMsduInfo->rQueEntry);
 	}
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 #else
 	for (ucIndex = 0; ucIndex < TX_PORT_NUM; ucIndex++) {
+		TX_PORT_QUE_LOCK(prAdapter, ucIndex);
 		prMsduInfo = (struct MSDU_INFO *)QUEUE_GET_HEAD(
 			&prAdapter->rTxPQueue[ucIndex]);
 		while (prMsduInfo) {
@@ -5773,9 +5868,9 @@ void nicTxHandleRoamingDone(struct ADAPTER *prAdapter,
 			prMsduInfo = (struct MSDU_INFO *)QUEUE_GET_NEXT_ENTRY(
 				&prMsduInfo->rQueEntry);
 		}
+		TX_PORT_QUE_UNLOCK(prAdapter, ucIndex);
 	}
 #endif
-	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_TX_PORT_QUE);
 #endif
 }
 
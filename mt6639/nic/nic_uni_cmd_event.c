@@ -93,8 +93,8 @@ static PROCESS_LEGACY_TO_UNI_FUNCTION arUniExtCmdTable[EXT_CMD_ID_END] = {
 	[EXT_CMD_ID_GET_MAC_INFO] = nicUniCmdGetTsf,
 };
 
-static PROCESS_RX_UNI_EVENT_FUNCTION arUniEventTable[UNI_EVENT_ID_NUM] = {
-	[0 ... UNI_EVENT_ID_NUM - 1] = NULL,
+static PROCESS_RX_UNI_EVENT_FUNCTION arUniEventTable[RX_EVENT_ID_NUM] = {
+	[0 ... RX_EVENT_ID_NUM - 1] = NULL,
 	[UNI_EVENT_ID_SCAN_DONE] = nicUniEventScanDone,
 	[UNI_EVENT_ID_CNM] = nicUniEventChMngrHandleChEvent,
 	[UNI_EVENT_ID_MBMC] = nicUniEventMbmcHandleEvent,
@@ -228,14 +228,13 @@ wlanSendSetQueryCmdHelper(IN struct ADAPTER *prAdapter,
 	info.pvSetQueryBuffer = pvSetQueryBuffer;
 	info.u4SetQueryBufferLen = u4SetQueryBufferLen;
 	LINK_INITIALIZE(&info.rUniCmdList);
+	link = &info.rUniCmdList;
 
 	/* collect unified cmd info */
 	status = arUniCmdTable[ucCID](prAdapter, &info);
 	if (status != WLAN_STATUS_SUCCESS)
 		goto done;
 
-	link = &info.rUniCmdList;
-
 	LINK_FOR_EACH_ENTRY_SAFE(entry, next,
 		link, rLinkEntry, struct WIFI_UNI_CMD_ENTRY) {
 
@@ -2851,12 +2850,14 @@ void nicRxProcessUniEventPacket(IN struct ADAPTER *prAdapter,
 	struct mt66xx_chip_info *prChipInfo;
 	struct CMD_INFO *prCmdInfo;
 	struct WIFI_UNI_EVENT *prEvent;
+	uint64_t u8StartTime;
 
 	ASSERT(prAdapter);
 	ASSERT(prSwRfb);
 	prChipInfo = prAdapter->chip_info;
 	prEvent = (struct WIFI_UNI_EVENT *)
 			(prSwRfb->pucRecvBuff + prChipInfo->rxd_size);
+	u8StartTime = sched_clock();
 
 	if (IS_UNI_UNSOLICIT_EVENT(prEvent)) {
 		if (arUniEventTable[GET_UNI_EVENT_ID(prEvent)])
@@ -2888,6 +2889,10 @@ void nicRxProcessUniEventPacket(IN struct ADAPTER *prAdapter,
 		}
 	}
 
+	nicRxUpdateEventStat(
+		&prAdapter->rRxCtrl.arUniEventStat[GET_UNI_EVENT_ID(prEvent)],
+		u8StartTime);
+
 	/* Reset Chip NoAck flag */
 	if (prAdapter->fgIsChipNoAck) {
 		DBGLOG_LIMITED(RX, WARN,
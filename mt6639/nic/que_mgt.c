@@ -252,10 +252,14 @@ do { \
 } while (0)
 #endif
 
-#define RX_DIRECT_REORDER_LOCK(pad, dbg) \
+/* The lock reads RX_DATA_IS_CONCURRENT() once into locked, and the unlock
+ * only trusts locked, so a runtime change cannot unbalance a pair
+ */
+#define RX_DIRECT_REORDER_LOCK(pad, locked, dbg) \
 do { \
 	struct GLUE_INFO *_glue = pad->prGlueInfo; \
-	if (!HAL_IS_RX_DIRECT(pad) || !_glue) \
+	locked = (RX_DATA_IS_CONCURRENT(pad) && _glue) ? TRUE : FALSE; \
+	if (!locked) \
 		break; \
 	if (dbg) \
 		DBGLOG(QM, EVENT, "RX_DIRECT_REORDER_LOCK %d\n", __LINE__); \
@@ -265,10 +269,10 @@ do { \
 		spin_lock_bh(&_glue->rSpinLock[SPIN_LOCK_RX_DIRECT_REORDER]); \
 } while (0)
 
-#define RX_DIRECT_REORDER_UNLOCK(pad, dbg) \
+#define RX_DIRECT_REORDER_UNLOCK(pad, locked, dbg) \
 do { \
 	struct GLUE_INFO *_glue = pad->prGlueInfo; \
-	if (!HAL_IS_RX_DIRECT(pad) || !_glue) \
+	if (!locked) \
 		break; \
 	if (dbg) \
 		DBGLOG(QM, EVENT, "RX_DIRECT_REORDER_UNLOCK %u\n", __LINE__); \
@@ -334,6 +338,9 @@ void qmInit(IN struct ADAPTER *prAdapter,
 #endif
 #if CFG_WOW_SUPPORT
 		prQM->arRxBaTable[u4Idx].fgFirstSnToWinStart = FALSE;
+#endif
+#if QM_RX_REORDER_SLOT_INDEX
+		qmRxReorderSlotFree(prAdapter, &prQM->arRxBaTable[u4Idx]);
 #endif
 		cnmTimerInitTimer(prAdapter,
 			&(prQM->arRxBaTable[u4Idx].rReorderBubbleTimer),
@@ -848,12 +855,13 @@ struct SW_RFB *qmFlushRxQueues(IN struct ADAPTER *prAdapter)
 	struct SW_RFB *prSwRfbListHead;
 	struct SW_RFB *prSwRfbListTail;
 	struct QUE_MGT *prQM = &prAdapter->rQM;
+	u_int8_t fgReorderLocked;
 
 	prSwRfbListHead = prSwRfbListTail = NULL;
 
 	DBGLOG(QM, TRACE, "QM: Enter qmFlushRxQueues()\n");
 
-	RX_DIRECT_REORDER_LOCK(prAdapter, 0);
+	RX_DIRECT_REORDER_LOCK(prAdapter, fgReorderLocked, 0);
 	for (i = 0; i < CFG_NUM_OF_RX_BA_AGREEMENTS; i++) {
 		if (QUEUE_IS_NOT_EMPTY(&
 			(prQM->arRxBaTable[i].rReOrderQue))) {
@@ -884,6 +892,9 @@ struct SW_RFB *qmFlushRxQueues(IN struct ADAPTER *prAdapter)
 			}
 
 			QUEUE_INITIALIZE(&(prQM->arRxBaTable[i].rReOrderQue));
+#if QM_RX_REORDER_SLOT_INDEX
+			qmRxReorderSlotReset(&prQM->arRxBaTable[i]);
+#endif
 			if (QM_RX_GET_NEXT_SW_RFB(prSwRfbListTail)) {
 				DBGLOG(QM, ERROR,
 					"QM: non-null tail->next at arRxBaTable[%u]\n",
@@ -893,7 +904,7 @@ struct SW_RFB *qmFlushRxQueues(IN struct ADAPTER *prAdapter)
 			continue;
 		}
 	}
-	RX_DIRECT_REORDER_UNLOCK(prAdapter, 0);
+	RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
 
 	if (prSwRfbListTail) {
 		/* Terminate the MSDU_INFO list with a NULL pointer */
@@ -921,6 +932,7 @@ struct SW_RFB *qmFlushStaRxQueue(IN struct ADAPTER *prAdapter,
 	struct SW_RFB *prSwRfbListTail = NULL;
 	struct RX_BA_ENTRY *prReorderQueParm = NULL;
 	struct STA_RECORD *prStaRec = NULL;
+	u_int8_t fgReorderLocked;
 
 	DBGLOG(QM, TRACE, "QM: Enter qmFlushStaRxQueues(%u)\n", u4StaRecIdx);
 
@@ -942,7 +954,7 @@ struct SW_RFB *qmFlushStaRxQueue(IN struct ADAPTER *prAdapter,
 	 * prCurrSwRfb->eDst equals RX_PKT_DESTINATION_HOST
 	 */
 	if (prReorderQueParm) {
-		RX_DIRECT_REORDER_LOCK(prAdapter, 0);
+		RX_DIRECT_REORDER_LOCK(prAdapter, fgReorderLocked, 0);
 		if (QUEUE_IS_NOT_EMPTY(&(prReorderQueParm->rReOrderQue))) {
 
 			prSwRfbListHead = (struct SW_RFB *)
@@ -953,8 +965,11 @@ struct SW_RFB *qmFlushStaRxQueue(IN struct ADAPTER *prAdapter,
 					&(prReorderQueParm->rReOrderQue));
 
 			QUEUE_INITIALIZE(&(prReorderQueParm->rReOrderQue));
+#if QM_RX_REORDER_SLOT_INDEX
+			qmRxReorderSlotReset(prReorderQueParm);
+#endif
 		}
-		RX_DIRECT_REORDER_UNLOCK(prAdapter, 0);
+		RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
 	}
 
 	if (prSwRfbListTail) {
@@ -1410,8 +1425,6 @@ struct MSDU_INFO *qmEnqueueTxPackets(IN struct ADAPTER *prAdapter,
 void qmDetermineStaRecIndex(IN struct ADAPTER *prAdapter,
 	IN struct MSDU_INFO *prMsduInfo)
 {
-	uint32_t i;
-
 	struct STA_RECORD *prTempStaRec;
 	struct BSS_INFO *prBssInfo;
 
@@ -1444,10 +1457,10 @@ void qmDetermineStaRecIndex(IN struct ADAPTER *prAdapter,
 #if CFG_SUPPORT_TDLS
 
 			prTempStaRec =
-				cnmGetTdlsPeerByAddress(prAdapter,
+				cnmGetStaRecByAddress(prAdapter,
 					prBssInfo->ucBssIndex,
 					prMsduInfo->aucEthDestAddr);
-			if (IS_DLS_STA(prTempStaRec)
+			if (prTempStaRec && IS_DLS_STA(prTempStaRec)
 			    && prTempStaRec->ucStaState == STA_STATE_3) {
 				if (g_arTdlsLink[prTempStaRec->ucTdlsIndex]) {
 					prMsduInfo->ucStaRecIndex =
@@ -1490,32 +1503,17 @@ void qmDetermineStaRecIndex(IN struct ADAPTER *prAdapter,
 	/* 4 <3> Not BMCAST, No AP --> Compare DA
 	 * (i.e., to see whether this is a unicast frame to a client)
 	 */
-	for (i = 0; i < CFG_STA_REC_NUM; i++) {
-		prTempStaRec = &(prAdapter->arStaRec[i]);
-		if (prTempStaRec->fgIsInUse) {
-			if (prBssInfo->eCurrentOPMode == OP_MODE_NAN) {
-				if (EQUAL_MAC_ADDR(prTempStaRec->aucMacAddr,
-					prMsduInfo->aucEthDestAddr) &&
-					(prMsduInfo->ucBssIndex ==
-					prTempStaRec->ucBssIndex)) {
-					prMsduInfo->ucStaRecIndex =
-						prTempStaRec->ucIndex;
-					DBGLOG(QM, LOUD,
-						"TX with STA[%u]\n",
-						prTempStaRec->ucIndex);
-					return;
-				}
-			} else {
-				if (EQUAL_MAC_ADDR(prTempStaRec->aucMacAddr,
-					prMsduInfo->aucEthDestAddr)) {
-					prMsduInfo->ucStaRecIndex =
-						prTempStaRec->ucIndex;
-					DBGLOG(QM, LOUD, "TX with STA[%u]\n",
-						prTempStaRec->ucIndex);
-					return;
-				}
-			}
-		}
+	if (prBssInfo->eCurrentOPMode == OP_MODE_NAN)
+		prTempStaRec = cnmGetStaRecByAddress(prAdapter,
+			prMsduInfo->ucBssIndex, prMsduInfo->aucEthDestAddr);
+	else
+		prTempStaRec = cnmGetStaRecByAddressAnyBss(prAdapter,
+			prMsduInfo->ucBssIndex, prMsduInfo->aucEthDestAddr);
+	if (prTempStaRec) {
+		prMsduInfo->ucStaRecIndex = prTempStaRec->ucIndex;
+		DBGLOG(QM, LOUD, "TX with STA[%u]\n",
+			prTempStaRec->ucIndex);
+		return;
 	}
 
 	/* 4 <4> No STA found, Not BMCAST --> Indicate NOT_FOUND to FW */
@@ -4354,6 +4352,7 @@ void qmProcessPktWithReordering(IN struct ADAPTER *prAdapter,
 
 	struct STA_RECORD *prStaRec;
 	struct RX_BA_ENTRY *prReorderQueParm;
+	u_int8_t fgReorderLocked;
 
 #if CFG_SUPPORT_RX_AMSDU
 	uint8_t u8AmsduSubframeIdx;
@@ -4456,7 +4455,7 @@ void qmProcessPktWithReordering(IN struct ADAPTER *prAdapter,
 	prReorderQueParm->u4SeqNo = u4SeqNo;
 #endif
 
-	RX_DIRECT_REORDER_LOCK(prAdapter, 0);
+	RX_DIRECT_REORDER_LOCK(prAdapter, fgReorderLocked, 0);
 
 #if CFG_WOW_SUPPORT
 	/* After resuming, WinStart and WinEnd are obsolete and unsync
@@ -4481,7 +4480,7 @@ void qmProcessPktWithReordering(IN struct ADAPTER *prAdapter,
 	/* Insert reorder packet */
 	qmInsertReorderPkt(prAdapter, prSwRfb, prReorderQueParm,
 		prReturnedQue);
-	RX_DIRECT_REORDER_UNLOCK(prAdapter, 0);
+	RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
 }
 
 void qmProcessBarFrame(IN struct ADAPTER *prAdapter,
@@ -4491,6 +4490,7 @@ void qmProcessBarFrame(IN struct ADAPTER *prAdapter,
 	struct STA_RECORD *prStaRec;
 	struct RX_BA_ENTRY *prReorderQueParm;
 	struct CTRL_BAR_FRAME *prBarCtrlFrame;
+	u_int8_t fgReorderLocked;
 
 	uint32_t u4SSN;
 	uint32_t u4WinStart;
@@ -4559,7 +4559,7 @@ void qmProcessBarFrame(IN struct ADAPTER *prAdapter,
 		return;
 	}
 
-	RX_DIRECT_REORDER_LOCK(prAdapter, 0);
+	RX_DIRECT_REORDER_LOCK(prAdapter, fgReorderLocked, 0);
 
 	u4SSN = (uint32_t) (prSwRfb->u2SSN);
 	u4WinStart = (uint32_t) (prReorderQueParm->u2WinStart);
@@ -4585,9 +4585,304 @@ void qmProcessBarFrame(IN struct ADAPTER *prAdapter,
 		DBGLOG(QM, TRACE, "QM:(BAR)(%d)(%u){%u,%u}\n",
 			prSwRfb->ucTid, u4SSN, u4WinStart, u4WinEnd);
 	}
-	RX_DIRECT_REORDER_UNLOCK(prAdapter, 0);
+	RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
+}
+
+#if QM_RX_REORDER_SLOT_INDEX
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Allocate the SN-indexed slot array of an RX BA entry
+ *
+ * The slot array is a lookup index over rReOrderQue, which stays the
+ * ordered storage. If the allocation fails, the entry keeps using the
+ * linear queue walk.
+ *
+ * \param[in] prReorderQueParm The RX BA entry, u2WinSize shall be set
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void qmRxReorderSlotAlloc(IN struct ADAPTER *prAdapter,
+	IN struct RX_BA_ENTRY *prReorderQueParm)
+{
+	uint16_t u2SlotNum = 1;
+	struct SW_RFB **aprSlot;
+	uint32_t *pu4Bitmap;
+	u_int8_t fgReorderLocked;
+
+	qmRxReorderSlotFree(prAdapter, prReorderQueParm);
+
+	if (prReorderQueParm->u2WinSize == 0 ||
+		prReorderQueParm->u2WinSize > HALF_SEQ_NO_COUNT)
+		return;
+
+	/* A power of 2 divides MAX_SEQ_NO_COUNT, so (SN % u2SlotNum) stays
+	 * unique and contiguous across the SN wrap around
+	 */
+	while (u2SlotNum < prReorderQueParm->u2WinSize)
+		u2SlotNum <<= 1;
+
+	aprSlot = (struct SW_RFB **) kalMemAlloc(
+		u2SlotNum * sizeof(struct SW_RFB *), VIR_MEM_TYPE);
+	pu4Bitmap = (uint32_t *) kalMemAlloc(
+		QM_RX_REORDER_SLOT_BITMAP_SIZE(u2SlotNum), VIR_MEM_TYPE);
+	if (!aprSlot || !pu4Bitmap) {
+		DBGLOG(QM, WARN,
+			"QM: STA[%u] TID[%u] reorder slot alloc fail, size=%u\n",
+			prReorderQueParm->ucStaRecIdx, prReorderQueParm->ucTid,
+			u2SlotNum);
+		if (aprSlot)
+			kalMemFree(aprSlot, VIR_MEM_TYPE,
+				u2SlotNum * sizeof(struct SW_RFB *));
+		if (pu4Bitmap)
+			kalMemFree(pu4Bitmap, VIR_MEM_TYPE,
+				QM_RX_REORDER_SLOT_BITMAP_SIZE(u2SlotNum));
+		return;
+	}
+	kalMemZero(pu4Bitmap, QM_RX_REORDER_SLOT_BITMAP_SIZE(u2SlotNum));
+
+	RX_DIRECT_REORDER_LOCK(prAdapter, fgReorderLocked, 0);
+	prReorderQueParm->aprReorderSlot = aprSlot;
+	prReorderQueParm->pu4ReorderSlotBitmap = pu4Bitmap;
+	prReorderQueParm->u2SlotNum = u2SlotNum;
+	RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
 }
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Release the SN-indexed slot array of an RX BA entry
+ *
+ * \param[in] prReorderQueParm The RX BA entry
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void qmRxReorderSlotFree(IN struct ADAPTER *prAdapter,
+	IN struct RX_BA_ENTRY *prReorderQueParm)
+{
+	struct SW_RFB **aprSlot;
+	uint32_t *pu4Bitmap;
+	uint16_t u2SlotNum;
+	u_int8_t fgReorderLocked;
+
+	/* Detach under the reorder lock, RX direct may be walking it */
+	RX_DIRECT_REORDER_LOCK(prAdapter, fgReorderLocked, 0);
+	aprSlot = prReorderQueParm->aprReorderSlot;
+	pu4Bitmap = prReorderQueParm->pu4ReorderSlotBitmap;
+	u2SlotNum = prReorderQueParm->u2SlotNum;
+	prReorderQueParm->aprReorderSlot = NULL;
+	prReorderQueParm->pu4ReorderSlotBitmap = NULL;
+	prReorderQueParm->u2SlotNum = 0;
+	RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
+
+	if (aprSlot)
+		kalMemFree(aprSlot, VIR_MEM_TYPE,
+			u2SlotNum * sizeof(struct SW_RFB *));
+	if (pu4Bitmap)
+		kalMemFree(pu4Bitmap, VIR_MEM_TYPE,
+			QM_RX_REORDER_SLOT_BITMAP_SIZE(u2SlotNum));
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Mark all slots empty, used when rReOrderQue is flushed
+ *
+ * \param[in] prReorderQueParm The RX BA entry
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void qmRxReorderSlotReset(IN struct RX_BA_ENTRY *prReorderQueParm)
+{
+	if (!prReorderQueParm->aprReorderSlot)
+		return;
+
+	kalMemZero(prReorderQueParm->pu4ReorderSlotBitmap,
+		QM_RX_REORDER_SLOT_BITMAP_SIZE(prReorderQueParm->u2SlotNum));
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Index a SW_RFB which has just been linked into rReOrderQue
+ *
+ * The slot keeps the first queued SW_RFB of a SN, so A-MSDU subframes
+ * appended behind it do not move the slot. A slot still holding another SN
+ * (left behind by a window jump) is taken over.
+ *
+ * \param[in] prReorderQueParm The RX BA entry
+ * \param[in] prSwRfb The queued packet
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void qmRxReorderSlotSet(IN struct RX_BA_ENTRY *prReorderQueParm,
+	IN struct SW_RFB *prSwRfb)
+{
+	uint32_t u4Idx;
+
+	if (!prReorderQueParm->aprReorderSlot)
+		return;
+
+	u4Idx = prSwRfb->u2SSN % prReorderQueParm->u2SlotNum;
+	if (QM_RX_REORDER_SLOT_IS_SET(prReorderQueParm, u4Idx) &&
+		prReorderQueParm->aprReorderSlot[u4Idx]->u2SSN ==
+		prSwRfb->u2SSN)
+		return;
+
+	prReorderQueParm->aprReorderSlot[u4Idx] = prSwRfb;
+	prReorderQueParm->pu4ReorderSlotBitmap[u4Idx >> 5] |= BIT(u4Idx & 31);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Drop the index of a SW_RFB before it is unlinked from the head
+ *        of rReOrderQue
+ *
+ * \param[in] prReorderQueParm The RX BA entry
+ * \param[in] prSwRfb The head packet to be dequeued
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void qmRxReorderSlotClear(IN struct RX_BA_ENTRY *prReorderQueParm,
+	IN struct SW_RFB *prSwRfb)
+{
+	struct SW_RFB *prNextSwRfb;
+	uint32_t u4Idx;
+
+	if (!prReorderQueParm->aprReorderSlot)
+		return;
+
+	u4Idx = prSwRfb->u2SSN % prReorderQueParm->u2SlotNum;
+	if (!QM_RX_REORDER_SLOT_IS_SET(prReorderQueParm, u4Idx) ||
+		prReorderQueParm->aprReorderSlot[u4Idx] != prSwRfb)
+		return;
+
+	/* Remaining A-MSDU subframes of the same SN inherit the slot */
+	prNextSwRfb = QM_RX_GET_NEXT_SW_RFB(prSwRfb);
+	if (prNextSwRfb && prNextSwRfb->u2SSN == prSwRfb->u2SSN)
+		prReorderQueParm->aprReorderSlot[u4Idx] = prNextSwRfb;
+	else
+		prReorderQueParm->pu4ReorderSlotBitmap[u4Idx >> 5] &=
+			~BIT(u4Idx & 31);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Get the first queued SW_RFB of a SN
+ *
+ * \param[in] prReorderQueParm The RX BA entry
+ * \param[in] u2SN The sequence number
+ *
+ * \return The queued packet, NULL if the SN is not queued
+ */
+/*----------------------------------------------------------------------------*/
+struct SW_RFB *qmRxReorderSlotGet(IN struct RX_BA_ENTRY *prReorderQueParm,
+	IN uint16_t u2SN)
+{
+	struct SW_RFB *prSwRfb;
+	uint32_t u4Idx;
+
+	u4Idx = u2SN % prReorderQueParm->u2SlotNum;
+	if (!QM_RX_REORDER_SLOT_IS_SET(prReorderQueParm, u4Idx))
+		return NULL;
+
+	prSwRfb = prReorderQueParm->aprReorderSlot[u4Idx];
+	return (prSwRfb->u2SSN == u2SN) ? prSwRfb : NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Find the first queued SW_RFB after a SN, up to WinEnd
+ *
+ * The occupancy bitmap is scanned a word at a time, so the cost is bounded
+ * by u2WinSize / 32 instead of the number of queued packets.
+ *
+ * \param[in] prReorderQueParm The RX BA entry
+ * \param[in] u2SN The sequence number to start after
+ *
+ * \return The queued packet, NULL if nothing is queued after u2SN
+ */
+/*----------------------------------------------------------------------------*/
+struct SW_RFB *qmRxReorderSlotFindNext(
+	IN struct RX_BA_ENTRY *prReorderQueParm, IN uint16_t u2SN)
+{
+	uint32_t u4SlotNum = prReorderQueParm->u2SlotNum;
+	uint32_t u4Idx, u4Left, u4Bits, u4Word;
+
+	u4Left = (prReorderQueParm->u2WinEnd + MAX_SEQ_NO_COUNT - u2SN) %
+		MAX_SEQ_NO_COUNT;
+	if (u4Left >= u4SlotNum)
+		u4Left = u4SlotNum - 1;
+	u4Idx = (u2SN + 1) % u4SlotNum;
+
+	while (u4Left) {
+		u4Bits = 32 - (u4Idx & 31);
+		if (u4Bits > u4Left)
+			u4Bits = u4Left;
+		if (u4Idx + u4Bits > u4SlotNum)
+			u4Bits = u4SlotNum - u4Idx;
+
+		u4Word = prReorderQueParm->pu4ReorderSlotBitmap[u4Idx >> 5] >>
+			(u4Idx & 31);
+		if (u4Bits < 32)
+			u4Word &= BIT(u4Bits) - 1;
+		if (u4Word)
+			return prReorderQueParm->aprReorderSlot[
+				u4Idx + ffs(u4Word) - 1];
+
+		u4Left -= u4Bits;
+		u4Idx = (u4Idx + u4Bits) % u4SlotNum;
+	}
+
+	return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Get the position to start the insert walk of a fall within packet
+ *
+ * The slot found for the SN (or the next occupied one) is only trusted
+ * when its predecessor in rReOrderQue is older than the packet. Otherwise
+ * the walk restarts from the queue head, as the linear engine does.
+ *
+ * \param[in] prReorderQueParm The RX BA entry
+ * \param[in] prSwRfb The packet to insert
+ *
+ * \return The SW_RFB to start the walk from, NULL to insert at the tail
+ */
+/*----------------------------------------------------------------------------*/
+struct SW_RFB *qmRxReorderSlotLookup(IN struct RX_BA_ENTRY *prReorderQueParm,
+	IN struct SW_RFB *prSwRfb)
+{
+	struct QUE *prReorderQue = &(prReorderQueParm->rReOrderQue);
+	struct SW_RFB *prHead, *prStart, *prPrev;
+	uint16_t u2SN = prSwRfb->u2SSN;
+
+	prHead = (struct SW_RFB *) QUEUE_GET_HEAD(prReorderQue);
+	if (!prReorderQueParm->aprReorderSlot)
+		return prHead;
+
+	prStart = qmRxReorderSlotGet(prReorderQueParm, u2SN);
+	if (!prStart) {
+		prStart = qmRxReorderSlotFindNext(prReorderQueParm, u2SN);
+		if (prStart && !qmCompareSnIsLessThan(u2SN, prStart->u2SSN))
+			return prHead;
+	}
+
+	if (prStart)
+		prPrev = (struct SW_RFB *)
+			(((struct QUE_ENTRY *) prStart)->prPrev);
+	else
+		prPrev = (struct SW_RFB *) QUEUE_GET_TAIL(prReorderQue);
+
+	if (prPrev && !qmCompareSnIsLessThan(prPrev->u2SSN, u2SN))
+		return prHead;
+
+	return prStart;
+}
+#endif /* QM_RX_REORDER_SLOT_INDEX */
+
 void qmInsertReorderPkt(IN struct ADAPTER *prAdapter,
 	IN struct SW_RFB *prSwRfb,
 	IN struct RX_BA_ENTRY *prReorderQueParm,
@@ -4788,11 +5083,21 @@ void qmInsertFallWithinReorderPkt(IN struct ADAPTER *prAdapter,
 		prReorderQue->prHead = (struct QUE_ENTRY *) prSwRfb;
 		prReorderQue->prTail = (struct QUE_ENTRY *) prSwRfb;
 		prReorderQue->u4NumElem++;
+#if QM_RX_REORDER_SLOT_INDEX
+		qmRxReorderSlotSet(prReorderQueParm, prSwRfb);
+#endif
 	}
 
 	/* Determine the insert position */
 	else {
-		do {
+#if QM_RX_REORDER_SLOT_INDEX
+		/* Jump to the first queued SW_RFB whose SN is not less than
+		 * ours, a NULL result means the packet goes to the tail
+		 */
+		prExaminedQueuedSwRfb = qmRxReorderSlotLookup(prReorderQueParm,
+			prSwRfb);
+#endif
+		while (prExaminedQueuedSwRfb) {
 			/* Case 1: Terminate. A duplicate packet */
 			if ((prExaminedQueuedSwRfb->u2SSN) ==
 				(prSwRfb->u2SSN)) {
@@ -4850,7 +5155,7 @@ void qmInsertFallWithinReorderPkt(IN struct ADAPTER *prAdapter,
 				prExaminedQueuedSwRfb =
 					(struct SW_RFB *) (((struct QUE_ENTRY *)
 						prExaminedQueuedSwRfb)->prNext);
-		} while (prExaminedQueuedSwRfb);
+		}
 #if CFG_SUPPORT_RX_AMSDU
 		prReorderQueParm->fgIsAmsduDuplicated = FALSE;
 #endif
@@ -4886,6 +5191,9 @@ void qmInsertFallWithinReorderPkt(IN struct ADAPTER *prAdapter,
 		}
 
 		prReorderQue->u4NumElem++;
+#if QM_RX_REORDER_SLOT_INDEX
+		qmRxReorderSlotSet(prReorderQueParm, prSwRfb);
+#endif
 	}
 
 }
@@ -4919,6 +5227,9 @@ void qmInsertFallAheadReorderPkt(IN struct ADAPTER *prAdapter,
 	}
 	prReorderQue->prTail = (struct QUE_ENTRY *) prSwRfb;
 	prReorderQue->u4NumElem++;
+#if QM_RX_REORDER_SLOT_INDEX
+	qmRxReorderSlotSet(prReorderQueParm, prSwRfb);
+#endif
 }
 
 void qmPopOutReorderPkt(IN struct ADAPTER *prAdapter,
@@ -5075,6 +5386,10 @@ void qmPopOutDueToFallWithin(IN struct ADAPTER *prAdapter,
 
 		/* Dequeue the head packet */
 		if (fgDequeuHead) {
+#if QM_RX_REORDER_SLOT_INDEX
+			qmRxReorderSlotClear(prReorderQueParm,
+				prReorderedSwRfb);
+#endif
 			if (((struct QUE_ENTRY *) prReorderedSwRfb)->prNext ==
 				NULL) {
 				prReorderQue->prHead = NULL;
@@ -5210,6 +5525,10 @@ void qmPopOutDueToFallAhead(IN struct ADAPTER *prAdapter,
 
 		/* Dequeue the head packet */
 		if (fgDequeuHead) {
+#if QM_RX_REORDER_SLOT_INDEX
+			qmRxReorderSlotClear(prReorderQueParm,
+				prReorderedSwRfb);
+#endif
 			if (((struct QUE_ENTRY *) prReorderedSwRfb)->prNext ==
 				NULL) {
 				prReorderQue->prHead = NULL;
@@ -5276,6 +5595,7 @@ void qmHandleEventCheckReorderBubble(IN struct ADAPTER *prAdapter,
 	struct QUE *prReturnedQue = &rReturnedQue;
 	struct SW_RFB *prReorderedSwRfb, *prSwRfb;
 	OS_SYSTIME *prMissTimeout;
+	u_int8_t fgReorderLocked;
 
 	QUEUE_INITIALIZE(prReturnedQue);
 
@@ -5301,7 +5621,7 @@ void qmHandleEventCheckReorderBubble(IN struct ADAPTER *prAdapter,
 
 	prReorderQue = &(prReorderQueParm->rReOrderQue);
 
-	RX_DIRECT_REORDER_LOCK(prAdapter, 0);
+	RX_DIRECT_REORDER_LOCK(prAdapter, fgReorderLocked, 0);
 
 	if (QUEUE_IS_EMPTY(prReorderQue)) {
 		prReorderQueParm->fgHasBubble = FALSE;
@@ -5310,7 +5630,7 @@ void qmHandleEventCheckReorderBubble(IN struct ADAPTER *prAdapter,
 			"QM:(Bub Check Cancel) STA[%u] TID[%u], Bubble has been filled\n",
 			prReorderQueParm->ucStaRecIdx, prReorderQueParm->ucTid);
 
-		RX_DIRECT_REORDER_UNLOCK(prAdapter, 0);
+		RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
 		return;
 	}
 
@@ -5347,7 +5667,7 @@ void qmHandleEventCheckReorderBubble(IN struct ADAPTER *prAdapter,
 			prReorderQueParm->u2WinEnd);
 
 		prReorderQueParm->fgHasBubble = FALSE;
-		RX_DIRECT_REORDER_UNLOCK(prAdapter, 0);
+		RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
 
 		/* process prReturnedQue after unlock prReturnedQue */
 		if (QUEUE_IS_NOT_EMPTY(prReturnedQue)) {
@@ -5391,7 +5711,7 @@ void qmHandleEventCheckReorderBubble(IN struct ADAPTER *prAdapter,
 			prReorderQueParm->u2FirstBubbleSn,
 			prReorderQueParm->u2WinStart,
 			prReorderQueParm->u2WinEnd);
-		RX_DIRECT_REORDER_UNLOCK(prAdapter, 0);
+		RX_DIRECT_REORDER_UNLOCK(prAdapter, fgReorderLocked, 0);
 
 		cnmTimerStartTimer(prAdapter,
 			&(prReorderQueParm->rReorderBubbleTimer),
@@ -5682,6 +6002,9 @@ u_int8_t qmAddRxBaEntry(IN struct ADAPTER *prAdapter,
 		prRxBaEntry->u2WinSize = u2WinSize;
 		prRxBaEntry->u2WinEnd = ((u2WinStart + u2WinSize - 1) %
 			MAX_SEQ_NO_COUNT);
+#if QM_RX_REORDER_SLOT_INDEX
+		qmRxReorderSlotAlloc(prAdapter, prRxBaEntry);
+#endif
 #if CFG_SUPPORT_RX_AMSDU
 		/* RX reorder for one MSDU in AMSDU issue */
 		prRxBaEntry->u8LastAmsduSubIdx = RX_PAYLOAD_FORMAT_MSDU;
@@ -5784,6 +6107,9 @@ void qmDelRxBaEntry(IN struct ADAPTER *prAdapter,
 		 */
 		prRxBaEntry->fgIsValid = FALSE;
 		prQM->ucRxBaCount--;
+#if QM_RX_REORDER_SLOT_INDEX
+		qmRxReorderSlotFree(prAdapter, prRxBaEntry);
+#endif
 
 		/* Debug */
 #if 0
@@ -7745,7 +8071,7 @@ uint32_t qmDumpQueueStatus(IN struct ADAPTER *prAdapter,
 		"CMD: F[%u/%u] PQ[%u] CQ[%u] TCQ[%u] TCDQ[%u]\n",
 		prAdapter->rFreeCmdList.u4NumElem,
 		CFG_TX_MAX_CMD_PKT_NUM,
-		prAdapter->rPendingCmdQueue.u4NumElem,
+		prAdapter->u4PendingCmdNum,
 		prGlueInfo->rCmdQueue.u4NumElem,
 		prAdapter->rTxCmdQueue.u4NumElem,
 		prAdapter->rTxCmdDoneQueue.u4NumElem);
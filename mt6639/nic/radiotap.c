@@ -450,10 +450,10 @@ void radiotapFillRadiotap(IN struct ADAPTER *prAdapter,
 	uint16_t padding_len = 0;
 	uint32_t present;
 
-	if (prRxDescOps->nic_rxd_fill_radiotap) {
+	if (RX_DESC_OPS_EXIST(prRxDescOps, fill_radiotap)) {
 		prSwRfb->prRadiotapInfo = &radiotapInfo;
-		ucFillRadiotap = prRxDescOps->nic_rxd_fill_radiotap(prAdapter,
-								    prSwRfb);
+		ucFillRadiotap = RX_DESC_OPS_FN(prRxDescOps, fill_radiotap)(
+			prAdapter, prSwRfb);
 	}
 
 	if (ucFillRadiotap == FALSE) {
@@ -908,15 +908,12 @@ static int bowHardStartXmit(IN struct sk_buff *prSkb, IN struct net_device *prDe
 	struct GLUE_INFO *prGlueInfo = *((struct GLUE_INFO **) netdev_priv(prDev));
 
 	struct QUE_ENTRY *prQueueEntry = NULL;
-	struct QUE *prTxQueue = NULL;
 	uint16_t u2QueueIdx = 0;
 	uint8_t ucDSAP, ucSSAP, ucControl;
 	uint8_t aucOUI[3];
 	uint8_t *aucLookAheadBuf = NULL;
 	uint8_t ucBssIndex;
 
-	GLUE_SPIN_LOCK_DECLARATION();
-
 	ASSERT(prSkb);
 	ASSERT(prDev);
 	ASSERT(prGlueInfo);
@@ -952,12 +949,9 @@ static int bowHardStartXmit(IN struct sk_buff *prSkb, IN struct net_device *prDe
 	GLUE_SET_PKT_BSS_IDX(prSkb, ucBssIndex);
 
 	prQueueEntry = (struct QUE_ENTRY *) GLUE_GET_PKT_QUEUE_ENTRY(prSkb);
-	prTxQueue = &prGlueInfo->rTxQueue;
 
 	if (wlanProcessSecurityFrame(prGlueInfo->prAdapter, (void *) prSkb) == FALSE) {
-		GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
-		QUEUE_INSERT_TAIL(prTxQueue, prQueueEntry);
-		GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+		QUEUE_MPSC_PUSH(&prGlueInfo->prTxInbox, prQueueEntry);
 
 		GLUE_INC_REF_CNT(prGlueInfo->i4TxPendingFrameNum);
 		GLUE_INC_REF_CNT(prGlueInfo->ai4TxPendingFrameNumPerQueue[ucBssIndex][u2QueueIdx]);
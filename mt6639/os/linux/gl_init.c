@@ -2035,6 +2035,8 @@ netdev_tx_t wlanHardStartXmit(struct sk_buff *prSkb,
 	}
 #endif
 	kalResetPacket(prGlueInfo, (void *) prSkb);
+	if (KAL_IS_PKT_XMIT_MORE(prSkb))
+		GLUE_SET_PKT_FLAG(prSkb, ENUM_PKT_XMIT_MORE);
 
 	STATS_TX_TIME_ARRIVE(prSkb);
 
@@ -3274,6 +3276,7 @@ static struct wireless_dev *wlanNetCreate(void *pvData,
 #if CFG_SUPPORT_MULTITHREAD
 	init_completion(&prGlueInfo->rHifHaltComp);
 	init_completion(&prGlueInfo->rRxHaltComp);
+	init_completion(&prGlueInfo->rTxHaltComp);
 #endif
 
 #if CFG_SUPPORT_NCHO
@@ -3307,6 +3310,7 @@ static struct wireless_dev *wlanNetCreate(void *pvData,
 	QUEUE_INITIALIZE(&prGlueInfo->rCmdQueue);
 	prGlueInfo->i4TxPendingCmdNum = 0;
 	QUEUE_INITIALIZE(&prGlueInfo->rTxQueue);
+	prGlueInfo->prTxInbox = NULL;
 	glSetHifInfo(prGlueInfo, (unsigned long) pvData);
 
 	/* Init wakelock */
@@ -3316,10 +3320,12 @@ static struct wireless_dev *wlanNetCreate(void *pvData,
 #if CFG_SUPPORT_MULTITHREAD
 	init_waitqueue_head(&prGlueInfo->waitq_rx);
 	init_waitqueue_head(&prGlueInfo->waitq_hif);
+	init_waitqueue_head(&prGlueInfo->waitq_tx);
 
 	prGlueInfo->u4TxThreadPid = 0xffffffff;
 	prGlueInfo->u4RxThreadPid = 0xffffffff;
 	prGlueInfo->u4HifThreadPid = 0xffffffff;
+	prGlueInfo->u4TxDataThreadPid = 0xffffffff;
 #endif
 
 #if CFG_SUPPORT_CSI
@@ -4786,6 +4792,18 @@ static int32_t wlanOnPreNetRegister(struct GLUE_INFO *prGlueInfo,
 			prGlueInfo->prDevHandler, "hif_thread");
 	prGlueInfo->rx_thread = kthread_run(rx_thread,
 			prGlueInfo->prDevHandler, "rx_thread");
+	/* main_thread keeps data RX if rx_thread is unavailable */
+	prAdapter->rRxCtrl.fgRxDataThread = prWifiVar->ucRxDataThread &&
+		!IS_ERR_OR_NULL(prGlueInfo->rx_thread);
+	if (prWifiVar->ucTxDataThread) {
+		prGlueInfo->tx_thread = kthread_run(tx_thread,
+				prGlueInfo->prDevHandler, "tx_thread");
+		/* main_thread keeps data TX if tx_thread is unavailable */
+		if (IS_ERR(prGlueInfo->tx_thread)) {
+			DBGLOG(INIT, ERROR, "Create tx_thread failed\n");
+			prGlueInfo->tx_thread = NULL;
+		}
+	}
 #endif
 
 	if (!bAtResetFlow)
@@ -5261,7 +5279,7 @@ static int32_t wlanPowerOnInit(void)
 		prAdapter->ucCmdSeqNum = 0;
 		prAdapter->u4PwrCtrlBlockCnt = 0;
 
-		QUEUE_INITIALIZE(&(prAdapter->rPendingCmdQueue));
+		nicInitPendingCmdInfo(prAdapter);
 #if CFG_SUPPORT_MULTITHREAD
 		QUEUE_INITIALIZE(&prAdapter->rTxCmdQueue);
 		QUEUE_INITIALIZE(&prAdapter->rTxCmdDoneQueue);
@@ -5582,6 +5600,7 @@ void wlanOffStopWlanThreads(IN struct GLUE_INFO *prGlueInfo)
 #if CFG_SUPPORT_MULTITHREAD
 		&& prGlueInfo->hif_thread == NULL
 		&& prGlueInfo->rx_thread == NULL
+		&& prGlueInfo->tx_thread == NULL
 #endif
 		) {
 
@@ -5596,6 +5615,11 @@ void wlanOffStopWlanThreads(IN struct GLUE_INFO *prGlueInfo)
 		&prGlueInfo->rHifHaltComp);
 	wake_up_interruptible(&prGlueInfo->waitq_rx);
 	wait_for_completion_interruptible(&prGlueInfo->rRxHaltComp);
+	/* tx_thread must stop before main_thread flushes pending TX */
+	if (prGlueInfo->tx_thread) {
+		wake_up_interruptible(&prGlueInfo->waitq_tx);
+		wait_for_completion_interruptible(&prGlueInfo->rTxHaltComp);
+	}
 #endif
 
 	/* wake up main thread */
@@ -5608,11 +5632,18 @@ void wlanOffStopWlanThreads(IN struct GLUE_INFO *prGlueInfo)
 	/* prGlueInfo->rHifInfo.main_thread = NULL; */
 	prGlueInfo->main_thread = NULL;
 #if CFG_SUPPORT_MULTITHREAD
+	/* No thread is left in a reorder section to see this change,
+	 * nicRxUninitialize frees the data RFBs still queued for rx_thread
+	 */
+	if (prGlueInfo->prAdapter)
+		prGlueInfo->prAdapter->rRxCtrl.fgRxDataThread = FALSE;
 	prGlueInfo->hif_thread = NULL;
 	prGlueInfo->rx_thread = NULL;
+	prGlueInfo->tx_thread = NULL;
 
 	prGlueInfo->u4TxThreadPid = 0xffffffff;
 	prGlueInfo->u4HifThreadPid = 0xffffffff;
+	prGlueInfo->u4TxDataThreadPid = 0xffffffff;
 #endif
 
 	if (test_and_clear_bit(GLUE_FLAG_OID_BIT, &prGlueInfo->ulFlag) &&
@@ -5781,6 +5812,7 @@ int32_t wlanOnAtReset(void)
 		QUEUE_INITIALIZE(&prGlueInfo->rCmdQueue);
 		prGlueInfo->i4TxPendingCmdNum = 0;
 		QUEUE_INITIALIZE(&prGlueInfo->rTxQueue);
+		prGlueInfo->prTxInbox = NULL;
 
 		glResetHifInfo(prGlueInfo);
 
@@ -6822,6 +6854,9 @@ static void exitWlan(void)
 #if WLAN_INCLUDE_SYS
 	sysUninitSysFs();
 #endif
+#if CFG_SUPPORT_DBG_TRACE_RING
+	wlanDbgTraceUninit();
+#endif
 #if defined(UT_TEST_MODE) && defined(CFG_BUILD_X86_PLATFORM)
 	kfree((const void *)gConEmiPhyBase);
 #endif
@@ -2154,6 +2154,61 @@ u_int8_t kalIsPairwiseEapolPacket(IN void *prPacket)
 }
 
 #if (CFG_SUPPORT_TX_TSO_SW == 1)
+#if defined(HIF_TX_SUPPORT_NONLINEAR_SKB) && HIF_TX_SUPPORT_NONLINEAR_SKB
+/*----------------------------------------------------------------------------*/
+/*
+ * \brief Attach the current TSO payload chunk to a segment. Payload in the
+ *        page frags of the original skb is referenced, not copied, so the
+ *        HIF gathers it straight into the DMA buffer. Payload left in the
+ *        linear area always precedes the frags and is copied, and so is
+ *        payload of frags the caller may not reference.
+ *
+ * \param[in] prOrgSkb  Original GSO skb
+ * \param[in] prNskb    Segment being built
+ * \param[in] prTso     TSO iterator pointing to the chunk
+ * \param[in] u4Size    Bytes of the chunk to attach
+ * \param[in] fgRefFrag TRUE if the frag pages may be referenced
+ *
+ * \retval none
+ */
+/*----------------------------------------------------------------------------*/
+static void kalSwTsoAddData(struct sk_buff *prOrgSkb,
+			    struct sk_buff *prNskb,
+			    struct tso_t *prTso, uint32_t u4Size,
+			    u_int8_t fgRefFrag)
+{
+	skb_frag_t *prFrag;
+	struct page *prPage;
+	uint32_t u4Off;
+	int i;
+
+	if (prTso->next_frag_idx == 0 || !fgRefFrag) {
+		kalMemCopy(skb_put(prNskb, u4Size), prTso->data, u4Size);
+		return;
+	}
+
+	prFrag = &skb_shinfo(prOrgSkb)->frags[prTso->next_frag_idx - 1];
+	prPage = skb_frag_page(prFrag);
+#if KERNEL_VERSION(5, 4, 0) <= LINUX_VERSION_CODE
+	u4Off = skb_frag_off(prFrag);
+#else
+	u4Off = prFrag->page_offset;
+#endif
+	u4Off += (uint32_t)(prTso->data - (char *)skb_frag_address(prFrag));
+
+	i = skb_shinfo(prNskb)->nr_frags;
+	if (skb_can_coalesce(prNskb, i, prPage, u4Off)) {
+		skb_frag_size_add(&skb_shinfo(prNskb)->frags[i - 1], u4Size);
+	} else {
+		get_page(prPage);
+		skb_fill_page_desc(prNskb, i, prPage, u4Off, u4Size);
+	}
+	prNskb->len += u4Size;
+	prNskb->data_len += u4Size;
+	prNskb->truesize += u4Size;
+}
+#endif
+
 uint32_t
 kalSwTsoXmit(struct sk_buff **pprOrgSkb,
 		 IN struct net_device *prDev, struct GLUE_INFO *prGlueInfo,
@@ -2165,6 +2220,9 @@ kalSwTsoXmit(struct sk_buff **pprOrgSkb,
 	struct mt66xx_chip_info *prChipInfo;
 	uint32_t u4TxHeadRoomSize;
 	struct sk_buff *prOrgSkb = *pprOrgSkb;
+#if defined(HIF_TX_SUPPORT_NONLINEAR_SKB) && HIF_TX_SUPPORT_NONLINEAR_SKB
+	u_int8_t fgRefFrag;
+#endif
 
 	if (!prOrgSkb || !prGlueInfo) {
 		DBGLOG(TX, ERROR, "Invalid resource %p %p\n"
@@ -2207,6 +2265,23 @@ kalSwTsoXmit(struct sk_buff **pprOrgSkb,
 	u4TxHeadRoomSize = NIC_TX_DESC_AND_PADDING_LENGTH +
 			   prChipInfo->txd_append_size;
 
+#if defined(HIF_TX_SUPPORT_NONLINEAR_SKB) && HIF_TX_SUPPORT_NONLINEAR_SKB
+	/* Frag pages of a zerocopy skb go back to the user as soon as
+	 * prOrgSkb is freed, while the segments may still wait for DMA. Move
+	 * them to kernel pages first, or copy the payload if that fails.
+	 */
+#if KERNEL_VERSION(4, 14, 0) <= LINUX_VERSION_CODE
+	if (skb_zcopy(prOrgSkb))
+		skb_orphan_frags(prOrgSkb, GFP_ATOMIC);
+	fgRefFrag = !skb_zcopy(prOrgSkb);
+#else
+	fgRefFrag = !skb_orphan_frags(prOrgSkb, GFP_ATOMIC);
+#endif
+	/* SwTsoRefFrag=0 keeps the copy path, to compare CPU per Gbit */
+	if (!prGlueInfo->prAdapter->rWifiVar.ucSwTsoRefFrag)
+		fgRefFrag = FALSE;
+#endif
+
 	/* Initialize the TSO handler, and prepare the first payload */
 	tso_start(prOrgSkb, &rTso);
 
@@ -2266,10 +2341,15 @@ kalSwTsoXmit(struct sk_buff **pprOrgSkb,
 
 			u4Size = min_t(int, rTso.size, u4DataLeft);
 
+#if defined(HIF_TX_SUPPORT_NONLINEAR_SKB) && HIF_TX_SUPPORT_NONLINEAR_SKB
+			kalSwTsoAddData(prOrgSkb, prNskb, &rTso, u4Size,
+					fgRefFrag);
+#else
 			kalMemCopy(prNskb->data + prNskb->len,
 				rTso.data, u4Size);
 
 			__skb_put(prNskb, u4Size);
+#endif
 
 			u4DataLeft -= u4Size;
 
@@ -2309,7 +2389,6 @@ kalHardStartXmit(struct sk_buff *prOrgSkb,
 		 uint8_t ucBssIndex)
 {
 	struct QUE_ENTRY *prQueueEntry = NULL;
-	struct QUE *prTxQueue = NULL;
 	uint16_t u2QueueIdx = 0;
 	struct sk_buff *prSkbNew = NULL;
 	struct sk_buff *prSkb = NULL;
@@ -2381,7 +2460,6 @@ kalHardStartXmit(struct sk_buff *prOrgSkb,
 
 	prQueueEntry = (struct QUE_ENTRY *)
 		       GLUE_GET_PKT_QUEUE_ENTRY(prSkb);
-	prTxQueue = &prGlueInfo->rTxQueue;
 
 	GLUE_SET_PKT_BSS_IDX(prSkb, ucBssIndex);
 
@@ -2418,13 +2496,9 @@ kalHardStartXmit(struct sk_buff *prOrgSkb,
 	}
 #endif /* CFG_SUPPORT_TPENHANCE_MODE */
 
-	if (!HAL_IS_TX_DIRECT(prGlueInfo->prAdapter)) {
-		GLUE_SPIN_LOCK_DECLARATION();
-
-		GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
-		QUEUE_INSERT_TAIL(prTxQueue, prQueueEntry);
-		GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
-	}
+	/* netdevs of every BSS push here without a shared lock */
+	if (!HAL_IS_TX_DIRECT(prGlueInfo->prAdapter))
+		QUEUE_MPSC_PUSH(&prGlueInfo->prTxInbox, prQueueEntry);
 
 	GLUE_INC_REF_CNT(prGlueInfo->i4TxPendingFrameNum);
 	GLUE_INC_REF_CNT(
@@ -2435,6 +2509,8 @@ kalHardStartXmit(struct sk_buff *prOrgSkb,
 	    [ucBssIndex][u2QueueIdx]) >=
 	    prGlueInfo->prAdapter->rWifiVar.u4NetifStopTh) {
 		netif_stop_subqueue(prDev, u2QueueIdx);
+		/* Stack stops feeding this queue, do not hold the skb */
+		GLUE_CLEAR_PKT_FLAG(prSkb, ENUM_PKT_XMIT_MORE);
 
 		DBGLOG_LIMITED(TX, INFO,
 		       "Stop subqueue for BSS[%u] QIDX[%u] PKT_LEN[%u] TOT_CNT[%d] PER-Q_CNT[%d]\n",
@@ -2469,7 +2545,11 @@ kalHardStartXmit(struct sk_buff *prOrgSkb,
 		return nicTxDirectStartXmit(prSkb, prGlueInfo);
 	}
 
+#if CFG_SUPPORT_MULTITHREAD
+	kalSetTxDataEvent(prGlueInfo);
+#else
 	kalSetEvent(prGlueInfo);
+#endif
 
 	return WLAN_STATUS_SUCCESS;
 }				/* end of kalHardStartXmit() */
@@ -2643,6 +2723,11 @@ void kalSendCompleteAndAwakeQueue(IN struct GLUE_INFO
 
 #if (CFG_SUPPORT_TX_TSO_SW == 1)
 	if (GLUE_TEST_PKT_FLAG(pvPacket, ENUM_PKT_TSO)) {
+		/* Drop payload page references before the skb is reused,
+		 * and the truesize they added
+		 */
+		pskb_trim((struct sk_buff *)pvPacket, 0);
+		prSkb->truesize = SKB_TRUESIZE(skb_end_offset(prSkb));
 		skb_queue_tail(&prGlueInfo->prAdapter->rTsoQueue,
 			(struct sk_buff *)pvPacket);
 	} else
@@ -3539,7 +3624,7 @@ kalIoctlByBssIdx(IN struct GLUE_INFO *prGlueInfo,
 	 * bit.
 	 */
 	smp_mb();
-	set_bit(GLUE_FLAG_OID_BIT, &prGlueInfo->ulFlag);
+	kalRaiseEvent(prGlueInfo, GLUE_FLAG_OID_BIT);
 
 	/* <7.1> Hold wakelock to ensure OS won't be suspended */
 	KAL_WAKE_LOCK_TIMEOUT(prGlueInfo->prAdapter,
@@ -3929,17 +4014,16 @@ uint32_t kalProcessTxPacket(struct GLUE_INFO *prGlueInfo,
 
 /*----------------------------------------------------------------------------*/
 /*!
- * \brief This routine is used to process Tx request to main_thread
+ * \brief This routine moves OS TX packets into QM and dequeues them to HIF
  *
  * \param prGlueInfo     Pointer of GLUE Data Structure
  *
  * \retval none
  */
 /*----------------------------------------------------------------------------*/
-void kalProcessTxReq(struct GLUE_INFO *prGlueInfo,
-		     u_int8_t *pfgNeedHwAccess)
+static void kalProcessTxData(struct GLUE_INFO *prGlueInfo,
+			     u_int8_t *pfgNeedHwAccess)
 {
-	struct QUE *prCmdQue = NULL;
 	struct QUE *prTxQueue = NULL;
 	struct QUE rTempQue;
 	struct QUE *prTempQue = &rTempQue;
@@ -3948,16 +4032,12 @@ void kalProcessTxReq(struct GLUE_INFO *prGlueInfo,
 	struct QUE_ENTRY *prQueueEntry = NULL;
 	/* struct sk_buff      *prSkb = NULL; */
 	uint32_t u4Status;
-#if CFG_SUPPORT_MULTITHREAD
-	uint32_t u4CmdCount = 0;
-#endif
 	uint32_t u4TxLoopCount;
 
 	/* for spin lock acquire and release */
 	GLUE_SPIN_LOCK_DECLARATION();
 
 	prTxQueue = &prGlueInfo->rTxQueue;
-	prCmdQue = &prGlueInfo->rCmdQueue;
 
 	QUEUE_INITIALIZE(prTempQue);
 	QUEUE_INITIALIZE(prTempReturnQue);
@@ -3965,33 +4045,14 @@ void kalProcessTxReq(struct GLUE_INFO *prGlueInfo,
 	u4TxLoopCount =
 		prGlueInfo->prAdapter->rWifiVar.u4TxFromOsLoopCount;
 
-	/* Process Mailbox Messages */
-	wlanProcessMboxMessage(prGlueInfo->prAdapter);
-
-	/* Process CMD request */
-#if CFG_SUPPORT_MULTITHREAD
-	GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_CMD_QUE);
-	u4CmdCount = prCmdQue->u4NumElem;
-	GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_CMD_QUE);
-	if (u4CmdCount > 0)
-		wlanProcessCommandQueue(prGlueInfo->prAdapter, prCmdQue);
-
-#else
-	if (prCmdQue->u4NumElem > 0) {
-		if (*pfgNeedHwAccess == FALSE) {
-			*pfgNeedHwAccess = TRUE;
-
-			wlanAcquirePowerControl(prGlueInfo->prAdapter);
-		}
-		wlanProcessCommandQueue(prGlueInfo->prAdapter, prCmdQue);
-	}
-#endif
-
 	while (u4TxLoopCount--) {
-		while (QUEUE_IS_NOT_EMPTY(prTxQueue)) {
+		while (QUEUE_IS_NOT_EMPTY(prTxQueue) ||
+		       prGlueInfo->prTxInbox) {
+			/* frames put back first, then the new ones in order */
 			GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
 			QUEUE_MOVE_ALL(prTempQue, prTxQueue);
 			GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+			QUEUE_MPSC_MOVE_ALL(prTempQue, &prGlueInfo->prTxInbox);
 
 			/* Handle Packet Tx */
 			while (QUEUE_IS_NOT_EMPTY(prTempQue)) {
@@ -4070,7 +4131,58 @@ void kalProcessTxReq(struct GLUE_INFO *prGlueInfo,
 			wlanTxPendingPackets(prGlueInfo->prAdapter,
 					     pfgNeedHwAccess);
 	}
+}
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief This routine is used to process Tx request to main_thread
+ *
+ * \param prGlueInfo     Pointer of GLUE Data Structure
+ *
+ * \retval none
+ */
+/*----------------------------------------------------------------------------*/
+void kalProcessTxReq(struct GLUE_INFO *prGlueInfo,
+		     u_int8_t *pfgNeedHwAccess)
+{
+	struct QUE *prCmdQue = NULL;
+#if CFG_SUPPORT_MULTITHREAD
+	uint32_t u4CmdCount = 0;
+
+	/* for spin lock acquire and release */
+	GLUE_SPIN_LOCK_DECLARATION();
+#endif
+
+	prCmdQue = &prGlueInfo->rCmdQueue;
+
+	/* Process Mailbox Messages */
+	wlanProcessMboxMessage(prGlueInfo->prAdapter);
+
+	/* Process CMD request */
+#if CFG_SUPPORT_MULTITHREAD
+	GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_CMD_QUE);
+	u4CmdCount = prCmdQue->u4NumElem;
+	GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_CMD_QUE);
+	if (u4CmdCount > 0)
+		wlanProcessCommandQueue(prGlueInfo->prAdapter, prCmdQue);
+
+	/* Data TX is scheduled by tx_thread when it is running */
+	if (prGlueInfo->tx_thread) {
+		kalSetTxDataEvent(prGlueInfo);
+		return;
+	}
+#else
+	if (prCmdQue->u4NumElem > 0) {
+		if (*pfgNeedHwAccess == FALSE) {
+			*pfgNeedHwAccess = TRUE;
+
+			wlanAcquirePowerControl(prGlueInfo->prAdapter);
+		}
+		wlanProcessCommandQueue(prGlueInfo->prAdapter, prCmdQue);
+	}
+#endif
+
+	kalProcessTxData(prGlueInfo, pfgNeedHwAccess);
 }
 
 #if CFG_SUPPORT_MULTITHREAD
@@ -4107,6 +4219,7 @@ int hif_thread(void *data)
 	prGlueInfo->u4HifThreadPid = KAL_GET_CURRENT_THREAD_ID();
 
 	kalSetThreadSchPolicyPriority(prGlueInfo);
+	kalSetThreadCpuMask(prAdapter->rWifiVar.u4HifThreadCpuMask);
 
 	while (TRUE) {
 
@@ -4150,8 +4263,7 @@ int hif_thread(void *data)
 		wlanAcquirePowerControl(prAdapter);
 
 		/* Handle Interrupt */
-		if (test_and_clear_bit(GLUE_FLAG_INT_BIT,
-				       &prGlueInfo->ulFlag)) {
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_INT_BIT)) {
 			/* the Wi-Fi interrupt is already disabled in mmc
 			 * thread, so we set the flag only to enable the
 			 * interrupt later
@@ -4174,29 +4286,28 @@ int hif_thread(void *data)
 		if ((prAdapter->fgIsFwOwn == FALSE) &&
 		    !nicSerIsTxStop(prAdapter)) {
 			/* TX Commands */
-			if (test_and_clear_bit(GLUE_FLAG_HIF_TX_CMD_BIT,
-					       &prGlueInfo->ulFlag))
+			if (kalTestAndClearEvent(prGlueInfo,
+						 GLUE_FLAG_HIF_TX_CMD_BIT))
 				wlanTxCmdMthread(prAdapter);
 
 			/* Process TX data packet to HIF */
-			if (test_and_clear_bit(GLUE_FLAG_HIF_TX_BIT,
-					       &prGlueInfo->ulFlag))
+			if (kalTestAndClearEvent(prGlueInfo,
+						 GLUE_FLAG_HIF_TX_BIT))
 				nicTxMsduQueueMthread(prAdapter);
 		}
 
 		/* Read chip status when chip no response */
-		if (test_and_clear_bit(GLUE_FLAG_HIF_PRT_HIF_DBG_INFO_BIT,
-				       &prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo,
+					 GLUE_FLAG_HIF_PRT_HIF_DBG_INFO_BIT))
 			halPrintHifDbgInfo(prAdapter);
 
 		/* Update Tx Quota */
-		if (test_and_clear_bit(GLUE_FLAG_UPDATE_WMM_QUOTA,
-					&prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo,
+					 GLUE_FLAG_UPDATE_WMM_QUOTA))
 			halUpdateTxMaxQuota(prAdapter);
 
 		/* Set FW own */
-		if (test_and_clear_bit(GLUE_FLAG_HIF_FW_OWN_BIT,
-				       &prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_HIF_FW_OWN_BIT))
 			prAdapter->fgWiFiInSleepyState = TRUE;
 
 		/* Release to FW own */
@@ -4256,6 +4367,8 @@ int rx_thread(void *data)
 	prGlueInfo->u4RxThreadPid = KAL_GET_CURRENT_THREAD_ID();
 
 	kalSetThreadSchPolicyPriority(prGlueInfo);
+	kalSetThreadCpuMask(
+		prGlueInfo->prAdapter->rWifiVar.u4RxThreadCpuMask);
 
 	prTempRxQue = &rTempRxQue;
 
@@ -4286,8 +4399,11 @@ int rx_thread(void *data)
 			KAL_WAKE_LOCK(prGlueInfo->prAdapter,
 				      prRxThreadWakeLock);
 #endif
-		if (test_and_clear_bit(GLUE_FLAG_RX_TO_OS_BIT,
-				       &prGlueInfo->ulFlag)) {
+		/* Data RFBs, queued to rRxQueue for the RX_TO_OS step below */
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_RX_DATA_BIT))
+			nicRxProcessDataRFBs(prGlueInfo->prAdapter);
+
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_RX_TO_OS_BIT)) {
 			u4LoopCount =
 			    prGlueInfo->prAdapter->rWifiVar.u4Rx2OsLoopCount;
 
@@ -4335,6 +4451,97 @@ int rx_thread(void *data)
 	DBGLOG(INIT, TRACE, "%s:%u stopped!\n",
 	       KAL_GET_CURRENT_THREAD_NAME(), KAL_GET_CURRENT_THREAD_ID());
 
+#if CFG_CHIP_RESET_HANG
+	while (fgIsResetHangState == SER_L0_HANG_RST_HANG) {
+		kalMsleep(SER_L0_HANG_LOG_TIME_INTERVAL);
+		DBGLOG(INIT, STATE, "[SER][L0] SQC hang!\n");
+	}
+#endif
+
+	return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief This function is a kernel thread function for moving OS TX packets
+ * to QM and HIF, so data TX does not wait behind main_thread management work
+ *
+ * @param data       data pointer to private data of tx_thread
+ *
+ * @retval           If the function succeeds, the return value is 0.
+ * Otherwise, an error code is returned.
+ *
+ */
+/*----------------------------------------------------------------------------*/
+int tx_thread(void *data)
+{
+	struct net_device *dev = data;
+	struct GLUE_INFO *prGlueInfo = *((struct GLUE_INFO **)
+					 netdev_priv(dev));
+	u_int8_t fgNeedHwAccess = FALSE;
+	int ret = 0;
+#if CFG_ENABLE_WAKE_LOCK
+	KAL_WAKE_LOCK_T *prTxDataThreadWakeLock;
+
+	KAL_WAKE_LOCK_INIT(prGlueInfo->prAdapter,
+			   prTxDataThreadWakeLock, "WLAN tx_thread");
+	KAL_WAKE_LOCK(prGlueInfo->prAdapter, prTxDataThreadWakeLock);
+#endif
+
+	DBGLOG(INIT, INFO, "%s:%u starts running...\n",
+	       KAL_GET_CURRENT_THREAD_NAME(), KAL_GET_CURRENT_THREAD_ID());
+
+	prGlueInfo->u4TxDataThreadPid = KAL_GET_CURRENT_THREAD_ID();
+
+	kalSetThreadSchPolicyPriority(prGlueInfo);
+	kalSetThreadCpuMask(
+		prGlueInfo->prAdapter->rWifiVar.u4TxDataThreadCpuMask);
+
+	while (TRUE) {
+
+		if (prGlueInfo->ulFlag & GLUE_FLAG_HALT
+			|| kalIsResetting()
+			) {
+			DBGLOG(INIT, INFO, "tx_thread should stop now...\n");
+			break;
+		}
+
+		/* Unlock wakelock if tx_thread going to idle */
+		if (!(prGlueInfo->ulFlag & GLUE_FLAG_TX_DATA_PROCESS))
+			KAL_WAKE_UNLOCK(prGlueInfo->prAdapter,
+					prTxDataThreadWakeLock);
+
+		/*
+		 * sleep on waitqueue if no events occurred.
+		 */
+		do {
+			ret = wait_event_interruptible(prGlueInfo->waitq_tx,
+			    ((prGlueInfo->ulFlag & GLUE_FLAG_TX_DATA_PROCESS)
+			    != 0));
+		} while (ret != 0);
+#if CFG_ENABLE_WAKE_LOCK
+		if (!KAL_WAKE_LOCK_ACTIVE(prGlueInfo->prAdapter,
+					  prTxDataThreadWakeLock))
+			KAL_WAKE_LOCK(prGlueInfo->prAdapter,
+				      prTxDataThreadWakeLock);
+#endif
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_TX_DATA_BIT))
+			kalProcessTxData(prGlueInfo, &fgNeedHwAccess);
+	}
+
+	complete(&prGlueInfo->rTxHaltComp);
+#if CFG_ENABLE_WAKE_LOCK
+	if (KAL_WAKE_LOCK_ACTIVE(prGlueInfo->prAdapter,
+				 prTxDataThreadWakeLock))
+		KAL_WAKE_UNLOCK(prGlueInfo->prAdapter,
+				prTxDataThreadWakeLock);
+	KAL_WAKE_LOCK_DESTROY(prGlueInfo->prAdapter,
+			      prTxDataThreadWakeLock);
+#endif
+
+	DBGLOG(INIT, TRACE, "%s:%u stopped!\n",
+	       KAL_GET_CURRENT_THREAD_NAME(), KAL_GET_CURRENT_THREAD_ID());
+
 #if CFG_CHIP_RESET_HANG
 	while (fgIsResetHangState == SER_L0_HANG_RST_HANG) {
 		kalMsleep(SER_L0_HANG_LOG_TIME_INTERVAL);
@@ -4381,6 +4588,8 @@ int main_thread(void *data)
 	ASSERT(prGlueInfo->prAdapter);
 
 	kalSetThreadSchPolicyPriority(prGlueInfo);
+	kalSetThreadCpuMask(
+		prGlueInfo->prAdapter->rWifiVar.u4MainThreadCpuMask);
 
 #if CFG_ENABLE_WAKE_LOCK
 	KAL_WAKE_LOCK_INIT(prGlueInfo->prAdapter,
@@ -4517,8 +4726,7 @@ int main_thread(void *data)
 #if CFG_SUPPORT_MULTITHREAD
 #else
 		/* Handle Interrupt */
-		if (test_and_clear_bit(GLUE_FLAG_INT_BIT,
-				       &prGlueInfo->ulFlag)) {
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_INT_BIT)) {
 
 			if (fgNeedHwAccess == FALSE) {
 				fgNeedHwAccess = TRUE;
@@ -4545,12 +4753,12 @@ int main_thread(void *data)
 			}
 		}
 		/* Read chip status when chip no response */
-		if (test_and_clear_bit(GLUE_FLAG_HIF_PRT_HIF_DBG_INFO_BIT,
-				       &prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo,
+					 GLUE_FLAG_HIF_PRT_HIF_DBG_INFO_BIT))
 			halPrintHifDbgInfo(prGlueInfo->prAdapter);
 
-		if (test_and_clear_bit(GLUE_FLAG_UPDATE_WMM_QUOTA,
-					&prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo,
+					 GLUE_FLAG_UPDATE_WMM_QUOTA))
 			halUpdateTxMaxQuota(prGlueInfo->prAdapter);
 #endif
 		/* transfer ioctl to OID request */
@@ -4558,8 +4766,8 @@ int main_thread(void *data)
 		testProcessOid(prGlueInfo->prAdapter);
 #endif
 		do {
-			if (test_and_clear_bit(GLUE_FLAG_OID_BIT,
-					       &prGlueInfo->ulFlag)) {
+			if (kalTestAndClearEvent(prGlueInfo,
+						 GLUE_FLAG_OID_BIT)) {
 				/* get current prIoReq */
 				prIoReq = &(prGlueInfo->OidEntry);
 				if (prIoReq->fgRead == FALSE) {
@@ -4609,8 +4817,7 @@ int main_thread(void *data)
 		testProcessTxReq(prGlueInfo->prAdapter);
 #endif
 
-		if (test_and_clear_bit(GLUE_FLAG_TXREQ_BIT,
-				       &prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_TXREQ_BIT))
 			kalProcessTxReq(prGlueInfo, &fgNeedHwAccess);
 
 #if CFG_SUPPORT_MULTITHREAD
@@ -4618,12 +4825,10 @@ int main_thread(void *data)
 #ifdef UT_TEST_MODE
 		testProcessRFBs(prGlueInfo->prAdapter);
 #endif
-		if (test_and_clear_bit(GLUE_FLAG_TX_CMD_DONE_BIT,
-				       &prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_TX_CMD_DONE_BIT))
 			wlanTxCmdDoneMthread(prGlueInfo->prAdapter);
 #endif
-		if (test_and_clear_bit(GLUE_FLAG_RX_BIT,
-					   &prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_RX_BIT))
 			nicRxProcessRFBs(prGlueInfo->prAdapter);
 
 
@@ -4643,8 +4848,7 @@ int main_thread(void *data)
 #ifdef UT_TEST_MODE
 		testTimeoutCheck(prGlueInfo->prAdapter);
 #endif
-		if (test_and_clear_bit(GLUE_FLAG_TIMEOUT_BIT,
-				       &prGlueInfo->ulFlag))
+		if (kalTestAndClearEvent(prGlueInfo, GLUE_FLAG_TIMEOUT_BIT))
 			wlanTimerTimeoutCheck(prGlueInfo->prAdapter);
 #if CFG_SUPPORT_SDIO_READ_WRITE_PATTERN
 		if (prGlueInfo->fgEnSdioTestPattern == TRUE)
@@ -4782,14 +4986,13 @@ u_int8_t kalRetrieveNetworkAddress(IN struct GLUE_INFO *prGlueInfo,
 void kalFlushPendingTxPackets(IN struct GLUE_INFO
 			      *prGlueInfo)
 {
-	struct QUE *prTxQue;
+	struct QUE rTempQue;
+	struct QUE *prTempQue = &rTempQue;
 	struct QUE_ENTRY *prQueueEntry;
 	void *prPacket;
 
 	ASSERT(prGlueInfo);
 
-	prTxQue = &(prGlueInfo->rTxQueue);
-
 	if (GLUE_GET_REF_CNT(prGlueInfo->i4TxPendingFrameNum) == 0)
 		return;
 
@@ -4798,11 +5001,14 @@ void kalFlushPendingTxPackets(IN struct GLUE_INFO
 	} else {
 		GLUE_SPIN_LOCK_DECLARATION();
 
+		GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+		QUEUE_MOVE_ALL(prTempQue, &prGlueInfo->rTxQueue);
+		GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+		QUEUE_MPSC_MOVE_ALL(prTempQue, &prGlueInfo->prTxInbox);
+
 		while (TRUE) {
-			GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
-			QUEUE_REMOVE_HEAD(prTxQue, prQueueEntry,
+			QUEUE_REMOVE_HEAD(prTempQue, prQueueEntry,
 					  struct QUE_ENTRY *);
-			GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
 
 			if (prQueueEntry == NULL)
 				break;
@@ -5253,14 +5459,67 @@ void kalTimeoutHandler(unsigned long arg)
 	ASSERT(prGlueInfo);
 
 	/* Notify tx thread  for timeout event */
-	set_bit(GLUE_FLAG_TIMEOUT_BIT, &prGlueInfo->ulFlag);
+	kalRaiseEvent(prGlueInfo, GLUE_FLAG_TIMEOUT_BIT);
 	wake_up_interruptible(&prGlueInfo->waitq);
 
 }
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Raise a GLUE_FLAG event and stamp when it started to wait
+ *
+ * \param[in] pr      Pointer to the GLUE data structure.
+ * \param[in] u4Bit   GLUE_FLAG bit number
+ *
+ * \retval (none)
+ */
+/*----------------------------------------------------------------------------*/
+void kalRaiseEvent(struct GLUE_INFO *pr, uint32_t u4Bit)
+{
+	/* keep the first raise of a pending event */
+	if (!test_bit(u4Bit, &pr->ulFlag))
+		pr->au8EventSetTime[u4Bit] = sched_clock();
+	set_bit(u4Bit, &pr->ulFlag);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Consume a GLUE_FLAG event and account its queueing delay
+ *
+ * \param[in] pr      Pointer to the GLUE data structure.
+ * \param[in] u4Bit   GLUE_FLAG bit number
+ *
+ * \retval TRUE if the event was pending
+ */
+/*----------------------------------------------------------------------------*/
+u_int8_t kalTestAndClearEvent(struct GLUE_INFO *pr, uint32_t u4Bit)
+{
+	struct GLUE_EVENT_STAT *prStat;
+	uint64_t u8SetTime, u8Time;
+
+	if (!test_and_clear_bit(u4Bit, &pr->ulFlag))
+		return FALSE;
+
+	/* raised by a path without kalRaiseEvent() */
+	u8SetTime = pr->au8EventSetTime[u4Bit];
+	if (u8SetTime == 0)
+		return TRUE;
+	pr->au8EventSetTime[u4Bit] = 0;
+
+	u8Time = sched_clock() - u8SetTime;
+	prStat = &pr->arEventDelayStat[u4Bit];
+	prStat->u4HitCnt++;
+	prStat->u8TotalTime += u8Time;
+	if (u8Time > prStat->u4MaxTime)
+		prStat->u4MaxTime = u8Time > 0xFFFFFFFF ?
+			0xFFFFFFFF : (uint32_t)u8Time;
+
+	return TRUE;
+}
+
 void kalSetEvent(struct GLUE_INFO *pr)
 {
-	set_bit(GLUE_FLAG_TXREQ_BIT, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_TXREQ_BIT);
 	wake_up_interruptible(&pr->waitq);
 }
 
@@ -5270,7 +5529,7 @@ void kalSetIntEvent(struct GLUE_INFO *pr)
 
 	/* Do not wakeup hif_thread in direct mode */
 	if (!HAL_IS_RX_DIRECT(pr->prAdapter))
-		set_bit(GLUE_FLAG_INT_BIT, &pr->ulFlag);
+		kalRaiseEvent(pr, GLUE_FLAG_INT_BIT);
 
 	/* when we got interrupt, we wake up servie thread */
 #if CFG_SUPPORT_MULTITHREAD
@@ -5285,7 +5544,7 @@ void kalSetIntEvent(struct GLUE_INFO *pr)
 
 void kalSetWmmUpdateEvent(struct GLUE_INFO *pr)
 {
-	set_bit(GLUE_FLAG_UPDATE_WMM_QUOTA, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_UPDATE_WMM_QUOTA);
 #if CFG_SUPPORT_MULTITHREAD
 	wake_up_interruptible(&pr->waitq_hif);
 #endif
@@ -5293,7 +5552,7 @@ void kalSetWmmUpdateEvent(struct GLUE_INFO *pr)
 
 void kalSetHifDbgEvent(struct GLUE_INFO *pr)
 {
-	set_bit(GLUE_FLAG_HIF_PRT_HIF_DBG_INFO_BIT, &(pr->ulFlag));
+	kalRaiseEvent(pr, GLUE_FLAG_HIF_PRT_HIF_DBG_INFO_BIT);
 #if CFG_SUPPORT_MULTITHREAD
 	wake_up_interruptible(&pr->waitq_hif);
 #endif
@@ -5309,7 +5568,7 @@ void kalSetTxEvent2Hif(struct GLUE_INFO *pr)
 			      MSEC_TO_JIFFIES(
 			      pr->prAdapter->rWifiVar.u4WakeLockThreadWakeup));
 
-	set_bit(GLUE_FLAG_HIF_TX_BIT, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_HIF_TX_BIT);
 	wake_up_interruptible(&pr->waitq_hif);
 }
 
@@ -5322,7 +5581,7 @@ void kalSetFwOwnEvent2Hif(struct GLUE_INFO *pr)
 			      MSEC_TO_JIFFIES(
 			      pr->prAdapter->rWifiVar.u4WakeLockThreadWakeup));
 
-	set_bit(GLUE_FLAG_HIF_FW_OWN_BIT, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_HIF_FW_OWN_BIT);
 	wake_up_interruptible(&pr->waitq_hif);
 }
 
@@ -5335,7 +5594,7 @@ void kalSetTxEvent2Rx(struct GLUE_INFO *pr)
 			      MSEC_TO_JIFFIES(
 			      pr->prAdapter->rWifiVar.u4WakeLockThreadWakeup));
 
-	set_bit(GLUE_FLAG_RX_TO_OS_BIT, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_RX_TO_OS_BIT);
 	wake_up_interruptible(&pr->waitq_rx);
 }
 
@@ -5348,27 +5607,46 @@ void kalSetTxCmdEvent2Hif(struct GLUE_INFO *pr)
 			      MSEC_TO_JIFFIES(
 			      pr->prAdapter->rWifiVar.u4WakeLockThreadWakeup));
 
-	set_bit(GLUE_FLAG_HIF_TX_CMD_BIT, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_HIF_TX_CMD_BIT);
 	wake_up_interruptible(&pr->waitq_hif);
 }
 
 void kalSetTxCmdDoneEvent(struct GLUE_INFO *pr)
 {
 	/* do we need wake lock here */
-	set_bit(GLUE_FLAG_TX_CMD_DONE_BIT, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_TX_CMD_DONE_BIT);
 	wake_up_interruptible(&pr->waitq);
 }
 
 void kalSetRxProcessEvent(struct GLUE_INFO *pr)
 {
+	struct RX_CTRL *prRxCtrl = &pr->prAdapter->rRxCtrl;
+
+	/* Data RFBs are processed by rx_thread */
+	if (QUEUE_IS_NOT_EMPTY(&prRxCtrl->rReceivedDataRfbList)) {
+		kalRaiseEvent(pr, GLUE_FLAG_RX_DATA_BIT);
+		wake_up_interruptible(&pr->waitq_rx);
+	}
+
 	/* Do not wakeup target if there is nothing waiting */
-	if (QUEUE_IS_EMPTY(&pr->prAdapter->rRxCtrl.rReceivedRfbList))
+	if (QUEUE_IS_EMPTY(&prRxCtrl->rReceivedRfbList))
 		return;
 
 	/* do we need wake lock here ? */
-	set_bit(GLUE_FLAG_RX_BIT, &pr->ulFlag);
+	kalRaiseEvent(pr, GLUE_FLAG_RX_BIT);
 	wake_up_interruptible(&pr->waitq);
 }
+
+void kalSetTxDataEvent(struct GLUE_INFO *pr)
+{
+	if (!pr->tx_thread) {
+		kalSetEvent(pr);
+		return;
+	}
+
+	kalRaiseEvent(pr, GLUE_FLAG_TX_DATA_BIT);
+	wake_up_interruptible(&pr->waitq_tx);
+}
 #endif
 /*----------------------------------------------------------------------------*/
 /*!
@@ -10291,6 +10569,7 @@ static int kalNapiPollSwRfb(struct napi_struct *napi, int budget)
 	if (GLUE_INC_REF_CNT(i4UserCnt) > 1)
 		goto end;
 
+	nicRxBeginReturnBatch(prGlueInfo->prAdapter);
 	while (KAL_FIFO_OUT(&prGlueInfo->rRxKfifoQ, prSwRfb)) {
 		if (!prSwRfb) {
 			DBGLOG(RX, ERROR, "prSwRfb null\n");
@@ -10300,6 +10579,7 @@ static int kalNapiPollSwRfb(struct napi_struct *napi, int budget)
 		nicRxProcessPacketType(prGlueInfo->prAdapter, prSwRfb);
 		work_done++;
 	}
+	nicRxEndReturnBatch(prGlueInfo->prAdapter);
 	/* Set max work_done budget */
 	if (work_done > budget)
 		work_done = budget;
@@ -10652,6 +10932,34 @@ void kalSetThreadSchPolicyPriority(IN struct GLUE_INFO *prGlueInfo)
 	set_user_nice(current, prGlueInfo->prAdapter->rWifiVar.cThreadNice);
 }
 
+void kalSetThreadCpuMask(IN uint32_t u4CpuMask)
+{
+	cpumask_var_t rCpuMask;
+	uint32_t u4Cpu;
+
+	/* 0 keeps the default affinity */
+	if (u4CpuMask == 0)
+		return;
+
+	if (!zalloc_cpumask_var(&rCpuMask, GFP_KERNEL))
+		return;
+
+	for (u4Cpu = 0; u4Cpu < 32 && u4Cpu < nr_cpu_ids; u4Cpu++) {
+		if (u4CpuMask & BIT(u4Cpu))
+			cpumask_set_cpu(u4Cpu, rCpuMask);
+	}
+
+	if (cpumask_empty(rCpuMask) ||
+	    set_cpus_allowed_ptr(current, rCpuMask) != 0)
+		DBGLOG(INIT, WARN, "[%s]Set cpu mask 0x%x failed\n",
+			KAL_GET_CURRENT_THREAD_NAME(), u4CpuMask);
+	else
+		DBGLOG(INIT, STATE, "[%s]Set cpu mask 0x%x\n",
+			KAL_GET_CURRENT_THREAD_NAME(), u4CpuMask);
+
+	free_cpumask_var(rCpuMask);
+}
+
 #if CFG_SUPPORT_ROAMING
 void kalIndicateCqmRssiNotify(struct net_device *dev,
 			      enum nl80211_cqm_rssi_threshold_event rssi_event,
@@ -1189,6 +1189,8 @@ nanHardStartXmit(IN struct sk_buff *prSkb, IN struct net_device *prDev)
 #endif
 
 	kalResetPacket(prGlueInfo, (void *)prSkb);
+	if (KAL_IS_PKT_XMIT_MORE(prSkb))
+		GLUE_SET_PKT_FLAG(prSkb, ENUM_PKT_XMIT_MORE);
 
 	kalHardStartXmit(prSkb, prDev, prGlueInfo, ucBssIndex);
 
@@ -1945,6 +1945,8 @@ netdev_tx_t p2pHardStartXmit(IN struct sk_buff *prSkb, IN struct net_device *prD
 	ucBssIndex = prNetDevPrivate->ucBssIdx;
 
 	kalResetPacket(prGlueInfo, (void *) prSkb);
+	if (KAL_IS_PKT_XMIT_MORE(prSkb))
+		GLUE_SET_PKT_FLAG(prSkb, ENUM_PKT_XMIT_MORE);
 
 	kalHardStartXmit(prSkb, prDev, prGlueInfo, ucBssIndex);
 	prP2pBssInfo = GET_BSS_INFO_BY_INDEX(prGlueInfo->prAdapter, ucBssIndex);
@@ -93,6 +93,9 @@
 #define PROC_RX_STATISTICS                      "rx_statistics"
 #define PROC_TX_STATISTICS                      "tx_statistics"
 #define PROC_DBG_LEVEL_NAME                     "dbgLevel"
+#if CFG_SUPPORT_DBG_TRACE_RING
+#define PROC_DBG_TRACE_NAME			"dbg_trace"
+#endif
 #define PROC_DRIVER_CMD                         "driver"
 #define PROC_CFG                                "cfg"
 #define PROC_EFUSE_DUMP                         "efuse_dump"
@@ -109,10 +112,15 @@
 #endif
 #if CFG_SUPPORT_CSI
 #define PROC_CSI_DATA_NAME                     "csi_data"
+#define PROC_CSI_RING_NAME                     "csi_ring"
 #endif
 #if CFG_SUPPORT_PROC_GET_WAKEUP_REASON
 #define PROC_WAKEUP_REASON			"wakeup_reason"
 #endif
+#define PROC_EVENT_STAT				"event_stat"
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+#define PROC_TX_LATENCY				"tx_latency"
+#endif
 
 #define PROC_MCR_ACCESS_MAX_USER_INPUT_LEN      20
 #define PROC_RX_STATISTICS_MAX_USER_INPUT_LEN   10
@@ -381,7 +389,6 @@ static ssize_t procCSIDataPrepare(
 	return i4Pos;
 }
 
-struct CSI_DATA_T rTmpCSIData;
 static ssize_t procCSIDataRead(struct file *filp,
 	char __user *buf, size_t count, loff_t *f_pos)
 {
@@ -389,26 +396,34 @@ static ssize_t procCSIDataRead(struct file *filp,
 	uint32_t u4CopySize = 0;
 	uint32_t u4StartIdx = 0;
 	int32_t i4Pos = 0;
+	struct ADAPTER *prAdapter;
 	struct CSI_INFO_T *prCSIInfo = NULL;
+	struct CSI_DATA_T *prCSIData;
 
 	if (g_prGlueInfo_proc && g_prGlueInfo_proc->prAdapter)
-		prCSIInfo = &(g_prGlueInfo_proc->prAdapter->rCSIInfo);
+		prAdapter = g_prGlueInfo_proc->prAdapter;
 	else
 		return 0;
+	prCSIInfo = &(prAdapter->rCSIInfo);
 
 	if (prCSIInfo->bIncomplete == FALSE) {
 
 		wait_event_interruptible(prCSIInfo->waitq,
-			prCSIInfo->u4CSIBufferUsed != 0);
+			prCSIInfo->u4CSIBufferHead !=
+			READ_ONCE(prCSIInfo->u4CSIBufferTail));
 
 		/*
 		 * No older CSI data in buffer waiting for reading out,
 		 * so prepare a new one for reading.
 		 */
-		if (wlanPopCSIData(g_prGlueInfo_proc->prAdapter,
-			&rTmpCSIData))
+		KAL_ACQUIRE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+		prCSIData = wlanCSIRingPeek(prAdapter);
+		if (prCSIData) {
 			i4Pos = procCSIDataPrepare(temp,
-				prCSIInfo, &rTmpCSIData);
+				prCSIInfo, prCSIData);
+			wlanCSIRingConsume(prAdapter);
+		}
+		KAL_RELEASE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
 
 		/* The frist run of reading the CSI data */
 		u4StartIdx = 0;
@@ -453,6 +468,87 @@ static ssize_t procCSIDataRead(struct file *filp,
 
 	return (ssize_t)u4CopySize;
 }
+
+/*
+ * Bulk binary read of the CSI ring: as many whole records
+ * (struct CSI_EXPORT_HDR + struct CSI_DATA_T) as fit in count are
+ * copied straight from the ring slots, without any formatting.
+ */
+static ssize_t procCSIRingRead(struct file *filp,
+	char __user *buf, size_t count, loff_t *f_pos)
+{
+	struct ADAPTER *prAdapter;
+	struct CSI_INFO_T *prCSIInfo;
+	struct CSI_DATA_T *prCSIData;
+	struct CSI_EXPORT_HDR rHdr;
+	const size_t u4RecSize = sizeof(rHdr) + sizeof(struct CSI_DATA_T);
+	size_t u4CopySize = 0;
+
+	if (g_prGlueInfo_proc && g_prGlueInfo_proc->prAdapter)
+		prAdapter = g_prGlueInfo_proc->prAdapter;
+	else
+		return 0;
+	prCSIInfo = &(prAdapter->rCSIInfo);
+
+	if (count < u4RecSize)
+		return -EINVAL;
+
+	if (prCSIInfo->u4CSIBufferHead ==
+	    READ_ONCE(prCSIInfo->u4CSIBufferTail)) {
+		if (filp->f_flags & O_NONBLOCK)
+			return -EAGAIN;
+		if (wait_event_interruptible(prCSIInfo->waitq,
+			prCSIInfo->u4CSIBufferHead !=
+			READ_ONCE(prCSIInfo->u4CSIBufferTail)))
+			return -ERESTARTSYS;
+	}
+
+	rHdr.ucMagic = CSI_EXPORT_MAGIC;
+	rHdr.ucVer = CSI_EXPORT_VER;
+	rHdr.u2HdrLen = sizeof(rHdr);
+	rHdr.u4RecLen = sizeof(struct CSI_DATA_T);
+
+	KAL_ACQUIRE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+	while (count - u4CopySize >= u4RecSize) {
+		prCSIData = wlanCSIRingPeek(prAdapter);
+		if (!prCSIData)
+			break;
+
+		rHdr.u4Seq = prCSIData->u4Seq;
+		rHdr.u4DropCnt = READ_ONCE(prCSIInfo->u4CSIDropCnt);
+		if (copy_to_user(buf + u4CopySize, &rHdr, sizeof(rHdr)) ||
+		    copy_to_user(buf + u4CopySize + sizeof(rHdr), prCSIData,
+				 sizeof(struct CSI_DATA_T))) {
+			KAL_RELEASE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+			DBGLOG(INIT, ERROR, "[CSI] copy to user failed\n");
+			return u4CopySize ? (ssize_t)u4CopySize : -EFAULT;
+		}
+		wlanCSIRingConsume(prAdapter);
+		u4CopySize += u4RecSize;
+	}
+	KAL_RELEASE_MUTEX(prAdapter, MUTEX_CSI_BUFFER);
+
+	*f_pos += u4CopySize;
+
+	return (ssize_t)u4CopySize;
+}
+
+static unsigned int procCSIRingPoll(struct file *filp, poll_table *wait)
+{
+	struct CSI_INFO_T *prCSIInfo;
+	unsigned int mask = 0;
+
+	if (!g_prGlueInfo_proc || !g_prGlueInfo_proc->prAdapter)
+		return POLLERR;
+	prCSIInfo = &(g_prGlueInfo_proc->prAdapter->rCSIInfo);
+
+	poll_wait(filp, &prCSIInfo->waitq, wait);
+	if (prCSIInfo->u4CSIBufferHead !=
+	    READ_ONCE(prCSIInfo->u4CSIBufferTail))
+		mask |= POLLIN | POLLRDNORM;
+
+	return mask;
+}
 #endif
 
 
@@ -604,6 +700,12 @@ static DEFINE_PROC_OPS_STRUCT(csidata_ops) = {
 	DEFINE_PROC_OPS_OPEN(procCSIDataOpen)
 	DEFINE_PROC_OPS_RELEASE(procCSIDataRelease)
 };
+
+static DEFINE_PROC_OPS_STRUCT(csiring_ops) = {
+	DEFINE_PROC_OPS_OWNER(THIS_MODULE)
+	DEFINE_PROC_OPS_READ(procCSIRingRead)
+	DEFINE_PROC_OPS_POLL(procCSIRingPoll)
+};
 #endif
 
 #if WLAN_INCLUDE_PROC
@@ -1504,12 +1606,304 @@ static DEFINE_PROC_OPS_STRUCT(wakeup_reason_ops) = {
 };
 #endif
 
+static void procEventStatShowTbl(struct seq_file *s, const char *pucName,
+				 struct RX_EVENT_STAT *prStat)
+{
+	uint32_t u4Idx;
+
+	for (u4Idx = 0; u4Idx < RX_EVENT_ID_NUM; u4Idx++, prStat++) {
+		if (!prStat->u4HitCnt)
+			continue;
+		seq_printf(s, "%s 0x%02X %10u %10llu %10u %14llu\n",
+			   pucName, u4Idx, prStat->u4HitCnt,
+			   div_u64(div_u64(prStat->u8TotalTime, NSEC_PER_USEC),
+				   prStat->u4HitCnt),
+			   prStat->u4MaxTime / NSEC_PER_USEC,
+			   div_u64(prStat->u8TotalTime, NSEC_PER_USEC));
+	}
+}
+
+static void procMboxMsgStatShowTbl(struct seq_file *s,
+				   struct MBOX_MSG_STAT *prStat)
+{
+	uint32_t u4Idx;
+
+	for (u4Idx = 0; u4Idx < MID_TOTAL_NUM; u4Idx++, prStat++) {
+		if (prStat->u4HitCnt == 0)
+			continue;
+		seq_printf(s, "MSG 0x%02X %10u %10llu %10u %14llu\n",
+			   u4Idx, prStat->u4HitCnt,
+			   div_u64(div_u64(prStat->u8TotalTime, NSEC_PER_USEC),
+				   prStat->u4HitCnt),
+			   prStat->u4MaxTime / NSEC_PER_USEC,
+			   div_u64(prStat->u8TotalTime, NSEC_PER_USEC));
+	}
+}
+
+static void procEventDelayStatShowTbl(struct seq_file *s,
+				     struct GLUE_EVENT_STAT *prStat)
+{
+	uint32_t u4Idx;
+
+	/* EID is the GLUE_FLAG bit, time is raise to handler entry */
+	for (u4Idx = 0; u4Idx < GLUE_FLAG_BIT_NUM; u4Idx++, prStat++) {
+		if (prStat->u4HitCnt == 0)
+			continue;
+		seq_printf(s, "FLG 0x%02X %10u %10llu %10u %14llu\n",
+			   u4Idx, prStat->u4HitCnt,
+			   div_u64(div_u64(prStat->u8TotalTime, NSEC_PER_USEC),
+				   prStat->u4HitCnt),
+			   prStat->u4MaxTime / NSEC_PER_USEC,
+			   div_u64(prStat->u8TotalTime, NSEC_PER_USEC));
+	}
+}
+
+static int procEventStatShow(struct seq_file *s, void *v)
+{
+	struct GLUE_INFO *prGlueInfo = g_prGlueInfo_proc;
+	struct RX_CTRL *prRxCtrl;
+
+	if (!prGlueInfo || !prGlueInfo->prAdapter) {
+		seq_puts(s, "prGlueInfo is null\n");
+		return 0;
+	}
+	prRxCtrl = &prGlueInfo->prAdapter->rRxCtrl;
+
+	seq_printf(s, "%-3s %-4s %10s %10s %10s %14s\n",
+		   "TYP", "EID", "HIT", "AVG(us)", "MAX(us)", "TOTAL(us)");
+	procEventStatShowTbl(s, "EVT", prRxCtrl->arEventStat);
+	procEventStatShowTbl(s, "UNI", prRxCtrl->arUniEventStat);
+	procMboxMsgStatShowTbl(s, prGlueInfo->prAdapter->arMboxMsgStat);
+	procEventDelayStatShowTbl(s, prGlueInfo->arEventDelayStat);
+
+	return 0;
+}
+
+static int procEventStatOpen(struct inode *inode, struct file *file)
+{
+	return single_open(file, procEventStatShow, NULL);
+}
+
+static ssize_t procEventStatWrite(struct file *file, const char __user *buffer,
+				  size_t count, loff_t *data)
+{
+	struct GLUE_INFO *prGlueInfo = g_prGlueInfo_proc;
+	struct RX_CTRL *prRxCtrl;
+
+	if (!prGlueInfo || !prGlueInfo->prAdapter)
+		return -EFAULT;
+	prRxCtrl = &prGlueInfo->prAdapter->rRxCtrl;
+
+	/* any write clears the statistics */
+	kalMemZero(prRxCtrl->arEventStat, sizeof(prRxCtrl->arEventStat));
+	kalMemZero(prRxCtrl->arUniEventStat,
+		   sizeof(prRxCtrl->arUniEventStat));
+	kalMemZero(prGlueInfo->prAdapter->arMboxMsgStat,
+		   sizeof(prGlueInfo->prAdapter->arMboxMsgStat));
+	kalMemZero(prGlueInfo->arEventDelayStat,
+		   sizeof(prGlueInfo->arEventDelayStat));
+
+	return count;
+}
+
+static DEFINE_PROC_OPS_STRUCT(event_stat_ops) = {
+	DEFINE_PROC_OPS_OWNER(THIS_MODULE)
+	DEFINE_PROC_OPS_OPEN(procEventStatOpen)
+	DEFINE_PROC_OPS_READ(seq_read)
+	DEFINE_PROC_OPS_WRITE(procEventStatWrite)
+	DEFINE_PROC_OPS_LSEEK(seq_lseek)
+	DEFINE_PROC_OPS_RELEASE(single_release)
+};
+
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+static const char * const apucTxLatStageName[TX_LAT_STAGE_NUM] = {
+	"os_to_enque",
+	"enque_to_deque",
+	"deque_to_hif",
+	"hif_to_free",
+	"total"
+};
+
+static int procTxLatencyShow(struct seq_file *s, void *v)
+{
+	struct GLUE_INFO *prGlueInfo = g_prGlueInfo_proc;
+	struct TX_LAT_STATS *prLatStats;
+	struct TX_LAT_HIST *prHist;
+#if CFG_SUPPORT_MULTITHREAD && !CFG_FIX_2_TX_PORT && CFG_TX_PORT_QUE_LOCK_STAT
+	struct TX_PORT_QUE_STAT *prPortStat;
+#endif
+	uint64_t u8Duration, u8Pps = 0;
+	uint32_t u4Stage;
+
+	if (!prGlueInfo || !prGlueInfo->prAdapter) {
+		seq_puts(s, "{}\n");
+		return 0;
+	}
+	prLatStats = &prGlueInfo->prAdapter->rTxCtrl.rLatStats;
+
+	u8Duration = prLatStats->u8LastFreeTime - prLatStats->u8FirstFreeTime;
+	if (u8Duration)
+		u8Pps = div64_u64((uint64_t)
+			prLatStats->arHist[TX_LAT_STAGE_TOTAL].u4Count *
+			NSEC_PER_SEC, u8Duration);
+
+	seq_printf(s, "{\"duration_ns\":%llu,\"pps\":%llu,\"stages\":{",
+		   u8Duration, u8Pps);
+	for (u4Stage = 0; u4Stage < TX_LAT_STAGE_NUM; u4Stage++) {
+		prHist = &prLatStats->arHist[u4Stage];
+		seq_printf(s, "%s\"%s\":{\"count\":%u,\"avg_ns\":%llu,",
+			   u4Stage ? "," : "", apucTxLatStageName[u4Stage],
+			   prHist->u4Count,
+			   prHist->u4Count ?
+			   div_u64(prHist->u8TotalTime, prHist->u4Count) : 0);
+		seq_printf(s,
+			   "\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,",
+			   wlanTxLatGetPercentile(prHist, 500),
+			   wlanTxLatGetPercentile(prHist, 990),
+			   wlanTxLatGetPercentile(prHist, 999));
+		seq_printf(s, "\"max_ns\":%llu}", prHist->u8MaxTime);
+	}
+	seq_puts(s, "}");
+
+#if CFG_SUPPORT_MULTITHREAD && !CFG_FIX_2_TX_PORT && CFG_TX_PORT_QUE_LOCK_STAT
+	seq_puts(s, ",\"port_que_lock\":[");
+	for (u4Stage = 0; u4Stage < TX_PORT_NUM; u4Stage++) {
+		prPortStat = &prGlueInfo->prAdapter->arTxPQueueStat[u4Stage];
+		seq_printf(s,
+			   "%s{\"hold\":%u,\"avg_ns\":%llu,\"max_ns\":%u}",
+			   u4Stage ? "," : "", prPortStat->u4HoldCnt,
+			   prPortStat->u4HoldCnt ?
+			   div_u64(prPortStat->u8TotalHoldTime,
+				   prPortStat->u4HoldCnt) : 0,
+			   prPortStat->u4MaxHoldTime);
+	}
+	seq_puts(s, "]");
+#endif
+	seq_puts(s, "}\n");
+
+	return 0;
+}
+
+static int procTxLatencyOpen(struct inode *inode, struct file *file)
+{
+	return single_open(file, procTxLatencyShow, NULL);
+}
+
+static ssize_t procTxLatencyWrite(struct file *file, const char __user *buffer,
+				  size_t count, loff_t *data)
+{
+	struct GLUE_INFO *prGlueInfo = g_prGlueInfo_proc;
+#if CFG_SUPPORT_MULTITHREAD && !CFG_FIX_2_TX_PORT && CFG_TX_PORT_QUE_LOCK_STAT
+	struct TX_PORT_QUE_STAT *prPortStat;
+	uint32_t u4Port;
+#endif
+
+	if (!prGlueInfo || !prGlueInfo->prAdapter)
+		return -EFAULT;
+
+	/* any write clears the histograms */
+	wlanTxLatReset(prGlueInfo->prAdapter);
+#if CFG_SUPPORT_MULTITHREAD && !CFG_FIX_2_TX_PORT && CFG_TX_PORT_QUE_LOCK_STAT
+	/* keep u8LockTime, a port queue lock may be held right now */
+	for (u4Port = 0; u4Port < TX_PORT_NUM; u4Port++) {
+		prPortStat = &prGlueInfo->prAdapter->arTxPQueueStat[u4Port];
+		prPortStat->u4HoldCnt = 0;
+		prPortStat->u4MaxHoldTime = 0;
+		prPortStat->u8TotalHoldTime = 0;
+	}
+#endif
+
+	return count;
+}
+
+static DEFINE_PROC_OPS_STRUCT(tx_latency_ops) = {
+	DEFINE_PROC_OPS_OWNER(THIS_MODULE)
+	DEFINE_PROC_OPS_OPEN(procTxLatencyOpen)
+	DEFINE_PROC_OPS_READ(seq_read)
+	DEFINE_PROC_OPS_WRITE(procTxLatencyWrite)
+	DEFINE_PROC_OPS_LSEEK(seq_lseek)
+	DEFINE_PROC_OPS_RELEASE(single_release)
+};
+#endif
+
 static DEFINE_PROC_OPS_STRUCT(dbglevel_ops) = {
 	DEFINE_PROC_OPS_OWNER(THIS_MODULE)
 	DEFINE_PROC_OPS_READ(procDbgLevelRead)
 	DEFINE_PROC_OPS_WRITE(procDbgLevelWrite)
 };
 
+#if CFG_SUPPORT_DBG_TRACE_RING
+static int procDbgTraceShow(struct seq_file *s, void *v)
+{
+	struct DBG_TRACE_REC rRec;
+	char acLine[256];
+	uint32_t u4Cpu, u4Idx, u4End, u4NSec;
+	uint64_t u8Sec;
+
+	seq_printf(s, "mode: %s\n", fgDbgTraceBinary ? "binary" : "text");
+
+	/* records are formatted here, not in the DBGTRACE caller */
+	for (u4Cpu = 0; u4Cpu < nr_cpu_ids; u4Cpu++) {
+		u4End = wlanDbgTraceGetWriteIdx(u4Cpu);
+		u4Idx = u4End > DBG_TRACE_RING_SIZE ?
+			u4End - DBG_TRACE_RING_SIZE : 0;
+		for (; u4Idx != u4End; u4Idx++) {
+			if (!wlanDbgTraceRead(u4Cpu, u4Idx, &rRec))
+				continue;
+			bstr_printf(acLine, sizeof(acLine), rRec.pucFmt,
+				    rRec.au4Arg);
+			u8Sec = div_u64_rem(rRec.u8Time, NSEC_PER_SEC,
+					    &u4NSec);
+			seq_printf(s, "[%5llu.%06u] cpu%u [%u]%s:%s",
+				   u8Sec, u4NSec / NSEC_PER_USEC, u4Cpu,
+				   rRec.u4Tid, rRec.pucFunc, acLine);
+		}
+	}
+
+	return 0;
+}
+
+static int procDbgTraceOpen(struct inode *inode, struct file *file)
+{
+	return single_open(file, procDbgTraceShow, NULL);
+}
+
+static ssize_t procDbgTraceWrite(struct file *file, const char __user *buffer,
+				 size_t count, loff_t *data)
+{
+	uint32_t u4CopySize = sizeof(g_aucProcBuf);
+	uint32_t u4Mode = 0;
+
+	kalMemSet(g_aucProcBuf, 0, u4CopySize);
+	u4CopySize = (count < u4CopySize) ? count : (u4CopySize - 1);
+
+	if (copy_from_user(g_aucProcBuf, buffer, u4CopySize)) {
+		pr_err("error of copy from user\n");
+		return -EFAULT;
+	}
+	g_aucProcBuf[u4CopySize] = '\0';
+
+	/* 0: DBGTRACE prints as DBGLOG_LIMITED, 1: binary ring */
+	if (kalkStrtou32(strim((char *)g_aucProcBuf), 0, &u4Mode))
+		return -EINVAL;
+
+	if (wlanDbgTraceSetMode(u4Mode ? TRUE : FALSE) !=
+	    WLAN_STATUS_SUCCESS)
+		return -ENOMEM;
+
+	return count;
+}
+
+static DEFINE_PROC_OPS_STRUCT(dbg_trace_ops) = {
+	DEFINE_PROC_OPS_OWNER(THIS_MODULE)
+	DEFINE_PROC_OPS_OPEN(procDbgTraceOpen)
+	DEFINE_PROC_OPS_READ(seq_read)
+	DEFINE_PROC_OPS_WRITE(procDbgTraceWrite)
+	DEFINE_PROC_OPS_LSEEK(seq_lseek)
+	DEFINE_PROC_OPS_RELEASE(single_release)
+};
+#endif
+
 #if CFG_ASSERT_DUMP
 DEFINE_PROC_OPS_STRUCT(coredump_ops) = {
 	DEFINE_PROC_OPS_OWNER(THIS_MODULE)
@@ -2156,6 +2550,17 @@ int32_t procInitFs(void)
 	proc_set_user(prEntry, KUIDT_INIT(PROC_UID_SHELL),
 		      KGIDT_INIT(PROC_GID_WIFI));
 
+#if CFG_SUPPORT_DBG_TRACE_RING
+	prEntry =
+	    proc_create(PROC_DBG_TRACE_NAME, 0664, gprProcRoot, &dbg_trace_ops);
+	if (prEntry == NULL) {
+		pr_err("Unable to create /proc entry dbg_trace\n");
+		return -1;
+	}
+	proc_set_user(prEntry, KUIDT_INIT(PROC_UID_SHELL),
+		      KGIDT_INIT(PROC_GID_WIFI));
+#endif
+
 #if (CFG_SUPPORT_PERMON == 1)
 	prEntry =
 	    proc_create(PROC_AUTO_PERF_CFG, 0664, gprProcRoot, &auto_perf_ops);
@@ -2178,6 +2583,9 @@ int32_t procUninitProcFs(void)
 	remove_proc_subtree(PROC_AUTO_PERF_CFG, gprProcRoot);
 #endif
 	remove_proc_subtree(PROC_DBG_LEVEL_NAME, gprProcRoot);
+#if CFG_SUPPORT_DBG_TRACE_RING
+	remove_proc_subtree(PROC_DBG_TRACE_NAME, gprProcRoot);
+#endif
 
 	/*
 	 * move PROC_ROOT_NAME to last since it's root directory of the others
@@ -2189,6 +2597,9 @@ int32_t procUninitProcFs(void)
 	remove_proc_entry(PROC_AUTO_PERF_CFG, gprProcRoot);
 #endif
 	remove_proc_entry(PROC_DBG_LEVEL_NAME, gprProcRoot);
+#if CFG_SUPPORT_DBG_TRACE_RING
+	remove_proc_entry(PROC_DBG_TRACE_NAME, gprProcRoot);
+#endif
 
 	/*
 	 * move PROC_ROOT_NAME to last since it's root directory of the others
@@ -2231,11 +2642,16 @@ int32_t procRemoveProcfs(void)
 #endif
 #if CFG_SUPPORT_CSI
 	remove_proc_entry(PROC_CSI_DATA_NAME, gprProcRoot);
+	remove_proc_entry(PROC_CSI_RING_NAME, gprProcRoot);
 #endif
 #if CFG_SUPPORT_PROC_GET_WAKEUP_REASON
 	remove_proc_entry(PROC_WAKEUP_REASON, gprProcRoot);
 #endif
 	remove_proc_entry(PROC_COUNTRY, gprProcRoot);
+	remove_proc_entry(PROC_EVENT_STAT, gprProcRoot);
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+	remove_proc_entry(PROC_TX_LATENCY, gprProcRoot);
+#endif
 	g_prGlueInfo_proc = NULL;
 	return 0;
 } /* end of procRemoveProcfs() */
@@ -2287,6 +2703,22 @@ int32_t procCreateFsEntry(struct GLUE_INFO *prGlueInfo)
 		DBGLOG(INIT, ERROR, "Unable to create /proc entry country\n");
 		return -1;
 	}
+	prEntry = proc_create(PROC_EVENT_STAT, 0664, gprProcRoot,
+			      &event_stat_ops);
+	if (prEntry == NULL) {
+		DBGLOG(INIT, ERROR,
+		       "Unable to create /proc entry event_stat\n");
+		return -1;
+	}
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+	prEntry = proc_create(PROC_TX_LATENCY, 0664, gprProcRoot,
+			      &tx_latency_ops);
+	if (prEntry == NULL) {
+		DBGLOG(INIT, ERROR,
+		       "Unable to create /proc entry tx_latency\n");
+		return -1;
+	}
+#endif
 
 #if	CFG_SUPPORT_EASY_DEBUG
 
@@ -2338,6 +2770,13 @@ int32_t procCreateFsEntry(struct GLUE_INFO *prGlueInfo)
 			"[CSI] Unable to create /proc entry csidata\n");
 		return -1;
 	}
+	prEntry = proc_create(PROC_CSI_RING_NAME, 0664, gprProcRoot,
+			      &csiring_ops);
+	if (prEntry == NULL) {
+		DBGLOG(INIT, ERROR,
+			"[CSI] Unable to create /proc entry csi_ring\n");
+		return -1;
+	}
 #endif
 
 #if CFG_SUPPORT_PROC_GET_WAKEUP_REASON
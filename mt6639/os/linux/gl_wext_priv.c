@@ -3426,6 +3426,7 @@ reqExtSetAcpiDevicePowerState(IN struct GLUE_INFO
 #define CMD_SET_FW_LOG		"SET_FWLOG"
 #define CMD_GET_QUE_INFO	"GET_QUE"
 #define CMD_GET_MEM_INFO	"GET_MEM"
+#define CMD_GET_TIMER_INFO	"GET_TIMER"
 #define CMD_GET_HIF_INFO	"GET_HIF"
 #define CMD_GET_TP_INFO		"GET_TP"
 #define CMD_GET_STA_KEEP_CNT    "KEEPCOUNTER"
@@ -13584,6 +13585,18 @@ static int priv_driver_get_mem_info(IN struct net_device *prNetDev,
 				   i4TotalLen);
 }
 
+static int priv_driver_get_timer_info(IN struct net_device *prNetDev,
+				      IN char *pcCommand, IN int i4TotalLen)
+{
+	struct GLUE_INFO *prGlueInfo = NULL;
+
+	ASSERT(prNetDev);
+	prGlueInfo = *((struct GLUE_INFO **) netdev_priv(prNetDev));
+
+	return cnmTimerDumpStatus(prGlueInfo->prAdapter, pcCommand,
+				  i4TotalLen);
+}
+
 static int priv_driver_get_hif_info(IN struct net_device *prNetDev,
 				    IN char *pcCommand, IN int i4TotalLen)
 {
@@ -17186,6 +17199,7 @@ struct PRIV_CMD_HANDLER priv_cmd_handlers[] = {
 #endif /*CFG_SUPPORT_DBDC*/
 	{CMD_GET_QUE_INFO, priv_driver_get_que_info},
 	{CMD_GET_MEM_INFO, priv_driver_get_mem_info},
+	{CMD_GET_TIMER_INFO, priv_driver_get_timer_info},
 	{CMD_GET_HIF_INFO, priv_driver_get_hif_info},
 #if (CFG_SUPPORT_PERMON == 1)
 	{CMD_GET_TP_INFO, priv_driver_get_tp_info},
@@ -21291,9 +21305,7 @@ priv_driver_set_csi(IN struct net_device *prNetDev,
 		prCSIInfo->bIncomplete = FALSE;
 		prCSIInfo->u4CopiedDataSize = 0;
 		prCSIInfo->u4RemainingDataSize = 0;
-		prCSIInfo->u4CSIBufferHead = 0;
-		prCSIInfo->u4CSIBufferTail = 0;
-		prCSIInfo->u4CSIBufferUsed = 0;
+		wlanCSIRingFlush(prGlueInfo->prAdapter);
 		goto send_cmd;
 	}
 
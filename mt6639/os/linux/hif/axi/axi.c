@@ -809,6 +809,7 @@ void glSetHifInfo(struct GLUE_INFO *prGlueInfo, unsigned long ulCookie)
 	INIT_LIST_HEAD(&prHif->rTxCmdQ);
 	INIT_LIST_HEAD(&prHif->rTxDataQ);
 	prHif->u4TxDataQLen = 0;
+	kalDevTxAmsduInit(prGlueInfo);
 
 	prHif->fgIsPowerOff = true;
 	prHif->fgIsDumpLog = false;
@@ -885,6 +886,7 @@ void glClearHifInfo(struct GLUE_INFO *prGlueInfo)
 		kfree(prTxCmdReq);
 	}
 
+	kalDevTxAmsduUninit(prGlueInfo);
 	list_for_each_safe(prCur, prNext, &prHifInfo->rTxDataQ) {
 		prTxDataReq = list_entry(prCur, struct TX_DATA_REQ, list);
 		list_del(prCur);
@@ -131,6 +131,8 @@ struct HIF_MEM_OPS {
 			    struct RTMP_DMABUF *prDmaBuf,
 			    uint32_t u4Num, uint32_t u4Idx);
 	void *(*allocRuntimeMem)(uint32_t u4SrcLen);
+	void *(*allocRxPacket)(struct GL_HIF_INFO *prHifInfo,
+			       uint32_t u4Size, uint8_t **ppucData);
 	bool (*copyCmd)(struct GL_HIF_INFO *prHifInfo,
 			struct RTMP_DMACB *prTxCell, void *pucBuf,
 			void *pucSrc1, uint32_t u4SrcLen1,
@@ -209,6 +211,10 @@ struct GL_HIF_INFO {
 	struct list_head rTxCmdQ;
 	struct list_head rTxDataQ;
 	uint32_t u4TxDataQLen;
+	struct TX_AMSDU_BUCKET *prTxAmsduBucket;	/* [STA][TID] */
+	struct list_head rTxAmsduOpenQ;
+	/* nesting of TX doorbell bursts, by halWpdmaTxBurstSlot() */
+	int32_t ai4TxBurstDepth[HIF_TX_BURST_SLOT_NUM];
 
 	bool fgIsPowerOff;
 	bool fgIsDumpLog;
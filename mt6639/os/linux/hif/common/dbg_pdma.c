@@ -252,6 +252,14 @@ uint32_t halDumpHifStatus(IN struct ADAPTER *prAdapter,
 			u4Idx, u4MaxCnt, prTxRing->TxCpuIdx,
 			u4CpuIdx, prTxRing->TxDmaIdx,
 			u4DmaIdx, prTxRing->TxSwUsedIdx, prTxRing->u4UsedCnt);
+		if (prTxRing->u4DoorbellCnt)
+			LOGBUF(pucBuf, u4Max, u4Len,
+				"TX[%u] Kick[%u] Desc[%u] Avg[%u] Pending[%u]\n",
+				u4Idx, prTxRing->u4DoorbellCnt,
+				prTxRing->u4KickDescCnt,
+				prTxRing->u4KickDescCnt /
+				prTxRing->u4DoorbellCnt,
+				prTxRing->u4KickPendingCnt);
 
 		if (u4Idx == TX_RING_DATA0_IDX_0) {
 			halDumpTxRing(prGlueInfo, u4Idx, prTxRing->TxCpuIdx);
@@ -291,6 +299,16 @@ uint32_t halDumpHifStatus(IN struct ADAPTER *prAdapter,
 	LOGBUF(pucBuf, u4Max, u4Len, "Pending QLen Normal[%u] Sec[%u]\n",
 		prGlueInfo->i4TxPendingFrameNum,
 		prGlueInfo->i4TxPendingSecurityFrameNum);
+#if CFG_SUPPORT_PCIE_RX_POOL
+	LOGBUF(pucBuf, u4Max, u4Len,
+		"RX Pool: Num[%u] Hit[%u] Grow[%u] Miss[%u] Recycle Avg[%uus] Max[%uus]\n",
+		prHifInfo->rRxPool.u4Num, prHifInfo->rRxPool.u4HitCnt,
+		prHifInfo->rRxPool.u4GrowCnt, prHifInfo->rRxPool.u4MissCnt,
+		prHifInfo->rRxPool.u4HitCnt ?
+		(uint32_t)div_u64(prHifInfo->rRxPool.u8RecycleTotalUs,
+			prHifInfo->rRxPool.u4HitCnt) : 0,
+		prHifInfo->rRxPool.u4RecycleMaxUs);
+#endif
 
 	LOGBUF(pucBuf, u4Max, u4Len, "---------------------------------\n\n");
 
@@ -349,11 +367,7 @@ static bool halIsTxHang(struct ADAPTER *prAdapter)
 	struct MSDU_TOKEN_INFO *prTokenInfo;
 	struct MSDU_TOKEN_ENTRY *prToken;
 	struct MSDU_INFO *prMsduInfo;
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-	struct timespec64 rNowTs, rTime, rLongest, rTimeout;
-#else
-	struct timeval rNowTs, rTime, rLongest, rTimeout;
-#endif
+	OS_SYSTIME rNowTs, rTime, rLongest = 0, rTimeout;
 	uint32_t u4Idx = 0, u4TokenId = 0;
 	bool fgIsTimeout = false;
 	struct WIFI_VAR *prWifiVar;
@@ -364,17 +378,8 @@ static bool halIsTxHang(struct ADAPTER *prAdapter)
 	prTokenInfo = &prAdapter->prGlueInfo->rHifInfo.rTokenInfo;
 	prWifiVar = &prAdapter->rWifiVar;
 
-	rTimeout.tv_sec = prWifiVar->ucMsduReportTimeout;
-	rLongest.tv_sec = 0;
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-	rTimeout.tv_nsec = 0;
-	rLongest.tv_nsec = 0;
-	ktime_get_real_ts64(&rNowTs);
-#else
-	rTimeout.tv_usec = 0;
-	rLongest.tv_usec = 0;
-	do_gettimeofday(&rNowTs);
-#endif
+	rTimeout = SEC_TO_SYSTIME(prWifiVar->ucMsduReportTimeout);
+	GET_CURRENT_SYSTIME(&rNowTs);
 
 	for (u4Idx = 0; u4Idx < HIF_TX_MSDU_TOKEN_NUM; u4Idx++) {
 		prToken = &prTokenInfo->arToken[u4Idx];
@@ -388,43 +393,23 @@ static bool halIsTxHang(struct ADAPTER *prAdapter)
 			continue;
 
 		/* Ignore now time < token time */
-		if (halTimeCompare(&rNowTs, &prToken->rTs) < 0)
+		if (!CHECK_FOR_EXPIRATION(rNowTs, prToken->rTs))
 			continue;
 
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-		rTime = timespec64_sub(rNowTs, prToken->rTs);
-#else
-		rTime.tv_sec = rNowTs.tv_sec - prToken->rTs.tv_sec;
-		rTime.tv_usec = rNowTs.tv_usec;
-		if (prToken->rTs.tv_usec > rNowTs.tv_usec) {
-			rTime.tv_sec -= 1;
-			rTime.tv_usec += SEC_TO_USEC(1);
-		}
-		rTime.tv_usec -= prToken->rTs.tv_usec;
-#endif
+		rTime = rNowTs - prToken->rTs;
 
-		if (halTimeCompare(&rTime, &rTimeout) >= 0)
+		if (rTime >= rTimeout)
 			fgIsTimeout = true;
 
-		/* rTime > rLongest */
-		if (halTimeCompare(&rTime, &rLongest) > 0) {
-			rLongest.tv_sec = rTime.tv_sec;
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-			rLongest.tv_nsec = rTime.tv_nsec;
-#else
-			rLongest.tv_usec = rTime.tv_usec;
-#endif
+		if (rTime > rLongest) {
+			rLongest = rTime;
 			u4TokenId = u4Idx;
 		}
 	}
 
 	if (fgIsTimeout) {
-		DBGLOG(HAL, INFO, "TokenId[%u] timeout[sec:%ld, usec:%ld]\n",
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-		       u4TokenId, rLongest.tv_sec, rLongest.tv_nsec/1000);
-#else
-		       u4TokenId, rLongest.tv_sec, rLongest.tv_usec);
-#endif
+		DBGLOG(HAL, INFO, "TokenId[%u] timeout[%ums]\n",
+		       u4TokenId, rLongest);
 		prToken = &prTokenInfo->arToken[u4TokenId];
 		if (prToken->prPacket)
 			DBGLOG_MEM32(HAL, INFO, prToken->prPacket, 64);
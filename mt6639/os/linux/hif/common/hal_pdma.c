@@ -898,6 +898,38 @@ void halProcessTxInterrupt(IN struct ADAPTER *prAdapter)
 		halDefaultProcessTxInterrupt(prAdapter);
 }
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Sync PCIe ASPM with msdu token usage after a used count transition.
+ *
+ *        Used count is updated without the token lock, so the transitions
+ *        0->1 and 1->0 may race. The ASPM state is re-evaluated under the
+ *        lock from the current used count; whoever runs last wins.
+ *
+ * @param prAdapter      a pointer to adapter private data structure.
+ */
+/*----------------------------------------------------------------------------*/
+static void halSyncMsduTokenAspm(IN struct ADAPTER *prAdapter)
+{
+#if CFG_SUPPORT_PCIE_ASPM_IMPROVE
+	struct MSDU_TOKEN_INFO *prTokenInfo =
+		&prAdapter->prGlueInfo->rHifInfo.rTokenInfo;
+	struct BUS_INFO *prBusInfo = prAdapter->chip_info->bus_info;
+	unsigned long flags = 0;
+	u_int8_t fgBusy;
+
+	if (!prBusInfo->configPcieASPM)
+		return;
+
+	spin_lock_irqsave(&prTokenInfo->rTokenLock, flags);
+	fgBusy = GLUE_GET_REF_CNT(prTokenInfo->u4UsedCnt) ? TRUE : FALSE;
+	if (fgBusy != prTokenInfo->fgAspmBusy) {
+		prBusInfo->configPcieASPM(prAdapter->prGlueInfo, fgBusy);
+		prTokenInfo->fgAspmBusy = fgBusy;
+	}
+	spin_unlock_irqrestore(&prTokenInfo->rTokenLock, flags);
+#endif
+}
 
 void halInitMsduTokenInfo(IN struct ADAPTER *prAdapter)
 {
@@ -915,6 +947,15 @@ void halInitMsduTokenInfo(IN struct ADAPTER *prAdapter)
 	prChipInfo = prAdapter->chip_info;
 
 	prTokenInfo->u4UsedCnt = 0;
+#if CFG_SUPPORT_PCIE_ASPM_IMPROVE
+	prTokenInfo->fgAspmBusy = FALSE;
+#endif
+	if (!tokenPoolInit(&prTokenInfo->rPool, HIF_TX_MSDU_TOKEN_NUM,
+			   CFG_SUPPORT_MSDU_TOKEN_CPU_CACHE)) {
+		DBGLOG(HAL, ERROR, "Msdu Token pool alloc failed\n");
+		prTokenInfo->u4UsedCnt = HIF_TX_MSDU_TOKEN_NUM;
+		return;
+	}
 	u4TxHeadRoomSize = NIC_TX_DESC_AND_PADDING_LENGTH +
 		prChipInfo->txd_append_size;
 
@@ -951,7 +992,7 @@ void halInitMsduTokenInfo(IN struct ADAPTER *prAdapter)
 		prToken->u4Token = u4Idx;
 		prToken->u4CpuIdx = TX_RING_SIZE;
 
-		prTokenInfo->aprTokenStack[u4Idx] = prToken;
+		tokenPoolAdd(&prTokenInfo->rPool, prToken);
 	}
 
 	spin_lock_init(&prTokenInfo->rTokenLock);
@@ -1004,6 +1045,7 @@ void halUninitMsduTokenInfo(IN struct ADAPTER *prAdapter)
 	}
 
 	prTokenInfo->u4UsedCnt = 0;
+	tokenPoolUninit(&prTokenInfo->rPool);
 
 	DBGLOG(HAL, INFO, "Msdu Token Uninit: Tot[%u] Used[%u]\n",
 		HIF_TX_MSDU_TOKEN_NUM, prTokenInfo->u4UsedCnt);
@@ -1014,10 +1056,13 @@ uint32_t halGetMsduTokenFreeCnt(IN struct ADAPTER *prAdapter)
 	struct PERF_MONITOR_T *prPerMonitor;
 	struct MSDU_TOKEN_INFO *prTokenInfo =
 		&prAdapter->prGlueInfo->rHifInfo.rTokenInfo;
+	uint32_t u4UsedCnt;
+
 	prPerMonitor = &prAdapter->rPerMonitor;
-	prPerMonitor->u4UsedCnt = prTokenInfo->u4UsedCnt;
+	u4UsedCnt = GLUE_GET_REF_CNT(prTokenInfo->u4UsedCnt);
+	prPerMonitor->u4UsedCnt = u4UsedCnt;
 
-	return HIF_TX_MSDU_TOKEN_NUM - prTokenInfo->u4UsedCnt;
+	return HIF_TX_MSDU_TOKEN_NUM - u4UsedCnt;
 }
 
 struct MSDU_TOKEN_ENTRY *halGetMsduTokenEntry(IN struct ADAPTER *prAdapter,
@@ -1034,43 +1079,28 @@ struct MSDU_TOKEN_ENTRY *halAcquireMsduToken(IN struct ADAPTER *prAdapter)
 	struct MSDU_TOKEN_INFO *prTokenInfo =
 		&prAdapter->prGlueInfo->rHifInfo.rTokenInfo;
 	struct MSDU_TOKEN_ENTRY *prToken;
-	unsigned long flags = 0;
-#if CFG_SUPPORT_PCIE_ASPM_IMPROVE
-	struct BUS_INFO *prBusInfo = NULL;
 
-	prBusInfo = prAdapter->chip_info->bus_info;
-#endif
+	if (halGetMsduTokenFreeCnt(prAdapter))
+		prToken = tokenPoolGet(&prTokenInfo->rPool);
+	else
+		prToken = NULL;
 
-	if (!halGetMsduTokenFreeCnt(prAdapter)) {
+	if (!prToken) {
 		DBGLOG(HAL, INFO, "No more free MSDU token, Used[%u]\n",
-			prTokenInfo->u4UsedCnt);
+			GLUE_GET_REF_CNT(prTokenInfo->u4UsedCnt));
 		return NULL;
 	}
 
-	spin_lock_irqsave(&prTokenInfo->rTokenLock, flags);
-
-	prToken = prTokenInfo->aprTokenStack[prTokenInfo->u4UsedCnt];
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-	ktime_get_real_ts64(&prToken->rTs);
-#else
-	do_gettimeofday(&prToken->rTs);
-#endif
+	GET_CURRENT_SYSTIME(&prToken->rTs);
 	prToken->fgInUsed = TRUE;
 
-#if CFG_SUPPORT_PCIE_ASPM_IMPROVE
-	if (prTokenInfo->u4UsedCnt == 0)
-		if (prBusInfo->configPcieASPM)
-			prBusInfo->configPcieASPM(prAdapter->prGlueInfo, TRUE);
-#endif
+	if (GLUE_INC_REF_CNT(prTokenInfo->u4UsedCnt) == 1)
+		halSyncMsduTokenAspm(prAdapter);
 
-	prTokenInfo->u4UsedCnt++;
-
-	spin_unlock_irqrestore(&prTokenInfo->rTokenLock, flags);
-
-	DBGLOG_LIMITED(HAL, TRACE,
-		       "Acquire Entry[0x%p] Tok[%u] Buf[%p] Len[%u]\n",
-		       prToken, prToken->u4Token,
-		       prToken->prPacket, prToken->u4DmaLength);
+	DBGTRACE_LIMITED(HAL, TRACE,
+		 "Acquire Entry[0x%p] Tok[%u] Buf[%p] Len[%u]\n",
+		 prToken, prToken->u4Token,
+		 prToken->prPacket, prToken->u4DmaLength);
 
 	return prToken;
 }
@@ -1118,8 +1148,10 @@ static void halResetMsduToken(IN struct ADAPTER *prAdapter)
 		}
 
 		prToken->fgInUsed = FALSE;
-		prTokenInfo->aprTokenStack[u4Idx] = prToken;
 	}
+	tokenPoolReset(&prTokenInfo->rPool);
+	for (u4Idx = 0; u4Idx < HIF_TX_MSDU_TOKEN_NUM; u4Idx++)
+		tokenPoolAdd(&prTokenInfo->rPool, &prTokenInfo->arToken[u4Idx]);
 	prTokenInfo->u4UsedCnt = 0;
 }
 
@@ -1128,16 +1160,10 @@ void halReturnMsduToken(IN struct ADAPTER *prAdapter, uint32_t u4TokenNum)
 	struct MSDU_TOKEN_INFO *prTokenInfo =
 		&prAdapter->prGlueInfo->rHifInfo.rTokenInfo;
 	struct MSDU_TOKEN_ENTRY *prToken;
-	unsigned long flags = 0;
-#if CFG_SUPPORT_PCIE_ASPM_IMPROVE
-	struct BUS_INFO *prBusInfo = NULL;
-
-	prBusInfo = prAdapter->chip_info->bus_info;
-#endif
 
-	if (!prTokenInfo->u4UsedCnt) {
+	if (!GLUE_GET_REF_CNT(prTokenInfo->u4UsedCnt)) {
 		DBGLOG(HAL, WARN, "MSDU token is full, Used[%u]\n",
-			prTokenInfo->u4UsedCnt);
+			GLUE_GET_REF_CNT(prTokenInfo->u4UsedCnt));
 		return;
 	}
 
@@ -1147,21 +1173,11 @@ void halReturnMsduToken(IN struct ADAPTER *prAdapter, uint32_t u4TokenNum)
 		return;
 	}
 
-	spin_lock_irqsave(&prTokenInfo->rTokenLock, flags);
-
 	prToken->fgInUsed = FALSE;
-	prTokenInfo->u4UsedCnt--;
-	prTokenInfo->aprTokenStack[prTokenInfo->u4UsedCnt] = prToken;
-
-#if CFG_SUPPORT_PCIE_ASPM_IMPROVE
-	if (prTokenInfo->u4UsedCnt == 0)
-		if (prBusInfo->configPcieASPM)
-			prBusInfo->configPcieASPM(
-				prAdapter->prGlueInfo, FALSE);
-#endif
-
+	tokenPoolPut(&prTokenInfo->rPool, prToken);
 
-	spin_unlock_irqrestore(&prTokenInfo->rTokenLock, flags);
+	if (GLUE_DEC_REF_CNT(prTokenInfo->u4UsedCnt) == 0)
+		halSyncMsduTokenAspm(prAdapter);
 }
 
 
@@ -1177,13 +1193,7 @@ void halReturnTimeoutMsduToken(struct ADAPTER *prAdapter)
 {
 	struct MSDU_TOKEN_INFO *prTokenInfo;
 	struct MSDU_TOKEN_ENTRY *prToken;
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-	struct timespec64 rNowTs, rTime;
-	struct timespec64 rTimeout;
-#else
-	struct timeval rNowTs, rTime;
-	struct timeval rTimeout;
-#endif
+	OS_SYSTIME rNowTs;
 	uint32_t u4Idx = 0;
 
 	ASSERT(prAdapter);
@@ -1191,48 +1201,18 @@ void halReturnTimeoutMsduToken(struct ADAPTER *prAdapter)
 
 	prTokenInfo = &prAdapter->prGlueInfo->rHifInfo.rTokenInfo;
 
-	rTimeout.tv_sec = HIF_MSDU_REPORT_RETURN_TIMEOUT;
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-	rTimeout.tv_nsec = 0;
-#else
-	rTimeout.tv_usec = 0;
-#endif
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-	ktime_get_real_ts64(&rNowTs);
-#else
-	do_gettimeofday(&rNowTs);
-#endif
+	GET_CURRENT_SYSTIME(&rNowTs);
 
 	for (u4Idx = 0; u4Idx < HIF_TX_MSDU_TOKEN_NUM; u4Idx++) {
 		prToken = &prTokenInfo->arToken[u4Idx];
 		if (!prToken->fgInUsed)
 			continue;
 
-		/* Ignore now time < token time */
-		if (halTimeCompare(&rNowTs, &prToken->rTs) < 0)
-			continue;
-
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-		rTime = timespec64_sub(rNowTs, prToken->rTs);
-#else
-		rTime.tv_sec = rNowTs.tv_sec - prToken->rTs.tv_sec;
-		rTime.tv_usec = rNowTs.tv_usec;
-		if (prToken->rTs.tv_usec > rNowTs.tv_usec) {
-			rTime.tv_sec -= 1;
-			rTime.tv_usec += SEC_TO_USEC(1);
-		}
-		rTime.tv_usec -= prToken->rTs.tv_usec;
-#endif
-
 		/* Return token to free stack */
-		if (halTimeCompare(&rTime, &rTimeout) >= 0) {
-			DBGLOG(HAL, INFO,
-			       "Free TokenId[%u] timeout[sec:%ld, usec:%ld]\n",
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-			       u4Idx, rTime.tv_sec, rTime.tv_nsec/1000);
-#else
-			       u4Idx, rTime.tv_sec, rTime.tv_usec);
-#endif
+		if (CHECK_FOR_TIMEOUT(rNowTs, prToken->rTs,
+			SEC_TO_SYSTIME(HIF_MSDU_REPORT_RETURN_TIMEOUT))) {
+			DBGLOG(HAL, INFO, "Free TokenId[%u] timeout[%ums]\n",
+			       u4Idx, rNowTs - prToken->rTs);
 			halReturnMsduToken(prAdapter, u4Idx);
 		}
 	}
@@ -1307,18 +1287,18 @@ u_int8_t halProcessToken(IN struct ADAPTER *prAdapter,
 #endif
 
 #if HIF_TX_PREALLOC_DATA_BUFFER
-	DBGLOG_LIMITED(HAL, TRACE, "MsduRpt: Tok[%u] Free[%u]\n",
+	DBGTRACE_LIMITED(HAL, TRACE, "MsduRpt: Tok[%u] Free[%u]\n",
 		u4Token,
 		halGetMsduTokenFreeCnt(prAdapter));
 #else
 	prMsduInfo = prTokenEntry->prMsduInfo;
 	prMsduInfo->prToken = NULL;
 
-	DBGLOG_LIMITED(HAL, TRACE,
-		       "MsduRpt: Tok[%u] Msdu[0x%p] TxDone[%u] Free[%u]\n",
-		       u4Token, prMsduInfo,
-		       (prMsduInfo->pfTxDoneHandler ? TRUE : FALSE),
-		       halGetMsduTokenFreeCnt(prAdapter));
+	DBGTRACE_LIMITED(HAL, TRACE,
+		 "MsduRpt: Tok[%u] Msdu[0x%p] TxDone[%u] Free[%u]\n",
+		 u4Token, prMsduInfo,
+		 (prMsduInfo->pfTxDoneHandler ? TRUE : FALSE),
+		 halGetMsduTokenFreeCnt(prAdapter));
 
 	if (!prMsduInfo->pfTxDoneHandler) {
 		QUEUE_INSERT_TAIL(prFreeQueue,
@@ -1422,8 +1402,8 @@ void halRxProcessMsduReport(IN struct ADAPTER *prAdapter,
 	prRxDescOps = prAdapter->chip_info->prRxDescOps;
 	QUEUE_INITIALIZE(&rFreeQueue);
 #if (CFG_SUPPORT_CONNAC3X == 1)
-	if (prRxDescOps->nic_rxd_handle_host_rpt)
-		prRxDescOps->nic_rxd_handle_host_rpt(
+	if (RX_DESC_OPS_EXIST(prRxDescOps, handle_host_rpt))
+		RX_DESC_OPS_FN(prRxDescOps, handle_host_rpt)(
 			prAdapter, prSwRfb, &rFreeQueue);
 	else
 #endif
@@ -1557,11 +1537,11 @@ void halRxReceiveRFBs(IN struct ADAPTER *prAdapter, uint32_t u4Port,
 	prRxCtrl = &prAdapter->rRxCtrl;
 	ASSERT(prRxCtrl);
 	prRxDescOps = prAdapter->chip_info->prRxDescOps;
-	ASSERT(prRxDescOps->nic_rxd_get_rx_byte_count);
-	ASSERT(prRxDescOps->nic_rxd_get_pkt_type);
-	ASSERT(prRxDescOps->nic_rxd_get_wlan_idx);
+	ASSERT(RX_DESC_OPS_EXIST(prRxDescOps, get_rx_byte_count));
+	ASSERT(RX_DESC_OPS_EXIST(prRxDescOps, get_pkt_type));
+	ASSERT(RX_DESC_OPS_EXIST(prRxDescOps, get_wlan_idx));
 #if DBG
-	ASSERT(prRxDescOps->nic_rxd_get_sec_mode);
+	ASSERT(RX_DESC_OPS_EXIST(prRxDescOps, get_sec_mode));
 #endif /* DBG */
 	prGlueInfo = prAdapter->prGlueInfo;
 
@@ -1583,7 +1563,7 @@ void halRxReceiveRFBs(IN struct ADAPTER *prAdapter, uint32_t u4Port,
 	}
 	QUEUE_INITIALIZE(prRxQue);
 
-	DBGLOG(RX, LOUD, "halRxReceiveRFBs: u4RxCnt:%d\n", u4RxCnt);
+	DBGTRACE(RX, LOUD, "halRxReceiveRFBs: u4RxCnt:%d\n", u4RxCnt);
 
 	prRxRing = &prAdapter->prGlueInfo->rHifInfo.RxRing[u4Port];
 
@@ -1648,11 +1628,12 @@ void halRxReceiveRFBs(IN struct ADAPTER *prAdapter, uint32_t u4Port,
 		ASSERT(prRxStatus);
 
 		prSwRfb->ucPacketType =
-			prRxDescOps->nic_rxd_get_pkt_type(prRxStatus);
+			RX_DESC_OPS_FN(prRxDescOps, get_pkt_type)(prRxStatus);
 #if DBG
-		DBGLOG_LIMITED(RX, LOUD, "ucPacketType = %u, ucSecMode = %u\n",
+		DBGTRACE_LIMITED(RX, LOUD,
+			"ucPacketType = %u, ucSecMode = %u\n",
 				  prSwRfb->ucPacketType,
-				  prRxDescOps->nic_rxd_get_sec_mode(
+				  RX_DESC_OPS_FN(prRxDescOps, get_sec_mode)(
 					prRxStatus));
 #endif /* DBG */
 
@@ -1674,7 +1655,8 @@ void halRxReceiveRFBs(IN struct ADAPTER *prAdapter, uint32_t u4Port,
 		prSwRfb->ucStaRecIdx =
 			secGetStaIdxByWlanIdx(
 				prAdapter,
-				prRxDescOps->nic_rxd_get_wlan_idx(prRxStatus));
+				RX_DESC_OPS_FN(prRxDescOps, get_wlan_idx)(
+					prRxStatus));
 
 		if (HAL_IS_RX_DIRECT(prAdapter) &&
 			prSwRfb->ucPacketType == RX_PKT_TYPE_RX_DATA) {
@@ -1692,8 +1674,7 @@ void halRxReceiveRFBs(IN struct ADAPTER *prAdapter, uint32_t u4Port,
 			}
 		} else {
 			KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
-			QUEUE_INSERT_TAIL(&prRxCtrl->rReceivedRfbList,
-				&prSwRfb->rQueEntry);
+			nicRxEnqueueReceivedRFB(prAdapter, prSwRfb);
 			RX_INC_CNT(prRxCtrl, RX_MPDU_TOTAL_COUNT);
 			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 		}
@@ -2022,6 +2003,7 @@ bool halWpdmaAllocRing(struct GLUE_INFO *prGlueInfo, bool fgAllocMem)
 	for (u4Index = 0; u4Index < NUM_OF_TX_RING; u4Index++) {
 		prHifInfo->TxRing[u4Index].TxSwUsedIdx = 0;
 		prHifInfo->TxRing[u4Index].TxCpuIdx = 0;
+		prHifInfo->TxRing[u4Index].u4KickPendingCnt = 0;
 		spin_lock_init(&prHifInfo->TxRing[u4Index].rTxDmaQLock);
 	}
 
@@ -2204,6 +2186,7 @@ void halWpdmaInitTxRing(IN struct GLUE_INFO *prGlueInfo)
 		prTxRing->TxSwUsedIdx = 0;
 		prTxRing->u4UsedCnt = 0;
 		prTxRing->TxCpuIdx = 0;
+		prTxRing->u4KickPendingCnt = 0;
 
 		prTxRing->hw_desc_base =
 			prBusInfo->host_tx_ring_base + offset;
@@ -2441,7 +2424,7 @@ void halWpdmaProcessDataDmaDone(IN struct GLUE_INFO *prGlueInfo,
 			prTxRing->u4UsedCnt = 0;
 	}
 
-	DBGLOG_LIMITED(HAL, TRACE,
+	DBGTRACE_LIMITED(HAL, TRACE,
 		"DMA done: port[%u] dma[%u] idx[%u] used[%u]\n", u2Port,
 		u4DmaIdx, u4SwIdx, prTxRing->u4UsedCnt);
 
@@ -2581,6 +2564,94 @@ bool halWpdmaWriteCmd(IN struct GLUE_INFO *prGlueInfo,
 	return TRUE;
 }
 
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Write the software CPU index of a data TX ring to WFDMA.
+ *
+ * @param prGlueInfo     Pointer of GLUE Data Structure
+ * @param prTxRing       TX ring, caller holds its rTxDmaQLock
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void halWpdmaKickTxRing(struct GLUE_INFO *prGlueInfo,
+			       struct RTMP_TX_RING *prTxRing)
+{
+	if (prTxRing->u4KickPendingCnt == 0)
+		return;
+
+	kalDevRegWrite(prGlueInfo, prTxRing->hw_cidx_addr, prTxRing->TxCpuIdx);
+	prTxRing->u4DoorbellCnt++;
+	prTxRing->u4KickDescCnt += prTxRing->u4KickPendingCnt;
+	prTxRing->u4KickPendingCnt = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Burst depth slot of the current CPU. CPUs sharing a slot only
+ *        batch each other's doorbells, they never lose one.
+ *
+ * @return slot index in ai4TxBurstDepth[]
+ */
+/*----------------------------------------------------------------------------*/
+static uint32_t halWpdmaTxBurstSlot(void)
+{
+	return raw_smp_processor_id() & (HIF_TX_BURST_SLOT_NUM - 1);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Start a TX doorbell burst on the current CPU. Data descriptors this
+ *        CPU fills until the matching halWpdmaEndTxBurst() are kicked in
+ *        batches of u4TxKickBurstMax, other CPUs keep kicking at once.
+ *        Caller must hold the power control for the whole burst.
+ *
+ * @param prGlueInfo     Pointer of GLUE Data Structure
+ *
+ * @return burst slot to pass to halWpdmaEndTxBurst()
+ */
+/*----------------------------------------------------------------------------*/
+uint32_t halWpdmaBeginTxBurst(struct GLUE_INFO *prGlueInfo)
+{
+	uint32_t u4Slot = halWpdmaTxBurstSlot();
+
+	GLUE_INC_REF_CNT(prGlueInfo->rHifInfo.ai4TxBurstDepth[u4Slot]);
+	return u4Slot;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief End a TX doorbell burst, kick all data TX rings left pending when
+ *        the outermost burst of the slot ends.
+ *
+ * @param prGlueInfo     Pointer of GLUE Data Structure
+ * @param u4Slot         Slot returned by halWpdmaBeginTxBurst()
+ *
+ * @return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void halWpdmaEndTxBurst(struct GLUE_INFO *prGlueInfo, uint32_t u4Slot)
+{
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	struct RTMP_TX_RING *prTxRing;
+	unsigned long flags;
+	uint32_t u4Idx;
+
+	/* fully ordered, pairs with the smp_mb() in halWpdmaFillTxRing() */
+	if (GLUE_DEC_REF_CNT(prHifInfo->ai4TxBurstDepth[u4Slot]) > 0)
+		return;
+
+	/* Check under the ring lock, a descriptor filled while the depth was
+	 * still raised is then either seen here or kicked by its filler.
+	 */
+	for (u4Idx = 0; u4Idx < NUM_OF_TX_RING; u4Idx++) {
+		prTxRing = &prHifInfo->TxRing[u4Idx];
+		spin_lock_irqsave(&prTxRing->rTxDmaQLock, flags);
+		halWpdmaKickTxRing(prGlueInfo, prTxRing);
+		spin_unlock_irqrestore(&prTxRing->rTxDmaQLock, flags);
+	}
+}
+
 static bool halWpdmaFillTxRing(struct GLUE_INFO *prGlueInfo,
 			       struct MSDU_TOKEN_ENTRY *prToken)
 {
@@ -2603,7 +2674,7 @@ static bool halWpdmaFillTxRing(struct GLUE_INFO *prGlueInfo,
 
 	spin_lock_irqsave(&prTxRing->rTxDmaQLock, flags);
 
-	kalDevRegRead(prGlueInfo, prTxRing->hw_cidx_addr, &prTxRing->TxCpuIdx);
+	/* Data rings are only advanced by the driver, use the SW CPU index */
 	if (prTxRing->TxCpuIdx >= TX_RING_SIZE) {
 		spin_unlock_irqrestore(&prTxRing->rTxDmaQLock, flags);
 		DBGLOG(HAL, ERROR, "Error TxCpuIdx[%u]\n", prTxRing->TxCpuIdx);
@@ -2638,13 +2709,22 @@ static bool halWpdmaFillTxRing(struct GLUE_INFO *prGlueInfo,
 	/* Increase TX_CTX_IDX, but write to register later. */
 	INC_RING_INDEX(prTxRing->TxCpuIdx, TX_RING_SIZE);
 
-	/* Update HW Tx DMA ring */
+	/* Update HW Tx DMA ring, batched while a TX burst is open */
 	prTxRing->u4UsedCnt++;
-	kalDevRegWrite(prGlueInfo, prTxRing->hw_cidx_addr, prTxRing->TxCpuIdx);
+	prTxRing->u4KickPendingCnt++;
+	/* order the pending count before the depth read, an ending burst
+	 * does the opposite in halWpdmaEndTxBurst()
+	 */
+	smp_mb();
+	if (GLUE_GET_REF_CNT(prHifInfo->ai4TxBurstDepth[
+		halWpdmaTxBurstSlot()]) == 0 ||
+	    prTxRing->u4KickPendingCnt >=
+	    prGlueInfo->prAdapter->rWifiVar.u4TxKickBurstMax)
+		halWpdmaKickTxRing(prGlueInfo, prTxRing);
 
 	spin_unlock_irqrestore(&prTxRing->rTxDmaQLock, flags);
 
-	DBGLOG_LIMITED(HAL, TRACE,
+	DBGTRACE_LIMITED(HAL, TRACE,
 		"Tx Data:Ring%d CPU idx[0x%x] Used[%u]\n",
 		u2Port, prTxRing->TxCpuIdx, prTxRing->u4UsedCnt);
 
@@ -2675,6 +2755,22 @@ static bool halFlushToken(struct GLUE_INFO *prGlueInfo,
 	return true;
 }
 
+#if HIF_TX_PREALLOC_DATA_BUFFER
+static void halCopyTxData(struct HIF_MEM_OPS *prMemOps,
+			  struct MSDU_TOKEN_ENTRY *prToken,
+			  struct sk_buff *prSkb)
+{
+	/* SW TSO segments reference their payload in page frags */
+	if (skb_is_nonlinear(prSkb)) {
+		skb_copy_bits(prSkb, 0, prToken->prPacket, prSkb->len);
+		return;
+	}
+
+	if (prMemOps->copyTxData)
+		prMemOps->copyTxData(prToken, prSkb->data, prSkb->len);
+}
+#endif
+
 static bool halWpdmaWriteData(struct GLUE_INFO *prGlueInfo,
 			      struct MSDU_INFO *prMsduInfo,
 			      struct MSDU_TOKEN_ENTRY *prFillToken,
@@ -2729,7 +2825,7 @@ void halWpdmaFreeMsdu(struct GLUE_INFO *prGlueInfo,
 		      bool fgSetEvent)
 {
 
-	DBGLOG(HAL, LOUD, "Tx Data: Msdu[0x%p], TokFree[%u] TxDone[%u]\n",
+	DBGTRACE(HAL, LOUD, "Tx Data: Msdu[0x%p], TokFree[%u] TxDone[%u]\n",
 		prMsduInfo, halGetMsduTokenFreeCnt(prGlueInfo->prAdapter),
 		(prMsduInfo->pfTxDoneHandler ? TRUE : FALSE));
 
@@ -2796,8 +2892,7 @@ bool halWpdmaWriteMsdu(struct GLUE_INFO *prGlueInfo,
 	prToken->prMsduInfo = prMsduInfo;
 
 #if HIF_TX_PREALLOC_DATA_BUFFER
-	if (prMemOps->copyTxData)
-		prMemOps->copyTxData(prToken, pucSrc, u4TotalLen);
+	halCopyTxData(prMemOps, prToken, prSkb);
 #else
 	prToken->prPacket = pucSrc;
 	prToken->u4DmaLength = u4TotalLen;
@@ -2929,8 +3024,7 @@ bool halWpdmaWriteAmsdu(struct GLUE_INFO *prGlueInfo,
 		/* Use MsduInfo to select TxRing */
 		prToken->prMsduInfo = prMsduInfo;
 #if HIF_TX_PREALLOC_DATA_BUFFER
-		if (prMemOps->copyTxData)
-			prMemOps->copyTxData(prToken, pucSrc, u4TotalLen);
+		halCopyTxData(prMemOps, prToken, prSkb);
 #else
 		prToken->prPacket = pucSrc;
 		prToken->u4DmaLength = u4TotalLen;
@@ -57,8 +57,6 @@
 #ifndef __HIF_PDMA_H__
 #define __HIF_PDMA_H__
 
-#include <linux/list_sort.h>
-
 /*******************************************************************************
  *                              C O N S T A N T S
  *******************************************************************************
@@ -113,11 +111,15 @@
 #define TX_BUFFER_NORMSIZE			3840
 
 #define HIF_TX_PREALLOC_DATA_BUFFER			1
+/* TX data is copied to the prealloc buffer, so nonlinear skb is accepted */
+#define HIF_TX_SUPPORT_NONLINEAR_SKB		HIF_TX_PREALLOC_DATA_BUFFER
 
 #define HIF_NUM_OF_QM_RX_PKT_NUM			2048
 #define HIF_IST_LOOP_COUNT					32
 /* Min msdu count to trigger Tx during INT polling state */
 #define HIF_IST_TX_THRESHOLD				1
+/* Max data descriptors filled per TX ring before the CPU index is kicked */
+#define HIF_TX_KICK_BURST_MAX_NUM			32
 
 #define HIF_TX_BUFF_COUNT_TC0				4096
 #define HIF_TX_BUFF_COUNT_TC1				4096
@@ -155,6 +157,7 @@
 #define HIF_TX_PAYLOAD_LENGTH				72
 
 #define HIF_MSDU_REPORT_RETURN_TIMEOUT		10	/* sec */
+#define HIF_TX_BURST_SLOT_NUM			8	/* power of 2 */
 #define HIF_SER_TIMEOUT				10000	/* msec */
 
 #define MT_RINGREG_DIFF		0x10
@@ -399,6 +402,9 @@ struct RTMP_TX_RING {
 	uint32_t hw_didx_addr;
 	uint32_t hw_cnt_addr;
 	spinlock_t rTxDmaQLock;
+	uint32_t u4KickPendingCnt;	/* filled but not yet kicked */
+	uint32_t u4DoorbellCnt;
+	uint32_t u4KickDescCnt;
 };
 
 struct RTMP_RX_RING {
@@ -430,11 +436,7 @@ struct PCIE_CHIP_CR_MAPPING {
 struct MSDU_TOKEN_ENTRY {
 	uint32_t u4Token;
 	u_int8_t fgInUsed;
-#if KERNEL_VERSION(5, 0, 0) <= LINUX_VERSION_CODE
-	struct timespec64 rTs;	/* token tx timestamp */
-#else
-	struct timeval rTs;	/* token tx timestamp */
-#endif
+	OS_SYSTIME rTs;		/* token tx timestamp */
 	uint32_t u4CpuIdx;	/* tx ring cell index */
 	struct MSDU_INFO *prMsduInfo;
 	void *prPacket;
@@ -446,10 +448,13 @@ struct MSDU_TOKEN_ENTRY {
 };
 
 struct MSDU_TOKEN_INFO {
-	uint32_t u4UsedCnt;
-	struct MSDU_TOKEN_ENTRY *aprTokenStack[HIF_TX_MSDU_TOKEN_NUM];
+	uint32_t u4UsedCnt;	/* tokens in use, updated atomically */
+	struct TOKEN_POOL rPool;	/* free tokens */
 	spinlock_t rTokenLock;
 	struct MSDU_TOKEN_ENTRY arToken[HIF_TX_MSDU_TOKEN_NUM];
+#if CFG_SUPPORT_PCIE_ASPM_IMPROVE
+	u_int8_t fgAspmBusy;	/* ASPM config matches u4UsedCnt != 0 */
+#endif
 };
 
 struct TX_CMD_REQ {
@@ -461,6 +466,16 @@ struct TX_CMD_REQ {
 struct TX_DATA_REQ {
 	struct MSDU_INFO *prMsduInfo;
 	struct list_head list;
+	uint16_t u2AmsduNum;	/* MSDUs aggregated from this head, 1 if not */
+	uint16_t u2AmsduSize;
+};
+
+/* SW A-MSDU staging bucket of one STA/TID */
+struct TX_AMSDU_BUCKET {
+	struct list_head rMsduList;	/* TX_DATA_REQ being aggregated */
+	struct list_head rOpenEntry;	/* linked in rTxAmsduOpenQ */
+	uint16_t u2Num;
+	uint16_t u2Size;		/* A-MSDU length with TXD and padding */
 };
 
 struct AMSDU_MAC_TX_DESC {
@@ -549,7 +564,11 @@ void halWpdmaFreeMsduTasklet(unsigned long data);
 
 bool kalDevReadData(struct GLUE_INFO *prGlueInfo, uint16_t u2Port,
 		    struct SW_RFB *prSwRfb);
+void *kalDevAllocRxPacket(struct GLUE_INFO *prGlueInfo, uint32_t u4Size,
+			  uint8_t **ppucData);
 bool kalDevKickCmd(struct GLUE_INFO *prGlueInfo);
+void kalDevTxAmsduInit(struct GLUE_INFO *prGlueInfo);
+void kalDevTxAmsduUninit(struct GLUE_INFO *prGlueInfo);
 
 /* SER functions */
 void halSetDrvSer(struct ADAPTER *prAdapter);
@@ -117,6 +117,10 @@ static bool kalDevWriteCmdByQueue(struct GLUE_INFO *prGlueInfo,
 				  struct CMD_INFO *prCmdInfo, uint8_t ucTC);
 static bool kalDevWriteDataByQueue(struct GLUE_INFO *prGlueInfo,
 				   struct MSDU_INFO *prMsduInfo);
+static bool kalDevWriteDataByAmsdu(struct GLUE_INFO *prGlueInfo,
+				   struct MSDU_INFO *prMsduInfo,
+				   struct TX_AMSDU_BUCKET *prBucket,
+				   struct STA_RECORD *prStaRec);
 static bool kalDevKickMsduData(struct GLUE_INFO *prGlueInfo);
 static bool kalDevKickAmsduData(struct GLUE_INFO *prGlueInfo);
 
@@ -583,10 +587,13 @@ bool kalDevKickCmd(IN struct GLUE_INFO *prGlueInfo)
 	return true;
 }
 
-static uint8_t kalGetSwAmsduNum(struct GLUE_INFO *prGlueInfo,
-				struct MSDU_INFO *prMsduInfo)
+/* Staging bucket of the MSDU's STA/TID, NULL if SW A-MSDU is off for it */
+static struct TX_AMSDU_BUCKET *kalGetTxAmsduBucket(
+	struct GLUE_INFO *prGlueInfo, struct MSDU_INFO *prMsduInfo,
+	struct STA_RECORD **pprStaRec)
 {
 	struct ADAPTER *prAdapter;
+	struct GL_HIF_INFO *prHifInfo;
 	struct sk_buff *prSkb;
 	struct STA_RECORD *prStaRec;
 	uint8_t ucTid, ucStaRecIndex;
@@ -596,19 +603,26 @@ static uint8_t kalGetSwAmsduNum(struct GLUE_INFO *prGlueInfo,
 	ASSERT(prMsduInfo);
 
 	prAdapter = prGlueInfo->prAdapter;
+	prHifInfo = &prGlueInfo->rHifInfo;
 	prTxDescOps = prAdapter->chip_info->prTxDescOps;
 	prSkb = (struct sk_buff *)prMsduInfo->prPacket;
 
+	if (!prHifInfo->prTxAmsduBucket)
+		return NULL;
+
 	ucTid = prTxDescOps->nic_txd_tid_op((void *)prSkb->data, 0, FALSE);
 	ucStaRecIndex = prMsduInfo->ucStaRecIndex;
 	if (ucStaRecIndex >= CFG_STA_REC_NUM || ucTid >= TX_DESC_TID_NUM)
-		return 0;
+		return NULL;
 
 	prStaRec = cnmGetStaRecByIndex(prAdapter, ucStaRecIndex);
-	if (!prStaRec || !(prStaRec->ucAmsduEnBitmap & BIT(ucTid)))
-		return 0;
+	if (!prStaRec || !(prStaRec->ucAmsduEnBitmap & BIT(ucTid)) ||
+	    prStaRec->ucMaxMpduCount <= 1)
+		return NULL;
 
-	return prStaRec->ucMaxMpduCount;
+	*pprStaRec = prStaRec;
+	return &prHifInfo->prTxAmsduBucket[
+		ucStaRecIndex * TX_DESC_TID_NUM + ucTid];
 }
 
 u_int8_t kalDevWriteData(IN struct GLUE_INFO *prGlueInfo,
@@ -616,15 +630,22 @@ u_int8_t kalDevWriteData(IN struct GLUE_INFO *prGlueInfo,
 {
 	struct GL_HIF_INFO *prHifInfo = NULL;
 	struct mt66xx_chip_info *prChipInfo;
+	struct TX_AMSDU_BUCKET *prBucket = NULL;
+	struct STA_RECORD *prStaRec = NULL;
 
 	ASSERT(prGlueInfo);
 
 	prHifInfo = &prGlueInfo->rHifInfo;
 	prChipInfo = prGlueInfo->prAdapter->chip_info;
 
-	if (nicSerIsTxStop(prGlueInfo->prAdapter) ||
-	    (prChipInfo->ucMaxSwAmsduNum > 1 &&
-	     kalGetSwAmsduNum(prGlueInfo, prMsduInfo) > 1))
+	if (prChipInfo->ucMaxSwAmsduNum > 1)
+		prBucket = kalGetTxAmsduBucket(prGlueInfo, prMsduInfo,
+					       &prStaRec);
+	if (prBucket)
+		return kalDevWriteDataByAmsdu(prGlueInfo, prMsduInfo,
+					      prBucket, prStaRec);
+
+	if (nicSerIsTxStop(prGlueInfo->prAdapter))
 		return kalDevWriteDataByQueue(prGlueInfo, prMsduInfo);
 
 	return halWpdmaWriteMsdu(prGlueInfo, prMsduInfo, NULL);
@@ -641,6 +662,7 @@ static bool kalDevWriteDataByQueue(IN struct GLUE_INFO *prGlueInfo,
 
 	prTxReq = &prMsduInfo->rTxReq;
 	prTxReq->prMsduInfo = prMsduInfo;
+	prTxReq->u2AmsduNum = 1;
 	list_add_tail(&prTxReq->list, &prHifInfo->rTxDataQ);
 	prHifInfo->u4TxDataQLen++;
 
@@ -660,15 +682,22 @@ static bool kalDevWriteDataByQueue(IN struct GLUE_INFO *prGlueInfo,
 u_int8_t kalDevKickData(IN struct GLUE_INFO *prGlueInfo)
 {
 	struct mt66xx_chip_info *prChipInfo;
+	uint32_t u4BurstSlot;
+	u_int8_t fgRet;
 
 	ASSERT(prGlueInfo);
 
 	prChipInfo = prGlueInfo->prAdapter->chip_info;
 
+	/* Ring doorbells once per burst instead of once per MSDU */
+	u4BurstSlot = halWpdmaBeginTxBurst(prGlueInfo);
 	if (prChipInfo->ucMaxSwAmsduNum > 1)
-		return kalDevKickAmsduData(prGlueInfo);
+		fgRet = kalDevKickAmsduData(prGlueInfo);
+	else
+		fgRet = kalDevKickMsduData(prGlueInfo);
+	halWpdmaEndTxBurst(prGlueInfo, u4BurstSlot);
 
-	return kalDevKickMsduData(prGlueInfo);
+	return fgRet;
 }
 
 static uint16_t kalGetPaddingSize(uint16_t u2TxByteCount)
@@ -730,31 +759,21 @@ static bool kalDevKickMsduData(struct GLUE_INFO *prGlueInfo)
 
 	return fgRet;
 }
-#if KERNEL_VERSION(5, 13, 0) <= LINUX_VERSION_CODE
-static int kalAmsduTxDCmp(void *prPriv,
-		const struct list_head *prList1,
-		const struct list_head *prList2)
-#else
-static int kalAmsduTxDCmp(void *prPriv,
-		struct list_head *prList1,
-		struct list_head *prList2)
-#endif
+
+/* MSDUs can share one A-MSDU only if their TXD headers match */
+static bool kalIsSameAmsduTxD(struct MSDU_INFO *prMsduInfo1,
+			      struct MSDU_INFO *prMsduInfo2)
 {
-	struct TX_DATA_REQ *prTxReq1, *prTxReq2;
 	struct sk_buff *prSkb1, *prSkb2;
 	struct AMSDU_MAC_TX_DESC *prTxD1, *prTxD2;
 
-	prTxReq1 = list_entry(prList1, struct TX_DATA_REQ, list);
-	prTxReq2 = list_entry(prList2, struct TX_DATA_REQ, list);
-	prSkb1 = (struct sk_buff *)prTxReq1->prMsduInfo->prPacket;
-	prSkb2 = (struct sk_buff *)prTxReq2->prMsduInfo->prPacket;
+	prSkb1 = (struct sk_buff *)prMsduInfo1->prPacket;
+	prSkb2 = (struct sk_buff *)prMsduInfo2->prPacket;
 	prTxD1 = (struct AMSDU_MAC_TX_DESC *)prSkb1->data;
 	prTxD2 = (struct AMSDU_MAC_TX_DESC *)prSkb2->data;
 
-	if (prTxD1->u2DW0 != prTxD2->u2DW0)
-		return prTxD2->u2DW0 - prTxD1->u2DW0;
-
-	return prTxD1->u4DW1 - prTxD2->u4DW1;
+	return prTxD1->u2DW0 == prTxD2->u2DW0 &&
+		prTxD1->u4DW1 == prTxD2->u4DW1;
 }
 
 static bool kalIsAggregatedMsdu(struct GLUE_INFO *prGlueInfo,
@@ -771,104 +790,140 @@ static bool kalIsAggregatedMsdu(struct GLUE_INFO *prGlueInfo,
 	return true;
 }
 
-static uint32_t kalGetNumOfAmsdu(struct GLUE_INFO *prGlueInfo,
-				 struct list_head *prTarget,
-				 struct list_head *prHead,
-				 uint16_t *pu2Size)
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Move a staged A-MSDU to rTxDataQ, ready to be written by the next
+ *        kick. Its head entry carries the MSDU count and A-MSDU length, a
+ *        bucket below u4MinMpduLen is sent as single MSDUs.
+ *
+ * \param[in] prGlueInfo         Pointer to the GLUE_INFO_T structure.
+ * \param[in] prBucket           Staging bucket of one STA/TID
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void kalCloseTxAmsduBucket(struct GLUE_INFO *prGlueInfo,
+				  struct TX_AMSDU_BUCKET *prBucket)
 {
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
 	struct TX_DATA_REQ *prTxReq;
-	struct MSDU_INFO *prMsduInfo;
-	struct sk_buff *prSkb;
-	struct AMSDU_MAC_TX_DESC *prTxD;
 	struct STA_RECORD *prStaRec;
-	struct list_head *prCur;
-	uint16_t u2TotalSize, u2Size;
-	uint32_t u4Cnt = 1;
-	uint8_t ucStaRecIndex;
 
-	prTxReq = list_entry(prTarget, struct TX_DATA_REQ, list);
-	prMsduInfo = prTxReq->prMsduInfo;
-	prSkb = (struct sk_buff *)prMsduInfo->prPacket;
-	prTxD = (struct AMSDU_MAC_TX_DESC *)prSkb->data;
+	if (prBucket->u2Num == 0)
+		return;
+
+	prTxReq = list_first_entry(&prBucket->rMsduList,
+				   struct TX_DATA_REQ, list);
+	prStaRec = cnmGetStaRecByIndex(prGlueInfo->prAdapter,
+				       prTxReq->prMsduInfo->ucStaRecIndex);
+	if (prBucket->u2Num > 1 && prStaRec &&
+	    prBucket->u2Size >= prStaRec->u4MinMpduLen) {
+		prTxReq->u2AmsduNum = prBucket->u2Num;
+		prTxReq->u2AmsduSize = prBucket->u2Size;
+	}
 
-	ucStaRecIndex = prMsduInfo->ucStaRecIndex;
-	prStaRec = cnmGetStaRecByIndex(prGlueInfo->prAdapter, ucStaRecIndex);
-	if (!prStaRec)
-		return 1;
+	list_splice_tail_init(&prBucket->rMsduList, &prHifInfo->rTxDataQ);
+	list_del_init(&prBucket->rOpenEntry);
+	prBucket->u2Num = 0;
+	prBucket->u2Size = 0;
+}
 
-	u2TotalSize = NIC_TX_DESC_LONG_FORMAT_LENGTH;
-	u2TotalSize += prMsduInfo->u2FrameLength;
-	u2TotalSize += kalGetMoreSizeForAmsdu(prTxD->u4DW1);
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Stage a MSDU in the A-MSDU bucket of its STA/TID. The bucket is
+ *        closed once it reaches ucMaxMpduCount, or before the MSDU if it
+ *        would exceed u4MaxMpduLen or its TXD header differs.
+ *
+ * \param[in] prGlueInfo         Pointer to the GLUE_INFO_T structure.
+ * \param[in] prMsduInfo         MSDU to stage
+ * \param[in] prBucket           Staging bucket of the MSDU's STA/TID
+ * \param[in] prStaRec           STA record of the MSDU
+ *
+ * \retval TRUE          operation success
+ */
+/*----------------------------------------------------------------------------*/
+static bool kalDevWriteDataByAmsdu(struct GLUE_INFO *prGlueInfo,
+				   struct MSDU_INFO *prMsduInfo,
+				   struct TX_AMSDU_BUCKET *prBucket,
+				   struct STA_RECORD *prStaRec)
+{
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	struct TX_DATA_REQ *prTxReq, *prHeadReq;
+	struct sk_buff *prSkb;
+	struct AMSDU_MAC_TX_DESC *prTxD;
+	uint16_t u2Size;
 
-	for (prCur = prTarget->next; prCur != prHead; prCur = prCur->next) {
-		if (u4Cnt >= kalGetSwAmsduNum(prGlueInfo, prMsduInfo) ||
-		    kalAmsduTxDCmp((void *)prGlueInfo, prTarget, prCur))
-			break;
+	/* Keep per-TID order for MSDUs that cannot be aggregated */
+	if (!kalIsAggregatedMsdu(prGlueInfo, prMsduInfo)) {
+		kalCloseTxAmsduBucket(prGlueInfo, prBucket);
+		return kalDevWriteDataByQueue(prGlueInfo, prMsduInfo);
+	}
 
-		prTxReq = list_entry(prCur, struct TX_DATA_REQ, list);
-		prMsduInfo = prTxReq->prMsduInfo;
-		prSkb = (struct sk_buff *)prMsduInfo->prPacket;
-		prTxD = (struct AMSDU_MAC_TX_DESC *)prSkb->data;
+	prSkb = (struct sk_buff *)prMsduInfo->prPacket;
+	prTxD = (struct AMSDU_MAC_TX_DESC *)prSkb->data;
+	u2Size = prMsduInfo->u2FrameLength;
+	u2Size += kalGetMoreSizeForAmsdu(prTxD->u4DW1);
+
+	if (prBucket->u2Num) {
+		prHeadReq = list_first_entry(&prBucket->rMsduList,
+					     struct TX_DATA_REQ, list);
+		if (!kalIsSameAmsduTxD(prHeadReq->prMsduInfo, prMsduInfo) ||
+		    prBucket->u2Size + u2Size +
+		    kalGetPaddingSize(prBucket->u2Size) >
+		    prStaRec->u4MaxMpduLen)
+			kalCloseTxAmsduBucket(prGlueInfo, prBucket);
+	}
 
-		u2Size = prMsduInfo->u2FrameLength;
-		u2Size += kalGetMoreSizeForAmsdu(prTxD->u4DW1);
-		u2Size += kalGetPaddingSize(u2TotalSize);
-		if ((u2TotalSize + u2Size) > prStaRec->u4MaxMpduLen)
-			break;
+	if (prBucket->u2Num == 0) {
+		u2Size += NIC_TX_DESC_LONG_FORMAT_LENGTH;
+		list_add_tail(&prBucket->rOpenEntry,
+			      &prHifInfo->rTxAmsduOpenQ);
+	} else
+		u2Size += kalGetPaddingSize(prBucket->u2Size);
 
-		u2TotalSize += u2Size;
-		u4Cnt++;
-	}
+	prTxReq = &prMsduInfo->rTxReq;
+	prTxReq->prMsduInfo = prMsduInfo;
+	prTxReq->u2AmsduNum = 1;
+	list_add_tail(&prTxReq->list, &prBucket->rMsduList);
+	prHifInfo->u4TxDataQLen++;
+	prBucket->u2Num++;
+	prBucket->u2Size += u2Size;
 
-	if (u2TotalSize < prStaRec->u4MinMpduLen)
-		return 1;
+	if (prBucket->u2Num >= prStaRec->ucMaxMpduCount)
+		kalCloseTxAmsduBucket(prGlueInfo, prBucket);
 
-	*pu2Size = u2TotalSize;
-	return u4Cnt;
+	return true;
 }
 
 static bool kalDevKickAmsduData(struct GLUE_INFO *prGlueInfo)
 {
 	struct GL_HIF_INFO *prHifInfo = NULL;
-	struct BUS_INFO *prBusInfo = NULL;
-	struct list_head *prHead, *prCur, *prNext;
+	struct TX_AMSDU_BUCKET *prBucket, *prNextBucket;
+	struct list_head *prHead, *prCur;
 	struct TX_DATA_REQ *prTxReq;
-	struct MSDU_INFO *prMsduInfo;
-	uint32_t u4Num = 0, u4Idx;
-	uint16_t u2Size = 0;
 	bool fgRet = true;
 
 	ASSERT(prGlueInfo);
 
 	prHifInfo = &prGlueInfo->rHifInfo;
-	prBusInfo = prGlueInfo->prAdapter->chip_info->bus_info;
+
+	/* Kick ends the TX batch, flush partially filled buckets */
+	list_for_each_entry_safe(prBucket, prNextBucket,
+				 &prHifInfo->rTxAmsduOpenQ, rOpenEntry)
+		kalCloseTxAmsduBucket(prGlueInfo, prBucket);
 
 	prHead = &prHifInfo->rTxDataQ;
-	list_for_each_safe(prCur, prNext, prHead) {
+	while (!list_empty(prHead)) {
+		prCur = prHead->next;
 		prTxReq = list_entry(prCur, struct TX_DATA_REQ, list);
-		prMsduInfo = prTxReq->prMsduInfo;
-		if (!kalIsAggregatedMsdu(prGlueInfo, prMsduInfo)) {
-			if (!halWpdmaWriteMsdu(prGlueInfo, prMsduInfo, prCur))
-				return false;
-		}
-	}
-
-	list_sort((void *)prGlueInfo, prHead, kalAmsduTxDCmp);
-
-	for (prCur = prHead->next; prCur != prHead; prCur = prNext) {
-		u4Num = kalGetNumOfAmsdu(prGlueInfo, prCur, prHead, &u2Size);
-		prNext = prCur->next;
-		if (u4Num > 1) {
-			for (u4Idx = 1; u4Idx < u4Num; u4Idx++)
-				prNext = prNext->next;
+		if (prTxReq->u2AmsduNum > 1)
 			fgRet = halWpdmaWriteAmsdu(prGlueInfo, prCur,
-						   u4Num, u2Size);
-		} else {
-			prTxReq = list_entry(prCur, struct TX_DATA_REQ, list);
-			prMsduInfo = prTxReq->prMsduInfo;
-			fgRet = halWpdmaWriteMsdu(prGlueInfo, prMsduInfo,
-						  prCur);
-		}
+						   prTxReq->u2AmsduNum,
+						   prTxReq->u2AmsduSize);
+		else
+			fgRet = prTxReq->prMsduInfo &&
+				halWpdmaWriteMsdu(prGlueInfo,
+						  prTxReq->prMsduInfo, prCur);
 		if (!fgRet)
 			break;
 	}
@@ -876,6 +931,47 @@ static bool kalDevKickAmsduData(struct GLUE_INFO *prGlueInfo)
 	return fgRet;
 }
 
+void kalDevTxAmsduInit(struct GLUE_INFO *prGlueInfo)
+{
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	uint32_t u4Idx, u4Num = CFG_STA_REC_NUM * TX_DESC_TID_NUM;
+
+	INIT_LIST_HEAD(&prHifInfo->rTxAmsduOpenQ);
+
+	prHifInfo->prTxAmsduBucket = kalMemAlloc(
+		sizeof(struct TX_AMSDU_BUCKET) * u4Num, VIR_MEM_TYPE);
+	if (!prHifInfo->prTxAmsduBucket) {
+		DBGLOG(HAL, WARN, "SW A-MSDU disabled, no memory\n");
+		return;
+	}
+
+	for (u4Idx = 0; u4Idx < u4Num; u4Idx++) {
+		INIT_LIST_HEAD(&prHifInfo->prTxAmsduBucket[u4Idx].rMsduList);
+		INIT_LIST_HEAD(&prHifInfo->prTxAmsduBucket[u4Idx].rOpenEntry);
+		prHifInfo->prTxAmsduBucket[u4Idx].u2Num = 0;
+		prHifInfo->prTxAmsduBucket[u4Idx].u2Size = 0;
+	}
+}
+
+void kalDevTxAmsduUninit(struct GLUE_INFO *prGlueInfo)
+{
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	struct TX_AMSDU_BUCKET *prBucket, *prNextBucket;
+
+	if (!prHifInfo->prTxAmsduBucket)
+		return;
+
+	/* Hand staged MSDUs back to rTxDataQ for the caller to drop */
+	list_for_each_entry_safe(prBucket, prNextBucket,
+				 &prHifInfo->rTxAmsduOpenQ, rOpenEntry)
+		kalCloseTxAmsduBucket(prGlueInfo, prBucket);
+
+	kalMemFree(prHifInfo->prTxAmsduBucket, VIR_MEM_TYPE,
+		   sizeof(struct TX_AMSDU_BUCKET) *
+		   CFG_STA_REC_NUM * TX_DESC_TID_NUM);
+	prHifInfo->prTxAmsduBucket = NULL;
+}
+
 bool kalDevReadData(struct GLUE_INFO *prGlueInfo, uint16_t u2Port,
 		    struct SW_RFB *prSwRfb)
 {
@@ -1026,6 +1122,25 @@ skip:
 	return fgRet;
 }
 
+void *kalDevAllocRxPacket(struct GLUE_INFO *prGlueInfo, uint32_t u4Size,
+			  uint8_t **ppucData)
+{
+	struct HIF_MEM_OPS *prMemOps = &prGlueInfo->rHifInfo.rMemOps;
+	void *pvPacket = NULL;
+
+	/* Prefer the HIF RX buffer pool, fall back to a normal packet */
+	if (prMemOps->allocRxPacket)
+		pvPacket = prMemOps->allocRxPacket(&prGlueInfo->rHifInfo,
+						   u4Size, ppucData);
+
+	if (pvPacket)
+		kalResetPacket(prGlueInfo, pvPacket);
+	else
+		pvPacket = kalPacketAlloc(prGlueInfo, u4Size, ppucData);
+
+	return pvPacket;
+}
+
 
 #if (CFG_SUPPORT_CONNAC3X == 1)
 int wf_ioremap_read(phys_addr_t addr, unsigned int *val)
@@ -107,6 +107,15 @@
 
 #define PCIE_ASPM_CHECK_L1(reg)	((((reg) & PCI_EXP_LNKCAP_ASPMS) >> 10) & 0x2)
 
+#endif
+
+#if CFG_SUPPORT_PCIE_RX_POOL
+/* Max buffers of the RX pool: the data ring, all SW RFBs and the packets
+ * still held by the OS.
+ */
+#define PCIE_RX_POOL_SIZE	(RX_RING0_SIZE * 2 + CFG_RX_MAX_PKT_NUM)
+/* Max buffers checked for reuse per allocation */
+#define PCIE_RX_POOL_SCAN_NUM	32
 #endif
 /*******************************************************************************
  *                             D A T A   T Y P E S
@@ -130,6 +139,8 @@ struct HIF_MEM_OPS {
 			    struct RTMP_DMABUF *prDmaBuf,
 			    uint32_t u4Num, uint32_t u4Idx);
 	void *(*allocRuntimeMem)(uint32_t u4SrcLen);
+	void *(*allocRxPacket)(struct GL_HIF_INFO *prHifInfo,
+			       uint32_t u4Size, uint8_t **ppucData);
 	bool (*copyCmd)(struct GL_HIF_INFO *prHifInfo,
 			struct RTMP_DMACB *prTxCell, void *pucBuf,
 			void *pucSrc1, uint32_t u4SrcLen1,
@@ -167,6 +178,33 @@ struct HIF_MEM_OPS {
 		       uint32_t u4Idx, uint32_t u4DumpLen);
 };
 
+#if CFG_SUPPORT_PCIE_RX_POOL
+struct PCIE_RX_POOL_ENTRY {
+	struct page *prPage;
+	dma_addr_t rDmaAddr;	/* Mapping of the data area */
+	uint64_t u8AllocTime;	/* Last time it was handed out */
+};
+
+/* Each buffer is a page which holds a reference for the pool. The buffer is
+ * free again when the OS has dropped the reference of its skb.
+ */
+struct PCIE_RX_POOL {
+	struct PCIE_RX_POOL_ENTRY *prEntry;
+	uint32_t u4Num;		/* Buffers allocated so far */
+	uint32_t u4ScanIdx;	/* Next buffer to check for reuse */
+	uint32_t u4Order;	/* Page order of a buffer */
+	uint32_t u4Headroom;
+	uint32_t u4DataSize;	/* Size of the mapped data area */
+	spinlock_t rLock;
+
+	uint32_t u4HitCnt;	/* Buffer reused */
+	uint32_t u4GrowCnt;	/* Buffer added to the pool */
+	uint32_t u4MissCnt;	/* Fall back to a normal packet */
+	uint64_t u8RecycleTotalUs;
+	uint32_t u4RecycleMaxUs;
+};
+#endif
+
 /* host interface's private data structure, which is attached to os glue
  ** layer info structure.
  */
@@ -215,6 +253,10 @@ struct GL_HIF_INFO {
 	struct list_head rTxCmdQ;
 	struct list_head rTxDataQ;
 	uint32_t u4TxDataQLen;
+	struct TX_AMSDU_BUCKET *prTxAmsduBucket;	/* [STA][TID] */
+	struct list_head rTxAmsduOpenQ;
+	/* nesting of TX doorbell bursts, by halWpdmaTxBurstSlot() */
+	int32_t ai4TxBurstDepth[HIF_TX_BURST_SLOT_NUM];
 
 	bool fgIsPowerOff;
 	bool fgIsDumpLog;
@@ -223,6 +265,10 @@ struct GL_HIF_INFO {
 
 	uint32_t u4PcieLTR;
 	uint32_t u4PcieASPM;
+
+#if CFG_SUPPORT_PCIE_RX_POOL
+	struct PCIE_RX_POOL rRxPool;
+#endif
 };
 
 struct BUS_INFO {
@@ -249,6 +249,16 @@ static void pcieDumpTx(struct GL_HIF_INFO *prHifInfo,
 static void pcieDumpRx(struct GL_HIF_INFO *prHifInfo,
 		       struct RTMP_RX_RING *prRxRing,
 		       uint32_t u4Idx, uint32_t u4DumpLen);
+#if CFG_SUPPORT_PCIE_RX_POOL
+static void pcieRxPoolInit(struct GLUE_INFO *prGlueInfo);
+static void pcieRxPoolUninit(struct GL_HIF_INFO *prHifInfo);
+static struct PCIE_RX_POOL_ENTRY *pcieRxPoolGetEntry(
+	struct GL_HIF_INFO *prHifInfo, void *pvPacket);
+static struct PCIE_RX_POOL_ENTRY *pcieRxPoolGetEntryByPa(
+	struct GL_HIF_INFO *prHifInfo, phys_addr_t rDmaAddr);
+static void *pcieAllocRxPacket(struct GL_HIF_INFO *prHifInfo,
+			       uint32_t u4Size, uint8_t **ppucData);
+#endif
 
 /*******************************************************************************
  *                              F U N C T I O N S
@@ -692,6 +702,7 @@ void glSetHifInfo(struct GLUE_INFO *prGlueInfo, unsigned long ulCookie)
 	INIT_LIST_HEAD(&prHif->rTxCmdQ);
 	INIT_LIST_HEAD(&prHif->rTxDataQ);
 	prHif->u4TxDataQLen = 0;
+	kalDevTxAmsduInit(prGlueInfo);
 
 	prHif->fgIsPowerOff = true;
 	prHif->fgIsDumpLog = false;
@@ -702,6 +713,9 @@ void glSetHifInfo(struct GLUE_INFO *prGlueInfo, unsigned long ulCookie)
 	prMemOps->allocTxDataBuf = pcieAllocTxDataBuf;
 	prMemOps->allocRxBuf = pcieAllocRxBuf;
 	prMemOps->allocRuntimeMem = pcieAllocRuntimeMem;
+#if CFG_SUPPORT_PCIE_RX_POOL
+	prMemOps->allocRxPacket = pcieAllocRxPacket;
+#endif
 	prMemOps->copyCmd = pcieCopyCmd;
 	prMemOps->copyEvent = pcieCopyEvent;
 	prMemOps->copyTxData = pcieCopyTxData;
@@ -716,6 +730,10 @@ void glSetHifInfo(struct GLUE_INFO *prGlueInfo, unsigned long ulCookie)
 	prMemOps->freePacket = pcieFreePacket;
 	prMemOps->dumpTx = pcieDumpTx;
 	prMemOps->dumpRx = pcieDumpRx;
+
+#if CFG_SUPPORT_PCIE_RX_POOL
+	pcieRxPoolInit(prGlueInfo);
+#endif
 }
 
 /*----------------------------------------------------------------------------*/
@@ -742,6 +760,9 @@ void glClearHifInfo(struct GLUE_INFO *prGlueInfo)
 
 	halUninitMsduTokenInfo(prGlueInfo->prAdapter);
 	halWpdmaFreeRing(prGlueInfo);
+#if CFG_SUPPORT_PCIE_RX_POOL
+	pcieRxPoolUninit(prHifInfo);
+#endif
 
 	list_for_each_safe(prCur, prNext, &prHifInfo->rTxCmdQ) {
 		prTxCmdReq = list_entry(prCur, struct TX_CMD_REQ, list);
@@ -749,6 +770,7 @@ void glClearHifInfo(struct GLUE_INFO *prGlueInfo)
 		kfree(prTxCmdReq);
 	}
 
+	kalDevTxAmsduUninit(prGlueInfo);
 	list_for_each_safe(prCur, prNext, &prHifInfo->rTxDataQ) {
 		prTxDataReq = list_entry(prCur, struct TX_DATA_REQ, list);
 		list_del(prCur);
@@ -1092,18 +1114,40 @@ static bool pcieCopyRxData(struct GL_HIF_INFO *prHifInfo,
 {
 	void *pRxPacket = NULL;
 	dma_addr_t rAddr;
+#if CFG_SUPPORT_PCIE_RX_POOL
+	struct PCIE_RX_POOL_ENTRY *prEntry;
+#endif
 
 	pRxPacket = pRxCell->pPacket;
 	ASSERT(pRxPacket);
 
 	pRxCell->pPacket = prSwRfb->pvPacket;
 
+#if CFG_SUPPORT_PCIE_RX_POOL
+	/* Buffers of the RX pool stay mapped, only pass the ownership */
+	prEntry = pcieRxPoolGetEntry(prHifInfo, pRxPacket);
+	if (prEntry)
+		KAL_DMA_SYNC_SINGLE_FOR_CPU(prHifInfo->prDmaDev,
+			prEntry->rDmaAddr, prHifInfo->rRxPool.u4DataSize,
+			KAL_DMA_FROM_DEVICE);
+	else
+#endif
 	KAL_DMA_UNMAP_SINGLE(prHifInfo->prDmaDev,
 			     (dma_addr_t)prDmaBuf->AllocPa,
 			     prDmaBuf->AllocSize, KAL_DMA_FROM_DEVICE);
 	prSwRfb->pvPacket = pRxPacket;
 
 	prDmaBuf->AllocVa = ((struct sk_buff *)pRxCell->pPacket)->data;
+#if CFG_SUPPORT_PCIE_RX_POOL
+	prEntry = pcieRxPoolGetEntry(prHifInfo, pRxCell->pPacket);
+	if (prEntry) {
+		KAL_DMA_SYNC_SINGLE_FOR_DEVICE(prHifInfo->prDmaDev,
+			prEntry->rDmaAddr, prHifInfo->rRxPool.u4DataSize,
+			KAL_DMA_FROM_DEVICE);
+		prDmaBuf->AllocPa = (phys_addr_t)prEntry->rDmaAddr;
+		return true;
+	}
+#endif
 	rAddr = KAL_DMA_MAP_SINGLE(prHifInfo->prDmaDev,
 		prDmaBuf->AllocVa, prDmaBuf->AllocSize, KAL_DMA_FROM_DEVICE);
 	if (KAL_DMA_MAPPING_ERROR(prHifInfo->prDmaDev, rAddr)) {
@@ -1157,6 +1201,12 @@ static void pcieUnmapTxBuf(struct GL_HIF_INFO *prHifInfo,
 static void pcieUnmapRxBuf(struct GL_HIF_INFO *prHifInfo,
 			   phys_addr_t rDmaAddr, uint32_t u4Len)
 {
+#if CFG_SUPPORT_PCIE_RX_POOL
+	/* Mappings of the RX pool are released with the pool */
+	if (pcieRxPoolGetEntryByPa(prHifInfo, rDmaAddr))
+		return;
+#endif
+
 	KAL_DMA_UNMAP_SINGLE(prHifInfo->prDmaDev,
 			     (dma_addr_t)rDmaAddr,
 			     u4Len, KAL_DMA_FROM_DEVICE);
@@ -1209,6 +1259,9 @@ static void pcieDumpRx(struct GL_HIF_INFO *prHifInfo,
 {
 	struct RTMP_DMACB *prRxCell;
 	struct RTMP_DMABUF *prDmaBuf;
+#if CFG_SUPPORT_PCIE_RX_POOL
+	struct PCIE_RX_POOL_ENTRY *prEntry;
+#endif
 
 	prRxCell = &prRxRing->Cell[u4Idx];
 	prDmaBuf = &prRxCell->DmaBuf;
@@ -1216,6 +1269,22 @@ static void pcieDumpRx(struct GL_HIF_INFO *prHifInfo,
 	if (!prRxCell->pPacket)
 		return;
 
+#if CFG_SUPPORT_PCIE_RX_POOL
+	prEntry = pcieRxPoolGetEntry(prHifInfo, prRxCell->pPacket);
+	if (prEntry) {
+		KAL_DMA_SYNC_SINGLE_FOR_CPU(prHifInfo->prDmaDev,
+			prEntry->rDmaAddr, prHifInfo->rRxPool.u4DataSize,
+			KAL_DMA_FROM_DEVICE);
+		DBGLOG_MEM32(HAL, INFO,
+			     ((struct sk_buff *)prRxCell->pPacket)->data,
+			     u4DumpLen);
+		KAL_DMA_SYNC_SINGLE_FOR_DEVICE(prHifInfo->prDmaDev,
+			prEntry->rDmaAddr, prHifInfo->rRxPool.u4DataSize,
+			KAL_DMA_FROM_DEVICE);
+		return;
+	}
+#endif
+
 	pcieUnmapRxBuf(prHifInfo, prDmaBuf->AllocPa, prDmaBuf->AllocSize);
 
 	DBGLOG_MEM32(HAL, INFO, ((struct sk_buff *)prRxCell->pPacket)->data,
@@ -1225,6 +1294,208 @@ static void pcieDumpRx(struct GL_HIF_INFO *prHifInfo,
 					0, prDmaBuf->AllocSize);
 }
 
+#if CFG_SUPPORT_PCIE_RX_POOL
+static void pcieRxPoolInit(struct GLUE_INFO *prGlueInfo)
+{
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	struct PCIE_RX_POOL *prPool = &prHifInfo->rRxPool;
+	uint32_t u4BufSize;
+
+	kalMemZero(prPool, sizeof(struct PCIE_RX_POOL));
+	spin_lock_init(&prPool->rLock);
+
+	/* Same headroom as kalPacketAlloc, and keep the mapped data area
+	 * apart from the cache lines written by the CPU.
+	 */
+#if (CFG_SUPPORT_SNIFFER_RADIOTAP == 1)
+	prPool->u4Headroom = CFG_RADIOTAP_HEADROOM;
+#else
+	prPool->u4Headroom = NIC_TX_DESC_AND_PADDING_LENGTH +
+		prGlueInfo->prAdapter->chip_info->txd_append_size;
+#endif
+	prPool->u4Headroom = L1_CACHE_ALIGN(prPool->u4Headroom);
+	prPool->u4DataSize = SKB_DATA_ALIGN(CFG_RX_MAX_MPDU_SIZE);
+	u4BufSize = prPool->u4Headroom + prPool->u4DataSize +
+		SKB_DATA_ALIGN(sizeof(struct skb_shared_info));
+	prPool->u4Order = get_order(u4BufSize);
+
+	prPool->prEntry = kalMemAlloc(
+		sizeof(struct PCIE_RX_POOL_ENTRY) * PCIE_RX_POOL_SIZE,
+		VIR_MEM_TYPE);
+	if (!prPool->prEntry) {
+		DBGLOG(HAL, WARN, "RX pool disabled, no memory\n");
+		return;
+	}
+	kalMemZero(prPool->prEntry,
+		   sizeof(struct PCIE_RX_POOL_ENTRY) * PCIE_RX_POOL_SIZE);
+
+	DBGLOG(HAL, INFO, "RX pool: max[%u] order[%u] headroom[%u]\n",
+	       PCIE_RX_POOL_SIZE, prPool->u4Order, prPool->u4Headroom);
+}
+
+static void pcieRxPoolUninit(struct GL_HIF_INFO *prHifInfo)
+{
+	struct PCIE_RX_POOL *prPool = &prHifInfo->rRxPool;
+	struct PCIE_RX_POOL_ENTRY *prEntry;
+	uint32_t u4Idx;
+
+	if (!prPool->prEntry)
+		return;
+
+	/* Packets still held by the OS keep their page until released */
+	for (u4Idx = 0; u4Idx < prPool->u4Num; u4Idx++) {
+		prEntry = &prPool->prEntry[u4Idx];
+		KAL_DMA_UNMAP_SINGLE(prHifInfo->prDmaDev, prEntry->rDmaAddr,
+				     prPool->u4DataSize, KAL_DMA_FROM_DEVICE);
+		set_page_private(prEntry->prPage, 0);
+		put_page(prEntry->prPage);
+	}
+
+	kalMemFree(prPool->prEntry, VIR_MEM_TYPE,
+		   sizeof(struct PCIE_RX_POOL_ENTRY) * PCIE_RX_POOL_SIZE);
+	prPool->prEntry = NULL;
+	prPool->u4Num = 0;
+}
+
+static struct PCIE_RX_POOL_ENTRY *pcieRxPoolGetEntry(
+	struct GL_HIF_INFO *prHifInfo, void *pvPacket)
+{
+	struct PCIE_RX_POOL *prPool = &prHifInfo->rRxPool;
+	struct sk_buff *prSkb = (struct sk_buff *)pvPacket;
+	struct PCIE_RX_POOL_ENTRY *prEntry;
+	struct page *prPage;
+	unsigned long ulOffset;
+
+	/* Pool buffers are the only page fragment heads on the RX ring */
+	if (!prPool->prEntry || !prSkb || !prSkb->head_frag)
+		return NULL;
+
+	prPage = virt_to_head_page(prSkb->head);
+	prEntry = (struct PCIE_RX_POOL_ENTRY *)page_private(prPage);
+	ulOffset = (unsigned long)prEntry - (unsigned long)prPool->prEntry;
+	if (ulOffset >= sizeof(struct PCIE_RX_POOL_ENTRY) *
+	    PCIE_RX_POOL_SIZE || prEntry->prPage != prPage)
+		return NULL;
+
+	return prEntry;
+}
+
+static struct PCIE_RX_POOL_ENTRY *pcieRxPoolGetEntryByPa(
+	struct GL_HIF_INFO *prHifInfo, phys_addr_t rDmaAddr)
+{
+	struct PCIE_RX_POOL *prPool = &prHifInfo->rRxPool;
+	uint32_t u4Idx;
+
+	if (!prPool->prEntry)
+		return NULL;
+
+	for (u4Idx = 0; u4Idx < prPool->u4Num; u4Idx++) {
+		if ((phys_addr_t)prPool->prEntry[u4Idx].rDmaAddr == rDmaAddr)
+			return &prPool->prEntry[u4Idx];
+	}
+
+	return NULL;
+}
+
+static u_int8_t pcieRxPoolAddEntry(struct GL_HIF_INFO *prHifInfo,
+				   struct PCIE_RX_POOL_ENTRY *prEntry)
+{
+	struct PCIE_RX_POOL *prPool = &prHifInfo->rRxPool;
+	struct page *prPage;
+	dma_addr_t rAddr;
+
+	prPage = alloc_pages(GFP_ATOMIC | __GFP_COMP | __GFP_NOWARN,
+			     prPool->u4Order);
+	if (!prPage)
+		return FALSE;
+
+	rAddr = KAL_DMA_MAP_SINGLE(prHifInfo->prDmaDev,
+				   page_address(prPage) + prPool->u4Headroom,
+				   prPool->u4DataSize, KAL_DMA_FROM_DEVICE);
+	if (KAL_DMA_MAPPING_ERROR(prHifInfo->prDmaDev, rAddr)) {
+		DBGLOG(HAL, ERROR, "KAL_DMA_MAP_SINGLE() error!\n");
+		__free_pages(prPage, prPool->u4Order);
+		return FALSE;
+	}
+	/* The CPU owns a buffer until it is put on the RX ring */
+	KAL_DMA_SYNC_SINGLE_FOR_CPU(prHifInfo->prDmaDev, rAddr,
+				    prPool->u4DataSize, KAL_DMA_FROM_DEVICE);
+
+	prEntry->prPage = prPage;
+	prEntry->rDmaAddr = rAddr;
+	set_page_private(prPage, (unsigned long)prEntry);
+
+	return TRUE;
+}
+
+static void *pcieAllocRxPacket(struct GL_HIF_INFO *prHifInfo,
+			       uint32_t u4Size, uint8_t **ppucData)
+{
+	struct PCIE_RX_POOL *prPool = &prHifInfo->rRxPool;
+	struct PCIE_RX_POOL_ENTRY *prEntry = NULL;
+	struct sk_buff *prSkb;
+	unsigned long ulFlags;
+	uint64_t u8CurTime;
+	uint32_t u4Cnt, u4Idx, u4RecycleUs;
+
+	if (!prPool->prEntry || u4Size > prPool->u4DataSize)
+		return NULL;
+
+	u8CurTime = sched_clock();
+
+	spin_lock_irqsave(&prPool->rLock, ulFlags);
+
+	/* A buffer only referenced by the pool has been released by the OS */
+	for (u4Cnt = 0; u4Cnt < prPool->u4Num &&
+	     u4Cnt < PCIE_RX_POOL_SCAN_NUM; u4Cnt++) {
+		u4Idx = prPool->u4ScanIdx;
+		prPool->u4ScanIdx = (u4Idx + 1 < prPool->u4Num) ?
+			(u4Idx + 1) : 0;
+
+		if (page_ref_count(prPool->prEntry[u4Idx].prPage) == 1) {
+			prEntry = &prPool->prEntry[u4Idx];
+			break;
+		}
+	}
+
+	if (prEntry) {
+		u4RecycleUs = (uint32_t)div_u64(u8CurTime -
+			prEntry->u8AllocTime, NSEC_PER_USEC);
+		prPool->u4HitCnt++;
+		prPool->u8RecycleTotalUs += u4RecycleUs;
+		if (u4RecycleUs > prPool->u4RecycleMaxUs)
+			prPool->u4RecycleMaxUs = u4RecycleUs;
+	} else if (prPool->u4Num < PCIE_RX_POOL_SIZE &&
+		   pcieRxPoolAddEntry(prHifInfo,
+				      &prPool->prEntry[prPool->u4Num])) {
+		prEntry = &prPool->prEntry[prPool->u4Num];
+		prPool->u4Num++;
+		prPool->u4GrowCnt++;
+	} else {
+		prPool->u4MissCnt++;
+		spin_unlock_irqrestore(&prPool->rLock, ulFlags);
+		return NULL;
+	}
+
+	/* Reference of the skb, the pool keeps its own */
+	get_page(prEntry->prPage);
+	prEntry->u8AllocTime = u8CurTime;
+
+	spin_unlock_irqrestore(&prPool->rLock, ulFlags);
+
+	prSkb = build_skb(page_address(prEntry->prPage),
+			  PAGE_SIZE << prPool->u4Order);
+	if (!prSkb) {
+		put_page(prEntry->prPage);
+		return NULL;
+	}
+	skb_reserve(prSkb, prPool->u4Headroom);
+	*ppucData = prSkb->data;
+
+	return (void *)prSkb;
+}
+#endif /* CFG_SUPPORT_PCIE_RX_POOL */
+
 #if CFG_CHIP_RESET_SUPPORT
 void kalRemoveProbe(IN struct GLUE_INFO *prGlueInfo)
 {
@@ -1494,7 +1494,7 @@ void halRxSDIOReceiveRFBs(IN struct ADAPTER *prAdapter)
 		}
 
 		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
-		QUEUE_INSERT_TAIL(&prRxCtrl->rReceivedRfbList, &prSwRfb->rQueEntry);
+		nicRxEnqueueReceivedRFB(prAdapter, prSwRfb);
 		RX_INC_CNT(prRxCtrl, RX_MPDU_TOTAL_COUNT);
 		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 
@@ -1682,7 +1682,7 @@ void halRxSDIOEnhanceReceiveRFBs(IN struct ADAPTER *prAdapter)
 			/* prSDIOCtrl->au4RxLength[i] = 0; */
 
 			KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
-			QUEUE_INSERT_TAIL(&prRxCtrl->rReceivedRfbList, &prSwRfb->rQueEntry);
+			nicRxEnqueueReceivedRFB(prAdapter, prSwRfb);
 			RX_INC_CNT(prRxCtrl, RX_MPDU_TOTAL_COUNT);
 			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 		}
@@ -2885,13 +2885,15 @@ void halDeAggRxPktProc(struct ADAPTER *prAdapter,
 		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 		RX_ADD_CNT(prRxCtrl, RX_MPDU_TOTAL_COUNT,
 			prTempRxRfbList->u4NumElem);
-		QUEUE_CONCATENATE_QUEUES(&prRxCtrl->rReceivedRfbList,
-			prTempRxRfbList);
+		while (QUEUE_IS_NOT_EMPTY(prTempRxRfbList)) {
+			QUEUE_REMOVE_HEAD(prTempRxRfbList, prSwRfb,
+				struct SW_RFB *);
+			nicRxEnqueueReceivedRFB(prAdapter, prSwRfb);
+		}
 		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 #if CFG_SUPPORT_MULTITHREAD
-		/* Wake up Rx handling thread */
-		set_bit(GLUE_FLAG_RX_BIT, &(prAdapter->prGlueInfo->ulFlag));
-		wake_up_interruptible(&(prAdapter->prGlueInfo->waitq));
+		/* Wake up Rx handling threads */
+		kalSetRxProcessEvent(prAdapter->prGlueInfo);
 #endif
 	}
 
@@ -949,14 +949,14 @@ uint32_t halRxUSBEnqueueRFB(
 					break;
 				default:
 					KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
-					QUEUE_INSERT_TAIL(&prRxCtrl->rReceivedRfbList, &prSwRfb->rQueEntry);
+					nicRxEnqueueReceivedRFB(prAdapter, prSwRfb);
 					KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 					u4EnqCnt++;
 					break;
 				}
 			} else {
 				KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
-				QUEUE_INSERT_TAIL(&prRxCtrl->rReceivedRfbList, &prSwRfb->rQueEntry);
+				nicRxEnqueueReceivedRFB(prAdapter, prSwRfb);
 				KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
 				u4EnqCnt++;
 			}
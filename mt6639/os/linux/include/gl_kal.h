@@ -140,7 +140,10 @@ extern struct delayed_work cfg80211_workq;
 	(GLUE_FLAG_HALT | GLUE_FLAG_INT | GLUE_FLAG_HIF_TX | \
 	GLUE_FLAG_HIF_TX_CMD | GLUE_FLAG_HIF_FW_OWN)
 
-#define GLUE_FLAG_RX_PROCESS (GLUE_FLAG_HALT | GLUE_FLAG_RX_TO_OS)
+#define GLUE_FLAG_RX_PROCESS \
+	(GLUE_FLAG_HALT | GLUE_FLAG_RX_TO_OS | GLUE_FLAG_RX_DATA)
+
+#define GLUE_FLAG_TX_DATA_PROCESS (GLUE_FLAG_HALT | GLUE_FLAG_TX_DATA)
 #else
 /* All flags for single thread driver */
 #define GLUE_FLAG_MAIN_PROCESS  0xFFFFFFFF
@@ -158,6 +161,9 @@ extern struct delayed_work cfg80211_workq;
 #define COALESCING_INT_MAX_PKT (50)
 #endif
 
+/* Number of TX port queue locks, shall not be less than TX_PORT_NUM */
+#define SPIN_LOCK_TX_PORT_QUE_NUM	16
+
 #if CFG_SUPPORT_DATA_STALL
 #define REPORT_EVENT_INTERVAL		30
 #define EVENT_PER_HIGH_THRESHOLD	80
@@ -174,7 +180,10 @@ enum ENUM_SPIN_LOCK_CATEGORY_E {
 	SPIN_LOCK_FSM = 0,
 
 #if CFG_SUPPORT_MULTITHREAD
+	/* one lock per TX port queue, see TX_PORT_QUE_LOCK() */
 	SPIN_LOCK_TX_PORT_QUE,
+	SPIN_LOCK_TX_PORT_QUE_LAST =
+		SPIN_LOCK_TX_PORT_QUE + SPIN_LOCK_TX_PORT_QUE_NUM - 1,
 	SPIN_LOCK_TX_CMD_QUE,
 	SPIN_LOCK_TX_CMD_DONE_QUE,
 	SPIN_LOCK_TC_RESOURCE,
@@ -223,7 +232,6 @@ enum ENUM_SPIN_LOCK_CATEGORY_E {
 	SPIN_LOCK_MSG_BUF,
 	SPIN_LOCK_STA_REC,
 
-	SPIN_LOCK_MAILBOX,
 	SPIN_LOCK_TIMER,
 
 	SPIN_LOCK_BOW_TABLE,
@@ -415,6 +423,13 @@ enum ENUM_PKT_PATH {
 /*----------------------------------------------------------------------------*/
 #define KAL_GET_CURRENT_THREAD_ID() (current->pid)
 #define KAL_GET_CURRENT_THREAD_NAME() (current->comm)
+#define KAL_GET_CURRENT_CPU_ID() raw_smp_processor_id()
+
+/*----------------------------------------------------------------------------*/
+/* Macros of checking the execution context                                   */
+/*----------------------------------------------------------------------------*/
+#define KAL_IS_SOFTIRQ_CONTEXT() (in_serving_softirq() && !hardirq_count())
+#define KAL_IS_INTERRUPT_CONTEXT() in_interrupt()
 
 /*----------------------------------------------------------------------------*/
 /* Macros of SPIN LOCK operations for using in Driver Layer                   */
@@ -451,6 +466,14 @@ enum ENUM_PKT_PATH {
 #define KAL_GET_PKT_HEADER_LEN(_p)              GLUE_GET_PKT_HEADER_LEN(_p)
 #define KAL_GET_PKT_PAYLOAD_LEN(_p)             GLUE_GET_PKT_PAYLOAD_LEN(_p)
 #define KAL_GET_PKT_ARRIVAL_TIME(_p)            GLUE_GET_PKT_ARRIVAL_TIME(_p)
+/* Stack has more packets to hand over right after this one */
+#if KERNEL_VERSION(5, 2, 0) <= LINUX_VERSION_CODE
+#define KAL_IS_PKT_XMIT_MORE(_p)                netdev_xmit_more()
+#elif KERNEL_VERSION(3, 18, 0) <= LINUX_VERSION_CODE
+#define KAL_IS_PKT_XMIT_MORE(_p)                ((_p)->xmit_more)
+#else
+#define KAL_IS_PKT_XMIT_MORE(_p)                FALSE
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* Macros for kernel related defines                      */
@@ -926,6 +949,12 @@ kalCfg80211VendorEventAlloc(struct wiphy *wiphy, struct wireless_dev *wdev,
 #define kalMemMove(pvDst, pvSrc, u4Size)  \
 	memmove(pvDst, pvSrc, u4Size)
 
+/* CRC-32 (IEEE 802.3), same as zlib crc32(). crc32_le() is slice-by-8
+ * and uses the arch CRC/PCLMUL instructions when the kernel has them.
+ */
+#define kalCRC32(pucBuf, u4Len)  \
+	(~crc32_le(~0, pucBuf, u4Len))
+
 #if KERNEL_VERSION(4, 0, 0) <= LINUX_VERSION_CODE
 #define strnicmp(s1, s2, n)                         strncasecmp(s1, s2, n)
 #endif
@@ -1116,6 +1145,12 @@ do { \
 	dma_unmap_single(&((struct pci_dev *)(_dev))->dev, _addr, _size, _dir)
 #define KAL_DMA_MAPPING_ERROR(_dev, _addr) \
 	dma_mapping_error(&((struct pci_dev *)(_dev))->dev, _addr)
+#define KAL_DMA_SYNC_SINGLE_FOR_CPU(_dev, _addr, _size, _dir) \
+	dma_sync_single_for_cpu(&((struct pci_dev *)(_dev))->dev, \
+			_addr, _size, _dir)
+#define KAL_DMA_SYNC_SINGLE_FOR_DEVICE(_dev, _addr, _size, _dir) \
+	dma_sync_single_for_device(&((struct pci_dev *)(_dev))->dev, \
+			_addr, _size, _dir)
 #else
 #define KAL_DMA_ALLOC_COHERENT(_dev, _size, _handle) \
 	pci_alloc_consistent(_dev, _size, _handle)
@@ -1127,6 +1162,10 @@ do { \
 	pci_unmap_single(_dev, _addr, _size, _dir)
 #define KAL_DMA_MAPPING_ERROR(_dev, _addr) \
 	pci_dma_mapping_error(_dev, _addr)
+#define KAL_DMA_SYNC_SINGLE_FOR_CPU(_dev, _addr, _size, _dir) \
+	pci_dma_sync_single_for_cpu(_dev, _addr, _size, _dir)
+#define KAL_DMA_SYNC_SINGLE_FOR_DEVICE(_dev, _addr, _size, _dir) \
+	pci_dma_sync_single_for_device(_dev, _addr, _size, _dir)
 #endif
 #else
 #define KAL_DMA_TO_DEVICE	DMA_TO_DEVICE
@@ -1142,6 +1181,10 @@ do { \
 	dma_unmap_single(_dev, _addr, _size, _dir)
 #define KAL_DMA_MAPPING_ERROR(_dev, _addr) \
 	dma_mapping_error(_dev, _addr)
+#define KAL_DMA_SYNC_SINGLE_FOR_CPU(_dev, _addr, _size, _dir) \
+	dma_sync_single_for_cpu(_dev, _addr, _size, _dir)
+#define KAL_DMA_SYNC_SINGLE_FOR_DEVICE(_dev, _addr, _size, _dir) \
+	dma_sync_single_for_device(_dev, _addr, _size, _dir)
 #endif
 
 #if defined(_HIF_AXI)
@@ -1592,7 +1635,13 @@ void kalSetTxCmdEvent2Hif(struct GLUE_INFO *pr);
 void kalSetTxCmdDoneEvent(struct GLUE_INFO *pr);
 
 void kalSetRxProcessEvent(struct GLUE_INFO *pr);
+
+void kalSetTxDataEvent(struct GLUE_INFO *pr);
 #endif
+
+void kalRaiseEvent(struct GLUE_INFO *pr, uint32_t u4Bit);
+
+u_int8_t kalTestAndClearEvent(struct GLUE_INFO *pr, uint32_t u4Bit);
 /*----------------------------------------------------------------------------*/
 /* NVRAM/Registry Service                                                     */
 /*----------------------------------------------------------------------------*/
@@ -1849,6 +1898,7 @@ int main_thread(void *data);
 #if CFG_SUPPORT_MULTITHREAD
 int hif_thread(void *data);
 int rx_thread(void *data);
+int tx_thread(void *data);
 #endif
 uint64_t kalGetBootTime(void);
 
@@ -1989,6 +2039,7 @@ void kal_sched_set(struct task_struct *p, int policy,
 		const struct sched_param *param,
 		int nice);
 void kalSetThreadSchPolicyPriority(IN struct GLUE_INFO *prGlueInfo);
+void kalSetThreadCpuMask(IN uint32_t u4CpuMask);
 
 #ifndef __has_attribute
 #define __has_attribute(x) 0
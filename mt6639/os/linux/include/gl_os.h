@@ -167,6 +167,7 @@
 
 #include <linux/firmware.h>	/* for firmware download */
 #include <linux/ctype.h>
+#include <linux/crc32.h>	/* crc32_le() */
 
 #include <linux/interrupt.h>
 
@@ -240,6 +241,7 @@
 #include "gl_typedef.h"
 #include "typedef.h"
 #include "queue.h"
+#include "token_pool.h"
 #include "gl_kal.h"
 #include "gl_rst.h"
 #include "hif.h"
@@ -345,6 +347,15 @@ extern void update_driver_loaded_status(uint8_t loaded);
 #define GLUE_FLAG_NAN_MULTICAST_BIT (20)
 #define GLUE_FLAG_NAN_MULTICAST BIT(20)
 #endif
+#if CFG_SUPPORT_MULTITHREAD
+#define GLUE_FLAG_TX_DATA		BIT(21)
+#define GLUE_FLAG_TX_DATA_BIT		(21)
+#define GLUE_FLAG_RX_DATA		BIT(22)
+#define GLUE_FLAG_RX_DATA_BIT		(22)
+#endif
+
+/* Number of GLUE_FLAG bits tracked by the event delay statistics */
+#define GLUE_FLAG_BIT_NUM		32
 
 #define GLUE_BOW_KFIFO_DEPTH        (1024)
 /* #define GLUE_BOW_DEVICE_NAME        "MT6620 802.11 AMP" */
@@ -479,6 +490,7 @@ enum ENUM_PKT_FLAG {
 #if CFG_SUPPORT_TPENHANCE_MODE
 	ENUM_PKT_TCP_ACK,
 #endif /* CFG_SUPPORT_TPENHANCE_MODE */
+	ENUM_PKT_XMIT_MORE,	/* more packets follow from the stack */
 
 	ENUM_PKT_FLAG_NUM
 };
@@ -579,6 +591,13 @@ struct FT_IES {
 	uint32_t u4IeLength;
 };
 
+/* Queueing delay of one GLUE_FLAG event, raise to handler entry */
+struct GLUE_EVENT_STAT {
+	uint32_t u4HitCnt;
+	uint32_t u4MaxTime;	/* ns */
+	uint64_t u8TotalTime;	/* ns */
+};
+
 /*
  * type definition of pointer to p2p structure
  */
@@ -683,9 +702,13 @@ struct GLUE_INFO {
 	struct completion
 		rRxHaltComp;	/* indicate hif_thread halt complete */
 
+	struct completion
+		rTxHaltComp;	/* indicate tx_thread halt complete */
+
 	uint32_t u4TxThreadPid;
 	uint32_t u4RxThreadPid;
 	uint32_t u4HifThreadPid;
+	uint32_t u4TxDataThreadPid;
 #endif
 
 #if CFG_SUPPORT_NCHO
@@ -695,6 +718,11 @@ struct GLUE_INFO {
 
 	uint32_t rPendStatus;
 
+	/* OS TX frames pushed lock-free by QUEUE_MPSC_PUSH(), taken in one
+	 * swap by kalProcessTxData()
+	 */
+	struct QUE_ENTRY *prTxInbox;
+	/* frames QM could not take yet, under SPIN_LOCK_TX_QUE */
 	struct QUE rTxQueue;
 
 	/* OID related */
@@ -716,7 +744,14 @@ struct GLUE_INFO {
 	wait_queue_head_t waitq_rx;
 	struct task_struct *rx_thread;
 
+	wait_queue_head_t waitq_tx;
+	struct task_struct *tx_thread;
+
 #endif
+	/* Time a GLUE_FLAG bit was raised and its wait until handled */
+	uint64_t au8EventSetTime[GLUE_FLAG_BIT_NUM];	/* ns */
+	struct GLUE_EVENT_STAT arEventDelayStat[GLUE_FLAG_BIT_NUM];
+
 	struct tasklet_struct rRxTask;
 #if (CFG_SUPPORT_RETURN_TASK == 1)
 	struct tasklet_struct rRxRfbRetTask;
@@ -1130,6 +1165,9 @@ struct PACKET_PRIVATE_RX_DATA {
 #define GLUE_SET_PKT_FLAG(_p, _flag) \
 	(GLUE_GET_PKT_PRIVATE_DATA(_p)->u2Flag |= BIT(_flag))
 
+#define GLUE_CLEAR_PKT_FLAG(_p, _flag) \
+	(GLUE_GET_PKT_PRIVATE_DATA(_p)->u2Flag &= ~BIT(_flag))
+
 #define GLUE_TEST_PKT_FLAG(_p, _flag) \
 	(GLUE_GET_PKT_PRIVATE_DATA(_p)->u2Flag & BIT(_flag))
 
@@ -1245,6 +1283,18 @@ struct PACKET_PRIVATE_RX_DATA {
 #define GLUE_GET_REF_CNT(_refCount)  \
 	GLUE_FENCE_ATOMIC(atomic_read, ((atomic_t *)&(_refCount)))
 
+/* Fully ordered, return the previous value of *_ptr */
+#define GLUE_XCHG(_ptr, _new) \
+	xchg((_ptr), (_new))
+#define GLUE_CMPXCHG(_ptr, _old, _new) \
+	cmpxchg((_ptr), (_old), (_new))
+
+/* Ordered index handoff between one producer and one consumer */
+#define GLUE_LOAD_ACQUIRE(_ptr) \
+	smp_load_acquire(_ptr)
+#define GLUE_STORE_RELEASE(_ptr, _val) \
+	smp_store_release((_ptr), (_val))
+
 #define DbgPrint(...)
 
 #if (CFG_SUPPORT_CONNAC3X == 1)
@@ -77,6 +77,9 @@
 #include "precomp.h"
 
 #include "stdio.h"
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
 /*****************************************************************************
  *                              C O N S T A N T S
  *****************************************************************************
@@ -96,7 +99,13 @@
  *                           P R I V A T E   D A T A
  *****************************************************************************
  */
+/* sched_clock() while frozen by kal_virt_clock_freeze() */
+static bool fgVirtClockFrozen;
+static uint64_t u8VirtClockNs;
 
+/* slice-by-8 tables of kal_crc32_le(), built once on first use */
+static uint32_t au4KalCrc32Tab[8][256];
+static pthread_once_t rKalCrc32Once = PTHREAD_ONCE_INIT;
 
 /*****************************************************************************
  *                                 M A C R O S
@@ -133,6 +142,13 @@ int main(int argc, char *argv[])
 {
 	wlanSetDriverDbgLevel(DBG_ALL_MODULE_IDX,
 			      DBG_LOG_LEVEL_DEFAULT);
+	/* selftest [name] */
+	if (argc > 1 && strcmp(argv[1], "selftest") == 0)
+		return glSelfTest(argc > 2 ? argv[2] : NULL) ? 1 : 0;
+	/* bench [name] */
+	if (argc > 1 && strcmp(argv[1], "bench") == 0)
+		return glSelfBench(argc > 2 ? argv[2] : NULL) ? 1 : 0;
+
 	DBGLOG(INIT, ERROR, "test run\n");
 	return 0;
 }
@@ -165,6 +181,29 @@ void kal_get_monotonic_boottime(struct timespec *ts)
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
 }
 
+uint64_t kal_sched_clock(void)
+{
+	struct timespec rTs;
+
+	if (fgVirtClockFrozen)
+		return u8VirtClockNs;
+
+	clock_gettime(CLOCK_MONOTONIC, &rTs);
+	return (uint64_t) rTs.tv_sec * 1000000000ULL + rTs.tv_nsec;
+}
+
+void kal_virt_clock_freeze(bool freeze)
+{
+	if (freeze && !fgVirtClockFrozen)
+		u8VirtClockNs = kal_sched_clock();
+	fgVirtClockFrozen = freeze;
+}
+
+void kal_virt_clock_advance(uint64_t ns)
+{
+	u8VirtClockNs += ns;
+}
+
 int kal_mod_timer(struct timer_list *timer, unsigned long expires)
 {
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
@@ -219,26 +258,25 @@ int kal_scnprintf(char *buf, size_t size, const char *fmt, ...)
 	return i;
 }
 
+/* the none OS runs in user space, both heaps are the C library one */
 void *kal_kmalloc(size_t size, enum gfp_t type)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	return NULL;
+	return malloc(size);
 }
 
 void *kal_vmalloc(size_t size)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	return NULL;
+	return malloc(size);
 }
 
 void kal_kfree(void *addr)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	free(addr);
 }
 
 void kal_vfree(void *addr)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	free(addr);
 }
 
 bool kal_irqs_disabled(void)
@@ -247,34 +285,77 @@ bool kal_irqs_disabled(void)
 	return false;
 }
 
+/* Threads of the none OS (only the self tests start them) get an id on
+ * their first lock and a virtual CPU from kal_virt_set_cpu()
+ */
+static uint32_t u4KalThreadNum;
+static __thread uint32_t u4KalThreadId;
+static __thread uint32_t u4KalVirtCpu;
+
+static uint32_t kalGetThreadId(void)
+{
+	if (!u4KalThreadId)
+		u4KalThreadId = __atomic_add_fetch(&u4KalThreadNum, 1,
+						   __ATOMIC_RELAXED);
+	return u4KalThreadId;
+}
+
+uint32_t kal_smp_processor_id(void)
+{
+	return u4KalVirtCpu;
+}
+
+void kal_virt_set_cpu(uint32_t cpu)
+{
+	u4KalVirtCpu = cpu % KAL_VIRT_CPU_NUM;
+}
+
+/* The lock holds the id of its owner. The driver itself runs on one
+ * thread, so an acquire by the owner is a recursive acquire: it is
+ * reported and let through instead of hanging.
+ */
 void kal_spin_lock(spinlock_t *lock)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	uint32_t u4Self = kalGetThreadId();
+	uint32_t u4Owner = 0;
+
+	while (!__atomic_compare_exchange_n(lock, &u4Owner, u4Self, false,
+					    __ATOMIC_ACQUIRE,
+					    __ATOMIC_RELAXED)) {
+		if (u4Owner == u4Self) {
+			DBGLOG(INIT, ERROR, "spin lock %p is already held\n",
+			       lock);
+			return;
+		}
+		/* the owner may be waiting for the CPU we spin on */
+		sched_yield();
+		u4Owner = 0;
+	}
 }
 
 void kal_spin_unlock(spinlock_t *lock)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
 }
 
 void kal_spin_lock_bh(spinlock_t *lock)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	kal_spin_lock(lock);
 }
 
 void kal_spin_unlock_bh(spinlock_t *lock)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	kal_spin_unlock(lock);
 }
 
 void kal_spin_lock_irqsave(spinlock_t *lock, unsigned long flags)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	kal_spin_lock(lock);
 }
 
 void kal_spin_unlock_irqrestore(spinlock_t *lock, unsigned long flags)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	kal_spin_unlock(lock);
 }
 
 uint32_t kal_skb_queue_len(const struct sk_buff_head *list)
@@ -290,14 +371,25 @@ void kal_skb_queue_tail(struct sk_buff_head *list, struct sk_buff *newsk)
 
 void *kal_skb_push(struct sk_buff *skb, unsigned int len)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	return NULL;
+	if (skb->data - skb->head < len) {
+		DBGLOG(INIT, ERROR, "skb %p no headroom for %u\n", skb, len);
+		return NULL;
+	}
+	skb->data -= len;
+	skb->len += len;
+	return skb->data;
 }
 
 unsigned char *kal_skb_put(struct sk_buff *skb, unsigned int len)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	return NULL;
+	unsigned char *tail = skb->data + skb->len;
+
+	if (tail + len > skb->head + skb->end) {
+		DBGLOG(INIT, ERROR, "skb %p no tailroom for %u\n", skb, len);
+		return NULL;
+	}
+	skb->len += len;
+	return tail;
 }
 
 struct sk_buff *kal_skb_dequeue_tail(struct sk_buff_head *list)
@@ -313,73 +405,113 @@ void kal_skb_queue_head(struct sk_buff_head *list, struct sk_buff *newsk)
 
 void kal_skb_reset_tail_pointer(struct sk_buff *skb)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	/* the tail is data + len */
 }
 
 void kal_skb_trim(struct sk_buff *skb, unsigned int len)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	if (skb->len > len)
+		skb->len = len;
 }
 
+/* the sk_buff and its buffer are one allocation */
 struct sk_buff *kal_dev_alloc_skb(unsigned int length)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	return NULL;
+	struct sk_buff *skb;
+
+	skb = kal_kmalloc(sizeof(*skb) + length, GFP_ATOMIC);
+	if (!skb)
+		return NULL;
+
+	memset(skb, 0, sizeof(*skb));
+	skb->head = (unsigned char *) (skb + 1);
+	skb->data = skb->head;
+	skb->end = length;
+	return skb;
 }
 
 void kal_kfree_skb(struct sk_buff *skb)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	kal_kfree(skb);
 }
 
-int kal_test_and_clear_bit(unsigned long bit, unsigned long *p)
+void kal_skb_reserve(struct sk_buff *skb, unsigned int len)
 {
-	unsigned int res;
-	unsigned long mask = 1UL << (bit & 31);
+	skb->data += len;
+}
 
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	p += bit >> 5;
-	/* TODO: disable interrupt */
-	res = *p;
-	*p = res & ~mask;
-	/* TODO: restore interrupt */
+/* bit ops on unsigned long words, as the Linux ones */
+#define KAL_BIT_WORD(_nr)	((_nr) / (8 * sizeof(unsigned long)))
+#define KAL_BIT_MASK(_nr) \
+	(1UL << ((_nr) % (8 * sizeof(unsigned long))))
 
-	return (res & mask) != 0;
+int kal_test_and_clear_bit(unsigned long bit, unsigned long *p)
+{
+	unsigned long mask = KAL_BIT_MASK(bit);
+
+	return (__atomic_fetch_and(p + KAL_BIT_WORD(bit), ~mask,
+				   __ATOMIC_ACQ_REL) & mask) != 0;
 }
 
 void kal_clear_bit(unsigned long bit, unsigned long *p)
 {
-	unsigned long mask = 1UL << (bit & 31);
-
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	p += bit >> 5;
-	/* TODO: disable interrupt */
-	*p &= ~mask;
-	/* TOD: restore interrupt */
+	__atomic_fetch_and(p + KAL_BIT_WORD(bit), ~KAL_BIT_MASK(bit),
+			   __ATOMIC_RELEASE);
 }
 
 void kal_set_bit(unsigned long nr, unsigned long *addr)
 {
-	unsigned long mask = BIT(nr % 32);
-	unsigned long *p = ((unsigned long *)addr) + (nr / 32);
-
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	/* TODO: disable interrupt */
-	*p |= mask;
-	/* TODO: restore interrupt */
+	__atomic_fetch_or(addr + KAL_BIT_WORD(nr), KAL_BIT_MASK(nr),
+			  __ATOMIC_RELEASE);
 }
 
 int kal_test_bit(unsigned long nr, unsigned long *addr)
 {
-	unsigned long mask = BIT(nr % 32);
-	unsigned long *p = ((unsigned long *)addr) + (nr / 32);
-	int res = 0;
+	return (__atomic_load_n(addr + KAL_BIT_WORD(nr), __ATOMIC_ACQUIRE) &
+		KAL_BIT_MASK(nr)) != 0;
+}
 
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
-	/* TODO: disable interrupt */
+static void kal_crc32_init(void)
+{
+	uint32_t i, j, crc;
+
+	for (i = 0; i < 256; i++) {
+		crc = i;
+		for (j = 0; j < 8; j++)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+		au4KalCrc32Tab[0][i] = crc;
+	}
+	for (i = 0; i < 256; i++) {
+		crc = au4KalCrc32Tab[0][i];
+		for (j = 1; j < 8; j++) {
+			crc = (crc >> 8) ^ au4KalCrc32Tab[0][crc & 0xff];
+			au4KalCrc32Tab[j][i] = crc;
+		}
+	}
+}
+
+uint32_t kal_crc32_le(uint32_t crc, const uint8_t *p, size_t len)
+{
+	const uint32_t (*t)[256] = au4KalCrc32Tab;
+	uint32_t a, b;
+
+	/* slice-by-8 like the Linux generic crc32_le() */
+	pthread_once(&rKalCrc32Once, kal_crc32_init);
+
+	for (; len && ((uintptr_t)p & 7); len--)
+		crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+	for (; len >= 8; len -= 8, p += 8) {
+		a = crc ^ le2cpu32(*(const uint32_t *)p);
+		b = le2cpu32(*(const uint32_t *)(p + 4));
+		crc = t[7][a & 0xff] ^ t[6][(a >> 8) & 0xff] ^
+		      t[5][(a >> 16) & 0xff] ^ t[4][a >> 24] ^
+		      t[3][b & 0xff] ^ t[2][(b >> 8) & 0xff] ^
+		      t[1][(b >> 16) & 0xff] ^ t[0][b >> 24];
+	}
 
-	res = mask & *p;
-	/* TODO: restore interrupt */
+	for (; len; len--)
+		crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
 
-	return res;
+	return crc;
 }
@@ -138,3 +138,10 @@ enum ENUM_NVRAM_STATE wlanNvramGetState(void)
 	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
 }
 
+
+#if CFG_CHIP_RESET_SUPPORT
+void WfsysResetHdlr(struct work_struct *work)
+{
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+}
+#endif
@@ -122,6 +122,654 @@ uint32_t au4LogLevel[ENUM_WIFI_LOG_MODULE_NUM] = {ENUM_WIFI_LOG_LEVEL_DEFAULT};
  *                              F U N C T I O N S
  *****************************************************************************
  */
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief This function is provided by GLUE Layer for internal driver stack to
+ *        acquire OS SPIN_LOCK.
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] rLockCategory  Specify which SPIN_LOCK
+ * \param[out] plFlags       Pointer of a variable for saving IRQ flags
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void kalAcquireSpinLock(IN struct GLUE_INFO *prGlueInfo,
+			IN enum ENUM_SPIN_LOCK_CATEGORY_E rLockCategory,
+			OUT unsigned long *plFlags)
+{
+	ASSERT(prGlueInfo);
+	ASSERT(plFlags);
+
+	if (rLockCategory < SPIN_LOCK_NUM)
+		spin_lock(&prGlueInfo->rSpinLock[rLockCategory]);
+	*plFlags = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief This function is provided by GLUE Layer for internal driver stack to
+ *        release OS SPIN_LOCK.
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] rLockCategory  Specify which SPIN_LOCK
+ * \param[in] u4Flags        Saved IRQ flags
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void kalReleaseSpinLock(IN struct GLUE_INFO *prGlueInfo,
+			IN enum ENUM_SPIN_LOCK_CATEGORY_E rLockCategory,
+			IN unsigned long ulFlags)
+{
+	ASSERT(prGlueInfo);
+
+	if (rLockCategory < SPIN_LOCK_NUM)
+		spin_unlock(&prGlueInfo->rSpinLock[rLockCategory]);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Set the time of the next root timer timeout. There is no OS timer,
+ *        whoever drives the driver checks rTimerExpiry and calls
+ *        cnmTimerDoTimeOutCheck().
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] rInterval      Timeout from now, in kalGetTimeTick() units
+ *
+ * \return TRUE
+ */
+/*----------------------------------------------------------------------------*/
+u_int8_t kalSetTimer(IN struct GLUE_INFO *prGlueInfo,
+		     IN OS_SYSTIME rInterval)
+{
+	ASSERT(prGlueInfo);
+
+	prGlueInfo->rTimerExpiry = kalGetTimeTick() + rInterval;
+	prGlueInfo->fgTimerSet = TRUE;
+
+	return TRUE;
+}
+
+u_int8_t kalCancelTimer(IN struct GLUE_INFO *prGlueInfo)
+{
+	ASSERT(prGlueInfo);
+
+	prGlueInfo->fgTimerSet = FALSE;
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Free a packet of kalPacketAlloc() or of the TX path
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] pvPacket       Packet
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void kalPacketFree(IN struct GLUE_INFO *prGlueInfo,
+		   IN void *pvPacket)
+{
+	kfree_skb((struct sk_buff *)pvPacket);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Allocate a packet with the TX descriptor headroom, as Linux does
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] u4Size         Data size
+ * \param[out] ppucData      Start of the data
+ *
+ * \return The packet, NULL on failure
+ */
+/*----------------------------------------------------------------------------*/
+void *kalPacketAlloc(IN struct GLUE_INFO *prGlueInfo,
+		     IN uint32_t u4Size, OUT uint8_t **ppucData)
+{
+	struct mt66xx_chip_info *prChipInfo;
+	struct sk_buff *prSkb;
+	uint32_t u4TxHeadRoomSize;
+
+	prChipInfo = prGlueInfo->prAdapter->chip_info;
+	u4TxHeadRoomSize = NIC_TX_DESC_AND_PADDING_LENGTH +
+			   prChipInfo->txd_append_size;
+
+	prSkb = dev_alloc_skb(u4Size + u4TxHeadRoomSize);
+	if (prSkb) {
+		skb_reserve(prSkb, u4TxHeadRoomSize);
+		*ppucData = (uint8_t *) (prSkb->data);
+		kalResetPacket(prGlueInfo, (void *) prSkb);
+	}
+
+	return (void *) prSkb;
+}
+
+void *kalPacketAllocWithHeadroom(IN struct GLUE_INFO *prGlueInfo,
+				 IN uint32_t u4Size, OUT uint8_t **ppucData)
+{
+	struct sk_buff *prSkb = dev_alloc_skb(u4Size + NIC_TX_HEAD_ROOM);
+
+	if (!prSkb) {
+		DBGLOG(TX, WARN, "alloc skb failed\n");
+		return NULL;
+	}
+
+	skb_reserve(prSkb, NIC_TX_HEAD_ROOM);
+	*ppucData = (uint8_t *) (prSkb->data);
+	kalResetPacket(prGlueInfo, (void *) prSkb);
+
+	return (void *) prSkb;
+}
+
+void kalResetPacket(IN struct GLUE_INFO *prGlueInfo,
+		    IN void *prPacket)
+{
+	struct sk_buff *prSkb = (struct sk_buff *)prPacket;
+
+	kalMemZero(prSkb->cb, sizeof(prSkb->cb));
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Point a received packet at its payload
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] pvPacket       Packet
+ * \param[in] pucPacketStart Start of the payload
+ * \param[in] u4PacketLen    Payload length
+ * \param[in] fgIsRetain     Unused
+ * \param[in] aerCSUM        Unused, no checksum offload
+ *
+ * \return WLAN_STATUS_SUCCESS, WLAN_STATUS_FAILURE if it does not fit
+ */
+/*----------------------------------------------------------------------------*/
+uint32_t
+kalProcessRxPacket(IN struct GLUE_INFO *prGlueInfo,
+		   IN void *pvPacket, IN uint8_t *pucPacketStart,
+		   IN uint32_t u4PacketLen,
+		   IN u_int8_t fgIsRetain, IN enum ENUM_CSUM_RESULT aerCSUM[])
+{
+	struct sk_buff *skb = (struct sk_buff *)pvPacket;
+
+	skb->data = pucPacketStart;
+	skb_trim(skb, 0);
+	if (!skb_put(skb, u4PacketLen))
+		return WLAN_STATUS_FAILURE;
+
+	return WLAN_STATUS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Indicate a received frame to the OS. There is no network stack,
+ *        the frame is counted and freed.
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] pvPkt          Packet
+ *
+ * \return WLAN_STATUS_SUCCESS
+ */
+/*----------------------------------------------------------------------------*/
+uint32_t kalRxIndicateOnePkt(IN struct GLUE_INFO *prGlueInfo,
+			     IN void *pvPkt)
+{
+	struct sk_buff *prSkb = (struct sk_buff *)pvPkt;
+
+	prGlueInfo->u4RxIndicateCnt++;
+	prGlueInfo->u8RxIndicateBytes += prSkb->len;
+	kfree_skb(prSkb);
+
+	return WLAN_STATUS_SUCCESS;
+}
+
+uint32_t kalRxIndicatePkts(IN struct GLUE_INFO *prGlueInfo,
+			   IN void *apvPkts[], IN uint8_t ucPktNum)
+{
+	uint8_t ucIdx;
+
+	for (ucIdx = 0; ucIdx < ucPktNum; ucIdx++)
+		kalRxIndicateOnePkt(prGlueInfo, apvPkts[ucIdx]);
+
+	return WLAN_STATUS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Release a sent frame
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] pvPacket       Packet
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void kalSendCompleteAndAwakeQueue(IN struct GLUE_INFO *prGlueInfo,
+				  IN void *pvPacket)
+{
+	/* no netdev queues to wake */
+	GLUE_DEC_REF_CNT(prGlueInfo->i4TxPendingFrameNum);
+	prGlueInfo->u4TxCompleteCnt++;
+
+	kfree_skb((struct sk_buff *)pvPacket);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief TX entry point, what wlanHardStartXmit() of Linux ends up in. The
+ *        frame waits in prTxInbox until kalMainThreadRun() moves it to QM.
+ *
+ * \param[in] prSkb          Ethernet frame to send
+ * \param[in] prDev          Unused, there is no net_device
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] ucBssIndex     BSS to send on
+ *
+ * \retval WLAN_STATUS
+ */
+/*----------------------------------------------------------------------------*/
+uint32_t
+kalHardStartXmit(struct sk_buff *prSkb,
+		 IN struct net_device *prDev,
+		 struct GLUE_INFO *prGlueInfo, uint8_t ucBssIndex)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	struct BSS_INFO *prBssInfo;
+
+	if (test_bit(GLUE_FLAG_HALT_BIT, &prGlueInfo->ulFlag)) {
+		kfree_skb(prSkb);
+		return WLAN_STATUS_ADAPTER_NOT_READY;
+	}
+
+	prBssInfo = GET_BSS_INFO_BY_INDEX(prAdapter, ucBssIndex);
+	if (!prBssInfo || (prBssInfo->eNetworkType == NETWORK_TYPE_AIS &&
+	    prBssInfo->eConnectionState != MEDIA_STATE_CONNECTED)) {
+		kfree_skb(prSkb);
+		return WLAN_STATUS_NOT_ACCEPTED;
+	}
+
+	GLUE_SET_PKT_BSS_IDX(prSkb, ucBssIndex);
+	STATS_TX_TIME_ARRIVE(prSkb);
+
+	if (!wlanProcessTxFrame(prAdapter, (void *) prSkb)) {
+		kfree_skb(prSkb);
+		return WLAN_STATUS_INVALID_PACKET;
+	}
+
+	QUEUE_MPSC_PUSH(&prGlueInfo->prTxInbox,
+		(struct QUE_ENTRY *) GLUE_GET_PKT_QUEUE_ENTRY(prSkb));
+
+	GLUE_INC_REF_CNT(prGlueInfo->i4TxPendingFrameNum);
+
+	kalSetEvent(prGlueInfo);
+
+	return WLAN_STATUS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Extract the TX information of an Ethernet frame. Unlike Linux the
+ *        IP payload is not looked into, so DHCP, ARP and ICMP are not
+ *        flagged and the user priority is prSkb->priority as given.
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] prPacket       Packet descriptor
+ * \param[out] prTxPktInfo   Extracted packet info
+ *
+ * \retval TRUE      Success to extract information
+ * \retval FALSE     Fail to extract correct information
+ */
+/*----------------------------------------------------------------------------*/
+u_int8_t
+kalQoSFrameClassifierAndPacketInfo(IN struct GLUE_INFO *prGlueInfo,
+		IN void *prPacket, OUT struct TX_PACKET_INFO *prTxPktInfo)
+{
+	struct sk_buff *prSkb = (struct sk_buff *)prPacket;
+	uint8_t *aucLookAheadBuf = prSkb->data;
+	uint8_t ucEthTypeLenOffset = ETHER_HEADER_LEN - ETHER_TYPE_LEN;
+	uint16_t u2EtherTypeLen;
+
+	if (prSkb->len < ETHER_HEADER_LEN) {
+		DBGLOG(INIT, WARN, "Invalid Ether packet length: %u\n",
+		       prSkb->len);
+		return FALSE;
+	}
+
+	kalMemZero(prTxPktInfo, sizeof(struct TX_PACKET_INFO));
+
+	WLAN_GET_FIELD_BE16(&aucLookAheadBuf[ucEthTypeLenOffset],
+			    &u2EtherTypeLen);
+	if (u2EtherTypeLen == ETH_P_VLAN) {
+		prTxPktInfo->u2Flag |= BIT(ENUM_PKT_VLAN_EXIST);
+		ucEthTypeLenOffset += ETH_802_1Q_HEADER_LEN;
+		WLAN_GET_FIELD_BE16(&aucLookAheadBuf[ucEthTypeLenOffset],
+				    &u2EtherTypeLen);
+	}
+
+	if (u2EtherTypeLen == ETH_P_1X || u2EtherTypeLen == ETH_P_PRE_1X)
+		prTxPktInfo->u2Flag |= BIT(ENUM_PKT_1X);
+	else if (u2EtherTypeLen <= ETH_802_3_MAX_LEN)
+		prTxPktInfo->u2Flag |= BIT(ENUM_PKT_802_3);
+
+	prTxPktInfo->ucPriorityParam = (uint8_t) prSkb->priority;
+	prTxPktInfo->u4PacketLen = prSkb->len;
+	kalMemCopy(prTxPktInfo->aucEthDestAddr, aucLookAheadBuf,
+		   PARAM_MAC_ADDR_LEN);
+
+	return TRUE;
+}
+
+u_int8_t kalGetEthDestAddr(IN struct GLUE_INFO *prGlueInfo,
+			   IN void *prPacket, OUT uint8_t *pucEthDestAddr)
+{
+	struct sk_buff *prSkb = (struct sk_buff *)prPacket;
+
+	if (!prPacket || !prGlueInfo)
+		return FALSE;
+
+	kalMemCopy(pucEthDestAddr, prSkb->data, PARAM_MAC_ADDR_LEN);
+
+	return TRUE;
+}
+
+uint32_t kalGetTxPendingFrameCount(IN struct GLUE_INFO *prGlueInfo)
+{
+	return (uint32_t) GLUE_GET_REF_CNT(prGlueInfo->i4TxPendingFrameNum);
+}
+
+uint32_t kalGetTxPendingCmdCount(IN struct GLUE_INFO *prGlueInfo)
+{
+	return (uint32_t) GLUE_GET_REF_CNT(prGlueInfo->i4TxPendingCmdNum);
+}
+
+/* The virtual device is never unplugged */
+u_int8_t kalIsCardRemoved(IN struct GLUE_INFO *prGlueInfo)
+{
+	return FALSE;
+}
+
+/* Time since boot in microseconds, the host never suspends */
+uint64_t kalGetBootTime(void)
+{
+	return kal_sched_clock() / NSEC_PER_USEC;
+}
+
+#if CFG_SUPPORT_WAKEUP_REASON_DEBUG
+/* The host never suspends, so no RX is a wake up reason */
+u_int8_t kalIsWakeupByWlan(struct ADAPTER *prAdapter)
+{
+	return FALSE;
+}
+#endif
+
+#if CFG_MET_PACKET_TRACE_SUPPORT
+/* There is no MET on this OS, packets are not tagged */
+void kalMetTagPacket(IN struct GLUE_INFO *prGlueInfo,
+		     IN void *prPacket, IN enum ENUM_TX_PROFILING_TAG eTag)
+{
+}
+#endif
+
+/* There is no P2P role glue here, a P2P BSS is an open network */
+u_int8_t kalP2PGetCipher(IN struct GLUE_INFO *prGlueInfo,
+			 IN uint8_t ucRoleIdx)
+{
+	return FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Move the frames of rTxQueue and prTxInbox to QM and QM to HIF,
+ *        the data part of kalProcessTxReq() on Linux
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+static void kalProcessTxData(IN struct GLUE_INFO *prGlueInfo)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	struct QUE rTempQue;
+	struct QUE_ENTRY *prQueueEntry;
+	u_int8_t fgNeedHwAccess = FALSE;
+
+	GLUE_SPIN_LOCK_DECLARATION();
+
+	QUEUE_INITIALIZE(&rTempQue);
+
+	/* frames put back first, then the new ones in order */
+	GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+	QUEUE_MOVE_ALL(&rTempQue, &prGlueInfo->rTxQueue);
+	GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+	QUEUE_MPSC_MOVE_ALL(&rTempQue, &prGlueInfo->prTxInbox);
+
+	while (QUEUE_IS_NOT_EMPTY(&rTempQue)) {
+		QUEUE_REMOVE_HEAD(&rTempQue, prQueueEntry, struct QUE_ENTRY *);
+		if (wlanEnqueueTxPacket(prAdapter,
+		    GLUE_GET_PKT_DESCRIPTOR(prQueueEntry)) ==
+		    WLAN_STATUS_RESOURCES) {
+			/* keep the order, retried on the next TX request */
+			QUEUE_INSERT_HEAD(&rTempQue, prQueueEntry);
+			GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+			QUEUE_CONCATENATE_QUEUES_HEAD(&prGlueInfo->rTxQueue,
+				&rTempQue);
+			GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_TX_QUE);
+			break;
+		}
+	}
+
+	if (wlanGetTxPendingFrameCount(prAdapter) > 0)
+		wlanTxPendingPackets(prAdapter, &fgNeedHwAccess);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Status indication to the OS, there is no one to tell
+ */
+/*----------------------------------------------------------------------------*/
+void
+kalIndicateStatusAndComplete(IN struct GLUE_INFO *prGlueInfo,
+			     IN uint32_t eStatus, IN void *pvBuf,
+			     IN uint32_t u4BufLen, IN uint8_t ucBssIndex)
+{
+	DBGLOG(INIT, TRACE, "BSS[%u] status[0x%x]\n", ucBssIndex, eStatus);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Queue a command for the main thread
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] prQueueEntry   The CMD_INFO
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void kalEnqueueCommand(IN struct GLUE_INFO *prGlueInfo,
+		       IN struct QUE_ENTRY *prQueueEntry)
+{
+	struct CMD_INFO *prCmdInfo = (struct CMD_INFO *) prQueueEntry;
+
+	GLUE_SPIN_LOCK_DECLARATION();
+
+	DBGLOG(INIT, TRACE, "EN-Q CMD TYPE[%u] ID[0x%02X] SEQ[%u] to CMD Q\n",
+	       prCmdInfo->eCmdType, prCmdInfo->ucCID,
+	       prCmdInfo->ucCmdSeqNum);
+
+	GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_CMD_QUE);
+	QUEUE_INSERT_TAIL(&prGlueInfo->rCmdQueue, prQueueEntry);
+	GLUE_INC_REF_CNT(prGlueInfo->i4TxPendingCmdNum);
+	GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_CMD_QUE);
+}
+
+/* The none OS has no threads of its own. The kalSetXxxEvent() calls raise
+ * the GLUE_FLAG bits of the Linux threads and whoever drives the driver
+ * runs kalMainThreadRun().
+ */
+void kalSetEvent(struct GLUE_INFO *pr)
+{
+	set_bit(GLUE_FLAG_TXREQ_BIT, &pr->ulFlag);
+}
+
+void kalSetIntEvent(struct GLUE_INFO *pr)
+{
+	set_bit(GLUE_FLAG_INT_BIT, &pr->ulFlag);
+}
+
+void kalSetTxEvent2Hif(struct GLUE_INFO *pr)
+{
+	set_bit(GLUE_FLAG_HIF_TX_BIT, &pr->ulFlag);
+}
+
+void kalSetTxEvent2Rx(struct GLUE_INFO *pr)
+{
+	set_bit(GLUE_FLAG_RX_TO_OS_BIT, &pr->ulFlag);
+}
+
+void kalSetTxCmdEvent2Hif(struct GLUE_INFO *pr)
+{
+	set_bit(GLUE_FLAG_HIF_TX_CMD_BIT, &pr->ulFlag);
+}
+
+void kalSetTxCmdDoneEvent(struct GLUE_INFO *pr)
+{
+	set_bit(GLUE_FLAG_TX_CMD_DONE_BIT, &pr->ulFlag);
+}
+
+void kalSetRxProcessEvent(struct GLUE_INFO *pr)
+{
+	if (QUEUE_IS_EMPTY(&pr->prAdapter->rRxCtrl.rReceivedRfbList))
+		return;
+
+	set_bit(GLUE_FLAG_RX_BIT, &pr->ulFlag);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief One pass of the work of the Linux hif_thread, main_thread and
+ *        rx_thread, in that order
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ *
+ * \return TRUE if any event was handled, run again until FALSE to settle
+ */
+/*----------------------------------------------------------------------------*/
+u_int8_t kalMainThreadRun(IN struct GLUE_INFO *prGlueInfo)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	struct QUE rTempRxQue;
+	struct QUE_ENTRY *prQueueEntry;
+	u_int8_t fgEvent = FALSE;
+
+	GLUE_SPIN_LOCK_DECLARATION();
+
+	/* hif_thread */
+	if (test_and_clear_bit(GLUE_FLAG_INT_BIT, &prGlueInfo->ulFlag)) {
+		wlanIST(prAdapter);
+		fgEvent = TRUE;
+	}
+	if (test_and_clear_bit(GLUE_FLAG_HIF_TX_CMD_BIT,
+			       &prGlueInfo->ulFlag)) {
+		wlanTxCmdMthread(prAdapter);
+		fgEvent = TRUE;
+	}
+	if (test_and_clear_bit(GLUE_FLAG_HIF_TX_BIT, &prGlueInfo->ulFlag)) {
+		nicTxMsduQueueMthread(prAdapter);
+		fgEvent = TRUE;
+	}
+
+	/* main_thread */
+	if (test_and_clear_bit(GLUE_FLAG_TXREQ_BIT, &prGlueInfo->ulFlag)) {
+		wlanProcessMboxMessage(prAdapter);
+		if (QUEUE_IS_NOT_EMPTY(&prGlueInfo->rCmdQueue))
+			wlanProcessCommandQueue(prAdapter,
+				&prGlueInfo->rCmdQueue);
+		kalProcessTxData(prGlueInfo);
+		fgEvent = TRUE;
+	}
+	if (test_and_clear_bit(GLUE_FLAG_TX_CMD_DONE_BIT,
+			       &prGlueInfo->ulFlag)) {
+		wlanTxCmdDoneMthread(prAdapter);
+		fgEvent = TRUE;
+	}
+	if (test_and_clear_bit(GLUE_FLAG_RX_BIT, &prGlueInfo->ulFlag)) {
+		nicRxProcessRFBs(prAdapter);
+		fgEvent = TRUE;
+	}
+
+	/* rx_thread */
+	if (test_and_clear_bit(GLUE_FLAG_RX_TO_OS_BIT, &prGlueInfo->ulFlag)) {
+		QUEUE_INITIALIZE(&rTempRxQue);
+		GLUE_ACQUIRE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_RX_TO_OS_QUE);
+		QUEUE_MOVE_ALL(&rTempRxQue, &prAdapter->rRxQueue);
+		GLUE_RELEASE_SPIN_LOCK(prGlueInfo, SPIN_LOCK_RX_TO_OS_QUE);
+
+		while (QUEUE_IS_NOT_EMPTY(&rTempRxQue)) {
+			QUEUE_REMOVE_HEAD(&rTempRxQue, prQueueEntry,
+					  struct QUE_ENTRY *);
+			kalRxIndicateOnePkt(prGlueInfo,
+				(void *) GLUE_GET_PKT_DESCRIPTOR(prQueueEntry));
+		}
+		fgEvent = TRUE;
+	}
+
+	return fgEvent;
+}
+
+#if CFG_ENABLE_FW_DOWNLOAD
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Map the FW image. There is no file system, the image comes from the
+ *        emulated firmware of the virtual HIF.
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[out] ppvMapFileBuf Pointer of pointer to the image
+ * \param[out] pu4FileLength File length
+ * \param[in] eDlIdx         Image index
+ *
+ * \return The image, NULL if there is none
+ */
+/*----------------------------------------------------------------------------*/
+void *kalFirmwareImageMapping(IN struct GLUE_INFO *prGlueInfo,
+			      OUT void **ppvMapFileBuf,
+			      OUT uint32_t *pu4FileLength,
+			      IN enum ENUM_IMG_DL_IDX_T eDlIdx)
+{
+	ASSERT(prGlueInfo);
+	ASSERT(ppvMapFileBuf);
+	ASSERT(pu4FileLength);
+
+	*pu4FileLength = 0;
+	*ppvMapFileBuf = kal_virt_fw_image(prGlueInfo->prAdapter, eDlIdx,
+		pu4FileLength);
+
+	return *ppvMapFileBuf;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * \brief Release the FW image of kalFirmwareImageMapping()
+ *
+ * \param[in] prGlueInfo     Pointer of GLUE Data Structure
+ * \param[in] prFwHandle     Unused
+ * \param[in] pvMapFileBuf   The image
+ *
+ * \return (none)
+ */
+/*----------------------------------------------------------------------------*/
+void kalFirmwareImageUnmapping(IN struct GLUE_INFO *prGlueInfo,
+			       IN void *prFwHandle, IN void *pvMapFileBuf)
+{
+	ASSERT(prGlueInfo);
+
+	/* the image length is not kept, so not kalMemFree() */
+	vfree(pvMapFileBuf);
+}
+#endif
+
 #if CFG_CHIP_RESET_SUPPORT
 void kalRemoveProbe(IN struct GLUE_INFO *prGlueInfo)
 {
@@ -0,0 +1,3912 @@
+/****************************************************************************
+ *
+ * This file is provided under a dual license.  When you use or
+ * distribute this software, you may choose to be licensed under
+ * version 2 of the GNU General Public License ("GPLv2 License")
+ * or BSD License.
+ *
+ * GPLv2 License
+ *
+ * Copyright(C) 2016 MediaTek Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See http://www.gnu.org/licenses/gpl-2.0.html for more details.
+ *
+ * BSD LICENSE
+ *
+ * Copyright(C) 2016 MediaTek Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+/****************************************************************************
+ *[File]             gl_self_test.c
+ *[Version]          v1.0
+ *[Revision Date]    2019/01/01
+ *[Author]
+ *[Description]
+ *    Self tests of the common part, run by "wlan_<chip>_none selftest".
+ *[Copyright]
+ *    Copyright (C) 2010 MediaTek Incorporation. All Rights Reserved.
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *                         C O M P I L E R   F L A G S
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                    E X T E R N A L   R E F E R E N C E S
+ *****************************************************************************
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "gl_os.h"
+
+#include "precomp.h"
+
+/*****************************************************************************
+ *                              C O N S T A N T S
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                             D A T A   T Y P E S
+ *****************************************************************************
+ */
+struct SELF_TEST {
+	const char *pucName;
+	u_int8_t (*pfnTest)(void);	/* TRUE: pass */
+};
+
+/*****************************************************************************
+ *                            P U B L I C   D A T A
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                           P R I V A T E   D A T A
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                                 M A C R O S
+ *****************************************************************************
+ */
+/* Fail the running test if _cond does not hold */
+#define SELF_TEST_CHECK(_cond) \
+	do { \
+		if (!(_cond)) { \
+			DBGLOG(INIT, ERROR, "check failed: %s@%d: %s\n", \
+			       __FILE__, __LINE__, #_cond); \
+			return FALSE; \
+		} \
+	} while (0)
+
+/* Same, for tests that clean up at their "out" label */
+#define SELF_TEST_CHECK_OUT(_cond) \
+	do { \
+		if (!(_cond)) { \
+			DBGLOG(INIT, ERROR, "check failed: %s@%d: %s\n", \
+			       __FILE__, __LINE__, #_cond); \
+			goto out; \
+		} \
+	} while (0)
+
+/*****************************************************************************
+ *                   F U N C T I O N   D E C L A R A T I O N S
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                              F U N C T I O N S
+ *****************************************************************************
+ */
+/* wlanCRC32() as it was before it moved to crc32_le(), table on the stack */
+static uint32_t selfTestCrc32Ref(uint8_t *buf, uint32_t len)
+{
+	uint32_t i, crc32 = 0xFFFFFFFF;
+	const uint32_t crc32_ccitt_table[256] = {
+		0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419,
+		0x706af48f, 0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4,
+		0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07,
+		0x90bf1d91, 0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de,
+		0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7, 0x136c9856,
+		0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
+		0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4,
+		0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
+		0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3,
+		0x45df5c75, 0xdcd60dcf, 0xabd13d59, 0x26d930ac, 0x51de003a,
+		0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599,
+		0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
+		0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190,
+		0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f,
+		0x9fbfe4a5, 0xe8b8d433, 0x7807c9a2, 0x0f00f934, 0x9609a88e,
+		0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
+		0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed,
+		0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
+		0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3,
+		0xfbd44c65, 0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2,
+		0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a,
+		0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5,
+		0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa, 0xbe0b1010,
+		0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+		0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17,
+		0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6,
+		0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615,
+		0x73dc1683, 0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8,
+		0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1, 0xf00f9344,
+		0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
+		0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a,
+		0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
+		0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1,
+		0xa6bc5767, 0x3fb506dd, 0x48b2364b, 0xd80d2bda, 0xaf0a1b4c,
+		0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef,
+		0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
+		0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe,
+		0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31,
+		0x2cd99e8b, 0x5bdeae1d, 0x9b64c2b0, 0xec63f226, 0x756aa39c,
+		0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
+		0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b,
+		0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
+		0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1,
+		0x18b74777, 0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c,
+		0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45, 0xa00ae278,
+		0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7,
+		0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc, 0x40df0b66,
+		0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+		0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605,
+		0xcdd70693, 0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8,
+		0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b,
+		0x2d02ef8d
+	};
+
+	for (i = 0; i < len; i++)
+		crc32 = crc32_ccitt_table[(crc32 ^ buf[i]) & 0xff] ^
+			(crc32 >> 8);
+
+	return ~crc32;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief kalCRC32() and wlanCRC32() against the 256-entry table wlanCRC32()
+ *        used before it moved to crc32_le(), on fixed strings and on random
+ *        buffers of random alignment and length. The expected values were
+ *        computed with that table.
+ *
+ * @return TRUE if all match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestCrc32(void)
+{
+	static uint8_t aucBuf[4096];
+	uint8_t aucCheck[] = "123456789";
+	uint8_t aucFox[] = "The quick brown fox jumps over the lazy dog";
+	uint32_t i, j, u4Seed = 1, u4Off, u4Len, u4Split, u4Crc;
+
+	for (i = 0; i < sizeof(aucBuf); i++)
+		aucBuf[i] = (uint8_t)(i * 7 + 3);
+
+	SELF_TEST_CHECK(kalCRC32(aucCheck, 0) == 0);
+	SELF_TEST_CHECK(kalCRC32(aucFox + 36, 1) == 0xE8B7BE43);
+	SELF_TEST_CHECK(kalCRC32(aucCheck, 9) == 0xCBF43926);
+	SELF_TEST_CHECK(wlanCRC32(aucCheck, 9) == 0xCBF43926);
+	SELF_TEST_CHECK(wlanCRC32(aucFox, 43) == 0x414FA339);
+	SELF_TEST_CHECK(wlanCRC32(aucBuf, sizeof(aucBuf)) == 0x5E4E1995);
+	/* unaligned start and odd length */
+	SELF_TEST_CHECK(wlanCRC32(aucBuf + 1, 1499) == 0xE22D2953);
+
+	for (i = 0; i < 2000; i++) {
+		u4Seed = u4Seed * 1103515245 + 12345;
+		u4Off = (u4Seed >> 8) % 8;
+		u4Len = (u4Seed >> 11) % (sizeof(aucBuf) - u4Off + 1);
+		u4Split = u4Len ? (u4Seed >> 3) % u4Len : 0;
+		for (j = 0; j < u4Len; j++) {
+			u4Seed = u4Seed * 1103515245 + 12345;
+			aucBuf[u4Off + j] = (uint8_t)(u4Seed >> 16);
+		}
+
+		u4Crc = selfTestCrc32Ref(aucBuf + u4Off, u4Len);
+		SELF_TEST_CHECK(wlanCRC32(aucBuf + u4Off, u4Len) == u4Crc);
+		/* continued over two pieces */
+		SELF_TEST_CHECK(~crc32_le(crc32_le(~0, aucBuf + u4Off,
+			u4Split), aucBuf + u4Off + u4Split,
+			u4Len - u4Split) == u4Crc);
+	}
+
+	return TRUE;
+}
+
+/* Linear scan of a config store, what wlanCfgGetEntry() did before the
+ * hash index
+ */
+static struct WLAN_CFG_ENTRY *selfTestCfgScanBuf(struct WLAN_CFG_ENTRY *prBuf,
+						 uint32_t u4MaxNum,
+						 const int8_t *pucKey)
+{
+	uint32_t i;
+
+	for (i = 0; i < u4MaxNum; i++) {
+		if (prBuf[i].aucKey[0] != '\0' &&
+		    kalStrnCmp(pucKey, prBuf[i].aucKey,
+			       WLAN_CFG_KEY_LEN_MAX - 1) == 0)
+			return &prBuf[i];
+	}
+
+	return NULL;
+}
+
+static struct WLAN_CFG_ENTRY *selfTestCfgScan(struct WLAN_CFG *prWlanCfg,
+					      const int8_t *pucKey)
+{
+	return selfTestCfgScanBuf(prWlanCfg->arWlanCfgBuf,
+				  WLAN_CFG_ENTRY_NUM_MAX, pucKey);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief wlanCfgSet()/wlanCfgGet() on the hashed config store: fill it up,
+ *        remove entries, re-add them and compare every lookup with a linear
+ *        scan of the store
+ *
+ * @return TRUE if all match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestCfgHash(void)
+{
+	struct ADAPTER *prAdapter;
+	struct WLAN_CFG *prWlanCfg;
+	int8_t aucKey[WLAN_CFG_KEY_LEN_MAX + 8];
+	int8_t aucValue[WLAN_CFG_VALUE_LEN_MAX];
+	int8_t aucExpect[WLAN_CFG_VALUE_LEN_MAX];
+	u_int8_t fgPass = FALSE;
+	uint32_t i;
+
+	prAdapter = calloc(1, sizeof(struct ADAPTER));
+	if (!prAdapter)
+		return FALSE;
+	prAdapter->prWlanCfg = prWlanCfg = &prAdapter->rWlanCfg;
+	prAdapter->prWlanCfgRec = &prAdapter->rWlanCfgRec;
+
+	/* fill the whole store */
+	for (i = 0; i < WLAN_CFG_ENTRY_NUM_MAX; i++) {
+		kalSprintf(aucKey, "Key%u", i);
+		kalSprintf(aucValue, "%u", i * 3);
+		SELF_TEST_CHECK_OUT(
+			wlanCfgSet(prAdapter, aucKey, aucValue, 0) ==
+			WLAN_STATUS_SUCCESS);
+	}
+	SELF_TEST_CHECK_OUT(wlanCfgSet(prAdapter, "KeyFull", "1", 0) ==
+		WLAN_STATUS_FAILURE);
+
+	for (i = 0; i < WLAN_CFG_ENTRY_NUM_MAX; i++) {
+		kalSprintf(aucKey, "Key%u", i);
+		kalSprintf(aucExpect, "%u", i * 3);
+		SELF_TEST_CHECK_OUT(
+			wlanCfgGet(prAdapter, aucKey, aucValue, NULL, 0) ==
+			WLAN_STATUS_SUCCESS);
+		SELF_TEST_CHECK_OUT(strcmp(aucValue, aucExpect) == 0);
+		SELF_TEST_CHECK_OUT(wlanCfgGetEntry(prAdapter, aucKey, FALSE) ==
+			selfTestCfgScan(prWlanCfg, aucKey));
+	}
+	SELF_TEST_CHECK_OUT(wlanCfgGetEntry(prAdapter, "Key", FALSE) == NULL);
+	SELF_TEST_CHECK_OUT(
+		wlanCfgGet(prAdapter, "Missing", aucValue, "def", 0) ==
+		WLAN_STATUS_FAILURE);
+	SELF_TEST_CHECK_OUT(strcmp(aucValue, "def") == 0);
+
+	/* an update keeps the entry */
+	SELF_TEST_CHECK_OUT(wlanCfgSet(prAdapter, "Key7", "updated", 0) ==
+		WLAN_STATUS_SUCCESS);
+	SELF_TEST_CHECK_OUT(wlanCfgGetEntry(prAdapter, "Key7", FALSE) ==
+		&prWlanCfg->arWlanCfgBuf[7]);
+	SELF_TEST_CHECK_OUT(strcmp(prWlanCfg->arWlanCfgBuf[7].aucValue,
+			"updated") == 0);
+
+	/* an empty value removes the entry, the index is rebuilt */
+	for (i = 0; i < WLAN_CFG_ENTRY_NUM_MAX; i += 3) {
+		kalSprintf(aucKey, "Key%u", i);
+		SELF_TEST_CHECK_OUT(wlanCfgSet(prAdapter, aucKey, "", 0) ==
+			WLAN_STATUS_SUCCESS);
+	}
+	for (i = 0; i < WLAN_CFG_ENTRY_NUM_MAX; i++) {
+		kalSprintf(aucKey, "Key%u", i);
+		SELF_TEST_CHECK_OUT(wlanCfgGetEntry(prAdapter, aucKey, FALSE) ==
+			selfTestCfgScan(prWlanCfg, aucKey));
+		SELF_TEST_CHECK_OUT(
+			(wlanCfgGetEntry(prAdapter, aucKey, FALSE) == NULL) ==
+			(i % 3 == 0));
+	}
+
+	/* new keys reuse the freed entries, lowest first */
+	for (i = 0; i < WLAN_CFG_ENTRY_NUM_MAX; i += 3) {
+		kalSprintf(aucKey, "New%u", i);
+		SELF_TEST_CHECK_OUT(wlanCfgSet(prAdapter, aucKey, "1", 0) ==
+			WLAN_STATUS_SUCCESS);
+		SELF_TEST_CHECK_OUT(wlanCfgGetEntry(prAdapter, aucKey, FALSE) ==
+			&prWlanCfg->arWlanCfgBuf[i]);
+	}
+	SELF_TEST_CHECK_OUT(wlanCfgSet(prAdapter, "KeyFull", "1", 0) ==
+		WLAN_STATUS_FAILURE);
+
+	/* only the first WLAN_CFG_KEY_LEN_MAX - 1 bytes of a key count */
+	SELF_TEST_CHECK_OUT(wlanCfgSet(prAdapter, "New0", "", 0) ==
+		WLAN_STATUS_SUCCESS);
+	kalMemSet(aucKey, 'k', sizeof(aucKey));
+	aucKey[sizeof(aucKey) - 1] = '\0';
+	SELF_TEST_CHECK_OUT(wlanCfgSet(prAdapter, aucKey, "long", 0) ==
+		WLAN_STATUS_SUCCESS);
+	aucKey[WLAN_CFG_KEY_LEN_MAX] = '\0';
+	SELF_TEST_CHECK_OUT(wlanCfgGetEntry(prAdapter, aucKey, FALSE) ==
+		&prWlanCfg->arWlanCfgBuf[0]);
+	aucKey[WLAN_CFG_KEY_LEN_MAX - 2] = '\0';
+	SELF_TEST_CHECK_OUT(wlanCfgGetEntry(prAdapter, aucKey, FALSE) == NULL);
+
+	fgPass = TRUE;
+out:
+	free(prAdapter);
+	return fgPass;
+}
+
+/* Adapter with the BSS_INFO and STA_REC setup of wlanAdapterStart().
+ * Its command buffers are left empty, so commands to the firmware fail
+ * to allocate and are dropped.
+ */
+static struct ADAPTER *selfTestAllocAdapter(void)
+{
+	struct ADAPTER *prAdapter;
+	struct GLUE_INFO *prGlueInfo;
+	uint32_t i;
+
+	prAdapter = calloc(1, sizeof(struct ADAPTER));
+	prGlueInfo = calloc(1, sizeof(struct GLUE_INFO));
+	if (!prAdapter || !prGlueInfo) {
+		free(prAdapter);
+		free(prGlueInfo);
+		return NULL;
+	}
+	prAdapter->prGlueInfo = prGlueInfo;
+	prGlueInfo->prAdapter = prAdapter;
+
+#ifdef MT6639
+	prAdapter->chip_info = mt66xx_driver_data_mt6639.chip_info;
+#endif
+	prAdapter->ucHwBssIdNum = BSS_DEFAULT_NUM;
+	prAdapter->ucP2PDevBssIdx = BSS_DEFAULT_NUM;
+	prAdapter->ucWtblEntryNum = WTBL_SIZE;
+	prAdapter->ucTxDefaultWlanIndex = prAdapter->ucWtblEntryNum - 1;
+	prAdapter->ucStaRecNum = CFG_STA_REC_NUM;
+	for (i = 0; i < MAX_BSSID_NUM; i++)
+		prAdapter->aprBssInfo[i] =
+			&prAdapter->rWifiVar.arBssInfoPool[i];
+	prAdapter->aprBssInfo[prAdapter->ucP2PDevBssIdx] =
+		&prAdapter->rWifiVar.rP2pDevInfo;
+#if CFG_DBG_MGT_BUF
+	LINK_INITIALIZE(&prAdapter->rMemTrackLink);
+#endif
+
+	cnmStaRecInit(prAdapter);
+
+	return prAdapter;
+}
+
+static void selfTestFreeAdapter(struct ADAPTER *prAdapter)
+{
+	free(prAdapter->prGlueInfo);
+	free(prAdapter);
+}
+
+/* Linear scan of the STA_RECs, what cnmGetStaRecByAddress() did before
+ * the hash index
+ */
+static struct STA_RECORD *selfTestStaRecScan(struct ADAPTER *prAdapter,
+					     uint8_t ucBssIndex,
+					     uint8_t *pucMacAddr)
+{
+	struct STA_RECORD *prStaRec;
+	uint32_t i;
+
+	for (i = 0; i < CFG_STA_REC_NUM; i++) {
+		prStaRec = &prAdapter->arStaRec[i];
+		if (prStaRec->fgIsInUse &&
+		    prStaRec->ucBssIndex == ucBssIndex &&
+		    EQUAL_MAC_ADDR(prStaRec->aucMacAddr, pucMacAddr))
+			return prStaRec;
+	}
+
+	return NULL;
+}
+
+/* Every address of the test, in use or not, looked up both ways */
+static u_int8_t selfTestStaRecCheck(struct ADAPTER *prAdapter,
+				    uint8_t aucMac[][MAC_ADDR_LEN],
+				    uint32_t u4Num)
+{
+	struct STA_RECORD *prStaRec;
+	uint32_t i;
+	uint8_t ucBss;
+
+	for (i = 0; i < u4Num; i++) {
+		for (ucBss = 0; ucBss <= MAX_BSSID_NUM; ucBss++) {
+			prStaRec = selfTestStaRecScan(prAdapter, ucBss,
+						      aucMac[i]);
+			SELF_TEST_CHECK(cnmGetStaRecByAddress(prAdapter,
+				ucBss, aucMac[i]) == prStaRec);
+			if (prStaRec)
+				SELF_TEST_CHECK(cnmGetStaRecByWlanIdx(prAdapter,
+					prStaRec->ucWlanIndex) == prStaRec);
+		}
+	}
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief STA_REC lookup by MAC address and by WLAN index through
+ *        cnmStaRecAlloc()/cnmStaRecFree(). Half of the addresses only differ
+ *        in the OUI, which the hash ignores, so they all probe from the same
+ *        home slot and removals have to shift them back.
+ *
+ * @return TRUE if every lookup matches a linear scan
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestStaRecHash(void)
+{
+	uint8_t aucMac[CFG_STA_REC_NUM + 4][MAC_ADDR_LEN];
+	struct STA_RECORD *aprStaRec[CFG_STA_REC_NUM + 4];
+	struct STA_RECORD *prStaRec;
+	struct ADAPTER *prAdapter;
+	u_int8_t fgPass = FALSE;
+	uint32_t u4Num = CFG_STA_REC_NUM + 4;
+	uint32_t i;
+
+	prAdapter = selfTestAllocAdapter();
+	if (!prAdapter)
+		return FALSE;
+
+	for (i = 0; i < u4Num; i++) {
+		aucMac[i][0] = 0x02;
+		aucMac[i][1] = (uint8_t)(i >> 1);
+		aucMac[i][2] = 0x00;
+		aucMac[i][3] = 0x11;
+		aucMac[i][4] = 0x22;
+		aucMac[i][5] = (i & 1) ? (uint8_t)i : 0x33;
+	}
+
+	/* fill up the STA_RECs over two BSSes */
+	for (i = 0; i < CFG_STA_REC_NUM; i++) {
+		aprStaRec[i] = cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_AP,
+					      (uint8_t)(i % 2), aucMac[i]);
+		SELF_TEST_CHECK_OUT(aprStaRec[i] != NULL);
+	}
+	SELF_TEST_CHECK_OUT(cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_AP,
+		0, aucMac[CFG_STA_REC_NUM]) == NULL);
+	SELF_TEST_CHECK_OUT(selfTestStaRecCheck(prAdapter, aucMac, u4Num));
+
+	/* a miss in the hinted BSS falls back to the other BSSes */
+	prStaRec = cnmGetStaRecByAddressAnyBss(prAdapter, 1, aucMac[0]);
+	SELF_TEST_CHECK_OUT(prStaRec == aprStaRec[0]);
+
+	/* remove from the middle of the shared probe sequence */
+	for (i = 0; i < CFG_STA_REC_NUM; i += 3)
+		cnmStaRecFree(prAdapter, aprStaRec[i]);
+	SELF_TEST_CHECK_OUT(selfTestStaRecCheck(prAdapter, aucMac, u4Num));
+	for (i = 0; i < CFG_STA_REC_NUM; i += 3)
+		SELF_TEST_CHECK_OUT(cnmGetStaRecByAddress(prAdapter,
+			(uint8_t)(i % 2), aucMac[i]) == NULL);
+
+	/* and refill with new addresses */
+	for (i = CFG_STA_REC_NUM; i < u4Num; i++) {
+		aprStaRec[i] = cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_AP,
+					      2, aucMac[i]);
+		SELF_TEST_CHECK_OUT(aprStaRec[i] != NULL);
+	}
+	SELF_TEST_CHECK_OUT(selfTestStaRecCheck(prAdapter, aucMac, u4Num));
+
+	fgPass = TRUE;
+out:
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+
+/* Linear scan of the scan result, what scanSearchBssDescByBssid() did
+ * before the hash index. Also counts the descriptors with that BSSID.
+ */
+static struct BSS_DESC *selfTestBssDescScan(struct ADAPTER *prAdapter,
+					    uint8_t *pucBssid,
+					    uint32_t *pu4Num)
+{
+	struct LINK *prBSSDescList =
+		&prAdapter->rWifiVar.rScanInfo.rBSSDescList;
+	struct BSS_DESC *prBssDesc, *prFirst = NULL;
+
+	*pu4Num = 0;
+	LINK_FOR_EACH_ENTRY(prBssDesc, prBSSDescList, rLinkEntry,
+			    struct BSS_DESC) {
+		if (!EQUAL_MAC_ADDR(prBssDesc->aucBSSID, pucBssid))
+			continue;
+		if (!prFirst)
+			prFirst = prBssDesc;
+		(*pu4Num)++;
+	}
+
+	return prFirst;
+}
+
+/* Whether prBssDesc is linked on prLink through the given member */
+#define SELF_TEST_ON_LINK(_prLink, _prBssDesc, _rMember, _fgFound) \
+	do { \
+		struct BSS_DESC *_prEntry; \
+		(_fgFound) = FALSE; \
+		LINK_FOR_EACH_ENTRY(_prEntry, _prLink, _rMember, \
+				    struct BSS_DESC) { \
+			if (_prEntry == (_prBssDesc)) \
+				(_fgFound) = TRUE; \
+		} \
+	} while (0)
+
+/* Every descriptor of the scan result must be filed under the buckets of
+ * its current BSSID, band and channel, and nothing else may be.
+ */
+static u_int8_t selfTestBssDescCheck(struct ADAPTER *prAdapter)
+{
+	struct SCAN_INFO *prScanInfo = &prAdapter->rWifiVar.rScanInfo;
+	struct BSS_DESC *prBssDesc, *prFound;
+	uint32_t i, j, u4Num = 0, u4Hash = 0, u4Chnl = 0, u4Same;
+	u_int8_t fgFound;
+
+	LINK_FOR_EACH_ENTRY(prBssDesc, &prScanInfo->rBSSDescList, rLinkEntry,
+			    struct BSS_DESC) {
+		u4Num++;
+		SELF_TEST_ON_LINK(&prScanInfo->arBssDescHash[
+			SCN_BSS_DESC_HASH(prBssDesc->aucBSSID)],
+			prBssDesc, rLinkEntryHash, fgFound);
+		SELF_TEST_CHECK(fgFound);
+		SELF_TEST_ON_LINK(&prScanInfo->aarBssDescChnl[
+			SCN_BSS_DESC_BAND_IDX(prBssDesc->eBand)][
+			SCN_BSS_DESC_CHNL_HASH(prBssDesc->ucChannelNum)],
+			prBssDesc, rLinkEntryChnl, fgFound);
+		SELF_TEST_CHECK(fgFound);
+
+		/* a BSSID seen on several channels may match any of them */
+		prFound = scanSearchBssDescByBssid(prAdapter,
+						   prBssDesc->aucBSSID);
+		SELF_TEST_CHECK(prFound != NULL);
+		SELF_TEST_CHECK(EQUAL_MAC_ADDR(prFound->aucBSSID,
+					       prBssDesc->aucBSSID));
+		if (selfTestBssDescScan(prAdapter, prBssDesc->aucBSSID,
+					&u4Same) == prBssDesc && u4Same == 1)
+			SELF_TEST_CHECK(prFound == prBssDesc);
+	}
+	SELF_TEST_CHECK(u4Num == prScanInfo->rBSSDescList.u4NumElem);
+	SELF_TEST_CHECK(u4Num + prScanInfo->rFreeBSSDescList.u4NumElem ==
+		CFG_MAX_NUM_BSS_LIST);
+
+	for (i = 0; i < SCN_BSS_DESC_HASH_NUM; i++)
+		u4Hash += prScanInfo->arBssDescHash[i].u4NumElem;
+	for (i = 0; i < BAND_NUM; i++)
+		for (j = 0; j < SCN_BSS_DESC_CHNL_HASH_NUM; j++)
+			u4Chnl += prScanInfo->aarBssDescChnl[i][j].u4NumElem;
+	SELF_TEST_CHECK(u4Hash == u4Num);
+	SELF_TEST_CHECK(u4Chnl == u4Num);
+
+	return TRUE;
+}
+
+/* Test BSSIDs only use 8 of the 64 buckets */
+static void selfTestBssDescBssid(uint32_t u4Id, uint8_t *pucBssid)
+{
+	pucBssid[0] = 0x02;
+	pucBssid[1] = (uint8_t)(u4Id >> 3);
+	pucBssid[2] = 0x00;
+	pucBssid[3] = 0x11;
+	pucBssid[4] = 0x11;
+	pucBssid[5] = (uint8_t)(u4Id & 7);
+}
+
+/* The i-th test descriptor, odd ones on 5G. The last 12 repeat the
+ * BSSIDs of descriptors 1 to 12 on the other band.
+ */
+static void selfTestBssDescSet(struct BSS_DESC *prBssDesc, uint32_t i)
+{
+	uint32_t u4Id = (i >= CFG_MAX_NUM_BSS_LIST - 12) ?
+			i - (CFG_MAX_NUM_BSS_LIST - 13) : i;
+
+	selfTestBssDescBssid(u4Id, prBssDesc->aucBSSID);
+	prBssDesc->eBSSType = BSS_TYPE_INFRASTRUCTURE;
+	if (i & 1) {
+		prBssDesc->eBand = BAND_5G;
+		prBssDesc->ucChannelNum = (uint8_t)(36 + 4 * (i % 8));
+	} else {
+		prBssDesc->eBand = BAND_2G4;
+		prBssDesc->ucChannelNum = (uint8_t)(1 + i % 13);
+	}
+}
+
+/* An adapter with an empty scan result and AIS on BSS 0 */
+static struct ADAPTER *selfTestScanAdapter(void)
+{
+	struct ADAPTER *prAdapter;
+	uint32_t i;
+
+	prAdapter = selfTestAllocAdapter();
+	if (!prAdapter)
+		return NULL;
+	LINK_INITIALIZE(&prAdapter->rWifiVar.rBlackList.rUsingLink);
+	for (i = 0; i < KAL_AIS_NUM; i++)
+		LINK_INITIALIZE(
+			&aisGetAisSpecBssInfo(prAdapter, i)->rCurEssLink);
+	prAdapter->aprBssInfo[0]->eNetworkType = NETWORK_TYPE_AIS;
+	scnInit(prAdapter);
+
+	return prAdapter;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief BSS descriptor BSSID and (band, channel) buckets through
+ *        scanAllocateBssDesc(), a channel switch, scanRemoveBssDescByBssid()
+ *        and scanRemoveBssDescByBandAndNetwork()
+ *
+ * @return TRUE if the buckets always match the scan result
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestBssDescHash(void)
+{
+	struct SCAN_INFO *prScanInfo;
+	struct BSS_DESC *prBssDesc;
+	struct ADAPTER *prAdapter;
+	u_int8_t fgPass = FALSE;
+	uint8_t aucBssid[MAC_ADDR_LEN];
+	uint32_t i, u4Num;
+
+	prAdapter = selfTestScanAdapter();
+	if (!prAdapter)
+		return FALSE;
+	prScanInfo = &prAdapter->rWifiVar.rScanInfo;
+
+	/* fill the scan result the way scanAddToBssDesc() does */
+	for (i = 0; i < CFG_MAX_NUM_BSS_LIST; i++) {
+		prBssDesc = scanAllocateBssDesc(prAdapter);
+		SELF_TEST_CHECK_OUT(prBssDesc != NULL);
+		selfTestBssDescSet(prBssDesc, i);
+		scanUpdateBssDescIndex(prAdapter, prBssDesc);
+	}
+	SELF_TEST_CHECK_OUT(scanAllocateBssDesc(prAdapter) == NULL);
+	SELF_TEST_CHECK_OUT(selfTestBssDescCheck(prAdapter));
+
+	/* channel switch of every third BSS, some of them across bands */
+	i = 0;
+	LINK_FOR_EACH_ENTRY(prBssDesc, &prScanInfo->rBSSDescList, rLinkEntry,
+			    struct BSS_DESC) {
+		if (i++ % 3)
+			continue;
+		prBssDesc->ucChannelNum = (uint8_t)(prBssDesc->ucChannelNum +
+			(prBssDesc->eBand == BAND_5G ? 4 : 1));
+		scanUpdateBssDescIndex(prAdapter, prBssDesc);
+	}
+	SELF_TEST_CHECK_OUT(selfTestBssDescCheck(prAdapter));
+
+	/* remove a BSSID seen on both bands and a few single ones */
+	selfTestBssDescBssid(1, aucBssid);
+	SELF_TEST_CHECK_OUT(selfTestBssDescScan(prAdapter, aucBssid, &u4Num)
+		!= NULL && u4Num == 2);
+	scanRemoveBssDescByBssid(prAdapter, aucBssid);
+	SELF_TEST_CHECK_OUT(scanSearchBssDescByBssid(prAdapter, aucBssid)
+		== NULL);
+	for (i = 20; i < 60; i += 7) {
+		selfTestBssDescBssid(i, aucBssid);
+		scanRemoveBssDescByBssid(prAdapter, aucBssid);
+		SELF_TEST_CHECK_OUT(selfTestBssDescScan(prAdapter, aucBssid,
+			&u4Num) == NULL);
+	}
+	SELF_TEST_CHECK_OUT(prScanInfo->rBSSDescList.u4NumElem ==
+		CFG_MAX_NUM_BSS_LIST - 8);
+	SELF_TEST_CHECK_OUT(selfTestBssDescCheck(prAdapter));
+
+	/* drop the 5G BSSes through their channel buckets */
+	scanRemoveBssDescByBandAndNetwork(prAdapter, BAND_5G, 0);
+	LINK_FOR_EACH_ENTRY(prBssDesc, &prScanInfo->rBSSDescList, rLinkEntry,
+			    struct BSS_DESC)
+		SELF_TEST_CHECK_OUT(prBssDesc->eBand == BAND_2G4);
+	SELF_TEST_CHECK_OUT(selfTestBssDescCheck(prAdapter));
+
+	/* and refill from the free list */
+	for (i = 1; i < CFG_MAX_NUM_BSS_LIST; i += 2) {
+		prBssDesc = scanAllocateBssDesc(prAdapter);
+		if (!prBssDesc)
+			break;
+		selfTestBssDescSet(prBssDesc, i);
+		scanUpdateBssDescIndex(prAdapter, prBssDesc);
+	}
+	SELF_TEST_CHECK_OUT(selfTestBssDescCheck(prAdapter));
+
+	fgPass = TRUE;
+out:
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+
+#if CFG_SUPPORT_CSI
+/* Random I or Q sample in [-u4Gain, u4Gain) */
+static int16_t selfTestCsiRand(uint32_t *pu4Seed, uint32_t u4Gain)
+{
+	*pu4Seed = *pu4Seed * 1103515245 + 12345;
+	return (int16_t)((int32_t)((*pu4Seed >> 8) % (2 * u4Gain)) -
+			 (int32_t)u4Gain);
+}
+
+/* Push one report the way the CSI event handler does */
+static u_int8_t selfTestCsiRingPush(struct ADAPTER *prAdapter,
+				    uint32_t u4Tag)
+{
+	struct CSI_DATA_T *prCSIData = wlanCSIRingReserve(prAdapter);
+
+	if (!prCSIData)
+		return FALSE;
+
+	prCSIData->u4ExtraInfo = u4Tag;
+	wlanCSIRingCommit(prAdapter);
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief CSI ring index handling: fill, drop on full, drain, wrap around
+ *        and flush, checking the order and sequence numbers seen by the
+ *        reader
+ *
+ * @return TRUE if all match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestCsiRing(void)
+{
+	struct CSI_INFO_T *prCSIInfo;
+	struct CSI_DATA_T *prCSIData;
+	struct ADAPTER *prAdapter;
+	u_int8_t fgPass = FALSE;
+	uint32_t i;
+
+	prAdapter = calloc(1, sizeof(struct ADAPTER));
+	if (!prAdapter)
+		return FALSE;
+	prCSIInfo = &prAdapter->rCSIInfo;
+
+	SELF_TEST_CHECK_OUT(wlanCSIRingPeek(prAdapter) == NULL);
+
+	/* one slot stays empty */
+	for (i = 0; i < CSI_RING_SIZE - 1; i++)
+		SELF_TEST_CHECK_OUT(selfTestCsiRingPush(prAdapter, i));
+	SELF_TEST_CHECK_OUT(!selfTestCsiRingPush(prAdapter, i));
+	SELF_TEST_CHECK_OUT(prCSIInfo->u4CSIDropCnt == 1);
+
+	/* the reader sees every report in order, a drop leaves a gap */
+	for (i = 0; i < CSI_RING_SIZE - 1; i++) {
+		prCSIData = wlanCSIRingPeek(prAdapter);
+		SELF_TEST_CHECK_OUT(prCSIData != NULL);
+		SELF_TEST_CHECK_OUT(prCSIData->u4ExtraInfo == i);
+		SELF_TEST_CHECK_OUT(prCSIData->u4Seq == i);
+		wlanCSIRingConsume(prAdapter);
+	}
+	SELF_TEST_CHECK_OUT(wlanCSIRingPeek(prAdapter) == NULL);
+
+	/* across the end of the buffer, a reserved slot starts zeroed */
+	for (i = 0; i < 5; i++) {
+		prCSIData = wlanCSIRingReserve(prAdapter);
+		SELF_TEST_CHECK_OUT(prCSIData != NULL);
+		SELF_TEST_CHECK_OUT(prCSIData->u4ExtraInfo == 0);
+		prCSIData->u4ExtraInfo = 100 + i;
+		wlanCSIRingCommit(prAdapter);
+	}
+	SELF_TEST_CHECK_OUT(prCSIInfo->u4CSIBufferTail == 4);
+	for (i = 0; i < 5; i++) {
+		prCSIData = wlanCSIRingPeek(prAdapter);
+		SELF_TEST_CHECK_OUT(prCSIData != NULL);
+		SELF_TEST_CHECK_OUT(prCSIData->u4ExtraInfo == 100 + i);
+		SELF_TEST_CHECK_OUT(prCSIData->u4Seq == CSI_RING_SIZE + i);
+		wlanCSIRingConsume(prAdapter);
+	}
+	SELF_TEST_CHECK_OUT(wlanCSIRingPeek(prAdapter) == NULL);
+
+	/* a flush drops whatever the reader has not taken yet */
+	for (i = 0; i < 10; i++)
+		SELF_TEST_CHECK_OUT(selfTestCsiRingPush(prAdapter, i));
+	wlanCSIRingFlush(prAdapter);
+	SELF_TEST_CHECK_OUT(wlanCSIRingPeek(prAdapter) == NULL);
+	SELF_TEST_CHECK_OUT(selfTestCsiRingPush(prAdapter, 7));
+	prCSIData = wlanCSIRingPeek(prAdapter);
+	SELF_TEST_CHECK_OUT(prCSIData != NULL);
+	SELF_TEST_CHECK_OUT(prCSIData->u4ExtraInfo == 7);
+	SELF_TEST_CHECK_OUT(prCSIInfo->u4CSIDropCnt == 1);
+
+	fgPass = TRUE;
+out:
+	free(prAdapter);
+	return fgPass;
+}
+#endif
+
+#if CFG_SUPPORT_CSI_NF
+/* Per-tone loops the CSI noise filter, BWD filter and noise count used
+ * before they were flattened
+ */
+static bool selfTestCsiNfRef(struct CSI_DATA_T *prCSIData,
+			     uint32_t au4Val[], bool *pfgHighPass)
+{
+	uint32_t i_data, q_data, tmp;
+	uint32_t u4Prim20 = 0, u4Sec20 = 0, u4Sec40 = 0;
+	uint16_t u2Prim20, u2Sec20, u2Sec40, u2Noise = 0, i;
+	uint8_t ucDBW = 0;
+
+	kalMemSet(au4Val, 0, sizeof(uint32_t) * CSI_MAX_DATA_COUNT);
+	for (i = 0; i < prCSIData->u2DataCount; i++) {
+		if ((prCSIData->ucRxMode == RX_VT_HE_MODE) &&
+		    (prCSIData->ucBw == RX_VT_FR_MODE_80) &&
+		    (prCSIData->ucDataBw == RX_VT_FR_MODE_80)) {
+			if ((i < CSI_DCTONE_NUM) ||
+			    (i >= (prCSIData->u2DataCount - CSI_DCTONE_NUM))) {
+				prCSIData->ac2IData[i] = 0;
+				prCSIData->ac2QData[i] = 0;
+			}
+		}
+		i_data = abs(prCSIData->ac2IData[i]);
+		q_data = abs(prCSIData->ac2QData[i]);
+		tmp = i_data < q_data ? i_data : q_data;
+		au4Val[i] = (i_data > q_data ? i_data : q_data) +
+			    (tmp >> 2) + (tmp >> 1);
+	}
+
+	for (i = 0; i < CSI_MAX_DATA_COUNT; i++)
+		if (au4Val[i] < CSI_NOISE_TH)
+			u2Noise++;
+	*pfgHighPass = u2Noise <= CSI_NOISE_CNT_TH;
+
+	if ((prCSIData->ucBw != RX_VT_FR_MODE_80) &&
+	    (prCSIData->ucDataBw != RX_VT_FR_MODE_80))
+		return TRUE;
+
+	if (prCSIData->ucDataBw == RX_VT_FR_MODE_80) {
+		switch (prCSIData->ucPrimaryChIdx) {
+		case 0:
+			u2Prim20 = 130, u2Sec20 = 194, u2Sec40 = 3;
+			break;
+		case 1:
+			u2Prim20 = 194, u2Sec20 = 130, u2Sec40 = 3;
+			break;
+		case 2:
+			u2Prim20 = 2, u2Sec20 = 66, u2Sec40 = 131;
+			break;
+		case 3:
+			u2Prim20 = 66, u2Sec20 = 2, u2Sec40 = 131;
+			break;
+		default:
+			return FALSE;
+		}
+		for (i = 0; i < 60; i++) {
+			u4Prim20 += au4Val[u2Prim20 + i];
+			u4Sec20 += au4Val[u2Sec20 + i];
+		}
+		for (i = 0; i < 120; i++)
+			u4Sec40 += au4Val[u2Sec40 + i];
+		u4Prim20 /= 60;
+		u4Sec20 /= 60;
+		u4Sec40 /= 120;
+
+		if (u4Prim20 > u4Sec20 * CSI_DBW20_RATIO_TH)
+			ucDBW = 0;
+		else if (u4Prim20 + u4Sec20 >
+			 u4Sec40 * 2 * CSI_DBW40_RATIO_TH)
+			ucDBW = 1;
+		else
+			ucDBW = 2;
+	}
+
+	return prCSIData->ucDataBw == ucDBW;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief wlanCSINoiseFilter(), wlanBWDFilter() and wlanCSILikeHighPass()
+ *        against the per-tone loops they replaced, over random reports of
+ *        every bandwidth, primary channel and length. The sub-bands get
+ *        different gains so every BWD decision is taken.
+ *
+ * @return TRUE if the magnitudes, the cleared DC tones and all decisions
+ *         match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestCsiNf(void)
+{
+	static const uint16_t au2Cnt[] = {
+		CSI_MAX_DATA_COUNT, 242, 64, CSI_DCTONE_NUM * 2, 2, 0
+	};
+	static struct CSI_DATA_T rData, rRef;
+	uint32_t au4Val[CSI_MAX_DATA_COUNT], au4Ref[CSI_MAX_DATA_COUNT];
+	uint32_t u4Seed = 1, u4Case, u4Gain[4], u4Pass[2] = {0};
+	bool fgRet, fgRef, fgHighPass;
+	uint16_t i;
+
+	for (u4Case = 0; u4Case < 2000; u4Case++) {
+		kalMemZero(&rData, sizeof(rData));
+		u4Seed = u4Seed * 1103515245 + 12345;
+		rData.u2DataCount = au2Cnt[(u4Seed >> 8) % ARRAY_SIZE(au2Cnt)];
+		rData.ucRxMode = (u4Seed & BIT(16)) ? RX_VT_HE_MODE : 0;
+		rData.ucBw = (uint8_t)((u4Seed >> 17) % 3);
+		rData.ucDataBw = (uint8_t)((u4Seed >> 20) % 3);
+		rData.ucPrimaryChIdx = (uint8_t)((u4Seed >> 23) % 4);
+		for (i = 0; i < 4; i++) {
+			u4Seed = u4Seed * 1103515245 + 12345;
+			u4Gain[i] = 1 << ((u4Seed >> 16) % 16);
+		}
+		for (i = 0; i < CSI_MAX_DATA_COUNT; i++) {
+			rData.ac2IData[i] = selfTestCsiRand(&u4Seed,
+							    u4Gain[i / 64]);
+			rData.ac2QData[i] = selfTestCsiRand(&u4Seed,
+							    u4Gain[i / 64]);
+		}
+		if (u4Case == 0) {
+			rData.ac2IData[5] = -32768;
+			rData.ac2QData[6] = -32768;
+			rData.ac2IData[7] = 32767;
+		}
+		kalMemCopy(&rRef, &rData, sizeof(rData));
+
+		fgRet = wlanCSINoiseFilter(NULL, &rData, au4Val);
+		fgRef = selfTestCsiNfRef(&rRef, au4Ref, &fgHighPass);
+		SELF_TEST_CHECK(fgRet == fgRef);
+		SELF_TEST_CHECK(kalMemCmp(au4Val, au4Ref, sizeof(au4Val)) == 0);
+		SELF_TEST_CHECK(kalMemCmp(&rData, &rRef, sizeof(rData)) == 0);
+		SELF_TEST_CHECK(wlanCSILikeHighPass(NULL, au4Val,
+			CSI_MAX_DATA_COUNT) == fgHighPass);
+		u4Pass[fgRet]++;
+	}
+	/* both outcomes of the filters were seen */
+	SELF_TEST_CHECK(u4Pass[0] && u4Pass[1]);
+
+	return TRUE;
+}
+#endif
+
+/* Download one section through the virtual HIF and check what the
+ * virtual firmware received
+ */
+static u_int8_t selfTestFwDlSection(struct ADAPTER *prAdapter,
+				    uint8_t *pucImage, uint32_t u4Len)
+{
+	struct VIRT_FW *prFw = &prAdapter->prGlueInfo->rHifInfo.rFw;
+	uint32_t u4InitCmdCnt = prFw->u4InitCmdCnt;
+	uint32_t u4DlBytes = prFw->u4DlBytes;
+
+	SELF_TEST_CHECK(wlanDownloadSection(prAdapter, 0x900000, u4Len, 0,
+		pucImage, IMG_DL_IDX_N9_FW) == WLAN_STATUS_SUCCESS);
+	SELF_TEST_CHECK(prFw->eState == VIRT_FW_STATE_ROM);
+	SELF_TEST_CHECK(prFw->u4DlBytes - u4DlBytes == u4Len);
+	/* an empty section is not sent at all */
+	if (u4Len == 0) {
+		SELF_TEST_CHECK(prFw->u4InitCmdCnt == u4InitCmdCnt);
+		return TRUE;
+	}
+	SELF_TEST_CHECK(prFw->u4DlCrc == kalCRC32(pucImage, u4Len));
+	/* one config command, then one scatter per chunk */
+	SELF_TEST_CHECK(prFw->u4InitCmdCnt - u4InitCmdCnt ==
+		1 + (u4Len + CMD_PKT_SIZE_FOR_IMAGE - 1) /
+		CMD_PKT_SIZE_FOR_IMAGE);
+
+	return TRUE;
+}
+
+/* An adapter with command buffers and the FWDL ports of the virtual HIF */
+static struct ADAPTER *selfTestFwDlAdapter(void)
+{
+	struct ADAPTER *prAdapter;
+
+	prAdapter = selfTestAllocAdapter();
+	if (!prAdapter)
+		return NULL;
+
+	prAdapter->u4MgtBufCachedSize = MGT_BUFFER_SIZE;
+	prAdapter->pucMgtBufCached = calloc(1, MGT_BUFFER_SIZE);
+	if (!prAdapter->pucMgtBufCached)
+		goto fail;
+	prAdapter->u4CoalescingBufCachedSize =
+		halGetValidCoalescingBufSize(prAdapter);
+	prAdapter->pucCoalescingBufCached =
+		calloc(1, prAdapter->u4CoalescingBufCachedSize);
+	if (!prAdapter->pucCoalescingBufCached)
+		goto fail;
+	prAdapter->rTxCtrl.pucTxCoalescingBufPtr =
+		prAdapter->pucCoalescingBufCached;
+	if (halAllocateIOBuffer(prAdapter) != WLAN_STATUS_SUCCESS)
+		goto fail;
+	cnmMemInit(prAdapter);
+	cmdBufInitialize(prAdapter);
+	halHifSwInfoInit(prAdapter);
+	/* TXD hooks and FWDL ports, as wlanAdapterStart() sets them */
+	prAdapter->chip_info->asicCapInit(prAdapter);
+
+	return prAdapter;
+
+fail:
+	free(prAdapter->pucCoalescingBufCached);
+	free(prAdapter->pucMgtBufCached);
+	selfTestFreeAdapter(prAdapter);
+	return NULL;
+}
+
+static void selfTestFwDlFreeAdapter(struct ADAPTER *prAdapter)
+{
+	halReleaseIOBuffer(prAdapter);
+	free(prAdapter->pucCoalescingBufCached);
+	free(prAdapter->pucMgtBufCached);
+	selfTestFreeAdapter(prAdapter);
+}
+
+/* A pseudo random FW image */
+static void selfTestFwDlImage(uint8_t *pucImage, uint32_t u4Len)
+{
+	uint32_t i, u4Seed = 1;
+
+	for (i = 0; i < u4Len; i++) {
+		u4Seed = u4Seed * 1103515245 + 12345;
+		pucImage[i] = (uint8_t)(u4Seed >> 16);
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief FW section download through the virtual HIF: empty, short, whole
+ *        chunk and chunk plus tail sections, checking the data the
+ *        virtual firmware received and the number of scatters
+ *
+ * @return TRUE if all match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestFwDl(void)
+{
+	struct ADAPTER *prAdapter;
+	uint8_t *pucImage = NULL;
+	uint32_t u4Len = 3 * CMD_PKT_SIZE_FOR_IMAGE + 123;
+	u_int8_t fgPass = FALSE;
+
+	prAdapter = selfTestFwDlAdapter();
+	if (!prAdapter)
+		return FALSE;
+
+	pucImage = malloc(u4Len);
+	SELF_TEST_CHECK_OUT(pucImage != NULL);
+	selfTestFwDlImage(pucImage, u4Len);
+
+	SELF_TEST_CHECK_OUT(selfTestFwDlSection(prAdapter, pucImage, 0));
+	SELF_TEST_CHECK_OUT(selfTestFwDlSection(prAdapter, pucImage, 77));
+	SELF_TEST_CHECK_OUT(selfTestFwDlSection(prAdapter, pucImage,
+		2 * CMD_PKT_SIZE_FOR_IMAGE));
+	SELF_TEST_CHECK_OUT(selfTestFwDlSection(prAdapter, pucImage + 1,
+		u4Len - 1));
+	SELF_TEST_CHECK_OUT(selfTestFwDlSection(prAdapter, pucImage, u4Len));
+
+	fgPass = TRUE;
+out:
+	free(pucImage);
+	selfTestFwDlFreeAdapter(prAdapter);
+	return fgPass;
+}
+
+/* Fire tick and count of the timers of the timer wheel test */
+static uint32_t au4SelfTestTimerTick[4];
+static uint32_t au4SelfTestTimerCnt[4];
+
+static void selfTestTimerCb(struct ADAPTER *prAdapter, unsigned long ulData)
+{
+	au4SelfTestTimerTick[ulData] = kalGetTimeTick();
+	au4SelfTestTimerCnt[ulData]++;
+}
+
+/* Wheel level of a pending timer: 0, 1 or 2 */
+static uint32_t selfTestTimerLevel(struct TIMER *prTimer)
+{
+	if (prTimer->u2WheelSlot < TIMER_WHEEL_L0_SIZE)
+		return 0;
+	if (prTimer->u2WheelSlot < TIMER_WHEEL_L0_SIZE + TIMER_WHEEL_LN_SIZE)
+		return 1;
+	return 2;
+}
+
+/* Step the frozen clock up to u4Tick, running the timeout check every
+ * u4Step ticks and on u4Tick itself
+ */
+static void selfTestTimerRunTo(struct ADAPTER *prAdapter, uint32_t u4Tick,
+			       uint32_t u4Step)
+{
+	uint32_t u4Left;
+
+	while ((u4Left = u4Tick - kalGetTimeTick()) != 0 &&
+	       u4Left <= 0x7fffffff) {
+		if (u4Left > u4Step)
+			u4Left = u4Step;
+		kal_virt_clock_advance((uint64_t) u4Left * NSEC_PER_MSEC);
+		cnmTimerDoTimeOutCheck(prAdapter);
+	}
+}
+
+/* Move the frozen clock to the next tick that is u4Rem modulo u4Mod */
+static void selfTestTimerAlign(uint32_t u4Mod, uint32_t u4Rem)
+{
+	kal_virt_clock_advance(NSEC_PER_MSEC -
+		kal_sched_clock() % NSEC_PER_MSEC);
+	kal_virt_clock_advance((uint64_t) ((u4Rem - kalGetTimeTick()) %
+		u4Mod) * NSEC_PER_MSEC);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Root timer wheel on a frozen clock: cascades at the level 0 and
+ *        level 1 wrap, a timeout beyond the wheel range after a long stall,
+ *        and stop/restart of a timer that sits in an upper level
+ *
+ * @return TRUE if every timer fires once, on its tick
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestTimerWheel(void)
+{
+	struct ADAPTER *prAdapter;
+	struct ROOT_TIMER *prRootTimer;
+	struct TIMER arTimer[4];
+	u_int8_t fgPass = FALSE;
+	uint32_t u4Start, u4Expiry, u4Level, i;
+
+	prAdapter = selfTestAllocAdapter();
+	if (!prAdapter)
+		return FALSE;
+	prRootTimer = &prAdapter->rRootTimer;
+	kalMemZero(arTimer, sizeof(arTimer));
+	kalMemZero(au4SelfTestTimerCnt, sizeof(au4SelfTestTimerCnt));
+	kal_virt_clock_freeze(true);
+
+	/* 16 ticks before a level 0 wrap, 300 ticks away is in level 1 and
+	 * is cascaded at the second wrap
+	 */
+	selfTestTimerAlign(TIMER_WHEEL_L0_SIZE, TIMER_WHEEL_L0_SIZE - 16);
+	cnmTimerInitialize(prAdapter);
+	for (i = 0; i < ARRAY_SIZE(arTimer); i++)
+		cnmTimerInitTimerOption(prAdapter, &arTimer[i],
+			selfTestTimerCb, i, TIMER_WAKELOCK_NONE);
+	u4Start = kalGetTimeTick();
+	u4Expiry = u4Start + 300;
+	cnmTimerStartTimer(prAdapter, &arTimer[0], 300);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[0]) == 1);
+	SELF_TEST_CHECK_OUT(prAdapter->prGlueInfo->fgTimerSet &&
+		prAdapter->prGlueInfo->rTimerExpiry == u4Expiry);
+	while (kalGetTimeTick() != u4Expiry - 1) {
+		selfTestTimerRunTo(prAdapter, kalGetTimeTick() + 1, 1);
+		SELF_TEST_CHECK_OUT(timerPendingTimer(&arTimer[0]));
+		u4Level = (kalGetTimeTick() - u4Start < 16 + 256) ? 1 : 0;
+		SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[0]) == u4Level);
+	}
+	selfTestTimerRunTo(prAdapter, u4Expiry, 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[0] == 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[0] == u4Expiry);
+	SELF_TEST_CHECK_OUT(prRootTimer->u4WheelTimerNum == 0);
+
+	/* 100 ticks before a level 1 wrap, 20000 ticks away is in level 2,
+	 * run the checks in coarse steps so empty slots get skipped
+	 */
+	selfTestTimerAlign(BIT(TIMER_WHEEL_L0_BITS + TIMER_WHEEL_LN_BITS),
+		BIT(TIMER_WHEEL_L0_BITS + TIMER_WHEEL_LN_BITS) - 100);
+	u4Expiry = kalGetTimeTick() + 20000;
+	cnmTimerStartTimer(prAdapter, &arTimer[1], 20000);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[1]) == 2);
+	u4Level = 2;
+	while (TIME_BEFORE(kalGetTimeTick(), u4Expiry - 300)) {
+		selfTestTimerRunTo(prAdapter, kalGetTimeTick() + 97, 97);
+		SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[1] == 0);
+		SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[1]) <= u4Level);
+		u4Level = selfTestTimerLevel(&arTimer[1]);
+	}
+	selfTestTimerRunTo(prAdapter, u4Expiry - 1, 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[1] == 0);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[1]) == 0);
+	selfTestTimerRunTo(prAdapter, u4Expiry, 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[1] == 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[1] == u4Expiry);
+
+	/* Stall for a little less than the wheel covers with a timer
+	 * pending, a new timer is then more than 2^20 ticks away from the
+	 * wheel time and is clamped to the last slot before the wheel time
+	 */
+	u4Start = kalGetTimeTick();
+	cnmTimerStartTimer(prAdapter, &arTimer[2], 10);
+	kal_virt_clock_advance((uint64_t) (TIMER_WHEEL_RANGE - 1000) *
+		NSEC_PER_MSEC);
+	u4Expiry = kalGetTimeTick() + 50000;
+	cnmTimerStartTimer(prAdapter, &arTimer[3], 50000);
+	SELF_TEST_CHECK_OUT(arTimer[3].u2WheelSlot == TIMER_WHEEL_L0_SIZE +
+		TIMER_WHEEL_LN_SIZE + (((u4Start + TIMER_WHEEL_RANGE - 1) >>
+		(TIMER_WHEEL_L0_BITS + TIMER_WHEEL_LN_BITS)) &
+		TIMER_WHEEL_LN_MASK));
+	SELF_TEST_CHECK_OUT(arTimer[3].rExpiredSysTime == u4Expiry);
+	cnmTimerDoTimeOutCheck(prAdapter);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[2] == 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[2] - u4Start ==
+		TIMER_WHEEL_RANGE - 1000);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[3]) == 2);
+	selfTestTimerRunTo(prAdapter, u4Expiry - 1, 1000);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[3] == 0);
+	selfTestTimerRunTo(prAdapter, u4Expiry, 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[3] == 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[3] == u4Expiry);
+
+	/* Stall for longer than the wheel covers, everything is due but a
+	 * timer started after the stall must still wait for its own tick
+	 */
+	kalMemZero(au4SelfTestTimerCnt, sizeof(au4SelfTestTimerCnt));
+	u4Start = kalGetTimeTick();
+	cnmTimerStartTimer(prAdapter, &arTimer[2], 10);
+	kal_virt_clock_advance((uint64_t) (TIMER_WHEEL_RANGE + 5000) *
+		NSEC_PER_MSEC);
+	u4Expiry = kalGetTimeTick() + 50000;
+	cnmTimerStartTimer(prAdapter, &arTimer[3], 50000);
+	cnmTimerDoTimeOutCheck(prAdapter);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[2] == 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[2] - u4Start ==
+		TIMER_WHEEL_RANGE + 5000);
+	SELF_TEST_CHECK_OUT(timerPendingTimer(&arTimer[3]));
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[3]) == 2);
+	selfTestTimerRunTo(prAdapter, u4Expiry - 1, 1000);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[3] == 0);
+	selfTestTimerRunTo(prAdapter, u4Expiry, 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[3] == 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[3] == u4Expiry);
+
+	/* Stop a timer of level 1, then restart it, and restart it again
+	 * while pending, into level 2 and back into level 0
+	 */
+	kalMemZero(au4SelfTestTimerCnt, sizeof(au4SelfTestTimerCnt));
+	cnmTimerStartTimer(prAdapter, &arTimer[0], 1000);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[0]) == 1);
+	selfTestTimerRunTo(prAdapter, kalGetTimeTick() + 300, 7);
+	cnmTimerStopTimer(prAdapter, &arTimer[0]);
+	SELF_TEST_CHECK_OUT(!timerPendingTimer(&arTimer[0]));
+	SELF_TEST_CHECK_OUT(prRootTimer->u4WheelTimerNum == 0);
+	for (i = 0; i < TIMER_WHEEL_BITMAP_NUM; i++)
+		SELF_TEST_CHECK_OUT(prRootTimer->au4WheelBitmap[i] == 0);
+	selfTestTimerRunTo(prAdapter, kalGetTimeTick() + 1000, 7);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[0] == 0);
+
+	cnmTimerStartTimer(prAdapter, &arTimer[0], 5000);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[0]) == 1);
+	selfTestTimerRunTo(prAdapter, kalGetTimeTick() + 600, 7);
+	u4Expiry = kalGetTimeTick() + 30000;
+	cnmTimerStartTimer(prAdapter, &arTimer[0], 30000);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[0]) == 2);
+	SELF_TEST_CHECK_OUT(prRootTimer->u4WheelTimerNum == 1);
+	selfTestTimerRunTo(prAdapter, kalGetTimeTick() + 6000, 7);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[0] == 0);
+	selfTestTimerRunTo(prAdapter, u4Expiry - 1, 13);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[0] == 0);
+	selfTestTimerRunTo(prAdapter, u4Expiry, 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[0] == 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[0] == u4Expiry);
+
+	cnmTimerStartTimer(prAdapter, &arTimer[0], 20000);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[0]) == 2);
+	u4Expiry = kalGetTimeTick() + 10;
+	cnmTimerStartTimer(prAdapter, &arTimer[0], 10);
+	SELF_TEST_CHECK_OUT(selfTestTimerLevel(&arTimer[0]) == 0);
+	selfTestTimerRunTo(prAdapter, kalGetTimeTick() + 30000, 1);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerCnt[0] == 2);
+	SELF_TEST_CHECK_OUT(au4SelfTestTimerTick[0] == u4Expiry);
+	SELF_TEST_CHECK_OUT(prRootTimer->u4WheelTimerNum == 0);
+
+	fgPass = TRUE;
+out:
+	cnmTimerDestroy(prAdapter);
+	kal_virt_clock_freeze(false);
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+
+#if QM_RX_REORDER_SLOT_INDEX
+/* SN stream of the reorder test and benchmark: blocks of u4Block SNs in
+ * shuffled order, each SN sent twice with 1/u4DupRate chance, and a jump
+ * past the window every 16th block if fgJump
+ */
+static void selfTestReorderStream(uint16_t *pu2SN, uint32_t u4Num,
+				  uint16_t u2Start, uint32_t u4Block,
+				  uint32_t u4DupRate, u_int8_t fgJump)
+{
+	uint16_t au2Block[1024];
+	uint32_t u4Seed = 1, u4Base = u2Start, i = 0, j, k, u4Blk = 0;
+	uint16_t u2Tmp;
+
+	while (i < u4Num) {
+		for (j = 0; j < u4Block; j++)
+			au2Block[j] = (uint16_t)((u4Base + j) % MAX_SEQ_NO_COUNT);
+		for (j = u4Block - 1; j > 0; j--) {
+			u4Seed = u4Seed * 1103515245 + 12345;
+			k = (u4Seed >> 16) % (j + 1);
+			u2Tmp = au2Block[j];
+			au2Block[j] = au2Block[k];
+			au2Block[k] = u2Tmp;
+		}
+		for (j = 0; j < u4Block && i < u4Num; j++) {
+			pu2SN[i++] = au2Block[j];
+			u4Seed = u4Seed * 1103515245 + 12345;
+			if (u4DupRate && (u4Seed >> 16) % u4DupRate == 0 &&
+			    i < u4Num)
+				pu2SN[i++] = au2Block[j];
+		}
+		u4Base += u4Block;
+		if (fgJump && (++u4Blk % 16) == 0)
+			u4Base += 3 * u4Block;
+	}
+}
+
+/* Feed a SN stream into a BA entry, the RFBs are taken round robin from
+ * a pool of u4PoolNum. prOut collects what the reordering gives back.
+ */
+static void selfTestReorderRun(struct ADAPTER *prAdapter,
+			       struct RX_BA_ENTRY *prEntry,
+			       struct SW_RFB *prPool, uint32_t u4PoolNum,
+			       uint16_t *pu2SN, uint32_t u4Num,
+			       struct QUE *prOut)
+{
+	/* zeroed ethernet header, for the fall behind no drop check */
+	static uint8_t aucHeader[ETH_HLEN + 32];
+	struct SW_RFB *prSwRfb;
+	struct QUE rReturnedQue;
+	uint32_t i;
+
+	for (i = 0; i < u4Num; i++) {
+		prSwRfb = &prPool[i % u4PoolNum];
+		kalMemZero(prSwRfb, sizeof(*prSwRfb));
+		prSwRfb->u2SSN = pu2SN[i];
+		prSwRfb->ucTid = prEntry->ucTid;
+		prSwRfb->ucStaRecIdx = prEntry->ucStaRecIdx;
+		prSwRfb->ucPayloadFormat = RX_PAYLOAD_FORMAT_MSDU;
+		prSwRfb->eDst = RX_PKT_DESTINATION_HOST;
+		prSwRfb->pvHeader = aucHeader;
+		prSwRfb->ucWlanIdx = WTBL_SIZE;
+
+		QUEUE_INITIALIZE(&rReturnedQue);
+		qmInsertReorderPkt(prAdapter, prSwRfb, prEntry,
+			&rReturnedQue);
+		if (prOut)
+			QUEUE_CONCATENATE_QUEUES(prOut, &rReturnedQue);
+	}
+}
+
+/* Adapter with the QM and the root timer set up for RX BA entries */
+static struct ADAPTER *selfTestReorderAllocAdapter(void)
+{
+	struct ADAPTER *prAdapter = selfTestAllocAdapter();
+
+	if (!prAdapter)
+		return NULL;
+
+	cnmTimerInitialize(prAdapter);
+	qmInit(prAdapter, FALSE);
+	/* Holes are only closed by a later SN, never by the miss timeout,
+	 * so both engines see the same and timing does not matter
+	 */
+	prAdapter->u4QmRxBaMissTimeout = 3600 * MSEC_PER_SEC;
+
+	return prAdapter;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief RX reorder slot index: the slot array sized by qmAddRxBaEntry(),
+ *        lookups across the SN wrap at 4096, and its release by
+ *        qmDelRxBaEntry(). A shuffled stream with duplicates and window
+ *        jumps goes through an indexed and a linear BA entry, both must
+ *        give back the same packets in the same order.
+ *
+ * @return TRUE if all match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestRxReorder(void)
+{
+	struct ADAPTER *prAdapter;
+	struct STA_RECORD *prStaRec;
+	struct RX_BA_ENTRY *prIdx, *prLin;
+	struct SW_RFB *prPoolIdx = NULL, *prPoolLin = NULL;
+	struct SW_RFB *prA, *prB, *prLast = NULL;
+	struct QUE rOutIdx, rOutLin;
+	uint16_t *pu2SN = NULL;
+	uint16_t au2Win[] = {4090, 4095, 3};
+	uint32_t u4Num = 3 * MAX_SEQ_NO_COUNT + 1000;
+	uint32_t u4Wrap = 0;
+	u_int8_t fgPass = FALSE;
+
+	prAdapter = selfTestReorderAllocAdapter();
+	if (!prAdapter)
+		return FALSE;
+	prStaRec = &prAdapter->arStaRec[0];
+	QUEUE_INITIALIZE(&rOutIdx);
+	QUEUE_INITIALIZE(&rOutLin);
+
+	/* the slot array is the power of 2 covering the window */
+	SELF_TEST_CHECK_OUT(qmAddRxBaEntry(prAdapter, 0, 0, 4090,
+		200 - CFG_RX_BA_INC_SIZE));
+	prIdx = prStaRec->aprRxReorderParamRefTbl[0];
+	SELF_TEST_CHECK_OUT(prIdx && prIdx->aprReorderSlot);
+	SELF_TEST_CHECK_OUT(prIdx->u2WinSize == 200);
+	SELF_TEST_CHECK_OUT(prIdx->u2SlotNum == 256);
+
+	/* queue 4095 and 3 behind a hole at 4090, across the SN wrap */
+	prPoolIdx = calloc(u4Num, sizeof(struct SW_RFB));
+	prPoolLin = calloc(u4Num, sizeof(struct SW_RFB));
+	pu2SN = calloc(u4Num, sizeof(uint16_t));
+	SELF_TEST_CHECK_OUT(prPoolIdx && prPoolLin && pu2SN);
+	prIdx->fgIsWaitingForPktWithSsn = FALSE;
+	selfTestReorderRun(prAdapter, prIdx, prPoolIdx, 3, au2Win + 1, 2,
+		&rOutIdx);
+	SELF_TEST_CHECK_OUT(QUEUE_IS_EMPTY(&rOutIdx));
+	SELF_TEST_CHECK_OUT(qmRxReorderSlotGet(prIdx, 4095) == &prPoolIdx[0]);
+	SELF_TEST_CHECK_OUT(qmRxReorderSlotGet(prIdx, 3) == &prPoolIdx[1]);
+	SELF_TEST_CHECK_OUT(qmRxReorderSlotGet(prIdx, 3 + 256) == NULL);
+	SELF_TEST_CHECK_OUT(qmRxReorderSlotGet(prIdx, 4090) == NULL);
+	SELF_TEST_CHECK_OUT(qmRxReorderSlotFindNext(prIdx, 4090) ==
+		&prPoolIdx[0]);
+	SELF_TEST_CHECK_OUT(qmRxReorderSlotFindNext(prIdx, 4095) ==
+		&prPoolIdx[1]);
+	SELF_TEST_CHECK_OUT(qmRxReorderSlotFindNext(prIdx, 3) == NULL);
+
+	/* 4090 fills the hole and flushes up to 4095 */
+	selfTestReorderRun(prAdapter, prIdx, prPoolIdx + 2, 1, au2Win, 1,
+		&rOutIdx);
+	SELF_TEST_CHECK_OUT(rOutIdx.u4NumElem == 1);
+	SELF_TEST_CHECK_OUT(prIdx->rReOrderQue.u4NumElem == 2);
+	SELF_TEST_CHECK_OUT(prIdx->u2WinStart == 4091);
+
+	/* deleting the BA entry returns the queued RFBs and the slots */
+	qmDelRxBaEntry(prAdapter, 0, 0, FALSE);
+	SELF_TEST_CHECK_OUT(prStaRec->aprRxReorderParamRefTbl[0] == NULL);
+	SELF_TEST_CHECK_OUT(prIdx->aprReorderSlot == NULL);
+	SELF_TEST_CHECK_OUT(prIdx->pu4ReorderSlotBitmap == NULL);
+	SELF_TEST_CHECK_OUT(prIdx->u2SlotNum == 0);
+	SELF_TEST_CHECK_OUT(prAdapter->rRxCtrl.rIndicatedRfbList.u4NumElem ==
+		2);
+	/* the pool is reused below */
+	QUEUE_INITIALIZE(&prAdapter->rRxCtrl.rIndicatedRfbList);
+
+	/* indexed and linear engine on the same stream */
+	QUEUE_INITIALIZE(&rOutIdx);
+	SELF_TEST_CHECK_OUT(qmAddRxBaEntry(prAdapter, 0, 0, 4000, 64));
+	SELF_TEST_CHECK_OUT(qmAddRxBaEntry(prAdapter, 0, 1, 4000, 64));
+	prIdx = prStaRec->aprRxReorderParamRefTbl[0];
+	prLin = prStaRec->aprRxReorderParamRefTbl[1];
+	qmRxReorderSlotFree(prAdapter, prLin);
+	SELF_TEST_CHECK_OUT(prIdx->aprReorderSlot && !prLin->aprReorderSlot);
+
+	selfTestReorderStream(pu2SN, u4Num, 4000, 48, 8, TRUE);
+	selfTestReorderRun(prAdapter, prIdx, prPoolIdx, u4Num, pu2SN, u4Num,
+		&rOutIdx);
+	selfTestReorderRun(prAdapter, prLin, prPoolLin, u4Num, pu2SN, u4Num,
+		&rOutLin);
+	SELF_TEST_CHECK_OUT(rOutIdx.u4NumElem == rOutLin.u4NumElem);
+	SELF_TEST_CHECK_OUT(prIdx->rReOrderQue.u4NumElem ==
+		prLin->rReOrderQue.u4NumElem);
+	SELF_TEST_CHECK_OUT(prIdx->u2WinStart == prLin->u2WinStart);
+	while (QUEUE_IS_NOT_EMPTY(&rOutIdx)) {
+		QUEUE_REMOVE_HEAD(&rOutIdx, prA, struct SW_RFB *);
+		QUEUE_REMOVE_HEAD(&rOutLin, prB, struct SW_RFB *);
+		SELF_TEST_CHECK_OUT(prA - prPoolIdx == prB - prPoolLin);
+		SELF_TEST_CHECK_OUT(prA->eDst == prB->eDst);
+		if (prA->eDst == RX_PKT_DESTINATION_NULL)
+			continue;
+		/* what is passed on is in SN order */
+		SELF_TEST_CHECK_OUT(!prLast ||
+			qmCompareSnIsLessThan(prLast->u2SSN, prA->u2SSN));
+		if (prLast && prA->u2SSN < prLast->u2SSN)
+			u4Wrap++;
+		prLast = prA;
+	}
+	SELF_TEST_CHECK_OUT(u4Wrap >= 2);
+	qmDelRxBaEntry(prAdapter, 0, 0, FALSE);
+	qmDelRxBaEntry(prAdapter, 0, 1, FALSE);
+	SELF_TEST_CHECK_OUT(prAdapter->rQM.ucRxBaCount == 0);
+
+	fgPass = TRUE;
+out:
+	free(pu2SN);
+	free(prPoolLin);
+	free(prPoolIdx);
+	cnmTimerDestroy(prAdapter);
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+#endif /* QM_RX_REORDER_SLOT_INDEX */
+
+#define SELF_TEST_TOKEN_NUM		64
+#define SELF_TEST_TOKEN_THREAD_NUM	4
+
+/* A token of the pool tests, fgInUse catches a token handed out twice */
+struct SELF_TEST_TOKEN {
+	uint32_t u4Id;
+	uint32_t fgInUse;
+};
+
+struct SELF_TEST_TOKEN_THREAD {
+	pthread_t rThread;
+	struct TOKEN_POOL *prPool;
+	uint32_t u4Cpu;
+	uint32_t u4Loop;
+	uint32_t u4Burst;	/* tokens held at once, random up to this */
+	uint32_t *pu4Start;	/* start barrier */
+	uint32_t u4Err;		/* token handed out twice */
+	uint32_t u4Get;		/* tokens taken */
+};
+
+/* Take up to u4Burst tokens on one virtual CPU and return them on the
+ * next one, the way TX completion runs on another CPU than xmit. Caches
+ * drift, so refill, drain and steal all race with each other.
+ */
+static void *selfTestTokenThread(void *pvArg)
+{
+	struct SELF_TEST_TOKEN_THREAD *prArg = pvArg;
+	struct SELF_TEST_TOKEN *aprHeld[TOKEN_CACHE_SIZE];
+	uint32_t u4Seed = prArg->u4Cpu + 1;
+	uint32_t u4Loop, u4Num, i;
+
+	__atomic_sub_fetch(prArg->pu4Start, 1, __ATOMIC_ACQ_REL);
+	while (__atomic_load_n(prArg->pu4Start, __ATOMIC_ACQUIRE))
+		sched_yield();
+
+	for (u4Loop = 0; u4Loop < prArg->u4Loop; u4Loop++) {
+		u4Seed = u4Seed * 1103515245 + 12345;
+		u4Num = 1 + (u4Seed >> 16) % prArg->u4Burst;
+
+		kal_virt_set_cpu(prArg->u4Cpu);
+		for (i = 0; i < u4Num; i++) {
+			aprHeld[i] = tokenPoolGet(prArg->prPool);
+			if (!aprHeld[i])
+				break;
+			if (__atomic_exchange_n(&aprHeld[i]->fgInUse, 1,
+						__ATOMIC_ACQ_REL))
+				prArg->u4Err++;
+		}
+		u4Num = i;
+		prArg->u4Get += u4Num;
+
+		kal_virt_set_cpu(prArg->u4Cpu + (u4Loop & 1));
+		for (i = 0; i < u4Num; i++) {
+			__atomic_store_n(&aprHeld[i]->fgInUse, 0,
+					 __ATOMIC_RELEASE);
+			tokenPoolPut(prArg->prPool, aprHeld[i]);
+		}
+	}
+
+	kal_virt_set_cpu(0);
+	return NULL;
+}
+
+/* Run u4ThreadNum token threads to the end, FALSE if one did not start */
+static u_int8_t selfTestTokenRun(struct TOKEN_POOL *prPool,
+				 struct SELF_TEST_TOKEN_THREAD *arThread,
+				 uint32_t u4ThreadNum, uint32_t u4Loop,
+				 uint32_t u4Burst)
+{
+	uint32_t u4Start = u4ThreadNum;
+	uint32_t i, u4Created;
+
+	for (u4Created = 0; u4Created < u4ThreadNum; u4Created++) {
+		kalMemZero(&arThread[u4Created], sizeof(arThread[0]));
+		arThread[u4Created].prPool = prPool;
+		arThread[u4Created].u4Cpu = u4Created;
+		arThread[u4Created].u4Loop = u4Loop;
+		arThread[u4Created].u4Burst = u4Burst;
+		arThread[u4Created].pu4Start = &u4Start;
+		if (pthread_create(&arThread[u4Created].rThread, NULL,
+				   selfTestTokenThread,
+				   &arThread[u4Created]))
+			break;
+	}
+	/* release the barrier for the threads which did start */
+	if (u4Created < u4ThreadNum)
+		__atomic_sub_fetch(&u4Start, u4ThreadNum - u4Created,
+				   __ATOMIC_ACQ_REL);
+	for (i = 0; i < u4Created; i++)
+		pthread_join(arThread[i].rThread, NULL);
+
+	return u4Created == u4ThreadNum;
+}
+
+/* Take every free token from CPU 0, each one must show up exactly once */
+static uint32_t selfTestTokenDrain(struct TOKEN_POOL *prPool,
+				   struct SELF_TEST_TOKEN *arToken)
+{
+	struct SELF_TEST_TOKEN *prToken;
+	uint32_t u4Cnt = 0;
+
+	while ((prToken = tokenPoolGet(prPool)) != NULL) {
+		if (prToken->fgInUse)
+			return 0;
+		prToken->fgInUse = 1;
+		u4Cnt++;
+	}
+	for (u4Cnt = 0; u4Cnt < SELF_TEST_TOKEN_NUM; u4Cnt++) {
+		if (!arToken[u4Cnt].fgInUse)
+			break;
+		arToken[u4Cnt].fgInUse = 0;
+	}
+	return u4Cnt;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Token pool: cache refill and drain in batches, stealing from other
+ *        CPUs once the stack is empty, and SELF_TEST_TOKEN_THREAD_NUM
+ *        threads on their own virtual CPUs taking and returning tokens.
+ *        No token may be handed out twice or get lost.
+ *
+ * @return TRUE if all match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestTokenPool(void)
+{
+	struct SELF_TEST_TOKEN arToken[SELF_TEST_TOKEN_NUM];
+	struct SELF_TEST_TOKEN_THREAD arThread[SELF_TEST_TOKEN_THREAD_NUM];
+	void *aprHeld[TOKEN_CACHE_BATCH + 1];
+	struct TOKEN_POOL rPool;
+	struct SELF_TEST_TOKEN *prToken;
+	u_int8_t fgPass = FALSE;
+	uint32_t i;
+
+	kalMemZero(&rPool, sizeof(rPool));
+	kalMemZero(arToken, sizeof(arToken));
+	SELF_TEST_CHECK(tokenPoolInit(&rPool, SELF_TEST_TOKEN_NUM, TRUE));
+	for (i = 0; i < SELF_TEST_TOKEN_NUM; i++) {
+		arToken[i].u4Id = i;
+		tokenPoolAdd(&rPool, &arToken[i]);
+	}
+	SELF_TEST_CHECK_OUT(rPool.u4CacheNum == KAL_VIRT_CPU_NUM);
+
+	/* an empty cache takes a batch off the top of the stack */
+	kal_virt_set_cpu(1);
+	prToken = tokenPoolGet(&rPool);
+	SELF_TEST_CHECK_OUT(prToken ==
+		&arToken[SELF_TEST_TOKEN_NUM - TOKEN_CACHE_BATCH]);
+	SELF_TEST_CHECK_OUT(rPool.arCache[1].u4Cnt == TOKEN_CACHE_BATCH - 1);
+	SELF_TEST_CHECK_OUT(rPool.u4StackCnt ==
+		SELF_TEST_TOKEN_NUM - TOKEN_CACHE_BATCH);
+	SELF_TEST_CHECK_OUT(tokenPoolFreeCnt(&rPool) ==
+		SELF_TEST_TOKEN_NUM - 1);
+	tokenPoolPut(&rPool, prToken);
+
+	/* tokens taken on CPU 2 and completed on CPU 1 fill up its cache,
+	 * a full cache gives a batch back before taking the token
+	 */
+	kal_virt_set_cpu(2);
+	for (i = 0; i <= TOKEN_CACHE_BATCH; i++)
+		aprHeld[i] = tokenPoolGet(&rPool);
+	SELF_TEST_CHECK_OUT(rPool.arCache[2].u4Cnt == TOKEN_CACHE_BATCH - 1);
+	kal_virt_set_cpu(1);
+	for (i = 0; i <= TOKEN_CACHE_BATCH; i++)
+		tokenPoolPut(&rPool, aprHeld[i]);
+	SELF_TEST_CHECK_OUT(rPool.arCache[1].u4Cnt == TOKEN_CACHE_BATCH + 1);
+	SELF_TEST_CHECK_OUT(rPool.u4StackCnt ==
+		SELF_TEST_TOKEN_NUM - 2 * TOKEN_CACHE_BATCH);
+	SELF_TEST_CHECK_OUT(tokenPoolFreeCnt(&rPool) == SELF_TEST_TOKEN_NUM);
+
+	/* CPU 0 empties the stack, then steals the rest from CPU 1 and 2 */
+	kal_virt_set_cpu(0);
+	SELF_TEST_CHECK_OUT(selfTestTokenDrain(&rPool, arToken) ==
+		SELF_TEST_TOKEN_NUM);
+	SELF_TEST_CHECK_OUT(tokenPoolFreeCnt(&rPool) == 0);
+
+	tokenPoolReset(&rPool);
+	for (i = 0; i < SELF_TEST_TOKEN_NUM; i++) {
+		arToken[i].fgInUse = 0;
+		tokenPoolAdd(&rPool, &arToken[i]);
+	}
+	SELF_TEST_CHECK_OUT(selfTestTokenRun(&rPool, arThread,
+		SELF_TEST_TOKEN_THREAD_NUM, 50000, 24));
+	for (i = 0; i < SELF_TEST_TOKEN_THREAD_NUM; i++)
+		SELF_TEST_CHECK_OUT(arThread[i].u4Err == 0);
+	SELF_TEST_CHECK_OUT(tokenPoolFreeCnt(&rPool) == SELF_TEST_TOKEN_NUM);
+	SELF_TEST_CHECK_OUT(selfTestTokenDrain(&rPool, arToken) ==
+		SELF_TEST_TOKEN_NUM);
+
+	/* without caches it is the plain global stack */
+	tokenPoolUninit(&rPool);
+	SELF_TEST_CHECK(tokenPoolInit(&rPool, SELF_TEST_TOKEN_NUM, FALSE));
+	SELF_TEST_CHECK_OUT(rPool.arCache == NULL);
+	for (i = 0; i < SELF_TEST_TOKEN_NUM; i++)
+		tokenPoolAdd(&rPool, &arToken[i]);
+	SELF_TEST_CHECK_OUT(tokenPoolGet(&rPool) ==
+		&arToken[SELF_TEST_TOKEN_NUM - 1]);
+	SELF_TEST_CHECK_OUT(selfTestTokenRun(&rPool, arThread,
+		SELF_TEST_TOKEN_THREAD_NUM, 20000, 24));
+	for (i = 0; i < SELF_TEST_TOKEN_THREAD_NUM; i++)
+		SELF_TEST_CHECK_OUT(arThread[i].u4Err == 0);
+	SELF_TEST_CHECK_OUT(tokenPoolFreeCnt(&rPool) ==
+		SELF_TEST_TOKEN_NUM - 1);
+
+	fgPass = TRUE;
+out:
+	kal_virt_set_cpu(0);
+	tokenPoolUninit(&rPool);
+	return fgPass;
+}
+
+#define SELF_TEST_INBOX_THREAD_NUM	4
+#define SELF_TEST_INBOX_NUM		50000	/* frames per producer */
+
+/* A frame of the TX inbox test, pushed by producer u4Thread as u4Seq */
+struct SELF_TEST_INBOX_FRAME {
+	struct QUE_ENTRY rQueEntry;
+	uint32_t u4Thread;
+	uint32_t u4Seq;
+};
+
+struct SELF_TEST_INBOX_THREAD {
+	pthread_t rThread;
+	struct QUE_ENTRY **pprInbox;
+	struct SELF_TEST_INBOX_FRAME *arFrame;
+	uint32_t *pu4Start;	/* start barrier */
+	uint32_t *pu4Done;	/* producers finished */
+};
+
+/* A netdev xmit path pushing its frames onto the TX inbox */
+static void *selfTestInboxThread(void *pvArg)
+{
+	struct SELF_TEST_INBOX_THREAD *prArg = pvArg;
+	uint32_t i;
+
+	__atomic_sub_fetch(prArg->pu4Start, 1, __ATOMIC_ACQ_REL);
+	while (__atomic_load_n(prArg->pu4Start, __ATOMIC_ACQUIRE))
+		sched_yield();
+
+	for (i = 0; i < SELF_TEST_INBOX_NUM; i++)
+		QUEUE_MPSC_PUSH(prArg->pprInbox, &prArg->arFrame[i].rQueEntry);
+
+	__atomic_add_fetch(prArg->pu4Done, 1, __ATOMIC_ACQ_REL);
+	return NULL;
+}
+
+/* Take the inbox and count its frames in *pu4Got, FALSE if one does not
+ * follow the previous frame of its producer
+ */
+static u_int8_t selfTestInboxDrain(struct QUE_ENTRY **pprInbox,
+				   uint32_t *au4Next, uint32_t *pu4Got)
+{
+	struct SELF_TEST_INBOX_FRAME *prFrame;
+	struct QUE rQue;
+
+	QUEUE_INITIALIZE(&rQue);
+	QUEUE_MPSC_MOVE_ALL(&rQue, pprInbox);
+	while (QUEUE_IS_NOT_EMPTY(&rQue)) {
+		QUEUE_REMOVE_HEAD(&rQue, prFrame,
+				  struct SELF_TEST_INBOX_FRAME *);
+		if (prFrame->u4Seq != au4Next[prFrame->u4Thread]++)
+			return FALSE;
+		(*pu4Got)++;
+	}
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief TX inbox of kalHardStartXmit(): SELF_TEST_INBOX_THREAD_NUM
+ *        producers push with QUEUE_MPSC_PUSH() while the consumer takes
+ *        the inbox with QUEUE_MPSC_MOVE_ALL(). Every frame must arrive
+ *        once and in the order of its producer.
+ *
+ * @return TRUE if all match
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestTxInbox(void)
+{
+	struct SELF_TEST_INBOX_THREAD arThread[SELF_TEST_INBOX_THREAD_NUM];
+	uint32_t au4Next[SELF_TEST_INBOX_THREAD_NUM] = {0};
+	uint32_t u4Size = SELF_TEST_INBOX_THREAD_NUM * SELF_TEST_INBOX_NUM *
+			  sizeof(struct SELF_TEST_INBOX_FRAME);
+	struct SELF_TEST_INBOX_FRAME *arFrame;
+	struct QUE_ENTRY *prInbox = NULL;
+	struct QUE rQue;
+	uint32_t u4Start = SELF_TEST_INBOX_THREAD_NUM, u4Done = 0;
+	uint32_t u4Got = 0, u4Created, i, j;
+	u_int8_t fgOrder = TRUE, fgPass = FALSE;
+
+	arFrame = kalMemAlloc(u4Size, VIR_MEM_TYPE);
+	SELF_TEST_CHECK(arFrame != NULL);
+	for (i = 0; i < SELF_TEST_INBOX_THREAD_NUM; i++) {
+		for (j = 0; j < SELF_TEST_INBOX_NUM; j++) {
+			arFrame[i * SELF_TEST_INBOX_NUM + j].u4Thread = i;
+			arFrame[i * SELF_TEST_INBOX_NUM + j].u4Seq = j;
+		}
+	}
+	/* an empty inbox, then one producer keeps its order */
+	QUEUE_INITIALIZE(&rQue);
+	QUEUE_MPSC_MOVE_ALL(&rQue, &prInbox);
+	SELF_TEST_CHECK_OUT(QUEUE_IS_EMPTY(&rQue));
+	for (j = 0; j < 3; j++)
+		QUEUE_MPSC_PUSH(&prInbox, &arFrame[j].rQueEntry);
+	SELF_TEST_CHECK_OUT(selfTestInboxDrain(&prInbox, au4Next, &u4Got));
+	SELF_TEST_CHECK_OUT(u4Got == 3 && prInbox == NULL);
+	au4Next[0] = 0;
+	u4Got = 0;
+
+	/* producers race with the consumer */
+	for (u4Created = 0; u4Created < SELF_TEST_INBOX_THREAD_NUM;
+	     u4Created++) {
+		arThread[u4Created].pprInbox = &prInbox;
+		arThread[u4Created].arFrame =
+			&arFrame[u4Created * SELF_TEST_INBOX_NUM];
+		arThread[u4Created].pu4Start = &u4Start;
+		arThread[u4Created].pu4Done = &u4Done;
+		if (pthread_create(&arThread[u4Created].rThread, NULL,
+				   selfTestInboxThread, &arThread[u4Created]))
+			break;
+	}
+	if (u4Created < SELF_TEST_INBOX_THREAD_NUM)
+		__atomic_sub_fetch(&u4Start,
+			SELF_TEST_INBOX_THREAD_NUM - u4Created,
+			__ATOMIC_ACQ_REL);
+
+	while (fgOrder &&
+	       __atomic_load_n(&u4Done, __ATOMIC_ACQUIRE) < u4Created)
+		fgOrder = selfTestInboxDrain(&prInbox, au4Next, &u4Got);
+	for (i = 0; i < u4Created; i++)
+		pthread_join(arThread[i].rThread, NULL);
+	if (fgOrder)
+		fgOrder = selfTestInboxDrain(&prInbox, au4Next, &u4Got);
+
+	SELF_TEST_CHECK_OUT(u4Created == SELF_TEST_INBOX_THREAD_NUM);
+	SELF_TEST_CHECK_OUT(fgOrder);
+	SELF_TEST_CHECK_OUT(u4Got ==
+		SELF_TEST_INBOX_THREAD_NUM * SELF_TEST_INBOX_NUM);
+	for (i = 0; i < SELF_TEST_INBOX_THREAD_NUM; i++)
+		SELF_TEST_CHECK_OUT(au4Next[i] == SELF_TEST_INBOX_NUM);
+
+	fgPass = TRUE;
+out:
+	kalMemFree(arFrame, VIR_MEM_TYPE, u4Size);
+	return fgPass;
+}
+
+/* Probe of the virtual device, what wlanProbe() does on Linux: create the
+ * adapter and bring it up against the firmware emulator. The emulator
+ * answers the unified capability query with an all-zero capability.
+ */
+static struct ADAPTER *selfTestProbe(void)
+{
+	struct GLUE_INFO *prGlueInfo;
+	struct ADAPTER *prAdapter;
+
+	prGlueInfo = calloc(1, sizeof(struct GLUE_INFO));
+	if (!prGlueInfo)
+		return NULL;
+	QUEUE_INITIALIZE(&prGlueInfo->rCmdQueue);
+	QUEUE_INITIALIZE(&prGlueInfo->rTxQueue);
+
+	prAdapter = wlanAdapterCreate(prGlueInfo);
+	if (!prAdapter) {
+		free(prGlueInfo);
+		return NULL;
+	}
+	prGlueInfo->prAdapter = prAdapter;
+#ifdef MT6639
+	prAdapter->chip_info = mt66xx_driver_data_mt6639.chip_info;
+#endif
+
+	kal_virt_power_on(prAdapter);
+	kal_virt_fw_set_rule(prAdapter, TRUE, UNI_CMD_ID_CHIP_CONFIG,
+		UNI_EVENT_ID_CHIP_CAPABILITY, NULL,
+		sizeof(struct UNI_EVENT_CHIP_CAPABILITY));
+
+	wlanCfgInit(prAdapter, NULL, 0, 0);
+	prAdapter->chip_info->asicCapInit(prAdapter);
+	prAdapter->fgIsFwOwn = TRUE;
+
+	if (wlanAdapterStart(prAdapter, &prGlueInfo->rRegInfo, FALSE) !=
+	    WLAN_STATUS_SUCCESS) {
+		wlanAdapterDestroy(prAdapter);
+		free(prGlueInfo);
+		return NULL;
+	}
+
+	return prAdapter;
+}
+
+/* Run the driver threads until nothing is left to do */
+static void selfTestRunThreads(struct ADAPTER *prAdapter)
+{
+	uint32_t i;
+
+	for (i = 0; i < 1000; i++) {
+		if (!kalMainThreadRun(prAdapter->prGlueInfo))
+			return;
+	}
+}
+
+/* wlanRemove(): halt the threads, stop and free the adapter */
+static void selfTestRemove(struct ADAPTER *prAdapter)
+{
+	struct GLUE_INFO *prGlueInfo = prAdapter->prGlueInfo;
+
+	set_bit(GLUE_FLAG_HALT_BIT, &prGlueInfo->ulFlag);
+	wlanAdapterStop(prAdapter);
+	wlanAdapterDestroy(prAdapter);
+	free(prGlueInfo);
+}
+
+/* Mark the AIS BSS connected to an AP at aucBssid, what the join does once
+ * the association response is in
+ */
+static struct STA_RECORD *selfTestConnect(struct ADAPTER *prAdapter,
+					  uint8_t *aucBssid)
+{
+	struct BSS_INFO *prBssInfo;
+	struct STA_RECORD *prStaRec;
+
+	prBssInfo = aisGetAisBssInfo(prAdapter, AIS_DEFAULT_INDEX);
+	prStaRec = cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_AP,
+				  prBssInfo->ucBssIndex, aucBssid);
+	if (!prStaRec)
+		return NULL;
+
+	prBssInfo->eCurrentOPMode = OP_MODE_INFRASTRUCTURE;
+	prBssInfo->prStaRecOfAP = prStaRec;
+	COPY_MAC_ADDR(prBssInfo->aucBSSID, aucBssid);
+	SET_NET_ACTIVE(prAdapter, prBssInfo->ucBssIndex);
+	cnmStaRecChangeState(prAdapter, prStaRec, STA_STATE_3);
+	prBssInfo->eConnectionState = MEDIA_STATE_CONNECTED;
+
+	return prStaRec;
+}
+
+/* An Ethernet frame of u4Len bytes from pucSa to pucDa */
+static struct sk_buff *selfTestEthFrame(struct ADAPTER *prAdapter,
+					uint8_t *pucDa, uint8_t *pucSa,
+					uint32_t u4Len)
+{
+	struct sk_buff *prSkb;
+	uint8_t *pucData;
+
+	prSkb = kalPacketAlloc(prAdapter->prGlueInfo, u4Len, &pucData);
+	if (!prSkb)
+		return NULL;
+	skb_put(prSkb, u4Len);
+	kalMemSet(pucData, 0x5a, u4Len);
+	COPY_MAC_ADDR(pucData, pucDa);
+	COPY_MAC_ADDR(pucData + MAC_ADDR_LEN, pucSa);
+	WLAN_SET_FIELD_BE16(pucData + 2 * MAC_ADDR_LEN, ETH_P_IPV4);
+
+	return prSkb;
+}
+
+/* An AP on a P2P BSS with u4StaNum associated QoS clients, for traffic
+ * to more than one station
+ */
+static struct BSS_INFO *selfTestApStart(struct ADAPTER *prAdapter,
+					struct STA_RECORD **aprStaRec,
+					uint32_t u4StaNum)
+{
+	uint8_t aucMac[MAC_ADDR_LEN] = {0x02, 0x00, 0x00, 0x00, 0x01, 0x00};
+	struct BSS_INFO *prBssInfo;
+	uint32_t i;
+
+	prBssInfo = cnmGetBssInfoAndInit(prAdapter, NETWORK_TYPE_P2P, FALSE);
+	if (!prBssInfo)
+		return NULL;
+	prBssInfo->eCurrentOPMode = OP_MODE_ACCESS_POINT;
+	SET_NET_ACTIVE(prAdapter, prBssInfo->ucBssIndex);
+	prBssInfo->eConnectionState = MEDIA_STATE_CONNECTED;
+
+	for (i = 0; i < u4StaNum; i++) {
+		aucMac[5] = (uint8_t) i;
+		aprStaRec[i] = cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_CLIENT,
+					      prBssInfo->ucBssIndex, aucMac);
+		if (!aprStaRec[i])
+			return NULL;
+		aprStaRec[i]->fgIsQoS = TRUE;
+		cnmStaRecChangeState(prAdapter, aprStaRec[i], STA_STATE_3);
+	}
+
+	return prBssInfo;
+}
+
+/* Turn SW A-MSDU on or off for a station, what the TX BA event of the
+ * firmware sets up
+ */
+static void selfTestSetAmsdu(struct ADAPTER *prAdapter,
+			     struct STA_RECORD *prStaRec, u_int8_t fgEnable)
+{
+	prAdapter->chip_info->ucMaxSwAmsduNum = fgEnable ? 4 : 0;
+	prStaRec->ucAmsduEnBitmap = fgEnable ? BITS(0, 7) : 0;
+	prStaRec->ucMaxMpduCount = fgEnable ? 4 : 0;
+	prStaRec->u4MaxMpduLen = fgEnable ? 7935 : 0;
+	prStaRec->u4MinMpduLen = 0;
+}
+
+/* A TX flow: frames of u4Len bytes round robin over u4StaNum clients,
+ * each frame taking the next user priority of pucTid
+ */
+struct SELF_TEST_TX_FLOW {
+	const char *pucName;
+	uint32_t u4Len;
+	const uint8_t *pucTid;
+	uint32_t u4TidNum;
+	uint32_t u4StaNum;
+};
+
+#define SELF_TEST_TX_BATCH	64
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Send u4Num frames of a TX flow from kalHardStartXmit() down to the
+ *        data ring, SELF_TEST_TX_BATCH frames at a time. The driver threads
+ *        run after each batch, so every batch is completed before the next.
+ *
+ * @return ns spent in the driver, frame allocation excluded, 0 on failure
+ */
+/*----------------------------------------------------------------------------*/
+static uint64_t selfTestTxFlowRun(struct ADAPTER *prAdapter,
+				  struct BSS_INFO *prBssInfo,
+				  struct STA_RECORD **aprStaRec,
+				  const struct SELF_TEST_TX_FLOW *prFlow,
+				  uint32_t u4Num)
+{
+	struct sk_buff *aprSkb[SELF_TEST_TX_BATCH];
+	struct GLUE_INFO *prGlueInfo = prAdapter->prGlueInfo;
+	uint64_t u8Start, u8Ns = 0;
+	uint32_t u4Batch, i, j;
+
+	for (i = 0; i < u4Num; i += u4Batch) {
+		u4Batch = u4Num - i;
+		if (u4Batch > SELF_TEST_TX_BATCH)
+			u4Batch = SELF_TEST_TX_BATCH;
+
+		for (j = 0; j < u4Batch; j++) {
+			aprSkb[j] = selfTestEthFrame(prAdapter,
+				aprStaRec[(i + j) % prFlow->u4StaNum]->
+				aucMacAddr, prBssInfo->aucOwnMacAddr,
+				prFlow->u4Len);
+			if (!aprSkb[j]) {
+				while (j--)
+					kfree_skb(aprSkb[j]);
+				return 0;
+			}
+			aprSkb[j]->priority =
+				prFlow->pucTid[(i + j) % prFlow->u4TidNum];
+		}
+
+		u8Start = kal_sched_clock();
+		for (j = 0; j < u4Batch; j++) {
+			if (kalHardStartXmit(aprSkb[j], NULL, prGlueInfo,
+			    prBssInfo->ucBssIndex) != WLAN_STATUS_SUCCESS) {
+				while (++j < u4Batch)
+					kfree_skb(aprSkb[j]);
+				return 0;
+			}
+		}
+		selfTestRunThreads(prAdapter);
+		u8Ns += kal_sched_clock() - u8Start;
+	}
+
+	return u8Ns ? u8Ns : 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief The adapter from wlanAdapterStart() to wlanAdapterStop() against
+ *        the virtual device: a data frame goes out through QM and the TX
+ *        ring and completes, a header translated data frame comes in from
+ *        the data ring and reaches the OS, and an unsolicited event from
+ *        the firmware is dispatched.
+ *
+ * @return TRUE if every frame and the event arrive where they should
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestAdapter(void)
+{
+	uint8_t aucBssid[MAC_ADDR_LEN] = {0x02, 0x00, 0x00, 0x0a, 0x0b, 0x0c};
+	uint8_t aucRx[CFG_RX_MAX_PKT_SIZE];
+	struct HW_MAC_CONNAC3X_RX_DESC *prRxStatus;
+	struct HW_MAC_RX_STS_GROUP_4 *prGroup4;
+	struct EVENT_STA_CHANGE_PS_MODE rPsMode;
+	struct GL_HIF_INFO *prHifInfo;
+	struct GLUE_INFO *prGlueInfo;
+	struct BSS_INFO *prBssInfo;
+	struct STA_RECORD *prStaRec;
+	struct ADAPTER *prAdapter;
+	struct sk_buff *prSkb;
+	uint32_t u4RxdSize, u4HdrLen, u4Len, u4DoneCnt, u4EvtCnt;
+	u_int8_t fgPass = FALSE;
+
+	prAdapter = selfTestProbe();
+	SELF_TEST_CHECK(prAdapter != NULL);
+	prGlueInfo = prAdapter->prGlueInfo;
+	prHifInfo = &prGlueInfo->rHifInfo;
+	u4RxdSize = prAdapter->chip_info->rxd_size;
+	selfTestRunThreads(prAdapter);
+
+	prStaRec = selfTestConnect(prAdapter, aucBssid);
+	SELF_TEST_CHECK_OUT(prStaRec != NULL);
+	prBssInfo = GET_BSS_INFO_BY_INDEX(prAdapter, prStaRec->ucBssIndex);
+	selfTestRunThreads(prAdapter);
+
+	/* TX: kalHardStartXmit() to the data ring and back as TX done */
+	u4DoneCnt = prHifInfo->arTxRing[VIRT_TX_RING_DATA].u4DoneCnt;
+	prSkb = selfTestEthFrame(prAdapter, aucBssid,
+				 prBssInfo->aucOwnMacAddr, 1000);
+	SELF_TEST_CHECK_OUT(prSkb != NULL);
+	SELF_TEST_CHECK_OUT(kalHardStartXmit(prSkb, NULL, prGlueInfo,
+		prBssInfo->ucBssIndex) == WLAN_STATUS_SUCCESS);
+	selfTestRunThreads(prAdapter);
+	SELF_TEST_CHECK_OUT(prHifInfo->arTxRing[VIRT_TX_RING_DATA].u4DoneCnt
+		== u4DoneCnt + 1);
+	SELF_TEST_CHECK_OUT(prGlueInfo->u4TxCompleteCnt == 1);
+	SELF_TEST_CHECK_OUT(kalGetTxPendingFrameCount(prGlueInfo) == 0);
+
+	/* RX: a header translated frame of the AP to the OS, group 4 keeps
+	 * what is left of the 802.11 header
+	 */
+	u4HdrLen = u4RxdSize + sizeof(struct HW_MAC_RX_STS_GROUP_4);
+	u4Len = u4HdrLen + ETHER_HEADER_LEN + 200;
+	kalMemZero(aucRx, sizeof(aucRx));
+	prRxStatus = (struct HW_MAC_CONNAC3X_RX_DESC *) aucRx;
+	prRxStatus->u4DW0 =
+		((RX_PKT_TYPE_RX_DATA << CONNAC3X_RX_STATUS_PKT_TYPE_OFFSET) &
+		 CONNAC3X_RX_STATUS_PKT_TYPE_MASK) |
+		(u4Len & CONNAC3X_RX_STATUS_RX_BYTE_COUNT_MASK);
+	prRxStatus->u4DW1 = (prStaRec->ucWlanIndex &
+		CONNAC3X_RX_STATUS_MLD_ID_MASK) |
+		((BIT(RX_GROUP_VLD_4) << CONNAC3X_RX_STATUS_GROUP_VLD_OFFSET) &
+		 CONNAC3X_RX_STATUS_GROUP_VLD_MASK);
+	prRxStatus->u4DW2 = CONNAC3X_RX_STATUS_FLAG_HEADER_TRAN;
+	prGroup4 = (struct HW_MAC_RX_STS_GROUP_4 *) &aucRx[u4RxdSize];
+	prGroup4->u2FrameCtl = MAC_FRAME_DATA | MASK_FC_FROM_DS;
+	COPY_MAC_ADDR(prGroup4->aucTA, aucBssid);
+	COPY_MAC_ADDR(&aucRx[u4HdrLen], prBssInfo->aucOwnMacAddr);
+	COPY_MAC_ADDR(&aucRx[u4HdrLen + MAC_ADDR_LEN], aucBssid);
+	WLAN_SET_FIELD_BE16(&aucRx[u4HdrLen + 2 * MAC_ADDR_LEN], ETH_P_IPV4);
+	SELF_TEST_CHECK_OUT(kal_virt_inject_rx(prAdapter, VIRT_RX_RING_DATA,
+		aucRx, u4Len));
+	selfTestRunThreads(prAdapter);
+	SELF_TEST_CHECK_OUT(prGlueInfo->u4RxIndicateCnt == 1);
+	SELF_TEST_CHECK_OUT(prGlueInfo->u8RxIndicateBytes ==
+		ETHER_HEADER_LEN + 200);
+
+	/* Event: the AP goes to power save */
+	u4EvtCnt = prAdapter->rRxCtrl.arEventStat[
+		EVENT_ID_STA_CHANGE_PS_MODE].u4HitCnt;
+	kalMemZero(&rPsMode, sizeof(rPsMode));
+	rPsMode.ucStaRecIdx = prStaRec->ucIndex;
+	rPsMode.ucIsInPs = TRUE;
+	SELF_TEST_CHECK_OUT(kal_virt_fw_inject_event(prAdapter,
+		EVENT_ID_STA_CHANGE_PS_MODE, (uint8_t *) &rPsMode,
+		sizeof(rPsMode)));
+	selfTestRunThreads(prAdapter);
+	SELF_TEST_CHECK_OUT(prAdapter->rRxCtrl.arEventStat[
+		EVENT_ID_STA_CHANGE_PS_MODE].u4HitCnt == u4EvtCnt + 1);
+	SELF_TEST_CHECK_OUT(prStaRec->fgIsInPS);
+
+	fgPass = TRUE;
+out:
+	selfTestRemove(prAdapter);
+	return fgPass;
+}
+
+/* Number of stations on arStaRecOfBss[ucBss], -1 if one does not belong */
+static uint32_t selfTestStaOfBss(struct ADAPTER *prAdapter, uint8_t ucBss)
+{
+	struct STA_RECORD *prStaRec;
+	uint32_t u4Num = 0;
+
+	LINK_FOR_EACH_ENTRY(prStaRec, &prAdapter->arStaRecOfBss[ucBss],
+		rLinkEntryOfBss, struct STA_RECORD) {
+		if (!prStaRec->fgIsInUse || prStaRec->ucBssIndex != ucBss)
+			return (uint32_t) -1;
+		u4Num++;
+	}
+
+	return u4Num;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Associate as many stations as the STA record pool holds, split
+ *        over two BSSes, through the STA_REC commands of the virtual
+ *        device. cnmStaFreeAllStaByNetwork() on one BSS must leave the
+ *        stations of the other one alone, and the freed records must be
+ *        usable again.
+ *
+ * @return TRUE if the per-BSS lists and lookups stay right throughout
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestStaScale(void)
+{
+	struct STA_RECORD *aprStaRec[CFG_STA_REC_NUM];
+	uint8_t aucMac[MAC_ADDR_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+	struct STA_RECORD *prStaRec;
+	struct ADAPTER *prAdapter;
+	struct VIRT_FW *prFw;
+	uint32_t u4Num, u4CmdCnt, i;
+	u_int8_t fgPass = FALSE;
+
+	prAdapter = selfTestProbe();
+	SELF_TEST_CHECK(prAdapter != NULL);
+	prFw = &prAdapter->prGlueInfo->rHifInfo.rFw;
+	selfTestRunThreads(prAdapter);
+	u4Num = prAdapter->ucStaRecNum;
+	SELF_TEST_CHECK_OUT(u4Num > 1 && u4Num <= CFG_STA_REC_NUM);
+
+	/* odd stations on BSS 1, even ones on BSS 0 */
+	u4CmdCnt = prFw->u4CmdCnt;
+	for (i = 0; i < u4Num; i++) {
+		aucMac[5] = (uint8_t) i;
+		aprStaRec[i] = cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_CLIENT,
+					      (uint8_t) (i % 2), aucMac);
+		SELF_TEST_CHECK_OUT(aprStaRec[i] != NULL);
+		cnmStaRecChangeState(prAdapter, aprStaRec[i], STA_STATE_3);
+		selfTestRunThreads(prAdapter);
+	}
+	SELF_TEST_CHECK_OUT(prFw->u4CmdCnt >= u4CmdCnt + u4Num);
+	aucMac[5] = (uint8_t) u4Num;
+	SELF_TEST_CHECK_OUT(cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_CLIENT,
+		0, aucMac) == NULL);
+	SELF_TEST_CHECK_OUT(selfTestStaOfBss(prAdapter, 0) == (u4Num + 1) / 2);
+	SELF_TEST_CHECK_OUT(selfTestStaOfBss(prAdapter, 1) == u4Num / 2);
+
+	/* drop BSS 0, BSS 1 keeps its associations */
+	u4CmdCnt = prFw->u4CmdCnt;
+	cnmStaFreeAllStaByNetwork(prAdapter, 0, STA_REC_INDEX_NOT_FOUND);
+	selfTestRunThreads(prAdapter);
+	SELF_TEST_CHECK_OUT(prFw->u4CmdCnt > u4CmdCnt);
+	SELF_TEST_CHECK_OUT(selfTestStaOfBss(prAdapter, 0) == 0);
+	SELF_TEST_CHECK_OUT(selfTestStaOfBss(prAdapter, 1) == u4Num / 2);
+	for (i = 0; i < u4Num; i++) {
+		aucMac[5] = (uint8_t) i;
+		prStaRec = cnmGetStaRecByAddress(prAdapter, (uint8_t) (i % 2),
+						 aucMac);
+		if (i % 2) {
+			SELF_TEST_CHECK_OUT(prStaRec == aprStaRec[i]);
+			SELF_TEST_CHECK_OUT(prStaRec->ucStaState ==
+				STA_STATE_3);
+		} else {
+			SELF_TEST_CHECK_OUT(prStaRec == NULL);
+			SELF_TEST_CHECK_OUT(!aprStaRec[i]->fgIsInUse);
+		}
+	}
+
+	/* and BSS 0 fills up the freed records again */
+	for (i = 0; i < u4Num; i += 2) {
+		aucMac[5] = (uint8_t) (0x80 + i);
+		prStaRec = cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_CLIENT,
+					  0, aucMac);
+		SELF_TEST_CHECK_OUT(prStaRec != NULL);
+		cnmStaRecChangeState(prAdapter, prStaRec, STA_STATE_3);
+		selfTestRunThreads(prAdapter);
+	}
+	SELF_TEST_CHECK_OUT(cnmStaRecAlloc(prAdapter, STA_TYPE_LEGACY_CLIENT,
+		0, aucMac) == NULL);
+	SELF_TEST_CHECK_OUT(selfTestStaOfBss(prAdapter, 0) == (u4Num + 1) / 2);
+	SELF_TEST_CHECK_OUT(selfTestStaOfBss(prAdapter, 1) == u4Num / 2);
+
+	fgPass = TRUE;
+out:
+	selfTestRemove(prAdapter);
+	return fgPass;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief SW A-MSDU of the data ring: mixed TID traffic to two clients is
+ *        staged per STA/TID and written as A-MSDUs of at most
+ *        ucMaxMpduCount MSDUs, every MSDU completes and returns its
+ *        resource. With A-MSDU off each MSDU takes a descriptor.
+ *
+ * @return TRUE if the MSDUs are aggregated and all of them complete
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfTestAmsdu(void)
+{
+	const uint8_t aucTid[] = {0, 0, 5, 0, 6, 0, 1, 0};
+	const struct SELF_TEST_TX_FLOW rFlow = {
+		"mixed", 1000, aucTid, ARRAY_SIZE(aucTid), 2
+	};
+	struct STA_RECORD *aprStaRec[2];
+	struct GL_HIF_INFO *prHifInfo;
+	struct BSS_INFO *prBssInfo;
+	struct VIRT_RING *prRing;
+	struct ADAPTER *prAdapter;
+	uint32_t u4Num = 4 * SELF_TEST_TX_BATCH, u4DoneCnt, u4Complete, i;
+	u_int8_t fgPass = FALSE;
+
+	prAdapter = selfTestProbe();
+	SELF_TEST_CHECK(prAdapter != NULL);
+	prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	prRing = &prHifInfo->arTxRing[VIRT_TX_RING_DATA];
+	selfTestRunThreads(prAdapter);
+	prBssInfo = selfTestApStart(prAdapter, aprStaRec, 2);
+	SELF_TEST_CHECK_OUT(prBssInfo != NULL);
+	selfTestRunThreads(prAdapter);
+
+	/* off: one descriptor per MSDU */
+	u4DoneCnt = prRing->u4DoneCnt;
+	u4Complete = prAdapter->prGlueInfo->u4TxCompleteCnt;
+	SELF_TEST_CHECK_OUT(selfTestTxFlowRun(prAdapter, prBssInfo,
+		aprStaRec, &rFlow, u4Num) != 0);
+	SELF_TEST_CHECK_OUT(prRing->u4DoneCnt == u4DoneCnt + u4Num);
+	SELF_TEST_CHECK_OUT(prAdapter->prGlueInfo->u4TxCompleteCnt ==
+		u4Complete + u4Num);
+	SELF_TEST_CHECK_OUT(prHifInfo->u4AmsduCnt == 0);
+
+	/* on: 1000 byte MSDUs fill 4 to an A-MSDU, the BE bucket of each
+	 * client does every batch
+	 */
+	for (i = 0; i < ARRAY_SIZE(aprStaRec); i++)
+		selfTestSetAmsdu(prAdapter, aprStaRec[i], TRUE);
+	u4DoneCnt = prRing->u4DoneCnt;
+	u4Complete = prAdapter->prGlueInfo->u4TxCompleteCnt;
+	SELF_TEST_CHECK_OUT(selfTestTxFlowRun(prAdapter, prBssInfo,
+		aprStaRec, &rFlow, u4Num) != 0);
+	SELF_TEST_CHECK_OUT(prAdapter->prGlueInfo->u4TxCompleteCnt ==
+		u4Complete + u4Num);
+	SELF_TEST_CHECK_OUT(kalGetTxPendingFrameCount(prAdapter->prGlueInfo)
+		== 0);
+	SELF_TEST_CHECK_OUT(prHifInfo->u4AmsduStagedCnt == 0);
+	SELF_TEST_CHECK_OUT(prHifInfo->u4AmsduCnt > 0);
+	SELF_TEST_CHECK_OUT(prHifInfo->u4AmsduMsduCnt <=
+		prHifInfo->u4AmsduCnt * 4);
+	SELF_TEST_CHECK_OUT(prRing->u4DoneCnt - u4DoneCnt ==
+		u4Num - prHifInfo->u4AmsduMsduCnt + prHifInfo->u4AmsduCnt);
+	SELF_TEST_CHECK_OUT(prRing->u4DropCnt == 0);
+
+	fgPass = TRUE;
+out:
+	selfTestRemove(prAdapter);
+	return fgPass;
+}
+
+static const struct SELF_TEST arSelfTest[] = {
+	{"crc32", selfTestCrc32},
+	{"cfg_hash", selfTestCfgHash},
+	{"sta_rec_hash", selfTestStaRecHash},
+	{"bss_desc_hash", selfTestBssDescHash},
+	{"fwdl", selfTestFwDl},
+	{"timer_wheel", selfTestTimerWheel},
+#if QM_RX_REORDER_SLOT_INDEX
+	{"rx_reorder", selfTestRxReorder},
+#endif
+	{"token_pool", selfTestTokenPool},
+	{"tx_inbox", selfTestTxInbox},
+	{"adapter", selfTestAdapter},
+	{"sta_scale", selfTestStaScale},
+	{"amsdu", selfTestAmsdu},
+#if CFG_SUPPORT_CSI
+	{"csi_ring", selfTestCsiRing},
+#endif
+#if CFG_SUPPORT_CSI_NF
+	{"csi_nf", selfTestCsiNf},
+#endif
+};
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Run the self tests
+ *
+ * @param name           Test to run, NULL for all
+ *
+ * @return number of failed tests, 1 if no test matched the name
+ */
+/*----------------------------------------------------------------------------*/
+int glSelfTest(const char *name)
+{
+	uint32_t i, u4Run = 0, u4Fail = 0;
+
+	for (i = 0; i < ARRAY_SIZE(arSelfTest); i++) {
+		if (name && strcmp(name, arSelfTest[i].pucName) != 0)
+			continue;
+
+		u4Run++;
+		if (arSelfTest[i].pfnTest()) {
+			DBGLOG(INIT, INFO, "PASS %s\n", arSelfTest[i].pucName);
+		} else {
+			DBGLOG(INIT, ERROR, "FAIL %s\n", arSelfTest[i].pucName);
+			u4Fail++;
+		}
+	}
+
+	DBGLOG(INIT, INFO, "%u run, %u failed\n", u4Run, u4Fail);
+	if (u4Run == 0)
+		return 1;
+	return u4Fail;
+}
+
+#if CFG_SUPPORT_CFG_FILE
+#define SELF_BENCH_CFG_REP	200	/* runs per case, the best is kept */
+
+/* Keys wlanInitFeatureOption() looks up, in the order it reads them */
+static int8_t aucSelfBenchCfgKey[WLAN_CFG_REC_ENTRY_NUM_MAX]
+				[WLAN_CFG_KEY_LEN_MAX];
+
+/* The lookups of one wlanCfgGetUint32(): the config store, then the record
+ * store in wlanCfgRecordValue() and again in wlanCfgSet()
+ */
+static uintptr_t selfBenchCfgLookup(struct ADAPTER *prAdapter,
+				    uint32_t u4Keys, u_int8_t fgLinear)
+{
+	struct WLAN_CFG_ENTRY *prCfg = prAdapter->rWlanCfg.arWlanCfgBuf;
+	struct WLAN_CFG_ENTRY *prRec = prAdapter->rWlanCfgRec.arWlanCfgBuf;
+	uintptr_t u4Sum = 0;
+	uint32_t i;
+
+	for (i = 0; i < u4Keys; i++) {
+		if (fgLinear) {
+			u4Sum += (uintptr_t) selfTestCfgScanBuf(prCfg,
+				WLAN_CFG_ENTRY_NUM_MAX, aucSelfBenchCfgKey[i]);
+			u4Sum += 2 * (uintptr_t) selfTestCfgScanBuf(prRec,
+				WLAN_CFG_REC_ENTRY_NUM_MAX,
+				aucSelfBenchCfgKey[i]);
+		} else {
+			u4Sum += (uintptr_t) wlanCfgGetEntry(prAdapter,
+				aucSelfBenchCfgKey[i], FALSE);
+			u4Sum += 2 * (uintptr_t) wlanCfgGetEntry(prAdapter,
+				aucSelfBenchCfgKey[i], TRUE);
+		}
+	}
+
+	return u4Sum;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Config store cost at probe: wlanCfgInit() with a wifi.cfg and
+ *        wlanInitFeatureOption(), with the hash index and with the linear
+ *        scan it replaced.
+ *
+ *        A first wlanInitFeatureOption() with only the MAC address set
+ *        leaves every key it reads in the record store. The wifi.cfg then
+ *        also sets one in three of those keys to the value it read,
+ *        between comment lines, the way a shipped wifi.cfg overrides a
+ *        part of the options.
+ *        The lookups of the feature option keys are timed through both
+ *        indexes. Init with the linear scan is the measured hash init with
+ *        its lookups swapped for the linear ones, the rest of the work
+ *        being the same code.
+ *
+ * @return TRUE if it ran and both lookups found the same entries
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchCfg(void)
+{
+	const char *apucLookup[] = {"hash", "linear"};
+	struct WLAN_CFG_ENTRY *prRec;
+	struct ADAPTER *prAdapter;
+	uint64_t u8Start, u8Ns, u8Init = ~0ULL;
+	uint64_t au8Lookup[ARRAY_SIZE(apucLookup)];
+	uintptr_t au4Sum[ARRAY_SIZE(apucLookup)];
+	uint32_t i, j, r, u4Keys = 0, u4Entries = 0, u4Len = 0;
+	uint32_t u4BufSize = 64 * 1024;
+	u_int8_t fgPass = FALSE;
+	uint8_t *pucBuf;
+
+	prAdapter = selfTestAllocAdapter();
+	if (!prAdapter)
+		return FALSE;
+	pucBuf = malloc(u4BufSize);
+	if (!pucBuf)
+		goto out;
+
+	u4Len += kalSnprintf(pucBuf + u4Len, u4BufSize - u4Len,
+			     "# wifi.cfg\nMacAddr=00:0c:e7:66:32:e1\n");
+	wlanCfgInit(prAdapter, pucBuf, u4Len, 0);
+	wlanInitFeatureOption(prAdapter);
+	prRec = prAdapter->rWlanCfgRec.arWlanCfgBuf;
+	u4Entries = 1;
+
+	for (i = 0; i < WLAN_CFG_REC_ENTRY_NUM_MAX; i++) {
+		if (prRec[i].aucKey[0] == '\0')
+			continue;
+		kalStrnCpy(aucSelfBenchCfgKey[u4Keys], prRec[i].aucKey,
+			   WLAN_CFG_KEY_LEN_MAX - 1);
+		if (u4Keys % 3 == 0) {
+			u4Len += kalSnprintf(pucBuf + u4Len,
+				u4BufSize - u4Len, "%s%s=%s\n",
+				(u4Keys % 30 == 0) ? "\n# Options\n" : "",
+				prRec[i].aucKey, prRec[i].aucValue);
+			u4Entries++;
+		}
+		u4Keys++;
+	}
+
+	for (r = 0; r < SELF_BENCH_CFG_REP; r++) {
+		u8Start = kal_sched_clock();
+		wlanCfgInit(prAdapter, pucBuf, u4Len, 0);
+		wlanInitFeatureOption(prAdapter);
+		u8Ns = kal_sched_clock() - u8Start;
+		if (u8Ns < u8Init)
+			u8Init = u8Ns;
+	}
+
+	for (j = 0; j < ARRAY_SIZE(apucLookup); j++)
+		au8Lookup[j] = ~0ULL;
+	for (r = 0; r < SELF_BENCH_CFG_REP; r++) {
+		for (j = 0; j < ARRAY_SIZE(apucLookup); j++) {
+			u8Start = kal_sched_clock();
+			au4Sum[j] = selfBenchCfgLookup(prAdapter, u4Keys, j);
+			u8Ns = kal_sched_clock() - u8Start;
+			if (u8Ns < au8Lookup[j])
+				au8Lookup[j] = u8Ns;
+		}
+		if (au4Sum[0] != au4Sum[1]) {
+			DBGLOG(INIT, ERROR, "cfg: hash and linear differ\n");
+			goto out;
+		}
+	}
+
+	for (j = 0; j < ARRAY_SIZE(apucLookup); j++) {
+		printf("{\"bench\":\"cfg\",\"stage\":\"lookup\","
+		       "\"lookup\":\"%s\",\"keys\":%u,"
+		       "\"ns_per_key\":%.1f,\"us_per_pass\":%.1f}\n",
+		       apucLookup[j], u4Keys,
+		       (double) au8Lookup[j] / u4Keys,
+		       (double) au8Lookup[j] / NSEC_PER_USEC);
+	}
+	for (j = 0; j < ARRAY_SIZE(apucLookup); j++) {
+		u8Ns = u8Init - au8Lookup[0] + au8Lookup[j];
+		printf("{\"bench\":\"cfg\",\"stage\":\"init\","
+		       "\"lookup\":\"%s\",\"cfg_bytes\":%u,"
+		       "\"cfg_entries\":%u,\"us\":%.1f}\n",
+		       apucLookup[j], u4Len, u4Entries,
+		       (double) u8Ns / NSEC_PER_USEC);
+	}
+
+	fgPass = TRUE;
+out:
+	free(pucBuf);
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief CRC-32 throughput of the byte table wlanCRC32() used to have
+ *        against kalCRC32(), over buffers from a frame to a firmware
+ *        region. Both must give the same CRC.
+ *
+ * @return TRUE if it ran and both agree
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchCrc32(void)
+{
+	const char *apucImpl[] = {"table", "kal"};
+	const uint32_t au4Len[] = {64, 1500, 4096, 65536, 1048576};
+	uint32_t u4Total = 64 * 1024 * 1024, u4Calls;
+	uint32_t au4Crc[ARRAY_SIZE(apucImpl)];
+	uint64_t u8Start, u8Ns;
+	u_int8_t fgPass = TRUE;
+	uint8_t *pucBuf;
+	uint32_t i, j, k;
+
+	pucBuf = malloc(au4Len[ARRAY_SIZE(au4Len) - 1]);
+	if (!pucBuf)
+		return FALSE;
+	for (i = 0; i < au4Len[ARRAY_SIZE(au4Len) - 1]; i++)
+		pucBuf[i] = (uint8_t)(i * 7 + 3);
+
+	for (i = 0; i < ARRAY_SIZE(au4Len); i++) {
+		u4Calls = u4Total / au4Len[i];
+		for (j = 0; j < ARRAY_SIZE(apucImpl); j++) {
+			au4Crc[j] = 0;
+			u8Start = kal_sched_clock();
+			for (k = 0; k < u4Calls; k++) {
+				if (j == 0)
+					au4Crc[j] ^= selfTestCrc32Ref(pucBuf,
+								au4Len[i]);
+				else
+					au4Crc[j] ^= kalCRC32(pucBuf,
+							      au4Len[i]);
+			}
+			u8Ns = kal_sched_clock() - u8Start;
+
+			printf("{\"bench\":\"crc32\",\"impl\":\"%s\","
+			       "\"len\":%u,\"calls\":%u,\"ns_per_call\":%.1f,"
+			       "\"mb_per_s\":%.1f}\n",
+			       apucImpl[j], au4Len[i], u4Calls,
+			       (double) u8Ns / u4Calls,
+			       u8Ns ? (double) u4Calls * au4Len[i] * 1000 / u8Ns
+				    : 0);
+		}
+		if (au4Crc[0] != au4Crc[1]) {
+			DBGLOG(INIT, ERROR, "crc32: table %08x kal %08x\n",
+			       au4Crc[0], au4Crc[1]);
+			fgPass = FALSE;
+		}
+	}
+
+	free(pucBuf);
+	return fgPass;
+}
+
+#define SELF_BENCH_SCAN_NUM	20	/* scans per case */
+
+/* scanSearchBssDescByBssidAndSsid() as it was before the BSSID index */
+static struct BSS_DESC *selfBenchBssDescLinear(struct ADAPTER *prAdapter,
+					       uint8_t aucBSSID[],
+					       struct PARAM_SSID *prSsid)
+{
+	struct LINK *prBSSDescList =
+		&prAdapter->rWifiVar.rScanInfo.rBSSDescList;
+	struct BSS_DESC *prBssDesc, *prDstBssDesc = NULL;
+
+	LINK_FOR_EACH_ENTRY(prBssDesc, prBSSDescList, rLinkEntry,
+			    struct BSS_DESC) {
+		if (!EQUAL_MAC_ADDR(prBssDesc->aucBSSID, aucBSSID))
+			continue;
+		if (EQUAL_SSID(prBssDesc->aucSSID, prBssDesc->ucSSIDLen,
+			       prSsid->aucSsid, prSsid->u4SsidLen))
+			return prBssDesc;
+		if (prDstBssDesc == NULL && prBssDesc->fgIsHiddenSSID)
+			prDstBssDesc = prBssDesc;
+	}
+
+	return prDstBssDesc;
+}
+
+/* One BSS of the synthetic site */
+struct SELF_BENCH_BSS {
+	uint8_t aucBssid[MAC_ADDR_LEN];
+	struct PARAM_SSID rSsid;
+	enum ENUM_BAND eBand;
+	uint8_t ucChannel;
+};
+
+/* A dense site: random BSSIDs, four BSSIDs per ESS, 2.4G on channels 1,
+ * 6 and 11, 5G spread over 36 to 161
+ */
+static void selfBenchBssDescSite(struct SELF_BENCH_BSS *prBss, uint32_t u4Num)
+{
+	const uint8_t aucChnl5G[] = {
+		36, 40, 44, 48, 52, 56, 60, 64, 100, 104, 108, 112,
+		116, 120, 124, 128, 132, 136, 140, 149, 153, 157, 161
+	};
+	uint32_t i, u4Seed = 7;
+
+	for (i = 0; i < u4Num; i++, prBss++) {
+		u4Seed = u4Seed * 1103515245 + 12345;
+		prBss->aucBssid[0] = 0x02;
+		prBss->aucBssid[1] = 0x0c;
+		prBss->aucBssid[2] = 0x43;
+		prBss->aucBssid[3] = (uint8_t)(u4Seed >> 24);
+		prBss->aucBssid[4] = (uint8_t)(u4Seed >> 16);
+		prBss->aucBssid[5] = (uint8_t)i;
+		prBss->rSsid.u4SsidLen = kalSnprintf(
+			(char *) prBss->rSsid.aucSsid,
+			sizeof(prBss->rSsid.aucSsid), "dense-%u", i / 4);
+		if (u4Seed & BIT(8)) {
+			prBss->eBand = BAND_5G;
+			prBss->ucChannel =
+				aucChnl5G[(u4Seed >> 9) % sizeof(aucChnl5G)];
+		} else {
+			prBss->eBand = BAND_2G4;
+			prBss->ucChannel =
+				(uint8_t)(1 + 5 * ((u4Seed >> 9) % 3));
+		}
+	}
+}
+
+/* One beacon of prBss: look up its descriptor the way scanAddToBssDesc()
+ * does and add it if it is new
+ */
+static struct BSS_DESC *selfBenchBssDescRx(struct ADAPTER *prAdapter,
+					   struct SELF_BENCH_BSS *prBss,
+					   u_int8_t fgIndex)
+{
+	struct BSS_DESC *prBssDesc;
+
+	if (fgIndex)
+		prBssDesc = scanSearchBssDescByBssidAndSsid(prAdapter,
+			prBss->aucBssid, TRUE, &prBss->rSsid);
+	else
+		prBssDesc = selfBenchBssDescLinear(prAdapter, prBss->aucBssid,
+						   &prBss->rSsid);
+	if (prBssDesc)
+		return prBssDesc;
+
+	prBssDesc = scanAllocateBssDesc(prAdapter);
+	if (!prBssDesc)
+		return NULL;
+	COPY_MAC_ADDR(prBssDesc->aucBSSID, prBss->aucBssid);
+	COPY_SSID(prBssDesc->aucSSID, prBssDesc->ucSSIDLen,
+		  prBss->rSsid.aucSsid, prBss->rSsid.u4SsidLen);
+	prBssDesc->eBSSType = BSS_TYPE_INFRASTRUCTURE;
+	prBssDesc->eBand = prBss->eBand;
+	prBssDesc->ucChannelNum = prBss->ucChannel;
+	scanUpdateBssDescIndex(prAdapter, prBssDesc);
+
+	return prBssDesc;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Dense scan: the scan result lookup of each beacon and probe
+ *        response through the old linear walk and through the BSSID
+ *        index, with 50 to CFG_MAX_NUM_BSS_LIST BSSes in range. The
+ *        first scan fills an empty result, the following ones update it.
+ *        Every scan sees each BSS twice, in a random order.
+ *
+ * @return TRUE if it ran and every beacon found or added its BSS
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchDenseScan(void)
+{
+	const char *apucLookup[] = {"linear", "index"};
+	const uint32_t au4BssNum[] = {50, 150, CFG_MAX_NUM_BSS_LIST};
+	static struct SELF_BENCH_BSS arBss[CFG_MAX_NUM_BSS_LIST];
+	uint32_t au4Order[2 * CFG_MAX_NUM_BSS_LIST];
+	uint32_t u4Seed, u4Rx, u4Tmp, i, j, k, n;
+	uint64_t u8Start, u8Fill, u8Update;
+	struct ADAPTER *prAdapter;
+	u_int8_t fgIndex;
+
+	selfBenchBssDescSite(arBss, CFG_MAX_NUM_BSS_LIST);
+	for (i = 0; i < ARRAY_SIZE(au4BssNum); i++) {
+		n = au4BssNum[i];
+		for (fgIndex = 0; fgIndex <= 1; fgIndex++) {
+			prAdapter = selfTestScanAdapter();
+			if (!prAdapter)
+				return FALSE;
+			u4Seed = 1;
+			u8Fill = 0;
+			u8Update = 0;
+			for (j = 0; j < SELF_BENCH_SCAN_NUM; j++) {
+				u4Rx = 0;
+				for (k = 0; k < 2 * n; k++)
+					au4Order[k] = k % n;
+				for (k = 2 * n - 1; k > 0; k--) {
+					u4Seed = u4Seed * 1103515245 + 12345;
+					u4Tmp = au4Order[k];
+					au4Order[k] = au4Order[(u4Seed >> 8) %
+							       (k + 1)];
+					au4Order[(u4Seed >> 8) % (k + 1)] =
+						u4Tmp;
+				}
+
+				u8Start = kal_sched_clock();
+				for (k = 0; k < 2 * n; k++)
+					u4Rx += selfBenchBssDescRx(prAdapter,
+						&arBss[au4Order[k]], fgIndex)
+						!= NULL;
+				if (j == 0)
+					u8Fill = kal_sched_clock() - u8Start;
+				else
+					u8Update += kal_sched_clock() - u8Start;
+
+				if (u4Rx != 2 * n ||
+				    prAdapter->rWifiVar.rScanInfo.
+				    rBSSDescList.u4NumElem != n) {
+					DBGLOG(INIT, ERROR,
+					       "dense_scan: %u BSS, %u found\n",
+					       n, u4Rx);
+					selfTestFreeAdapter(prAdapter);
+					return FALSE;
+				}
+			}
+			selfTestFreeAdapter(prAdapter);
+
+			printf("{\"bench\":\"dense_scan\",\"lookup\":\"%s\","
+			       "\"bss\":%u,\"scans\":%u,"
+			       "\"fill_ns_per_beacon\":%.1f,"
+			       "\"update_ns_per_beacon\":%.1f,"
+			       "\"update_us_per_scan\":%.1f}\n",
+			       apucLookup[fgIndex], n, SELF_BENCH_SCAN_NUM,
+			       (double) u8Fill / (2 * n),
+			       (double) u8Update /
+			       (2 * n * (SELF_BENCH_SCAN_NUM - 1)),
+			       (double) u8Update / 1000 /
+			       (SELF_BENCH_SCAN_NUM - 1));
+		}
+	}
+
+	return TRUE;
+}
+
+/* wlanDownloadSection() as it was before wlanImageSectionDownloadBurst(),
+ * one CMD_INFO allocated, filled and freed per chunk
+ */
+static uint32_t selfBenchFwDlChunk(struct ADAPTER *prAdapter,
+				   uint32_t u4Addr, uint32_t u4Len,
+				   uint8_t *pucStartPtr)
+{
+	uint32_t u4ImgSecSize, u4Offset;
+
+	if (wlanImageSectionConfig(prAdapter, u4Addr, u4Len, 0,
+				   IMG_DL_IDX_N9_FW) != WLAN_STATUS_SUCCESS)
+		return WLAN_STATUS_FAILURE;
+
+	for (u4Offset = 0; u4Offset < u4Len;
+	     u4Offset += CMD_PKT_SIZE_FOR_IMAGE) {
+		if (u4Offset + CMD_PKT_SIZE_FOR_IMAGE < u4Len)
+			u4ImgSecSize = CMD_PKT_SIZE_FOR_IMAGE;
+		else
+			u4ImgSecSize = u4Len - u4Offset;
+
+		if (wlanImageSectionDownload(prAdapter, u4ImgSecSize,
+					     pucStartPtr + u4Offset) !=
+					     WLAN_STATUS_SUCCESS)
+			return WLAN_STATUS_FAILURE;
+	}
+
+	return WLAN_STATUS_SUCCESS;
+}
+
+#define SELF_BENCH_FWDL_REP	5	/* interleaved runs, the best is kept */
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief FW section download through the virtual HIF, the old per-chunk
+ *        wlanImageSectionDownload() loop against
+ *        wlanImageSectionDownloadBurst(), for sections of a few chunks up
+ *        to 1 MB. Both include the section config command and its ack.
+ *        The two paths alternate and the fastest of SELF_BENCH_FWDL_REP
+ *        runs is reported, so host noise hits both alike.
+ *
+ * @return TRUE if it ran and the virtual firmware got every section intact
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchFwDl(void)
+{
+	const char *apucPath[] = {"chunk", "burst"};
+	const uint32_t au4Len[] = {8 * 1024 + 123, 64 * 1024, 1024 * 1024};
+	uint32_t u4Total = 64 * 1024 * 1024, u4Sections, u4Chunks;
+	uint64_t au8Best[ARRAY_SIZE(apucPath)];
+	struct ADAPTER *prAdapter;
+	struct VIRT_FW *prFw;
+	uint64_t u8Start, u8Ns;
+	uint8_t *pucImage;
+	u_int8_t fgPass = FALSE;
+	uint32_t i, j, k, r, u4Status;
+
+	prAdapter = selfTestFwDlAdapter();
+	if (!prAdapter)
+		return FALSE;
+	prFw = &prAdapter->prGlueInfo->rHifInfo.rFw;
+
+	pucImage = malloc(au4Len[ARRAY_SIZE(au4Len) - 1]);
+	if (!pucImage)
+		goto out;
+	selfTestFwDlImage(pucImage, au4Len[ARRAY_SIZE(au4Len) - 1]);
+
+	for (i = 0; i < ARRAY_SIZE(au4Len); i++) {
+		u4Sections = u4Total / au4Len[i];
+		u4Chunks = u4Sections * ((au4Len[i] + CMD_PKT_SIZE_FOR_IMAGE -
+			1) / CMD_PKT_SIZE_FOR_IMAGE);
+		for (j = 0; j < ARRAY_SIZE(apucPath); j++)
+			au8Best[j] = ~0ULL;
+
+		for (r = 0; r < SELF_BENCH_FWDL_REP; r++) {
+			for (j = 0; j < ARRAY_SIZE(apucPath); j++) {
+				u4Status = WLAN_STATUS_SUCCESS;
+				u8Start = kal_sched_clock();
+				for (k = 0; k < u4Sections &&
+				     u4Status == WLAN_STATUS_SUCCESS; k++) {
+					if (j == 0)
+						u4Status = selfBenchFwDlChunk(
+							prAdapter, 0x900000,
+							au4Len[i], pucImage);
+					else
+						u4Status = wlanDownloadSection(
+							prAdapter, 0x900000,
+							au4Len[i], 0, pucImage,
+							IMG_DL_IDX_N9_FW);
+				}
+				u8Ns = kal_sched_clock() - u8Start;
+
+				if (u4Status != WLAN_STATUS_SUCCESS ||
+				    prFw->u4DlCrc !=
+				    kalCRC32(pucImage, au4Len[i])) {
+					DBGLOG(INIT, ERROR,
+					       "fwdl: %s len %u failed at section %u\n",
+					       apucPath[j], au4Len[i], k);
+					goto out;
+				}
+				if (u8Ns < au8Best[j])
+					au8Best[j] = u8Ns;
+			}
+		}
+
+		for (j = 0; j < ARRAY_SIZE(apucPath); j++) {
+			u8Ns = au8Best[j];
+			printf("{\"bench\":\"fwdl\",\"path\":\"%s\","
+			       "\"len\":%u,\"sections\":%u,"
+			       "\"ns_per_chunk\":%.1f,\"mb_per_s\":%.1f}\n",
+			       apucPath[j], au4Len[i], u4Sections,
+			       (double) u8Ns / u4Chunks,
+			       u8Ns ? (double) u4Sections * au4Len[i] * 1000 /
+				      u8Ns : 0);
+		}
+	}
+
+	fgPass = TRUE;
+out:
+	free(pucImage);
+	selfTestFwDlFreeAdapter(prAdapter);
+	return fgPass;
+}
+
+#if QM_RX_REORDER_SLOT_INDEX
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief RX reorder cost per packet, list walk against the slot index.
+ *        Blocks of half a window arrive shuffled, so the queue holds up
+ *        to half a window of packets.
+ *
+ * @return TRUE if it ran
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchRxReorder(void)
+{
+	uint16_t au2Win[] = {64, 256, 1024};
+	const char *apucEngine[] = {"linear", "indexed"};
+	uint32_t u4Num = 200000, u4PoolNum = MAX_SEQ_NO_COUNT;
+	struct ADAPTER *prAdapter;
+	struct RX_BA_ENTRY *prEntry;
+	struct SW_RFB *prPool = NULL;
+	uint16_t *pu2SN = NULL;
+	uint64_t u8Start, u8Ns;
+	u_int8_t fgPass = FALSE;
+	uint32_t i, j;
+
+	prAdapter = selfTestReorderAllocAdapter();
+	if (!prAdapter)
+		return FALSE;
+	prPool = calloc(u4PoolNum, sizeof(struct SW_RFB));
+	pu2SN = calloc(u4Num, sizeof(uint16_t));
+	if (!prPool || !pu2SN)
+		goto out;
+	/* fault the pool in before timing */
+	kalMemZero(prPool, u4PoolNum * sizeof(struct SW_RFB));
+
+	for (i = 0; i < ARRAY_SIZE(au2Win); i++) {
+		selfTestReorderStream(pu2SN, u4Num, 0, au2Win[i] / 2, 0,
+			FALSE);
+		for (j = 0; j < ARRAY_SIZE(apucEngine); j++) {
+			if (!qmAddRxBaEntry(prAdapter, 0, 0, 0,
+				au2Win[i] - CFG_RX_BA_INC_SIZE))
+				goto out;
+			prEntry = prAdapter->arStaRec[0].
+				aprRxReorderParamRefTbl[0];
+			if (j == 0)
+				qmRxReorderSlotFree(prAdapter, prEntry);
+
+			u8Start = kal_sched_clock();
+			selfTestReorderRun(prAdapter, prEntry, prPool,
+				u4PoolNum, pu2SN, u4Num, NULL);
+			u8Ns = kal_sched_clock() - u8Start;
+
+			printf("{\"bench\":\"rx_reorder\",\"win\":%u,"
+			       "\"engine\":\"%s\",\"pkts\":%u,"
+			       "\"ns_per_pkt\":%.1f}\n",
+			       au2Win[i], apucEngine[j], u4Num,
+			       (double) u8Ns / u4Num);
+
+			qmDelRxBaEntry(prAdapter, 0, 0, FALSE);
+			QUEUE_INITIALIZE(
+				&prAdapter->rRxCtrl.rIndicatedRfbList);
+		}
+	}
+
+	fgPass = TRUE;
+out:
+	free(pu2SN);
+	free(prPool);
+	cnmTimerDestroy(prAdapter);
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+#endif /* QM_RX_REORDER_SLOT_INDEX */
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Token pool get/put cost with 1 to 8 threads, with the per-CPU
+ *        caches and with the global stack only. Each thread holds up to
+ *        8 tokens at a time, like a TX burst waiting for completion.
+ *
+ * @return TRUE if it ran
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchTokenPool(void)
+{
+	struct SELF_TEST_TOKEN arToken[SELF_TEST_TOKEN_NUM];
+	struct SELF_TEST_TOKEN_THREAD arThread[KAL_VIRT_CPU_NUM];
+	struct TOKEN_POOL rPool;
+	uint32_t au4ThreadNum[] = {1, 2, 4, 8};
+	uint32_t u4Loop = 200000, u4Get;
+	uint64_t u8Start, u8Ns;
+	u_int8_t fgCache;
+	uint32_t i, j, k;
+
+	kalMemZero(arToken, sizeof(arToken));
+	for (fgCache = 0; fgCache <= 1; fgCache++) {
+		for (i = 0; i < ARRAY_SIZE(au4ThreadNum); i++) {
+			kalMemZero(&rPool, sizeof(rPool));
+			if (!tokenPoolInit(&rPool, SELF_TEST_TOKEN_NUM,
+					   fgCache))
+				return FALSE;
+			for (j = 0; j < SELF_TEST_TOKEN_NUM; j++)
+				tokenPoolAdd(&rPool, &arToken[j]);
+
+			u8Start = kal_sched_clock();
+			if (!selfTestTokenRun(&rPool, arThread,
+					      au4ThreadNum[i], u4Loop, 8)) {
+				tokenPoolUninit(&rPool);
+				return FALSE;
+			}
+			u8Ns = kal_sched_clock() - u8Start;
+
+			u4Get = 0;
+			for (k = 0; k < au4ThreadNum[i]; k++)
+				u4Get += arThread[k].u4Get;
+			printf("{\"bench\":\"token_pool\",\"cache\":%s,"
+			       "\"threads\":%u,\"cpus\":%ld,"
+			       "\"get_put\":%u,\"ns_per_get_put\":%.1f}\n",
+			       fgCache ? "true" : "false", au4ThreadNum[i],
+			       sysconf(_SC_NPROCESSORS_ONLN), u4Get,
+			       (double) u8Ns / u4Get);
+			tokenPoolUninit(&rPool);
+		}
+	}
+
+	return TRUE;
+}
+
+#if CFG_RXD_STATIC_BIND
+#define SELF_BENCH_RXD_NUM	256
+#define SELF_BENCH_RXD_BUF	512
+
+/* One RX buffer of the RXD bench, the RXD and its groups come first */
+struct SELF_BENCH_RXD {
+	uint8_t aucBuf[SELF_BENCH_RXD_BUF];
+};
+
+/* Fill RXDs the way a data-heavy RX ring sees them: mostly data frames
+ * from a handful of WLAN indexes, with varying groups, header
+ * translation and TIDs, and now and then an MSDU report or an event.
+ */
+static void selfBenchRxdFill(struct SELF_BENCH_RXD *prRxd, uint32_t u4Num)
+{
+	struct HW_MAC_CONNAC3X_RX_DESC *prRxStatus;
+	uint32_t u4Seed = 0x5eed, u4PktType, i;
+
+	for (i = 0; i < u4Num; i++) {
+		u4Seed = u4Seed * 1103515245 + 12345;
+		if ((u4Seed >> 16) % 16 == 0)
+			u4PktType = RX_PKT_TYPE_MSDU_REPORT;
+		else if ((u4Seed >> 16) % 16 == 1)
+			u4PktType = RX_PKT_TYPE_SW_DEFINED;
+		else
+			u4PktType = RX_PKT_TYPE_RX_DATA;
+
+		kalMemZero(&prRxd[i], sizeof(prRxd[i]));
+		prRxStatus = (struct HW_MAC_CONNAC3X_RX_DESC *)prRxd[i].aucBuf;
+		prRxStatus->u4DW0 =
+			((u4PktType << CONNAC3X_RX_STATUS_PKT_TYPE_OFFSET) &
+			 CONNAC3X_RX_STATUS_PKT_TYPE_MASK) |
+			(SELF_BENCH_RXD_BUF & CONNAC3X_RX_STATUS_RX_BYTE_COUNT_MASK);
+		prRxStatus->u4DW1 =
+			((i % 8) & CONNAC3X_RX_STATUS_MLD_ID_MASK) |
+			((((u4Seed >> 8) & (BIT(RX_GROUP_VLD_1) |
+			    BIT(RX_GROUP_VLD_2) | BIT(RX_GROUP_VLD_3) |
+			    BIT(RX_GROUP_VLD_4))) <<
+			  CONNAC3X_RX_STATUS_GROUP_VLD_OFFSET) &
+			 CONNAC3X_RX_STATUS_GROUP_VLD_MASK);
+		prRxStatus->u4DW2 =
+			((u4Seed & BIT(4)) ? CONNAC3X_RX_STATUS_FLAG_HEADER_TRAN
+			 : 0) |
+			((12 << CONNAC3X_RX_STATUS_HEADER_LEN_OFFSET) &
+			 CONNAC3X_RX_STATUS_HEADER_LEN_MASK);
+		prRxStatus->u4DW3 =
+			((((u4Seed >> 20) & 1) ? 36 : 6) <<
+			 CONNAC3X_RX_STATUS_CH_FREQ_OFFSET) &
+			CONNAC3X_RX_STATUS_CH_FREQ_MASK;
+		prRxStatus->u4DW4 = ((u4Seed >> 24) <<
+			CONNAC3X_RX_STATUS_TID_OFFSET) &
+			CONNAC3X_RX_STATUS_TID_MASK;
+	}
+}
+
+/* Parse one RXD through the RX_DESC_OPS_T table, NULL checks included,
+ * the way RX_STATUS_GET did it before CFG_RXD_STATIC_BIND
+ */
+static uint32_t selfBenchRxdOps(struct ADAPTER *prAdapter,
+				struct RX_DESC_OPS_T *prOps,
+				struct SW_RFB *prSwRfb, u_int8_t fgFill)
+{
+	void *prRxStatus = prSwRfb->prRxStatus;
+	uint32_t u4Sum = 0;
+
+	if (prOps->nic_rxd_get_pkt_type)
+		prSwRfb->ucPacketType = prOps->nic_rxd_get_pkt_type(prRxStatus);
+	if (prSwRfb->ucPacketType == RX_PKT_TYPE_MSDU_REPORT)
+		return 0;
+	if (prOps->nic_rxd_get_wlan_idx)
+		u4Sum += prOps->nic_rxd_get_wlan_idx(prRxStatus);
+	if (fgFill && prOps->nic_rxd_fill_rfb)
+		prOps->nic_rxd_fill_rfb(prAdapter, prSwRfb);
+	if (prOps->nic_rxd_get_rx_byte_count)
+		u4Sum += prOps->nic_rxd_get_rx_byte_count(prRxStatus);
+	if (prOps->nic_rxd_get_sec_mode)
+		u4Sum += prOps->nic_rxd_get_sec_mode(prRxStatus);
+	if (prOps->nic_rxd_get_ofld)
+		u4Sum += prOps->nic_rxd_get_ofld(prRxStatus);
+	if (prOps->nic_rxd_get_HdrTrans)
+		u4Sum += prOps->nic_rxd_get_HdrTrans(prRxStatus);
+	if (prOps->nic_rxd_get_ch_num)
+		u4Sum += prOps->nic_rxd_get_ch_num(prRxStatus);
+	if (prOps->nic_rxd_get_rf_band)
+		u4Sum += prOps->nic_rxd_get_rf_band(prRxStatus);
+	if (prOps->nic_rxd_get_tcl)
+		u4Sum += prOps->nic_rxd_get_tcl(prRxStatus);
+
+	return u4Sum;
+}
+
+/* The same fields through the compile time bindings */
+static uint32_t selfBenchRxdStatic(struct ADAPTER *prAdapter,
+				   struct RX_DESC_OPS_T *prRxDescOps,
+				   struct SW_RFB *prSwRfb, u_int8_t fgFill)
+{
+	void *prRxStatus = prSwRfb->prRxStatus;
+	uint32_t u4Sum = 0;
+
+	prSwRfb->ucPacketType =
+		RX_DESC_OPS_FN(prRxDescOps, get_pkt_type)(prRxStatus);
+	if (prSwRfb->ucPacketType == RX_PKT_TYPE_MSDU_REPORT)
+		return 0;
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_wlan_idx)(prRxStatus);
+	if (fgFill)
+		RX_DESC_OPS_FN(prRxDescOps, fill_rfb)(prAdapter, prSwRfb);
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_rx_byte_count)(prRxStatus);
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_sec_mode)(prRxStatus);
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_ofld)(prRxStatus);
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_HdrTrans)(prRxStatus);
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_ch_num)(prRxStatus);
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_rf_band)(prRxStatus);
+	u4Sum += RX_DESC_OPS_FN(prRxDescOps, get_tcl)(prRxStatus);
+
+	return u4Sum;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief RXD parsing cost per packet through the RX_DESC_OPS_T table and
+ *        through the compile time bindings, over synthetic CONNAC3X
+ *        RXDs. Each packet reads the fields the RX path reads (packet
+ *        type and WLAN index in the HIF, the rest in nicRxProcessPacket),
+ *        with and without fill_rfb. Both bindings must read the same
+ *        values.
+ *
+ * @return TRUE if it ran and both bindings agree
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchRxdParse(void)
+{
+	const char *apucBind[] = {"ops", "static"};
+	uint32_t u4Num = 2000000;
+	struct RX_DESC_OPS_T rOps;
+	struct RX_DESC_OPS_T *volatile prOpsHidden = &rOps;
+	struct SELF_BENCH_RXD *prRxd;
+	struct ADAPTER *prAdapter;
+	struct SW_RFB rSwRfb;
+	uint64_t u8Start, u8Ns;
+	uint32_t au4Sum[ARRAY_SIZE(apucBind)];
+	u_int8_t fgFill, fgPass = TRUE;
+	uint32_t i, j;
+
+	prAdapter = selfTestAllocAdapter();
+	if (!prAdapter)
+		return FALSE;
+	prRxd = calloc(SELF_BENCH_RXD_NUM, sizeof(struct SELF_BENCH_RXD));
+	if (!prRxd) {
+		selfTestFreeAdapter(prAdapter);
+		return FALSE;
+	}
+	selfBenchRxdFill(prRxd, SELF_BENCH_RXD_NUM);
+
+	/* the table as a CONNAC3X chip fills it, read back through a
+	 * volatile pointer so the calls stay indirect
+	 */
+	kalMemZero(&rOps, sizeof(rOps));
+	asicConnac3xInitRxdHook(&rOps);
+	kalMemZero(&rSwRfb, sizeof(rSwRfb));
+
+	for (fgFill = 0; fgFill <= 1; fgFill++) {
+		for (j = 0; j < ARRAY_SIZE(apucBind); j++) {
+			au4Sum[j] = 0;
+			u8Start = kal_sched_clock();
+			for (i = 0; i < u4Num; i++) {
+				rSwRfb.prRxStatus = (void *)
+					prRxd[i % SELF_BENCH_RXD_NUM].aucBuf;
+				if (j == 0)
+					au4Sum[j] += selfBenchRxdOps(prAdapter,
+						prOpsHidden, &rSwRfb, fgFill);
+				else
+					au4Sum[j] += selfBenchRxdStatic(
+						prAdapter,
+						prAdapter->chip_info->
+						prRxDescOps, &rSwRfb, fgFill);
+			}
+			u8Ns = kal_sched_clock() - u8Start;
+
+			printf("{\"bench\":\"rxd_parse\",\"bind\":\"%s\","
+			       "\"fill_rfb\":%s,\"pkts\":%u,"
+			       "\"ns_per_pkt\":%.2f,\"mpps\":%.1f}\n",
+			       apucBind[j], fgFill ? "true" : "false", u4Num,
+			       (double) u8Ns / u4Num,
+			       u8Ns ? (double) u4Num * 1000 / u8Ns : 0);
+		}
+		if (au4Sum[0] != au4Sum[1]) {
+			DBGLOG(INIT, ERROR, "rxd_parse: ops %u static %u\n",
+			       au4Sum[0], au4Sum[1]);
+			fgPass = FALSE;
+		}
+	}
+
+	free(prRxd);
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+#endif /* CFG_RXD_STATIC_BIND */
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief SW A-MSDU of the data ring under mixed TID traffic to 4 clients,
+ *        off and on: MSDUs per data ring descriptor, MSDUs per A-MSDU and
+ *        the driver time per MSDU from kalHardStartXmit() to TX done.
+ *        Every STA/TID bucket is flushed at the end of each
+ *        SELF_TEST_TX_BATCH frames, so the more STA/TID pairs share a
+ *        batch the shorter the A-MSDUs.
+ *
+ * @return TRUE if it ran
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchAmsdu(void)
+{
+	const uint8_t aucTidBe[] = {0};
+	const uint8_t aucTidMixed[] = {0, 0, 5, 0, 6, 0, 1, 0};
+	const uint8_t aucTidAll[] = {0, 1, 2, 3, 4, 5, 6, 7};
+	const struct SELF_TEST_TX_FLOW arFlow[] = {
+		{"be", 1500, aucTidBe, ARRAY_SIZE(aucTidBe), 4},
+		{"mixed", 1500, aucTidMixed, ARRAY_SIZE(aucTidMixed), 4},
+		{"all", 1500, aucTidAll, ARRAY_SIZE(aucTidAll), 4},
+		{"mixed", 256, aucTidMixed, ARRAY_SIZE(aucTidMixed), 4},
+	};
+	struct STA_RECORD *aprStaRec[4];
+	struct GL_HIF_INFO *prHifInfo;
+	struct BSS_INFO *prBssInfo;
+	struct VIRT_RING *prRing;
+	struct ADAPTER *prAdapter;
+	uint32_t u4Num = 100000, u4DoneCnt, u4AmsduCnt, u4AmsduMsduCnt;
+	uint64_t u8Ns;
+	u_int8_t fgAmsdu, fgPass = FALSE;
+	uint32_t i, j;
+
+	prAdapter = selfTestProbe();
+	if (!prAdapter)
+		return FALSE;
+	prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	prRing = &prHifInfo->arTxRing[VIRT_TX_RING_DATA];
+	selfTestRunThreads(prAdapter);
+	prBssInfo = selfTestApStart(prAdapter, aprStaRec,
+				    ARRAY_SIZE(aprStaRec));
+	if (!prBssInfo)
+		goto out;
+	selfTestRunThreads(prAdapter);
+
+	for (i = 0; i < ARRAY_SIZE(arFlow); i++) {
+		for (fgAmsdu = 0; fgAmsdu <= 1; fgAmsdu++) {
+			for (j = 0; j < ARRAY_SIZE(aprStaRec); j++)
+				selfTestSetAmsdu(prAdapter, aprStaRec[j],
+						 fgAmsdu);
+			/* warm up the TXD templates */
+			if (!selfTestTxFlowRun(prAdapter, prBssInfo,
+			    aprStaRec, &arFlow[i], SELF_TEST_TX_BATCH))
+				goto out;
+
+			u4DoneCnt = prRing->u4DoneCnt;
+			u4AmsduCnt = prHifInfo->u4AmsduCnt;
+			u4AmsduMsduCnt = prHifInfo->u4AmsduMsduCnt;
+			u8Ns = selfTestTxFlowRun(prAdapter, prBssInfo,
+				aprStaRec, &arFlow[i], u4Num);
+			if (!u8Ns)
+				goto out;
+			u4DoneCnt = prRing->u4DoneCnt - u4DoneCnt;
+			u4AmsduCnt = prHifInfo->u4AmsduCnt - u4AmsduCnt;
+			u4AmsduMsduCnt = prHifInfo->u4AmsduMsduCnt -
+				u4AmsduMsduCnt;
+
+			printf("{\"bench\":\"amsdu\",\"tids\":\"%s\","
+			       "\"len\":%u,\"stas\":%u,\"amsdu\":%s,"
+			       "\"msdus\":%u,\"descs\":%u,"
+			       "\"msdus_per_desc\":%.2f,"
+			       "\"msdus_per_amsdu\":%.2f,"
+			       "\"ns_per_msdu\":%.1f}\n",
+			       arFlow[i].pucName, arFlow[i].u4Len,
+			       arFlow[i].u4StaNum,
+			       fgAmsdu ? "true" : "false", u4Num, u4DoneCnt,
+			       u4DoneCnt ? (double) u4Num / u4DoneCnt : 0,
+			       u4AmsduCnt ?
+			       (double) u4AmsduMsduCnt / u4AmsduCnt : 0,
+			       (double) u8Ns / u4Num);
+		}
+	}
+
+	fgPass = TRUE;
+out:
+	selfTestRemove(prAdapter);
+	return fgPass;
+}
+
+/* SW TSO data movement of kalSwTsoXmit() and halCopyTxData() on Linux, a
+ * GSO skb is SELF_BENCH_TSO_HDR bytes of MAC/IP/TCP header and a payload in
+ * separate pages, every segment ends in a prealloc token buffer
+ */
+#define SELF_BENCH_TSO_HDR		54
+#define SELF_BENCH_TSO_MSS		1448
+#define SELF_BENCH_TSO_PAGE		4096
+#define SELF_BENCH_TSO_SKB_NUM		64	/* GSO skbs cycled */
+#define SELF_BENCH_TSO_TOKEN_NUM	1024	/* token buffers cycled */
+#define SELF_BENCH_TSO_FRAG_MAX		4
+
+struct SELF_BENCH_TSO_FRAG {
+	const uint8_t *pucData;
+	uint32_t u4Len;
+};
+
+/* A segment: header and copied payload in aucLinear, referenced payload
+ * in arFrag, as a segment skb with page frags
+ */
+struct SELF_BENCH_TSO_SEG {
+	uint8_t aucLinear[ETHER_MAX_PKT_SZ];
+	uint32_t u4LinearLen;
+	struct SELF_BENCH_TSO_FRAG arFrag[SELF_BENCH_TSO_FRAG_MAX];
+	uint32_t u4FragNum;
+};
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Segment one GSO payload of u4Len bytes and write every segment
+ *        to a token buffer. With fgRefFrag the segment references the
+ *        payload pages and the token gathers them, as kalSwTsoAddData()
+ *        and skb_copy_bits(), otherwise the payload is copied into the
+ *        segment and the segment into the token.
+ *
+ * @return number of segments
+ */
+/*----------------------------------------------------------------------------*/
+static uint32_t selfBenchTsoXmit(struct SELF_BENCH_TSO_SEG *prSeg,
+				 const uint8_t *pucHdr, uint8_t **apucPage,
+				 uint32_t u4Len, uint8_t *pucToken,
+				 uint32_t *pu4TokenIdx, u_int8_t fgRefFrag)
+{
+	struct SELF_BENCH_TSO_FRAG *prFrag;
+	uint32_t u4Off = 0, u4SegNum = 0, u4Left, u4Size, u4PageOff, i;
+	const uint8_t *pucData;
+	uint8_t *pucDst;
+
+	while (u4Off < u4Len) {
+		u4Left = u4Len - u4Off;
+		if (u4Left > SELF_BENCH_TSO_MSS)
+			u4Left = SELF_BENCH_TSO_MSS;
+
+		/* tso_build_hdr() */
+		kalMemCopy(prSeg->aucLinear, pucHdr, SELF_BENCH_TSO_HDR);
+		prSeg->u4LinearLen = SELF_BENCH_TSO_HDR;
+		prSeg->u4FragNum = 0;
+
+		while (u4Left) {
+			u4PageOff = u4Off % SELF_BENCH_TSO_PAGE;
+			pucData = apucPage[u4Off / SELF_BENCH_TSO_PAGE] +
+				  u4PageOff;
+			u4Size = SELF_BENCH_TSO_PAGE - u4PageOff;
+			if (u4Size > u4Left)
+				u4Size = u4Left;
+
+			if (fgRefFrag) {
+				/* get_page() and skb_fill_page_desc() */
+				prFrag = &prSeg->arFrag[prSeg->u4FragNum++];
+				prFrag->pucData = pucData;
+				prFrag->u4Len = u4Size;
+			} else {
+				kalMemCopy(prSeg->aucLinear +
+					   prSeg->u4LinearLen, pucData,
+					   u4Size);
+				prSeg->u4LinearLen += u4Size;
+			}
+			u4Off += u4Size;
+			u4Left -= u4Size;
+		}
+
+		/* halCopyTxData() into the prealloc token buffer */
+		pucDst = pucToken + *pu4TokenIdx * ETHER_MAX_PKT_SZ;
+		*pu4TokenIdx = (*pu4TokenIdx + 1) % SELF_BENCH_TSO_TOKEN_NUM;
+		kalMemCopy(pucDst, prSeg->aucLinear, prSeg->u4LinearLen);
+		pucDst += prSeg->u4LinearLen;
+		for (i = 0; i < prSeg->u4FragNum; i++) {
+			kalMemCopy(pucDst, prSeg->arFrag[i].pucData,
+				   prSeg->arFrag[i].u4Len);
+			pucDst += prSeg->arFrag[i].u4Len;
+		}
+		u4SegNum++;
+	}
+
+	return u4SegNum;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief CPU per Gbit of SW TSO payload with the segments copying the
+ *        payload (SwTsoRefFrag=0) and referencing it (SwTsoRefFrag=1), for
+ *        16 KB and 64 KB GSO skbs. Only the data movement is timed, the
+ *        skb bookkeeping of Linux is not modeled.
+ *
+ * @return TRUE if it ran
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchSwTso(void)
+{
+	const uint32_t au4GsoLen[] = {16 * 1024, 64 * 1024};
+	const uint32_t u4PageNum = 64 * 1024 / SELF_BENCH_TSO_PAGE;
+	uint8_t *apucPage[SELF_BENCH_TSO_SKB_NUM][64 * 1024 /
+						  SELF_BENCH_TSO_PAGE];
+	uint8_t aucHdr[SELF_BENCH_TSO_HDR];
+	struct SELF_BENCH_TSO_SEG *prSeg;
+	uint8_t *pucToken;
+	uint64_t u8Start, u8Ns, u8Bytes;
+	uint32_t u4TokenIdx = 0, u4SegNum, u4Round = 2000, i, j, k;
+	u_int8_t fgRefFrag, fgPass = FALSE;
+
+	kalMemZero(apucPage, sizeof(apucPage));
+	prSeg = kalMemAlloc(sizeof(*prSeg), VIR_MEM_TYPE);
+	pucToken = kalMemAlloc(SELF_BENCH_TSO_TOKEN_NUM * ETHER_MAX_PKT_SZ,
+			       VIR_MEM_TYPE);
+	if (!prSeg || !pucToken)
+		goto out;
+	for (i = 0; i < SELF_BENCH_TSO_SKB_NUM; i++) {
+		for (j = 0; j < u4PageNum; j++) {
+			apucPage[i][j] = kalMemAlloc(SELF_BENCH_TSO_PAGE,
+						     VIR_MEM_TYPE);
+			if (!apucPage[i][j])
+				goto out;
+			kalMemSet(apucPage[i][j], (uint8_t) (i + j),
+				  SELF_BENCH_TSO_PAGE);
+		}
+	}
+	kalMemSet(aucHdr, 0x45, sizeof(aucHdr));
+	kalMemSet(pucToken, 0, SELF_BENCH_TSO_TOKEN_NUM * ETHER_MAX_PKT_SZ);
+
+	for (i = 0; i < ARRAY_SIZE(au4GsoLen); i++) {
+		for (fgRefFrag = 0; fgRefFrag <= 1; fgRefFrag++) {
+			u4SegNum = 0;
+			u8Start = kal_sched_clock();
+			for (k = 0; k < u4Round; k++)
+				u4SegNum += selfBenchTsoXmit(prSeg, aucHdr,
+					apucPage[k % SELF_BENCH_TSO_SKB_NUM],
+					au4GsoLen[i], pucToken, &u4TokenIdx,
+					fgRefFrag);
+			u8Ns = kal_sched_clock() - u8Start;
+			if (!u8Ns)
+				u8Ns = 1;
+			u8Bytes = (uint64_t) au4GsoLen[i] * u4Round;
+
+			printf("{\"bench\":\"sw_tso\",\"path\":\"%s\","
+			       "\"gso_len\":%u,\"mss\":%u,\"segs\":%u,"
+			       "\"payload_copies\":%u,"
+			       "\"ns_per_seg\":%.1f,"
+			       "\"cpu_ms_per_gbit\":%.3f}\n",
+			       fgRefFrag ? "ref" : "copy", au4GsoLen[i],
+			       SELF_BENCH_TSO_MSS, u4SegNum,
+			       fgRefFrag ? 1 : 2, (double) u8Ns / u4SegNum,
+			       (double) u8Ns * 1000 / (u8Bytes * 8));
+		}
+	}
+
+	fgPass = TRUE;
+out:
+	for (i = 0; i < SELF_BENCH_TSO_SKB_NUM; i++) {
+		for (j = 0; j < u4PageNum; j++) {
+			if (apucPage[i][j])
+				kalMemFree(apucPage[i][j], VIR_MEM_TYPE,
+					   SELF_BENCH_TSO_PAGE);
+		}
+	}
+	if (pucToken)
+		kalMemFree(pucToken, VIR_MEM_TYPE,
+			   SELF_BENCH_TSO_TOKEN_NUM * ETHER_MAX_PKT_SZ);
+	if (prSeg)
+		kalMemFree(prSeg, VIR_MEM_TYPE, sizeof(*prSeg));
+	return fgPass;
+}
+
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+static const char * const apucSelfBenchTxLatStage[TX_LAT_STAGE_NUM] = {
+	"os_to_enque",
+	"enque_to_deque",
+	"deque_to_hif",
+	"hif_to_free",
+	"total"
+};
+
+/* One tx_flow case: u4Num frames of prFlow with A-MSDU on or off, printed
+ * as one JSON line
+ */
+static u_int8_t selfBenchTxFlowCase(struct ADAPTER *prAdapter,
+				    struct BSS_INFO *prBssInfo,
+				    struct STA_RECORD **aprStaRec,
+				    const struct SELF_TEST_TX_FLOW *prFlow,
+				    u_int8_t fgAmsdu, uint32_t u4Num)
+{
+	struct TX_LAT_HIST *prHist;
+	uint32_t u4Stage, i;
+	uint64_t u8Ns;
+
+	for (i = 0; i < prFlow->u4StaNum; i++)
+		selfTestSetAmsdu(prAdapter, aprStaRec[i], fgAmsdu);
+	/* warm up the TXD templates */
+	if (!selfTestTxFlowRun(prAdapter, prBssInfo, aprStaRec, prFlow,
+			       SELF_TEST_TX_BATCH))
+		return FALSE;
+
+	wlanTxLatReset(prAdapter);
+	u8Ns = selfTestTxFlowRun(prAdapter, prBssInfo, aprStaRec, prFlow,
+				 u4Num);
+	if (!u8Ns)
+		return FALSE;
+
+	printf("{\"bench\":\"tx_flow\",\"len\":%u,\"tids\":\"%s\","
+	       "\"stas\":%u,\"amsdu\":%s,\"pkts\":%u,\"pps\":%.0f,"
+	       "\"ns_per_pkt\":%.1f,\"stages\":{",
+	       prFlow->u4Len, prFlow->pucName, prFlow->u4StaNum,
+	       fgAmsdu ? "true" : "false", u4Num,
+	       (double) u4Num * 1000 * NSEC_PER_MSEC / u8Ns,
+	       (double) u8Ns / u4Num);
+	for (u4Stage = 0; u4Stage < TX_LAT_STAGE_NUM; u4Stage++) {
+		prHist = &prAdapter->rTxCtrl.rLatStats.arHist[u4Stage];
+		printf("%s\"%s\":{\"count\":%u,\"p50_ns\":%llu,"
+		       "\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}",
+		       u4Stage ? "," : "", apucSelfBenchTxLatStage[u4Stage],
+		       prHist->u4Count,
+		       (unsigned long long) wlanTxLatGetPercentile(prHist, 500),
+		       (unsigned long long) wlanTxLatGetPercentile(prHist, 990),
+		       (unsigned long long) wlanTxLatGetPercentile(prHist, 999),
+		       (unsigned long long) prHist->u8MaxTime);
+	}
+	printf("}}\n");
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief TX data path from kalHardStartXmit() through wlanEnqueueTxPacket(),
+ *        qmEnqueueTxPackets(), qmDequeueTxPackets() and nicTxMsduQueue() to
+ *        the data ring, for each frame size, TID mix, station count and
+ *        A-MSDU setting: packets per second, driver ns per packet and the
+ *        p50/p99/p99.9 latency of every stage of the lifetime profiler.
+ *
+ * @return TRUE if it ran
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchTxFlow(void)
+{
+	const uint32_t au4Len[] = {64, 512, 1500};
+	const uint32_t au4StaNum[] = {1, 8};
+	const uint8_t aucTidBe[] = {0};
+	const uint8_t aucTidMixed[] = {0, 0, 5, 0, 6, 0, 1, 0};
+	const struct SELF_TEST_TX_FLOW arTid[] = {
+		{"be", 0, aucTidBe, ARRAY_SIZE(aucTidBe), 0},
+		{"mixed", 0, aucTidMixed, ARRAY_SIZE(aucTidMixed), 0},
+	};
+	struct STA_RECORD *aprStaRec[8];
+	struct SELF_TEST_TX_FLOW rFlow;
+	struct BSS_INFO *prBssInfo;
+	struct ADAPTER *prAdapter;
+	u_int8_t fgAmsdu, fgPass = FALSE;
+	uint32_t i, j;
+
+	prAdapter = selfTestProbe();
+	if (!prAdapter)
+		return FALSE;
+	selfTestRunThreads(prAdapter);
+	prBssInfo = selfTestApStart(prAdapter, aprStaRec,
+				    ARRAY_SIZE(aprStaRec));
+	if (!prBssInfo)
+		goto out;
+	selfTestRunThreads(prAdapter);
+
+	for (i = 0; i < ARRAY_SIZE(au4Len); i++) {
+		for (j = 0; j < ARRAY_SIZE(arTid) * ARRAY_SIZE(au4StaNum);
+		     j++) {
+			rFlow = arTid[j / ARRAY_SIZE(au4StaNum)];
+			rFlow.u4Len = au4Len[i];
+			rFlow.u4StaNum = au4StaNum[j % ARRAY_SIZE(au4StaNum)];
+			for (fgAmsdu = 0; fgAmsdu <= 1; fgAmsdu++) {
+				if (!selfBenchTxFlowCase(prAdapter, prBssInfo,
+				    aprStaRec, &rFlow, fgAmsdu, 50000))
+					goto out;
+			}
+		}
+	}
+
+	fgPass = TRUE;
+out:
+	selfTestRemove(prAdapter);
+	return fgPass;
+}
+#endif
+
+#if CFG_SUPPORT_CSI
+#define SELF_BENCH_CSI_EVENT_BUF	1536
+#define SELF_BENCH_CSI_SET_NUM		64	/* reports cycled per profile */
+
+/* One kind of CSI report as the firmware sends it */
+struct SELF_BENCH_CSI_PROFILE {
+	const char *pucName;
+	uint8_t ucRxMode;
+	uint8_t ucBw;
+	uint8_t ucDataBw;
+	uint8_t ucPrimaryChIdx;
+	uint16_t u2DataCount;
+};
+
+/* Append one TLV to a CSI event body, return its length */
+static uint32_t selfBenchCsiTlv(uint8_t *pucBuf, uint32_t u4Tag,
+				const void *pvBody, uint32_t u4Len)
+{
+	struct CSI_TLV_ELEMENT *prTlv = (struct CSI_TLV_ELEMENT *) pucBuf;
+
+	prTlv->tag_type = u4Tag;
+	prTlv->body_len = u4Len;
+	kalMemCopy(prTlv->aucbody, pvBody, u4Len);
+	return OFFSET_OF(struct CSI_TLV_ELEMENT, aucbody) + u4Len;
+}
+
+static uint32_t selfBenchCsiTlv32(uint8_t *pucBuf, uint32_t u4Tag,
+				  uint32_t u4Val)
+{
+	return selfBenchCsiTlv(pucBuf, u4Tag, &u4Val, sizeof(u4Val));
+}
+
+/* Build a CSI event with every tag, in the order the firmware sends them */
+static void selfBenchCsiEvent(struct ADAPTER *prAdapter,
+			      struct WIFI_EVENT *prEvent,
+			      const struct SELF_BENCH_CSI_PROFILE *prProf,
+			      uint32_t *pu4Seed)
+{
+	int16_t ai2Data[CSI_MAX_DATA_COUNT];
+	uint8_t aucTA[ALIGN_4(MAC_ADDR_LEN)] = {
+		0x00, 0x0c, 0x43, 0x11, 0x22, 0x33
+	};
+	uint32_t au4Rsvd[2] = {0};
+	uint8_t *pucBuf = prEvent->aucBuffer;
+	uint32_t u4Len = 0, u4Gain = 1 << 10;
+	uint16_t i;
+
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_VERSION, 1);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_CBW, prProf->ucBw);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_RSSI,
+				   (uint32_t) -45);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_SNR, 30);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_BAND, 0);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_CSI_NUM,
+				   prProf->u2DataCount);
+	kalMemZero(ai2Data, sizeof(ai2Data));
+	for (i = 0; i < prProf->u2DataCount; i++)
+		ai2Data[i] = selfTestCsiRand(pu4Seed, u4Gain);
+	u4Len += selfBenchCsiTlv(pucBuf + u4Len, CSI_EVENT_CSI_I_DATA,
+				 ai2Data, sizeof(ai2Data));
+	for (i = 0; i < prProf->u2DataCount; i++)
+		ai2Data[i] = selfTestCsiRand(pu4Seed, u4Gain);
+	u4Len += selfBenchCsiTlv(pucBuf + u4Len, CSI_EVENT_CSI_Q_DATA,
+				 ai2Data, sizeof(ai2Data));
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_DBW,
+				   prProf->ucDataBw);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_CH_IDX,
+				   prProf->ucPrimaryChIdx);
+	u4Len += selfBenchCsiTlv(pucBuf + u4Len, CSI_EVENT_TA,
+				 aucTA, sizeof(aucTA));
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_EXTRA_INFO, 0);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_RX_MODE,
+				   prProf->ucRxMode);
+	u4Len += selfBenchCsiTlv(pucBuf + u4Len, CSI_EVENT_RSVD1,
+				 au4Rsvd, sizeof(au4Rsvd));
+	u4Len += selfBenchCsiTlv(pucBuf + u4Len, CSI_EVENT_RSVD2,
+				 au4Rsvd, sizeof(au4Rsvd));
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_RSVD3, 0);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_RSVD4, 0);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_H_IDX, 0);
+	u4Len += selfBenchCsiTlv32(pucBuf + u4Len, CSI_EVENT_TX_RX_IDX, 0);
+
+	prEvent->u2PacketLength = prAdapter->chip_info->event_hdr_size + u4Len;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief nicEventCSIData() cost per report over synthetic firmware CSI
+ *        events of each bandwidth and PPDU type, in every output format.
+ *        Each event is parsed into the ring, masked, shifted and noise
+ *        filtered as configured, then drained the way /proc csi_ring
+ *        reads it.
+ *
+ * @return TRUE if it ran and every report was parsed with the right
+ *         tone count
+ */
+/*----------------------------------------------------------------------------*/
+static u_int8_t selfBenchCsi(void)
+{
+	const char *apucFormat[] = {"raw", "masked", "masked_shifted"};
+	const struct SELF_BENCH_CSI_PROFILE arProf[] = {
+		{"cck", RX_VT_LEGACY_CCK, RX_VT_FR_MODE_20,
+		 RX_VT_FR_MODE_20, 0, 64},
+		{"ht20", RX_VT_MIXED_MODE, RX_VT_FR_MODE_20,
+		 RX_VT_FR_MODE_20, 0, 64},
+		{"vht40", RX_VT_VHT_MODE, RX_VT_FR_MODE_40,
+		 RX_VT_FR_MODE_40, 1, 128},
+		{"he80", RX_VT_HE_MODE, RX_VT_FR_MODE_80,
+		 RX_VT_FR_MODE_80, 2, 256},
+	};
+	uint32_t u4Num = 200000, u4Seed = 1, u4Kept, u4Bad;
+	struct CSI_INFO_T *prCSIInfo;
+	struct CSI_DATA_T *prCSIData;
+	struct ADAPTER *prAdapter;
+	uint8_t *pucEvent;
+	uint64_t u8Start, u8Ns;
+	u_int8_t fgPass = FALSE;
+	uint32_t i, j, k;
+
+	prAdapter = selfTestAllocAdapter();
+	if (!prAdapter)
+		return FALSE;
+	prCSIInfo = &prAdapter->rCSIInfo;
+	pucEvent = calloc(SELF_BENCH_CSI_SET_NUM, SELF_BENCH_CSI_EVENT_BUF);
+	if (!pucEvent)
+		goto out;
+
+	for (j = 0; j < ARRAY_SIZE(arProf); j++) {
+		for (k = 0; k < SELF_BENCH_CSI_SET_NUM; k++)
+			selfBenchCsiEvent(prAdapter, (struct WIFI_EVENT *)
+				(pucEvent + k * SELF_BENCH_CSI_EVENT_BUF),
+				&arProf[j], &u4Seed);
+
+		for (k = 0; k < ARRAY_SIZE(apucFormat); k++) {
+			prCSIInfo->ucValue1[CSI_CONFIG_OUTPUT_FORMAT] = k;
+			u4Kept = 0;
+			u4Bad = 0;
+			u8Start = kal_sched_clock();
+			for (i = 0; i < u4Num; i++) {
+				nicEventCSIData(prAdapter, (struct WIFI_EVENT *)
+					(pucEvent + (i % SELF_BENCH_CSI_SET_NUM)
+					 * SELF_BENCH_CSI_EVENT_BUF));
+				prCSIData = wlanCSIRingPeek(prAdapter);
+				if (!prCSIData)
+					continue;
+				u4Kept++;
+				if (prCSIData->u2DataCount !=
+				    arProf[j].u2DataCount)
+					u4Bad++;
+				wlanCSIRingConsume(prAdapter);
+			}
+			u8Ns = kal_sched_clock() - u8Start;
+
+			printf("{\"bench\":\"csi\",\"report\":\"%s\","
+			       "\"format\":\"%s\",\"reports\":%u,\"kept\":%u,"
+			       "\"ns_per_report\":%.1f}\n",
+			       arProf[j].pucName, apucFormat[k], u4Num, u4Kept,
+			       (double) u8Ns / u4Num);
+			if (u4Bad) {
+				DBGLOG(INIT, ERROR, "csi: %s %s %u bad\n",
+				       arProf[j].pucName, apucFormat[k], u4Bad);
+				goto out;
+			}
+		}
+	}
+
+	fgPass = TRUE;
+out:
+	free(pucEvent);
+	selfTestFreeAdapter(prAdapter);
+	return fgPass;
+}
+#endif
+
+/* Benchmarks, run by "wlan_<chip>_none bench". Each prints one JSON object
+ * per line on stdout.
+ */
+static const struct SELF_TEST arSelfBench[] = {
+#if CFG_SUPPORT_CFG_FILE
+	{"cfg", selfBenchCfg},
+#endif
+	{"crc32", selfBenchCrc32},
+	{"dense_scan", selfBenchDenseScan},
+	{"fwdl", selfBenchFwDl},
+#if QM_RX_REORDER_SLOT_INDEX
+	{"rx_reorder", selfBenchRxReorder},
+#endif
+	{"token_pool", selfBenchTokenPool},
+#if CFG_RXD_STATIC_BIND
+	{"rxd_parse", selfBenchRxdParse},
+#endif
+	{"amsdu", selfBenchAmsdu},
+	{"sw_tso", selfBenchSwTso},
+#if CFG_ENABLE_PKT_LIFETIME_PROFILE
+	{"tx_flow", selfBenchTxFlow},
+#endif
+#if CFG_SUPPORT_CSI
+	{"csi", selfBenchCsi},
+#endif
+};
+
+/*----------------------------------------------------------------------------*/
+/*!
+ * @brief Run the benchmarks
+ *
+ * @param name           Benchmark to run, NULL for all
+ *
+ * @return number of benchmarks which could not run, 1 if none matched
+ */
+/*----------------------------------------------------------------------------*/
+int glSelfBench(const char *name)
+{
+	uint32_t i, u4Run = 0, u4Fail = 0;
+
+	/* keep stdout to the JSON lines */
+	wlanSetDriverDbgLevel(DBG_ALL_MODULE_IDX, DBG_CLASS_ERROR);
+
+	for (i = 0; i < ARRAY_SIZE(arSelfBench); i++) {
+		if (name && strcmp(name, arSelfBench[i].pucName) != 0)
+			continue;
+
+		u4Run++;
+		if (!arSelfBench[i].pfnTest()) {
+			DBGLOG(INIT, ERROR, "FAIL %s\n",
+			       arSelfBench[i].pucName);
+			u4Fail++;
+		}
+	}
+
+	if (u4Run == 0)
+		return 1;
+	return u4Fail;
+}
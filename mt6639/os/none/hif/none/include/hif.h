@@ -78,6 +78,15 @@
  *                              C O N S T A N T S
  *******************************************************************************
  */
+/* virtual WFDMA device */
+#define VIRT_RING_SIZE                  256
+#define VIRT_DMA_BUF_SIZE               4096
+#define VIRT_CR_NUM                     64
+
+/* scripted firmware responder */
+#define VIRT_FW_RULE_NUM                16
+/* zero filled payload of an unscripted command response */
+#define VIRT_FW_EVT_DEFAULT_LEN         512
 
 /*******************************************************************************
  *                             D A T A   T Y P E S
@@ -86,14 +95,125 @@
 
 struct GL_HIF_INFO;
 
+enum ENUM_VIRT_TX_RING {
+	VIRT_TX_RING_DATA = 0,
+	VIRT_TX_RING_CMD,	/* init commands, FW scatters and commands */
+	VIRT_TX_RING_NUM
+};
+
+enum ENUM_VIRT_RX_RING {
+	VIRT_RX_RING_DATA = 0,	/* WHISR_RX0_DONE_INT */
+	VIRT_RX_RING_EVT,	/* WHISR_RX1_DONE_INT */
+	VIRT_RX_RING_NUM
+};
+
+enum ENUM_VIRT_FW_STATE {
+	VIRT_FW_STATE_OFF = 0,
+	VIRT_FW_STATE_ROM,	/* answers init commands */
+	VIRT_FW_STATE_DL,	/* absorbs a download scatter */
+	VIRT_FW_STATE_RAM	/* answers runtime commands */
+};
+
+/* One descriptor of an emulated ring. TX data descriptors point at the host
+ * MSDU_INFO the way SDPtr0 points at a mapped buffer, all other descriptors
+ * own a VIRT_DMA_BUF_SIZE slot of the ring buffer pool.
+ */
+struct VIRT_DMAD {
+	void *pvPacket;
+	uint8_t *pucBuf;
+	uint32_t u4Len;
+	uint16_t u2MsduNum;	/* > 1: A-MSDU, pvPacket heads the MSDU chain */
+	uint8_t ucTC;
+	uint8_t ucWlanIdx;	/* TX status of frames with a done handler */
+	uint8_t ucPID;
+	u_int8_t fgTxStatus;
+};
+
+/* TX: host fills at u4CpuIdx, device consumes up to u4CpuIdx on doorbell,
+ *     host reclaims from u4SwUsedIdx to u4DmaIdx.
+ * RX: device fills at u4DmaIdx, host consumes at u4CpuIdx.
+ */
+struct VIRT_RING {
+	struct VIRT_DMAD arDmad[VIRT_RING_SIZE];
+	uint8_t *pucBufPool;
+	uint32_t u4CpuIdx;
+	uint32_t u4DmaIdx;
+	uint32_t u4SwUsedIdx;
+	uint32_t u4DoneCnt;
+	uint32_t u4DropCnt;
+};
+
+/* SW A-MSDU staging bucket of one STA/TID, kept by the rules of the PDMA
+ * HIF: MSDUs are chained by rQueEntry and written as one descriptor once
+ * the bucket is closed.
+ */
+struct VIRT_AMSDU_BUCKET {
+	struct QUE_ENTRY rQueEntry;	/* linked in rAmsduOpenQue */
+	struct QUE rMsduQue;
+	uint16_t u2Size;		/* A-MSDU length with TXD and padding */
+	u_int8_t fgQueued;		/* in rAmsduOpenQue */
+};
+
+struct VIRT_CR {
+	uint32_t u4Addr;
+	uint32_t u4Value;
+};
+
+/* Response of the firmware emulator to one command ID */
+struct VIRT_FW_RULE {
+	u_int8_t fgUni;
+	uint16_t u2CID;
+	uint8_t ucEID;
+	uint16_t u2EvtLen;
+	const uint8_t *pucEvt;	/* NULL: zero filled payload */
+};
+
+struct VIRT_FW {
+	enum ENUM_VIRT_FW_STATE eState;
+	uint32_t u4DlRemain;
+	uint32_t u4InitCmdCnt;
+	uint32_t u4DlBytes;
+	uint32_t u4DlCrc;	/* CRC32 of the last section downloaded */
+	uint32_t u4CmdCnt;
+	uint32_t u4EvtCnt;
+	uint32_t u4TxStatusCnt;
+	struct VIRT_FW_RULE arRule[VIRT_FW_RULE_NUM];
+	uint8_t ucRuleNum;
+	uint8_t aucEvtBuf[VIRT_DMA_BUF_SIZE];
+};
 
 /* host interface's private data structure, which is attached to os glue
  ** layer info structure.
  */
 struct GL_HIF_INFO {
+	struct VIRT_RING arTxRing[VIRT_TX_RING_NUM];
+	struct VIRT_RING arRxRing[VIRT_RX_RING_NUM];
+
+	/* interrupt model, WHISR bits */
+	uint32_t u4IntStatus;
+	u_int8_t fgIntEnable;
+	uint32_t u4IntRaiseCnt;
+
+	struct VIRT_CR arCr[VIRT_CR_NUM];
+	uint32_t u4CrNum;
+
+	u_int8_t fgFwDlEnable;
+	u_int8_t fgTxRxStop;
+
+	/* SW A-MSDU of the data ring, see kalDevWriteData() */
+	struct VIRT_AMSDU_BUCKET *prAmsduBucket;	/* [STA][TID] */
+	struct QUE rAmsduOpenQue;
+	uint32_t u4AmsduStagedCnt;	/* MSDUs in staging buckets */
+	uint32_t u4AmsduCnt;		/* A-MSDUs written */
+	uint32_t u4AmsduMsduCnt;	/* MSDUs written in A-MSDUs */
+
+	struct VIRT_FW rFw;
 };
 
 struct BUS_INFO {
+	/* needed by chips/common/cmm_asic_connac3x.c */
+	struct DMASHDL_CFG *prDmashdlCfg;
+	void (*DmaShdlInit)(IN struct ADAPTER *prAdapter);
 };
 
 
@@ -124,6 +244,12 @@ struct BUS_INFO {
 #define HIF_TX_BUFF_COUNT_TC2               3
 #define HIF_TX_BUFF_COUNT_TC3               3
 #define HIF_TX_BUFF_COUNT_TC4               2
+
+#define HIF_TX_PAGE_SIZE_IN_POWER_OF_2      11
+#define HIF_TX_PAGE_SIZE                    2048	/* in unit of bytes */
+
+#define HIF_TX_COALESCING_BUFFER_SIZE       (VIRT_DMA_BUF_SIZE)
+#define HIF_RX_COALESCING_BUFFER_SIZE       (VIRT_DMA_BUF_SIZE)
 /*******************************************************************************
  *                           P R I V A T E   D A T A
  *******************************************************************************
@@ -171,6 +297,10 @@ struct BUS_INFO {
 uint8_t halTxRingDataSelect(IN struct ADAPTER *prAdapter,
 	IN struct MSDU_INFO *prMsduInfo);
 
+u_int8_t halProcessToken(IN struct ADAPTER *prAdapter,
+	IN uint32_t u4Token,
+	IN struct QUE *prFreeQueue);
+
 /*******************************************************************************
  *                              F U N C T I O N S
  *******************************************************************************
@@ -247,6 +377,14 @@ void kal_virt_set_int_stat_readclear(struct ADAPTER *ad);
  */
 void kal_virt_init_hif(struct ADAPTER *ad);
 
+/*
+ * kal_virt_power_on: power on reset of the virtual device, the bus probe
+ *                    of the none OS. CRs go back to their reset values
+ *                    and the emulated firmware to ROM state.
+ * @ad: structure for adapter private data
+ */
+void kal_virt_power_on(struct ADAPTER *ad);
+
 /*
  * kal_virt_enable_fwdl: enable firmware download
  * @ad: structure for adapter private data
@@ -255,6 +393,14 @@ void kal_virt_init_hif(struct ADAPTER *ad);
  */
 void kal_virt_enable_fwdl(struct ADAPTER *ad, bool enable);
 
+/*
+ * kal_virt_cancel_tx_rx: stop the virtual DMA from moving TX/RX frames
+ * @ad: structure for adapter private data
+ *
+ * not: implementation for different HIF may refer to nic/hal.h
+ */
+void kal_virt_cancel_tx_rx(struct ADAPTER *ad);
+
 /*
  * kal_virt_get_int_status: read interrupt status
  * @ad: structure for adapter private data
@@ -287,4 +433,120 @@ void kal_virt_uhw_rd(struct ADAPTER *ad, uint32_t u4Offset, uint32_t *pu4Value,
  */
 void kal_virt_uhw_wr(struct ADAPTER *ad, uint32_t u4Offset, uint32_t u4Value,
 		     u_int8_t *pfgSts);
+
+/* virtual WFDMA device */
+/*
+ * kal_virt_rx_enqueue: device side DMA of one frame into an RX ring
+ * @ad: structure for adapter private data
+ * @ring: ENUM_VIRT_RX_RING
+ * @buf: frame including the chip RX descriptor
+ * @len: frame length
+ *
+ * note: caller holds SPIN_LOCK_VIRT_DEV and raises the interrupt with
+ *       kal_virt_raise_int() after releasing it
+ */
+u_int8_t kal_virt_rx_enqueue(struct ADAPTER *ad, uint8_t ring,
+	uint8_t *buf, uint32_t len);
+
+/*
+ * kal_virt_cr_access: access the register file of the device
+ * @ad: structure for adapter private data
+ * @write: TRUE to write *value, FALSE to read into *value
+ * @addr: CR address
+ * @value: CR value
+ *
+ * note: caller holds SPIN_LOCK_VIRT_DEV, unknown CRs read as 0
+ */
+u_int8_t kal_virt_cr_access(struct ADAPTER *ad, u_int8_t write,
+	uint32_t addr, uint32_t *value);
+
+/*
+ * kal_virt_raise_int: assert WHISR bits and signal the interrupt
+ * @ad: structure for adapter private data
+ * @bits: WHISR bits to assert, 0 to re-check pending bits
+ */
+void kal_virt_raise_int(struct ADAPTER *ad, uint32_t bits);
+
+/*
+ * kal_virt_inject_rx: inject a frame as if received from the air or FW
+ * @ad: structure for adapter private data
+ * @ring: ENUM_VIRT_RX_RING
+ * @buf: frame including the chip RX descriptor
+ * @len: frame length
+ */
+u_int8_t kal_virt_inject_rx(struct ADAPTER *ad, uint8_t ring,
+	uint8_t *buf, uint32_t len);
+
+/* firmware emulator, os/none/hif/none/virt_fw.c */
+/*
+ * kal_virt_fw_reset: put the emulated firmware back to ROM state
+ * @ad: structure for adapter private data
+ */
+void kal_virt_fw_reset(struct ADAPTER *ad);
+
+/*
+ * kal_virt_fw_handle_init_cmd: consume a frame of the init command port
+ * @ad: structure for adapter private data
+ * @buf: frame including the HIF TXD
+ * @len: frame length
+ *
+ * note: caller holds SPIN_LOCK_VIRT_DEV
+ */
+void kal_virt_fw_handle_init_cmd(struct ADAPTER *ad, uint8_t *buf,
+	uint32_t len);
+
+/*
+ * kal_virt_fw_handle_cmd: consume a runtime command
+ * @ad: structure for adapter private data
+ * @buf: command including the TXD
+ * @len: command length
+ *
+ * note: caller holds SPIN_LOCK_VIRT_DEV
+ */
+void kal_virt_fw_handle_cmd(struct ADAPTER *ad, uint8_t *buf, uint32_t len);
+
+/*
+ * kal_virt_fw_tx_status: report EVENT_ID_TX_DONE of a frame
+ * @ad: structure for adapter private data
+ * @wlan_idx: WTBL index of the frame
+ * @pid: packet ID of the frame
+ *
+ * note: caller holds SPIN_LOCK_VIRT_DEV
+ */
+void kal_virt_fw_tx_status(struct ADAPTER *ad, uint8_t wlan_idx,
+	uint8_t pid);
+
+/*
+ * kal_virt_fw_inject_event: send an unsolicited legacy event
+ * @ad: structure for adapter private data
+ * @eid: event ID
+ * @buf: event payload
+ * @len: payload length
+ */
+u_int8_t kal_virt_fw_inject_event(struct ADAPTER *ad, uint8_t eid,
+	uint8_t *buf, uint16_t len);
+
+/*
+ * kal_virt_fw_set_rule: script the response to a command ID
+ * @ad: structure for adapter private data
+ * @uni: TRUE for a unified command ID
+ * @cid: command ID
+ * @eid: event ID of the response
+ * @buf: response payload, kept by reference, NULL for zero filled
+ * @len: payload length
+ */
+u_int8_t kal_virt_fw_set_rule(struct ADAPTER *ad, u_int8_t uni,
+	uint16_t cid, uint8_t eid, const uint8_t *buf, uint16_t len);
+
+/*
+ * kal_virt_fw_image: build the CONNAC format image the emulated firmware
+ *                    boots from, random region data and the tailers
+ * @ad: structure for adapter private data
+ * @idx: image index, only IMG_DL_IDX_N9_FW has an image
+ * @len: image length
+ *
+ * note: caller frees the image with vfree()
+ */
+uint8_t *kal_virt_fw_image(struct ADAPTER *ad,
+	enum ENUM_IMG_DL_IDX_T idx, uint32_t *len);
 #endif /* _HIF_H */
@@ -102,6 +102,14 @@
  *                                 M A C R O S
  *****************************************************************************
  */
+#define VIRT_RING_NEXT(_u4Idx)		(((_u4Idx) + 1) % VIRT_RING_SIZE)
+
+#define VIRT_RING_FULL(_prRing) \
+	(VIRT_RING_NEXT((_prRing)->u4CpuIdx) == (_prRing)->u4SwUsedIdx)
+
+#define VIRT_RING_FREE(_prRing) \
+	(((_prRing)->u4SwUsedIdx + VIRT_RING_SIZE - (_prRing)->u4CpuIdx - 1) \
+	 % VIRT_RING_SIZE)
 
 /*****************************************************************************
  *                   F U N C T I O N   D E C L A R A T I O N S
@@ -114,79 +122,951 @@
  *****************************************************************************
  */
 
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Put all rings of the virtual WFDMA device back to index 0.
+*        Caller holds SPIN_LOCK_VIRT_DEV and has reclaimed the TX rings.
+*
+* @param prHifInfo      Pointer to the HIF info structure.
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static void halVirtResetRings(struct GL_HIF_INFO *prHifInfo)
+{
+	struct VIRT_RING *prRing;
+	uint32_t i, j;
+
+	for (i = 0; i < VIRT_TX_RING_NUM + VIRT_RX_RING_NUM; i++) {
+		if (i < VIRT_TX_RING_NUM)
+			prRing = &prHifInfo->arTxRing[i];
+		else
+			prRing = &prHifInfo->arRxRing[i - VIRT_TX_RING_NUM];
+
+		for (j = 0; j < VIRT_RING_SIZE; j++) {
+			prRing->arDmad[j].pvPacket = NULL;
+			prRing->arDmad[j].u4Len = 0;
+			prRing->arDmad[j].u2MsduNum = 0;
+			prRing->arDmad[j].fgTxStatus = FALSE;
+		}
+		prRing->u4CpuIdx = 0;
+		prRing->u4DmaIdx = 0;
+		prRing->u4SwUsedIdx = 0;
+	}
+
+	prHifInfo->u4IntStatus = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Reclaim the TX descriptors the device has finished with.
+*        Data MSDUs go back through nicTxMsduDoneCb(), frames with a TX done
+*        handler get their EVENT_ID_TX_DONE from the firmware emulator and
+*        the HIF resource of every descriptor is returned.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static void halVirtTxReclaim(IN struct ADAPTER *prAdapter)
+{
+	struct GLUE_INFO *prGlueInfo = prAdapter->prGlueInfo;
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	struct VIRT_RING *prRing;
+	struct VIRT_DMAD *prDmad;
+	struct MSDU_INFO *prMsduInfo, *prNextMsdu;
+	struct QUE rDoneQue;
+	uint32_t au4PageCnt[TC_NUM] = {0};
+	uint32_t u4TxStatusCnt = 0;
+	uint8_t ucTC;
+	uint16_t i;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	QUEUE_INITIALIZE(&rDoneQue);
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	prRing = &prHifInfo->arTxRing[VIRT_TX_RING_DATA];
+	while (prRing->u4SwUsedIdx != prRing->u4DmaIdx) {
+		prDmad = &prRing->arDmad[prRing->u4SwUsedIdx];
+
+		prMsduInfo = (struct MSDU_INFO *) prDmad->pvPacket;
+		if (prDmad->u2MsduNum > 1) {
+			/* each MSDU of an A-MSDU took its own resource */
+			for (i = 0; i < prDmad->u2MsduNum && prMsduInfo;
+			     i++) {
+				prNextMsdu = (struct MSDU_INFO *)
+					QUEUE_GET_NEXT_ENTRY(
+					&prMsduInfo->rQueEntry);
+				if (prDmad->ucTC < TC_NUM)
+					au4PageCnt[prDmad->ucTC] +=
+						halTxGetDataPageCount(prAdapter,
+						prMsduInfo->u2FrameLength,
+						TRUE);
+				QUEUE_INSERT_TAIL(&rDoneQue,
+					(struct QUE_ENTRY *) prMsduInfo);
+				prMsduInfo = prNextMsdu;
+			}
+		} else {
+			if (prMsduInfo)
+				QUEUE_INSERT_TAIL(&rDoneQue,
+					(struct QUE_ENTRY *) prMsduInfo);
+			if (prDmad->ucTC < TC_NUM)
+				au4PageCnt[prDmad->ucTC] +=
+					halTxGetDataPageCount(prAdapter,
+					prDmad->u4Len, TRUE);
+		}
+		if (prDmad->fgTxStatus) {
+			kal_virt_fw_tx_status(prAdapter, prDmad->ucWlanIdx,
+				prDmad->ucPID);
+			u4TxStatusCnt++;
+		}
+
+		prDmad->pvPacket = NULL;
+		prDmad->fgTxStatus = FALSE;
+		prRing->u4SwUsedIdx = VIRT_RING_NEXT(prRing->u4SwUsedIdx);
+	}
+
+	/* Only runtime commands hold TC4 resource. Frames of the init
+	 * command port are returned by halTxPollingResource().
+	 */
+	prRing = &prHifInfo->arTxRing[VIRT_TX_RING_CMD];
+	while (prRing->u4SwUsedIdx != prRing->u4DmaIdx) {
+		prDmad = &prRing->arDmad[prRing->u4SwUsedIdx];
+
+		if (prDmad->pvPacket)
+			au4PageCnt[TC4_INDEX] += halTxGetCmdPageCount(
+				prAdapter, prDmad->u4Len, TRUE);
+		if (prDmad->fgTxStatus) {
+			kal_virt_fw_tx_status(prAdapter, prDmad->ucWlanIdx,
+				prDmad->ucPID);
+			u4TxStatusCnt++;
+		}
+
+		prDmad->pvPacket = NULL;
+		prDmad->fgTxStatus = FALSE;
+		prRing->u4SwUsedIdx = VIRT_RING_NEXT(prRing->u4SwUsedIdx);
+	}
+
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	for (ucTC = 0; ucTC < TC_NUM; ucTC++) {
+		if (au4PageCnt[ucTC])
+			nicTxReleaseResource_PSE(prAdapter, ucTC,
+				au4PageCnt[ucTC], TRUE);
+	}
+
+	if (QUEUE_IS_NOT_EMPTY(&rDoneQue))
+		nicTxMsduDoneCb(prGlueInfo, &rDoneQue);
+
+	if (u4TxStatusCnt)
+		kal_virt_raise_int(prAdapter, WHISR_RX1_DONE_INT);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Reset the virtual WFDMA device as a WFSYS reset would: every queued
+*        TX descriptor completes, RX rings are flushed and the firmware
+*        emulator goes back to ROM state.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static void halVirtResetDevice(IN struct ADAPTER *prAdapter)
+{
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	uint32_t i;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	for (i = 0; i < VIRT_TX_RING_NUM; i++)
+		prHifInfo->arTxRing[i].u4DmaIdx =
+			prHifInfo->arTxRing[i].u4CpuIdx;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	halVirtTxReclaim(prAdapter);
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	halVirtResetRings(prHifInfo);
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	kal_virt_fw_reset(prAdapter);
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Take the oldest frame of an RX ring.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+* @param ucRing         ENUM_VIRT_RX_RING
+* @param pucBuf         Buffer to copy the frame to
+* @param u4MaxLen       Size of pucBuf
+* @param pu4Len         Length of the frame copied
+*
+* @return (TRUE: a frame was copied, FALSE: the ring is empty)
+*/
+/*----------------------------------------------------------------------------*/
+static u_int8_t halVirtRxRingPop(IN struct ADAPTER *prAdapter,
+	IN uint8_t ucRing, OUT uint8_t *pucBuf, IN uint32_t u4MaxLen,
+	OUT uint32_t *pu4Len)
+{
+	struct VIRT_RING *prRing;
+	struct VIRT_DMAD *prDmad;
+	uint32_t u4Len = 0;
+	u_int8_t fgRet = FALSE;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	if (ucRing >= VIRT_RX_RING_NUM)
+		return FALSE;
+
+	prRing = &prAdapter->prGlueInfo->rHifInfo.arRxRing[ucRing];
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	if (prRing->u4CpuIdx != prRing->u4DmaIdx) {
+		prDmad = &prRing->arDmad[prRing->u4CpuIdx];
+		u4Len = prDmad->u4Len;
+		if (u4Len > u4MaxLen)
+			u4Len = u4MaxLen;
+		kalMemCopy(pucBuf, prDmad->pucBuf, u4Len);
+		prRing->u4CpuIdx = VIRT_RING_NEXT(prRing->u4CpuIdx);
+		fgRet = TRUE;
+	}
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	if (pu4Len)
+		*pu4Len = u4Len;
+
+	return fgRet;
+}
+
+static u_int8_t halVirtRxRingIsEmpty(IN struct ADAPTER *prAdapter,
+	IN uint8_t ucRing)
+{
+	struct VIRT_RING *prRing;
+	u_int8_t fgEmpty;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	prRing = &prAdapter->prGlueInfo->rHifInfo.arRxRing[ucRing];
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	fgEmpty = prRing->u4CpuIdx == prRing->u4DmaIdx;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	return fgEmpty;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Move the frames of an RX ring to rReceivedRfbList, the way
+*        halRxReceiveRFBs() does for WFDMA.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+* @param ucRing         ENUM_VIRT_RX_RING
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static void halVirtRxReceiveRFBs(IN struct ADAPTER *prAdapter,
+	IN uint8_t ucRing)
+{
+	struct RX_CTRL *prRxCtrl = &prAdapter->rRxCtrl;
+	struct RX_DESC_OPS_T *prRxDescOps;
+	struct SW_RFB *prSwRfb;
+	void *prRxStatus;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	prRxDescOps = prAdapter->chip_info->prRxDescOps;
+	ASSERT(RX_DESC_OPS_EXIST(prRxDescOps, get_pkt_type));
+	ASSERT(RX_DESC_OPS_EXIST(prRxDescOps, get_wlan_idx));
+
+	while (!halVirtRxRingIsEmpty(prAdapter, ucRing)) {
+		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+		QUEUE_REMOVE_HEAD(&prRxCtrl->rFreeSwRfbList,
+			prSwRfb, struct SW_RFB *);
+		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+
+		if (!prSwRfb) {
+			DBGLOG(RX, WARN, "No More RFB for P[%u]\n", ucRing);
+			prAdapter->u4NoMoreRfb |= BIT(ucRing);
+			return;
+		}
+
+		if (!halVirtRxRingPop(prAdapter, ucRing,
+			prSwRfb->pucRecvBuff, CFG_RX_MAX_PKT_SIZE, NULL)) {
+			KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+			QUEUE_INSERT_TAIL(&prRxCtrl->rFreeSwRfbList,
+				&prSwRfb->rQueEntry);
+			KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_FREE_QUE);
+			break;
+		}
+
+		prRxStatus = prSwRfb->prRxStatus;
+		prSwRfb->ucPacketType =
+			RX_DESC_OPS_FN(prRxDescOps, get_pkt_type)(prRxStatus);
+
+		if (prSwRfb->ucPacketType == RX_PKT_TYPE_MSDU_REPORT) {
+			nicRxProcessMsduReport(prAdapter, prSwRfb);
+			continue;
+		}
+
+		prSwRfb->ucStaRecIdx =
+			secGetStaIdxByWlanIdx(
+				prAdapter,
+				RX_DESC_OPS_FN(prRxDescOps, get_wlan_idx)(
+					prRxStatus));
+
+		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+		nicRxEnqueueReceivedRFB(prAdapter, prSwRfb);
+		RX_INC_CNT(prRxCtrl, RX_MPDU_TOTAL_COUNT);
+		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_RX_QUE);
+	}
+
+	prAdapter->u4NoMoreRfb &= ~BIT(ucRing);
+}
+
+u_int8_t kal_virt_cr_access(struct ADAPTER *ad, u_int8_t write,
+	uint32_t addr, uint32_t *value)
+{
+	struct GL_HIF_INFO *prHifInfo = &ad->prGlueInfo->rHifInfo;
+	uint32_t i;
+
+	for (i = 0; i < prHifInfo->u4CrNum; i++) {
+		if (prHifInfo->arCr[i].u4Addr == addr)
+			break;
+	}
+
+	if (!write) {
+		*value = i < prHifInfo->u4CrNum ?
+			prHifInfo->arCr[i].u4Value : 0;
+		return TRUE;
+	}
+
+	if (i == prHifInfo->u4CrNum) {
+		if (prHifInfo->u4CrNum >= VIRT_CR_NUM) {
+			DBGLOG(HAL, WARN, "No CR slot for 0x%08x\n", addr);
+			return FALSE;
+		}
+		prHifInfo->arCr[i].u4Addr = addr;
+		prHifInfo->u4CrNum++;
+	}
+	prHifInfo->arCr[i].u4Value = *value;
+
+	return TRUE;
+}
+
+u_int8_t kal_virt_rx_enqueue(struct ADAPTER *ad, uint8_t ring,
+	uint8_t *buf, uint32_t len)
+{
+	struct VIRT_RING *prRing;
+	struct VIRT_DMAD *prDmad;
+
+	if (ring >= VIRT_RX_RING_NUM)
+		return FALSE;
+
+	prRing = &ad->prGlueInfo->rHifInfo.arRxRing[ring];
+	prDmad = &prRing->arDmad[prRing->u4DmaIdx];
+
+	if (VIRT_RING_NEXT(prRing->u4DmaIdx) == prRing->u4CpuIdx ||
+	    !prDmad->pucBuf || len > VIRT_DMA_BUF_SIZE) {
+		prRing->u4DropCnt++;
+		return FALSE;
+	}
+
+	kalMemCopy(prDmad->pucBuf, buf, len);
+	prDmad->u4Len = len;
+	prRing->u4DmaIdx = VIRT_RING_NEXT(prRing->u4DmaIdx);
+	prRing->u4DoneCnt++;
+
+	return TRUE;
+}
+
+void kal_virt_raise_int(struct ADAPTER *ad, uint32_t bits)
+{
+	struct GL_HIF_INFO *prHifInfo = &ad->prGlueInfo->rHifInfo;
+	u_int8_t fgSignal = FALSE;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	prHifInfo->u4IntStatus |= bits;
+	/* level triggered, masked until halEnableInterrupt() */
+	if (prHifInfo->fgIntEnable && prHifInfo->u4IntStatus) {
+		prHifInfo->fgIntEnable = FALSE;
+		prHifInfo->u4IntRaiseCnt++;
+		fgSignal = TRUE;
+	}
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+
+	if (fgSignal)
+		kalSetIntEvent(ad->prGlueInfo);
+}
+
+u_int8_t kal_virt_inject_rx(struct ADAPTER *ad, uint8_t ring,
+	uint8_t *buf, uint32_t len)
+{
+	u_int8_t fgRet;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	if (ad->prGlueInfo->rHifInfo.fgTxRxStop)
+		fgRet = FALSE;
+	else
+		fgRet = kal_virt_rx_enqueue(ad, ring, buf, len);
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+
+	if (fgRet)
+		kal_virt_raise_int(ad, ring == VIRT_RX_RING_DATA ?
+			WHISR_RX0_DONE_INT : WHISR_RX1_DONE_INT);
+
+	return fgRet;
+}
+
+u_int8_t kalDevRegRead(IN struct GLUE_INFO *prGlueInfo,
+		       IN uint32_t u4Register,
+		       OUT uint32_t *pu4Value)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	kal_virt_cr_access(prAdapter, FALSE, u4Register, pu4Value);
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	return TRUE;
+}
+
+u_int8_t kalDevRegWrite(struct GLUE_INFO *prGlueInfo,
+			IN uint32_t u4Register,
+			IN uint32_t u4Value)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	u_int8_t fgRet;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	fgRet = kal_virt_cr_access(prAdapter, TRUE, u4Register, &u4Value);
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	return fgRet;
+}
+
+u_int8_t
+kalDevPortRead(IN struct GLUE_INFO *prGlueInfo,
+	       IN uint16_t u2Port, IN uint32_t u2Len, OUT uint8_t *pucBuf,
+	       IN uint32_t u2ValidOutBufSize)
+{
+	if (u2Len > u2ValidOutBufSize)
+		u2Len = u2ValidOutBufSize;
+
+	return halVirtRxRingPop(prGlueInfo->prAdapter, (uint8_t) u2Port,
+		pucBuf, u2Len, NULL);
+}
+
+u_int8_t
+kalDevPortWrite(struct GLUE_INFO *prGlueInfo,
+		IN uint16_t u2Port, IN uint32_t u2Len, IN uint8_t *pucBuf,
+		IN uint32_t u2ValidInBufSize)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	struct VIRT_RING *prRing = &prHifInfo->arTxRing[VIRT_TX_RING_CMD];
+	struct VIRT_DMAD *prDmad;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	if (u2Len > u2ValidInBufSize || u2Len > VIRT_DMA_BUF_SIZE) {
+		DBGLOG(HAL, ERROR, "Invalid port write len[%u]\n", u2Len);
+		return FALSE;
+	}
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	if (prHifInfo->fgTxRxStop || VIRT_RING_FULL(prRing) ||
+	    !prRing->arDmad[prRing->u4CpuIdx].pucBuf) {
+		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+		return FALSE;
+	}
+
+	prDmad = &prRing->arDmad[prRing->u4CpuIdx];
+	kalMemCopy(prDmad->pucBuf, pucBuf, u2Len);
+	prDmad->u4Len = u2Len;
+	prDmad->pvPacket = NULL;
+	prDmad->fgTxStatus = FALSE;
+	prRing->u4CpuIdx = VIRT_RING_NEXT(prRing->u4CpuIdx);
+
+	/* the device fetches the frame as soon as the CPU index moves */
+	kal_virt_fw_handle_init_cmd(prAdapter, prDmad->pucBuf, u2Len);
+	prRing->u4DmaIdx = prRing->u4CpuIdx;
+	prRing->u4DoneCnt++;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	/* Init commands are polled, keep the ring from filling up during
+	 * firmware download.
+	 */
+	halVirtTxReclaim(prAdapter);
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Fill one descriptor of the data ring. The caller holds
+*        SPIN_LOCK_VIRT_DEV.
+*
+* @param prHifInfo      Pointer to the HIF info structure.
+* @param prMsduInfo     The MSDU, or the head of an A-MSDU chain
+* @param u4Len          Length written, of the whole A-MSDU if aggregated
+* @param u2MsduNum      Number of MSDUs chained from prMsduInfo
+*
+* @return TRUE if there was a free descriptor
+*/
+/*----------------------------------------------------------------------------*/
+static u_int8_t halVirtWriteDataDesc(struct GL_HIF_INFO *prHifInfo,
+	struct MSDU_INFO *prMsduInfo, uint32_t u4Len, uint16_t u2MsduNum)
+{
+	struct VIRT_RING *prRing = &prHifInfo->arTxRing[VIRT_TX_RING_DATA];
+	struct VIRT_DMAD *prDmad;
+
+	if (prHifInfo->fgTxRxStop || VIRT_RING_FULL(prRing)) {
+		prRing->u4DropCnt += u2MsduNum;
+		return FALSE;
+	}
+
+	prDmad = &prRing->arDmad[prRing->u4CpuIdx];
+	prDmad->u4Len = u4Len;
+	prDmad->u2MsduNum = u2MsduNum;
+	prDmad->ucTC = prMsduInfo->ucTC;
+	/* A frame with a TX done handler waits in rTxMgmtTxingQueue for
+	 * its EVENT_ID_TX_DONE, anything else is returned on reclaim.
+	 */
+	if (prMsduInfo->pfTxDoneHandler) {
+		prDmad->pvPacket = NULL;
+		prDmad->ucWlanIdx = prMsduInfo->ucWlanIndex;
+		prDmad->ucPID = prMsduInfo->ucPID;
+		prDmad->fgTxStatus = TRUE;
+	} else {
+		prDmad->pvPacket = prMsduInfo;
+		prDmad->fgTxStatus = FALSE;
+	}
+	prRing->u4CpuIdx = VIRT_RING_NEXT(prRing->u4CpuIdx);
+
+	return TRUE;
+}
+
+/* Staging bucket of the MSDU's STA/TID, NULL if SW A-MSDU is off for it */
+static struct VIRT_AMSDU_BUCKET *halVirtGetAmsduBucket(
+	struct ADAPTER *prAdapter, struct MSDU_INFO *prMsduInfo,
+	struct STA_RECORD **pprStaRec)
+{
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	struct STA_RECORD *prStaRec;
+	uint8_t ucTid, ucStaRecIndex;
+
+	if (!prHifInfo->prAmsduBucket ||
+	    prAdapter->chip_info->ucMaxSwAmsduNum <= 1 ||
+	    prMsduInfo->ucPacketType != TX_PACKET_TYPE_DATA)
+		return NULL;
+
+	ucTid = prMsduInfo->ucUserPriority;
+	ucStaRecIndex = prMsduInfo->ucStaRecIndex;
+	if (ucStaRecIndex >= CFG_STA_REC_NUM || ucTid >= TX_DESC_TID_NUM)
+		return NULL;
+
+	prStaRec = cnmGetStaRecByIndex(prAdapter, ucStaRecIndex);
+	if (!prStaRec || !(prStaRec->ucAmsduEnBitmap & BIT(ucTid)) ||
+	    prStaRec->ucMaxMpduCount <= 1)
+		return NULL;
+
+	*pprStaRec = prStaRec;
+	return &prHifInfo->prAmsduBucket[
+		ucStaRecIndex * TX_DESC_TID_NUM + ucTid];
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Write a staged A-MSDU to the data ring as one descriptor. A bucket
+*        below u4MinMpduLen is written as single MSDUs.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+* @param prBucket       Staging bucket of one STA/TID
+*
+* @return (none)
+*/
+/*----------------------------------------------------------------------------*/
+static void halVirtCloseAmsdu(struct ADAPTER *prAdapter,
+	struct VIRT_AMSDU_BUCKET *prBucket)
+{
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	struct MSDU_INFO *prMsduInfo, *prNextMsdu;
+	struct STA_RECORD *prStaRec;
+	uint32_t u4Num = prBucket->rMsduQue.u4NumElem;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	if (u4Num == 0)
+		return;
+
+	prMsduInfo = (struct MSDU_INFO *) QUEUE_GET_HEAD(&prBucket->rMsduQue);
+	prStaRec = cnmGetStaRecByIndex(prAdapter, prMsduInfo->ucStaRecIndex);
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	if (u4Num > 1 && prStaRec &&
+	    prBucket->u2Size >= prStaRec->u4MinMpduLen) {
+		if (halVirtWriteDataDesc(prHifInfo, prMsduInfo,
+		    prBucket->u2Size, (uint16_t) u4Num)) {
+			prHifInfo->u4AmsduCnt++;
+			prHifInfo->u4AmsduMsduCnt += u4Num;
+		}
+	} else {
+		while (prMsduInfo) {
+			prNextMsdu = (struct MSDU_INFO *)
+				QUEUE_GET_NEXT_ENTRY(&prMsduInfo->rQueEntry);
+			halVirtWriteDataDesc(prHifInfo, prMsduInfo,
+				prMsduInfo->u2FrameLength, 1);
+			prMsduInfo = prNextMsdu;
+		}
+	}
+	prHifInfo->u4AmsduStagedCnt -= u4Num;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	QUEUE_INITIALIZE(&prBucket->rMsduQue);
+	prBucket->u2Size = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Stage a MSDU in the A-MSDU bucket of its STA/TID, by the rules of
+*        kalDevWriteDataByAmsdu() of the PDMA HIF. The bucket is closed
+*        once it reaches ucMaxMpduCount, or before the MSDU if it would
+*        exceed u4MaxMpduLen. A fixed rate or TX status MSDU closes the
+*        bucket and is written alone.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+* @param prMsduInfo     MSDU to stage
+* @param prBucket       Staging bucket of the MSDU's STA/TID
+* @param prStaRec       STA record of the MSDU
+*
+* @return TRUE if the MSDU was staged or written
+*/
+/*----------------------------------------------------------------------------*/
+static u_int8_t halVirtWriteAmsdu(struct ADAPTER *prAdapter,
+	struct MSDU_INFO *prMsduInfo, struct VIRT_AMSDU_BUCKET *prBucket,
+	struct STA_RECORD *prStaRec)
+{
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	uint16_t u2Size, u2Pad;
+	u_int8_t fgRet;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	if (prMsduInfo->pfTxDoneHandler ||
+	    prMsduInfo->ucRateMode != MSDU_RATE_MODE_AUTO) {
+		halVirtCloseAmsdu(prAdapter, prBucket);
+		KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+		fgRet = halVirtWriteDataDesc(prHifInfo, prMsduInfo,
+			prMsduInfo->u2FrameLength, 1);
+		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+		return fgRet;
+	}
+
+	/* the subframe carries LLC/SNAP in front of an Ethernet II payload */
+	u2Size = prMsduInfo->u2FrameLength;
+	if (!prMsduInfo->fgIs802_3)
+		u2Size += LLC_LEN;
+	u2Pad = (4 - (prBucket->u2Size & 3)) & 3;
+
+	if (QUEUE_IS_NOT_EMPTY(&prBucket->rMsduQue) &&
+	    prBucket->u2Size + u2Pad + u2Size > prStaRec->u4MaxMpduLen)
+		halVirtCloseAmsdu(prAdapter, prBucket);
+
+	if (QUEUE_IS_EMPTY(&prBucket->rMsduQue)) {
+		u2Size += NIC_TX_DESC_LONG_FORMAT_LENGTH;
+		if (!prBucket->fgQueued) {
+			QUEUE_INSERT_TAIL(&prHifInfo->rAmsduOpenQue,
+				&prBucket->rQueEntry);
+			prBucket->fgQueued = TRUE;
+		}
+	} else
+		u2Size += u2Pad;
+
+	QUEUE_INSERT_TAIL(&prBucket->rMsduQue,
+		(struct QUE_ENTRY *) prMsduInfo);
+	prBucket->u2Size += u2Size;
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	prHifInfo->u4AmsduStagedCnt++;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	if (prBucket->rMsduQue.u4NumElem >= prStaRec->ucMaxMpduCount)
+		halVirtCloseAmsdu(prAdapter, prBucket);
+
+	return TRUE;
+}
+
+u_int8_t kalDevWriteData(IN struct GLUE_INFO *prGlueInfo,
+			 IN struct MSDU_INFO *prMsduInfo)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	struct VIRT_AMSDU_BUCKET *prBucket;
+	struct STA_RECORD *prStaRec = NULL;
+	u_int8_t fgRet;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	prBucket = halVirtGetAmsduBucket(prAdapter, prMsduInfo, &prStaRec);
+	if (prBucket)
+		return halVirtWriteAmsdu(prAdapter, prMsduInfo, prBucket,
+			prStaRec);
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	fgRet = halVirtWriteDataDesc(&prGlueInfo->rHifInfo, prMsduInfo,
+		prMsduInfo->u2FrameLength, 1);
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	return fgRet;
+}
+
+u_int8_t kalDevWriteCmd(IN struct GLUE_INFO *prGlueInfo,
+			IN struct CMD_INFO *prCmdInfo, IN uint8_t ucTC)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	struct GL_HIF_INFO *prHifInfo = &prGlueInfo->rHifInfo;
+	struct VIRT_RING *prRing = &prHifInfo->arTxRing[VIRT_TX_RING_CMD];
+	struct VIRT_DMAD *prDmad;
+	struct MSDU_INFO *prMsduInfo = NULL;
+	uint32_t u4TotalLen, u4EvtCnt;
+	u_int8_t fgEvent;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	u4TotalLen = prCmdInfo->u4TxdLen + prCmdInfo->u4TxpLen;
+	if (u4TotalLen > VIRT_DMA_BUF_SIZE) {
+		DBGLOG(HAL, ERROR, "CID[0x%x] len[%u] over DMA buffer\n",
+			prCmdInfo->ucCID, u4TotalLen);
+		return FALSE;
+	}
+
+	if (prCmdInfo->eCmdType == COMMAND_TYPE_SECURITY_FRAME ||
+	    prCmdInfo->eCmdType == COMMAND_TYPE_MANAGEMENT_FRAME)
+		prMsduInfo = prCmdInfo->prMsduInfo;
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	if (prHifInfo->fgTxRxStop || VIRT_RING_FULL(prRing) ||
+	    !prRing->arDmad[prRing->u4CpuIdx].pucBuf) {
+		KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+		return FALSE;
+	}
+
+	prDmad = &prRing->arDmad[prRing->u4CpuIdx];
+	kalMemCopy(prDmad->pucBuf, prCmdInfo->pucTxd, prCmdInfo->u4TxdLen);
+	if (prCmdInfo->u4TxpLen)
+		kalMemCopy(prDmad->pucBuf + prCmdInfo->u4TxdLen,
+			prCmdInfo->pucTxp, prCmdInfo->u4TxpLen);
+	prDmad->u4Len = u4TotalLen;
+	/* only marks the TC4 resource, CMD_INFO may be gone on reclaim */
+	prDmad->pvPacket = prCmdInfo;
+	prDmad->fgTxStatus = FALSE;
+	if (prMsduInfo && prMsduInfo->pfTxDoneHandler) {
+		prDmad->ucWlanIdx = prMsduInfo->ucWlanIndex;
+		prDmad->ucPID = prMsduInfo->ucPID;
+		prDmad->fgTxStatus = TRUE;
+	}
+	prRing->u4CpuIdx = VIRT_RING_NEXT(prRing->u4CpuIdx);
+
+	u4EvtCnt = prHifInfo->rFw.u4EvtCnt;
+	if (!prMsduInfo)
+		kal_virt_fw_handle_cmd(prAdapter, prDmad->pucBuf, u4TotalLen);
+	fgEvent = prHifInfo->rFw.u4EvtCnt != u4EvtCnt;
+
+	prRing->u4DmaIdx = prRing->u4CpuIdx;
+	prRing->u4DoneCnt++;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	kal_virt_raise_int(prAdapter, WHISR_TX_DONE_INT |
+		(fgEvent ? WHISR_RX1_DONE_INT : 0));
+
+	return TRUE;
+}
+
+u_int8_t kalDevKickData(IN struct GLUE_INFO *prGlueInfo)
+{
+	struct ADAPTER *prAdapter = prGlueInfo->prAdapter;
+	struct GL_HIF_INFO *prHifInfo;
+	struct VIRT_AMSDU_BUCKET *prBucket;
+	struct QUE_ENTRY *prQueueEntry;
+	struct VIRT_RING *prRing;
+	u_int8_t fgDone = FALSE;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	prHifInfo = &prGlueInfo->rHifInfo;
+	prRing = &prHifInfo->arTxRing[VIRT_TX_RING_DATA];
+
+	/* the kick ends the TX batch, flush partially filled buckets */
+	while (QUEUE_IS_NOT_EMPTY(&prHifInfo->rAmsduOpenQue)) {
+		QUEUE_REMOVE_HEAD(&prHifInfo->rAmsduOpenQue, prQueueEntry,
+			struct QUE_ENTRY *);
+		prBucket = (struct VIRT_AMSDU_BUCKET *) prQueueEntry;
+		prBucket->fgQueued = FALSE;
+		halVirtCloseAmsdu(prAdapter, prBucket);
+	}
+
+	/* the doorbell: everything up to the CPU index is sent at once */
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	if (prRing->u4DmaIdx != prRing->u4CpuIdx) {
+		prRing->u4DoneCnt += (prRing->u4CpuIdx + VIRT_RING_SIZE -
+			prRing->u4DmaIdx) % VIRT_RING_SIZE;
+		prRing->u4DmaIdx = prRing->u4CpuIdx;
+		fgDone = TRUE;
+	}
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	if (fgDone)
+		kal_virt_raise_int(prAdapter, WHISR_TX_DONE_INT);
+
+	return TRUE;
+}
+
+void kalDevReadIntStatus(IN struct ADAPTER *prAdapter,
+			 OUT uint32_t *pu4IntStatus)
+{
+	kal_virt_get_int_status(prAdapter, pu4IntStatus);
+}
+
 void kal_virt_write_tx_port(struct ADAPTER *ad,
 	uint16_t pid, uint32_t len, uint8_t *buf, uint32_t buf_size)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	if (!kalDevPortWrite(ad->prGlueInfo, pid, len, buf, buf_size))
+		DBGLOG(HAL, ERROR, "Write port[%u] len[%u] fail\n", pid, len);
 }
 
 void kal_virt_get_wifi_func_stat(struct ADAPTER *ad, uint32_t *res)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	*res = ad->prGlueInfo->rHifInfo.rFw.eState;
 }
 
 void kal_virt_chk_wifi_func_off(struct ADAPTER *ad, uint32_t ready_bits,
 	uint8_t *res)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	*res = ad->prGlueInfo->rHifInfo.rFw.eState != VIRT_FW_STATE_RAM;
 }
 
 void kal_virt_chk_wifi_func_ready(struct ADAPTER *ad, uint32_t ready_bits,
 	uint8_t *res)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	*res = ad->prGlueInfo->rHifInfo.rFw.eState == VIRT_FW_STATE_RAM;
 }
 
 void kal_virt_set_mailbox_readclear(struct ADAPTER *ad, bool enable)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	/* no mailbox on the virtual device */
 }
 
 void kal_virt_set_int_stat_readclear(struct ADAPTER *ad)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	/* interrupt status is always read clear */
 }
 
 void kal_virt_init_hif(struct ADAPTER *ad)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	struct GL_HIF_INFO *prHifInfo = &ad->prGlueInfo->rHifInfo;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	halVirtResetRings(prHifInfo);
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+}
+
+void kal_virt_power_on(struct ADAPTER *ad)
+{
+	struct mt66xx_chip_info *prChipInfo = ad->chip_info;
+	struct GL_HIF_INFO *prHifInfo = &ad->prGlueInfo->rHifInfo;
+	uint32_t u4Value;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	halVirtResetRings(prHifInfo);
+	prHifInfo->fgIntEnable = FALSE;
+	prHifInfo->u4CrNum = 0;
+
+	/* power on values read by halVerifyChipID(), PCIe chips keep the
+	 * revision in the chip ID register
+	 */
+	if (prChipInfo->top_hvr != prChipInfo->top_hcr) {
+		u4Value = 0;
+		kal_virt_cr_access(ad, TRUE, prChipInfo->top_hvr, &u4Value);
+	}
+	u4Value = prChipInfo->chip_id;
+	kal_virt_cr_access(ad, TRUE, prChipInfo->top_hcr, &u4Value);
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+
+	kal_virt_fw_reset(ad);
 }
 
 void kal_virt_enable_fwdl(struct ADAPTER *ad, bool enable)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	ad->prGlueInfo->rHifInfo.fgFwDlEnable = enable;
 }
 
 void kal_virt_get_int_status(struct ADAPTER *ad, uint32_t *status)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__);
+	struct GL_HIF_INFO *prHifInfo = &ad->prGlueInfo->rHifInfo;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	*status = prHifInfo->u4IntStatus;
+	prHifInfo->u4IntStatus = 0;
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
 }
 
 void kal_virt_uhw_rd(struct ADAPTER *ad, uint32_t u4Offset, uint32_t *pu4Value,
 		     u_int8_t *pfgSts)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, ad, u4Offset, pu4Value, pfgSts);
+	u_int8_t fgSts;
+
+	fgSts = kalDevRegRead(ad->prGlueInfo, u4Offset, pu4Value);
+	if (pfgSts)
+		*pfgSts = fgSts;
 }
 
 void kal_virt_uhw_wr(struct ADAPTER *ad, uint32_t u4Offset, uint32_t u4Value,
 		     u_int8_t *pfgSts)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, ad, u4Offset, u4Value, pfgSts);
+	u_int8_t fgSts;
+
+	fgSts = kalDevRegWrite(ad->prGlueInfo, u4Offset, u4Value);
+	if (pfgSts)
+		*pfgSts = fgSts;
 }
 
 void kal_virt_cancel_tx_rx(struct ADAPTER *ad)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, ad);
+	ad->prGlueInfo->rHifInfo.fgTxRxStop = TRUE;
 }
 
 void kal_virt_resume_tx_rx(struct ADAPTER *ad)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, ad);
+	ad->prGlueInfo->rHifInfo.fgTxRxStop = FALSE;
 }
 
 uint32_t kal_virt_toggle_wfsys_rst(struct ADAPTER *ad)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, ad);
+	halVirtResetDevice(ad);
+
+	return WLAN_STATUS_SUCCESS;
 }
 
 /* the following functions are defined in include/nic/hal.h
@@ -194,179 +1074,374 @@ uint32_t kal_virt_toggle_wfsys_rst(struct ADAPTER *ad)
  */
 bool halHifSwInfoInit(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	halVirtResetRings(prHifInfo);
+	prHifInfo->fgIntEnable = FALSE;
+	prHifInfo->fgTxRxStop = FALSE;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	kal_virt_fw_reset(prAdapter);
+
+	return TRUE;
 }
 
 void halPrintHifDbgInfo(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	halDumpHifStatus(prAdapter, NULL, 0);
 }
 
 uint32_t halHifPowerOffWifi(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	prAdapter->prGlueInfo->rHifInfo.rFw.eState = VIRT_FW_STATE_OFF;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	return WLAN_STATUS_SUCCESS;
 }
 
 void halTxResourceResetHwTQCounter(struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
 }
 
 uint32_t halDumpHifStatus(struct ADAPTER *prAdapter,
 	uint8_t *pucBuf, uint32_t u4Max)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	struct VIRT_RING *prRing;
+	struct VIRT_FW *prFw = &prHifInfo->rFw;
+	uint32_t u4Len = 0;
+	uint32_t i;
+
+	LOGBUF(pucBuf, u4Max, u4Len, "\n");
+	for (i = 0; i < VIRT_TX_RING_NUM; i++) {
+		prRing = &prHifInfo->arTxRing[i];
+		LOGBUF(pucBuf, u4Max, u4Len,
+			"TX%u CPU[%u] DMA[%u] SW[%u] DONE[%u] DROP[%u]\n", i,
+			prRing->u4CpuIdx, prRing->u4DmaIdx,
+			prRing->u4SwUsedIdx, prRing->u4DoneCnt,
+			prRing->u4DropCnt);
+	}
+	for (i = 0; i < VIRT_RX_RING_NUM; i++) {
+		prRing = &prHifInfo->arRxRing[i];
+		LOGBUF(pucBuf, u4Max, u4Len,
+			"RX%u CPU[%u] DMA[%u] DONE[%u] DROP[%u]\n", i,
+			prRing->u4CpuIdx, prRing->u4DmaIdx,
+			prRing->u4DoneCnt, prRing->u4DropCnt);
+	}
+	LOGBUF(pucBuf, u4Max, u4Len, "AMSDU[%u] MSDU[%u] STAGED[%u]\n",
+		prHifInfo->u4AmsduCnt, prHifInfo->u4AmsduMsduCnt,
+		prHifInfo->u4AmsduStagedCnt);
+	LOGBUF(pucBuf, u4Max, u4Len, "INT[0x%08x] EN[%u] RAISE[%u]\n",
+		prHifInfo->u4IntStatus, prHifInfo->fgIntEnable,
+		prHifInfo->u4IntRaiseCnt);
+	LOGBUF(pucBuf, u4Max, u4Len,
+		"FW state[%u] INIT[%u] DL[%u] CMD[%u] EVT[%u] TXS[%u]\n",
+		prFw->eState, prFw->u4InitCmdCnt, prFw->u4DlBytes,
+		prFw->u4CmdCnt, prFw->u4EvtCnt, prFw->u4TxStatusCnt);
+
+	return u4Len;
 }
 
 uint32_t halGetValidCoalescingBufSize(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	uint32_t u4BufSize;
+
+	if (HIF_TX_COALESCING_BUFFER_SIZE > HIF_RX_COALESCING_BUFFER_SIZE)
+		u4BufSize = HIF_TX_COALESCING_BUFFER_SIZE;
+	else
+		u4BufSize = HIF_RX_COALESCING_BUFFER_SIZE;
+
+	return u4BufSize;
 }
 
 uint32_t halAllocateIOBuffer(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	struct VIRT_RING *prRing;
+	uint32_t i, j, u4Num = CFG_STA_REC_NUM * TX_DESC_TID_NUM;
+
+	if (!prHifInfo->prAmsduBucket) {
+		QUEUE_INITIALIZE(&prHifInfo->rAmsduOpenQue);
+		prHifInfo->prAmsduBucket = kalMemAlloc(
+			sizeof(struct VIRT_AMSDU_BUCKET) * u4Num, VIR_MEM_TYPE);
+		if (prHifInfo->prAmsduBucket) {
+			kalMemZero(prHifInfo->prAmsduBucket,
+				sizeof(struct VIRT_AMSDU_BUCKET) * u4Num);
+			for (i = 0; i < u4Num; i++)
+				QUEUE_INITIALIZE(
+					&prHifInfo->prAmsduBucket[i].rMsduQue);
+		} else
+			DBGLOG(HAL, WARN, "SW A-MSDU disabled, no memory\n");
+	}
+
+	/* TX data descriptors point at MSDU_INFO and need no buffer */
+	for (i = VIRT_TX_RING_CMD; i < VIRT_TX_RING_NUM + VIRT_RX_RING_NUM;
+	     i++) {
+		if (i < VIRT_TX_RING_NUM)
+			prRing = &prHifInfo->arTxRing[i];
+		else
+			prRing = &prHifInfo->arRxRing[i - VIRT_TX_RING_NUM];
+
+		if (prRing->pucBufPool)
+			continue;
+
+		prRing->pucBufPool = kalMemAlloc(
+			VIRT_RING_SIZE * VIRT_DMA_BUF_SIZE, VIR_MEM_TYPE);
+		if (!prRing->pucBufPool) {
+			DBGLOG(HAL, ERROR, "Alloc ring[%u] buffer fail\n", i);
+			halReleaseIOBuffer(prAdapter);
+			return WLAN_STATUS_RESOURCES;
+		}
+
+		for (j = 0; j < VIRT_RING_SIZE; j++)
+			prRing->arDmad[j].pucBuf =
+				prRing->pucBufPool + j * VIRT_DMA_BUF_SIZE;
+	}
+
+	return WLAN_STATUS_SUCCESS;
 }
 
 uint32_t halReleaseIOBuffer(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	struct VIRT_RING *prRing;
+	uint32_t i, j;
+
+	if (prHifInfo->prAmsduBucket) {
+		kalMemFree(prHifInfo->prAmsduBucket, VIR_MEM_TYPE,
+			sizeof(struct VIRT_AMSDU_BUCKET) *
+			CFG_STA_REC_NUM * TX_DESC_TID_NUM);
+		prHifInfo->prAmsduBucket = NULL;
+	}
+
+	for (i = 0; i < VIRT_TX_RING_NUM + VIRT_RX_RING_NUM; i++) {
+		if (i < VIRT_TX_RING_NUM)
+			prRing = &prHifInfo->arTxRing[i];
+		else
+			prRing = &prHifInfo->arRxRing[i - VIRT_TX_RING_NUM];
+
+		if (!prRing->pucBufPool)
+			continue;
+
+		kalMemFree(prRing->pucBufPool, VIR_MEM_TYPE,
+			VIRT_RING_SIZE * VIRT_DMA_BUF_SIZE);
+		prRing->pucBufPool = NULL;
+		for (j = 0; j < VIRT_RING_SIZE; j++)
+			prRing->arDmad[j].pucBuf = NULL;
+	}
+
+	return WLAN_STATUS_SUCCESS;
 }
 
 void halDisableInterrupt(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	prAdapter->prGlueInfo->rHifInfo.fgIntEnable = FALSE;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	prAdapter->fgIsIntEnable = FALSE;
 }
 
 void halEnableInterrupt(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+	prAdapter->prGlueInfo->rHifInfo.fgIntEnable = TRUE;
+	KAL_RELEASE_SPIN_LOCK(prAdapter, SPIN_LOCK_VIRT_DEV);
+
+	prAdapter->fgIsIntEnable = TRUE;
+
+	/* status asserted while masked fires right away */
+	kal_virt_raise_int(prAdapter, 0);
 }
 
 u_int8_t halVerifyChipID(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	uint32_t u4CIR = 0;
+	struct mt66xx_chip_info *prChipInfo;
+
+	if (prAdapter == NULL) {
+		DBGLOG(HAL, ERROR, "prAdapter is NULL error\n");
+		return FALSE;
+	}
+
+	if (prAdapter->fgIsReadRevID)
+		return TRUE;
+
+	prChipInfo = prAdapter->chip_info;
+
+	HAL_MCR_RD(prAdapter, prChipInfo->top_hcr, &u4CIR);
+	DBGLOG(INIT, TRACE, "Chip ID: 0x%4x\n", u4CIR);
+
+	if (u4CIR != prChipInfo->chip_id)
+		return FALSE;
+
+	HAL_MCR_RD(prAdapter, prChipInfo->top_hvr, &u4CIR);
+	DBGLOG(INIT, TRACE, "Revision ID: 0x%4x\n", u4CIR);
+
+	prAdapter->ucRevID = (uint8_t) (u4CIR & 0xF);
+	prAdapter->fgIsReadRevID = TRUE;
+	return TRUE;
 }
 
 void halProcessAbnormalInterrupt(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
 }
 
 void halProcessSoftwareInterrupt(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
 }
 
 void halProcessRxInterrupt(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	halVirtRxReceiveRFBs(prAdapter, VIRT_RX_RING_DATA);
+	halVirtRxReceiveRFBs(prAdapter, VIRT_RX_RING_EVT);
 }
 
 void halProcessTxInterrupt(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	halVirtTxReclaim(prAdapter);
+
+#if CFG_SUPPORT_MULTITHREAD
+	if (!QUEUE_IS_EMPTY(&prAdapter->rTxCmdQueue))
+		kalSetTxCmdEvent2Hif(prAdapter->prGlueInfo);
+#endif
 }
 
 void halSerHifReset(IN struct ADAPTER *prAdapter)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	halVirtResetDevice(prAdapter);
 }
 
 u_int8_t halIsTxResourceControlEn(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	return TRUE;
 }
 
 uint32_t halTxPollingResource(IN struct ADAPTER *prAdapter, IN uint8_t ucTC)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	halVirtTxReclaim(prAdapter);
+	/* init commands hold no descriptor, return their page as WFDMA */
+	nicTxReleaseResource(prAdapter, ucTC, 1, TRUE, FALSE);
+	return WLAN_STATUS_SUCCESS;
 }
+
 static uint32_t halGetHifTxPageSize(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	return HIF_TX_PAGE_SIZE;
 }
 
 uint32_t halGetHifTxDataPageSize(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	return halGetHifTxPageSize(prAdapter);
 }
 
 uint32_t halGetHifTxCmdPageSize(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	return halGetHifTxPageSize(prAdapter);
 }
 
 u_int32_t halTxGetFreeCmdCnt(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	struct VIRT_RING *prRing;
+	u_int32_t u4Used;
+
+	prRing = &prAdapter->prGlueInfo->rHifInfo.arTxRing[VIRT_TX_RING_CMD];
+	u4Used = (prRing->u4CpuIdx + VIRT_RING_SIZE - prRing->u4SwUsedIdx) %
+		VIRT_RING_SIZE;
+
+	return VIRT_RING_SIZE - 1 - u4Used;
 }
 
 u_int8_t halTxIsDataBufEnough(struct ADAPTER *prAdapter,
 	struct MSDU_INFO *prMsduInfo)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	struct GL_HIF_INFO *prHifInfo = &prAdapter->prGlueInfo->rHifInfo;
+	struct VIRT_RING *prRing = &prHifInfo->arTxRing[VIRT_TX_RING_DATA];
+
+	/* a staged MSDU may still need a descriptor of its own */
+	return VIRT_RING_FREE(prRing) > prHifInfo->u4AmsduStagedCnt;
 }
 
 static uint32_t halTxGetPageCount(IN struct ADAPTER *prAdapter,
 	IN uint32_t u4FrameLength, IN u_int8_t fgIncludeDesc)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	/* one descriptor per frame, as WFDMA */
+	return 1;
 }
 
 uint32_t halTxGetDataPageCount(IN struct ADAPTER *prAdapter,
 	IN uint32_t u4FrameLength, IN u_int8_t fgIncludeDesc)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	return halTxGetPageCount(prAdapter, u4FrameLength, fgIncludeDesc);
 }
 
 uint32_t halTxGetCmdPageCount(IN struct ADAPTER *prAdapter,
 	IN uint32_t u4FrameLength, IN u_int8_t fgIncludeDesc)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	return halTxGetPageCount(prAdapter, u4FrameLength, fgIncludeDesc);
 }
 
 void halTxCancelSendingCmd(struct ADAPTER *prAdapter,
 	struct CMD_INFO *prCmdInfo)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	/* commands are consumed by the device when written */
 }
 
 void halRxProcessMsduReport(IN struct ADAPTER *prAdapter,
 			    IN OUT struct SW_RFB *prSwRfb)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	/* MSDUs complete on TX done, the virtual device sends no report */
 }
 
 u_int8_t halIsPendingRx(IN struct ADAPTER *prAdapter)
 {
-	/* TODO: check pending Rx
-	 * if previous Rx handling is break due to lack of SwRfb
-	 */
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	/* previous Rx handling is break due to lack of SwRfb */
+	if (!prAdapter->u4NoMoreRfb)
+		return FALSE;
+
+	return !halVirtRxRingIsEmpty(prAdapter, VIRT_RX_RING_DATA) ||
+		!halVirtRxRingIsEmpty(prAdapter, VIRT_RX_RING_EVT);
 }
 
 uint32_t
 halRxWaitResponse(struct ADAPTER *prAdapter, uint8_t ucPortIdx,
 	uint8_t *pucRspBuffer, uint32_t u4MaxRespBufferLen, uint32_t *pu4Length)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	/* The device answers synchronously, so the event is there already.
+	 * All events use the event ring whatever ucPortIdx says.
+	 */
+	if (!halVirtRxRingPop(prAdapter, VIRT_RX_RING_EVT, pucRspBuffer,
+			      u4MaxRespBufferLen, pu4Length))
+		return WLAN_STATUS_FAILURE;
+
+	return WLAN_STATUS_SUCCESS;
 }
 
 void halSetFWOwn(IN struct ADAPTER *prAdapter, IN u_int8_t fgEnableGlobalInt)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	prAdapter->fgIsFwOwn = TRUE;
 }
 
 u_int8_t halSetDriverOwn(IN struct ADAPTER *prAdapter)
 {
-	return KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	prAdapter->fgIsFwOwn = FALSE;
+	return TRUE;
 }
 
 uint8_t halTxRingDataSelect(IN struct ADAPTER *prAdapter,
 	IN struct MSDU_INFO *prMsduInfo)
 {
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	return VIRT_TX_RING_DATA;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -380,7 +1455,49 @@ uint8_t halTxRingDataSelect(IN struct ADAPTER *prAdapter,
 /*----------------------------------------------------------------------------*/
 bool halIsHifStateSuspend(IN struct ADAPTER *prAdapter)
 {
-	/* HIF owner should implement this function */
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, prAdapter);
+	/* the virtual device never suspends */
+	return FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Check if HIF is ready to accept driver requests
+*
+* @param prAdapter      Pointer to the Adapter structure.
+* @param pucState       Suspend state, always 0 for the virtual device.
+*
+* @return (TRUE: ready. FALSE: card is not ready)
+*/
+/*----------------------------------------------------------------------------*/
+bool halIsHifStateReady(IN struct ADAPTER *prAdapter, uint8_t *pucState)
+{
+	if (!prAdapter || !prAdapter->prGlueInfo)
+		return FALSE;
+
+	if (pucState)
+		*pucState = 0;
+
+	return prAdapter->prGlueInfo->u4ReadyFlag != 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Return the MSDU of a TX free-done token
+*
+*        The virtual device completes MSDUs on TX ring reclaim and never
+*        reports tokens, so a free-done token is always unknown here.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+* @param u4Token        Token reported by the free-done event.
+* @param prFreeQueue    Queue collecting the MSDUs to free.
+*
+* @return (TRUE: MSDU returned. FALSE: unknown token)
+*/
+/*----------------------------------------------------------------------------*/
+u_int8_t halProcessToken(IN struct ADAPTER *prAdapter,
+	IN uint32_t u4Token,
+	IN struct QUE *prFreeQueue)
+{
+	DBGLOG(HAL, WARN, "Unexpected TX free-done token %u\n", u4Token);
 	return FALSE;
 }
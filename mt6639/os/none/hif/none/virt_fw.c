@@ -0,0 +1,573 @@
+/****************************************************************************
+ *
+ * This file is provided under a dual license.  When you use or
+ * distribute this software, you may choose to be licensed under
+ * version 2 of the GNU General Public License ("GPLv2 License")
+ * or BSD License.
+ *
+ * GPLv2 License
+ *
+ * Copyright(C) 2016 MediaTek Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of version 2 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See http://www.gnu.org/licenses/gpl-2.0.html for more details.
+ *
+ * BSD LICENSE
+ *
+ * Copyright(C) 2016 MediaTek Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  * Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+/****************************************************************************
+ *[File]             virt_fw.c
+ *[Version]          v1.0
+ *[Revision Date]    2010-03-01
+ *[Author]
+ *[Description]
+ *    The program provides the firmware emulator of the virtual WFDMA device
+ *[Copyright]
+ *    Copyright (C) 2010 MediaTek Incorporation. All Rights Reserved.
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *                         C O M P I L E R   F L A G S
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                    E X T E R N A L   R E F E R E N C E S
+ *****************************************************************************
+ */
+
+#include "gl_os.h"
+
+#include "precomp.h"
+
+#include "hif.h"
+
+/*****************************************************************************
+ *                              C O N S T A N T S
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                             D A T A   T Y P E S
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                            P U B L I C   D A T A
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                           P R I V A T E   D A T A
+ *****************************************************************************
+ */
+
+
+/*****************************************************************************
+ *                                 M A C R O S
+ *****************************************************************************
+ */
+
+/*****************************************************************************
+ *                   F U N C T I O N   D E C L A R A T I O N S
+ *****************************************************************************
+ */
+
+
+/*****************************************************************************
+ *                              F U N C T I O N S
+ *****************************************************************************
+ */
+
+/*----------------------------------------------------------------------------*/
+/*!
+* @brief Build an event frame in the event buffer of the emulator: the RX
+*        descriptor of a SW event, an event header of u4HdrLen bytes left
+*        to the caller and the payload.
+*
+* @param prAdapter      Pointer to the Adapter structure.
+* @param u4HdrLen       Length of the event header
+* @param pucBuf         Payload, NULL for zero filled
+* @param u2Len          Payload length
+* @param pu4Len         Length of the whole frame
+*
+* @return Pointer to the event header
+*/
+/*----------------------------------------------------------------------------*/
+static uint8_t *halVirtFwFillEvent(IN struct ADAPTER *prAdapter,
+	IN uint32_t u4HdrLen, IN const uint8_t *pucBuf, IN uint16_t u2Len,
+	OUT uint32_t *pu4Len)
+{
+	struct mt66xx_chip_info *prChipInfo = prAdapter->chip_info;
+	struct VIRT_FW *prFw = &prAdapter->prGlueInfo->rHifInfo.rFw;
+	uint8_t *pucEvt = prFw->aucEvtBuf;
+	uint32_t u4Len;
+
+	if (prChipInfo->rxd_size + u4HdrLen + u2Len > VIRT_DMA_BUF_SIZE)
+		u2Len = VIRT_DMA_BUF_SIZE - prChipInfo->rxd_size - u4HdrLen;
+	u4Len = prChipInfo->rxd_size + u4HdrLen + u2Len;
+
+	kalMemZero(pucEvt, u4Len);
+	/* RXD DW0: byte count and SW event packet type */
+	*(uint32_t *) pucEvt = u4Len |
+		((uint32_t) prChipInfo->u2RxSwPktEvent << 16);
+	if (pucBuf)
+		kalMemCopy(pucEvt + prChipInfo->rxd_size + u4HdrLen,
+			pucBuf, u2Len);
+
+	*pu4Len = u4Len;
+	return pucEvt + prChipInfo->rxd_size;
+}
+
+static void halVirtFwPostEvent(IN struct ADAPTER *prAdapter,
+	IN uint32_t u4Len)
+{
+	struct VIRT_FW *prFw = &prAdapter->prGlueInfo->rHifInfo.rFw;
+
+	if (kal_virt_rx_enqueue(prAdapter, VIRT_RX_RING_EVT,
+				prFw->aucEvtBuf, u4Len))
+		prFw->u4EvtCnt++;
+	else
+		DBGLOG(HAL, WARN, "Event ring full, drop event\n");
+}
+
+static void halVirtFwSendInitEvent(IN struct ADAPTER *prAdapter,
+	IN uint8_t ucEID, IN uint8_t ucSeqNum, IN const void *pvBuf,
+	IN uint16_t u2Len)
+{
+	struct mt66xx_chip_info *prChipInfo = prAdapter->chip_info;
+	struct INIT_WIFI_EVENT *prInitEvent;
+	uint32_t u4Len;
+
+	prInitEvent = (struct INIT_WIFI_EVENT *) halVirtFwFillEvent(prAdapter,
+		prChipInfo->init_event_size, pvBuf, u2Len, &u4Len);
+	prInitEvent->u2RxByteCount = u4Len - prChipInfo->rxd_size;
+	prInitEvent->u2PacketType = EVENT_PACKET_TYPE;
+	prInitEvent->ucEID = ucEID;
+	prInitEvent->ucSeqNum = ucSeqNum;
+
+	halVirtFwPostEvent(prAdapter, u4Len);
+}
+
+static void halVirtFwSendEvent(IN struct ADAPTER *prAdapter,
+	IN uint8_t ucEID, IN uint8_t ucSeqNum, IN const void *pvBuf,
+	IN uint16_t u2Len)
+{
+	struct mt66xx_chip_info *prChipInfo = prAdapter->chip_info;
+	struct WIFI_EVENT *prEvent;
+	uint32_t u4Len;
+
+	/* not event_hdr_size, CONNAC3X chips leave it 0 */
+	prEvent = (struct WIFI_EVENT *) halVirtFwFillEvent(prAdapter,
+		sizeof(struct WIFI_EVENT), pvBuf, u2Len, &u4Len);
+	prEvent->u2PacketLength = u4Len - prChipInfo->rxd_size;
+	prEvent->u2PacketType = EVENT_PACKET_TYPE;
+	prEvent->ucEID = ucEID;
+	prEvent->ucSeqNum = ucSeqNum;
+
+	halVirtFwPostEvent(prAdapter, u4Len);
+}
+
+#ifdef CFG_SUPPORT_UNIFIED_COMMAND
+static void halVirtFwSendUniEvent(IN struct ADAPTER *prAdapter,
+	IN uint16_t u2CID, IN uint8_t ucEID, IN uint8_t ucSeqNum,
+	IN const void *pvBuf, IN uint16_t u2Len)
+{
+	struct mt66xx_chip_info *prChipInfo = prAdapter->chip_info;
+	struct WIFI_UNI_EVENT *prEvent;
+	struct UNI_EVENT_CMD_RESULT *prCmdResult;
+	uint32_t u4Len;
+
+	prEvent = (struct WIFI_UNI_EVENT *) halVirtFwFillEvent(prAdapter,
+		sizeof(struct WIFI_UNI_EVENT), pvBuf, u2Len, &u4Len);
+	prEvent->u2PacketLength = u4Len - prChipInfo->rxd_size;
+	prEvent->u2PacketType = EVENT_PACKET_TYPE;
+	prEvent->ucEID = ucEID;
+	prEvent->ucSeqNum = ucSeqNum;
+	/* solicited */
+	prEvent->ucOption = UNI_CMD_OPT_BIT_1_UNI_EVENT;
+
+	if (!pvBuf && ucEID == UNI_EVENT_ID_CMD_RESULT &&
+	    u2Len >= sizeof(struct UNI_EVENT_CMD_RESULT)) {
+		prCmdResult = (struct UNI_EVENT_CMD_RESULT *)
+			prEvent->aucBuffer;
+		prCmdResult->u2CID = u2CID;
+	}
+
+	halVirtFwPostEvent(prAdapter, u4Len);
+}
+#endif /* CFG_SUPPORT_UNIFIED_COMMAND */
+
+static struct VIRT_FW_RULE *halVirtFwFindRule(IN struct VIRT_FW *prFw,
+	IN u_int8_t fgUni, IN uint16_t u2CID)
+{
+	uint8_t i;
+
+	for (i = 0; i < prFw->ucRuleNum; i++) {
+		if (prFw->arRule[i].fgUni == fgUni &&
+		    prFw->arRule[i].u2CID == u2CID)
+			return &prFw->arRule[i];
+	}
+
+	return NULL;
+}
+
+void kal_virt_fw_reset(struct ADAPTER *ad)
+{
+	struct VIRT_FW *prFw = &ad->prGlueInfo->rHifInfo.rFw;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	/* scripted rules survive a reset */
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	prFw->eState = VIRT_FW_STATE_ROM;
+	prFw->u4DlRemain = 0;
+	prFw->u4InitCmdCnt = 0;
+	prFw->u4DlBytes = 0;
+	prFw->u4DlCrc = 0;
+	prFw->u4CmdCnt = 0;
+	prFw->u4EvtCnt = 0;
+	prFw->u4TxStatusCnt = 0;
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+}
+
+void kal_virt_fw_handle_init_cmd(struct ADAPTER *ad, uint8_t *buf,
+	uint32_t len)
+{
+	struct mt66xx_chip_info *prChipInfo = ad->chip_info;
+	struct VIRT_FW *prFw = &ad->prGlueInfo->rHifInfo.rFw;
+	struct INIT_HIF_TX_HEADER *prInitHifTxHeader;
+	struct INIT_WIFI_CMD *prInitCmd;
+	struct INIT_CMD_DOWNLOAD_CONFIG *prDlConfig;
+	struct INIT_CMD_PATCH_SEMA_CONTROL *prSemaCtrl;
+	struct INIT_CMD_ACCESS_REG *prAccessReg;
+	struct INIT_EVENT_ACCESS_REG rAccessRegEvt;
+	struct INIT_EVENT_CMD_RESULT rResult;
+	uint32_t u4HdrLen, u4DataLen;
+
+	if (prFw->eState == VIRT_FW_STATE_OFF) {
+		DBGLOG(HAL, WARN, "FW is off, drop init frame\n");
+		return;
+	}
+
+	prFw->u4InitCmdCnt++;
+
+	/* a download scatter is raw image data behind the HIF TXD */
+	if (prFw->eState == VIRT_FW_STATE_DL) {
+		u4DataLen = len > prChipInfo->u2HifTxdSize ?
+			len - prChipInfo->u2HifTxdSize : 0;
+		/* the last scatter is padded to a DW */
+		if (u4DataLen > prFw->u4DlRemain)
+			u4DataLen = prFw->u4DlRemain;
+		prFw->u4DlCrc = crc32_le(prFw->u4DlCrc,
+			buf + prChipInfo->u2HifTxdSize, u4DataLen);
+		prFw->u4DlBytes += u4DataLen;
+		prFw->u4DlRemain -= u4DataLen;
+		if (prFw->u4DlRemain == 0) {
+			prFw->u4DlCrc = ~prFw->u4DlCrc;
+			prFw->eState = VIRT_FW_STATE_ROM;
+		}
+		return;
+	}
+
+	u4HdrLen = prChipInfo->u2HifTxdSize +
+		sizeof(struct INIT_HIF_TX_HEADER_PENDING_FOR_HW_32BYTES) +
+		sizeof(struct INIT_HIF_TX_HEADER);
+	if (len < u4HdrLen) {
+		DBGLOG(HAL, WARN, "Short init command len[%u]\n", len);
+		return;
+	}
+
+	prInitHifTxHeader = (struct INIT_HIF_TX_HEADER *)
+		(buf + prChipInfo->u2HifTxdSize +
+		 sizeof(struct INIT_HIF_TX_HEADER_PENDING_FOR_HW_32BYTES));
+	prInitCmd = &prInitHifTxHeader->rInitWifiCmd;
+
+	kalMemZero(&rResult, sizeof(rResult));
+	rResult.ucCID = prInitCmd->ucCID;
+
+	switch (prInitCmd->ucCID) {
+	case INIT_CMD_ID_DOWNLOAD_CONFIG:
+	case INIT_CMD_ID_PATCH_START:
+		prDlConfig = (struct INIT_CMD_DOWNLOAD_CONFIG *)
+			prInitCmd->aucBuffer;
+		prFw->u4DlRemain = prDlConfig->u4Length;
+		if (prFw->u4DlRemain) {
+			prFw->u4DlCrc = ~0;
+			prFw->eState = VIRT_FW_STATE_DL;
+		} else {
+			prFw->u4DlCrc = 0;
+		}
+		break;
+
+	case INIT_CMD_ID_WIFI_START:
+#if CFG_SUPPORT_COMPRESSION_FW_OPTION
+	case INIT_CMD_ID_DECOMPRESSED_WIFI_START:
+#endif
+		prFw->eState = VIRT_FW_STATE_RAM;
+		break;
+
+	case INIT_CMD_ID_PATCH_SEMAPHORE_CONTROL:
+		prSemaCtrl = (struct INIT_CMD_PATCH_SEMA_CONTROL *)
+			prInitCmd->aucBuffer;
+		rResult.ucStatus = prSemaCtrl->ucGetSemaphore ?
+			PATCH_STATUS_GET_SEMA_NEED_PATCH :
+			PATCH_STATUS_RELEASE_SEMA;
+		halVirtFwSendInitEvent(ad, INIT_EVENT_ID_PATCH_SEMA_CTRL,
+			prInitCmd->ucSeqNum, &rResult, sizeof(rResult));
+		return;
+
+	case INIT_CMD_ID_ACCESS_REG:
+		prAccessReg = (struct INIT_CMD_ACCESS_REG *)
+			prInitCmd->aucBuffer;
+		if (prAccessReg->ucSetQuery) {
+			kal_virt_cr_access(ad, TRUE, prAccessReg->u4Address,
+				&prAccessReg->u4Data);
+			break;
+		}
+		rAccessRegEvt.u4Address = prAccessReg->u4Address;
+		kal_virt_cr_access(ad, FALSE, prAccessReg->u4Address,
+			&rAccessRegEvt.u4Data);
+		halVirtFwSendInitEvent(ad, INIT_EVENT_ID_ACCESS_REG,
+			prInitCmd->ucSeqNum, &rAccessRegEvt,
+			sizeof(rAccessRegEvt));
+		return;
+
+	case INIT_CMD_ID_QUERY_PENDING_ERROR:
+		/* 0 for download success */
+		halVirtFwSendInitEvent(ad, INIT_EVENT_ID_PENDING_ERROR,
+			prInitCmd->ucSeqNum, &rResult, sizeof(rResult));
+		return;
+
+	default:
+		break;
+	}
+
+	halVirtFwSendInitEvent(ad, INIT_EVENT_ID_CMD_RESULT,
+		prInitCmd->ucSeqNum, &rResult, sizeof(rResult));
+}
+
+void kal_virt_fw_handle_cmd(struct ADAPTER *ad, uint8_t *buf, uint32_t len)
+{
+	struct mt66xx_chip_info *prChipInfo = ad->chip_info;
+	struct VIRT_FW *prFw = &ad->prGlueInfo->rHifInfo.rFw;
+	struct VIRT_FW_RULE *prRule;
+	struct WIFI_CMD *prWifiCmd;
+	uint32_t u4Offset;
+	u_int8_t fgUni = FALSE;
+	uint16_t u2CID;
+	uint8_t ucSeqNum;
+
+	if (prFw->eState != VIRT_FW_STATE_RAM) {
+		DBGLOG(HAL, WARN, "FW state[%u], drop command\n",
+			prFw->eState);
+		return;
+	}
+
+	u4Offset = prChipInfo->u2HifTxdSize + prChipInfo->u2CmdTxHdrSize -
+		sizeof(struct WIFI_CMD);
+	/* the unified header is the shorter one */
+	if (len < u4Offset + offsetof(struct WIFI_CMD, ucCmdVersion)) {
+		DBGLOG(HAL, WARN, "Short command len[%u]\n", len);
+		return;
+	}
+
+	prWifiCmd = (struct WIFI_CMD *) (buf + u4Offset);
+	u2CID = prWifiCmd->ucCID;
+	ucSeqNum = prWifiCmd->ucSeqNum;
+#ifdef CFG_SUPPORT_UNIFIED_COMMAND
+	/* ucOption of WIFI_UNI_CMD sits at ucExtCmdOption */
+	if (prWifiCmd->ucExtCmdOption & UNI_CMD_OPT_BIT_1_UNI_CMD) {
+		struct WIFI_UNI_CMD *prUniCmd =
+			(struct WIFI_UNI_CMD *) prWifiCmd;
+
+		fgUni = TRUE;
+		u2CID = prUniCmd->u2CID;
+		ucSeqNum = prUniCmd->ucSeqNum;
+	}
+#endif
+	if (!fgUni && len < u4Offset + sizeof(struct WIFI_CMD)) {
+		DBGLOG(HAL, WARN, "Short command len[%u]\n", len);
+		return;
+	}
+
+	prFw->u4CmdCnt++;
+
+	/* Every command is answered. The driver drops the response of a
+	 * command it is not waiting for when the pending lookup fails.
+	 */
+	prRule = halVirtFwFindRule(prFw, fgUni, u2CID);
+#ifdef CFG_SUPPORT_UNIFIED_COMMAND
+	if (fgUni) {
+		if (prRule)
+			halVirtFwSendUniEvent(ad, u2CID, prRule->ucEID,
+				ucSeqNum, prRule->pucEvt, prRule->u2EvtLen);
+		else
+			halVirtFwSendUniEvent(ad, u2CID,
+				UNI_EVENT_ID_CMD_RESULT, ucSeqNum, NULL,
+				VIRT_FW_EVT_DEFAULT_LEN);
+		return;
+	}
+#endif
+
+	if (prRule)
+		halVirtFwSendEvent(ad, prRule->ucEID, ucSeqNum,
+			prRule->pucEvt, prRule->u2EvtLen);
+	else
+		halVirtFwSendEvent(ad, EVENT_ID_INIT_EVENT_CMD_RESULT,
+			ucSeqNum, NULL, VIRT_FW_EVT_DEFAULT_LEN);
+}
+
+void kal_virt_fw_tx_status(struct ADAPTER *ad, uint8_t wlan_idx,
+	uint8_t pid)
+{
+	struct VIRT_FW *prFw = &ad->prGlueInfo->rHifInfo.rFw;
+	struct EVENT_TX_DONE rTxDone;
+
+	kalMemZero(&rTxDone, sizeof(rTxDone));
+	rTxDone.ucPacketSeq = pid;
+	rTxDone.ucStatus = TX_RESULT_SUCCESS;
+	rTxDone.ucWlanIndex = wlan_idx;
+	rTxDone.ucTxCount = 1;
+
+	halVirtFwSendEvent(ad, EVENT_ID_TX_DONE, 0, &rTxDone,
+		sizeof(rTxDone));
+	prFw->u4TxStatusCnt++;
+}
+
+u_int8_t kal_virt_fw_inject_event(struct ADAPTER *ad, uint8_t eid,
+	uint8_t *buf, uint16_t len)
+{
+	struct VIRT_FW *prFw = &ad->prGlueInfo->rHifInfo.rFw;
+	uint32_t u4EvtCnt;
+	u_int8_t fgRet;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	u4EvtCnt = prFw->u4EvtCnt;
+	halVirtFwSendEvent(ad, eid, 0, buf, len);
+	fgRet = prFw->u4EvtCnt != u4EvtCnt;
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+
+	if (fgRet)
+		kal_virt_raise_int(ad, WHISR_RX1_DONE_INT);
+
+	return fgRet;
+}
+
+u_int8_t kal_virt_fw_set_rule(struct ADAPTER *ad, u_int8_t uni,
+	uint16_t cid, uint8_t eid, const uint8_t *buf, uint16_t len)
+{
+	struct VIRT_FW *prFw = &ad->prGlueInfo->rHifInfo.rFw;
+	struct VIRT_FW_RULE *prRule;
+	u_int8_t fgRet = TRUE;
+
+	KAL_SPIN_LOCK_DECLARATION();
+
+	KAL_ACQUIRE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+	prRule = halVirtFwFindRule(prFw, uni, cid);
+	if (!prRule && prFw->ucRuleNum < VIRT_FW_RULE_NUM)
+		prRule = &prFw->arRule[prFw->ucRuleNum++];
+
+	if (prRule) {
+		prRule->fgUni = uni;
+		prRule->u2CID = cid;
+		prRule->ucEID = eid;
+		prRule->pucEvt = buf;
+		prRule->u2EvtLen = len;
+	} else {
+		DBGLOG(HAL, WARN, "No rule slot for CID[0x%x]\n", cid);
+		fgRet = FALSE;
+	}
+	KAL_RELEASE_SPIN_LOCK(ad, SPIN_LOCK_VIRT_DEV);
+
+	return fgRet;
+}
+
+uint8_t *kal_virt_fw_image(struct ADAPTER *ad,
+	enum ENUM_IMG_DL_IDX_T idx, uint32_t *len)
+{
+	static const uint32_t au4RegionLen[] = {
+		3 * CMD_PKT_SIZE_FOR_IMAGE + 123, 77
+	};
+	struct TAILER_COMMON_FORMAT_T *prComTailer;
+	struct TAILER_REGION_FORMAT_T *prRegTailer;
+	uint32_t u4DataLen = 0, u4Seed = 1;
+	uint8_t *pucImage;
+	uint32_t i;
+
+	/* no ROM patch, wlanDownloadPatch() failure is not fatal */
+	if (idx != IMG_DL_IDX_N9_FW)
+		return NULL;
+
+	for (i = 0; i < ARRAY_SIZE(au4RegionLen); i++)
+		u4DataLen += au4RegionLen[i];
+	*len = u4DataLen + ARRAY_SIZE(au4RegionLen) *
+		sizeof(struct TAILER_REGION_FORMAT_T) +
+		sizeof(struct TAILER_COMMON_FORMAT_T);
+
+	pucImage = vmalloc(*len);
+	if (!pucImage)
+		return NULL;
+	kalMemZero(pucImage, *len);
+
+	for (i = 0; i < u4DataLen; i++) {
+		u4Seed = u4Seed * 1103515245 + 12345;
+		pucImage[i] = (uint8_t)(u4Seed >> 16);
+	}
+
+	prRegTailer = (struct TAILER_REGION_FORMAT_T *)
+		(pucImage + u4DataLen);
+	for (i = 0; i < ARRAY_SIZE(au4RegionLen); i++) {
+		prRegTailer[i].u4Addr = 0x900000 + i * 0x10000;
+		prRegTailer[i].u4Len = au4RegionLen[i];
+		prRegTailer[i].u4RealSize = au4RegionLen[i];
+	}
+
+	prComTailer = (struct TAILER_COMMON_FORMAT_T *)
+		(pucImage + *len - sizeof(struct TAILER_COMMON_FORMAT_T));
+	prComTailer->ucChipInfo = (uint8_t) ad->chip_info->chip_id;
+	prComTailer->ucRegionNum = ARRAY_SIZE(au4RegionLen);
+	kalMemCopy(prComTailer->aucRamVersion, "virt_fw",
+		sizeof("virt_fw"));
+	kalMemCopy(prComTailer->aucRamBuiltDate, "20100301000000",
+		sizeof("20100301000000"));
+
+	return pucImage;
+}
@@ -217,6 +217,8 @@ struct wireless_dev {
 	struct wiphy *wiphy;
 	struct net_device *netdev;
 	void *current_bss; /* Should be struct cfg80211_internal_bss */
+	/* needed by mgmt/saa_fsm.c */
+	u_int8_t connected;
 
 };
 /* needed by
@@ -254,7 +256,11 @@ struct sk_buff {
 	char cb[48];
 	unsigned char *data;
 	unsigned int len;
+	unsigned int priority;	/* 802.1D user priority of a TX frame */
 	struct net_device *dev;
+	/* buffer of kal_dev_alloc_skb(), data moves inside it */
+	unsigned char *head;
+	unsigned int end;
 };
 
 /*
@@ -382,6 +388,15 @@ enum nl80211_band {
 #endif
 	NUM_NL80211_BANDS,
 };
+/* pre-4.7 name, used by mgmt/scan.c under the old version code */
+#define ieee80211_band nl80211_band
+
+/* needed by mgmt/roaming_fsm.c */
+enum nl80211_cqm_rssi_threshold_event {
+	NL80211_CQM_RSSI_THRESHOLD_EVENT_LOW,
+	NL80211_CQM_RSSI_THRESHOLD_EVENT_HIGH,
+	NL80211_CQM_RSSI_BEACON_LOSS_EVENT,
+};
 
 /*
  * enum nl80211_initiator - Indicates the initiator of a reg domain request
@@ -606,6 +621,12 @@ struct timer_list {
 	 */
 };
 
+/* needed by include/nic/adapter.h
+ * CSI_INFO_T, and GLUE_INFO in os folder
+ */
+typedef struct {
+} wait_queue_head_t;
+
 /* needed by include/nic/adapter.h
  * for DIRECT_TX implementation in os folder
  */
@@ -685,6 +706,12 @@ struct work_struct {
 	/* work_func_t func; */
 };
 
+/* needed by nic/nic.c, L0.5 reset work */
+#define INIT_WORK(_work, _func) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _work, _func)
+#define flush_work(_work) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _work)
+
 /* needed by include/nic/mt66xx_reg.h
  * struct mt66xx_chip_info
  * comment: use with #if CFG_MTK_ANDROID_WMT
@@ -849,6 +876,22 @@ void kal_vfree(void *addr);
 bool kal_irqs_disabled(void);
 #define irqs_disabled() kal_irqs_disabled()
 
+/*
+ * kal_smp_processor_id: virtual CPU of the calling thread, 0 unless set by
+ *                       kal_virt_set_cpu()
+ * common/token_pool.c
+ */
+uint32_t kal_smp_processor_id(void);
+#define smp_processor_id() kal_smp_processor_id()
+
+/* number of virtual CPUs a thread can be put on */
+#define KAL_VIRT_CPU_NUM	8
+#define nr_cpu_ids		KAL_VIRT_CPU_NUM
+
+/* a thread never leaves its virtual CPU, there is nothing to mask */
+#define local_irq_save(_flags) ((_flags) = 0)
+#define local_irq_restore(_flags) ((void) (_flags))
+
 /*
  * kal_spin_lock: lock in irqs disabled, os-dependent
  * nic/nic_tx.c
@@ -1004,6 +1047,10 @@ struct sk_buff *kal_dev_alloc_skb(unsigned int length);
 void kal_kfree_skb(struct sk_buff *skb);
 #define kfree_skb(_skb) kal_kfree_skb(_skb)
 
+/* reserve headroom of an empty buffer */
+void kal_skb_reserve(struct sk_buff *skb, unsigned int len);
+#define skb_reserve(_skb, _len) kal_skb_reserve(_skb, _len)
+
 /****************************************************************************
  * TODO: Functions need implementation
  ****************************************************************************
@@ -1014,7 +1061,7 @@ void kal_kfree_skb(struct sk_buff *skb);
  * mgmt/stats.c
  * ais_fsm.c
  */
-#define kal_sched_clock() KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+uint64_t kal_sched_clock(void);
 #define sched_clock() kal_sched_clock()
 
 /* looks like min/max not in C
@@ -1120,8 +1167,41 @@ void kal_kfree_skb(struct sk_buff *skb);
 #define le64_to_cpu(_val) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
-#define div_u64(_val, _div) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+/* needed by common/wlan_lib.c */
+#define div_u64(_val, _div) ((uint64_t)(_val) / (uint32_t)(_div))
+
+/* needed by chips/common/fw_dl.c */
+#define div64_u64(_val, _div) ((uint64_t)(_val) / (uint64_t)(_div))
+
+/* needed by chips/common/dbg_connac3x.c */
+#define do_div(_n, _base) ({ \
+	uint32_t __rem = (uint64_t)(_n) % (_base); \
+	(_n) = (uint64_t)(_n) / (_base); \
+	__rem; \
+})
+#define local_clock() kal_sched_clock()
+
+/* needed by nic/nic_cmd_event.c */
+#define le16_to_cpup(_p) ((uint16_t)le2cpu16(*(const uint16_t *)(_p)))
+#define le32_to_cpup(_p) ((uint32_t)le2cpu32(*(const uint32_t *)(_p)))
+/* CSI readers poll the ring, nobody sleeps on the wait queue */
+#define wake_up_interruptible(_wq) ((void)(_wq))
+
+/* needed by common/wlan_lib.c, CSI ring */
+#define READ_ONCE(_x) (*(const volatile typeof(_x) *)&(_x))
+#define WRITE_ONCE(_x, _val) (*(volatile typeof(_x) *)&(_x) = (_val))
+
+/* needed by nic/nic.c, common/token_pool.c */
+#define spin_lock_init(_lock) (*(_lock) = 0)
+
+/* needed by mgmt/rlm.c, mgmt/scan.c */
+#define ieee80211_channel_to_frequency(_chan, _band) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _chan)
+#define ieee80211_get_channel(_wiphy, _freq) \
+	((struct ieee80211_channel *) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _wiphy))
+#define ieee80211_operating_class_to_band(_class, _band) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _band)
 
 int kal_test_and_clear_bit(unsigned long bit, unsigned long *p);
 #ifndef test_and_clear_bit
@@ -1149,4 +1229,51 @@ int kal_test_bit(unsigned long bit, unsigned long *p);
 #ifndef test_bit
 #define test_bit(_offset, _val) kal_test_bit(_offset, _val)
 #endif
+
+/*
+ * kal_crc32_le: reflected CRC-32 of polynomial 0xEDB88320, no pre or post
+ *               inversion, same as Linux crc32_le()
+ * @crc: CRC of the preceding data
+ * @p: data
+ * @len: data length
+ */
+uint32_t kal_crc32_le(uint32_t crc, const uint8_t *p, size_t len);
+#define crc32_le(_crc, _p, _len) kal_crc32_le(_crc, _p, _len)
+
+/*
+ * kal_virt_clock_freeze: stop sched_clock() and kalGetTimeTick() at the
+ *                        current time, so a test can step them with
+ *                        kal_virt_clock_advance()
+ * @freeze: false lets the clock follow CLOCK_MONOTONIC again
+ */
+void kal_virt_clock_freeze(bool freeze);
+
+/*
+ * kal_virt_clock_advance: move the frozen clock forward
+ * @ns: nanoseconds to add
+ */
+void kal_virt_clock_advance(uint64_t ns);
+
+/*
+ * kal_virt_set_cpu: put the calling thread on a virtual CPU, see
+ *                   kal_smp_processor_id()
+ * @cpu: virtual CPU, below KAL_VIRT_CPU_NUM
+ */
+void kal_virt_set_cpu(uint32_t cpu);
+
+/*
+ * glSelfTest: run the self tests of os/none/gl_self_test.c
+ * @name: test to run, NULL for all
+ *
+ * return: number of failed tests
+ */
+int glSelfTest(const char *name);
+
+/*
+ * glSelfBench: run the benchmarks of os/none/gl_self_test.c
+ * @name: benchmark to run, NULL for all
+ *
+ * return: number of benchmarks which could not run
+ */
+int glSelfBench(const char *name);
 #endif
@@ -138,6 +138,17 @@ extern int g_u4HaltFlag;
 #define COALESCING_INT_MAX_PKT (50)
 #endif
 
+/* Number of TX port queue locks, shall not be less than TX_PORT_NUM */
+#define SPIN_LOCK_TX_PORT_QUE_NUM	16
+
+#if CFG_SUPPORT_DATA_STALL
+#define REPORT_EVENT_INTERVAL		30
+#define EVENT_PER_HIGH_THRESHOLD	80
+#define EVENT_TX_LOW_RATE_THRESHOLD	20
+#define EVENT_RX_LOW_RATE_THRESHOLD	20
+#define TRAFFIC_RHRESHOLD	150
+#endif
+
 /*******************************************************************************
  *                             D A T A   T Y P E S
  *******************************************************************************
@@ -147,7 +158,10 @@ enum ENUM_SPIN_LOCK_CATEGORY_E {
 	SPIN_LOCK_FSM = 0,
 
 #if CFG_SUPPORT_MULTITHREAD
+	/* one lock per TX port queue, see TX_PORT_QUE_LOCK() */
 	SPIN_LOCK_TX_PORT_QUE,
+	SPIN_LOCK_TX_PORT_QUE_LAST =
+		SPIN_LOCK_TX_PORT_QUE + SPIN_LOCK_TX_PORT_QUE_NUM - 1,
 	SPIN_LOCK_TX_CMD_QUE,
 	SPIN_LOCK_TX_CMD_DONE_QUE,
 	SPIN_LOCK_TC_RESOURCE,
@@ -184,12 +198,12 @@ enum ENUM_SPIN_LOCK_CATEGORY_E {
 	SPIN_LOCK_MSG_BUF,
 	SPIN_LOCK_STA_REC,
 
-	SPIN_LOCK_MAILBOX,
 	SPIN_LOCK_TIMER,
 
 	/* SPIN_LOCK_BOW_TABLE,*/
 
 	SPIN_LOCK_EHPI_BUS,	/* only for EHPI */
+	SPIN_LOCK_VIRT_DEV,	/* only for virtual WFDMA device */
 	SPIN_LOCK_NET_DEV,
 #if (CFG_TX_DYN_CMD_SUPPORT == 1)
 	SPIN_LOCK_DYN_CMD,
@@ -203,6 +217,9 @@ enum ENUM_MUTEX_CATEGORY_E {
 	MUTEX_DEL_INF,
 	MUTEX_CHIP_RST,
 	MUTEX_SET_OWN,
+#if CFG_SUPPORT_CSI
+	MUTEX_CSI_BUFFER,
+#endif
 	MUTEX_NUM
 };
 
@@ -289,6 +306,16 @@ struct KAL_THREAD_SCHEDSTATS {
 	unsigned long long iowait;
 };
 
+#if CFG_SUPPORT_DATA_STALL
+enum ENUM_VENDOR_DRIVER_EVENT {
+	EVENT_TEST_MODE,
+	EVENT_ARP_NO_RESPONSE,
+	EVENT_PER_HIGH,
+	EVENT_TX_LOW_RATE,
+	EVENT_RX_LOW_RATE
+};
+#endif
+
 /*******************************************************************************
  *                            P U B L I C   D A T A
  *******************************************************************************
@@ -319,6 +346,14 @@ struct KAL_THREAD_SCHEDSTATS {
 /* TODO: os-related: need implementation */
 #define KAL_GET_CURRENT_THREAD_ID() (0)
 #define KAL_GET_CURRENT_THREAD_NAME() ("n/a")
+#define KAL_GET_CURRENT_CPU_ID() (0)
+
+/*----------------------------------------------------------------------------*/
+/* Macros of checking the execution context                                   */
+/*----------------------------------------------------------------------------*/
+/* TODO: os-related: need implementation */
+#define KAL_IS_SOFTIRQ_CONTEXT() (FALSE)
+#define KAL_IS_INTERRUPT_CONTEXT() (FALSE)
 
 /*----------------------------------------------------------------------------*/
 /* Macros of SPIN LOCK operations for using in Driver Layer                   */
@@ -580,6 +615,10 @@ struct KAL_THREAD_SCHEDSTATS {
 #define kalMemMove(pvDst, pvSrc, u4Size)  \
 	memmove(pvDst, pvSrc, u4Size)
 
+/* CRC-32 (IEEE 802.3), same as zlib crc32() */
+#define kalCRC32(pucBuf, u4Len) \
+	(~crc32_le(~0, pucBuf, u4Len))
+
 #define strnicmp(s1, s2, n) KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
 /* string operation */
@@ -685,7 +724,7 @@ int8_t kal_atoi(uint8_t ch);
 #define kalCopyFrame(prGlueInfo, pvPacket, pucDestBuffer) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
-#define kalGetTimeTick() KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+#define kalGetTimeTick() ((uint32_t) (kal_sched_clock() / NSEC_PER_MSEC))
 
 #define WLAN_TAG                        "[wlan]"
 #define kalPrint(_Fmt...) printf(WLAN_TAG _Fmt)
@@ -745,6 +784,12 @@ KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
 #define KAL_DMA_MAPPING_ERROR(_dev, _addr) \
 KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+
+#define KAL_DMA_SYNC_SINGLE_FOR_CPU(_dev, _addr, _size, _dir) \
+KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+
+#define KAL_DMA_SYNC_SINGLE_FOR_DEVICE(_dev, _addr, _size, _dir) \
+KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 #else
 #define KAL_DMA_TO_DEVICE	DMA_TO_DEVICE
 #define KAL_DMA_FROM_DEVICE	DMA_FROM_DEVICE
@@ -763,6 +808,12 @@ KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
 #define KAL_DMA_MAPPING_ERROR(_dev, _addr) \
 KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+
+#define KAL_DMA_SYNC_SINGLE_FOR_CPU(_dev, _addr, _size, _dir) \
+KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+
+#define KAL_DMA_SYNC_SINGLE_FOR_DEVICE(_dev, _addr, _size, _dir) \
+KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 #endif
 
 #if defined(_HIF_AXI)
@@ -793,13 +844,15 @@ KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 /*----------------------------------------------------------------------------*/
 /* Routines in gl_kal.c                                                       */
 /*----------------------------------------------------------------------------*/
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalAcquireSpinLock(_pr, _rLockCate, _plFlags) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr, _rLockCate, _plFlags)
+void kalAcquireSpinLock(IN struct GLUE_INFO *prGlueInfo,
+			IN enum ENUM_SPIN_LOCK_CATEGORY_E rLockCategory,
+			OUT unsigned long *plFlags);
 
-#define kalReleaseSpinLock(_prGlueInfo, _rLockCategory, _ulFlags) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
+void kalReleaseSpinLock(IN struct GLUE_INFO *prGlueInfo,
+			IN enum ENUM_SPIN_LOCK_CATEGORY_E rLockCategory,
+			IN unsigned long ulFlags);
 
+#ifdef CFG_REMIND_IMPLEMENT
 #define kalUpdateMACAddress(_prGlueInfo, _pucMacAddr) \
 KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo, _pucMacAddr)
 
@@ -809,23 +862,7 @@ KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo, _rMutexCategory)
 #define kalReleaseMutex(_prGlueInfo, _rMutexCategory) \
 KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo, _rMutexCategory)
 
-#define kalPacketFree(_prGlueInfo, _pvPacket) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo, _pvPacket)
-
-#define kalPacketAlloc(_prGlueInfo, _u4Size, _ppucData) \
-((void *) KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo))
-
-#define kalPacketAllocWithHeadroom(_prGlueInfo, _u4Size, _ppucData) \
-((void *) KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo))
 #else
-void kalAcquireSpinLock(IN struct GLUE_INFO *prGlueInfo,
-			IN enum ENUM_SPIN_LOCK_CATEGORY_E rLockCategory,
-			OUT unsigned long *plFlags);
-
-void kalReleaseSpinLock(IN struct GLUE_INFO *prGlueInfo,
-			IN enum ENUM_SPIN_LOCK_CATEGORY_E rLockCategory,
-			IN unsigned long ulFlags);
-
 void kalUpdateMACAddress(IN struct GLUE_INFO *prGlueInfo,
 			 IN uint8_t *pucMacAddr);
 
@@ -834,6 +871,7 @@ void kalAcquireMutex(IN struct GLUE_INFO *prGlueInfo,
 
 void kalReleaseMutex(IN struct GLUE_INFO *prGlueInfo,
 		     IN enum ENUM_MUTEX_CATEGORY_E rMutexCategory);
+#endif
 
 void kalPacketFree(IN struct GLUE_INFO *prGlueInfo,
 		   IN void *pvPacket);
@@ -845,7 +883,6 @@ void *kalPacketAlloc(IN struct GLUE_INFO *prGlueInfo,
 void *kalPacketAllocWithHeadroom(IN struct GLUE_INFO
 				 *prGlueInfo,
 				 IN uint32_t u4Size, OUT uint8_t **ppucData);
-#endif
 
 void kalOsTimerInitialize(IN struct GLUE_INFO *prGlueInfo,
 			  IN void *prTimerHandler);
@@ -853,39 +890,17 @@ void kalOsTimerInitialize(IN struct GLUE_INFO *prGlueInfo,
 u_int8_t kalSetTimer(IN struct GLUE_INFO *prGlueInfo,
 		     IN OS_SYSTIME rInterval);
 
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalProcessRxPacket(_prGlueInfo, _pvPacket, _pucPacketStart, \
-	_u4PacketLen, _fgIsRetain, _aeCSUM) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-#else
 uint32_t
 kalProcessRxPacket(IN struct GLUE_INFO *prGlueInfo,
 		   IN void *pvPacket,
 		   IN uint8_t *pucPacketStart, IN uint32_t u4PacketLen,
 		   /* IN PBOOLEAN           pfgIsRetain, */
 		   IN u_int8_t fgIsRetain, IN enum ENUM_CSUM_RESULT aeCSUM[]);
-#endif
 
 uint32_t kalRxIndicatePkts(IN struct GLUE_INFO *prGlueInfo,
 			   IN void *apvPkts[],
 			   IN uint8_t ucPktNum);
 
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalRxIndicateOnePkt(_prGlueInfo, _pvPkt) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-
-#define kalIndicateStatusAndComplete(_prGlInfo, _eStatus, _pvBuf, _u4BufLen, \
-	_ucBssIndex) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-
-#define kalUpdateReAssocReqInfo(_prGlueInfo, _pucFrameBody, _u4FrameBodyLen, \
-	_fgReassocRequest, _ucBssIndex) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-
-#define kalUpdateReAssocRspInfo(_prGlueInfo, _pucFrameBody, _u4FrameBodyLen, \
-	_ucBssIndex) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-#else
 uint32_t kalRxIndicateOnePkt(IN struct GLUE_INFO
 			     *prGlueInfo, IN void *pvPkt);
 
@@ -896,6 +911,15 @@ kalIndicateStatusAndComplete(IN struct GLUE_INFO
 			     IN uint32_t u4BufLen,
 			     IN uint8_t ucBssIndex);
 
+#ifdef CFG_REMIND_IMPLEMENT
+#define kalUpdateReAssocReqInfo(_prGlueInfo, _pucFrameBody, _u4FrameBodyLen, \
+	_fgReassocRequest, _ucBssIndex) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+
+#define kalUpdateReAssocRspInfo(_prGlueInfo, _pucFrameBody, _u4FrameBodyLen, \
+	_ucBssIndex) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+#else
 void
 kalUpdateReAssocReqInfo(IN struct GLUE_INFO *prGlueInfo,
 			IN uint8_t *pucFrameBody, IN uint32_t u4FrameBodyLen,
@@ -916,14 +940,9 @@ kalQueryTxPacketHeader(IN struct GLUE_INFO *prGlueInfo,
 		       OUT uint8_t *pucEthDestAddr);
 #endif /* CFG_TX_FRAGMENT */
 
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalSendCompleteAndAwakeQueue(_prGlueInfo, _pvPacket) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo, _pvPacket)
-#else
 void kalSendCompleteAndAwakeQueue(IN struct GLUE_INFO
 				  *prGlueInfo,
 				  IN void *pvPacket);
-#endif
 
 #if CFG_TCP_IP_CHKSUM_OFFLOAD
 #ifdef CFG_REMIND_IMPLEMENT
@@ -1000,25 +1019,16 @@ void kalIndicateRxMgmtFrame(IN struct ADAPTER *prAdapter,
 /*----------------------------------------------------------------------------*/
 /* Routines in interface - ehpi/sdio.c                                        */
 /*----------------------------------------------------------------------------*/
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalDevRegRead(_prGlueInfo, _u4Register, _pu4Value) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-#else
+/* implemented by the virtual WFDMA device in hif/none */
 u_int8_t kalDevRegRead(IN struct GLUE_INFO *prGlueInfo,
 		       IN uint32_t u4Register,
 		       OUT uint32_t *pu4Value);
-#endif
 u_int8_t kalDevRegRead_mac(IN struct GLUE_INFO *prGlueInfo,
 			   IN uint32_t u4Register, OUT uint32_t *pu4Value);
 
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalDevRegWrite(_prGlueInfo, _u4Register, _u4Value) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-#else
 u_int8_t kalDevRegWrite(struct GLUE_INFO *prGlueInfo,
 			IN uint32_t u4Register,
 			IN uint32_t u4Value);
-#endif
 u_int8_t kalDevRegWrite_mac(struct GLUE_INFO *prGlueInfo,
 			    IN uint32_t u4Register, IN uint32_t u4Value);
 
@@ -1032,22 +1042,11 @@ kalDevPortWrite(struct GLUE_INFO *prGlueInfo,
 		IN uint16_t u2Port, IN uint32_t u2Len, IN uint8_t *pucBuf,
 		IN uint32_t u2ValidInBufSize);
 
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalDevWriteData(_prGlueInfo, _prMsduInfo) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
-#define kalDevWriteCmd(_prGlueInfo, _prCmdInfo, _ucTC) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
-#define kalDevKickData(_prGlueInfo) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-#else
 u_int8_t kalDevWriteData(IN struct GLUE_INFO *prGlueInfo,
 			 IN struct MSDU_INFO *prMsduInfo);
 u_int8_t kalDevWriteCmd(IN struct GLUE_INFO *prGlueInfo,
 			IN struct CMD_INFO *prCmdInfo, IN uint8_t ucTC);
 u_int8_t kalDevKickData(IN struct GLUE_INFO *prGlueInfo);
-#endif
 void kalDevReadIntStatus(IN struct ADAPTER *prAdapter,
 			 OUT uint32_t *pu4IntStatus);
 
@@ -1059,13 +1058,17 @@ u_int8_t kalDevWriteWithSdioCmd52(IN struct GLUE_INFO
 uint32_t kalReadExtCfg(IN struct GLUE_INFO *prGlueInfo);
 #endif
 
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalQoSFrameClassifierAndPacketInfo(_pr, _prPacket, _prTxPktInfo) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
+u_int8_t
+kalQoSFrameClassifierAndPacketInfo(IN struct GLUE_INFO
+				   *prGlueInfo,
+				   IN void *prPacket,
+				   OUT struct TX_PACKET_INFO *prTxPktInfo);
 
-#define kalGetEthDestAddr(_prGlueInfo, _prPacket, _pucEthDestAddr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
+u_int8_t kalGetEthDestAddr(IN struct GLUE_INFO *prGlueInfo,
+			   IN void *prPacket,
+			   OUT uint8_t *pucEthDestAddr);
 
+#ifdef CFG_REMIND_IMPLEMENT
 #define kalOidComplete(_prGlueInfo, _fgSetQuery, _u4SetQueryInfoLen, \
 	       _rOidStatus) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
@@ -1090,16 +1093,6 @@ uint32_t kalReadExtCfg(IN struct GLUE_INFO *prGlueInfo);
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
 
 #else
-u_int8_t
-kalQoSFrameClassifierAndPacketInfo(IN struct GLUE_INFO
-				   *prGlueInfo,
-				   IN void *prPacket,
-				   OUT struct TX_PACKET_INFO *prTxPktInfo);
-
-u_int8_t kalGetEthDestAddr(IN struct GLUE_INFO *prGlueInfo,
-			   IN void *prPacket,
-			   OUT uint8_t *pucEthDestAddr);
-
 void
 kalOidComplete(IN struct GLUE_INFO *prGlueInfo,
 	       IN u_int8_t fgSetQuery, IN uint32_t u4SetQueryInfoLen,
@@ -1135,14 +1128,6 @@ void kalHandleAssocInfo(IN struct GLUE_INFO *prGlueInfo,
 			IN struct EVENT_ASSOC_INFO *prAssocInfo);
 
 #if CFG_ENABLE_FW_DOWNLOAD
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalFirmwareImageMapping(_prGlueInfo, _ppvMapFileBuf, \
-	_pu4FileLength, _eDlIdx) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
-#define kalFirmwareImageUnmapping(_prGlueInfo, _prFwHandle, _pvMapFileBuf) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-#else
 void *kalFirmwareImageMapping(IN struct GLUE_INFO
 			      *prGlueInfo,
 			      OUT void **ppvMapFileBuf,
@@ -1152,17 +1137,11 @@ void kalFirmwareImageUnmapping(IN struct GLUE_INFO
 			       *prGlueInfo,
 			       IN void *prFwHandle, IN void *pvMapFileBuf);
 #endif
-#endif
 
 /*----------------------------------------------------------------------------*/
 /* Card Removal Check                                                         */
 /*----------------------------------------------------------------------------*/
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalIsCardRemoved(_prGlueInfo) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-#else
 u_int8_t kalIsCardRemoved(IN struct GLUE_INFO *prGlueInfo);
-#endif
 /*----------------------------------------------------------------------------*/
 /* TX                                                                         */
 /*----------------------------------------------------------------------------*/
@@ -1204,17 +1183,14 @@ void kalSetMediaStateIndicated(IN struct GLUE_INFO *prGlueInfo,
 
 #define kalOidClearance(_prGlueInfo) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
-#define kalEnqueueCommand(_prGlueInfo, _prQueueEntry) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
 #else
 void kalOidCmdClearance(IN struct GLUE_INFO *prGlueInfo);
 
 void kalOidClearance(IN struct GLUE_INFO *prGlueInfo);
+#endif
 
 void kalEnqueueCommand(IN struct GLUE_INFO *prGlueInfo,
 		       IN struct QUE_ENTRY *prQueueEntry);
-#endif
 
 #if CFG_ENABLE_BT_OVER_WIFI
 /*----------------------------------------------------------------------------*/
@@ -1287,6 +1263,12 @@ void kalSecurityFrameSendComplete(IN struct GLUE_INFO
 /*----------------------------------------------------------------------------*/
 /* Management Frame Clearance                                                 */
 /*----------------------------------------------------------------------------*/
+uint32_t kalGetTxPendingFrameCount(IN struct GLUE_INFO
+				   *prGlueInfo);
+
+uint32_t kalGetTxPendingCmdCount(IN struct GLUE_INFO
+				 *prGlueInfo);
+
 #ifdef CFG_REMIND_IMPLEMENT
 #define kalClearMgmtFrames(_prGlueInfo) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
@@ -1294,17 +1276,8 @@ void kalSecurityFrameSendComplete(IN struct GLUE_INFO
 #define kalClearMgmtFramesByBssIdx(_prGlueInfo, _ucBssIndex) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
 
-#define kalGetTxPendingFrameCount(_prGlueInfo) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
-#define kalGetTxPendingCmdCount(_prGlueInfo) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
 #define kalClearCommandQueue(_prGlueInfo) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
-#define kalSetTimer(_prGlueInfo, _u4Interval) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
 #else
 void kalClearMgmtFrames(IN struct GLUE_INFO *prGlueInfo);
 
@@ -1312,16 +1285,7 @@ void kalClearMgmtFramesByBssIdx(IN struct GLUE_INFO
 				*prGlueInfo,
 				IN uint8_t ucBssIndex);
 
-uint32_t kalGetTxPendingFrameCount(IN struct GLUE_INFO
-				   *prGlueInfo);
-
-uint32_t kalGetTxPendingCmdCount(IN struct GLUE_INFO
-				 *prGlueInfo);
-
 void kalClearCommandQueue(IN struct GLUE_INFO *prGlueInfo);
-
-u_int8_t kalSetTimer(IN struct GLUE_INFO *prGlueInfo,
-		     IN uint32_t u4Interval);
 #endif
 
 u_int8_t kalCancelTimer(IN struct GLUE_INFO *prGlueInfo);
@@ -1344,12 +1308,6 @@ void kalTimeoutHandler(unsigned long arg);
 #ifdef CFG_REMIND_IMPLEMENT
 #define kalRandomNumber() KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
-#define kalSetEvent(_pr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
-
-#define kalSetIntEvent(_pr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
-
 #define kalSetWmmUpdateEvent(_pr) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
 
@@ -1358,31 +1316,16 @@ void kalTimeoutHandler(unsigned long arg);
 #else
 uint32_t kalRandomNumber(void);
 
-void kalSetEvent(struct GLUE_INFO *pr);
-
-void kalSetIntEvent(struct GLUE_INFO *pr);
-
 void kalSetWmmUpdateEvent(struct GLUE_INFO *pr);
 
 void kalSetHifDbgEvent(struct GLUE_INFO *pr);
 #endif
 
-#if CFG_SUPPORT_MULTITHREAD
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalSetTxEvent2Hif(_pr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
-
-#define kalSetTxEvent2Rx(_pr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
+void kalSetEvent(struct GLUE_INFO *pr);
 
-#define kalSetTxCmdEvent2Hif(_pr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
-#define kalSetTxCmdDoneEvent(_pr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
+void kalSetIntEvent(struct GLUE_INFO *pr);
 
-#define kalSetRxProcessEvent(_pr) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _pr)
-#else
+#if CFG_SUPPORT_MULTITHREAD
 void kalSetTxEvent2Hif(struct GLUE_INFO *pr);
 
 void kalSetTxEvent2Rx(struct GLUE_INFO *pr);
@@ -1393,7 +1336,8 @@ void kalSetTxCmdDoneEvent(struct GLUE_INFO *pr);
 
 void kalSetRxProcessEvent(struct GLUE_INFO *pr);
 #endif
-#endif
+
+u_int8_t kalMainThreadRun(IN struct GLUE_INFO *prGlueInfo);
 /*----------------------------------------------------------------------------*/
 /* NVRAM/Registry Service                                                     */
 /*----------------------------------------------------------------------------*/
@@ -1470,11 +1414,12 @@ u_int8_t kalInitIOBuffer(u_int8_t is_pre_alloc);
 void kalUninitIOBuffer(void);
 
 #ifdef CFG_REMIND_IMPLEMENT
+/* no pre-allocated I/O buffer, as the Linux fallback */
 #define kalAllocateIOBuffer(_u4AllocSize) \
-((uint8_t *) KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__))
+	((uint8_t *) kalMemAlloc(_u4AllocSize, PHY_MEM_TYPE))
 
 #define kalReleaseIOBuffer(_pvAddr, _u4Size) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+	kalMemFree(_pvAddr, PHY_MEM_TYPE, _u4Size)
 #else
 void *kalAllocateIOBuffer(IN uint32_t u4AllocSize);
 
@@ -1565,10 +1510,12 @@ kalIndicateBssInfo(IN struct GLUE_INFO *prGlueInfo,
 /*----------------------------------------------------------------------------*/
 /* Net device                                                                 */
 /*----------------------------------------------------------------------------*/
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalHardStartXmit(_prSkb, _prDev, _prGlueInfo, _ucBssIndex) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
+uint32_t
+kalHardStartXmit(struct sk_buff *prSkb,
+		 IN struct net_device *prDev,
+		 struct GLUE_INFO *prGlueInfo, uint8_t ucBssIndex);
 
+#ifdef CFG_REMIND_IMPLEMENT
 #define kalIsPairwiseEapolPacket(_prPacket) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
@@ -1591,11 +1538,6 @@ kalIndicateBssInfo(IN struct GLUE_INFO *prGlueInfo,
 #define kalGetStats(_prDev) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 #else
-uint32_t
-kalHardStartXmit(struct sk_buff *prSkb,
-		 IN struct net_device *prDev,
-		 struct GLUE_INFO *prGlueInfo, uint8_t ucBssIndex);
-
 u_int8_t kalIsPairwiseEapolPacket(IN void *prPacket);
 
 u_int8_t
@@ -1782,11 +1724,7 @@ int hif_thread(void *data);
 int rx_thread(void *data);
 #endif
 
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalGetBootTime() KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-#else
 uint64_t kalGetBootTime(void);
-#endif
 
 int kalMetInitProcfs(IN struct GLUE_INFO *prGlueInfo);
 int kalMetRemoveProcfs(void);
@@ -1794,13 +1732,8 @@ int kalMetRemoveProcfs(void);
 uint8_t kalGetEapolKeyType(void *prPacket);
 
 #if CFG_SUPPORT_WAKEUP_REASON_DEBUG
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalIsWakeupByWlan(_prAdapter) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-#else
 u_int8_t kalIsWakeupByWlan(struct ADAPTER *prAdapter);
 #endif
-#endif
 
 int32_t kalHaltLock(uint32_t waitMs);
 int32_t kalHaltTryLock(void);
@@ -1950,6 +1883,7 @@ uint8_t kalRxNapiValidSkb(struct GLUE_INFO *prGlueInfo,
 
 #if CFG_CHIP_RESET_SUPPORT
 void kalRemoveProbe(IN struct GLUE_INFO *prGlueInfo);
+#endif
 
 #if (CFG_SUPPORT_SINGLE_SKU_LOCAL_DB == 1)
 void
@@ -1957,5 +1891,41 @@ kalApplyCustomRegulatory(IN struct wiphy *pWiphy,
 	IN const struct ieee80211_regdomain *pRegdom);
 #endif
 
+#if CFG_SUPPORT_DATA_STALL
+#ifdef CFG_REMIND_IMPLEMENT
+#define KAL_REPORT_ERROR_EVENT(_prAdapter, _event, _ucBssIdx) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prAdapter)
+#else
+u_int8_t kalIndicateDriverEvent(struct ADAPTER *prAdapter,
+					enum ENUM_VENDOR_DRIVER_EVENT event,
+					uint8_t ucBssIdx);
+#define KAL_REPORT_ERROR_EVENT			kalIndicateDriverEvent
+#endif
+#endif
+
+#ifdef CFG_REMIND_IMPLEMENT
+#define kalGetFwFlavor(_flavor) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _flavor)
+
+#define kalIndicateCqmRssiNotify(_dev, _rssi_event, _rssi_level) \
+	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _dev)
+#else
+int32_t kalGetFwFlavor(uint8_t *flavor);
+
+void kalIndicateCqmRssiNotify(struct net_device *dev,
+			      enum nl80211_cqm_rssi_threshold_event rssi_event,
+			      int32_t rssi_level);
+#endif
+
+#ifndef __has_attribute
+#define __has_attribute(x) 0
+#endif
+
+#if __has_attribute(__fallthrough__)
+#define kal_fallthrough __attribute__((__fallthrough__))
+#else
+#define kal_fallthrough do {} while (0)  /* fallthrough */
+#endif
+
 #endif /* _GL_KAL_H */
 
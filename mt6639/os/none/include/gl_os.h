@@ -95,6 +95,9 @@
 /* va_* series */
 #include<stdarg.h>
 
+/* abs */
+#include <stdlib.h>
+
 /* for INT_MAX for some reason include fail not checked */
 #if 0
 /* when there is platform specific toolchain
@@ -121,6 +124,7 @@ typedef uint8_t u8;
 #include "gl_typedef.h"
 #include "typedef.h"
 #include "queue.h"
+#include "token_pool.h"
 #include "gl_kal.h"
 #include "gl_rst.h"
 #include "hif.h"
@@ -432,8 +436,21 @@ struct GLUE_INFO {
 	/* OID related */
 	struct QUE rCmdQueue;
 
+	/* frames of kalHardStartXmit() waiting for the main thread, pushed
+	 * by QUEUE_MPSC_PUSH(), and the ones QM could not take yet
+	 */
+	struct QUE_ENTRY *prTxInbox;
+	struct QUE rTxQueue;
+
 	spinlock_t rSpinLock[SPIN_LOCK_NUM];
 
+	unsigned long ulFlag;		/* GLUE_FLAG_XXX */
+
+	/* there is no network stack, frames given to the OS are counted */
+	uint32_t u4RxIndicateCnt;
+	uint64_t u8RxIndicateBytes;
+	uint32_t u4TxCompleteCnt;
+
 	/* Number of pending frames, also used for debuging if any frame is
 	 * missing during the process of unloading Driver.
 	 *
@@ -488,6 +505,10 @@ struct GLUE_INFO {
 	uint32_t u4CurrTick;
 	uint64_t u8CurrTime;
 
+	/* Root timer timeout set by kalSetTimer(), in kalGetTimeTick() */
+	u_int8_t fgTimerSet;
+	OS_SYSTIME rTimerExpiry;
+
 	/*
 	 * Buffer to hold non-wfa vendor specific IEs set
 	 * from wpa_supplicant. This is used in sending
@@ -521,6 +542,14 @@ struct GLUE_INFO {
 
 	/* Device */
 	struct device *prDev;
+
+	/* Host interface related information */
+	/* defined in related hif header file */
+	struct GL_HIF_INFO rHifInfo;
+
+#if CFG_CHIP_RESET_SUPPORT
+	struct work_struct rWfsysResetWork;    /* work for Wfsys L0.5 reset  */
+#endif
 	/* not necessary for built */
 	/* TODO: os-related */
 	uint32_t u4ReadyFlag;	/* check if card is ready */
@@ -994,14 +1023,15 @@ struct PACKET_PRIVATE_RX_DATA {
 /*----------------------------------------------------------------------------*/
 /* Macros for accessing Reserved Fields of native packet                      */
 /*----------------------------------------------------------------------------*/
-/* TODO: os-related, implementation may refer to os/linux */
-#define GLUE_GET_PKT_PRIVATE_DATA(_p) ((struct PACKET_PRIVATE_DATA *)0)
+#define GLUE_GET_PKT_PRIVATE_DATA(_p) \
+	((struct PACKET_PRIVATE_DATA *)(&(((struct sk_buff *)(_p))->cb[0])))
 
 #define GLUE_GET_PKT_QUEUE_ENTRY(_p)    \
 	    (&(GLUE_GET_PKT_PRIVATE_DATA(_p)->rQueEntry))
 
-/* TODO: os-related implementation */
-#define GLUE_GET_PKT_DESCRIPTOR(_prQueueEntry) ((struct PACKET_PRIVATE_DATA *)0)
+#define GLUE_GET_PKT_DESCRIPTOR(_prQueueEntry)  \
+	    ((void *) (((unsigned long)_prQueueEntry) \
+	    - offsetof(struct sk_buff, cb[0])))
 
 #define GLUE_SET_PKT_TID(_p, _tid) \
 	    (GLUE_GET_PKT_PRIVATE_DATA(_p)->ucTid = (uint8_t)(_tid))
@@ -1113,6 +1143,13 @@ struct PACKET_PRIVATE_RX_DATA {
 #define GLUE_INC_REF_CNT(_refCount)     (_refCount++)
 #define GLUE_DEC_REF_CNT(_refCount)     (_refCount--)
 #define GLUE_GET_REF_CNT(_refCount)     (_refCount)
+/* Fully ordered, return the previous value of *_ptr, as on Linux */
+#define GLUE_XCHG(_ptr, _new) \
+	__atomic_exchange_n((_ptr), (_new), __ATOMIC_SEQ_CST)
+#define GLUE_CMPXCHG(_ptr, _old, _new) \
+	__sync_val_compare_and_swap((_ptr), (_old), (_new))
+#define GLUE_LOAD_ACQUIRE(_ptr)         (*(_ptr))
+#define GLUE_STORE_RELEASE(_ptr, _val)  (*(_ptr) = (_val))
 
 #define DbgPrint(...)
 
@@ -1276,13 +1313,8 @@ extern int glUnregisterEarlySuspend(struct early_suspend
 #endif
 
 #if CFG_MET_PACKET_TRACE_SUPPORT
-#ifdef CFG_REMIND_IMPLEMENT
-#define kalMetTagPacket(_prGlueInfo, _prPacket, _eTag) \
-KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-#else
 void kalMetTagPacket(IN struct GLUE_INFO *prGlueInfo,
 		     IN void *prPacket, IN enum ENUM_TX_PROFILING_TAG eTag);
-#endif
 
 void kalMetInit(IN struct GLUE_INFO *prGlueInfo);
 #endif
@@ -153,6 +153,9 @@ int32_t mtk_Netdev_To_RoleIdx(struct GLUE_INFO *prGlueInfo,
 		struct net_device *ndev,
 		uint8_t *pucRoleIdx);
 
+u_int8_t kalP2PGetCipher(IN struct GLUE_INFO *prGlueInfo,
+		IN uint8_t ucRoleIdx);
+
 #ifdef CFG_REMIND_IMPLEMENT
 #define kalP2PUpdateAssocInfo(_prGlueInfo, _pucFrameBody, _u4FrameBodyLen, \
 	_fgReassocRequest, _ucBssIndex) \
@@ -167,9 +170,6 @@ int32_t mtk_Netdev_To_RoleIdx(struct GLUE_INFO *prGlueInfo,
 #define kalP2PSetCipher(_prGlueInfo, _u4Cipher, _ucRoleIdx) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
 
-#define kalP2PGetCipher(_prGlueInfo, _ucRoleIdx) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
-
 #define kalP2PGetWepCipher(_prGlueInfo, _ucRoleIdx) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__, _prGlueInfo)
 
@@ -197,9 +197,6 @@ void kalP2PSetCipher(IN struct GLUE_INFO *prGlueInfo,
 		IN uint32_t u4Cipher,
 		IN uint8_t ucRoleIdx);
 
-u_int8_t kalP2PGetCipher(IN struct GLUE_INFO *prGlueInfo,
-		IN uint8_t ucRoleIdx);
-
 u_int8_t kalP2PGetWepCipher(IN struct GLUE_INFO *prGlueInfo,
 		IN uint8_t ucRoleIdx);
 
@@ -279,6 +279,9 @@ void glSendResetRequest(void);
 
 u_int8_t glIsWmtCodeDump(void);
 
+/* referenced by address in INIT_WORK, so never a macro */
+void WfsysResetHdlr(struct work_struct *work);
+
 #ifdef CFG_REMIND_IMPLEMENT
 #define glSetWfsysResetState(_prAdapter, _state) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
@@ -286,9 +289,6 @@ u_int8_t glIsWmtCodeDump(void);
 #define glReSchWfsysReset(_prAdapter) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
-#define WfsysResetHdlr(_work) \
-	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
-
 #define glSetRstReason(_eReason) \
 	KAL_NEED_IMPLEMENT(__FILE__, __func__, __LINE__)
 
@@ -322,8 +322,6 @@ void glSetWfsysResetState(struct ADAPTER *prAdapter,
 
 u_int8_t glReSchWfsysReset(struct ADAPTER *prAdapter);
 
-void WfsysResetHdlr(struct work_struct *work);
-
 void glSetRstReason(enum _ENUM_CHIP_RESET_REASON_TYPE_T
 		    eReason);
 
@@ -272,6 +272,7 @@ typedef void(*remove_card) (void);
 #define LE48_TO_CPU(x) (x)
 #define CPU_TO_LE48(x) (x)
 #define cpu2le32(x) ((uint32_t)(x))
+#define le2cpu16(x) ((uint16_t)(x))
 #define le2cpu32(x) ((uint32_t)(x))
 #define cpu2be32(x) SWAP32((x))
 #define be2cpu32(x) SWAP32((x))
@@ -290,6 +291,8 @@ typedef void(*remove_card) (void);
 #define LE48_TO_CPU(x) SWAP48(x)
 #define CPU_TO_LE48(x) SWAP48(x)
 #define cpu2le32(x) SWAP32((x))
+#define le2cpu16(x) \
+	((uint16_t)(((uint16_t)(x) << 8) | ((uint16_t)(x) >> 8)))
 #define le2cpu32(x) SWAP32((x))
 #define cpu2be32(x) ((uint32_t)(x))
 #define be2cpu32(x) ((uint32_t)(x))